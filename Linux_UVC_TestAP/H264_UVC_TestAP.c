@@ -20,6 +20,7 @@
 #include <sys/mman.h>
 #include <sys/select.h>
 #include <sys/time.h>
+#include <time.h>
 #include <linux/videodev2.h>
 #include <linux/version.h>
 #include <sys/utsname.h>
@@ -28,6 +29,11 @@
 #include "v4l2uvc.h"
 #include "h264_xu_ctrls.h"
 #include "nalu.h"
+#include "mp4_mux.h"
+#include "ms_demux.h"
+#include "frame_writer.h"
+#include "md_monitor.h"
+#include "dev_cache.h"
 #include "debug.h"
 
 #define TESTAP_VERSION		"v1.0.14.0_H264_UVC_TestAP_Multi"
@@ -47,11 +53,6 @@
 #define V4L_BUFFERS_MAX		3
 #endif
 
-#define H264_SIZE_HD				((1280<<16)|720)
-#define H264_SIZE_VGA				((640<<16)|480)
-#define H264_SIZE_QVGA				((320<<16)|240)
-#define H264_SIZE_QQVGA				((160<<16)|112)
-
 #define MULTI_STREAM_HD_QVGA		1
 #define MULTI_STREAM_HD_QQVGA		2
 #define MULTI_STREAM_HD_QVGA_QQVGA	4
@@ -68,6 +69,17 @@ struct thread_parameter
 	int *dev;
 	unsigned int *nframes ;
 	unsigned char multi_stream_mjpg_enable;
+	MS_DEMUX *demux;
+};
+
+struct record_target
+{
+	const char *basename;
+	unsigned int pixelformat;
+	FRAME_WRITER *writer;
+	MP4_MUX *mux;
+	FW_STREAM *stream;
+	FW_STREAM *pts;				/* <name>.<ext>.pts, timestamp format v2 (ms per frame) */
 };
 
 #if 0
@@ -421,7 +433,9 @@ static void usage(const char *argv0)
 	TestAp_Printf(TESTAP_DBG_USAGE, "-S, --save		Save captured images to disk\n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "    --enum-inputs	Enumerate inputs\n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "    --skip n		Skip the first n frames\n");
-	TestAp_Printf(TESTAP_DBG_USAGE, "-r, --record		Record H264 file\n");
+	TestAp_Printf(TESTAP_DBG_USAGE, "-r, --record		Record video file (H264: fragmented MP4, others: raw)\n");
+	TestAp_Printf(TESTAP_DBG_USAGE, "    --writers n	Number of file writer threads for --save/--record (default %d)\n", FW_DEFAULT_THREADS);
+	TestAp_Printf(TESTAP_DBG_USAGE, "    --refresh-cache	Re-read chip ID / XU mappings / H.264 formats from the device and rewrite the device cache ($%s)\n", DEV_CACHE_DIR_ENV);
 	TestAp_Printf(TESTAP_DBG_USAGE, "--bri-set values	Set brightness values\n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "--bri-get		Get brightness values\n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "--shrp-set values	Set sharpness values\n");
@@ -483,7 +497,9 @@ static void usage(const char *argv0)
 	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuset-mdm  m1 m2 ... m24		Set Motion detect mask\n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuget-mdm			Get Motion detect mask\n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuset-mdr  m1 m2 ... m24		Set Motion detect result\n");
-	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuget-mdr			Get Motion detect result\n");
+	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuget-mdr			Get Motion detect result (printed on change while capturing)\n");
+	TestAp_Printf(TESTAP_DBG_USAGE, "     --md-poll min[:max[:latency]]	MD result poll interval in ms (default %d:%d:%d, adaptive up to latency; control events when supported)\n",
+		MD_MON_DEFAULT_MIN_MS, MD_MON_DEFAULT_MAX_MS, MD_MON_DEFAULT_LATENCY_MS);
 	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuset-mjb Bitrate		Set MJPG Bitrate (bps) \n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuget-mjb			Get MJPG Bitrate (bps) \n");
 	TestAp_Printf(TESTAP_DBG_USAGE, "     --xuset-if	nframe			Set H264 reset to IFrame.  nframe : reset per nframe.\n");
@@ -604,6 +620,9 @@ static void usage(const char *argv0)
 #define OPT_FRAME_DROP_CTRL_SET	OPT_ENUM_INPUTS + 83
 #define OPT_FRAME_DROP_CTRL_GET	OPT_ENUM_INPUTS + 84
 #define OPT_DEBUG_LEVEL			OPT_ENUM_INPUTS + 85
+#define OPT_WRITERS				OPT_ENUM_INPUTS + 86
+#define OPT_MD_POLL				OPT_ENUM_INPUTS + 87
+#define OPT_REFRESH_CACHE		OPT_ENUM_INPUTS + 88
 
 static struct option opts[] = {
 	{"capture", 2, 0, 'c'},
@@ -700,31 +719,19 @@ static struct option opts[] = {
 	{"xuset-fdc", 1, 0, OPT_FRAME_DROP_CTRL_SET},
 	{"xuget-fdc", 0, 0, OPT_FRAME_DROP_CTRL_GET},
 	{"dbg", 1, 0, OPT_DEBUG_LEVEL},
+	{"writers", 1, 0, OPT_WRITERS},
+	{"md-poll", 1, 0, OPT_MD_POLL},
+	{"refresh-cache", 0, 0, OPT_REFRESH_CACHE},
 	{0, 0, 0, 0}
 };
 
 void *thread_capture(void *par)
 {
-
-	unsigned int mjpg_resolution = 0;//(width << 16) | (height);
-	unsigned int mjpg_width = 0;
-	unsigned int mjpg_height = 0;
-	unsigned int unknow_size = 0;
 	unsigned int skip = 0;
 	struct thread_parameter thread_par = * (struct thread_parameter*) par;
 	int i = 0;
 	int ret;
-	FILE *file = NULL;
-	char filename[] = "";
-/*	
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.dev = %d \n",*thread_par.dev);
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.nframes = %d \n",*thread_par.nframes);
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.multi_stream_mjpg_enable = %d \n",(unsigned int)thread_par.multi_stream_mjpg_enable);
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.mem = 0x%x \n",thread_par.mem[0]);
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.mem = 0x%x \n",thread_par.mem[1]);
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.mem = 0x%x \n",thread_par.mem[2]);
-	TestAp_Printf(TESTAP_DBG_FLOW, "  +++ thread_par.mem = 0x%x \n",thread_par.mem[3]);
-*/
+
 	if(thread_par.multi_stream_mjpg_enable)
 	{
 		skip = 6;
@@ -732,8 +739,6 @@ void *thread_capture(void *par)
 	
 	for (i = 0; i < *thread_par.nframes; ++i) 
 	{
-		unknow_size = 0;
-		
 		/* Dequeue a buffer. */
 		memset(thread_par.buf, 0, sizeof *thread_par.buf);
 		thread_par.buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -745,45 +750,11 @@ void *thread_capture(void *par)
 			return;
 		}
 		
-		/* Save the image. */
-		if(thread_par.multi_stream_mjpg_enable)
-		{
-			//mjpg_width = (unsigned int)((*(unsigned char *)(thread_par.mem[(thread_par.buf->index)]+9)) << 8) | (*(unsigned char *)(thread_par.mem[(thread_par.buf->index)]+10));
-			//mjpg_height = (unsigned int)((*(unsigned char *)(thread_par.mem[(thread_par.buf->index)]+7)) << 8) | (*(unsigned char *)(thread_par.mem[(thread_par.buf->index)]+8));
-			//mjpg_resolution = (unsigned int)((mjpg_width << 16) | (mjpg_height));
-			mjpg_resolution = thread_par.buf->reserved;
-			
-			if(mjpg_resolution == H264_SIZE_HD)
-				sprintf(filename, "[   HD]frame-%06u.jpg", i);
-			else if(mjpg_resolution == H264_SIZE_VGA)
-				sprintf(filename, "[  VGA]frame-%06u.jpg", i);
-			else if(mjpg_resolution == H264_SIZE_QVGA)
-				sprintf(filename, "[ QVGA]frame-%06u.jpg", i);
-			else if(mjpg_resolution == H264_SIZE_QQVGA)
-				sprintf(filename, "[QQVGA]frame-%06u.jpg", i);
-			else
-			{
-				unknow_size = 1;
-				//TestAp_Printf(TESTAP_DBG_FRAME, "  ### [frame %4d] mjpg  unknow size  w=%d  h=%d  \n",i , mjpg_width,mjpg_height);
-				//sprintf(filename, "[%4d*%4d]frame-%06u.jpg", mjpg_width, mjpg_height , i);
-			}
-		}
-		else
-		{
-			sprintf(filename, "frame-%06u.jpg", i);		
-		}
-		
-		//TestAp_Printf(TESTAP_DBG_FRAME, "  +++ unknow_size=%d  skip=%d    %x  \n", unknow_size,skip,mjpg_resolution);
-		
-		if((!unknow_size)&&(!skip))
-		{
-			file = fopen(filename, "wb");
-			if (file != NULL) 
-			{
-				fwrite(thread_par.mem[thread_par.buf->index], thread_par.buf->bytesused, 1, file);
-				fclose(file);
-			}
-		}
+		/* Save the image: the driver packs (width << 16) | height into reserved for multi-stream MJPEG.
+		 * Classification and file writes happen in the demux consumer, so the buffer is requeued right away. */
+		if(!skip)
+			MsDemuxPublish(thread_par.demux, thread_par.multi_stream_mjpg_enable ? thread_par.buf->reserved : 0,
+				thread_par.mem[thread_par.buf->index], thread_par.buf->bytesused, &thread_par.buf->timestamp, 1);
 		
 		if(skip)
 			--skip;
@@ -799,14 +770,157 @@ void *thread_capture(void *par)
 	pthread_exit(NULL);
 }
 
+/* The frame is copied into the writer pool; a full queue drops the file instead of stalling capture. */
+static void save_jpeg(FRAME_WRITER *writer, const char *filename, const void *data, unsigned int len)
+{
+	if(FrameWriterSubmitFile(writer, filename, data, len) < 0)
+		TestAp_Printf(TESTAP_DBG_FRAME, "%s dropped (writer queue full)\n", filename);
+}
+
+static void jpeg_save_consumer(const MS_FRAME *frame, void *user)
+{
+	char filename[32];
+
+	if(frame->stream == MS_STREAM_OTHER)
+		snprintf(filename, sizeof(filename), "frame-%06u.jpg", frame->sequence);
+	else
+		snprintf(filename, sizeof(filename), "[%s]frame-%06u.jpg", MsDemuxStreamName(frame->stream), frame->sequence);
+
+	save_jpeg((FRAME_WRITER *)user, filename, frame->data, frame->len);
+}
+
+/* Extension of a raw (non-MP4) recording, from the negotiated pixel format. */
+static const char *record_extension(unsigned int pixelformat)
+{
+	switch(pixelformat)
+	{
+	case V4L2_PIX_FMT_MJPEG:	return "mjpeg";
+	case V4L2_PIX_FMT_YUYV:		return "yuyv";
+	case V4L2_PIX_FMT_H264:		return "h264";
+	default:					return "raw";
+	}
+}
+
+/* H264 is written as fragmented MP4 (V4L2 buffer timestamps), other formats as raw frames
+ * with the buffer timestamps in a .pts sidecar so the recording can be replayed at its original pacing.
+ * Both go through the frame writer, which gathers them into large aligned writes on its own threads. */
+static void record_frame(struct record_target *rec, const void *data, unsigned int len, const struct timeval *ts)
+{
+	char name[64];
+	char line[32];
+	int n;
+
+	if(rec->pixelformat == V4L2_PIX_FMT_H264)
+	{
+		if(rec->mux == NULL)
+		{
+			snprintf(name, sizeof(name), "%s.mp4", rec->basename);
+			rec->mux = Mp4MuxOpenWriter(name, rec->writer);
+		}
+		if(rec->mux != NULL)
+			Mp4MuxWriteFrame(rec->mux, (const unsigned char *)data, len, ts);
+		return;
+	}
+
+	if(rec->stream == NULL)
+	{
+		snprintf(name, sizeof(name), "%s.%s", rec->basename, record_extension(rec->pixelformat));
+		rec->stream = FrameWriterStreamOpen(rec->writer, name);
+		snprintf(name, sizeof(name), "%s.%s.pts", rec->basename, record_extension(rec->pixelformat));
+		rec->pts = FrameWriterStreamOpen(rec->writer, name);
+		if(rec->pts != NULL)
+			FrameWriterStreamWrite(rec->pts, "# timestamp format v2\n", 22);
+	}
+	if(rec->stream != NULL)
+		FrameWriterStreamWrite(rec->stream, data, len);
+	if(rec->pts != NULL)
+	{
+		n = snprintf(line, sizeof(line), "%ld.%03ld\n", (long)ts->tv_sec * 1000 + ts->tv_usec / 1000, (long)(ts->tv_usec % 1000));
+		FrameWriterStreamWrite(rec->pts, line, n);
+	}
+}
+
+static void record_consumer(const MS_FRAME *frame, void *user)
+{
+	record_frame((struct record_target *)user, frame->data, frame->len, &frame->timestamp);
+}
+
+static void record_close(struct record_target *rec)
+{
+	MP4_MUX_STATS st;
+
+	if(rec->mux != NULL)
+	{
+		if(Mp4MuxClose(rec->mux, &st) < 0)
+			TestAp_Printf(TESTAP_DBG_ERR, "MP4 record: close failed\n");
+		printf("MP4 record %s: %lu frames (%lu skipped before IDR), %lu fragments, %llu bytes\n",
+			rec->basename, st.frames, st.skipped, st.fragments, st.bytes);
+		rec->mux = NULL;
+	}
+	if(rec->stream != NULL)
+	{
+		if(FrameWriterStreamClose(rec->stream) < 0)
+			TestAp_Printf(TESTAP_DBG_ERR, "Record %s: close failed\n", rec->basename);
+		rec->stream = NULL;
+	}
+	if(rec->pts != NULL)
+	{
+		if(FrameWriterStreamClose(rec->pts) < 0)
+			TestAp_Printf(TESTAP_DBG_ERR, "Record %s: timestamp close failed\n", rec->basename);
+		rec->pts = NULL;
+	}
+}
+
+static void writer_report(FRAME_WRITER *writer)
+{
+	FW_STATS st;
+
+	FrameWriterGetStats(writer, &st);
+	printf("Frame writer: %lu jobs, %llu bytes, %lu dropped, %lu stalls, %lu errors, max backlog %u, max latency %llu ms\n",
+		st.completed, st.bytes, st.dropped, st.stalls, st.errors, st.max_backlog, st.max_latency_us / 1000);
+	TestAp_Printf(TESTAP_DBG_FLOW, "Frame writer: %lu O_DIRECT files, %lu buffered files, %d io_uring threads, pool %u bytes\n",
+		st.direct_files, st.buffered_files, st.uring_threads, st.pool_used);
+}
+
+static void md_result_changed(const MD_MON_RESULT *res, void *user)
+{
+	XU_MD_Print_RESULT(res->result);
+	TestAp_Printf(TESTAP_DBG_FLOW, "MD result #%u: %d cells (%s)\n", res->sequence, res->active_cells,
+		res->source == MD_MON_SRC_EVENT ? "event" : (res->source == MD_MON_SRC_KICK ? "kick" : "poll"));
+}
+
+static void md_monitor_report(MD_MONITOR *mon)
+{
+	MD_MON_STATS st;
+
+	MdMonitorGetStats(mon, &st);
+	printf("MD monitor: %lu reads, %lu changes, %lu events, %lu errors (%s, interval %u ms)\n",
+		st.reads, st.changes, st.events, st.errors, st.event_mode ? "control events" : "polling", st.interval_ms);
+}
+
+static void demux_report(const char *what, MS_SUBSCRIBER **subs, int count)
+{
+	MS_SUB_STATS st;
+	int k;
+
+	for(k = 0; k < count; k++)
+	{
+		MsDemuxGetStats(subs[k], &st);
+		if(st.delivered == 0 && st.dropped == 0)
+			continue;
+		TestAp_Printf(TESTAP_DBG_FLOW, "%s [%s]: %lu frames, %lu dropped, blocked %lu times (%llu ms), max queue %u\n",
+			what, MsDemuxStreamName(k), st.delivered, st.dropped, st.blocked, st.blocked_us / 1000, st.max_depth);
+	}
+}
+
 int main(int argc, char *argv[])
 {
 	char filename[] = "quickcam-0000.jpg";
-	char rec_filename[] = "RecordH264.h264";			/*"H264.ts"*/
-	char rec_filename1[] = "RecordH264HD.h264";		/*"H264.ts"*/
-	char rec_filename2[] = "RecordH264QVGA.h264";	/*"H264.ts"*/
-	char rec_filename3[] = "RecordH264QQVGA.h264";	/*"H264.ts"*/
-	char rec_filename4[] = "RecordH264VGA.h264";		/*"H264.ts"*/
+	char rec_filename[] = "RecordH264";			/* .mp4 (H264), .mjpeg or .yuyv */
+	char rec_filename1[] = "RecordH264HD";
+	char rec_filename2[] = "RecordH264QVGA";
+	char rec_filename3[] = "RecordH264QQVGA";
+	char rec_filename4[] = "RecordH264VGA";
 	int dev, ret;
 	int fake_dev; // chris
 	int freeram;
@@ -831,12 +945,24 @@ int main(int argc, char *argv[])
 	/* Capture loop */
 	struct timeval start, end, ts;
 	unsigned int delay = 0, nframes = (unsigned int)-1;
-	FILE *file = NULL;
-	FILE *rec_fp1 = NULL;
-	FILE *rec_fp2 = NULL;
-	FILE *rec_fp3 = NULL;
-	FILE *rec_fp4 = NULL;
+	struct record_target rec_main;
+	struct record_target rec_stream[4];		/* indexed by MS_STREAM_HD..MS_STREAM_QQVGA */
+	MS_DEMUX *rec_demux = NULL;
+	MS_DEMUX *jpg_demux = NULL;
+	MD_MONITOR *md_mon = NULL;
+	MD_MON_CONFIG md_mon_cfg;
+	MS_SUBSCRIBER *rec_subs[4];
+	int ms_stream = MS_STREAM_OTHER;
+	int ms_keyframe = 0;
+	int thread_started = 0;
+	int k;
+	FRAME_WRITER *writer = NULL;
+	FW_CONFIG writer_cfg;
 	double fps;
+	DEV_CACHE dev_cache;
+	DEV_CACHE *devc = NULL;
+	int refresh_cache = 0;
+	struct timespec t_open, t_probe, t_first;
 
 	struct v4l2_buffer buf0;
 	struct v4l2_buffer buf1;
@@ -884,6 +1010,8 @@ int main(int argc, char *argv[])
 	unsigned int multi_stream_width = 0;//1280;
 	unsigned int multi_stream_height = 0;//720;
 	unsigned int multi_stream_resolution = 0;//(multi_stream_width << 16) | (multi_stream_height);
+	H264_PARSER ms_parser;
+	H264_FRAME_INFO ms_info;
 	unsigned int MS_bitrate = 0;
 	unsigned int MS_qp = 0;
 	unsigned int streamID_set = 0;
@@ -1018,6 +1146,19 @@ int main(int argc, char *argv[])
 	unsigned char stream2_frame_drop_ctrl = 0;
 	char osd_string[12] = {"0"};
 	pthread_t thread_capture_id;
+
+	memset(&rec_main, 0, sizeof(rec_main));
+	memset(rec_stream, 0, sizeof(rec_stream));
+	memset(rec_subs, 0, sizeof(rec_subs));
+	memset(&writer_cfg, 0, sizeof(writer_cfg));
+	writer_cfg.flags = FW_FLAG_DIRECT | FW_FLAG_URING;
+	memset(&md_mon_cfg, 0, sizeof(md_mon_cfg));
+	md_mon_cfg.flags = MD_MON_FLAG_EVENTS;
+	rec_main.basename = rec_filename;
+	rec_stream[MS_STREAM_HD].basename = rec_filename1;
+	rec_stream[MS_STREAM_VGA].basename = rec_filename4;
+	rec_stream[MS_STREAM_QVGA].basename = rec_filename2;
+	rec_stream[MS_STREAM_QQVGA].basename = rec_filename3;
 #if(CARCAM_PROJECT == 1)
 	printf("%s   ******  for Carcam  ******\n",TESTAP_VERSION);
 #else
@@ -1664,6 +1805,19 @@ int main(int argc, char *argv[])
 		case OPT_DEBUG_LEVEL:
 			Dbg_Param = strtol(optarg, &endptr, 16);
 			break;
+		case OPT_WRITERS:
+			writer_cfg.threads = atoi(optarg);
+			break;
+		case OPT_MD_POLL:
+			md_mon_cfg.min_interval_ms = strtoul(optarg, &endptr, 10);
+			if(*endptr == ':')
+				md_mon_cfg.max_interval_ms = strtoul(endptr + 1, &endptr, 10);
+			if(*endptr == ':')
+				md_mon_cfg.latency_ms = strtoul(endptr + 1, &endptr, 10);
+			break;
+		case OPT_REFRESH_CACHE:
+			refresh_cache = 1;
+			break;
 		default:
 			TestAp_Printf(TESTAP_DBG_ERR, "Invalid option -%c\n", c);
 			TestAp_Printf(TESTAP_DBG_ERR, "Run %s -h for help.\n", argv[0]);
@@ -1677,6 +1831,7 @@ int main(int argc, char *argv[])
 	}
 
 	/* Open the video device. */
+	clock_gettime(CLOCK_MONOTONIC, &t_open);
 	dev = video_open(argv[optind]);
 	if (dev < 0)
 		return 1;
@@ -1688,14 +1843,27 @@ int main(int argc, char *argv[])
 
 	// RERVISION XU Ctrl ++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-	ret = XU_Ctrl_ReadChipID(dev);
+	/* Chip ID, XU mappings and the H.264 format table come from the per-device cache while it is valid */
+	if(DevCacheOpen(&dev_cache, dev, NULL) >= 0)
+	{
+		devc = &dev_cache;
+		if(refresh_cache)
+		{
+			for(k = 0; k < DEV_CACHE_TAG_COUNT; k++)
+				DevCacheDrop(devc, (DEV_CACHE_TAG)k);
+		}
+	}
+	else
+		TestAp_Printf(TESTAP_DBG_FLOW, "Device cache not used: %s\n", dev_cache.stats.reason);
+
+	ret = DevCacheReadChipID(devc, dev);
 	if(ret<0)
 		TestAp_Printf(TESTAP_DBG_ERR, "RERVISION_UVC_TestAP @main : XU_Ctrl_ReadChipID Failed\n");
 
 	/* Add XU ctrls */
 	if(do_add_xu_ctrl)
 	{
-		ret = XU_Init_Ctrl(dev);
+		ret = DevCacheInitXuCtrl(devc, dev);
 		if(ret<0)
 		{
 			if(ret == -EEXIST)
@@ -1723,10 +1891,19 @@ int main(int argc, char *argv[])
 
 	if(do_xu_get_fmt)
 	{
-		if(!H264_GetFormat(dev))
+		if(!DevCacheGetH264Format(devc, dev))
 			TestAp_Printf(TESTAP_DBG_ERR, "RERVISION_UVC_TestAP @main : H264 Get Format Failed\n");
 	}
 
+	if(devc != NULL)
+	{
+		if(DevCacheSave(devc) < 0)
+			TestAp_Printf(TESTAP_DBG_ERR, "Device cache: can't write %s\n", devc->path);
+		TestAp_Printf(TESTAP_DBG_FLOW, "Device cache %s: %s (sysfs %lu us, load %lu us)\n", devc->path,
+			devc->stats.hit ? "hit" : devc->stats.reason, devc->stats.sysfs_us, devc->stats.load_us);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t_probe);
+
 	if(do_xu_set_fmt)
 	{
 		if(XU_H264_SetFormat(dev, cur_H264fmt) < 0)
@@ -1777,7 +1954,7 @@ int main(int argc, char *argv[])
 		TestAp_Printf(TESTAP_DBG_FLOW, "  Control Selector = 0x%x \n", SetCS);
 		TestAp_Printf(TESTAP_DBG_FLOW, "  Cmd Data Number  = %d \n", SetCmdDataNum);
 			
-		if(XU_Set_Cur(dev, SetXU_ID, SetCS, SetCmdDataNum, &SetData) < 0)
+		if(XU_Set_Cur(dev, SetXU_ID, SetCS, SetCmdDataNum, SetData) < 0)
 			TestAp_Printf(TESTAP_DBG_ERR, "RERVISION_UVC_TestAP @main : XU_Set Failed\n");
 	}
 
@@ -1790,7 +1967,7 @@ int main(int argc, char *argv[])
 		for(i=0; i<GetCmdDataNum; i++)
 			TestAp_Printf(TESTAP_DBG_FLOW, "  Cmd Data[%d] = 0x%x\n", i, GetData[i]);		
 
-		if(XU_Get_Cur(dev, GetXU_ID, GetCS, GetCmdDataNum, &GetData) < 0)
+		if(XU_Get_Cur(dev, GetXU_ID, GetCS, GetCmdDataNum, GetData) < 0)
 			TestAp_Printf(TESTAP_DBG_ERR, "RERVISION_UVC_TestAP @main : XU_Get Failed\n");
 	}
 
@@ -2585,6 +2762,20 @@ int main(int argc, char *argv[])
 			//TestAp_Printf(TESTAP_DBG_ERR, "RERVISION_UVC_TestAP @main : XU_OSD_Set_Multi_Size Failed\n");
 	}	
 
+	/* --save/--record files are written by the frame writer threads, never by the capture loops */
+	if(do_save || do_record)
+	{
+		writer = FrameWriterCreate(&writer_cfg);
+		if(writer == NULL)
+		{
+			close(dev);
+			if(multi_stream_enable)
+				close(fake_dev);
+			TestAp_Printf(TESTAP_DBG_ERR, "Create frame writer error!\n");
+			return 1;
+		}
+	}
+
 	if((do_record)&&(do_save)&&(multi_stream_enable!=0)&&(pixelformat == V4L2_PIX_FMT_H264))
 	{
 		struct thread_parameter par;
@@ -2595,15 +2786,66 @@ int main(int argc, char *argv[])
 		par.dev = &fake_dev;
 		par.nframes = &nframes;
 		par.multi_stream_mjpg_enable = (multi_stream_enable & 0x02) >> 1;
+
+		/* JPEG files are written by a demux consumer; frames of unknown size are skipped in multi-stream MJPEG mode */
+		jpg_demux = MsDemuxCreate();
+		if(jpg_demux == NULL || MsDemuxSubscribe(jpg_demux, "jpeg", par.multi_stream_mjpg_enable ? MS_STREAM_ALL_KNOWN : MS_STREAM_MASK(MS_STREAM_OTHER),
+				MS_POLICY_BLOCK, 16, -1, jpeg_save_consumer, writer) == NULL)
+		{
+			MsDemuxDestroy(jpg_demux);
+			close(dev);
+			close(fake_dev);
+			TestAp_Printf(TESTAP_DBG_ERR, "Create JPEG demux error!\n");
+			return 1;
+		}
+		par.demux = jpg_demux;
 		
 		ret = pthread_create(&thread_capture_id,NULL,thread_capture,(void*)&par);
 		if(ret != 0)
 		{
+			MsDemuxDestroy(jpg_demux);
 			close(dev);
 			close(fake_dev);
 			TestAp_Printf(TESTAP_DBG_ERR, "Create pthread error!\n");
 			return 1;
 		}
+		thread_started = 1;
+	}
+
+	rec_main.pixelformat = pixelformat;
+	rec_main.writer = writer;
+	for(k = 0; k < 4; k++)
+	{
+		rec_stream[k].pixelformat = pixelformat;
+		rec_stream[k].writer = writer;
+	}
+
+	/* Multi-stream recording: one BLOCK consumer per stream so a slow file never stalls the capture loop
+	 * for the other streams and no recorded frame is lost. Falls back to inline writes if the demux can't start. */
+	if((do_record)&&((multi_stream_enable & 0x01) == 1))
+	{
+		rec_demux = MsDemuxCreate();
+		for(k = 0; rec_demux != NULL && k < 4; k++)
+		{
+			rec_subs[k] = MsDemuxSubscribe(rec_demux, rec_stream[k].basename, MS_STREAM_MASK(k), MS_POLICY_BLOCK, 64, -1,
+				record_consumer, &rec_stream[k]);
+			if(rec_subs[k] == NULL)
+			{
+				TestAp_Printf(TESTAP_DBG_ERR, "MS demux: subscribe failed, recording inline\n");
+				MsDemuxDestroy(rec_demux);
+				rec_demux = NULL;
+			}
+		}
+	}
+
+	memset(&ms_parser, 0, sizeof(ms_parser));
+
+	/* MD results are read by the monitor thread and printed only when they change */
+	if(do_md_result_get)
+	{
+		md_mon = MdMonitorCreate(dev, &md_mon_cfg, md_result_changed, NULL);
+		if(md_mon == NULL)
+			TestAp_Printf(TESTAP_DBG_ERR, "MD monitor: create failed, reading the result every frame\n");
 	}
 
 	for (i = 0; i < nframes; ++i) {
@@ -2629,24 +2871,19 @@ int main(int argc, char *argv[])
 
 		if(multi_stream_enable)
 		{
-			h264_decode_seq_parameter_set(mem0[buf0.index]+4, buf0.bytesused, &multi_stream_width, &multi_stream_height);
+			/* Repeated SPS/PPS are matched against the parser cache; parsing stops at the first slice header. */
+			ms_keyframe = 0;
+			if (H264ParseFrame(&ms_parser, (unsigned char*)mem0[buf0.index], buf0.bytesused, &ms_info) == 0) {
+				multi_stream_width = ms_info.width;
+				multi_stream_height = ms_info.height;
+				ms_keyframe = ms_info.keyframe;
+			}
 			
 			multi_stream_resolution = (multi_stream_width << 16) | (multi_stream_height);
-			if(multi_stream_resolution == H264_SIZE_HD)
+			ms_stream = MsDemuxClassify(multi_stream_resolution);
+			if(ms_stream != MS_STREAM_OTHER)
 			{
-				TestAp_Printf(TESTAP_DBG_FRAME, "[   HD]  ");		
-			}
-			else if(multi_stream_resolution == H264_SIZE_VGA)
-			{
-				TestAp_Printf(TESTAP_DBG_FRAME, "[  VGA]  ");
-			}
-			else if(multi_stream_resolution == H264_SIZE_QVGA)
-			{
-				TestAp_Printf(TESTAP_DBG_FRAME, "[ QVGA]  ");
-			}
-			else if(multi_stream_resolution == H264_SIZE_QQVGA)
-			{
-				TestAp_Printf(TESTAP_DBG_FRAME, "[QQVGA]  ");
+				TestAp_Printf(TESTAP_DBG_FRAME, "[%s]  ", MsDemuxStreamName(ms_stream));
 			}
 			else
 			{
@@ -2657,25 +2894,27 @@ int main(int argc, char *argv[])
 
 		TestAp_Printf(TESTAP_DBG_FRAME, "Frame[%4u] %u bytes %ld.%06ld %ld.%06ld\n ", i, buf0.bytesused, buf0.timestamp.tv_sec, buf0.timestamp.tv_usec, ts.tv_sec, ts.tv_usec);
 
-		if(do_md_result_get)
+		if(do_md_result_get && md_mon == NULL)
 		{
 			if(XU_MD_Get_RESULT(dev, md_mask) <0)
 				TestAp_Printf(TESTAP_DBG_ERR, "RERVISION_UVC_TestAP @main : XU_MD_Get_RESULT Failed\n");
 		}
 
 		if (i == 0)
+		{
 			start = ts;
+			clock_gettime(CLOCK_MONOTONIC, &t_first);
+			printf("Startup to first frame: %.1f ms (device probe %.1f ms, device cache %s)\n",
+				(t_first.tv_sec - t_open.tv_sec) * 1000.0 + (t_first.tv_nsec - t_open.tv_nsec) / 1e6,
+				(t_probe.tv_sec - t_open.tv_sec) * 1000.0 + (t_probe.tv_nsec - t_open.tv_nsec) / 1e6,
+				devc == NULL ? "off" : (devc->stats.hit && !refresh_cache) ? "hit" : "miss");
+		}
 
 		/* Save the image. */
 		if ((do_save && !skip)&&(pixelformat == V4L2_PIX_FMT_MJPEG))
 		{
 			sprintf(filename, "frame-%06u.jpg", i);
-			file = fopen(filename, "wb");
-			if (file != NULL) {
-				fwrite(mem0[buf0.index], buf0.bytesused, 1, file);
-					
-				fclose(file);
-			}
+			save_jpeg(writer, filename, mem0[buf0.index], buf0.bytesused);
 		}
 		if (skip)
 			--skip;
@@ -2685,51 +2924,14 @@ int main(int argc, char *argv[])
 		{
 			if((multi_stream_enable & 0x01) == 1)
 			{
-				if(multi_stream_resolution == H264_SIZE_HD)
-				{
-					if(rec_fp1 == NULL)
-						rec_fp1 = fopen(rec_filename1, "a+b");
-					
-					if(rec_fp1 != NULL)
-						fwrite(mem0[buf0.index], buf0.bytesused, 1, rec_fp1);
-				}
-
-				if(multi_stream_resolution == H264_SIZE_VGA)
-				{
-					if(rec_fp4 == NULL)
-						rec_fp4 = fopen(rec_filename4, "a+b");
-					
-					if(rec_fp4 != NULL)
-						fwrite(mem0[buf0.index], buf0.bytesused, 1, rec_fp4);
-				}
-
-				if(multi_stream_resolution == H264_SIZE_QVGA)
-				{
-					if(rec_fp2 == NULL)
-						rec_fp2 = fopen(rec_filename2, "a+b");
-					
-					if(rec_fp2 != NULL)
-						fwrite(mem0[buf0.index], buf0.bytesused, 1, rec_fp2);
-				}
-
-				if(multi_stream_resolution == H264_SIZE_QQVGA)
-				{
-					if(rec_fp3 == NULL)
-						rec_fp3 = fopen(rec_filename3, "a+b");
-					
-					if(rec_fp3 != NULL)
-						fwrite(mem0[buf0.index], buf0.bytesused, 1, rec_fp3);
-				}
+				if(rec_demux != NULL)
+					MsDemuxPublish(rec_demux, multi_stream_resolution, mem0[buf0.index], buf0.bytesused, &buf0.timestamp, ms_keyframe);
+				else if(ms_stream != MS_STREAM_OTHER)
+					record_frame(&rec_stream[ms_stream], mem0[buf0.index], buf0.bytesused, &buf0.timestamp);
 			}
 			else
 			{
-				if(rec_fp1 == NULL)
-					rec_fp1 = fopen(rec_filename, "a+b");
-
-				if(rec_fp1 != NULL)
-				{
-					fwrite(mem0[buf0.index], buf0.bytesused, 1, rec_fp1);
-				}
+				record_frame(&rec_main, mem0[buf0.index], buf0.bytesused, &buf0.timestamp);
 			}
 		}
 
@@ -2750,8 +2952,16 @@ int main(int argc, char *argv[])
 	}
 	gettimeofday(&end, NULL);
 
-	if((do_record)&&(do_save)&&(multi_stream_enable == 1)&&(pixelformat == V4L2_PIX_FMT_H264))
+	if(md_mon != NULL)
+	{
+		md_monitor_report(md_mon);
+		MdMonitorDestroy(md_mon);
+	}
+
+	if(thread_started)
 		pthread_join(thread_capture_id,NULL);
+	if(jpg_demux != NULL)
+		MsDemuxDestroy(jpg_demux);
 	
 	/* Stop streaming. */
 	video_enable(dev, 0);
@@ -2759,14 +2969,28 @@ int main(int argc, char *argv[])
 	if(multi_stream_enable)
 		video_enable(fake_dev, 0);
 
-	if(do_record && rec_fp1 != NULL)
-		fclose(rec_fp1);
-	
-	if(do_record && rec_fp2 != NULL)
-		fclose(rec_fp2);
+	if(rec_demux != NULL)
+	{
+		/* drain the recorder queues before the files are closed */
+		MsDemuxStop(rec_demux);
+		demux_report("MS record", rec_subs, 4);
+		MsDemuxDestroy(rec_demux);
+	}
 
-	if(do_record && rec_fp3 != NULL)
-		fclose(rec_fp3);		
+	if(do_record)
+	{
+		record_close(&rec_main);
+		for(k = 0; k < 4; k++)
+			record_close(&rec_stream[k]);
+	}
+
+	if(writer != NULL)
+	{
+		/* waits for every queued file to reach the disk */
+		FrameWriterFlush(writer);
+		writer_report(writer);
+		FrameWriterDestroy(writer);
+	}
 
 	end.tv_sec -= start.tv_sec;
 	end.tv_usec -= start.tv_usec;
@@ -2785,6 +3009,7 @@ int main(int argc, char *argv[])
 		free(gH264fmt);
 		gH264fmt = NULL;
 	}
+	DevCacheClose(devc);
 
 	close(dev);
 	if(multi_stream_enable)
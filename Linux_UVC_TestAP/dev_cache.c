@@ -0,0 +1,546 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/sysmacros.h>
+#include "h264_xu_ctrls.h"
+#include "dev_cache.h"
+
+#define DEV_CACHE_MAGIC             "RVDC"
+#define DEV_CACHE_VERSION           1
+#define DEV_CACHE_MAX_FILE          (sizeof(struct cache_file_header) + DEV_CACHE_TAG_COUNT * (8 + DEV_CACHE_MAX_ENTRY) + 4)
+
+// 파일 배치: 헤더, (tag, len, data) x count, 앞 전체의 CRC32. 같은 호스트에서만 읽으므로 호스트 바이트 순서
+struct cache_file_header
+{
+    char magic[4];
+    unsigned int version;
+    DEV_CACHE_KEY key;
+    unsigned int count;
+};
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static unsigned int crc32_update(unsigned int crc, const unsigned char *p, size_t len)
+{
+    static unsigned int table[256];
+    unsigned int c;
+    int i, k;
+
+    if(table[1] == 0)
+    {
+        for(i = 0; i < 256; i++)
+        {
+            c = i;
+            for(k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    while(len--)
+        crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+// ===== sysfs =====
+
+static int read_file(const char *dir, const char *name, unsigned char *buf, int size)
+{
+    char path[PATH_MAX];
+    int fd, n, total = 0;
+
+    if(snprintf(path, sizeof(path), "%s/%s", dir, name) >= (int)sizeof(path))
+        return -1;
+    fd = open(path, O_RDONLY);
+    if(fd < 0)
+        return -1;
+    while(total < size && (n = read(fd, buf + total, size - total)) > 0)
+        total += n;
+    close(fd);
+    return total;
+}
+
+// 텍스트 속성 하나 (끝의 개행 제거). 없으면 -1
+static int read_attr(const char *dir, const char *name, char *buf, int size)
+{
+    int n;
+
+    n = read_file(dir, name, (unsigned char *)buf, size - 1);
+    if(n < 0)
+        return -1;
+    while(n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' '))
+        n--;
+    buf[n] = '\0';
+    return n;
+}
+
+static int read_attr_num(const char *dir, const char *name, int base, unsigned int *val)
+{
+    char buf[32];
+    char *end;
+
+    if(read_attr(dir, name, buf, sizeof(buf)) <= 0)
+        return -1;
+    *val = strtoul(buf, &end, base);
+    return end == buf ? -1 : 0;
+}
+
+// video 노드의 device 링크는 USB 인터페이스 디렉터리, 그 부모가 USB 장치 디렉터리
+static const char *read_identity(DEV_CACHE *cache, const char *sysfs_device)
+{
+    char usb[PATH_MAX];
+    unsigned char desc[4096];
+    unsigned int vid, pid, bcd;
+    char *slash;
+    int n;
+
+    if(realpath(sysfs_device, usb) == NULL)
+        return "sysfs 장치 없음";
+    slash = strrchr(usb, '/');
+    if(slash == NULL || slash == usb)
+        return "sysfs 장치 없음";
+    *slash = '\0';
+
+    if(read_attr_num(usb, "idVendor", 16, &vid) < 0 || read_attr_num(usb, "idProduct", 16, &pid) < 0 ||
+        read_attr_num(usb, "bcdDevice", 16, &bcd) < 0)
+        return "USB 장치 아님";
+    cache->key.vid = vid;
+    cache->key.pid = pid;
+    cache->key.bcd_device = bcd;
+    if(read_attr(usb, "serial", cache->key.serial, sizeof(cache->key.serial)) < 0)
+        cache->key.serial[0] = '\0';
+    slash = strrchr(usb, '/');
+    snprintf(cache->key.usb_port, sizeof(cache->key.usb_port), "%s", slash + 1);
+
+    // 커널이 열거 때 받아 둔 디스크립터 (읽어도 전송 없음). 펌웨어가 바뀌면 대개 같이 바뀐다
+    n = read_file(usb, "descriptors", desc, sizeof(desc));
+    if(n <= 0)
+        return "descriptors 없음";
+    cache->key.desc_crc = crc32_update(0, desc, n);
+
+    if(read_attr_num(usb, "busnum", 10, &cache->instance.busnum) < 0 ||
+        read_attr_num(usb, "devnum", 10, &cache->instance.devnum) < 0)
+        return "busnum/devnum 없음";
+    if(read_attr("/proc/sys/kernel/random", "boot_id", cache->instance.boot_id, sizeof(cache->instance.boot_id)) < 0)
+        cache->instance.boot_id[0] = '\0';
+    return NULL;
+}
+
+// ===== 파일 =====
+
+static int make_dir(const char *dir)
+{
+    char tmp[256];
+    char *p;
+
+    snprintf(tmp, sizeof(tmp), "%s", dir);
+    for(p = tmp + 1; *p; p++)
+    {
+        if(*p == '/')
+        {
+            *p = '\0';
+            mkdir(tmp, 0755);
+            *p = '/';
+        }
+    }
+    if(mkdir(tmp, 0755) < 0 && errno != EEXIST)
+        return -1;
+    return 0;
+}
+
+static int cache_path(DEV_CACHE *cache, const char *dir)
+{
+    char base[200];
+    const char *env;
+    const char *id;
+    char name[80];
+    int i, n;
+
+    if(dir == NULL)
+        dir = getenv(DEV_CACHE_DIR_ENV);
+    if(dir == NULL)
+    {
+        if((env = getenv("XDG_CACHE_HOME")) != NULL && env[0])
+            n = snprintf(base, sizeof(base), "%s/rervision_uvc", env);
+        else if((env = getenv("HOME")) != NULL && env[0])
+            n = snprintf(base, sizeof(base), "%s/.cache/rervision_uvc", env);
+        else
+            n = snprintf(base, sizeof(base), "/tmp/rervision_uvc");
+        if(n >= (int)sizeof(base))
+            return -1;
+        dir = base;
+    }
+
+    // 시리얼이 있으면 포트를 옮겨도 같은 항목, 없으면 포트마다 항목
+    if(cache->key.serial[0])
+    {
+        id = cache->key.serial;
+        n = snprintf(name, sizeof(name), "%04x-%04x-", cache->key.vid, cache->key.pid);
+    }
+    else
+    {
+        id = cache->key.usb_port;
+        n = snprintf(name, sizeof(name), "%04x-%04x-port-", cache->key.vid, cache->key.pid);
+    }
+    for(i = 0; id[i] && n < (int)sizeof(name) - 1; i++)
+        name[n++] = (id[i] == '/' || id[i] == ' ' || (unsigned char)id[i] < 0x20) ? '_' : id[i];
+    name[n] = '\0';
+
+    if(snprintf(cache->path, sizeof(cache->path), "%s/%s.cache", dir, name) >= (int)sizeof(cache->path))
+        return -1;
+    return 0;
+}
+
+static int key_matches(const DEV_CACHE_KEY *a, const DEV_CACHE_KEY *b)
+{
+    if(a->vid != b->vid || a->pid != b->pid || strcmp(a->serial, b->serial) != 0)
+        return 0;
+    if(a->serial[0] == '\0' && strcmp(a->usb_port, b->usb_port) != 0)
+        return 0;
+    return 1;
+}
+
+static const char *load_file(DEV_CACHE *cache)
+{
+    struct cache_file_header hdr;
+    struct stat st;
+    unsigned char *buf;
+    unsigned int crc, tag, len, i;
+    size_t off;
+    int fd, n, total = 0;
+    const char *reason = NULL;
+
+    fd = open(cache->path, O_RDONLY);
+    if(fd < 0)
+        return "캐시 파일 없음";
+    if(fstat(fd, &st) < 0 || st.st_size < (off_t)(sizeof(hdr) + 4) || st.st_size > (off_t)DEV_CACHE_MAX_FILE)
+    {
+        close(fd);
+        return "캐시 파일 크기 이상";
+    }
+    buf = (unsigned char *)malloc(st.st_size);
+    if(buf == NULL)
+    {
+        close(fd);
+        return "메모리 부족";
+    }
+    while(total < st.st_size && (n = read(fd, buf + total, st.st_size - total)) > 0)
+        total += n;
+    close(fd);
+
+    memcpy(&crc, buf + st.st_size - 4, 4);
+    memcpy(&hdr, buf, sizeof(hdr));
+    if(total != st.st_size || crc32_update(0, buf, st.st_size - 4) != crc)
+        reason = "캐시 파일 손상";
+    else if(memcmp(hdr.magic, DEV_CACHE_MAGIC, 4) != 0 || hdr.version != DEV_CACHE_VERSION)
+        reason = "캐시 형식 다름";
+    else if(!key_matches(&hdr.key, &cache->key))
+        reason = "다른 장치";
+    else if(hdr.key.bcd_device != cache->key.bcd_device)
+        reason = "펌웨어 버전 바뀜";
+    else if(hdr.key.desc_crc != cache->key.desc_crc)
+        reason = "USB 디스크립터 바뀜";
+
+    off = sizeof(hdr);
+    for(i = 0; reason == NULL && i < hdr.count; i++)
+    {
+        if(off + 8 > (size_t)st.st_size - 4)
+        {
+            reason = "캐시 파일 손상";
+            break;
+        }
+        memcpy(&tag, buf + off, 4);
+        memcpy(&len, buf + off + 4, 4);
+        off += 8;
+        if(tag >= DEV_CACHE_TAG_COUNT || len > DEV_CACHE_MAX_ENTRY || off + len > (size_t)st.st_size - 4)
+        {
+            reason = "캐시 파일 손상";
+            break;
+        }
+        DevCachePut(cache, (DEV_CACHE_TAG)tag, buf + off, len);
+        off += len;
+    }
+    free(buf);
+
+    if(reason != NULL)
+    {
+        // 남은 항목을 버리고 새로 채운다 (저장할 때 덮어씀)
+        for(i = 0; i < DEV_CACHE_TAG_COUNT; i++)
+            DevCacheDrop(cache, (DEV_CACHE_TAG)i);
+        return reason;
+    }
+    cache->dirty = 0;
+    return NULL;
+}
+
+// ===== API =====
+
+int DevCacheOpenSysfs(DEV_CACHE *cache, const char *sysfs_device, const char *dir)
+{
+    unsigned long long t0, t1;
+
+    memset(cache, 0, sizeof(*cache));
+    t0 = now_us();
+    cache->stats.reason = read_identity(cache, sysfs_device);
+    if(cache->stats.reason == NULL && cache_path(cache, dir) < 0)
+        cache->stats.reason = "캐시 경로가 너무 김";
+    t1 = now_us();
+    cache->stats.sysfs_us = t1 - t0;
+    if(cache->stats.reason != NULL)
+    {
+        cache->path[0] = '\0';
+        return -1;
+    }
+
+    cache->stats.reason = load_file(cache);
+    cache->stats.load_us = now_us() - t1;
+    cache->stats.hit = cache->stats.reason == NULL;
+    return cache->stats.hit;
+}
+
+int DevCacheOpen(DEV_CACHE *cache, int fd, const char *dir)
+{
+    char sysfs_device[64];
+    struct stat st;
+
+    if(fstat(fd, &st) < 0 || !S_ISCHR(st.st_mode))
+    {
+        memset(cache, 0, sizeof(*cache));
+        cache->stats.reason = "문자 장치 아님";
+        return -1;
+    }
+    snprintf(sysfs_device, sizeof(sysfs_device), "/sys/dev/char/%u:%u/device", major(st.st_rdev), minor(st.st_rdev));
+    return DevCacheOpenSysfs(cache, sysfs_device, dir);
+}
+
+const void *DevCacheGet(DEV_CACHE *cache, DEV_CACHE_TAG tag, unsigned int *len)
+{
+    if(cache == NULL || tag >= DEV_CACHE_TAG_COUNT || cache->data[tag] == NULL)
+        return NULL;
+    if(len)
+        *len = cache->len[tag];
+    return cache->data[tag];
+}
+
+int DevCachePut(DEV_CACHE *cache, DEV_CACHE_TAG tag, const void *data, unsigned int len)
+{
+    unsigned char *copy;
+
+    if(cache == NULL || cache->path[0] == '\0' || tag >= DEV_CACHE_TAG_COUNT || len > DEV_CACHE_MAX_ENTRY)
+        return -1;
+    if(cache->data[tag] != NULL && cache->len[tag] == len && memcmp(cache->data[tag], data, len) == 0)
+        return 0;
+    copy = (unsigned char *)malloc(len ? len : 1);
+    if(copy == NULL)
+        return -1;
+    memcpy(copy, data, len);
+    free(cache->data[tag]);
+    cache->data[tag] = copy;
+    cache->len[tag] = len;
+    cache->dirty = 1;
+    return 0;
+}
+
+void DevCacheDrop(DEV_CACHE *cache, DEV_CACHE_TAG tag)
+{
+    if(cache == NULL || tag >= DEV_CACHE_TAG_COUNT || cache->data[tag] == NULL)
+        return;
+    free(cache->data[tag]);
+    cache->data[tag] = NULL;
+    cache->len[tag] = 0;
+    cache->dirty = 1;
+}
+
+int DevCacheSave(DEV_CACHE *cache)
+{
+    struct cache_file_header hdr;
+    char dir[256], tmp[300];
+    unsigned char *buf;
+    unsigned int crc, i, tag;
+    unsigned long long t0;
+    size_t size, off;
+    char *slash;
+    int fd, ok;
+
+    if(cache == NULL || cache->path[0] == '\0' || !cache->dirty)
+        return 0;
+    t0 = now_us();
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, DEV_CACHE_MAGIC, 4);
+    hdr.version = DEV_CACHE_VERSION;
+    hdr.key = cache->key;
+    size = sizeof(hdr) + 4;
+    for(i = 0; i < DEV_CACHE_TAG_COUNT; i++)
+    {
+        if(cache->data[i] != NULL)
+        {
+            hdr.count++;
+            size += 8 + cache->len[i];
+        }
+    }
+
+    buf = (unsigned char *)malloc(size);
+    if(buf == NULL)
+        return -1;
+    memcpy(buf, &hdr, sizeof(hdr));
+    off = sizeof(hdr);
+    for(i = 0; i < DEV_CACHE_TAG_COUNT; i++)
+    {
+        if(cache->data[i] == NULL)
+            continue;
+        tag = i;
+        memcpy(buf + off, &tag, 4);
+        memcpy(buf + off + 4, &cache->len[i], 4);
+        memcpy(buf + off + 8, cache->data[i], cache->len[i]);
+        off += 8 + cache->len[i];
+    }
+    crc = crc32_update(0, buf, off);
+    memcpy(buf + off, &crc, 4);
+
+    snprintf(dir, sizeof(dir), "%s", cache->path);
+    slash = strrchr(dir, '/');
+    if(slash != NULL && slash != dir)
+    {
+        *slash = '\0';
+        make_dir(dir);
+    }
+
+    // 같은 장치로 동시에 실행해도 읽는 쪽은 옛 파일이나 새 파일 하나만 본다
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", cache->path, (int)getpid());
+    fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ok = fd >= 0 && write(fd, buf, size) == (ssize_t)size;
+    if(fd >= 0)
+        ok = (close(fd) == 0) && ok;
+    ok = ok && rename(tmp, cache->path) == 0;
+    if(!ok)
+        unlink(tmp);
+    free(buf);
+
+    cache->stats.save_us = now_us() - t0;
+    if(!ok)
+        return -1;
+    cache->dirty = 0;
+    return 0;
+}
+
+void DevCacheClose(DEV_CACHE *cache)
+{
+    int i;
+
+    if(cache == NULL)
+        return;
+    for(i = 0; i < DEV_CACHE_TAG_COUNT; i++)
+    {
+        free(cache->data[i]);
+        cache->data[i] = NULL;
+    }
+    cache->path[0] = '\0';
+}
+
+// ===== XU 시작 절차 =====
+
+static int chip_known(unsigned int id)
+{
+    return id == CHIP_RER9420 || id == CHIP_RER9421 || id == CHIP_RER9422;
+}
+
+int DevCacheReadChipID(DEV_CACHE *cache, int fd)
+{
+    const void *data;
+    unsigned int len, id;
+    int ret;
+
+    data = DevCacheGet(cache, DEV_CACHE_CHIP_ID, &len);
+    if(data != NULL && len == sizeof(id))
+    {
+        memcpy(&id, data, sizeof(id));
+        if(chip_known(id))
+        {
+            chip_id = id;
+            return 0;
+        }
+    }
+
+    ret = XU_Ctrl_ReadChipID(fd);
+    if(ret >= 0 && chip_known(chip_id))
+        DevCachePut(cache, DEV_CACHE_CHIP_ID, &chip_id, sizeof(chip_id));
+    return ret;
+}
+
+int DevCacheInitXuCtrl(DEV_CACHE *cache, int fd)
+{
+    const DEV_CACHE_INSTANCE *inst;
+    unsigned int len;
+    int ret;
+
+    // 같은 장치 인스턴스에 같은 매핑 세트가 드라이버에 남아 있으면 건너뛴다
+    inst = (const DEV_CACHE_INSTANCE *)DevCacheGet(cache, DEV_CACHE_XU_MAPPING, &len);
+    if(inst != NULL && len == sizeof(*inst) &&
+        inst->busnum == cache->instance.busnum && inst->devnum == cache->instance.devnum &&
+        strcmp(inst->boot_id, cache->instance.boot_id) == 0 &&
+        DevCacheReadChipID(cache, fd) >= 0 && inst->chip_id == chip_id && XU_Ctrl_Mapped(fd))
+        return 0;
+
+    ret = XU_Init_Ctrl(fd);
+    if(ret < 0 || cache == NULL)
+        return ret;
+
+    if(chip_known(chip_id))
+        DevCachePut(cache, DEV_CACHE_CHIP_ID, &chip_id, sizeof(chip_id));
+    if(XU_Ctrl_Mapped(fd))
+    {
+        cache->instance.chip_id = chip_id;
+        DevCachePut(cache, DEV_CACHE_XU_MAPPING, &cache->instance, sizeof(cache->instance));
+    }
+    else
+        DevCacheDrop(cache, DEV_CACHE_XU_MAPPING);
+    return ret;
+}
+
+int DevCacheGetH264Format(DEV_CACHE *cache, int fd)
+{
+    const void *data;
+    unsigned char *fwData = NULL;
+    unsigned short fwLen = 0;
+    unsigned int len;
+    int ret, success;
+
+    // 포맷 테이블 배치가 칩에 따라 다르므로 칩 ID 를 먼저 안다
+    data = DevCacheGet(cache, DEV_CACHE_H264_FORMAT, &len);
+    if(data != NULL && len > 0 && len <= 0xffff && chip_known(chip_id))
+    {
+        fwData = (unsigned char *)malloc(len);
+        if(fwData != NULL)
+        {
+            memcpy(fwData, data, len);
+            success = H264_LoadFormat(fwData, (unsigned short)len);
+            free(fwData);
+            if(success)
+                return success;
+        }
+        DevCacheDrop(cache, DEV_CACHE_H264_FORMAT);
+    }
+
+    ret = H264_ReadFormat(fd, &fwData, &fwLen);
+    success = H264_LoadFormat(fwData, fwLen);
+    // 기본 테이블로 대신한 경우나 일부만 읽은 경우는 저장하지 않는다
+    if(ret >= 0 && success && chip_known(chip_id))
+        DevCachePut(cache, DEV_CACHE_H264_FORMAT, fwData, fwLen);
+    free(fwData);
+    return success;
+}
@@ -0,0 +1,95 @@
+#ifndef _DEV_CACHE_H_
+#define _DEV_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 장치별 능력 / XU 매핑 캐시 (디스크)
+// 시작할 때마다 하던 칩 ID 읽기, XU 매핑, H.264 포맷 테이블 읽기는 모두 느린 USB 컨트롤 전송이다.
+// 결과를 USB 시리얼 + 펌웨어 버전(bcdDevice)으로 찾는 파일에 저장해 두고 다음 실행에서는 건너뛴다.
+// - 키 확인은 sysfs 만 읽는다 (VID / PID / bcdDevice / serial, 커널이 보관한 descriptors 의 CRC).
+//   제어 전송이 없으므로 캐시가 맞으면 첫 프레임 전까지 XU 전송 0 회
+// - 시리얼이 없는 장치는 USB 포트 경로를 대신 쓴다 (같은 포트에 같은 모델을 꽂으면 같은 항목)
+// - XU 매핑은 드라이버에 남아 있는 동안만 유효하므로 장치 인스턴스(boot_id + busnum + devnum)를
+//   함께 기록하고, 재연결 / 재부팅 / 드라이버 재적재(XU_Ctrl_Mapped 로 확인) 때는 다시 매핑한다
+// - 파일은 CRC 로 검증하고 임시 파일 + rename 으로 바꾼다. 깨졌거나 키가 다르면 처음부터 다시 읽는다
+// 저장 위치: dir 인자 > $RERVISION_CACHE_DIR > $XDG_CACHE_HOME/rervision_uvc > ~/.cache/rervision_uvc
+
+#define DEV_CACHE_DIR_ENV           "RERVISION_CACHE_DIR"
+#define DEV_CACHE_MAX_ENTRY         8192            // 항목 하나의 최대 크기
+
+typedef enum
+{
+    DEV_CACHE_CHIP_ID = 0,          // unsigned int chip_id (CHIP_RER942X)
+    DEV_CACHE_H264_FORMAT,          // XU_H264_GetFormatData 원본 (H264_LoadFormat 으로 해석)
+    DEV_CACHE_CAPABILITY,           // 캡 디스크립터 원본 (OSD 펌웨어 GetCapability)
+    DEV_CACHE_XU_MAPPING,           // 매핑을 적용한 장치 인스턴스 (DEV_CACHE_INSTANCE)
+    DEV_CACHE_TAG_COUNT
+} DEV_CACHE_TAG;
+
+typedef struct
+{
+    unsigned short vid;
+    unsigned short pid;
+    unsigned short bcd_device;      // 펌웨어 버전
+    char serial[64];                // 없으면 빈 문자열
+    char usb_port[32];              // 1-1.2 (시리얼이 없을 때만 키에 포함)
+    unsigned int desc_crc;          // USB descriptors 파일 CRC32
+} DEV_CACHE_KEY;
+
+typedef struct
+{
+    char boot_id[40];
+    unsigned int busnum;
+    unsigned int devnum;            // 재연결마다 바뀐다
+    unsigned int chip_id;           // 적용한 매핑 세트
+} DEV_CACHE_INSTANCE;
+
+typedef struct
+{
+    unsigned long sysfs_us;         // 키 / 인스턴스 읽기
+    unsigned long load_us;          // 파일 읽기 + 검증
+    unsigned long save_us;
+    int hit;                        // 1: 파일이 있었고 키가 맞음
+    const char *reason;             // 캐시를 쓰지 못한 이유 (hit 이면 NULL)
+} DEV_CACHE_STATS;
+
+typedef struct
+{
+    DEV_CACHE_KEY key;
+    DEV_CACHE_INSTANCE instance;    // 지금 열린 장치
+    char path[256];
+    int dirty;
+    unsigned int len[DEV_CACHE_TAG_COUNT];
+    unsigned char *data[DEV_CACHE_TAG_COUNT];   // NULL 이면 없음
+    DEV_CACHE_STATS stats;
+} DEV_CACHE;
+
+// fd 의 장치 노드(/sys/dev/char/M:m/device)로 키를 만들고 캐시 파일을 읽는다.
+// 1: 캐시 적중, 0: 새 항목 (키는 맞게 채워짐), -1: USB 장치가 아니거나 sysfs 를 읽을 수 없음
+int DevCacheOpen(DEV_CACHE *cache, int fd, const char *dir);
+
+// sysfs_device 는 video 노드의 device 링크 (USB 인터페이스 디렉터리). 시험용 가짜 트리에 쓴다
+int DevCacheOpenSysfs(DEV_CACHE *cache, const char *sysfs_device, const char *dir);
+
+// 항목이 없으면 NULL
+const void *DevCacheGet(DEV_CACHE *cache, DEV_CACHE_TAG tag, unsigned int *len);
+int DevCachePut(DEV_CACHE *cache, DEV_CACHE_TAG tag, const void *data, unsigned int len);
+void DevCacheDrop(DEV_CACHE *cache, DEV_CACHE_TAG tag);
+
+// 바뀐 항목이 있을 때만 쓴다. 실패해도 캐시 없이 동작하면 되므로 -1 만 돌려준다
+int DevCacheSave(DEV_CACHE *cache);
+void DevCacheClose(DEV_CACHE *cache);
+
+// XU 시작 절차의 캐시 적용판. cache 가 NULL 이면 원래 함수와 같다.
+// 장치에서 읽은 결과는 캐시에 넣는다 (DevCacheSave 로 저장)
+int DevCacheReadChipID(DEV_CACHE *cache, int fd);      // XU_Ctrl_ReadChipID
+int DevCacheInitXuCtrl(DEV_CACHE *cache, int fd);      // XU_Init_Ctrl
+int DevCacheGetH264Format(DEV_CACHE *cache, int fd);   // H264_GetFormat (성공 1)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,488 @@
+//----------------------------------------------//
+//	장치 캐시 벤치마크 / 검증						//
+//----------------------------------------------//
+// 사용법: ./dev_cache_bench [ms_per_transfer]
+// 가짜 sysfs(USB 장치 + 인터페이스 디렉터리)와 ioctl 을 가로채는 모의 RER9422 를 두고
+// TestAP 의 시작 절차(칩 ID → XU 매핑 → H.264 포맷 테이블)를 여러 상황에서 실행한다.
+//   legacy   : 캐시 없이 (기존 main 과 같은 호출)
+//   cold     : 캐시 파일 없음 → 장치에서 읽고 저장
+//   warm     : 같은 장치 인스턴스 → 전송 0 회
+//   replug   : devnum 이 바뀜 → 매핑만 다시 (칩 / 포맷은 캐시)
+//   reload   : 드라이버 재적재 (devnum 같고 매핑 없음) → XU_Ctrl_Mapped 로 알아채고 다시 매핑
+//   firmware : bcdDevice / 포맷 테이블 바뀜 → 전부 다시 읽고 새 테이블
+//   corrupt  : 캐시 파일 한 바이트 손상 → 거부하고 다시 읽음
+//   noserial : 시리얼 없는 장치 → 포트 경로 키
+// 상황마다 칩 ID 와 해석한 포맷 테이블이 장치 값과 같은지 확인하고 불일치가 있으면 1 을 반환한다.
+// 시간은 전송 횟수 x 전송당 지연(기본 2ms) + 실제 걸린 시간(sysfs / 파일)으로 계산한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include "h264_xu_ctrls.h"
+#include "dev_cache.h"
+
+// h264_xu_ctrls.c 가 참조하는 TestAP 전역
+struct H264Format *gH264fmt = NULL;
+int Dbg_Param = 0;
+
+#define MOCK_FD         42
+#define MOCK_MAX_MAPS   32
+
+// 모의 장치: ASIC 읽기(칩 ID / DRAM), FRAME_INFO(포맷 테이블), 드라이버의 XU 매핑
+static struct {
+    unsigned char asic_addr;
+    int info_sub;
+    int expect_data;
+    int read_off;
+    unsigned char table[256];
+    int table_len;
+    unsigned int mapped[MOCK_MAX_MAPS];
+    int nmapped;
+    unsigned char info_loaded[256];     // (unit 대신 GUID 첫 바이트, selector) 별 GET_INFO / GET_LEN 완료
+    unsigned int transfers;
+} mock;
+
+static int table_count;             // gH264fmt 항목 수 (H264_CountFormat 은 chip_id 에 따라 달라진다)
+
+static char root[128];
+static char usb_dir[256];
+static char intf_link[256];
+static char cache_dir[256];
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// 9421/9422 배치: W(2) H(2) fps 수(1) 프레임 크기(4) + fps 마다 간격(2) 페이로드(4)
+static void mock_set_table(int nfmt)
+{
+    static const unsigned short sizes[][2] = { {1920, 1080}, {1280, 720}, {640, 480}, {320, 240}, {160, 120} };
+    static const unsigned short intervals[] = { 0x1458, 0x1e84, 0x28b0 };
+    int i, j, off = 0;
+
+    for (i = 0; i < nfmt; i++) {
+        unsigned int frame = sizes[i][0] * sizes[i][1] / 4;
+        mock.table[off++] = sizes[i][0] >> 8;
+        mock.table[off++] = sizes[i][0] & 0xff;
+        mock.table[off++] = sizes[i][1] >> 8;
+        mock.table[off++] = sizes[i][1] & 0xff;
+        mock.table[off++] = 3;
+        mock.table[off++] = frame >> 24;
+        mock.table[off++] = frame >> 16;
+        mock.table[off++] = frame >> 8;
+        mock.table[off++] = frame;
+        for (j = 0; j < 3; j++) {
+            unsigned int payload = 0x1000 * (i + 1) + j;
+            mock.table[off++] = intervals[j] >> 8;
+            mock.table[off++] = intervals[j] & 0xff;
+            mock.table[off++] = payload >> 24;
+            mock.table[off++] = payload >> 16;
+            mock.table[off++] = payload >> 8;
+            mock.table[off++] = payload;
+        }
+    }
+    mock.table_len = off;
+}
+
+// 드라이버가 사라진 매핑 (재연결 / 모듈 재적재)
+static void mock_unplug(void)
+{
+    mock.nmapped = 0;
+    memset(mock.info_loaded, 0, sizeof(mock.info_loaded));
+}
+
+static int mock_xu_query(struct uvc_xu_control_query *q)
+{
+    mock.transfers++;
+
+    if (q->unit == XU_RERVISION_SYS_ID && q->selector == XU_RERVISION_SYS_ASIC_RW) {
+        if (q->query == UVC_SET_CUR)
+            mock.asic_addr = q->data[0];
+        else if (mock.asic_addr == 0x1f)
+            q->data[2] = 0x92;          // RER9422 계열
+        else if (mock.asic_addr == 0x07)
+            q->data[2] = 0x00;          // DRAM 64M → RER9422
+        return 0;
+    }
+
+    if (q->unit == XU_RERVISION_USR_ID && q->selector == XU_RERVISION_USR_FRAME_INFO) {
+        if (q->query == UVC_SET_CUR) {
+            if (!mock.expect_data && q->data[0] == 0x9A) {
+                mock.info_sub = q->data[1];
+                mock.expect_data = 1;
+            } else {
+                mock.expect_data = 0;
+                mock.read_off = 0;      // 스트림 / 포맷 선택
+            }
+            return 0;
+        }
+        mock.expect_data = 0;
+        memset(q->data, 0, q->size);
+        if (mock.info_sub == 0x01) {
+            q->data[5] = 1;
+        } else if (mock.info_sub == 0x02) {
+            q->data[6] = mock.table_len >> 8;
+            q->data[7] = mock.table_len & 0xff;
+        } else if (mock.info_sub == 0x03) {
+            int n = mock.table_len - mock.read_off;
+            if (n > q->size)
+                n = q->size;
+            if (n > 0)
+                memcpy(q->data, mock.table + mock.read_off, n);
+            mock.read_off += q->size;
+        }
+        return 0;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+static int mock_ioctl(int fd, unsigned long request, void *arg)
+{
+    int i;
+
+    if (fd != MOCK_FD) {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (request == UVCIOC_CTRL_QUERY)
+        return mock_xu_query((struct uvc_xu_control_query *)arg);
+
+    if (request == UVCIOC_CTRL_MAP) {
+        struct uvc_xu_control_mapping *map = (struct uvc_xu_control_mapping *)arg;
+        unsigned int key = ((map->entity[0] & 0x0f) << 4) | (map->selector & 0x0f);
+
+        for (i = 0; i < mock.nmapped; i++) {
+            if (mock.mapped[i] == map->id) {
+                errno = EEXIST;
+                return -1;
+            }
+        }
+        // uvcvideo 는 컨트롤마다 처음 매핑할 때 GET_INFO + GET_LEN 을 보낸다
+        if (!mock.info_loaded[key]) {
+            mock.info_loaded[key] = 1;
+            mock.transfers += 2;
+        }
+        mock.mapped[mock.nmapped++] = map->id;
+        return 0;
+    }
+
+    if (request == VIDIOC_QUERYCTRL) {
+        struct v4l2_queryctrl *qc = (struct v4l2_queryctrl *)arg;
+        for (i = 0; i < mock.nmapped; i++)
+            if (mock.mapped[i] == qc->id)
+                return 0;
+        errno = EINVAL;
+        return -1;
+    }
+
+    errno = ENOTTY;
+    return -1;
+}
+
+// ===== 가짜 sysfs =====
+
+static int write_text(const char *dir, const char *name, const char *text)
+{
+    char path[512];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    fp = fopen(path, "w");
+    if (!fp)
+        return -1;
+    fputs(text, fp);
+    fclose(fp);
+    return 0;
+}
+
+static int write_descriptors(const char *bcd)
+{
+    unsigned char desc[64];
+    char path[512];
+    FILE *fp;
+    int i;
+
+    // 장치 디스크립터 (bcdDevice 포함) + 설정 디스크립터 흉내
+    memset(desc, 0, sizeof(desc));
+    desc[0] = 18;
+    desc[1] = 1;
+    desc[8] = 0x45; desc[9] = 0x0c; desc[10] = 0x66; desc[11] = 0x63;
+    desc[12] = (unsigned char)strtoul(bcd + 2, NULL, 16);
+    desc[13] = (unsigned char)(strtoul(bcd, NULL, 16) >> 8);
+    for (i = 18; i < (int)sizeof(desc); i++)
+        desc[i] = (unsigned char)(i * 7);
+
+    snprintf(path, sizeof(path), "%s/descriptors", usb_dir);
+    fp = fopen(path, "wb");
+    if (!fp)
+        return -1;
+    fwrite(desc, 1, sizeof(desc), fp);
+    fclose(fp);
+    return 0;
+}
+
+static int sysfs_setup(void)
+{
+    char intf[300];
+
+    snprintf(root, sizeof(root), "/tmp/dev_cache_bench_%d", (int)getpid());
+    snprintf(usb_dir, sizeof(usb_dir), "%s/usb1/1-1.2", root);
+    snprintf(intf, sizeof(intf), "%s/1-1.2:1.0", usb_dir);
+    snprintf(intf_link, sizeof(intf_link), "%s/video0_device", root);
+    snprintf(cache_dir, sizeof(cache_dir), "%s/cache", root);
+
+    if (mkdir(root, 0755) < 0)
+        return -1;
+    snprintf(intf, sizeof(intf), "%s/usb1", root);
+    mkdir(intf, 0755);
+    mkdir(usb_dir, 0755);
+    snprintf(intf, sizeof(intf), "%s/1-1.2:1.0", usb_dir);
+    mkdir(intf, 0755);
+    if (symlink(intf, intf_link) < 0)
+        return -1;
+
+    write_text(usb_dir, "idVendor", "0c45\n");
+    write_text(usb_dir, "idProduct", "6366\n");
+    write_text(usb_dir, "bcdDevice", "0102\n");
+    write_text(usb_dir, "serial", "SN0001\n");
+    write_text(usb_dir, "busnum", "1\n");
+    write_text(usb_dir, "devnum", "5\n");
+    return write_descriptors("0102");
+}
+
+static void sysfs_cleanup(void)
+{
+    char cmd[300];
+
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", root);
+    if (system(cmd) != 0)
+        printf("정리 실패: %s\n", root);
+}
+
+// ===== 시작 절차 =====
+
+typedef struct {
+    unsigned int transfers;
+    unsigned long wall_us;
+    int hit;
+    const char *reason;
+    unsigned int chip;
+    char table[1024];               // 해석한 포맷 테이블 (문자열로 비교)
+} run_t;
+
+static void snapshot_table(char *out, int size)
+{
+    int i, j, n = 0, count;
+
+    out[0] = '\0';
+    if (gH264fmt == NULL)
+        return;
+    count = table_count = H264_CountFormat(mock.table, mock.table_len);
+    for (i = 0; i < count && n < size - 64; i++) {
+        n += snprintf(out + n, size - n, "%dx%d/%u:", gH264fmt[i].wWidth, gH264fmt[i].wHeight, gH264fmt[i].FrameSize);
+        for (j = 0; j < gH264fmt[i].fpsCnt * 2 && n < size - 16; j++)
+            n += snprintf(out + n, size - n, "%x,", gH264fmt[i].FrPay[j]);
+        n += snprintf(out + n, size - n, " ");
+    }
+}
+
+static void free_table(void)
+{
+    int i;
+
+    if (gH264fmt == NULL)
+        return;
+    for (i = 0; i < table_count; i++)
+        free(gH264fmt[i].FrPay);
+    free(gH264fmt);
+    gH264fmt = NULL;
+}
+
+// TestAP main 과 같은 순서. use_cache 가 0 이면 기존 호출 그대로
+static int run_startup(int use_cache, run_t *r)
+{
+    DEV_CACHE cache;
+    DEV_CACHE *devc = NULL;
+    unsigned long long t0;
+    int err = 0;
+
+    // 새 프로세스처럼
+    chip_id = CHIP_NONE;
+    XU_Cache_Invalidate(MOCK_FD);
+    free_table();
+    memset(r, 0, sizeof(*r));
+    mock.transfers = 0;
+
+    t0 = now_us();
+    if (use_cache) {
+        r->hit = DevCacheOpenSysfs(&cache, intf_link, cache_dir);
+        r->reason = cache.stats.reason;
+        if (r->hit >= 0)
+            devc = &cache;
+        if (DevCacheReadChipID(devc, MOCK_FD) < 0)
+            err = 1;
+        if (DevCacheInitXuCtrl(devc, MOCK_FD) < 0)
+            err = 1;
+        // 칩 ID 를 읽은 뒤 포맷 테이블 (main 은 --xuget-fmt 일 때)
+        if (!DevCacheGetH264Format(devc, MOCK_FD))
+            err = 1;
+        if (devc != NULL && DevCacheSave(devc) < 0)
+            err = 1;
+        DevCacheClose(devc);
+    } else {
+        if (XU_Ctrl_ReadChipID(MOCK_FD) < 0 || XU_Init_Ctrl(MOCK_FD) < 0 || !H264_GetFormat(MOCK_FD))
+            err = 1;
+    }
+    r->wall_us = now_us() - t0;
+    r->transfers = mock.transfers;
+    r->chip = chip_id;
+    snapshot_table(r->table, sizeof(r->table));
+    return err;
+}
+
+static void corrupt_cache_file(void)
+{
+    char path[512];
+    FILE *fp;
+    long size;
+    int c;
+
+    snprintf(path, sizeof(path), "%s/0c45-6366-SN0001.cache", cache_dir);
+    fp = fopen(path, "r+b");
+    if (!fp)
+        return;
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, size / 2, SEEK_SET);
+    c = fgetc(fp);
+    fseek(fp, size / 2, SEEK_SET);
+    fputc(c ^ 0x5a, fp);
+    fclose(fp);
+}
+
+int main(int argc, char **argv)
+{
+    double ms_per_transfer = 2.0;
+    run_t legacy, r;
+    char fw_table[1024];
+    int failures = 0;
+
+    if (argc >= 2)
+        ms_per_transfer = atof(argv[1]);
+    if (ms_per_transfer <= 0) {
+        printf("사용법: %s [ms_per_transfer]\n", argv[0]);
+        return 2;
+    }
+    if (sysfs_setup() < 0) {
+        printf("가짜 sysfs 를 만들 수 없음: %s\n", root);
+        return 1;
+    }
+
+    XU_Set_Ioctl(mock_ioctl);
+    mock_set_table(4);
+
+    printf("=== 장치 캐시 벤치마크 (전송당 %.1f ms 가정, 시작 → 첫 프레임 중 XU 부분) ===\n", ms_per_transfer);
+
+#define REPORT(name, run) \
+    printf("%-9s: 전송 %3u회  %7.1f ms  (실제 %4lu us)  %s\n", name, (run).transfers, \
+           (run).transfers * ms_per_transfer + (run).wall_us / 1000.0, (run).wall_us, \
+           (run).hit > 0 ? "캐시 적중" : (run).reason ? (run).reason : "")
+
+#define CHECK(cond, msg) do { if (!(cond)) { printf("  실패: %s\n", msg); failures++; } } while (0)
+
+    if (run_startup(0, &legacy))
+        failures++;
+    REPORT("legacy", legacy);
+    CHECK(legacy.chip == CHIP_RER9422 && legacy.table[0], "legacy 칩 ID / 포맷 테이블");
+
+    // 각 상황의 첫 실행은 드라이버에 매핑이 없는 상태에서 (legacy 와 전송 수 비교)
+    mock_unplug();
+    failures += run_startup(1, &r);
+    REPORT("cold", r);
+    CHECK(r.hit == 0, "cold 는 캐시 파일이 없어야 함");
+    CHECK(r.transfers == legacy.transfers, "cold 전송 수가 legacy 와 다름");
+    CHECK(r.chip == legacy.chip && strcmp(r.table, legacy.table) == 0, "cold 결과가 legacy 와 다름");
+
+    failures += run_startup(1, &r);
+    REPORT("warm", r);
+    CHECK(r.hit == 1 && r.transfers == 0, "warm 은 전송 0 회여야 함");
+    CHECK(r.chip == legacy.chip && strcmp(r.table, legacy.table) == 0, "warm 결과가 legacy 와 다름");
+
+    // 재연결: 새 devnum, 드라이버 매핑 없음
+    mock_unplug();
+    write_text(usb_dir, "devnum", "6\n");
+    failures += run_startup(1, &r);
+    REPORT("replug", r);
+    CHECK(r.hit == 1 && r.transfers > 0 && r.transfers < legacy.transfers, "replug 는 매핑만 다시 해야 함");
+    CHECK(mock.nmapped > 0 && strcmp(r.table, legacy.table) == 0, "replug 매핑 / 포맷 테이블");
+    failures += run_startup(1, &r);
+    CHECK(r.transfers == 0, "replug 다음 시작은 전송 0 회여야 함");
+
+    // 드라이버 재적재: devnum 은 같고 매핑만 사라짐
+    mock_unplug();
+    failures += run_startup(1, &r);
+    REPORT("reload", r);
+    CHECK(r.hit == 1 && r.transfers > 0 && mock.nmapped > 0, "reload 는 다시 매핑해야 함");
+
+    // 펌웨어 교체: 장치가 다시 열거되고 bcdDevice 와 포맷 테이블이 바뀜
+    write_text(usb_dir, "bcdDevice", "0103\n");
+    write_text(usb_dir, "devnum", "7\n");
+    write_descriptors("0103");
+    mock_set_table(5);
+    mock_unplug();
+    if (run_startup(0, &legacy))
+        failures++;
+    strcpy(fw_table, legacy.table);
+    mock_unplug();
+    failures += run_startup(1, &r);
+    REPORT("firmware", r);
+    CHECK(r.hit == 0 && r.transfers == legacy.transfers, "firmware 는 전부 다시 읽어야 함");
+    CHECK(strcmp(r.table, fw_table) == 0, "firmware 새 포맷 테이블과 다름");
+    failures += run_startup(1, &r);
+    CHECK(r.hit == 1 && r.transfers == 0 && strcmp(r.table, fw_table) == 0, "firmware 다음 시작은 새 테이블로 적중해야 함");
+
+    // 파일 손상 (매핑 기록도 잃으므로 legacy 와 비교할 수 있게 매핑도 없는 상태에서)
+    corrupt_cache_file();
+    mock_unplug();
+    failures += run_startup(1, &r);
+    REPORT("corrupt", r);
+    CHECK(r.hit == 0 && r.transfers == legacy.transfers && strcmp(r.table, fw_table) == 0, "corrupt 는 거부하고 다시 읽어야 함");
+    failures += run_startup(1, &r);
+    CHECK(r.hit == 1 && r.transfers == 0, "corrupt 다음 시작은 적중해야 함");
+
+    // 시리얼 없는 장치: 포트 경로 키
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/serial", usb_dir);
+        unlink(path);
+    }
+    write_text(usb_dir, "devnum", "8\n");
+    mock_unplug();
+    failures += run_startup(1, &r);
+    REPORT("noserial", r);
+    CHECK(r.hit == 0 && r.transfers == legacy.transfers, "noserial 은 새 항목이어야 함");
+    failures += run_startup(1, &r);
+    CHECK(r.hit == 1 && r.transfers == 0 && strcmp(r.table, fw_table) == 0, "noserial 다음 시작은 적중해야 함");
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/0c45-6366-port-1-1.2.cache", cache_dir);
+        CHECK(access(path, R_OK) == 0, "포트 경로 캐시 파일 이름");
+    }
+
+    free_table();
+    sysfs_cleanup();
+    printf("검증: %s\n", failures ? "실패" : "모든 상황에서 칩 ID / 포맷 테이블이 장치 값과 일치");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,380 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "frame_bus.h"
+
+struct FRAME_BUS
+{
+    char name[FB_NAME_MAX];
+    unsigned char *base;
+    size_t size;
+    FB_HEADER *hdr;
+    FB_SLOT_DESC *slots;
+    uint64_t next;                  // 다음 프레임 번호 (라이터만 씀)
+    FB_STATS stats;
+};
+
+struct FB_READER
+{
+    const unsigned char *base;
+    size_t size;
+    const FB_HEADER *hdr;
+    const FB_SLOT_DESC *slots;
+    unsigned int slot_count;
+    unsigned int slot_size;
+    unsigned int slot_stride;
+    unsigned int data_offset;
+    FB_READ_MODE mode;
+    uint64_t cursor;                // 다음에 받을 프레임 번호
+    FB_READER_STATS stats;
+};
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// 프로세스 사이에서 쓰므로 FUTEX_PRIVATE_FLAG 없이
+static int futex_wait(const uint32_t *addr, uint32_t val, const struct timespec *timeout)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+static int futex_wake(uint32_t *addr)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static void make_name(char *out, const char *name)
+{
+    snprintf(out, FB_NAME_MAX, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+static unsigned int page_align(unsigned long long v)
+{
+    return (unsigned int)((v + FB_PAGE - 1) & ~(unsigned long long)(FB_PAGE - 1));
+}
+
+FRAME_BUS *FrameBusCreate(const char *name, unsigned int slot_count, unsigned int slot_size)
+{
+    FRAME_BUS *bus;
+    unsigned int stride, data_offset;
+    int fd;
+
+    if(!name || !name[0] || slot_size == 0)
+        return NULL;
+    if(slot_count == 0)
+        slot_count = FB_DEFAULT_SLOTS;
+    if(slot_count < 2 || slot_count > FB_MAX_SLOTS)
+        return NULL;
+
+    bus = (FRAME_BUS *)calloc(1, sizeof(*bus));
+    if(!bus)
+        return NULL;
+    make_name(bus->name, name);
+
+    stride = page_align(slot_size);
+    data_offset = page_align(sizeof(FB_HEADER) + slot_count * sizeof(FB_SLOT_DESC));
+    bus->size = data_offset + (size_t)slot_count * stride;
+
+    // 남아 있던 같은 이름은 지우고 새로 만든다 (이전 리더는 옛 매핑을 계속 가짐)
+    shm_unlink(bus->name);
+    fd = shm_open(bus->name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0)
+    {
+        fprintf(stderr, "frame bus %s: shm_open: %s\n", bus->name, strerror(errno));
+        free(bus);
+        return NULL;
+    }
+    if(ftruncate(fd, (off_t)bus->size) < 0)
+    {
+        fprintf(stderr, "frame bus %s: ftruncate: %s\n", bus->name, strerror(errno));
+        close(fd);
+        shm_unlink(bus->name);
+        free(bus);
+        return NULL;
+    }
+    bus->base = (unsigned char *)mmap(NULL, bus->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(bus->base == MAP_FAILED)
+    {
+        shm_unlink(bus->name);
+        free(bus);
+        return NULL;
+    }
+
+    bus->hdr = (FB_HEADER *)bus->base;
+    bus->slots = (FB_SLOT_DESC *)(bus->base + sizeof(FB_HEADER));
+    bus->hdr->version = FB_VERSION;
+    bus->hdr->slot_count = slot_count;
+    bus->hdr->slot_size = slot_size;
+    bus->hdr->slot_stride = stride;
+    bus->hdr->data_offset = data_offset;
+    bus->hdr->writer_pid = (uint32_t)getpid();
+    bus->hdr->created_ns = now_ns();
+    // magic 은 마지막에: 리더는 magic 을 보고 나머지를 믿는다
+    __atomic_store_n(&bus->hdr->magic, FB_MAGIC, __ATOMIC_RELEASE);
+    return bus;
+}
+
+long long FrameBusPublish(FRAME_BUS *bus, const struct iovec *iov, int cnt, const FB_META *meta)
+{
+    unsigned long long t0 = now_ns();
+    uint64_t n;
+    FB_SLOT_DESC *d;
+    unsigned char *dst;
+    unsigned int used = 0, room;
+    int i;
+
+    if(!bus || (cnt > 0 && !iov))
+        return -1;
+
+    n = bus->next;
+    d = &bus->slots[n % bus->hdr->slot_count];
+    dst = bus->base + bus->hdr->data_offset + (size_t)(n % bus->hdr->slot_count) * bus->hdr->slot_stride;
+
+    // seqlock 시작: 홀수를 먼저 보이게 한 뒤 데이터를 쓴다
+    __atomic_store_n(&d->seq, 2 * n + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    room = bus->hdr->slot_size;
+    for(i = 0; i < cnt; i++)
+    {
+        unsigned int len = (unsigned int)iov[i].iov_len;
+        if(len > room - used)
+        {
+            len = room - used;
+            bus->stats.truncated++;
+        }
+        memcpy(dst + used, iov[i].iov_base, len);
+        used += len;
+        if(used == room)
+            break;
+    }
+
+    d->bytes = used;
+    d->width = meta ? meta->width : 0;
+    d->height = meta ? meta->height : 0;
+    d->pixfmt = meta ? meta->pixfmt : 0;
+    d->sequence = meta ? meta->sequence : 0;
+    d->timestamp_us = meta ? meta->timestamp_us : 0;
+    d->flags = meta ? meta->flags : 0;
+    d->publish_ns = now_ns();
+    __atomic_store_n(&d->seq, 2 * n + 2, __ATOMIC_RELEASE);
+
+    bus->next = n + 1;
+    __atomic_store_n(&bus->hdr->published, n + 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&bus->hdr->notify, 1, __ATOMIC_RELEASE);
+    futex_wake(&bus->hdr->notify);
+
+    bus->stats.published++;
+    bus->stats.bytes += used;
+    t0 = (now_ns() - t0) / 1000;
+    if(t0 > bus->stats.max_publish_us)
+        bus->stats.max_publish_us = t0;
+    return (long long)n;
+}
+
+void FrameBusGetStats(FRAME_BUS *bus, FB_STATS *stats)
+{
+    if(bus && stats)
+        *stats = bus->stats;
+}
+
+void FrameBusDestroy(FRAME_BUS *bus)
+{
+    FB_META eos;
+
+    if(!bus)
+        return;
+    memset(&eos, 0, sizeof(eos));
+    eos.flags = FB_FLAG_EOS;
+    FrameBusPublish(bus, NULL, 0, &eos);
+    munmap(bus->base, bus->size);
+    shm_unlink(bus->name);
+    free(bus);
+}
+
+FB_READER *FrameBusOpen(const char *name, FB_READ_MODE mode)
+{
+    char path[FB_NAME_MAX];
+    FB_READER *r;
+    FB_HEADER hdr;
+    struct stat st;
+    void *p;
+    int fd;
+
+    if(!name || !name[0])
+        return NULL;
+    make_name(path, name);
+    fd = shm_open(path, O_RDONLY, 0);
+    if(fd < 0)
+        return NULL;
+    if(fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(FB_HEADER) ||
+       pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) ||
+       hdr.magic != FB_MAGIC || hdr.version != FB_VERSION ||
+       hdr.slot_count < 2 || hdr.slot_count > FB_MAX_SLOTS ||
+       (unsigned long long)hdr.data_offset + (unsigned long long)hdr.slot_count * hdr.slot_stride > (unsigned long long)st.st_size)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    r = (FB_READER *)calloc(1, sizeof(*r));
+    if(!r)
+    {
+        close(fd);
+        return NULL;
+    }
+    r->size = (size_t)st.st_size;
+    p = mmap(NULL, r->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(p == MAP_FAILED)
+    {
+        free(r);
+        return NULL;
+    }
+    r->base = (const unsigned char *)p;
+    r->hdr = (const FB_HEADER *)r->base;
+    r->slots = (const FB_SLOT_DESC *)(r->base + sizeof(FB_HEADER));
+    r->slot_count = hdr.slot_count;
+    r->slot_size = hdr.slot_size;
+    r->slot_stride = hdr.slot_stride;
+    r->data_offset = hdr.data_offset;
+    r->mode = mode;
+    r->cursor = __atomic_load_n(&r->hdr->published, __ATOMIC_ACQUIRE);
+    return r;
+}
+
+static int slot_intact(const FB_READER *r, uint64_t frame)
+{
+    const FB_SLOT_DESC *d = &r->slots[frame % r->slot_count];
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&d->seq, __ATOMIC_RELAXED) == 2 * frame + 2;
+}
+
+int FrameBusNext(FB_READER *r, FB_FRAME *frame, int timeout_ms)
+{
+    unsigned long long deadline = 0;
+
+    if(!r || !frame)
+        return -1;
+    if(timeout_ms >= 0)
+        deadline = now_ns() + (unsigned long long)timeout_ms * 1000000ULL;
+
+    for(;;)
+    {
+        // notify 를 먼저 읽어야 그 뒤의 게시를 futex 가 놓치지 않는다
+        uint32_t seen = __atomic_load_n(&r->hdr->notify, __ATOMIC_ACQUIRE);
+        uint64_t pub = __atomic_load_n(&r->hdr->published, __ATOMIC_ACQUIRE);
+
+        if(pub > r->cursor)
+        {
+            uint64_t target = r->cursor;
+            const FB_SLOT_DESC *d;
+            uint64_t seq;
+
+            if(r->mode == FB_READ_LATEST)
+            {
+                target = pub - 1;
+            }
+            else if(pub - target > r->slot_count - 1)
+            {
+                // 프레임 pub 을 쓰는 슬롯은 피한다: 남은 것 중 가장 오래된 프레임으로
+                target = pub - (r->slot_count - 1);
+            }
+
+            d = &r->slots[target % r->slot_count];
+            seq = __atomic_load_n(&d->seq, __ATOMIC_ACQUIRE);
+            if(seq != 2 * target + 2)
+            {
+                // 확인하는 사이 라이터가 링을 한 바퀴 돌았다: 다시 본다
+                r->stats.skipped += target + 1 - r->cursor;
+                r->cursor = target + 1;
+                continue;
+            }
+
+            frame->data = r->base + r->data_offset + (size_t)(target % r->slot_count) * r->slot_stride;
+            frame->bytes = d->bytes <= r->slot_size ? d->bytes : r->slot_size;
+            frame->width = d->width;
+            frame->height = d->height;
+            frame->pixfmt = d->pixfmt;
+            frame->sequence = d->sequence;
+            frame->flags = d->flags;
+            frame->timestamp_us = d->timestamp_us;
+            frame->publish_ns = d->publish_ns;
+            frame->frame = target;
+            frame->skipped = (unsigned int)(target - r->cursor);
+
+            // 설명자를 읽는 사이 덮어써졌으면 버린다
+            if(!slot_intact(r, target))
+            {
+                r->stats.skipped += target + 1 - r->cursor;
+                r->cursor = target + 1;
+                continue;
+            }
+
+            r->stats.skipped += frame->skipped;
+            r->stats.frames++;
+            r->cursor = target + 1;
+            return 1;
+        }
+
+        struct timespec ts, *tsp = NULL;
+        if(timeout_ms >= 0)
+        {
+            unsigned long long now = now_ns();
+            if(now >= deadline)
+                return 0;
+            ts.tv_sec = (deadline - now) / 1000000000ULL;
+            ts.tv_nsec = (deadline - now) % 1000000000ULL;
+            tsp = &ts;
+        }
+        if(futex_wait(&r->hdr->notify, seen, tsp) < 0 &&
+           errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+            return -1;
+    }
+}
+
+int FrameBusValid(FB_READER *r, const FB_FRAME *frame)
+{
+    if(!r || !frame)
+        return 0;
+    if(slot_intact(r, frame->frame))
+        return 1;
+    r->stats.torn++;
+    return 0;
+}
+
+unsigned int FrameBusSlotSize(FB_READER *r)
+{
+    return r ? r->slot_size : 0;
+}
+
+void FrameBusReaderStats(FB_READER *r, FB_READER_STATS *stats)
+{
+    if(r && stats)
+        *stats = r->stats;
+}
+
+void FrameBusClose(FB_READER *r)
+{
+    if(!r)
+        return;
+    munmap((void *)r->base, r->size);
+    free(r);
+}
@@ -0,0 +1,144 @@
+#ifndef _FRAME_BUS_H_
+#define _FRAME_BUS_H_
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 공유 메모리 프레임 버스
+// 카메라를 연 프로세스 하나가 POSIX 공유 메모리 (/dev/shm/<name>) 의 슬롯 링에 프레임을 게시하고,
+// 여러 로컬 프로세스(뷰어, 파이썬 스크립트)가 읽기 전용으로 매핑해서 복사 없이 읽는다.
+// - 슬롯마다 seqlock: 쓰는 중에는 seq 가 홀수, 프레임 n 이 완성되면 2n+2
+// - 게시할 때마다 notify 를 올리고 futex 로 기다리는 리더를 깨운다 (리더가 없으면 syscall 한 번)
+// - 리더 커서는 리더 프로세스에 있다. 라이터는 리더를 기다리지 않고 링을 덮어쓰며,
+//   늦은 리더는 아직 남아 있는 가장 오래된 프레임(SEQUENTIAL) 또는 최신 프레임(LATEST)으로 건너뛴다
+// - 받은 포인터는 슬롯이 덮어써지기 전까지만 유효하다. 다 쓴 뒤 FrameBusValid 로 확인한다
+//
+// 배치 (모두 리틀엔디안, test_cam/frame_bus_reader.py 와 같다)
+//   0     FB_HEADER (64 바이트)
+//   64    FB_SLOT_DESC x slot_count (64 바이트씩)
+//   data_offset + i * slot_stride   슬롯 i 데이터 (페이지 정렬)
+
+#define FB_MAGIC                0x42435655      // "UVCB"
+#define FB_VERSION              1
+#define FB_PAGE                 4096
+#define FB_DEFAULT_SLOTS        8
+#define FB_MAX_SLOTS            62              // 머리 + 설명자가 첫 페이지에 들어가도록
+#define FB_NAME_MAX             64
+
+#define FB_FLAG_KEYFRAME        0x01
+#define FB_FLAG_EOS             0x80            // 라이터가 끝남 (데이터 없음)
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;             // 슬롯 하나에 들어가는 최대 프레임 크기
+    uint32_t slot_stride;           // 슬롯 간격 (FB_PAGE 배수)
+    uint32_t data_offset;           // 첫 슬롯 위치 (FB_PAGE 배수)
+    uint32_t writer_pid;
+    uint32_t notify;                // futex: 게시할 때마다 +1
+    uint64_t published;             // 게시한 프레임 수 (= 다음 프레임 번호)
+    uint64_t created_ns;            // CLOCK_MONOTONIC
+    uint64_t reserved[2];
+} FB_HEADER;
+
+typedef struct
+{
+    uint64_t seq;                   // 2n+1: 프레임 n 을 쓰는 중, 2n+2: 프레임 n 완성
+    uint64_t timestamp_us;          // V4L2 버퍼 timestamp
+    uint64_t publish_ns;            // 게시 시각 (CLOCK_MONOTONIC)
+    uint32_t bytes;
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixfmt;                // V4L2_PIX_FMT_*
+    uint32_t sequence;              // V4L2 sequence
+    uint32_t flags;                 // FB_FLAG_*
+    uint32_t reserved[4];
+} FB_SLOT_DESC;
+
+// 게시할 프레임 정보
+typedef struct
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int pixfmt;
+    unsigned int sequence;
+    unsigned long long timestamp_us;
+    unsigned int flags;
+} FB_META;
+
+typedef enum
+{
+    FB_READ_SEQUENTIAL = 0,         // 순서대로, 덮어써진 프레임만 건너뜀 (녹화 / 분석)
+    FB_READ_LATEST                  // 항상 최신 프레임 (미리보기)
+} FB_READ_MODE;
+
+typedef struct
+{
+    const unsigned char *data;      // 공유 메모리 안 (읽기 전용)
+    unsigned int bytes;
+    unsigned int width;
+    unsigned int height;
+    unsigned int pixfmt;
+    unsigned int sequence;
+    unsigned int flags;
+    unsigned long long frame;       // 버스 프레임 번호
+    unsigned long long timestamp_us;
+    unsigned long long publish_ns;
+    unsigned int skipped;           // 이 프레임 앞에서 건너뛴 프레임 수
+} FB_FRAME;
+
+typedef struct
+{
+    unsigned long long published;
+    unsigned long long bytes;
+    unsigned long truncated;        // slot_size 보다 커서 잘린 프레임
+    unsigned long long max_publish_us;  // 게시 한 번의 최대 시간 (복사 + 깨우기)
+} FB_STATS;
+
+typedef struct
+{
+    unsigned long long frames;      // 받은 프레임
+    unsigned long long skipped;     // 늦어서 건너뛴 프레임
+    unsigned long torn;             // 받은 뒤 FrameBusValid 가 덮어써짐을 알린 프레임
+} FB_READER_STATS;
+
+typedef struct FRAME_BUS FRAME_BUS;
+typedef struct FB_READER FB_READER;
+
+// 라이터: 공유 메모리를 만든다 (같은 이름이 있으면 새로 만듦). slot_count 가 0 이면 FB_DEFAULT_SLOTS
+FRAME_BUS *FrameBusCreate(const char *name, unsigned int slot_count, unsigned int slot_size);
+
+// iov 를 다음 슬롯에 모아 쓰고 리더를 깨운다. 리더를 기다리지 않는다. 프레임 번호, 실패 시 -1
+long long FrameBusPublish(FRAME_BUS *bus, const struct iovec *iov, int cnt, const FB_META *meta);
+
+void FrameBusGetStats(FRAME_BUS *bus, FB_STATS *stats);
+
+// FB_FLAG_EOS 프레임을 게시하고 공유 메모리 이름을 지운다 (이미 매핑한 리더는 계속 읽을 수 있음)
+void FrameBusDestroy(FRAME_BUS *bus);
+
+// 리더: 읽기 전용으로 매핑한다. 열기 전에 게시된 프레임은 받지 않는다. 실패 시 NULL
+FB_READER *FrameBusOpen(const char *name, FB_READ_MODE mode);
+
+// 다음 프레임을 기다린다 (timeout_ms < 0 이면 무한). 1 프레임, 0 시간 초과, -1 오류
+int FrameBusNext(FB_READER *reader, FB_FRAME *frame, int timeout_ms);
+
+// frame 을 다 쓴 뒤 호출: 그동안 덮어써지지 않았으면 1
+int FrameBusValid(FB_READER *reader, const FB_FRAME *frame);
+
+// 슬롯 데이터 크기 (리더가 버퍼를 준비할 때)
+unsigned int FrameBusSlotSize(FB_READER *reader);
+
+void FrameBusReaderStats(FB_READER *reader, FB_READER_STATS *stats);
+void FrameBusClose(FB_READER *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,430 @@
+//----------------------------------------------//
+//	공유 메모리 프레임 버스 벤치마크 / 검증		//
+//----------------------------------------------//
+// 사용법: ./frame_bus_bench                    리더 프로세스 3 개로 검증 + 파이프 방식과 비교
+//         ./frame_bus_bench --serve NAME [sec] [fps]
+//                                              합성 YUYV 640x480 을 NAME 버스에 게시 (파이썬 리더 시험용)
+// 라이터는 프레임마다 [번호 머리 | 패턴 버퍼] 두 조각을 게시하고,
+// 빠른 순차 리더 / 느린 순차 리더 / 최신 프레임 리더가 각자 받은 프레임 내용을 확인한다.
+// 내용이 틀린 프레임 (FrameBusValid 가 통과시킨 것 중), 건너뜀 회계 불일치,
+// 느린 리더가 라이터를 붙잡은 경우 (건너뛴 프레임이 없음) 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <linux/videodev2.h>
+#include "frame_bus.h"
+
+#define FRAME_W             640
+#define FRAME_H             480
+#define FRAME_BYTES         (FRAME_W * FRAME_H * 2)
+#define HEAD_BYTES          16
+#define PATTERNS            4
+#define FRAMES              600
+#define PERIOD_US           2000            // 500fps
+#define SLOW_READER_US      10000           // 느린 리더의 프레임당 처리 시간
+#define SLOTS               8
+
+typedef struct
+{
+    unsigned long long frames;
+    unsigned long long skipped;
+    unsigned long torn;
+    unsigned long mismatches;
+    unsigned long long max_latency_us;      // 게시 → 리더가 받음
+    unsigned long long sum_latency_us;
+    int got_eos;
+} READER_RESULT;
+
+static unsigned char patterns[PATTERNS][FRAME_BYTES];
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void make_patterns(void)
+{
+    unsigned int state = 12345;
+    int p, i;
+
+    for(p = 0; p < PATTERNS; p++)
+    {
+        for(i = 0; i < FRAME_BYTES; i++)
+        {
+            state = state * 1103515245u + 12345u;
+            patterns[p][i] = (unsigned char)(state >> 16);
+        }
+    }
+}
+
+static void sleep_until_us(unsigned long long t)
+{
+    unsigned long long now = now_us();
+    if(t > now)
+        usleep((useconds_t)(t - now));
+}
+
+// 프레임 n: [n (8) | n 의 패턴 번호 (4) | ~n 하위 32비트 (4)] + patterns[n % PATTERNS]
+static void fill_head(unsigned char *head, unsigned long long n)
+{
+    unsigned int p = (unsigned int)(n % PATTERNS), inv = ~(unsigned int)n;
+
+    memcpy(head, &n, 8);
+    memcpy(head + 8, &p, 4);
+    memcpy(head + 12, &inv, 4);
+}
+
+// 리더는 라이터보다 먼저 열리므로 버스 프레임 번호 = 라이터의 프레임 번호
+static int check_frame(const FB_FRAME *f)
+{
+    unsigned char head[HEAD_BYTES];
+    unsigned long long n = f->frame;
+
+    if(f->bytes != HEAD_BYTES + FRAME_BYTES || f->width != FRAME_W || f->height != FRAME_H ||
+       f->pixfmt != V4L2_PIX_FMT_YUYV || f->sequence != (unsigned int)n)
+        return 0;
+    fill_head(head, n);
+    return memcmp(f->data, head, HEAD_BYTES) == 0 &&
+           memcmp(f->data + HEAD_BYTES, patterns[n % PATTERNS], FRAME_BYTES) == 0;
+}
+
+static void run_reader(const char *name, FB_READ_MODE mode, unsigned int work_us, int ready_fd, int result_fd)
+{
+    READER_RESULT res;
+    FB_READER_STATS st;
+    FB_READER *r;
+    FB_FRAME f;
+    char ok = 1;
+
+    memset(&res, 0, sizeof(res));
+    r = FrameBusOpen(name, mode);
+    if(!r)
+        ok = 0;
+    if(write(ready_fd, &ok, 1) != 1 || !r)
+        _exit(2);
+
+    for(;;)
+    {
+        int rc = FrameBusNext(r, &f, 5000);
+        if(rc <= 0)
+            break;
+        unsigned long long lat = (now_ns() - f.publish_ns) / 1000;
+        if(f.flags & FB_FLAG_EOS)
+        {
+            res.got_eos = 1;
+            break;
+        }
+        if(lat > res.max_latency_us)
+            res.max_latency_us = lat;
+        res.sum_latency_us += lat;
+
+        // 다 쓰고 나서 검사: 검사 중에 덮어써졌으면 내용이 틀려도 불일치가 아니다
+        int good = check_frame(&f);
+        if(work_us)
+            usleep(work_us);
+        if(FrameBusValid(r, &f) && !good)
+            res.mismatches++;
+    }
+
+    FrameBusReaderStats(r, &st);
+    res.frames = st.frames;
+    res.skipped = st.skipped;
+    res.torn = st.torn;
+    FrameBusClose(r);
+    if(write(result_fd, &res, sizeof(res)) != (ssize_t)sizeof(res))
+        _exit(3);
+    _exit(0);
+}
+
+//------------------------------------------------------------------------------
+// 리더 3 개: 빠른 순차, 느린 순차, 최신
+//------------------------------------------------------------------------------
+
+static int verify_bus(void)
+{
+    static const struct
+    {
+        const char *name;
+        FB_READ_MODE mode;
+        unsigned int work_us;
+    } readers[] = {
+        { "sequential", FB_READ_SEQUENTIAL, 0 },
+        { "slow",       FB_READ_SEQUENTIAL, SLOW_READER_US },
+        { "latest",     FB_READ_LATEST,     0 },
+    };
+    const int nreaders = sizeof(readers) / sizeof(readers[0]);
+    char name[FB_NAME_MAX];
+    FRAME_BUS *bus;
+    FB_STATS st;
+    READER_RESULT res[3];
+    pid_t pids[3];
+    int ready[2], results[3][2];
+    unsigned char head[HEAD_BYTES];
+    unsigned long long t0, publish_sum_ns = 0;
+    int i, failures = 0;
+
+    snprintf(name, sizeof(name), "uvc_bus_bench_%d", (int)getpid());
+    bus = FrameBusCreate(name, SLOTS, HEAD_BYTES + FRAME_BYTES);
+    if(!bus || pipe(ready) < 0)
+    {
+        printf("버스 생성 실패\n");
+        return 1;
+    }
+
+    for(i = 0; i < nreaders; i++)
+    {
+        if(pipe(results[i]) < 0)
+            return 1;
+        pids[i] = fork();
+        if(pids[i] == 0)
+        {
+            close(ready[0]);
+            close(results[i][0]);
+            run_reader(name, readers[i].mode, readers[i].work_us, ready[1], results[i][1]);
+        }
+        close(results[i][1]);
+    }
+    close(ready[1]);
+    for(i = 0; i < nreaders; i++)
+    {
+        char ok = 0;
+        if(read(ready[0], &ok, 1) != 1 || !ok)
+        {
+            printf("리더가 버스를 열지 못함\n");
+            failures++;
+        }
+    }
+    close(ready[0]);
+
+    t0 = now_us();
+    for(i = 0; i < FRAMES; i++)
+    {
+        struct iovec iov[2];
+        FB_META meta;
+        unsigned long long p0;
+
+        sleep_until_us(t0 + (unsigned long long)i * PERIOD_US);
+        fill_head(head, i);
+        iov[0].iov_base = head;
+        iov[0].iov_len = HEAD_BYTES;
+        iov[1].iov_base = patterns[i % PATTERNS];
+        iov[1].iov_len = FRAME_BYTES;
+        memset(&meta, 0, sizeof(meta));
+        meta.width = FRAME_W;
+        meta.height = FRAME_H;
+        meta.pixfmt = V4L2_PIX_FMT_YUYV;
+        meta.sequence = i;
+        meta.timestamp_us = now_us();
+        p0 = now_ns();
+        FrameBusPublish(bus, iov, 2, &meta);
+        publish_sum_ns += now_ns() - p0;
+    }
+    FrameBusGetStats(bus, &st);
+    FrameBusDestroy(bus);       // EOS
+
+    for(i = 0; i < nreaders; i++)
+    {
+        int status = 0;
+        memset(&res[i], 0, sizeof(res[i]));
+        if(read(results[i][0], &res[i], sizeof(res[i])) != (ssize_t)sizeof(res[i]))
+        {
+            printf("  %s: 결과 없음\n", readers[i].name);
+            failures++;
+        }
+        close(results[i][0]);
+        waitpid(pids[i], &status, 0);
+    }
+
+    printf("게시 %d 프레임 (%dx%d YUYV, %d 슬롯, %d us 간격): 평균 %.1f us, 최대 %llu us\n",
+           FRAMES, FRAME_W, FRAME_H, SLOTS, PERIOD_US, publish_sum_ns / 1000.0 / FRAMES, st.max_publish_us);
+    printf("  %-11s %7s %7s %5s %8s %10s %10s\n", "reader", "frames", "skipped", "torn", "mismatch", "lat avg us", "lat max us");
+    for(i = 0; i < nreaders; i++)
+    {
+        const READER_RESULT *r = &res[i];
+        printf("  %-11s %7llu %7llu %5lu %8lu %10.1f %10llu\n", readers[i].name, r->frames, r->skipped, r->torn,
+               r->mismatches, r->frames ? (double)r->sum_latency_us / r->frames : 0.0, r->max_latency_us);
+
+        if(r->mismatches)
+            failures++;
+        if(!r->got_eos)
+        {
+            printf("  %s: EOS 를 받지 못함\n", readers[i].name);
+            failures++;
+        }
+        // EOS 도 프레임 하나로 센다
+        if(r->frames + r->skipped != FRAMES + 1)
+        {
+            printf("  %s: 받음 %llu + 건너뜀 %llu != %d\n", readers[i].name, r->frames, r->skipped, FRAMES + 1);
+            failures++;
+        }
+    }
+    if(res[1].skipped == 0)
+    {
+        printf("  느린 리더가 건너뛴 프레임이 없음 (라이터가 기다렸다는 뜻)\n");
+        failures++;
+    }
+    if(st.published != FRAMES || st.truncated)
+    {
+        printf("  라이터 통계 불일치 (published %llu, truncated %lu)\n", st.published, st.truncated);
+        failures++;
+    }
+    printf("리더 검증: %s\n", failures ? "FAIL" : "OK");
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// 비교: 파이프로 밀어 넣기 (main_pipe.c 방식) vs 버스 게시
+//------------------------------------------------------------------------------
+
+static void compare_pipe(void)
+{
+    unsigned char *buf = (unsigned char *)malloc(FRAME_BYTES);
+    int fds[2];
+    pid_t child;
+    unsigned long long t0, pipe_ns, bus_ns;
+    FRAME_BUS *bus;
+    char name[FB_NAME_MAX];
+    int i;
+
+    if(!buf || pipe(fds) < 0)
+    {
+        free(buf);
+        return;
+    }
+    child = fork();
+    if(child == 0)
+    {
+        // 소비자: 프레임마다 전부 읽는다 (커널 → 사용자 복사)
+        size_t got = 0;
+        ssize_t n;
+        close(fds[1]);
+        while((n = read(fds[0], buf, FRAME_BYTES)) > 0)
+            got += (size_t)n;
+        _exit(got == (size_t)FRAMES * FRAME_BYTES ? 0 : 1);
+    }
+    close(fds[0]);
+    t0 = now_ns();
+    for(i = 0; i < FRAMES; i++)
+    {
+        const unsigned char *p = patterns[i % PATTERNS];
+        size_t off = 0;
+        while(off < FRAME_BYTES)
+        {
+            ssize_t n = write(fds[1], p + off, FRAME_BYTES - off);
+            if(n <= 0)
+                break;
+            off += (size_t)n;
+        }
+    }
+    close(fds[1]);
+    waitpid(child, NULL, 0);
+    pipe_ns = now_ns() - t0;
+
+    snprintf(name, sizeof(name), "uvc_bus_cmp_%d", (int)getpid());
+    bus = FrameBusCreate(name, SLOTS, FRAME_BYTES);
+    if(!bus)
+    {
+        free(buf);
+        return;
+    }
+    t0 = now_ns();
+    for(i = 0; i < FRAMES; i++)
+    {
+        struct iovec iov;
+        iov.iov_base = patterns[i % PATTERNS];
+        iov.iov_len = FRAME_BYTES;
+        FrameBusPublish(bus, &iov, 1, NULL);
+    }
+    bus_ns = now_ns() - t0;
+    FrameBusDestroy(bus);
+
+    printf("\n%d 프레임 x %d 바이트 전달 (us/frame, 리더 수와 무관하게 라이터 쪽 비용)\n", FRAMES, FRAME_BYTES);
+    printf("  pipe write + read (리더 1)   %8.1f\n", pipe_ns / 1000.0 / FRAMES);
+    printf("  frame bus publish (리더 N)   %8.1f\n", bus_ns / 1000.0 / FRAMES);
+    free(buf);
+}
+
+//------------------------------------------------------------------------------
+// --serve: 합성 프레임 게시
+//------------------------------------------------------------------------------
+
+static volatile sig_atomic_t serving = 1;
+static void stop_serving(int sig) { (void)sig; serving = 0; }
+
+static int serve(const char *name, int seconds, int fps)
+{
+    FRAME_BUS *bus = FrameBusCreate(name, SLOTS, HEAD_BYTES + FRAME_BYTES);
+    unsigned char head[HEAD_BYTES];
+    unsigned long long t0, n = 0;
+
+    if(!bus)
+        return 1;
+    if(fps <= 0)
+        fps = 30;
+    signal(SIGINT, stop_serving);
+    signal(SIGTERM, stop_serving);
+    printf("게시 중: /dev/shm/%s (%dx%d YUYV + %d 바이트 머리, %d fps)\n", name[0] == '/' ? name + 1 : name,
+           FRAME_W, FRAME_H, HEAD_BYTES, fps);
+    fflush(stdout);
+
+    t0 = now_us();
+    while(serving && (seconds <= 0 || now_us() - t0 < (unsigned long long)seconds * 1000000ULL))
+    {
+        struct iovec iov[2];
+        FB_META meta;
+
+        sleep_until_us(t0 + n * 1000000ULL / fps);
+        fill_head(head, n);
+        iov[0].iov_base = head;
+        iov[0].iov_len = HEAD_BYTES;
+        iov[1].iov_base = patterns[n % PATTERNS];
+        iov[1].iov_len = FRAME_BYTES;
+        memset(&meta, 0, sizeof(meta));
+        meta.width = FRAME_W;
+        meta.height = FRAME_H;
+        meta.pixfmt = V4L2_PIX_FMT_YUYV;
+        meta.sequence = (unsigned int)n;
+        meta.timestamp_us = now_us();
+        FrameBusPublish(bus, iov, 2, &meta);
+        n++;
+    }
+    FrameBusDestroy(bus);
+    printf("게시 %llu 프레임\n", n);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int failures;
+
+    make_patterns();
+    if(argc >= 3 && strcmp(argv[1], "--serve") == 0)
+        return serve(argv[2], argc > 3 ? atoi(argv[3]) : 0, argc > 4 ? atoi(argv[4]) : 30);
+
+    failures = verify_bus();
+    compare_pipe();
+
+    if(failures)
+    {
+        printf("\n불일치 %d 건\n", failures);
+        return 1;
+    }
+    return 0;
+}
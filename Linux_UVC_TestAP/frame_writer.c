@@ -0,0 +1,911 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include "frame_writer.h"
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define FW_HAVE_URING   1
+#endif
+#endif
+
+#define FW_POOL_CLASSES 13          // 4KB << 0 .. 4KB << 12 (16MB)
+
+#define FW_JOB_FILE     0
+#define FW_JOB_CHUNK    1
+
+typedef struct FW_JOB
+{
+    struct FW_JOB *next;
+    int type;
+    unsigned char *buf;
+    int cls;                        // 풀 크기 등급
+    unsigned int len;               // 실제 데이터 길이
+    int direct;                     // 파일 작업을 O_DIRECT 로 썼는지
+    FW_STREAM *stream;
+    off_t offset;
+    unsigned long long submit_us;
+    char path[FW_PATH_MAX];
+} FW_JOB;
+
+struct FW_STREAM
+{
+    FRAME_WRITER *fw;
+    int fd;
+    int direct;
+    unsigned char *cur;             // 채우는 중인 청크
+    int cur_cls;
+    unsigned int cur_len;
+    off_t offset;                   // 다음 청크의 파일 오프셋
+    unsigned long long size;
+    int pending;                    // 제출했지만 아직 안 써진 청크 (fw->lock)
+    int closing;
+};
+
+struct FRAME_WRITER
+{
+    FW_CONFIG cfg;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;        // 큐 자리 또는 풀 버퍼가 생김
+    pthread_cond_t idle;
+    FW_JOB *head, *tail;
+    unsigned int queued;
+    unsigned int reserved;          // 자리를 잡고 복사 중인 작업
+    unsigned int in_flight;
+    FW_JOB *free_jobs;
+    void *free_bufs[FW_POOL_CLASSES];
+    int direct_ok;                  // 파일시스템이 O_DIRECT 를 거부하면 0
+    int stop;
+    pthread_t *threads;
+    int nthreads;
+    FW_STATS stats;
+};
+
+static ssize_t fw_default_pwrite(int fd, const void *buf, size_t len, off_t offset)
+{
+    return pwrite(fd, buf, len, offset);
+}
+
+static FW_PWRITE_FN fw_pwrite_fn = fw_default_pwrite;
+
+void FrameWriterSetPwrite(FW_PWRITE_FN fn)
+{
+    fw_pwrite_fn = fn ? fn : fw_default_pwrite;
+}
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static unsigned int align_up(unsigned int len)
+{
+    return (len + FW_ALIGN - 1) & ~(FW_ALIGN - 1);
+}
+
+// ===== 버퍼 풀 (4KB 정렬, 2 의 거듭제곱 크기 등급) =====
+
+static int size_class(unsigned int len)
+{
+    int c = 0;
+
+    while(c < FW_POOL_CLASSES && ((unsigned int)FW_ALIGN << c) < len)
+        c++;
+    return c < FW_POOL_CLASSES ? c : -1;
+}
+
+// fw->lock 을 잡은 상태. 예산을 넘으면 다른 등급의 빈 버퍼를 해제해서 자리를 만든다
+static void *pool_get(FRAME_WRITER *fw, int cls)
+{
+    unsigned int size = (unsigned int)FW_ALIGN << cls;
+    void *p = fw->free_bufs[cls];
+    int c;
+
+    if(p)
+    {
+        fw->free_bufs[cls] = *(void **)p;
+        return p;
+    }
+    for(c = FW_POOL_CLASSES - 1; c >= 0 && fw->stats.pool_used + size > fw->cfg.pool_bytes; c--)
+    {
+        while(fw->free_bufs[c] && fw->stats.pool_used + size > fw->cfg.pool_bytes)
+        {
+            void *q = fw->free_bufs[c];
+            fw->free_bufs[c] = *(void **)q;
+            free(q);
+            fw->stats.pool_used -= (unsigned int)FW_ALIGN << c;
+        }
+    }
+    if(fw->stats.pool_used + size > fw->cfg.pool_bytes)
+        return NULL;
+    if(posix_memalign(&p, FW_ALIGN, size) != 0)
+        return NULL;
+    fw->stats.pool_used += size;
+    return p;
+}
+
+static void pool_put(FRAME_WRITER *fw, void *p, int cls)
+{
+    *(void **)p = fw->free_bufs[cls];
+    fw->free_bufs[cls] = p;
+}
+
+static FW_JOB *job_get(FRAME_WRITER *fw)
+{
+    FW_JOB *job = fw->free_jobs;
+
+    if(job)
+        fw->free_jobs = job->next;
+    else
+        job = (FW_JOB *)malloc(sizeof(FW_JOB));
+    if(job)
+        memset(job, 0, offsetof(FW_JOB, path) + 1);
+    return job;
+}
+
+// ===== 디스크 쓰기 =====
+
+static int open_file(FRAME_WRITER *fw, const char *path, int *direct)
+{
+    int fd = -1;
+
+    *direct = 0;
+    if(fw->direct_ok)
+    {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+        if(fd >= 0)
+        {
+            *direct = 1;
+            return fd;
+        }
+        if(errno == EINVAL)
+            fw->direct_ok = 0;      // 이 파일시스템은 O_DIRECT 를 지원하지 않음
+    }
+    return open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+
+// 끝까지 쓴다. O_DIRECT 쓰기를 거부하면 O_DIRECT 를 끄고 다시 시도
+static int write_all(int fd, int *direct, const unsigned char *buf, unsigned int len, off_t offset)
+{
+    unsigned int done = 0;
+
+    while(done < len)
+    {
+        ssize_t n = fw_pwrite_fn(fd, buf + done, len - done, offset + done);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            if(errno == EINVAL && *direct)
+            {
+                int fl = fcntl(fd, F_GETFL);
+                if(fl >= 0 && fcntl(fd, F_SETFL, fl & ~O_DIRECT) == 0)
+                {
+                    *direct = 0;
+                    continue;
+                }
+            }
+            return -1;
+        }
+        done += (unsigned int)n;
+    }
+    return 0;
+}
+
+// O_DIRECT 는 정렬된 길이만 쓸 수 있으므로 패딩을 0 으로 채운 길이
+static unsigned int padded_len(const FW_JOB *job, int direct)
+{
+    unsigned int len = direct ? align_up(job->len) : job->len;
+
+    if(len > job->len)
+        memset(job->buf + job->len, 0, len - job->len);
+    return len;
+}
+
+static void stream_finalize(FW_STREAM *stream)
+{
+    if(stream->fd >= 0)
+    {
+        if(stream->size % FW_ALIGN)
+        {
+            if(ftruncate(stream->fd, (off_t)stream->size) < 0)
+                printf("frame writer: ftruncate 실패: %s\n", strerror(errno));
+        }
+        close(stream->fd);
+    }
+    free(stream);
+}
+
+// 작업 완료 처리: 통계, 버퍼 반환, 스트림 마지막 청크면 파일 정리
+static void job_done(FRAME_WRITER *fw, FW_JOB *job, int ok)
+{
+    FW_STREAM *finalize = NULL;
+    unsigned long long lat = now_us() - job->submit_us;
+
+    pthread_mutex_lock(&fw->lock);
+    if(ok)
+    {
+        fw->stats.completed++;
+        fw->stats.bytes += job->len;
+    }
+    else
+    {
+        fw->stats.errors++;
+    }
+    if(lat > fw->stats.max_latency_us)
+        fw->stats.max_latency_us = lat;
+
+    if(job->type == FW_JOB_CHUNK)
+    {
+        FW_STREAM *s = job->stream;
+        if(--s->pending == 0 && s->closing)
+            finalize = s;
+    }
+    else if(job->direct)
+    {
+        fw->stats.direct_files++;
+    }
+    else
+    {
+        fw->stats.buffered_files++;
+    }
+    pool_put(fw, job->buf, job->cls);
+    job->next = fw->free_jobs;
+    fw->free_jobs = job;
+
+    // Flush 가 돌아왔을 때 파일 크기까지 맞춰져 있도록 in_flight 를 줄이기 전에 정리
+    if(finalize)
+    {
+        pthread_mutex_unlock(&fw->lock);
+        stream_finalize(finalize);
+        pthread_mutex_lock(&fw->lock);
+    }
+
+    fw->in_flight--;
+    pthread_cond_broadcast(&fw->not_full);
+    if(fw->queued == 0 && fw->in_flight == 0 && fw->reserved == 0)
+        pthread_cond_broadcast(&fw->idle);
+    pthread_mutex_unlock(&fw->lock);
+}
+
+// 파일 작업 준비 (열기). 실패 시 -1
+static int job_open(FRAME_WRITER *fw, FW_JOB *job, int *fd, int *direct)
+{
+    if(job->type == FW_JOB_CHUNK)
+    {
+        *fd = job->stream->fd;
+        *direct = job->stream->direct;
+        return *fd >= 0 ? 0 : -1;
+    }
+    *fd = open_file(fw, job->path, direct);
+    if(*fd < 0)
+    {
+        printf("frame writer: %s 열기 실패: %s\n", job->path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static int job_close(FW_JOB *job, int fd, int direct, int ok)
+{
+    if(job->type == FW_JOB_CHUNK)
+    {
+        job->stream->direct = direct;
+        return ok;
+    }
+    if(ok && direct && (job->len % FW_ALIGN) && ftruncate(fd, job->len) < 0)
+        ok = 0;
+    job->direct = direct;
+    close(fd);
+    return ok;
+}
+
+static void job_run_sync(FRAME_WRITER *fw, FW_JOB *job)
+{
+    int fd, direct, ok = 0;
+
+    if(job_open(fw, job, &fd, &direct) == 0)
+    {
+        ok = write_all(fd, &direct, job->buf, padded_len(job, direct), job->offset) == 0;
+        if(!ok)
+            printf("frame writer: 쓰기 실패: %s\n", strerror(errno));
+        ok = job_close(job, fd, direct, ok);
+    }
+    job_done(fw, job, ok);
+}
+
+// ===== io_uring (liburing 없이 시스템 콜 직접 사용) =====
+
+#ifdef FW_HAVE_URING
+typedef struct
+{
+    int fd;
+    unsigned int *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned int *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+    struct io_uring_sqe *sqes;
+    void *sq_ptr, *cq_ptr;
+    size_t sq_size, cq_size, sqe_size;
+} FW_URING;
+
+static int uring_init(FW_URING *r, unsigned int entries)
+{
+    struct io_uring_params p;
+
+    memset(r, 0, sizeof(*r));
+    memset(&p, 0, sizeof(p));
+    r->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if(r->fd < 0)
+        return -1;
+
+    r->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    r->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if(r->cq_size > r->sq_size)
+            r->sq_size = r->cq_size;
+        r->cq_size = r->sq_size;
+    }
+    r->sq_ptr = mmap(NULL, r->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if(r->sq_ptr == MAP_FAILED)
+        goto fail;
+    if(p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        r->cq_ptr = r->sq_ptr;
+    }
+    else
+    {
+        r->cq_ptr = mmap(NULL, r->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if(r->cq_ptr == MAP_FAILED)
+        {
+            r->cq_ptr = NULL;
+            goto fail;
+        }
+    }
+    r->sqe_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = (struct io_uring_sqe *)mmap(NULL, r->sqe_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                          r->fd, IORING_OFF_SQES);
+    if(r->sqes == MAP_FAILED)
+    {
+        r->sqes = NULL;
+        goto fail;
+    }
+
+    r->sq_head = (unsigned int *)((char *)r->sq_ptr + p.sq_off.head);
+    r->sq_tail = (unsigned int *)((char *)r->sq_ptr + p.sq_off.tail);
+    r->sq_mask = (unsigned int *)((char *)r->sq_ptr + p.sq_off.ring_mask);
+    r->sq_array = (unsigned int *)((char *)r->sq_ptr + p.sq_off.array);
+    r->cq_head = (unsigned int *)((char *)r->cq_ptr + p.cq_off.head);
+    r->cq_tail = (unsigned int *)((char *)r->cq_ptr + p.cq_off.tail);
+    r->cq_mask = (unsigned int *)((char *)r->cq_ptr + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *)((char *)r->cq_ptr + p.cq_off.cqes);
+    return 0;
+
+fail:
+    if(r->sq_ptr && r->sq_ptr != MAP_FAILED)
+        munmap(r->sq_ptr, r->sq_size);
+    if(r->cq_ptr && r->cq_ptr != r->sq_ptr)
+        munmap(r->cq_ptr, r->cq_size);
+    close(r->fd);
+    r->fd = -1;
+    return -1;
+}
+
+static void uring_exit(FW_URING *r)
+{
+    if(r->fd < 0)
+        return;
+    munmap(r->sqes, r->sqe_size);
+    if(r->cq_ptr != r->sq_ptr)
+        munmap(r->cq_ptr, r->cq_size);
+    munmap(r->sq_ptr, r->sq_size);
+    close(r->fd);
+    r->fd = -1;
+}
+
+static void uring_queue_write(FW_URING *r, int fd, const struct iovec *iov, off_t offset, unsigned long long user)
+{
+    unsigned int tail = *r->sq_tail;
+    unsigned int idx = tail & *r->sq_mask;
+    struct io_uring_sqe *sqe = &r->sqes[idx];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long)iov;
+    sqe->len = 1;
+    sqe->off = (unsigned long long)offset;
+    sqe->user_data = user;
+    r->sq_array[idx] = idx;
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+// n 개를 보내고 n 개의 완료를 기다린다. res[user_data] 에 결과
+static int uring_submit_wait(FW_URING *r, unsigned int n, int *res)
+{
+    unsigned int submitted = 0, reaped = 0;
+
+    while(reaped < n)
+    {
+        unsigned int head, tail;
+        int ret = (int)syscall(__NR_io_uring_enter, r->fd, n - submitted, n - reaped, IORING_ENTER_GETEVENTS, NULL, 0);
+        if(ret < 0)
+        {
+            if(errno == EINTR || errno == EAGAIN)
+                continue;
+            return -1;
+        }
+        submitted += (unsigned int)ret;
+
+        head = *r->cq_head;
+        tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+        while(head != tail)
+        {
+            struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+            res[cqe->user_data] = cqe->res;
+            head++;
+            reaped++;
+        }
+        __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+// 작업 여러 개의 쓰기를 한 번에 보낸다. 짧은 쓰기/거부는 동기 쓰기로 마무리
+static void job_run_uring(FRAME_WRITER *fw, FW_URING *r, FW_JOB **jobs, unsigned int n)
+{
+    struct iovec iov[FW_URING_DEPTH];
+    int fds[FW_URING_DEPTH], direct[FW_URING_DEPTH], res[FW_URING_DEPTH], ok[FW_URING_DEPTH];
+    unsigned int len[FW_URING_DEPTH], i, queued = 0;
+
+    for(i = 0; i < n; i++)
+    {
+        ok[i] = job_open(fw, jobs[i], &fds[i], &direct[i]) == 0;
+        res[i] = 0;
+        if(!ok[i])
+            continue;
+        len[i] = padded_len(jobs[i], direct[i]);
+        iov[i].iov_base = jobs[i]->buf;
+        iov[i].iov_len = len[i];
+        uring_queue_write(r, fds[i], &iov[i], jobs[i]->offset, i);
+        queued++;
+    }
+    if(queued && uring_submit_wait(r, queued, res) < 0)
+    {
+        // 링을 쓸 수 없으면 전부 동기 쓰기로
+        for(i = 0; i < n; i++)
+            res[i] = 0;
+    }
+
+    for(i = 0; i < n; i++)
+    {
+        if(ok[i])
+        {
+            unsigned int done = res[i] > 0 ? (unsigned int)res[i] : 0;
+            if(done < len[i])
+            {
+                if(res[i] < 0)
+                    errno = -res[i];
+                ok[i] = write_all(fds[i], &direct[i], jobs[i]->buf + done, len[i] - done, jobs[i]->offset + done) == 0;
+            }
+            if(!ok[i])
+                printf("frame writer: 쓰기 실패: %s\n", strerror(errno));
+            ok[i] = job_close(jobs[i], fds[i], direct[i], ok[i]);
+        }
+        job_done(fw, jobs[i], ok[i]);
+    }
+}
+#endif
+
+// ===== writer 스레드 =====
+
+// 큐에서 최대 max 개를 꺼낸다. 멈출 때 큐가 비었으면 0
+static unsigned int take_jobs(FRAME_WRITER *fw, FW_JOB **jobs, unsigned int max)
+{
+    unsigned int n = 0;
+
+    pthread_mutex_lock(&fw->lock);
+    while(fw->queued == 0 && !fw->stop)
+        pthread_cond_wait(&fw->not_empty, &fw->lock);
+    while(n < max && fw->head)
+    {
+        jobs[n] = fw->head;
+        fw->head = fw->head->next;
+        if(!fw->head)
+            fw->tail = NULL;
+        fw->queued--;
+        fw->in_flight++;
+        n++;
+    }
+    pthread_mutex_unlock(&fw->lock);
+    return n;
+}
+
+static void *writer_thread(void *arg)
+{
+    FRAME_WRITER *fw = (FRAME_WRITER *)arg;
+    FW_JOB *jobs[FW_URING_DEPTH];
+    unsigned int n;
+#ifdef FW_HAVE_URING
+    FW_URING ring;
+    int use_uring = (fw->cfg.flags & FW_FLAG_URING) && fw_pwrite_fn == fw_default_pwrite &&
+                    uring_init(&ring, FW_URING_DEPTH) == 0;
+
+    if(use_uring)
+    {
+        pthread_mutex_lock(&fw->lock);
+        fw->stats.uring_threads++;
+        pthread_mutex_unlock(&fw->lock);
+    }
+#endif
+
+    for(;;)
+    {
+#ifdef FW_HAVE_URING
+        if(use_uring)
+        {
+            n = take_jobs(fw, jobs, FW_URING_DEPTH);
+            if(n == 0)
+                break;
+            job_run_uring(fw, &ring, jobs, n);
+            continue;
+        }
+#endif
+        n = take_jobs(fw, jobs, 1);
+        if(n == 0)
+            break;
+        job_run_sync(fw, jobs[0]);
+    }
+
+#ifdef FW_HAVE_URING
+    if(use_uring)
+        uring_exit(&ring);
+#endif
+    return NULL;
+}
+
+// ===== 제출 =====
+
+FRAME_WRITER *FrameWriterCreate(const FW_CONFIG *cfg)
+{
+    FRAME_WRITER *fw = (FRAME_WRITER *)calloc(1, sizeof(FRAME_WRITER));
+    int i;
+
+    if(!fw)
+        return NULL;
+    if(cfg)
+        fw->cfg = *cfg;
+    else
+        fw->cfg.flags = FW_FLAG_DIRECT | FW_FLAG_URING;
+    if(fw->cfg.threads <= 0)
+        fw->cfg.threads = FW_DEFAULT_THREADS;
+    if(fw->cfg.queue_depth == 0)
+        fw->cfg.queue_depth = FW_DEFAULT_QUEUE_DEPTH;
+    if(fw->cfg.pool_bytes < 2 * FW_CHUNK_SIZE)
+        fw->cfg.pool_bytes = fw->cfg.pool_bytes ? 2 * FW_CHUNK_SIZE : FW_DEFAULT_POOL_BYTES;
+    fw->direct_ok = (fw->cfg.flags & FW_FLAG_DIRECT) != 0;
+
+    pthread_mutex_init(&fw->lock, NULL);
+    pthread_cond_init(&fw->not_empty, NULL);
+    pthread_cond_init(&fw->not_full, NULL);
+    pthread_cond_init(&fw->idle, NULL);
+
+    fw->threads = (pthread_t *)calloc(fw->cfg.threads, sizeof(pthread_t));
+    if(!fw->threads)
+    {
+        free(fw);
+        return NULL;
+    }
+    for(i = 0; i < fw->cfg.threads; i++)
+    {
+        if(pthread_create(&fw->threads[i], NULL, writer_thread, fw) != 0)
+        {
+            printf("frame writer: 스레드 생성 실패\n");
+            break;
+        }
+        fw->nthreads++;
+    }
+    if(fw->nthreads == 0)
+    {
+        free(fw->threads);
+        free(fw);
+        return NULL;
+    }
+    return fw;
+}
+
+// fw->lock 을 잡은 상태에서 큐 끝에 넣는다
+static void enqueue_locked(FRAME_WRITER *fw, FW_JOB *job)
+{
+    unsigned int backlog;
+
+    job->submit_us = now_us();
+    job->next = NULL;
+    if(fw->tail)
+        fw->tail->next = job;
+    else
+        fw->head = job;
+    fw->tail = job;
+    fw->queued++;
+    fw->stats.submitted++;
+    backlog = fw->queued + fw->in_flight;
+    if(backlog > fw->stats.max_backlog)
+        fw->stats.max_backlog = backlog;
+    pthread_cond_signal(&fw->not_empty);
+}
+
+int FrameWriterSubmitFile(FRAME_WRITER *fw, const char *path, const void *data, unsigned int len)
+{
+    FW_JOB *job;
+    int cls;
+
+    if(!fw || !path || (!data && len))
+        return -1;
+    cls = size_class(len ? len : 1);
+
+    pthread_mutex_lock(&fw->lock);
+    job = NULL;
+    if(cls >= 0 && fw->queued + fw->reserved + fw->in_flight < fw->cfg.queue_depth)
+    {
+        job = job_get(fw);
+        if(job)
+        {
+            job->buf = (unsigned char *)pool_get(fw, cls);
+            if(!job->buf)
+            {
+                job->next = fw->free_jobs;
+                fw->free_jobs = job;
+                job = NULL;
+            }
+        }
+    }
+    if(!job)
+    {
+        fw->stats.dropped++;
+        pthread_mutex_unlock(&fw->lock);
+        return -1;
+    }
+    fw->reserved++;
+    pthread_mutex_unlock(&fw->lock);
+
+    // 복사는 잠금 밖에서 (writer 스레드를 막지 않음)
+    job->type = FW_JOB_FILE;
+    job->cls = cls;
+    job->len = len;
+    if(len)
+        memcpy(job->buf, data, len);
+    snprintf(job->path, sizeof(job->path), "%s", path);
+
+    pthread_mutex_lock(&fw->lock);
+    fw->reserved--;
+    enqueue_locked(fw, job);
+    pthread_mutex_unlock(&fw->lock);
+    return 0;
+}
+
+FW_STREAM *FrameWriterStreamOpen(FRAME_WRITER *fw, const char *path)
+{
+    FW_STREAM *stream;
+
+    if(!fw || !path)
+        return NULL;
+    stream = (FW_STREAM *)calloc(1, sizeof(FW_STREAM));
+    if(!stream)
+        return NULL;
+    stream->fw = fw;
+    stream->cur_cls = size_class(FW_CHUNK_SIZE);
+
+    pthread_mutex_lock(&fw->lock);
+    stream->fd = open_file(fw, path, &stream->direct);
+    if(stream->fd >= 0)
+    {
+        if(stream->direct)
+            fw->stats.direct_files++;
+        else
+            fw->stats.buffered_files++;
+    }
+    pthread_mutex_unlock(&fw->lock);
+
+    if(stream->fd < 0)
+    {
+        printf("frame writer: %s 열기 실패: %s\n", path, strerror(errno));
+        free(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+// 채운 청크를 제출한다. 자리가 없으면 기다린다
+static int stream_submit(FW_STREAM *stream)
+{
+    FRAME_WRITER *fw = stream->fw;
+    FW_JOB *job;
+    int stalled = 0;
+
+    pthread_mutex_lock(&fw->lock);
+    while(fw->queued + fw->reserved + fw->in_flight >= fw->cfg.queue_depth || !(job = job_get(fw)))
+    {
+        if(!stalled)
+        {
+            fw->stats.stalls++;
+            stalled = 1;
+        }
+        pthread_cond_wait(&fw->not_full, &fw->lock);
+    }
+    job->type = FW_JOB_CHUNK;
+    job->buf = stream->cur;
+    job->cls = stream->cur_cls;
+    job->len = stream->cur_len;
+    job->stream = stream;
+    job->offset = stream->offset;
+    job->path[0] = 0;
+    stream->pending++;
+    enqueue_locked(fw, job);
+    pthread_mutex_unlock(&fw->lock);
+
+    stream->offset += stream->cur_len;
+    stream->cur = NULL;
+    stream->cur_len = 0;
+    return 0;
+}
+
+// 청크 버퍼 확보. 풀이 비었으면 반환될 때까지 기다린다
+static int stream_get_chunk(FW_STREAM *stream)
+{
+    FRAME_WRITER *fw = stream->fw;
+    int stalled = 0;
+
+    pthread_mutex_lock(&fw->lock);
+    while(!(stream->cur = (unsigned char *)pool_get(fw, stream->cur_cls)))
+    {
+        if(fw->queued + fw->in_flight == 0)
+        {
+            // 예산이 청크 하나보다 작음 (생성 시 막지만 방어)
+            pthread_mutex_unlock(&fw->lock);
+            return -1;
+        }
+        if(!stalled)
+        {
+            fw->stats.stalls++;
+            stalled = 1;
+        }
+        pthread_cond_wait(&fw->not_full, &fw->lock);
+    }
+    pthread_mutex_unlock(&fw->lock);
+    return 0;
+}
+
+int FrameWriterStreamWrite(FW_STREAM *stream, const void *data, unsigned int len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+
+    if(!stream || (!data && len))
+        return -1;
+
+    while(len > 0)
+    {
+        unsigned int n;
+
+        if(!stream->cur && stream_get_chunk(stream) < 0)
+            return -1;
+        n = FW_CHUNK_SIZE - stream->cur_len;
+        if(n > len)
+            n = len;
+        memcpy(stream->cur + stream->cur_len, p, n);
+        stream->cur_len += n;
+        stream->size += n;
+        p += n;
+        len -= n;
+        if(stream->cur_len == FW_CHUNK_SIZE && stream_submit(stream) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+int FrameWriterStreamClose(FW_STREAM *stream)
+{
+    FRAME_WRITER *fw;
+    int done;
+
+    if(!stream)
+        return -1;
+    fw = stream->fw;
+
+    if(stream->cur_len > 0)
+        stream_submit(stream);
+    else if(stream->cur)
+    {
+        pthread_mutex_lock(&fw->lock);
+        pool_put(fw, stream->cur, stream->cur_cls);
+        pthread_mutex_unlock(&fw->lock);
+        stream->cur = NULL;
+    }
+
+    pthread_mutex_lock(&fw->lock);
+    stream->closing = 1;
+    done = stream->pending == 0;
+    pthread_mutex_unlock(&fw->lock);
+
+    // 남은 청크가 있으면 마지막 청크를 쓴 writer 스레드가 정리한다
+    if(done)
+        stream_finalize(stream);
+    return 0;
+}
+
+void FrameWriterFlush(FRAME_WRITER *fw)
+{
+    if(!fw)
+        return;
+    pthread_mutex_lock(&fw->lock);
+    while(fw->queued || fw->in_flight || fw->reserved)
+        pthread_cond_wait(&fw->idle, &fw->lock);
+    pthread_mutex_unlock(&fw->lock);
+}
+
+void FrameWriterGetStats(FRAME_WRITER *fw, FW_STATS *stats)
+{
+    if(!stats)
+        return;
+    if(!fw)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    pthread_mutex_lock(&fw->lock);
+    *stats = fw->stats;
+    stats->backlog = fw->queued + fw->in_flight;
+    pthread_mutex_unlock(&fw->lock);
+}
+
+void FrameWriterDestroy(FRAME_WRITER *fw)
+{
+    FW_JOB *job;
+    int i;
+
+    if(!fw)
+        return;
+
+    FrameWriterFlush(fw);
+    pthread_mutex_lock(&fw->lock);
+    fw->stop = 1;
+    pthread_cond_broadcast(&fw->not_empty);
+    pthread_mutex_unlock(&fw->lock);
+    for(i = 0; i < fw->nthreads; i++)
+        pthread_join(fw->threads[i], NULL);
+
+    for(i = 0; i < FW_POOL_CLASSES; i++)
+    {
+        while(fw->free_bufs[i])
+        {
+            void *p = fw->free_bufs[i];
+            fw->free_bufs[i] = *(void **)p;
+            free(p);
+        }
+    }
+    while((job = fw->free_jobs) != NULL)
+    {
+        fw->free_jobs = job->next;
+        free(job);
+    }
+    pthread_cond_destroy(&fw->idle);
+    pthread_cond_destroy(&fw->not_full);
+    pthread_cond_destroy(&fw->not_empty);
+    pthread_mutex_destroy(&fw->lock);
+    free(fw->threads);
+    free(fw);
+}
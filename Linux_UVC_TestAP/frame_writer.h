@@ -0,0 +1,84 @@
+#ifndef _FRAME_WRITER_H_
+#define _FRAME_WRITER_H_
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 비동기 프레임 저장 (--save JPEG, --record 파일)
+// 캡처 스레드는 프레임을 풀 버퍼로 복사만 하고 바로 V4L2 버퍼를 돌려준다.
+// 제한된 큐를 writer 스레드 N 개가 비우며, 파일은 4KB 정렬 버퍼로 한 번에 크게 쓴다.
+// - O_DIRECT 를 먼저 시도하고 파일시스템이 거부하면(예전 커널의 tmpfs 등) 일반 쓰기로 자동 전환
+// - 커널에 io_uring 이 있으면 스레드마다 링 하나로 여러 쓰기를 동시에 보낸다 (없으면 pwrite)
+// - 단일 파일(JPEG)은 큐/풀이 가득 차면 버리고(drop 카운트), 스트림(녹화)은 기다린다(stall 카운트)
+
+#define FW_ALIGN                    4096
+#define FW_CHUNK_SIZE               (1 << 20)       // 스트림 쓰기 단위
+#define FW_DEFAULT_THREADS          2
+#define FW_DEFAULT_QUEUE_DEPTH      64
+#define FW_DEFAULT_POOL_BYTES       (32 << 20)
+#define FW_URING_DEPTH              8               // 스레드당 동시에 보내는 쓰기 수
+#define FW_PATH_MAX                 256
+
+#define FW_FLAG_DIRECT              0x01            // O_DIRECT 시도
+#define FW_FLAG_URING               0x02            // io_uring 시도
+
+typedef struct
+{
+    int threads;                    // 0 이면 FW_DEFAULT_THREADS
+    unsigned int queue_depth;       // 0 이면 FW_DEFAULT_QUEUE_DEPTH
+    unsigned int pool_bytes;        // 0 이면 FW_DEFAULT_POOL_BYTES
+    unsigned int flags;             // FW_FLAG_*
+} FW_CONFIG;
+
+typedef struct
+{
+    unsigned long submitted;        // 큐에 들어간 작업 (파일, 스트림 청크)
+    unsigned long completed;
+    unsigned long dropped;          // 큐/풀이 가득 차서 버린 파일
+    unsigned long stalls;           // 스트림 쓰기가 빈 자리를 기다린 횟수
+    unsigned long errors;
+    unsigned long long bytes;       // 디스크에 쓴 데이터 (정렬 패딩 제외)
+    unsigned int backlog;           // 지금 큐 + 처리 중인 작업
+    unsigned int max_backlog;
+    unsigned int pool_used;         // 할당한 풀 버퍼 바이트
+    unsigned long direct_files;     // O_DIRECT 로 연 파일
+    unsigned long buffered_files;
+    int uring_threads;              // io_uring 을 쓰는 writer 스레드 수
+    unsigned long long max_latency_us;  // 제출 → 디스크 쓰기 완료 최대 시간
+} FW_STATS;
+
+typedef struct FRAME_WRITER FRAME_WRITER;
+typedef struct FW_STREAM FW_STREAM;
+
+// cfg 가 NULL 이면 기본값 + O_DIRECT + io_uring. 실패 시 NULL
+FRAME_WRITER *FrameWriterCreate(const FW_CONFIG *cfg);
+
+// 파일 하나를 통째로 쓴다 (data 는 복사됨). 큐에 넣으면 0, 버리면 -1
+int FrameWriterSubmitFile(FRAME_WRITER *fw, const char *path, const void *data, unsigned int len);
+
+// 순차 파일 (녹화). FW_CHUNK_SIZE 단위로 모아서 제출하고 자리가 없으면 기다린다
+FW_STREAM *FrameWriterStreamOpen(FRAME_WRITER *fw, const char *path);
+int FrameWriterStreamWrite(FW_STREAM *stream, const void *data, unsigned int len);
+// 남은 데이터를 제출하고 닫는다 (마지막 청크가 써지면 파일 크기를 맞추고 close). stream 은 해제된다
+int FrameWriterStreamClose(FW_STREAM *stream);
+
+// 지금까지 제출한 작업이 모두 끝날 때까지 기다린다
+void FrameWriterFlush(FRAME_WRITER *fw);
+
+void FrameWriterGetStats(FRAME_WRITER *fw, FW_STATS *stats);
+
+// Flush 후 스레드를 끝내고 해제한다
+void FrameWriterDestroy(FRAME_WRITER *fw);
+
+// 테스트용 pwrite 대체 (NULL 이면 기본). 설정하면 io_uring 대신 이 함수로 쓴다
+typedef ssize_t (*FW_PWRITE_FN)(int fd, const void *buf, size_t len, off_t offset);
+void FrameWriterSetPwrite(FW_PWRITE_FN fn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,348 @@
+//----------------------------------------------//
+//	비동기 frame writer 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./frame_writer_bench [dir] [frames] [fps]
+// 1) 지연 스파이크: pwrite 를 가로채 25 번째 쓰기마다 150ms 멈추는 SD 카드를 흉내내고
+//    합성 JPEG(150KB) 를 fps 로 저장한다.
+//      inline : 기존처럼 캡처 루프에서 open/write/close
+//      async  : FrameWriterSubmitFile
+//    캡처 루프가 한 프레임 간격 이상 밀린 횟수(= 드라이버 버퍼가 모자라 프레임을 잃는 상황)를 비교
+// 2) 백엔드별 정확성: dir(기본 /tmp) 과 /dev/shm(tmpfs, O_DIRECT 를 거부하는 커널이면 자동 전환) 에서
+//    pwrite / O_DIRECT / O_DIRECT + io_uring 으로 크기가 제각각인 파일과 스트림을 쓰고 다시 읽어 비교
+// 3) 드롭 회계: 작은 큐에 한꺼번에 제출해서 submitted + dropped == 제출 수 인지 확인
+// async 가 밀리거나, 내용이 다르거나, 회계가 맞지 않으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "frame_writer.h"
+
+#define JPEG_SIZE           (150 * 1024)
+#define SPIKE_EVERY         25
+#define SPIKE_US            150000
+#define CHECK_FILES         40
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void fill(unsigned char *buf, unsigned int len, unsigned int seed)
+{
+    unsigned int i, v = seed * 2654435761u + 1;
+
+    for(i = 0; i < len; i++)
+    {
+        v = v * 1103515245u + 12345u;
+        buf[i] = (unsigned char)(v >> 24);
+    }
+}
+
+// ===== 느린 저장 장치 =====
+
+static volatile unsigned long slow_writes;
+
+static ssize_t slow_pwrite(int fd, const void *buf, size_t len, off_t offset)
+{
+    if(__sync_add_and_fetch(&slow_writes, 1) % SPIKE_EVERY == 0)
+        usleep(SPIKE_US);
+    return pwrite(fd, buf, len, offset);
+}
+
+// 기존 캡처 루프의 저장 (fopen/fwrite/fclose 와 같은 동기 쓰기)
+static void save_inline(const char *path, const unsigned char *data, unsigned int len)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(fd < 0)
+        return;
+    if(slow_pwrite(fd, data, len, 0) < 0)
+        printf("쓰기 실패: %s\n", strerror(errno));
+    close(fd);
+}
+
+static int file_matches(const char *path, const unsigned char *expect, unsigned int len)
+{
+    unsigned char *buf = (unsigned char *)malloc(len + 1);
+    FILE *fp = fopen(path, "rb");
+    size_t n = 0;
+    int ok;
+
+    if(fp && buf)
+        n = fread(buf, 1, len + 1, fp);
+    ok = fp && buf && n == len && memcmp(buf, expect, len) == 0;
+    if(fp)
+        fclose(fp);
+    free(buf);
+    return ok;
+}
+
+// 1) 캡처 루프 지연 비교
+static int run_spike(const char *dir, int frames, int fps, int async, unsigned long *late, double *max_late_ms)
+{
+    unsigned long long interval = 1000000ULL / fps, start, worst = 0;
+    unsigned char *frame = (unsigned char *)malloc(JPEG_SIZE);
+    char path[FW_PATH_MAX];
+    FRAME_WRITER *fw = NULL;
+    FW_STATS st;
+    int i, bad = 0;
+
+    if(!frame)
+        return 1;
+    *late = 0;
+    slow_writes = 0;
+    if(async)
+    {
+        FrameWriterSetPwrite(slow_pwrite);
+        fw = FrameWriterCreate(NULL);
+        if(!fw)
+            return 1;
+    }
+
+    start = now_us();
+    for(i = 0; i < frames; i++)
+    {
+        unsigned long long deadline = start + i * interval, t = now_us();
+
+        if(t < deadline)
+        {
+            usleep((useconds_t)(deadline - t));
+            t = now_us();
+        }
+        if(t - deadline > worst)
+            worst = t - deadline;
+        if(t - deadline >= interval)
+            (*late)++;
+
+        fill(frame, JPEG_SIZE, (unsigned int)i);
+        snprintf(path, sizeof(path), "%s/frame-%06d.jpg", dir, i);
+        if(async)
+        {
+            if(FrameWriterSubmitFile(fw, path, frame, JPEG_SIZE) < 0)
+                bad++;
+        }
+        else
+        {
+            save_inline(path, frame, JPEG_SIZE);
+        }
+    }
+
+    if(async)
+    {
+        FrameWriterFlush(fw);
+        FrameWriterGetStats(fw, &st);
+        printf("        backlog 최대 %u, 드롭 %lu, 제출→완료 최대 %.1f ms\n",
+               st.max_backlog, st.dropped, st.max_latency_us / 1000.0);
+        FrameWriterDestroy(fw);
+        FrameWriterSetPwrite(NULL);
+    }
+
+    for(i = 0; i < frames; i++)
+    {
+        fill(frame, JPEG_SIZE, (unsigned int)i);
+        snprintf(path, sizeof(path), "%s/frame-%06d.jpg", dir, i);
+        if(!file_matches(path, frame, JPEG_SIZE))
+            bad++;
+        unlink(path);
+    }
+    free(frame);
+    *max_late_ms = worst / 1000.0;
+    return bad;
+}
+
+// 2) 백엔드 정확성: 파일 CHECK_FILES 개 + 스트림 하나
+static int run_backend(const char *dir, const char *label, unsigned int flags)
+{
+    static const unsigned int sizes[5] = { 1, 4095, 4096, 70001, 3 * 1024 * 1024 + 17 };
+    unsigned int stream_len = 5 * FW_CHUNK_SIZE + 12345, off, piece;
+    unsigned char *buf = (unsigned char *)malloc(stream_len);
+    char path[FW_PATH_MAX];
+    FW_CONFIG cfg;
+    FW_STATS st;
+    FRAME_WRITER *fw;
+    FW_STREAM *stream;
+    unsigned long long t0;
+    int i, bad = 0;
+
+    if(!buf)
+        return 1;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads = 2;
+    cfg.flags = flags;
+    fw = FrameWriterCreate(&cfg);
+    if(!fw)
+    {
+        free(buf);
+        return 1;
+    }
+
+    t0 = now_us();
+    snprintf(path, sizeof(path), "%s/stream.bin", dir);
+    stream = FrameWriterStreamOpen(fw, path);
+    if(!stream)
+        bad++;
+    for(i = 0; i < CHECK_FILES; i++)
+    {
+        unsigned int len = sizes[i % 5];
+
+        fill(buf, len, 1000 + i);
+        snprintf(path, sizeof(path), "%s/file-%02d.bin", dir, i);
+        if(FrameWriterSubmitFile(fw, path, buf, len) < 0)
+            bad++;
+    }
+    // 스트림은 녹화처럼 작은 조각으로
+    fill(buf, stream_len, 7);
+    for(off = 0; stream && off < stream_len; off += piece)
+    {
+        piece = 1000 + (off * 7) % 60000;
+        if(piece > stream_len - off)
+            piece = stream_len - off;
+        if(FrameWriterStreamWrite(stream, buf + off, piece) < 0)
+            bad++;
+    }
+    if(stream)
+        FrameWriterStreamClose(stream);
+    FrameWriterFlush(fw);
+    FrameWriterGetStats(fw, &st);
+    FrameWriterDestroy(fw);
+
+    printf("  %-10s %-22s O_DIRECT %2lu  buffered %2lu  io_uring 스레드 %d  %6.1f MB  %7.1f MB/s  오류 %lu\n",
+           dir, label, st.direct_files, st.buffered_files, st.uring_threads, st.bytes / 1048576.0,
+           st.bytes / 1048576.0 / ((now_us() - t0) / 1e6), st.errors);
+    bad += (int)st.errors;
+
+    snprintf(path, sizeof(path), "%s/stream.bin", dir);
+    if(!file_matches(path, buf, stream_len))
+    {
+        printf("불일치: %s\n", path);
+        bad++;
+    }
+    unlink(path);
+    for(i = 0; i < CHECK_FILES; i++)
+    {
+        unsigned int len = sizes[i % 5];
+
+        fill(buf, len, 1000 + i);
+        snprintf(path, sizeof(path), "%s/file-%02d.bin", dir, i);
+        if(!file_matches(path, buf, len))
+        {
+            printf("불일치: %s\n", path);
+            bad++;
+        }
+        unlink(path);
+    }
+    free(buf);
+    return bad;
+}
+
+// 3) 드롭 회계
+static int run_drop(const char *dir)
+{
+    unsigned char frame[8192];
+    char path[FW_PATH_MAX];
+    FW_CONFIG cfg;
+    FW_STATS st;
+    FRAME_WRITER *fw;
+    int i, refused = 0, total = 50;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads = 1;
+    cfg.queue_depth = 4;
+    FrameWriterSetPwrite(slow_pwrite);
+    slow_writes = SPIKE_EVERY - 1;          // 첫 쓰기가 스파이크
+    fw = FrameWriterCreate(&cfg);
+    if(!fw)
+        return 1;
+    memset(frame, 0x5a, sizeof(frame));
+    for(i = 0; i < total; i++)
+    {
+        snprintf(path, sizeof(path), "%s/drop-%02d.bin", dir, i);
+        if(FrameWriterSubmitFile(fw, path, frame, sizeof(frame)) < 0)
+            refused++;
+    }
+    FrameWriterFlush(fw);
+    FrameWriterGetStats(fw, &st);
+    FrameWriterDestroy(fw);
+    FrameWriterSetPwrite(NULL);
+    for(i = 0; i < total; i++)
+    {
+        snprintf(path, sizeof(path), "%s/drop-%02d.bin", dir, i);
+        unlink(path);
+    }
+
+    printf("드롭 회계: 제출 %d → 큐 %lu, 드롭 %lu (거부 반환 %d), 완료 %lu, 최대 backlog %u\n",
+           total, st.submitted, st.dropped, refused, st.completed, st.max_backlog);
+    return (st.submitted + st.dropped == (unsigned long)total && st.dropped == (unsigned long)refused &&
+            st.dropped > 0 && st.completed == st.submitted && st.max_backlog <= cfg.queue_depth) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    char tmpl[] = "/tmp/fw_bench.XXXXXX";
+    char shm_tmpl[] = "/dev/shm/fw_bench.XXXXXX";
+    const char *dir = NULL;
+    char *shm_dir;
+    int frames = 90, fps = 30, failures = 0, own_dir = 0;
+    unsigned long late_inline, late_async;
+    double max_inline, max_async;
+
+    if(argc >= 2)
+        dir = argv[1];
+    if(argc >= 3)
+        frames = atoi(argv[2]);
+    if(argc >= 4)
+        fps = atoi(argv[3]);
+    if(frames <= 0 || fps <= 0)
+    {
+        printf("사용법: %s [dir] [frames] [fps]\n", argv[0]);
+        return 2;
+    }
+    if(!dir)
+    {
+        dir = mkdtemp(tmpl);
+        own_dir = 1;
+        if(!dir)
+        {
+            printf("임시 디렉터리 생성 실패\n");
+            return 2;
+        }
+    }
+
+    printf("=== frame writer 벤치마크 (%d 프레임 x %d KB, %d fps, %d 번째 쓰기마다 %d ms 스파이크) ===\n",
+           frames, JPEG_SIZE / 1024, fps, SPIKE_EVERY, SPIKE_US / 1000);
+    failures += run_spike(dir, frames, fps, 0, &late_inline, &max_inline);
+    printf("inline: 한 간격 이상 밀린 프레임 %3lu/%d, 최대 지연 %6.1f ms\n", late_inline, frames, max_inline);
+    failures += run_spike(dir, frames, fps, 1, &late_async, &max_async);
+    printf("async : 한 간격 이상 밀린 프레임 %3lu/%d, 최대 지연 %6.1f ms\n", late_async, frames, max_async);
+    if(late_async != 0)
+    {
+        printf("불일치: async 모드에서 캡처 루프가 밀림\n");
+        failures++;
+    }
+
+    printf("백엔드별 정확성:\n");
+    failures += run_backend(dir, "pwrite", 0);
+    failures += run_backend(dir, "O_DIRECT", FW_FLAG_DIRECT);
+    failures += run_backend(dir, "O_DIRECT + io_uring", FW_FLAG_DIRECT | FW_FLAG_URING);
+    shm_dir = mkdtemp(shm_tmpl);
+    if(shm_dir)
+    {
+        failures += run_backend(shm_dir, "O_DIRECT + io_uring", FW_FLAG_DIRECT | FW_FLAG_URING);
+        rmdir(shm_dir);
+    }
+
+    failures += run_drop(dir);
+
+    if(own_dir)
+        rmdir(dir);
+    printf("검증: %s\n", failures ? "실패" : "디스크 지연이 캡처 루프로 번지지 않고 모든 백엔드에서 내용이 일치");
+    return failures ? 1 : 0;
+}
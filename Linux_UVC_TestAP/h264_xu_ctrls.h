@@ -157,8 +157,11 @@ extern unsigned int  chip_id;
 
 int XU_Init_Ctrl(int fd);
 int XU_Ctrl_ReadChipID(int fd);
+int XU_Ctrl_Mapped(int fd);
 
 int H264_GetFormat(int fd);
+int H264_ReadFormat(int fd, unsigned char **fwData, unsigned short *fwLen);
+int H264_LoadFormat(unsigned char *fwData, unsigned short fwLen);
 int H264_CountFormat(unsigned char *Data, int len);
 int H264_ParseFormat(unsigned char *Data, int len, struct H264Format *fmt);
 int H264_GetFPS(unsigned int FrPay);
@@ -168,6 +171,31 @@ int H264_GetFPS(unsigned int FrPay);
 int XU_Set(int fd, struct uvc_xu_control xctrl);
 int XU_Get(int fd, struct uvc_xu_control *xctrl);
 
+int XU_Set_Cur(int fd, __u8 xu_unit, __u8 xu_selector, __u16 xu_size, __u8 *xu_data);
+int XU_Get_Cur(int fd, __u8 xu_unit, __u8 xu_selector, __u16 xu_size, __u8 *xu_data);
+
+// XU transfer layer +++++
+
+#define XU_CTRL_MAX_SIZE			32
+
+struct XU_Cache_Stats
+{
+	unsigned int bus_transfers;		// control transfers actually issued
+	unsigned int switch_skipped;	// switch commands dropped (sub-selection already active)
+	unsigned int read_hits;			// GET_CUR served from the shadow cache
+	unsigned int write_skipped;		// SET_CUR equal to the value already written
+	unsigned int write_coalesced;	// queued SET_CUR replaced inside a transaction
+};
+
+typedef int (*XU_IOCTL_FN)(int fd, unsigned long request, void *arg);
+
+void XU_Set_Ioctl(XU_IOCTL_FN fn);
+void XU_Cache_Enable(int enable);
+void XU_Cache_Invalidate(int fd);
+int XU_Cache_Get_Stats(int fd, struct XU_Cache_Stats *stats);
+int XU_Txn_Begin(int fd);
+int XU_Txn_Commit(int fd);
+
 int XU_H264_InitFormat(int fd);
 int XU_H264_GetFormatLength(int fd, unsigned short *fwLen);
 int XU_H264_GetFormatData(int fd, unsigned char *fwData, unsigned short fwLen);
@@ -249,6 +277,8 @@ int XU_MD_Get_Mask(int fd, unsigned char *Mask);
 
 int XU_MD_Set_RESULT(int fd, unsigned char *Result);
 int XU_MD_Get_RESULT(int fd, unsigned char *Result);
+int XU_MD_Read_RESULT(int fd, unsigned char *Result);		// no printing (monitor polling)
+void XU_MD_Print_RESULT(const unsigned char *Result);
 
 int XU_MJPG_Set_Bitrate(int fd, unsigned int MJPG_Bitrate);
 int XU_MJPG_Get_Bitrate(int fd, unsigned int *MJPG_Bitrate);
@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <linux/videodev2.h>
+#include "h264_xu_ctrls.h"
+#include "md_monitor.h"
+
+struct MD_MONITOR
+{
+    int fd;
+    MD_MON_CONFIG cfg;
+    MD_MON_FN fn;
+    void *user;
+
+    int wake_fd;                    // 종료 / Kick
+    int notify_fd;                  // 결과 변화 알림 (MdMonitorEventFd)
+    int stop;
+    int kicked;
+    int event_mode;
+    unsigned int interval_ms;
+    unsigned int quiet;
+
+    pthread_mutex_t lock;
+    pthread_t thread;
+    int has_result;
+    MD_MON_RESULT last;             // lock 보호
+    MD_MON_STATS stats;             // lock 보호
+};
+
+static int default_ioctl(int fd, unsigned long request, void *arg)
+{
+    return ioctl(fd, request, arg);
+}
+
+static MD_MON_IOCTL_FN mon_ioctl = default_ioctl;
+static MD_MON_POLL_FN mon_poll = poll;
+
+void MdMonitorSetHooks(MD_MON_IOCTL_FN ioctl_fn, MD_MON_POLL_FN poll_fn)
+{
+    mon_ioctl = ioctl_fn ? ioctl_fn : default_ioctl;
+    mon_poll = poll_fn ? poll_fn : poll;
+}
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static int count_cells(const unsigned char *result)
+{
+    int i, n = 0;
+
+    for(i = 0; i < MD_MON_RESULT_BYTES; i++)
+        n += __builtin_popcount(result[i]);
+    return n;
+}
+
+// ===== V4L2 컨트롤 이벤트 =====
+
+static int event_subscribe(MD_MONITOR *mon)
+{
+#ifdef V4L2_EVENT_CTRL
+    struct v4l2_event_subscription sub;
+
+    memset(&sub, 0, sizeof(sub));
+    sub.type = V4L2_EVENT_CTRL;
+    sub.id = mon->cfg.event_ctrl_id;
+    if(mon_ioctl(mon->fd, VIDIOC_SUBSCRIBE_EVENT, &sub) == 0)
+        return 1;
+#endif
+    // 예전 uvcvideo (ENOTTY/EINVAL) 나 매핑되지 않은 컨트롤: 폴링으로 동작
+    return 0;
+}
+
+static void event_unsubscribe(MD_MONITOR *mon)
+{
+#ifdef V4L2_EVENT_CTRL
+    struct v4l2_event_subscription sub;
+
+    memset(&sub, 0, sizeof(sub));
+    sub.type = V4L2_EVENT_CTRL;
+    sub.id = mon->cfg.event_ctrl_id;
+    mon_ioctl(mon->fd, VIDIOC_UNSUBSCRIBE_EVENT, &sub);
+#endif
+}
+
+// 쌓인 이벤트를 모두 꺼낸다. 24 바이트 결과는 이벤트 값에 들어가지 않으므로 내용은 따로 읽는다
+static int event_drain(MD_MONITOR *mon)
+{
+    int n = 0;
+#ifdef V4L2_EVENT_CTRL
+    struct v4l2_event ev;
+
+    for(;;)
+    {
+        memset(&ev, 0, sizeof(ev));
+        if(mon_ioctl(mon->fd, VIDIOC_DQEVENT, &ev) < 0)
+            break;
+        n++;
+        if(ev.pending == 0)
+            break;
+    }
+#endif
+    return n;
+}
+
+// ===== 모니터 스레드 =====
+
+// 조용한 구간의 폴링 간격 상한. 이벤트가 없으면 이 간격이 움직임 시작 지연이 된다
+static unsigned int poll_cap(const MD_MONITOR *mon)
+{
+    if(mon->event_mode || mon->cfg.latency_ms > mon->cfg.max_interval_ms)
+        return mon->cfg.max_interval_ms;
+    return mon->cfg.latency_ms;
+}
+
+// 스레드만 바꾸는 값을 통계로 내보낸다
+static void publish_state(MD_MONITOR *mon)
+{
+    pthread_mutex_lock(&mon->lock);
+    mon->stats.interval_ms = mon->interval_ms;
+    mon->stats.event_mode = mon->event_mode;
+    pthread_mutex_unlock(&mon->lock);
+}
+
+static void read_result(MD_MONITOR *mon, MD_MON_SOURCE source)
+{
+    unsigned char result[MD_MON_RESULT_BYTES];
+    MD_MON_RESULT res;
+    int changed, active;
+    unsigned long long one = 1;
+
+    if(XU_MD_Read_RESULT(mon->fd, result) < 0)
+    {
+        // 장치가 바쁘거나 분리됨: 가장 느린 간격으로 재시도
+        pthread_mutex_lock(&mon->lock);
+        mon->stats.reads++;
+        mon->stats.errors++;
+        pthread_mutex_unlock(&mon->lock);
+        mon->interval_ms = mon->cfg.max_interval_ms;
+        publish_state(mon);
+        return;
+    }
+
+    active = count_cells(result);
+    pthread_mutex_lock(&mon->lock);
+    mon->stats.reads++;
+    changed = !mon->has_result || memcmp(mon->last.result, result, MD_MON_RESULT_BYTES) != 0;
+    if(changed)
+    {
+        memcpy(mon->last.result, result, MD_MON_RESULT_BYTES);
+        mon->last.sequence++;
+        mon->last.timestamp_us = now_us();
+        mon->last.active_cells = active;
+        mon->last.source = source;
+        mon->has_result = 1;
+        mon->stats.changes++;
+        res = mon->last;
+    }
+    pthread_mutex_unlock(&mon->lock);
+
+    // 움직임이 이어지는 동안은 빠르게, 조용해지면 점점 느리게
+    if(changed || active)
+    {
+        mon->interval_ms = mon->cfg.min_interval_ms;
+        mon->quiet = 0;
+    }
+    else if(++mon->quiet >= mon->cfg.quiet_polls)
+    {
+        mon->interval_ms *= 2;
+        if(mon->interval_ms > poll_cap(mon))
+            mon->interval_ms = poll_cap(mon);
+    }
+    publish_state(mon);
+
+    if(changed)
+    {
+        if(mon->fn)
+            mon->fn(&res, mon->user);
+        if(write(mon->notify_fd, &one, sizeof(one)) < 0)
+        {
+            // 카운터 포화: 소비자가 읽지 않고 있음
+        }
+    }
+}
+
+static void *monitor_thread(void *arg)
+{
+    MD_MONITOR *mon = (MD_MONITOR *)arg;
+    struct pollfd pfds[2];
+    unsigned long long count;
+    MD_MON_SOURCE source;
+    int n, r, stop, kicked, events;
+
+    read_result(mon, MD_MON_SRC_POLL);
+
+    for(;;)
+    {
+        pfds[0].fd = mon->wake_fd;
+        pfds[0].events = POLLIN;
+        pfds[0].revents = 0;
+        n = 1;
+        if(mon->event_mode)
+        {
+            // POLLPRI 만 기다린다 (스트리밍 중인 캡처 fd 여도 POLLIN 으로 깨지 않음)
+            pfds[1].fd = mon->fd;
+            pfds[1].events = POLLPRI;
+            pfds[1].revents = 0;
+            n = 2;
+        }
+
+        r = mon_poll(pfds, n, mon->event_mode ? (int)mon->cfg.max_interval_ms : (int)mon->interval_ms);
+        if(r < 0 && errno != EINTR)
+            break;
+
+        if(pfds[0].revents & POLLIN)
+        {
+            if(read(mon->wake_fd, &count, sizeof(count)) < 0)
+            {
+                // EAGAIN: 이미 비워짐
+            }
+        }
+
+        pthread_mutex_lock(&mon->lock);
+        stop = mon->stop;
+        kicked = mon->kicked;
+        mon->kicked = 0;
+        if(kicked)
+            mon->stats.kicks++;
+        pthread_mutex_unlock(&mon->lock);
+        if(stop)
+            break;
+
+        source = MD_MON_SRC_POLL;
+        if(n > 1 && (pfds[1].revents & (POLLERR | POLLHUP | POLLNVAL)))
+        {
+            // 장치가 이벤트를 더 줄 수 없음: 폴링으로 전환
+            event_unsubscribe(mon);
+            mon->event_mode = 0;
+            mon->interval_ms = mon->cfg.min_interval_ms;
+        }
+        else if(n > 1 && (pfds[1].revents & POLLPRI))
+        {
+            events = event_drain(mon);
+            pthread_mutex_lock(&mon->lock);
+            mon->stats.events += events;
+            pthread_mutex_unlock(&mon->lock);
+            source = MD_MON_SRC_EVENT;
+        }
+        if(kicked)
+        {
+            mon->interval_ms = mon->cfg.min_interval_ms;
+            mon->quiet = 0;
+            source = MD_MON_SRC_KICK;
+        }
+        else if(r != 0 && source != MD_MON_SRC_EVENT)
+        {
+            // 타이머 만료(폴링/안전 확인)도 이벤트도 아님 (EINTR, 폴링 전환)
+            publish_state(mon);
+            continue;
+        }
+
+        read_result(mon, source);
+    }
+    return NULL;
+}
+
+// ===== API =====
+
+MD_MONITOR *MdMonitorCreate(int fd, const MD_MON_CONFIG *cfg, MD_MON_FN fn, void *user)
+{
+    MD_MONITOR *mon;
+
+    mon = (MD_MONITOR *)calloc(1, sizeof(MD_MONITOR));
+    if(!mon)
+        return NULL;
+
+    mon->fd = fd;
+    mon->fn = fn;
+    mon->user = user;
+    if(cfg)
+        mon->cfg = *cfg;
+    else
+        mon->cfg.flags = MD_MON_FLAG_EVENTS;
+    if(mon->cfg.min_interval_ms == 0)
+        mon->cfg.min_interval_ms = MD_MON_DEFAULT_MIN_MS;
+    if(mon->cfg.max_interval_ms == 0)
+        mon->cfg.max_interval_ms = MD_MON_DEFAULT_MAX_MS;
+    if(mon->cfg.max_interval_ms < mon->cfg.min_interval_ms)
+        mon->cfg.max_interval_ms = mon->cfg.min_interval_ms;
+    if(mon->cfg.quiet_polls == 0)
+        mon->cfg.quiet_polls = MD_MON_DEFAULT_QUIET_POLLS;
+    if(mon->cfg.latency_ms == 0)
+        mon->cfg.latency_ms = MD_MON_DEFAULT_LATENCY_MS;
+    if(mon->cfg.latency_ms < mon->cfg.min_interval_ms)
+        mon->cfg.latency_ms = mon->cfg.min_interval_ms;
+    if(mon->cfg.event_ctrl_id == 0)
+        mon->cfg.event_ctrl_id = V4L2_CID_MOTION_DETECTION_RERVISION;
+    mon->interval_ms = mon->cfg.min_interval_ms;
+
+    mon->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mon->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(mon->wake_fd < 0 || mon->notify_fd < 0)
+    {
+        if(mon->wake_fd >= 0)
+            close(mon->wake_fd);
+        if(mon->notify_fd >= 0)
+            close(mon->notify_fd);
+        free(mon);
+        return NULL;
+    }
+    pthread_mutex_init(&mon->lock, NULL);
+
+    if(mon->cfg.flags & MD_MON_FLAG_EVENTS)
+        mon->event_mode = event_subscribe(mon);
+    mon->stats.interval_ms = mon->interval_ms;
+    mon->stats.event_mode = mon->event_mode;
+
+    if(pthread_create(&mon->thread, NULL, monitor_thread, mon) != 0)
+    {
+        if(mon->event_mode)
+            event_unsubscribe(mon);
+        pthread_mutex_destroy(&mon->lock);
+        close(mon->wake_fd);
+        close(mon->notify_fd);
+        free(mon);
+        return NULL;
+    }
+    return mon;
+}
+
+int MdMonitorEventFd(MD_MONITOR *mon)
+{
+    return mon->notify_fd;
+}
+
+int MdMonitorGetResult(MD_MONITOR *mon, MD_MON_RESULT *res)
+{
+    int ret = -1;
+
+    pthread_mutex_lock(&mon->lock);
+    if(mon->has_result)
+    {
+        *res = mon->last;
+        ret = 0;
+    }
+    pthread_mutex_unlock(&mon->lock);
+    return ret;
+}
+
+void MdMonitorKick(MD_MONITOR *mon)
+{
+    unsigned long long one = 1;
+
+    pthread_mutex_lock(&mon->lock);
+    mon->kicked = 1;
+    pthread_mutex_unlock(&mon->lock);
+    if(write(mon->wake_fd, &one, sizeof(one)) < 0)
+    {
+        // 이미 깨울 예정
+    }
+}
+
+void MdMonitorGetStats(MD_MONITOR *mon, MD_MON_STATS *stats)
+{
+    pthread_mutex_lock(&mon->lock);
+    *stats = mon->stats;
+    pthread_mutex_unlock(&mon->lock);
+}
+
+void MdMonitorDestroy(MD_MONITOR *mon)
+{
+    unsigned long long one = 1;
+
+    if(!mon)
+        return;
+    pthread_mutex_lock(&mon->lock);
+    mon->stop = 1;
+    pthread_mutex_unlock(&mon->lock);
+    if(write(mon->wake_fd, &one, sizeof(one)) < 0)
+    {
+        // 카운터가 이미 0 이 아님
+    }
+    pthread_join(mon->thread, NULL);
+
+    if(mon->event_mode)
+        event_unsubscribe(mon);
+    pthread_mutex_destroy(&mon->lock);
+    close(mon->wake_fd);
+    close(mon->notify_fd);
+    free(mon);
+}
@@ -0,0 +1,96 @@
+#ifndef _MD_MONITOR_H_
+#define _MD_MONITOR_H_
+
+#include <poll.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 하드웨어 모션 감지 결과 모니터 (XU_MD_Read_RESULT)
+// 전용 스레드가 결과를 읽고, 바뀌었을 때만 콜백 / eventfd 로 알린다.
+// - 폴링 간격은 적응형: 움직임이 있거나 결과가 바뀌면 min_interval, 조용한 폴이
+//   quiet_polls 번 이어지면 두 배씩 늘리되 latency 를 넘지 않는다. 폴링만 할 때는 조용한 구간의
+//   간격이 곧 움직임 시작을 알아채는 지연이므로, 기본값은 예전 매 프레임 읽기(30fps)와 같은 33ms
+// - 장치/드라이버가 컨트롤 변경 이벤트(V4L2_EVENT_CTRL)를 주면 그 이벤트에 깨어나 읽고,
+//   폴링은 max_interval 간격의 안전 확인만 한다. 구독이 안 되면 자동으로 폴링
+// - 전송 계층이 결과 레지스터의 스위치 명령을 생략하므로 연속 읽기는 전송 1 회
+// MD 셀렉터(마스크/임계값/결과)는 모니터가 도는 동안 다른 스레드에서 건드리지 않는다.
+
+#define MD_MON_RESULT_BYTES         24
+#define MD_MON_DEFAULT_MIN_MS       33
+#define MD_MON_DEFAULT_MAX_MS       1000
+#define MD_MON_DEFAULT_QUIET_POLLS  4
+#define MD_MON_DEFAULT_LATENCY_MS   33              // 폴링 모드의 움직임 시작 최대 지연
+
+#define MD_MON_FLAG_EVENTS          0x01            // V4L2 컨트롤 이벤트 구독 시도
+
+typedef enum
+{
+    MD_MON_SRC_POLL = 0,            // 폴링 타이머
+    MD_MON_SRC_EVENT,               // V4L2 컨트롤 이벤트
+    MD_MON_SRC_KICK                 // MdMonitorKick
+} MD_MON_SOURCE;
+
+typedef struct
+{
+    unsigned int min_interval_ms;   // 0 이면 MD_MON_DEFAULT_MIN_MS
+    unsigned int max_interval_ms;   // 이벤트 모드 안전 확인 / 오류 재시도 간격. 0 이면 MD_MON_DEFAULT_MAX_MS
+    unsigned int latency_ms;        // 폴링 모드 간격 상한. 0 이면 MD_MON_DEFAULT_LATENCY_MS
+    unsigned int quiet_polls;       // 0 이면 MD_MON_DEFAULT_QUIET_POLLS
+    unsigned int flags;             // MD_MON_FLAG_*
+    unsigned int event_ctrl_id;     // 0 이면 V4L2_CID_MOTION_DETECTION_RERVISION
+} MD_MON_CONFIG;
+
+typedef struct
+{
+    unsigned char result[MD_MON_RESULT_BYTES];  // XU_MD_Get_RESULT 배치
+    unsigned int sequence;          // 변화 번호 (첫 결과 1)
+    unsigned long long timestamp_us;    // 읽은 시각 (CLOCK_MONOTONIC)
+    int active_cells;
+    MD_MON_SOURCE source;
+} MD_MON_RESULT;
+
+typedef struct
+{
+    unsigned long reads;            // XU_MD_Read_RESULT 호출 수
+    unsigned long changes;          // 알린 결과 수
+    unsigned long events;           // V4L2 이벤트로 깨어난 횟수
+    unsigned long kicks;
+    unsigned long errors;
+    unsigned int interval_ms;       // 현재 폴링 간격
+    int event_mode;                 // 1 이면 V4L2 이벤트 구독 중
+} MD_MON_STATS;
+
+typedef struct MD_MONITOR MD_MONITOR;
+
+// 모니터 스레드에서 호출된다 (오래 걸리면 다음 읽기가 늦어짐)
+typedef void (*MD_MON_FN)(const MD_MON_RESULT *res, void *user);
+
+// fd 는 XU 컨트롤을 보낼 장치. cfg 가 NULL 이면 기본값 + 이벤트 시도. fn 은 NULL 가능. 실패 시 NULL
+MD_MONITOR *MdMonitorCreate(int fd, const MD_MON_CONFIG *cfg, MD_MON_FN fn, void *user);
+
+// 결과가 바뀔 때마다 1 씩 더해지는 eventfd (EFD_NONBLOCK, 읽은 뒤 MdMonitorGetResult)
+int MdMonitorEventFd(MD_MONITOR *mon);
+
+// 마지막 결과. 아직 한 번도 읽지 못했으면 -1
+int MdMonitorGetResult(MD_MONITOR *mon, MD_MON_RESULT *res);
+
+// 즉시 한 번 읽고 폴링 간격을 min_interval 로 되돌린다 (다른 경로에서 움직임을 감지했을 때 등)
+void MdMonitorKick(MD_MONITOR *mon);
+
+void MdMonitorGetStats(MD_MONITOR *mon, MD_MON_STATS *stats);
+
+// 스레드를 끝내고 이벤트 구독을 해제한다
+void MdMonitorDestroy(MD_MONITOR *mon);
+
+// 테스트용 ioctl(VIDIOC_*_EVENT) / poll 대체 (NULL 이면 기본). XU 전송은 XU_Set_Ioctl 로 바꾼다
+typedef int (*MD_MON_IOCTL_FN)(int fd, unsigned long request, void *arg);
+typedef int (*MD_MON_POLL_FN)(struct pollfd *fds, nfds_t nfds, int timeout);
+void MdMonitorSetHooks(MD_MON_IOCTL_FN ioctl_fn, MD_MON_POLL_FN poll_fn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
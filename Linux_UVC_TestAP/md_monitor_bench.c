@@ -0,0 +1,420 @@
+//----------------------------------------------//
+//	모션 감지 결과 모니터 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./md_monitor_bench
+// 모의 XU 장치(스위치 명령 + MD 결과 레지스터)와 모의 V4L2 컨트롤 이벤트를 두고
+// 정지 → 움직임 → 정지 장면을 실시간으로 재생하면서 네 가지 방식을 비교한다.
+//   legacy   : 전송 캐시 끔, 33ms 고정 폴링 (예전 TestAP 의 매 프레임 읽기, 매번 스위치 + GET)
+//   fixed    : 33ms 고정 폴링 (스위치 생략)
+//   adaptive : 움직이는 동안 10ms, 조용하면 지연 상한(33ms)까지 늘리는 적응형 폴링
+//   event    : 컨트롤 변경 이벤트 + 1초 안전 확인
+// 방식마다 USB 컨트롤 전송 수, 받은 변화 수, 움직임 시작 / 변화 → 콜백 지연을 출력한다.
+// 마지막 결과 누락, 콜백/eventfd 불일치, 적응형의 지연이 legacy 보다 나쁘거나
+// 적응형/이벤트 방식의 전송 수 증가가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <linux/videodev2.h>
+#include "h264_xu_ctrls.h"
+#include "md_monitor.h"
+
+// h264_xu_ctrls.c 가 참조하는 TestAP 전역
+struct H264Format *gH264fmt = NULL;
+int Dbg_Param = 0;
+
+#define MOCK_FD             42
+#define SCENE_STATIC_MS     400         // 처음 정지 구간
+#define SCENE_STEP_MS       50          // 움직임 구간의 결과 변화 간격
+#define SCENE_STEPS         8
+#define SCENE_TAIL_MS       900         // 움직임이 끝난 뒤 정지 구간
+#define MAX_CHANGES         (SCENE_STEPS + 2)
+
+// 모의 장치: MD 셀렉터의 현재 sub, 결과 레지스터, 이벤트 큐
+static struct
+{
+    pthread_mutex_t lock;
+    int cur_sub;
+    int expect_data;
+    unsigned char result[MD_MON_RESULT_BYTES];
+    int events_supported;
+    int subscribed;
+    int pending;
+    int event_fd;                       // pending 이 있으면 읽기 가능 (POLLPRI 로 변환)
+    unsigned int transfers;
+    unsigned int switches;
+
+    // 장면이 결과를 바꾼 시각 (지연 측정)
+    int nchanges;
+    unsigned char change_result[MAX_CHANGES][MD_MON_RESULT_BYTES];
+    unsigned long long change_us[MAX_CHANGES];
+} mock;
+
+// 콜백이 받은 결과
+static struct
+{
+    pthread_mutex_t lock;
+    int count;
+    unsigned char result[64][MD_MON_RESULT_BYTES];
+    unsigned long long us[64];
+} got;
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static int mock_ioctl(int fd, unsigned long request, void *arg)
+{
+    int ret = 0;
+
+    if(fd != MOCK_FD)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    pthread_mutex_lock(&mock.lock);
+    if(request == UVCIOC_CTRL_QUERY)
+    {
+        struct uvc_xu_control_query *q = (struct uvc_xu_control_query *)arg;
+
+        mock.transfers++;
+        if(q->unit != XU_RERVISION_USR_ID || q->selector != XU_RERVISION_USR_MOTION_DETECTION)
+        {
+            errno = EINVAL;
+            ret = -1;
+        }
+        else if(q->query == UVC_SET_CUR && !mock.expect_data && q->data[0] == 0x9A)
+        {
+            mock.cur_sub = q->data[1];
+            mock.expect_data = 1;
+            mock.switches++;
+        }
+        else
+        {
+            mock.expect_data = 0;
+            if(mock.cur_sub != 0x04 || q->query != UVC_GET_CUR)
+            {
+                errno = EIO;
+                ret = -1;
+            }
+            else
+                memcpy(q->data, mock.result, MD_MON_RESULT_BYTES);
+        }
+    }
+    else if(request == VIDIOC_SUBSCRIBE_EVENT)
+    {
+        struct v4l2_event_subscription *sub = (struct v4l2_event_subscription *)arg;
+
+        if(!mock.events_supported || sub->type != V4L2_EVENT_CTRL || sub->id != V4L2_CID_MOTION_DETECTION_RERVISION)
+        {
+            errno = ENOTTY;
+            ret = -1;
+        }
+        else
+            mock.subscribed = 1;
+    }
+    else if(request == VIDIOC_UNSUBSCRIBE_EVENT)
+    {
+        mock.subscribed = 0;
+    }
+    else if(request == VIDIOC_DQEVENT)
+    {
+        struct v4l2_event *ev = (struct v4l2_event *)arg;
+
+        if(mock.pending == 0)
+        {
+            errno = ENOENT;
+            ret = -1;
+        }
+        else
+        {
+            unsigned long long count;
+
+            memset(ev, 0, sizeof(*ev));
+            ev->type = V4L2_EVENT_CTRL;
+            ev->id = V4L2_CID_MOTION_DETECTION_RERVISION;
+            ev->u.ctrl.changes = V4L2_EVENT_CTRL_CH_VALUE;
+            ev->pending = --mock.pending;
+            if(mock.pending == 0 && read(mock.event_fd, &count, sizeof(count)) < 0)
+            {
+                // 이미 비워짐
+            }
+        }
+    }
+    else
+    {
+        errno = ENOTTY;
+        ret = -1;
+    }
+    pthread_mutex_unlock(&mock.lock);
+    return ret;
+}
+
+// 장치 fd 의 POLLPRI 를 모의 eventfd 의 POLLIN 으로 바꿔 기다린다
+static int mock_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    struct pollfd tmp[4];
+    nfds_t i;
+    int r;
+
+    for(i = 0; i < nfds; i++)
+    {
+        tmp[i] = fds[i];
+        if(fds[i].fd == MOCK_FD)
+        {
+            tmp[i].fd = mock.event_fd;
+            tmp[i].events = POLLIN;
+        }
+    }
+    r = poll(tmp, nfds, timeout);
+    for(i = 0; i < nfds; i++)
+    {
+        fds[i].revents = tmp[i].revents;
+        if(fds[i].fd == MOCK_FD && (tmp[i].revents & POLLIN))
+            fds[i].revents = POLLPRI;
+    }
+    return r;
+}
+
+static void scene_set(const unsigned char *result)
+{
+    unsigned long long one = 1;
+
+    pthread_mutex_lock(&mock.lock);
+    memcpy(mock.result, result, MD_MON_RESULT_BYTES);
+    if(mock.nchanges < MAX_CHANGES)
+    {
+        memcpy(mock.change_result[mock.nchanges], result, MD_MON_RESULT_BYTES);
+        mock.change_us[mock.nchanges] = now_us();
+        mock.nchanges++;
+    }
+    // 장치가 Control Change 인터럽트를 보내고 드라이버가 이벤트로 전달
+    if(mock.subscribed)
+    {
+        mock.pending++;
+        if(write(mock.event_fd, &one, sizeof(one)) < 0)
+        {
+            // 포화
+        }
+    }
+    pthread_mutex_unlock(&mock.lock);
+}
+
+static void on_result(const MD_MON_RESULT *res, void *user)
+{
+    (void)user;
+    pthread_mutex_lock(&got.lock);
+    if(got.count < 64)
+    {
+        memcpy(got.result[got.count], res->result, MD_MON_RESULT_BYTES);
+        got.us[got.count] = now_us();
+        got.count++;
+    }
+    pthread_mutex_unlock(&got.lock);
+}
+
+typedef struct
+{
+    const char *name;
+    int cache;
+    int events;
+    unsigned int min_ms, max_ms, latency_ms;
+} bench_mode_t;
+
+typedef struct
+{
+    unsigned int transfers;
+    unsigned int switches;
+    unsigned long reads;
+    int delivered;                      // 콜백이 받은 장면 변화 수
+    double mean_ms, max_ms;
+    double onset_ms;                    // 첫 움직임 → 처음 움직임 결과를 받을 때까지
+    int final_ok;
+    int notify_ok;
+} result_t;
+
+static void run_mode(const bench_mode_t *m, result_t *out)
+{
+    static const unsigned char zero[MD_MON_RESULT_BYTES] = { 0 };
+    MD_MON_CONFIG cfg;
+    MD_MONITOR *mon;
+    MD_MON_STATS st;
+    MD_MON_RESULT last;
+    unsigned long long count = 0;
+    double sum = 0;
+    int i, j, k;
+
+    pthread_mutex_lock(&mock.lock);
+    mock.cur_sub = -1;
+    mock.expect_data = 0;
+    memset(mock.result, 0, sizeof(mock.result));
+    mock.events_supported = m->events;
+    mock.subscribed = 0;
+    mock.pending = 0;
+    mock.event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mock.transfers = 0;
+    mock.switches = 0;
+    mock.nchanges = 0;
+    pthread_mutex_unlock(&mock.lock);
+    pthread_mutex_lock(&got.lock);
+    got.count = 0;
+    pthread_mutex_unlock(&got.lock);
+
+    XU_Cache_Enable(m->cache);
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.min_interval_ms = m->min_ms;
+    cfg.max_interval_ms = m->max_ms;
+    cfg.latency_ms = m->latency_ms;
+    cfg.flags = m->events ? MD_MON_FLAG_EVENTS : 0;
+    mon = MdMonitorCreate(MOCK_FD, &cfg, on_result, NULL);
+    if(!mon)
+    {
+        memset(out, 0, sizeof(*out));
+        close(mock.event_fd);
+        return;
+    }
+
+    // 정지 → 움직임(결과가 SCENE_STEP_MS 마다 바뀜) → 정지
+    usleep(SCENE_STATIC_MS * 1000);
+    for(i = 0; i < SCENE_STEPS; i++)
+    {
+        unsigned char r[MD_MON_RESULT_BYTES] = { 0 };
+        r[8 + (i / 4) * 2] = (unsigned char)(0x07 << (i % 4));
+        r[10 + (i / 4) * 2] = (unsigned char)(0x07 << (i % 4));
+        scene_set(r);
+        usleep(SCENE_STEP_MS * 1000);
+    }
+    scene_set(zero);
+    usleep(SCENE_TAIL_MS * 1000);
+
+    if(read(MdMonitorEventFd(mon), &count, sizeof(count)) < 0)
+        count = 0;
+    MdMonitorGetStats(mon, &st);
+    out->final_ok = MdMonitorGetResult(mon, &last) == 0 && memcmp(last.result, zero, sizeof(zero)) == 0;
+    MdMonitorDestroy(mon);
+
+    pthread_mutex_lock(&mock.lock);
+    out->transfers = mock.transfers;
+    out->switches = mock.switches;
+    pthread_mutex_unlock(&mock.lock);
+    out->reads = st.reads;
+    out->notify_ok = count == st.changes && (int)st.changes == got.count;
+
+    // 장면 변화마다 처음으로 같은 결과를 받은 시각 (그 변화 이후)
+    out->delivered = 0;
+    out->max_ms = 0;
+    for(i = 0; i < mock.nchanges; i++)
+    {
+        for(j = 0; j < got.count; j++)
+        {
+            if(got.us[j] >= mock.change_us[i] && memcmp(got.result[j], mock.change_result[i], MD_MON_RESULT_BYTES) == 0)
+            {
+                double ms = (got.us[j] - mock.change_us[i]) / 1000.0;
+                // 다음 변화 이후에 받은 것은 이 변화의 결과가 아님
+                k = i + 1;
+                if(k < mock.nchanges && got.us[j] > mock.change_us[k] + 1000)
+                    break;
+                sum += ms;
+                if(ms > out->max_ms)
+                    out->max_ms = ms;
+                out->delivered++;
+                break;
+            }
+        }
+    }
+    out->mean_ms = out->delivered ? sum / out->delivered : 0;
+
+    out->onset_ms = -1;
+    for(j = 0; j < got.count && mock.nchanges > 0; j++)
+    {
+        if(memcmp(got.result[j], zero, sizeof(zero)) != 0)
+        {
+            out->onset_ms = (got.us[j] - mock.change_us[0]) / 1000.0;
+            break;
+        }
+    }
+    close(mock.event_fd);
+}
+
+int main(void)
+{
+    static const bench_mode_t modes[] =
+    {
+        { "legacy",   0, 0, 33, 33, 33 },
+        { "fixed",    1, 0, 33, 33, 33 },
+        { "adaptive", 1, 0, 10, 320, 0 },           // 지연 상한 기본값 (MD_MON_DEFAULT_LATENCY_MS)
+        { "event",    1, 1, 10, 1000, 0 },
+    };
+    result_t res[4];
+    int failures = 0;
+    int i;
+
+    pthread_mutex_init(&mock.lock, NULL);
+    pthread_mutex_init(&got.lock, NULL);
+    XU_Set_Ioctl(mock_ioctl);
+    MdMonitorSetHooks(mock_ioctl, mock_poll);
+
+    printf("장면: 정지 %d ms → 결과 변화 %d 회 (%d ms 간격) → 정지 %d ms\n\n",
+           SCENE_STATIC_MS, SCENE_STEPS + 1, SCENE_STEP_MS, SCENE_TAIL_MS);
+    printf("%-9s %9s %8s %7s %10s %9s %9s %9s\n", "mode", "transfers", "switches", "reads", "delivered",
+           "onset ms", "mean ms", "max ms");
+    for(i = 0; i < 4; i++)
+    {
+        run_mode(&modes[i], &res[i]);
+        printf("%-9s %9u %8u %7lu %7d/%-2d %9.1f %9.1f %9.1f%s%s\n", modes[i].name, res[i].transfers, res[i].switches,
+               res[i].reads, res[i].delivered, SCENE_STEPS + 1, res[i].onset_ms, res[i].mean_ms, res[i].max_ms,
+               res[i].final_ok ? "" : "  [마지막 결과 누락]", res[i].notify_ok ? "" : "  [eventfd/콜백 수 불일치]");
+        if(!res[i].final_ok || !res[i].notify_ok)
+            failures++;
+    }
+
+    // 스위치 생략: 고정 폴링의 전송 수가 legacy 의 절반 정도
+    if(res[1].transfers * 3 > res[0].transfers * 2)
+    {
+        printf("fixed: 스위치 생략이 동작하지 않음\n");
+        failures++;
+    }
+    // 적응형은 legacy 보다 전송이 적으면서 지연은 나쁘지 않아야 한다:
+    // 움직임 시작은 legacy 폴링 간격(legacy 의 최악 지연, 스케줄링 여유 10ms) 안에 잡고,
+    // 변화는 모두 전달하며 평균 지연은 legacy 보다 짧다
+    if(res[2].transfers >= res[0].transfers)
+    {
+        printf("adaptive: 전송 수가 legacy 보다 줄지 않음\n");
+        failures++;
+    }
+    if(res[2].onset_ms < 0 || res[2].onset_ms > modes[0].min_ms + 10 ||
+       res[2].delivered < res[0].delivered || res[2].mean_ms > res[0].mean_ms)
+    {
+        printf("adaptive: 움직임 지연이 legacy 보다 나쁨 (시작 %.1f / %.1f ms, 평균 %.1f / %.1f ms)\n",
+               res[2].onset_ms, res[0].onset_ms, res[2].mean_ms, res[0].mean_ms);
+        failures++;
+    }
+    // 이벤트 방식은 변화를 모두 전달하고 가장 적게 읽는다
+    if(res[3].delivered != SCENE_STEPS + 1 || res[3].transfers > res[2].transfers)
+    {
+        printf("event: 변화 누락 또는 전송 수 과다\n");
+        failures++;
+    }
+
+    if(failures)
+    {
+        printf("\n불일치 %d 건\n", failures);
+        return 1;
+    }
+    printf("\n전송 수 legacy 대비: fixed x%.2f, adaptive x%.2f, event x%.2f\n",
+           (double)res[1].transfers / res[0].transfers, (double)res[2].transfers / res[0].transfers,
+           (double)res[3].transfers / res[0].transfers);
+    return 0;
+}
@@ -0,0 +1,439 @@
+//----------------------------------------------//
+//	MJPEG DHT 삽입 벤치마크 / 검증				//
+//----------------------------------------------//
+// 사용법: ./mjpeg_dht_bench [frame.jpg ...]
+// 파일을 주지 않으면 UVC 카메라가 보내는 헤더 모양을 흉내 낸 합성 프레임 모음을 만든다.
+//   legacy-0xaf : SOF0 가 0xaf 에 있는 프레임 (기존 고정 오프셋과 결과가 같아야 함)
+//   avi1        : APP0 AVI1 + DQT 한 세그먼트 (SOF0 가 0xaf 가 아님)
+//   dri-fill    : DRI + 마커 앞 0xFF 채움 바이트 + 엔트로피 데이터 안의 RSTn
+//   has-dht     : 이미 DHT 가 있는 프레임 (그대로 통과해야 함)
+//   hd-420      : 1280x720 4:2:0, 큰 페이로드
+// 프레임마다 iovec 결과를 모은 것이 "SOF 앞에 DHT" 정답과 바이트 단위로 같은지,
+// 다시 파싱하면 DHT 가 있고 해상도가 같은지, 잘리거나 깨진 헤더를 거부하는지 확인한다.
+// 기존 방식(3 번 memcpy, 바이트 단위 0xFFC0 검색)과 iovec 방식의 프레임당 시간을 비교한다.
+// 하나라도 어긋나면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mjpeg_dht.h"
+
+#define DHT_LEN             420
+#define HEADERFRAME1        0xaf
+#define BENCH_ITERS         2000
+
+// v4l2uvc.c 의 dht_data 와 같은 표준 테이블 (Annex K.3, 한 세그먼트)
+static unsigned char dht[DHT_LEN];
+
+static void build_dht(void)
+{
+    static const unsigned char bits_dc_l[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+    static const unsigned char bits_dc_c[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+    static const unsigned char bits_ac_l[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+    static const unsigned char bits_ac_c[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+    const unsigned char *bits[4] = { bits_dc_l, bits_ac_l, bits_dc_c, bits_ac_c };
+    static const unsigned char cls[4] = { 0x00, 0x10, 0x01, 0x11 };
+    unsigned int pos = 4, t, i, n;
+
+    dht[0] = 0xFF;
+    dht[1] = 0xC4;
+    dht[2] = (DHT_LEN - 2) >> 8;
+    dht[3] = (DHT_LEN - 2) & 0xFF;
+    for(t = 0; t < 4; t++)
+    {
+        dht[pos++] = cls[t];
+        for(i = 0, n = 0; i < 16; i++)
+        {
+            dht[pos++] = bits[t][i];
+            n += bits[t][i];
+        }
+        // 심볼 값은 검증에 쓰이지 않으므로 순번으로 채운다 (길이만 표준과 같게)
+        for(i = 0; i < n; i++)
+            dht[pos++] = (unsigned char)i;
+    }
+}
+
+// ===== 합성 프레임 =====
+
+typedef struct
+{
+    unsigned char *buf;
+    unsigned int len;
+    unsigned int cap;
+} OUT;
+
+static void put(OUT *o, const void *p, unsigned int n)
+{
+    if(o->len + n > o->cap)
+    {
+        o->cap = (o->len + n) * 2;
+        o->buf = (unsigned char *)realloc(o->buf, o->cap);
+    }
+    memcpy(o->buf + o->len, p, n);
+    o->len += n;
+}
+
+static void put_byte(OUT *o, unsigned char c)
+{
+    put(o, &c, 1);
+}
+
+// 마커 + 길이 + 내용 (내용은 fill 로 채움)
+static void put_segment(OUT *o, unsigned char marker, unsigned int body_len, unsigned char fill)
+{
+    unsigned int i;
+
+    put_byte(o, 0xFF);
+    put_byte(o, marker);
+    put_byte(o, (unsigned char)((body_len + 2) >> 8));
+    put_byte(o, (unsigned char)(body_len + 2));
+    for(i = 0; i < body_len; i++)
+        put_byte(o, fill);
+}
+
+static void put_sof0(OUT *o, unsigned int w, unsigned int h, unsigned char y_samp)
+{
+    unsigned char sof[19] = { 0xFF, 0xC0, 0x00, 0x11, 0x08, 0, 0, 0, 0, 0x03,
+                              0x01, 0, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01 };
+
+    sof[5] = (unsigned char)(h >> 8);
+    sof[6] = (unsigned char)h;
+    sof[7] = (unsigned char)(w >> 8);
+    sof[8] = (unsigned char)w;
+    sof[11] = y_samp;
+    put(o, sof, sizeof(sof));
+}
+
+static void put_sos(OUT *o)
+{
+    static const unsigned char sos[14] = { 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11,
+                                           0x03, 0x11, 0x00, 0x3F, 0x00 };
+    put(o, sos, sizeof(sos));
+}
+
+// 엔트로피 데이터: 0xFF 는 0xFF00 으로 스터핑, rst 가 0 이 아니면 그 간격마다 RSTn
+static void put_entropy(OUT *o, unsigned int len, unsigned int seed, unsigned int rst)
+{
+    unsigned int i, v = seed * 2654435761u + 7, r = 0;
+
+    for(i = 0; i < len; i++)
+    {
+        v = v * 1103515245u + 12345u;
+        put_byte(o, (unsigned char)(v >> 24));
+        if((unsigned char)(v >> 24) == 0xFF)
+            put_byte(o, 0x00);
+        if(rst && i % rst == rst - 1)
+        {
+            put_byte(o, 0xFF);
+            put_byte(o, (unsigned char)(0xD0 + (r++ & 7)));
+        }
+    }
+    put_byte(o, 0xFF);
+    put_byte(o, 0xD9);
+}
+
+typedef struct
+{
+    const char *name;
+    OUT frame;
+    unsigned int insert_at;         // 정답 삽입 위치 (DHT 가 있으면 0)
+    int has_dht;
+    unsigned int width, height;
+} SAMPLE;
+
+#define SAMPLE_COUNT    5
+
+static void make_corpus(SAMPLE *s)
+{
+    static const unsigned char soi[2] = { 0xFF, 0xD8 };
+    static const unsigned char avi1[16] = { 0xFF, 0xE0, 0x00, 0x0E, 'A', 'V', 'I', '1', 0, 0, 0, 0, 0, 0, 0, 0 };
+    static const unsigned char fill[3] = { 0xFF, 0xFF, 0xFF };
+    int i;
+
+    memset(s, 0, sizeof(SAMPLE) * SAMPLE_COUNT);
+
+    // SOI + APP0 JFIF(16) + DQT x2 + COM(15) → SOF0 가 0xaf
+    s[0].name = "legacy-0xaf";
+    put(&s[0].frame, soi, 2);
+    put_segment(&s[0].frame, 0xE0, 14, 0x4A);
+    put_segment(&s[0].frame, 0xDB, 65, 0x10);
+    put_segment(&s[0].frame, 0xDB, 65, 0x11);
+    put_segment(&s[0].frame, 0xFE, 13, 'c');
+    s[0].insert_at = s[0].frame.len;
+    put_sof0(&s[0].frame, 640, 480, 0x21);
+    put_sos(&s[0].frame);
+    put_entropy(&s[0].frame, 40000, 1, 0);
+    s[0].width = 640;
+    s[0].height = 480;
+
+    // APP0 AVI1 + DQT 두 테이블을 한 세그먼트로
+    s[1].name = "avi1";
+    put(&s[1].frame, soi, 2);
+    put(&s[1].frame, avi1, sizeof(avi1));
+    put_segment(&s[1].frame, 0xDB, 130, 0x20);
+    s[1].insert_at = s[1].frame.len;
+    put_sof0(&s[1].frame, 640, 480, 0x21);
+    put_sos(&s[1].frame);
+    put_entropy(&s[1].frame, 50000, 2, 0);
+    s[1].width = 640;
+    s[1].height = 480;
+
+    // DRI + 채움 바이트 + RSTn
+    s[2].name = "dri-fill";
+    put(&s[2].frame, soi, 2);
+    put_segment(&s[2].frame, 0xDB, 130, 0x30);
+    put(&s[2].frame, fill, 3);
+    put_segment(&s[2].frame, 0xDD, 2, 0x00);
+    s[2].frame.buf[s[2].frame.len - 1] = 40;
+    put(&s[2].frame, fill, 2);
+    s[2].insert_at = s[2].frame.len;        // 채움 바이트는 헤더 쪽에 남고 SOF0 의 FF 앞에 삽입
+    put_sof0(&s[2].frame, 320, 240, 0x21);
+    put_sos(&s[2].frame);
+    put_entropy(&s[2].frame, 20000, 3, 997);
+    s[2].width = 320;
+    s[2].height = 240;
+
+    // DHT 가 이미 있음
+    s[3].name = "has-dht";
+    put(&s[3].frame, soi, 2);
+    put_segment(&s[3].frame, 0xDB, 130, 0x40);
+    put(&s[3].frame, dht, DHT_LEN);
+    put_sof0(&s[3].frame, 640, 480, 0x21);
+    put_sos(&s[3].frame);
+    put_entropy(&s[3].frame, 30000, 4, 0);
+    s[3].has_dht = 1;
+    s[3].width = 640;
+    s[3].height = 480;
+
+    // HD 4:2:0
+    s[4].name = "hd-420";
+    put(&s[4].frame, soi, 2);
+    put(&s[4].frame, avi1, sizeof(avi1));
+    put_segment(&s[4].frame, 0xDB, 65, 0x50);
+    put_segment(&s[4].frame, 0xDB, 65, 0x51);
+    s[4].insert_at = s[4].frame.len;
+    put_sof0(&s[4].frame, 1280, 720, 0x22);
+    put_sos(&s[4].frame);
+    put_entropy(&s[4].frame, 300000, 5, 0);
+    s[4].width = 1280;
+    s[4].height = 720;
+
+    for(i = 0; i < SAMPLE_COUNT; i++)
+        if(!s[i].frame.buf)
+            exit(2);
+}
+
+// ===== 기존 방식 =====
+
+// v4l2uvc.c uvcGrab: 고정 오프셋에 3 번 memcpy
+static unsigned int legacy_fixed(unsigned char *dst, const unsigned char *src, unsigned int len)
+{
+    memcpy(dst, src, HEADERFRAME1);
+    memcpy(dst + HEADERFRAME1, dht, DHT_LEN);
+    memcpy(dst + HEADERFRAME1 + DHT_LEN, src + HEADERFRAME1, len - HEADERFRAME1);
+    return len + DHT_LEN;
+}
+
+// UCAM-Motion_detection get_picture: 0xFFC4 를 바이트 단위로 찾고 없으면 0xFFC0 앞에 삽입
+static unsigned int legacy_scan(unsigned char *dst, const unsigned char *src, unsigned int len)
+{
+    const unsigned char *p = src;
+    unsigned int i = 0, at;
+
+    while(((p[0] << 8) | p[1]) != 0xffda)
+    {
+        if(i++ > 2048)
+            break;
+        if(((p[0] << 8) | p[1]) == 0xffc4)
+        {
+            memcpy(dst, src, len);
+            return len;
+        }
+        p++;
+    }
+    p = src;
+    while(((p[0] << 8) | p[1]) != 0xffc0)
+        p++;
+    at = (unsigned int)(p - src);
+    memcpy(dst, src, at);
+    memcpy(dst + at, dht, DHT_LEN);
+    memcpy(dst + at + DHT_LEN, src + at, len - at);
+    return len + DHT_LEN;
+}
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// 정답: insert_at 에 DHT 를 끼운 프레임
+static int check_sample(const SAMPLE *s, unsigned char *tmp, unsigned int tmp_size)
+{
+    struct iovec iov[MJPEG_IOV_MAX];
+    MJPEG_INFO info, out_info;
+    unsigned int n, expect_len;
+    int cnt, ok = 1;
+
+    cnt = MjpegDhtIovec(s->frame.buf, s->frame.len, dht, DHT_LEN, iov, &info);
+    if(cnt < 0)
+    {
+        printf("불일치: %s 파싱 실패\n", s->name);
+        return 1;
+    }
+    n = MjpegGather(tmp, tmp_size, iov, cnt);
+    if(s->has_dht)
+    {
+        ok = cnt == 1 && n == s->frame.len && memcmp(tmp, s->frame.buf, n) == 0;
+    }
+    else
+    {
+        expect_len = s->frame.len + DHT_LEN;
+        ok = cnt == 3 && n == expect_len && info.sof_offset == s->insert_at &&
+             memcmp(tmp, s->frame.buf, s->insert_at) == 0 &&
+             memcmp(tmp + s->insert_at, dht, DHT_LEN) == 0 &&
+             memcmp(tmp + s->insert_at + DHT_LEN, s->frame.buf + s->insert_at, s->frame.len - s->insert_at) == 0;
+    }
+    ok = ok && info.width == s->width && info.height == s->height && info.sof_marker == 0xC0;
+    ok = ok && MjpegParse(tmp, n, &out_info) == 0 && out_info.has_dht && out_info.width == s->width;
+    printf("  %-12s %7u bytes  %4ux%-4u  Y %ux%u  SOF @0x%03x  SOS @0x%03x  DRI %3u  DHT %s → iov %d  %s\n",
+           s->name, s->frame.len, info.width, info.height, info.h_samp, info.v_samp, info.sof_offset,
+           info.sos_offset, info.restart_interval, info.has_dht ? "있음" : "없음", cnt, ok ? "OK" : "불일치");
+    return ok ? 0 : 1;
+}
+
+// 깨진 헤더 거부
+static int check_rejects(const SAMPLE *s)
+{
+    unsigned char bad[64];
+    MJPEG_INFO info;
+    unsigned int cut;
+    int failures = 0;
+
+    // SOS 전에서 자른 프레임
+    for(cut = 0; cut < s->insert_at + 19; cut++)
+        if(MjpegParse(s->frame.buf, cut, &info) == 0)
+            failures++;
+    // SOI 가 아님
+    memcpy(bad, s->frame.buf, sizeof(bad));
+    bad[1] = 0xD9;
+    failures += MjpegParse(bad, sizeof(bad), &info) == 0;
+    // 세그먼트 길이가 버퍼를 넘음
+    memcpy(bad, s->frame.buf, sizeof(bad));
+    bad[4] = 0x7F;
+    failures += MjpegParse(bad, sizeof(bad), &info) == 0;
+    // 마커 사이에 쓰레기
+    memcpy(bad, s->frame.buf, sizeof(bad));
+    bad[2] = 0x12;
+    failures += MjpegParse(bad, sizeof(bad), &info) == 0;
+
+    printf("깨진 헤더 거부: %s\n", failures ? "실패" : "잘린 헤더, SOI 없음, 길이 초과, 마커 사이 쓰레기 모두 -1");
+    return failures ? 1 : 0;
+}
+
+static int check_file(const char *path, unsigned char *tmp, unsigned int tmp_size)
+{
+    struct iovec iov[MJPEG_IOV_MAX];
+    MJPEG_INFO info, out_info;
+    unsigned char *buf;
+    unsigned int len, n;
+    int cnt, ok;
+    FILE *fp = fopen(path, "rb");
+
+    if(!fp)
+    {
+        printf("%s 열기 실패\n", path);
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    len = (unsigned int)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = (unsigned char *)malloc(len ? len : 1);
+    if(!buf || fread(buf, 1, len, fp) != len)
+    {
+        fclose(fp);
+        free(buf);
+        return 1;
+    }
+    fclose(fp);
+
+    cnt = MjpegDhtIovec(buf, len, dht, DHT_LEN, iov, &info);
+    n = cnt > 0 ? MjpegGather(tmp, tmp_size, iov, cnt) : 0;
+    ok = cnt > 0 && n > 0 && MjpegParse(tmp, n, &out_info) == 0 && out_info.has_dht;
+    printf("  %s: %u bytes, %ux%u, SOF @0x%x, DHT %s → iov %d  %s\n", path, len, info.width, info.height,
+           info.sof_offset, info.has_dht ? "있음" : "없음", cnt, ok ? "OK" : "실패");
+    free(buf);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    SAMPLE corpus[SAMPLE_COUNT];
+    unsigned int tmp_size = 4 << 20;
+    unsigned char *tmp = (unsigned char *)malloc(tmp_size);
+    unsigned long long t0, t_fixed, t_scan, t_iov;
+    volatile unsigned int sink = 0;
+    struct iovec iov[MJPEG_IOV_MAX];
+    MJPEG_INFO info;
+    int i, k, failures = 0;
+
+    if(!tmp)
+        return 2;
+    build_dht();
+
+    if(argc >= 2)
+    {
+        printf("=== MJPEG DHT 검사 (%d 파일) ===\n", argc - 1);
+        for(i = 1; i < argc; i++)
+            failures += check_file(argv[i], tmp, tmp_size);
+        free(tmp);
+        return failures ? 1 : 0;
+    }
+
+    make_corpus(corpus);
+    printf("=== MJPEG DHT 삽입 벤치마크 (합성 프레임 %d 종, 프레임당 %d 회) ===\n", SAMPLE_COUNT, BENCH_ITERS);
+    for(i = 0; i < SAMPLE_COUNT; i++)
+        failures += check_sample(&corpus[i], tmp, tmp_size);
+    failures += check_rejects(&corpus[1]);
+
+    // 기존 고정 오프셋은 SOF0 가 0xaf 인 프레임에서만 맞다
+    legacy_fixed(tmp, corpus[0].frame.buf, corpus[0].frame.len);
+    k = MjpegDhtIovec(corpus[0].frame.buf, corpus[0].frame.len, dht, DHT_LEN, iov, NULL);
+    if(k != 3 || memcmp(tmp + HEADERFRAME1 + DHT_LEN, iov[2].iov_base, iov[2].iov_len) != 0)
+        failures++;
+    legacy_fixed(tmp, corpus[1].frame.buf, corpus[1].frame.len);
+    printf("기존 고정 0xaf 삽입: legacy-0xaf 는 같음, avi1 은 %s\n",
+           MjpegParse(tmp, corpus[1].frame.len + DHT_LEN, &info) == 0 && info.has_dht ?
+           "우연히 유효" : "세그먼트 중간에 끼워져 깨짐");
+
+    printf("프레임당 시간 (ns):      %10s %10s %10s\n", "고정 memcpy", "바이트 검색", "iovec");
+    for(i = 0; i < SAMPLE_COUNT; i++)
+    {
+        const SAMPLE *s = &corpus[i];
+
+        t0 = now_ns();
+        for(k = 0; k < BENCH_ITERS; k++)
+            sink += legacy_fixed(tmp, s->frame.buf, s->frame.len);
+        t_fixed = now_ns() - t0;
+        t0 = now_ns();
+        for(k = 0; k < BENCH_ITERS; k++)
+            sink += legacy_scan(tmp, s->frame.buf, s->frame.len);
+        t_scan = now_ns() - t0;
+        t0 = now_ns();
+        for(k = 0; k < BENCH_ITERS; k++)
+            sink += (unsigned int)MjpegDhtIovec(s->frame.buf, s->frame.len, dht, DHT_LEN, iov, NULL);
+        t_iov = now_ns() - t0;
+        printf("  %-12s %7u B  %10.0f %10.0f %10.0f  (%.0fx)\n", s->name, s->frame.len,
+               (double)t_fixed / BENCH_ITERS, (double)t_scan / BENCH_ITERS, (double)t_iov / BENCH_ITERS,
+               t_iov ? (double)t_fixed / t_iov : 0.0);
+    }
+
+    for(i = 0; i < SAMPLE_COUNT; i++)
+        free(corpus[i].frame.buf);
+    free(tmp);
+    printf("검증: %s\n", failures ? "실패" : "iovec 결과가 정답과 일치, 페이로드 복사 없음");
+    return failures ? 1 : 0;
+}
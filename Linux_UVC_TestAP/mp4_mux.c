@@ -0,0 +1,689 @@
+//----------------------------------------------//
+//	H.264 fragmented MP4 muxer					//
+//----------------------------------------------//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "nalu.h"
+#include "mp4_mux.h"
+
+#define MP4_BOX_DEPTH       8
+#define MP4_TRACK_ID        1
+#define MP4_OUT_ALIGN       4096
+#define MP4_DEFAULT_DUR     (MP4_MUX_TIMESCALE / 30)
+
+// trun sample_flags
+#define MP4_SAMPLE_SYNC     0x02000000  // sample_depends_on = 2 (다른 샘플 참조 없음)
+#define MP4_SAMPLE_NONSYNC  0x01010000  // sample_depends_on = 1, sample_is_non_sync_sample
+
+// 박스를 조립하는 가변 버퍼 (크기는 box_end 에서 채운다)
+typedef struct
+{
+    unsigned char *p;
+    unsigned int len;
+    unsigned int cap;
+    unsigned int stack[MP4_BOX_DEPTH];
+    int depth;
+    int error;
+} MP4_BUF;
+
+struct MP4_MUX
+{
+    int fd;
+    FW_STREAM *stream;              // 비동기 writer 로 쓸 때 (fd, out 은 쓰지 않음)
+
+    // 파일 출력 버퍼 (정렬, 가득 차면 write)
+    unsigned char *out;
+    unsigned int out_size;
+    unsigned int out_len;
+
+    // 현재 프래그먼트의 mdat 페이로드와 샘플 표
+    MP4_BUF frag;
+    unsigned int sample_size[MP4_MUX_MAX_SAMPLES];
+    unsigned int sample_flags[MP4_MUX_MAX_SAMPLES];
+    unsigned long long sample_dts[MP4_MUX_MAX_SAMPLES];
+    unsigned int nsamples;
+
+    // avcC 에 넣을 파라미터 셋
+    unsigned char sps[H264_PS_RAW_MAX];
+    unsigned int sps_len;
+    unsigned char pps[H264_PS_RAW_MAX];
+    unsigned int pps_len;
+    int header_written;
+    int ps_changed_warned;
+    int failed;                     // write 실패 후에는 더 쓰지 않는다
+
+    struct timeval ts0;
+    int has_ts0;
+    unsigned long long last_dts;
+    unsigned int last_duration;
+    unsigned int sequence;          // mfhd sequence_number
+
+    MP4_BUF box;                    // moov / moof 조립용
+    MP4_MUX_STATS stats;
+};
+
+// ===== 바이트 / 박스 쓰기 =====
+
+static int buf_reserve(MP4_BUF *b, unsigned int n)
+{
+    unsigned char *p;
+    unsigned int cap;
+
+    if(b->len + n <= b->cap)
+        return 0;
+    cap = b->cap ? b->cap : 4096;
+    while(cap < b->len + n)
+        cap *= 2;
+    p = (unsigned char *)realloc(b->p, cap);
+    if(!p)
+    {
+        b->error = 1;
+        return -1;
+    }
+    b->p = p;
+    b->cap = cap;
+    return 0;
+}
+
+static void put_bytes(MP4_BUF *b, const void *data, unsigned int n)
+{
+    if(buf_reserve(b, n) < 0)
+        return;
+    memcpy(b->p + b->len, data, n);
+    b->len += n;
+}
+
+static void put_zero(MP4_BUF *b, unsigned int n)
+{
+    if(buf_reserve(b, n) < 0)
+        return;
+    memset(b->p + b->len, 0, n);
+    b->len += n;
+}
+
+static void put_u8(MP4_BUF *b, unsigned int v)
+{
+    unsigned char c = (unsigned char)v;
+    put_bytes(b, &c, 1);
+}
+
+static void put_u16(MP4_BUF *b, unsigned int v)
+{
+    unsigned char c[2] = { (unsigned char)(v >> 8), (unsigned char)v };
+    put_bytes(b, c, 2);
+}
+
+static void put_u32(MP4_BUF *b, unsigned int v)
+{
+    unsigned char c[4] = { (unsigned char)(v >> 24), (unsigned char)(v >> 16),
+                           (unsigned char)(v >> 8), (unsigned char)v };
+    put_bytes(b, c, 4);
+}
+
+static void put_u64(MP4_BUF *b, unsigned long long v)
+{
+    put_u32(b, (unsigned int)(v >> 32));
+    put_u32(b, (unsigned int)v);
+}
+
+static void patch_u32(MP4_BUF *b, unsigned int pos, unsigned int v)
+{
+    if(b->error || pos + 4 > b->len)
+        return;
+    b->p[pos] = (unsigned char)(v >> 24);
+    b->p[pos + 1] = (unsigned char)(v >> 16);
+    b->p[pos + 2] = (unsigned char)(v >> 8);
+    b->p[pos + 3] = (unsigned char)v;
+}
+
+static void box_begin(MP4_BUF *b, const char *type)
+{
+    if(b->depth >= MP4_BOX_DEPTH)
+    {
+        b->error = 1;
+        return;
+    }
+    b->stack[b->depth++] = b->len;
+    put_u32(b, 0);
+    put_bytes(b, type, 4);
+}
+
+// FullBox: version(8) + flags(24)
+static void fullbox_begin(MP4_BUF *b, const char *type, unsigned int version, unsigned int flags)
+{
+    box_begin(b, type);
+    put_u32(b, (version << 24) | (flags & 0xFFFFFF));
+}
+
+static void box_end(MP4_BUF *b)
+{
+    unsigned int start;
+
+    if(b->depth <= 0)
+    {
+        b->error = 1;
+        return;
+    }
+    start = b->stack[--b->depth];
+    patch_u32(b, start, b->len - start);
+}
+
+static void put_matrix(MP4_BUF *b)
+{
+    static const unsigned int unity[9] = { 0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000 };
+    int i;
+
+    for(i = 0; i < 9; i++)
+        put_u32(b, unity[i]);
+}
+
+// ===== 파일 출력 =====
+
+static int out_flush(MP4_MUX *mux)
+{
+    unsigned int done = 0;
+
+    if(mux->stream)
+        return 0;
+
+    while(done < mux->out_len)
+    {
+        ssize_t n = write(mux->fd, mux->out + done, mux->out_len - done);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            printf("MP4 mux: write 실패: %s\n", strerror(errno));
+            mux->failed = 1;
+            return -1;
+        }
+        mux->stats.write_calls++;
+        done += (unsigned int)n;
+    }
+    mux->stats.bytes += mux->out_len;
+    mux->out_len = 0;
+    return 0;
+}
+
+static int out_append(MP4_MUX *mux, const unsigned char *data, unsigned int len)
+{
+    if(mux->stream)
+    {
+        // writer 가 청크 단위로 모아서 쓴다
+        if(FrameWriterStreamWrite(mux->stream, data, len) < 0)
+        {
+            mux->failed = 1;
+            return -1;
+        }
+        mux->stats.bytes += len;
+        return 0;
+    }
+    while(len > 0)
+    {
+        unsigned int room = mux->out_size - mux->out_len;
+        unsigned int n = len < room ? len : room;
+
+        memcpy(mux->out + mux->out_len, data, n);
+        mux->out_len += n;
+        data += n;
+        len -= n;
+        if(mux->out_len == mux->out_size && out_flush(mux) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+// ===== 박스 =====
+
+static void write_avcc(MP4_MUX *mux, MP4_BUF *b, const H264_SPS *sps)
+{
+    box_begin(b, "avcC");
+    put_u8(b, 1);                           // configurationVersion
+    put_u8(b, mux->sps[1]);                 // AVCProfileIndication
+    put_u8(b, mux->sps[2]);                 // profile_compatibility
+    put_u8(b, mux->sps[3]);                 // AVCLevelIndication
+    put_u8(b, 0xFC | 3);                    // lengthSizeMinusOne = 3
+    put_u8(b, 0xE0 | 1);                    // numOfSequenceParameterSets
+    put_u16(b, mux->sps_len);
+    put_bytes(b, mux->sps, mux->sps_len);
+    put_u8(b, 1);                           // numOfPictureParameterSets
+    put_u16(b, mux->pps_len);
+    put_bytes(b, mux->pps, mux->pps_len);
+    if(sps->profile_idc == 100 || sps->profile_idc == 110 ||
+       sps->profile_idc == 122 || sps->profile_idc == 144)
+    {
+        put_u8(b, 0xFC | sps->chroma_format_idc);
+        put_u8(b, 0xF8 | (sps->bit_depth_luma - 8));
+        put_u8(b, 0xF8 | (sps->bit_depth_chroma - 8));
+        put_u8(b, 0);                       // numOfSequenceParameterSetExt
+    }
+    box_end(b);
+}
+
+static int write_header(MP4_MUX *mux)
+{
+    MP4_BUF *b = &mux->box;
+    H264_SPS sps;
+    static const char compressor[32] = "\x04" "H264";
+
+    if(H264ParseSps(mux->sps, mux->sps_len, &sps) < 0)
+    {
+        printf("MP4 mux: SPS 파싱 실패\n");
+        return -1;
+    }
+
+    b->len = 0;
+    b->depth = 0;
+
+    box_begin(b, "ftyp");
+    put_bytes(b, "isom", 4);
+    put_u32(b, 0x200);
+    put_bytes(b, "isomiso6avc1mp41", 16);
+    box_end(b);
+
+    box_begin(b, "moov");
+
+    fullbox_begin(b, "mvhd", 0, 0);
+    put_u32(b, 0);                          // creation_time
+    put_u32(b, 0);                          // modification_time
+    put_u32(b, 1000);                       // timescale
+    put_u32(b, 0);                          // duration (프래그먼트에서 결정)
+    put_u32(b, 0x00010000);                 // rate 1.0
+    put_u16(b, 0x0100);                     // volume 1.0
+    put_zero(b, 10);
+    put_matrix(b);
+    put_zero(b, 24);                        // pre_defined
+    put_u32(b, MP4_TRACK_ID + 1);           // next_track_ID
+    box_end(b);
+
+    box_begin(b, "trak");
+    fullbox_begin(b, "tkhd", 0, 0x000003); // enabled | in_movie
+    put_u32(b, 0);
+    put_u32(b, 0);
+    put_u32(b, MP4_TRACK_ID);
+    put_u32(b, 0);                          // reserved
+    put_u32(b, 0);                          // duration
+    put_zero(b, 8);
+    put_u16(b, 0);                          // layer
+    put_u16(b, 0);                          // alternate_group
+    put_u16(b, 0);                          // volume
+    put_u16(b, 0);
+    put_matrix(b);
+    put_u32(b, (unsigned int)sps.width << 16);
+    put_u32(b, (unsigned int)sps.height << 16);
+    box_end(b);
+
+    box_begin(b, "mdia");
+    fullbox_begin(b, "mdhd", 0, 0);
+    put_u32(b, 0);
+    put_u32(b, 0);
+    put_u32(b, MP4_MUX_TIMESCALE);
+    put_u32(b, 0);
+    put_u16(b, 0x55C4);                     // language "und"
+    put_u16(b, 0);
+    box_end(b);
+
+    fullbox_begin(b, "hdlr", 0, 0);
+    put_u32(b, 0);
+    put_bytes(b, "vide", 4);
+    put_zero(b, 12);
+    put_bytes(b, "VideoHandler", 13);
+    box_end(b);
+
+    box_begin(b, "minf");
+    fullbox_begin(b, "vmhd", 0, 1);
+    put_zero(b, 8);                         // graphicsmode, opcolor
+    box_end(b);
+
+    box_begin(b, "dinf");
+    fullbox_begin(b, "dref", 0, 0);
+    put_u32(b, 1);
+    fullbox_begin(b, "url ", 0, 1);         // 같은 파일
+    box_end(b);
+    box_end(b);
+    box_end(b);
+
+    box_begin(b, "stbl");
+    fullbox_begin(b, "stsd", 0, 0);
+    put_u32(b, 1);
+    box_begin(b, "avc1");
+    put_zero(b, 6);
+    put_u16(b, 1);                          // data_reference_index
+    put_zero(b, 16);                        // pre_defined, reserved
+    put_u16(b, (unsigned int)sps.width);
+    put_u16(b, (unsigned int)sps.height);
+    put_u32(b, 0x00480000);                 // 72 dpi
+    put_u32(b, 0x00480000);
+    put_u32(b, 0);
+    put_u16(b, 1);                          // frame_count
+    put_bytes(b, compressor, 32);
+    put_u16(b, 0x0018);                     // depth
+    put_u16(b, 0xFFFF);                     // pre_defined = -1
+    write_avcc(mux, b, &sps);
+    box_end(b);                             // avc1
+    box_end(b);                             // stsd
+
+    // 샘플 표는 비어 있고 모든 샘플은 프래그먼트에 있다
+    fullbox_begin(b, "stts", 0, 0);
+    put_u32(b, 0);
+    box_end(b);
+    fullbox_begin(b, "stsc", 0, 0);
+    put_u32(b, 0);
+    box_end(b);
+    fullbox_begin(b, "stsz", 0, 0);
+    put_u32(b, 0);
+    put_u32(b, 0);
+    box_end(b);
+    fullbox_begin(b, "stco", 0, 0);
+    put_u32(b, 0);
+    box_end(b);
+    box_end(b);                             // stbl
+    box_end(b);                             // minf
+    box_end(b);                             // mdia
+    box_end(b);                             // trak
+
+    box_begin(b, "mvex");
+    fullbox_begin(b, "trex", 0, 0);
+    put_u32(b, MP4_TRACK_ID);
+    put_u32(b, 1);                          // default_sample_description_index
+    put_u32(b, 0);
+    put_u32(b, 0);
+    put_u32(b, 0);
+    box_end(b);
+    box_end(b);
+
+    box_end(b);                             // moov
+
+    if(b->error || b->depth != 0)
+        return -1;
+    if(out_append(mux, b->p, b->len) < 0)
+        return -1;
+
+    printf("MP4 mux: %dx%d, profile %u level %u\n", sps.width, sps.height,
+           sps.profile_idc, sps.level_idc);
+    mux->header_written = 1;
+    return 0;
+}
+
+// 모인 샘플로 moof + mdat 를 쓴다. next_dts 는 다음 샘플의 DTS (없으면 0)
+static int flush_fragment(MP4_MUX *mux, unsigned long long next_dts, int has_next)
+{
+    MP4_BUF *b = &mux->box;
+    unsigned int data_offset_pos, i;
+
+    if(mux->nsamples == 0)
+        return 0;
+
+    b->len = 0;
+    b->depth = 0;
+
+    box_begin(b, "moof");
+    fullbox_begin(b, "mfhd", 0, 0);
+    put_u32(b, ++mux->sequence);
+    box_end(b);
+
+    box_begin(b, "traf");
+    fullbox_begin(b, "tfhd", 0, 0x020000); // default-base-is-moof
+    put_u32(b, MP4_TRACK_ID);
+    box_end(b);
+
+    fullbox_begin(b, "tfdt", 1, 0);
+    put_u64(b, mux->sample_dts[0]);
+    box_end(b);
+
+    // data-offset | sample-duration | sample-size | sample-flags
+    fullbox_begin(b, "trun", 0, 0x000701);
+    put_u32(b, mux->nsamples);
+    data_offset_pos = b->len;
+    put_u32(b, 0);
+    for(i = 0; i < mux->nsamples; i++)
+    {
+        unsigned long long dur;
+
+        if(i + 1 < mux->nsamples)
+            dur = mux->sample_dts[i + 1] - mux->sample_dts[i];
+        else if(has_next)
+            dur = next_dts - mux->sample_dts[i];
+        else
+            dur = mux->last_duration;
+        put_u32(b, (unsigned int)dur);
+        put_u32(b, mux->sample_size[i]);
+        put_u32(b, mux->sample_flags[i]);
+    }
+    box_end(b);                             // trun
+    box_end(b);                             // traf
+    box_end(b);                             // moof
+
+    // mdat 헤더 (페이로드는 frag 버퍼에서 바로 복사)
+    patch_u32(b, data_offset_pos, b->len + 8);
+    put_u32(b, mux->frag.len + 8);
+    put_bytes(b, "mdat", 4);
+
+    if(b->error || mux->frag.error)
+        return -1;
+    if(out_append(mux, b->p, b->len) < 0 || out_append(mux, mux->frag.p, mux->frag.len) < 0)
+        return -1;
+
+    mux->stats.fragments++;
+    mux->nsamples = 0;
+    mux->frag.len = 0;
+    return 0;
+}
+
+// ===== 공개 함수 =====
+
+MP4_MUX *Mp4MuxOpen(const char *filename, unsigned int buf_size)
+{
+    MP4_MUX *mux;
+    void *out = NULL;
+
+    if(!filename)
+        return NULL;
+    if(buf_size == 0)
+        buf_size = MP4_MUX_DEFAULT_BUF_SIZE;
+    buf_size = (buf_size + MP4_OUT_ALIGN - 1) & ~(MP4_OUT_ALIGN - 1);
+
+    mux = (MP4_MUX *)calloc(1, sizeof(MP4_MUX));
+    if(!mux)
+        return NULL;
+    if(posix_memalign(&out, MP4_OUT_ALIGN, buf_size) != 0)
+    {
+        free(mux);
+        return NULL;
+    }
+    mux->out = (unsigned char *)out;
+    mux->out_size = buf_size;
+    mux->last_duration = MP4_DEFAULT_DUR;
+
+    mux->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(mux->fd < 0)
+    {
+        printf("MP4 mux: %s 열기 실패: %s\n", filename, strerror(errno));
+        free(mux->out);
+        free(mux);
+        return NULL;
+    }
+    return mux;
+}
+
+MP4_MUX *Mp4MuxOpenWriter(const char *filename, FRAME_WRITER *writer)
+{
+    MP4_MUX *mux;
+
+    if(!writer)
+        return Mp4MuxOpen(filename, 0);
+    if(!filename)
+        return NULL;
+
+    mux = (MP4_MUX *)calloc(1, sizeof(MP4_MUX));
+    if(!mux)
+        return NULL;
+    mux->fd = -1;
+    mux->last_duration = MP4_DEFAULT_DUR;
+    mux->stream = FrameWriterStreamOpen(writer, filename);
+    if(!mux->stream)
+    {
+        free(mux);
+        return NULL;
+    }
+    return mux;
+}
+
+// 저장해 둔 파라미터 셋과 같은지 (다르면 새로 저장할 수 있으면 저장)
+static int store_ps(MP4_MUX *mux, unsigned char *dst, unsigned int *dst_len,
+                    const unsigned char *nal, unsigned int len)
+{
+    if(*dst_len == len && memcmp(dst, nal, len) == 0)
+        return 1;
+    if(len > H264_PS_RAW_MAX || len < 4)
+        return 0;
+    if(mux->header_written)
+    {
+        // avcC 는 이미 썼으므로 바뀐 파라미터 셋은 샘플 안에 그대로 남긴다
+        if(!mux->ps_changed_warned)
+        {
+            printf("MP4 mux: 녹화 중 SPS/PPS 변경 (샘플 안에 유지)\n");
+            mux->ps_changed_warned = 1;
+        }
+        return 0;
+    }
+    memcpy(dst, nal, len);
+    *dst_len = len;
+    return 1;
+}
+
+int Mp4MuxWriteFrame(MP4_MUX *mux, const unsigned char *buf, unsigned int len, const struct timeval *ts)
+{
+    H264_NALU nalus[MP4_MUX_MAX_NALUS];
+    unsigned char keep[MP4_MUX_MAX_NALUS];
+    unsigned long long dts;
+    unsigned int size = 0;
+    int count, i, key = 0, has_vcl = 0;
+
+    if(!mux || !buf || mux->failed)
+        return -1;
+
+    count = H264ScanNALUs(buf, len, nalus, MP4_MUX_MAX_NALUS);
+    for(i = 0; i < count; i++)
+    {
+        const unsigned char *nal = buf + nalus[i].offset;
+        unsigned int type = nalus[i].nal_unit_type;
+
+        keep[i] = 1;
+        if(type == 9)
+            keep[i] = 0;        // AUD: MP4 에서는 쓰지 않음
+        else if(type == 7)
+            keep[i] = !store_ps(mux, mux->sps, &mux->sps_len, nal, nalus[i].size);
+        else if(type == 8)
+            keep[i] = !store_ps(mux, mux->pps, &mux->pps_len, nal, nalus[i].size);
+        else if(type >= 1 && type <= 5)
+        {
+            has_vcl = 1;
+            if(type == 5)
+                key = 1;
+        }
+    }
+    if(!has_vcl)
+        return 0;               // SPS/PPS 만 있는 버퍼
+
+    if(!mux->header_written)
+    {
+        if(!key || !mux->sps_len || !mux->pps_len)
+        {
+            mux->stats.skipped++;
+            return 0;
+        }
+        if(write_header(mux) < 0)
+            return -1;
+    }
+
+    // DTS (첫 프레임 기준 90kHz). 뒤로 가거나 같은 timestamp 는 직전 길이만큼 진행
+    if(ts && !mux->has_ts0)
+    {
+        mux->ts0 = *ts;
+        mux->has_ts0 = 1;
+    }
+    if(ts)
+    {
+        long long us = (long long)(ts->tv_sec - mux->ts0.tv_sec) * 1000000LL + (ts->tv_usec - mux->ts0.tv_usec);
+        dts = us > 0 ? (unsigned long long)us * MP4_MUX_TIMESCALE / 1000000ULL : 0;
+    }
+    else
+        dts = mux->last_dts + mux->last_duration;
+    if(mux->stats.frames > 0 && dts <= mux->last_dts)
+        dts = mux->last_dts + mux->last_duration;
+    if(mux->stats.frames > 0)
+        mux->last_duration = (unsigned int)(dts - mux->last_dts);
+
+    // IDR 에서 프래그먼트를 자른다
+    if(mux->nsamples > 0 && (key || mux->nsamples == MP4_MUX_MAX_SAMPLES))
+    {
+        if(flush_fragment(mux, dts, 1) < 0)
+            return -1;
+    }
+
+    // Annex-B → AVCC (start code 대신 4 바이트 길이)
+    for(i = 0; i < count; i++)
+    {
+        if(!keep[i])
+            continue;
+        put_u32(&mux->frag, nalus[i].size);
+        put_bytes(&mux->frag, buf + nalus[i].offset, nalus[i].size);
+        size += 4 + nalus[i].size;
+    }
+    if(mux->frag.error)
+        return -1;
+
+    mux->sample_size[mux->nsamples] = size;
+    mux->sample_flags[mux->nsamples] = key ? MP4_SAMPLE_SYNC : MP4_SAMPLE_NONSYNC;
+    mux->sample_dts[mux->nsamples] = dts;
+    mux->nsamples++;
+    mux->last_dts = dts;
+    mux->stats.frames++;
+    return 0;
+}
+
+int Mp4MuxClose(MP4_MUX *mux, MP4_MUX_STATS *stats)
+{
+    int ret = 0;
+
+    if(!mux)
+        return -1;
+
+    if(mux->failed || flush_fragment(mux, 0, 0) < 0 || out_flush(mux) < 0)
+        ret = -1;
+    if(mux->stream)
+    {
+        if(FrameWriterStreamClose(mux->stream) < 0)
+            ret = -1;
+    }
+    else if(close(mux->fd) < 0)
+    {
+        ret = -1;
+    }
+    if(stats)
+        *stats = mux->stats;
+
+    free(mux->out);
+    free(mux->frag.p);
+    free(mux->box.p);
+    free(mux);
+    return ret;
+}
+
+void Mp4MuxGetStats(const MP4_MUX *mux, MP4_MUX_STATS *stats)
+{
+    if(!stats)
+        return;
+    if(!mux)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = mux->stats;
+}
@@ -0,0 +1,55 @@
+#ifndef _MP4_MUX_H_
+#define _MP4_MUX_H_
+
+#include <sys/time.h>
+#include "frame_writer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// H.264 Annex-B → fragmented MP4 (ISO-BMFF) 스트리밍 muxer
+// - ftyp + moov(avcC 는 스트림의 SPS/PPS) 를 첫 IDR 에서 쓰고, 이후 IDR 마다 moof + mdat 프래그먼트
+// - NAL 은 4 바이트 길이 접두(AVCC)로 변환, AUD 와 avcC 에 들어간 SPS/PPS 는 샘플에서 뺀다
+// - 타임스탬프는 V4L2 버퍼 timestamp (90kHz), 샘플 길이는 다음 프레임과의 차이
+// - 출력은 큰 정렬 버퍼에 모아서 write() 하므로 프레임마다 시스템 콜이 생기지 않는다
+// 녹화 도중 종료돼도 마지막으로 완성된 프래그먼트까지는 재생 가능하다.
+
+#define MP4_MUX_DEFAULT_BUF_SIZE    (1 << 20)   // 출력 버퍼 (4KB 정렬)
+#define MP4_MUX_TIMESCALE           90000
+#define MP4_MUX_MAX_SAMPLES         1024        // 프래그먼트당 최대 샘플 (넘으면 IDR 전이라도 자른다)
+#define MP4_MUX_MAX_NALUS           64          // 프레임당 최대 NAL 수
+
+typedef struct
+{
+    unsigned long frames;           // 기록한 샘플 수
+    unsigned long skipped;          // 첫 IDR(SPS/PPS) 전이라 버린 프레임
+    unsigned long fragments;
+    unsigned long write_calls;      // write() 호출 수
+    unsigned long long bytes;       // 파일에 쓴 바이트
+} MP4_MUX_STATS;
+
+typedef struct MP4_MUX MP4_MUX;
+
+// buf_size 가 0 이면 MP4_MUX_DEFAULT_BUF_SIZE. 실패 시 NULL
+MP4_MUX *Mp4MuxOpen(const char *filename, unsigned int buf_size);
+
+// 비동기 writer 스트림으로 쓴다 (캡처 스레드에서 디스크 쓰기가 빠짐). writer 가 NULL 이면 Mp4MuxOpen
+// 이 경우 stats.write_calls 는 0 이고 실제 쓰기 통계는 FrameWriterGetStats 로 본다
+MP4_MUX *Mp4MuxOpenWriter(const char *filename, FRAME_WRITER *writer);
+
+// Annex-B 프레임(액세스 유닛) 하나. ts 가 NULL 이면 직전 샘플 길이만큼 진행
+// 성공(첫 IDR 전이라 버린 경우 포함) 시 0, 쓰기 실패 시 -1
+int Mp4MuxWriteFrame(MP4_MUX *mux, const unsigned char *buf, unsigned int len, const struct timeval *ts);
+
+// 남은 프래그먼트와 버퍼를 쓰고 파일을 닫는다. mux 는 해제된다
+// stats 가 NULL 이 아니면 닫은 뒤의 최종 통계를 채운다
+int Mp4MuxClose(MP4_MUX *mux, MP4_MUX_STATS *stats);
+
+void Mp4MuxGetStats(const MP4_MUX *mux, MP4_MUX_STATS *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
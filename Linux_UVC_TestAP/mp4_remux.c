@@ -0,0 +1,704 @@
+//----------------------------------------------//
+//	H.264 Annex-B → fMP4 리먹스 / 검증			//
+//----------------------------------------------//
+// 사용법: ./mp4_remux [in.h264] [out.mp4] [fps]
+// 녹화된 .h264 파일을 액세스 유닛으로 나눠 녹화 경로와 같은 Mp4Mux 로 다시 쓴다.
+// 입력을 주지 않으면 I_PCM IDR + P_Skip 프레임으로 된 합성 스트림(디코드 가능)을 만든다.
+// 쓴 파일을 다시 읽어 박스 구조, 프래그먼트(IDR 로 시작, tfdt 연속),
+// AVCC 샘플이 입력 NAL 과 바이트 단위로 같은지 확인하고 불일치가 있으면 1 을 반환한다.
+// 같은 입력을 직접 write() 경로와 비동기 frame writer 경로로 한 번씩 쓰고 둘 다 검증한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "nalu.h"
+#include "mp4_mux.h"
+
+#define MAX_NALUS       (1 << 20)
+#define MAX_AUS         (1 << 18)
+
+// ===== 합성 H.264 스트림 =====
+
+#define SYN_WIDTH       64
+#define SYN_HEIGHT      48
+#define SYN_FRAMES      300
+#define SYN_GOP         30
+
+typedef struct
+{
+    unsigned char *buf;
+    unsigned int len;
+    unsigned int cap;
+    unsigned int acc;           // 아직 내보내지 않은 비트
+    int nbits;
+    int zeros;                  // emulation prevention 용 연속 0 바이트
+} BIT_WRITER;
+
+static void bw_reserve(BIT_WRITER *bw, unsigned int n)
+{
+    if(bw->len + n > bw->cap)
+    {
+        bw->cap = bw->cap ? bw->cap * 2 : 65536;
+        bw->buf = (unsigned char *)realloc(bw->buf, bw->cap);
+        if(!bw->buf)
+            exit(2);
+    }
+}
+
+static void bw_byte(BIT_WRITER *bw, unsigned char c)
+{
+    bw_reserve(bw, 2);
+    if(bw->zeros >= 2 && c <= 3)
+    {
+        bw->buf[bw->len++] = 3;
+        bw->zeros = 0;
+    }
+    bw->buf[bw->len++] = c;
+    bw->zeros = c ? 0 : bw->zeros + 1;
+}
+
+static void bw_bits(BIT_WRITER *bw, unsigned int v, int n)
+{
+    while(n-- > 0)
+    {
+        bw->acc = (bw->acc << 1) | ((v >> n) & 1);
+        if(++bw->nbits == 8)
+        {
+            bw_byte(bw, (unsigned char)bw->acc);
+            bw->acc = 0;
+            bw->nbits = 0;
+        }
+    }
+}
+
+static void bw_ue(BIT_WRITER *bw, unsigned int v)
+{
+    unsigned int x = v + 1;
+    int len = 0;
+
+    while((x >> len) > 1)
+        len++;
+    bw_bits(bw, 0, len);
+    bw_bits(bw, x, len + 1);
+}
+
+static void bw_align_zero(BIT_WRITER *bw)
+{
+    if(bw->nbits)
+        bw_bits(bw, 0, 8 - bw->nbits);
+}
+
+static void bw_trailing(BIT_WRITER *bw)
+{
+    bw_bits(bw, 1, 1);
+    bw_align_zero(bw);
+}
+
+// start code + NAL 헤더 (emulation prevention 없이 그대로)
+static void bw_nal_start(BIT_WRITER *bw, unsigned int ref_idc, unsigned int type, int long_sc)
+{
+    static const unsigned char sc[4] = { 0, 0, 0, 1 };
+    int i;
+
+    bw_reserve(bw, 5);
+    for(i = long_sc ? 0 : 1; i < 4; i++)
+        bw->buf[bw->len++] = sc[i];
+    bw->buf[bw->len++] = (unsigned char)((ref_idc << 5) | type);
+    bw->zeros = 0;
+}
+
+static void syn_sps_pps(BIT_WRITER *bw)
+{
+    bw_nal_start(bw, 3, 7, 1);
+    bw_bits(bw, 66, 8);                     // Baseline
+    bw_bits(bw, 0xC0, 8);                   // constraint_set0/1
+    bw_bits(bw, 30, 8);                     // level 3.0
+    bw_ue(bw, 0);                           // seq_parameter_set_id
+    bw_ue(bw, 0);                           // log2_max_frame_num_minus4
+    bw_ue(bw, 2);                           // pic_order_cnt_type
+    bw_ue(bw, 1);                           // max_num_ref_frames
+    bw_bits(bw, 0, 1);                      // gaps_in_frame_num_value_allowed_flag
+    bw_ue(bw, SYN_WIDTH / 16 - 1);
+    bw_ue(bw, SYN_HEIGHT / 16 - 1);
+    bw_bits(bw, 1, 1);                      // frame_mbs_only_flag
+    bw_bits(bw, 1, 1);                      // direct_8x8_inference_flag
+    bw_bits(bw, 0, 1);                      // frame_cropping_flag
+    bw_bits(bw, 0, 1);                      // vui_parameters_present_flag
+    bw_trailing(bw);
+
+    bw_nal_start(bw, 3, 8, 1);
+    bw_ue(bw, 0);                           // pic_parameter_set_id
+    bw_ue(bw, 0);                           // seq_parameter_set_id
+    bw_bits(bw, 0, 1);                      // entropy_coding_mode_flag (CAVLC)
+    bw_bits(bw, 0, 1);                      // bottom_field_pic_order_in_frame_present_flag
+    bw_ue(bw, 0);                           // num_slice_groups_minus1
+    bw_ue(bw, 0);                           // num_ref_idx_l0_default_active_minus1
+    bw_ue(bw, 0);                           // num_ref_idx_l1_default_active_minus1
+    bw_bits(bw, 0, 1);                      // weighted_pred_flag
+    bw_bits(bw, 0, 2);                      // weighted_bipred_idc
+    bw_ue(bw, 0);                           // pic_init_qp_minus26 (se(0) == ue(0))
+    bw_ue(bw, 0);                           // pic_init_qs_minus26
+    bw_ue(bw, 0);                           // chroma_qp_index_offset
+    bw_bits(bw, 1, 1);                      // deblocking_filter_control_present_flag
+    bw_bits(bw, 0, 1);                      // constrained_intra_pred_flag
+    bw_bits(bw, 0, 1);                      // redundant_pic_cnt_present_flag
+    bw_trailing(bw);
+}
+
+// 모든 매크로블록이 I_PCM 인 IDR
+static void syn_idr(BIT_WRITER *bw, unsigned int idr_pic_id, unsigned int frame)
+{
+    int mb, i, mbs = (SYN_WIDTH / 16) * (SYN_HEIGHT / 16);
+
+    bw_nal_start(bw, 3, 5, 0);
+    bw_ue(bw, 0);                           // first_mb_in_slice
+    bw_ue(bw, 7);                           // slice_type: I (all)
+    bw_ue(bw, 0);                           // pic_parameter_set_id
+    bw_bits(bw, 0, 4);                      // frame_num
+    bw_ue(bw, idr_pic_id);
+    bw_bits(bw, 0, 1);                      // no_output_of_prior_pics_flag
+    bw_bits(bw, 0, 1);                      // long_term_reference_flag
+    bw_ue(bw, 0);                           // slice_qp_delta (se)
+    bw_ue(bw, 1);                           // disable_deblocking_filter_idc
+    for(mb = 0; mb < mbs; mb++)
+    {
+        bw_ue(bw, 25);                      // mb_type: I_PCM
+        bw_align_zero(bw);
+        for(i = 0; i < 256; i++)
+            bw_bits(bw, 16 + ((i * 7 + mb * 13 + frame * 5) % 220), 8);
+        for(i = 0; i < 128; i++)
+            bw_bits(bw, 128 + ((i + frame) % 32) - 16, 8);
+    }
+    bw_trailing(bw);
+}
+
+// 모든 매크로블록을 건너뛰는 P 프레임
+static void syn_p(BIT_WRITER *bw, unsigned int frame_num, int long_sc)
+{
+    bw_nal_start(bw, 2, 1, long_sc);
+    bw_ue(bw, 0);                           // first_mb_in_slice
+    bw_ue(bw, 5);                           // slice_type: P (all)
+    bw_ue(bw, 0);
+    bw_bits(bw, frame_num & 15, 4);
+    bw_bits(bw, 0, 1);                      // num_ref_idx_active_override_flag
+    bw_bits(bw, 0, 1);                      // ref_pic_list_modification_flag_l0
+    bw_bits(bw, 0, 1);                      // adaptive_ref_pic_marking_mode_flag
+    bw_ue(bw, 0);                           // slice_qp_delta
+    bw_ue(bw, 1);                           // disable_deblocking_filter_idc
+    bw_ue(bw, (SYN_WIDTH / 16) * (SYN_HEIGHT / 16));    // mb_skip_run
+    bw_trailing(bw);
+}
+
+// IDR 전 P 프레임 1개(버려져야 함) + GOP 마다 SPS/PPS/IDR, 짝수 프레임에 AUD
+static unsigned char *synth_stream(unsigned int *len)
+{
+    BIT_WRITER bw;
+    unsigned int f, frame_num = 0, idr_id = 0;
+
+    memset(&bw, 0, sizeof(bw));
+    syn_p(&bw, 3, 1);
+    for(f = 0; f < SYN_FRAMES; f++)
+    {
+        if((f & 1) == 0)
+        {
+            bw_nal_start(&bw, 0, 9, 1);
+            bw_bits(&bw, 7, 3);             // primary_pic_type
+            bw_trailing(&bw);
+        }
+        if(f % SYN_GOP == 0)
+        {
+            syn_sps_pps(&bw);
+            syn_idr(&bw, idr_id++ & 0xFFFF, f);
+            frame_num = 1;
+        }
+        else
+        {
+            syn_p(&bw, frame_num++, (f & 1) == 0);
+        }
+    }
+    *len = bw.len;
+    return bw.buf;
+}
+
+// ===== 액세스 유닛 분할 =====
+
+typedef struct
+{
+    unsigned int start;         // 첫 NAL 의 start code 오프셋
+    unsigned int end;
+} AU_RANGE;
+
+static int is_vcl(unsigned int type)
+{
+    return type >= 1 && type <= 5;
+}
+
+static int first_mb_is_zero(const unsigned char *nal, unsigned int len)
+{
+    H264_BITREADER br;
+
+    if(len < 2)
+        return 1;
+    H264BitReaderInit(&br, nal + 1, len - 1);
+    return H264ReadUe(&br) == 0;
+}
+
+// AUD, VCL 뒤의 SPS/PPS/SEI, 또는 first_mb_in_slice == 0 인 새 슬라이스에서 새 AU 시작
+static int split_access_units(const unsigned char *buf, unsigned int len, const H264_NALU *nalus, int count,
+                              AU_RANGE *aus, int max_aus)
+{
+    int i, n = 0, vcl_seen = 0;
+
+    for(i = 0; i < count; i++)
+    {
+        unsigned int type = nalus[i].nal_unit_type;
+        unsigned int sc = nalus[i].offset - nalus[i].start_code_len;
+        int boundary;
+
+        if(type == 9 || ((type == 6 || type == 7 || type == 8) && vcl_seen))
+            boundary = 1;
+        else if(is_vcl(type) && vcl_seen)
+            boundary = first_mb_is_zero(buf + nalus[i].offset, nalus[i].size);
+        else
+            boundary = (n == 0);
+
+        if(boundary)
+        {
+            if(n == max_aus)
+                break;
+            if(n > 0)
+                aus[n - 1].end = sc;
+            aus[n].start = sc;
+            n++;
+            vcl_seen = 0;
+        }
+        if(is_vcl(type))
+            vcl_seen = 1;
+    }
+    if(n > 0)
+        aus[n - 1].end = len;
+    return n;
+}
+
+// ===== 검증 =====
+
+static unsigned int rd32(const unsigned char *p)
+{
+    return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3];
+}
+
+static unsigned long long rd64(const unsigned char *p)
+{
+    return ((unsigned long long)rd32(p) << 32) | rd32(p + 4);
+}
+
+// [p, end) 안에서 type 박스를 찾는다 (없으면 NULL, *size 에 박스 전체 크기)
+static const unsigned char *find_box(const unsigned char *p, const unsigned char *end,
+                                     const char *type, unsigned int *size)
+{
+    while(p + 8 <= end)
+    {
+        unsigned int sz = rd32(p);
+        if(sz < 8 || p + sz > end)
+            return NULL;
+        if(memcmp(p + 4, type, 4) == 0)
+        {
+            *size = sz;
+            return p;
+        }
+        p += sz;
+    }
+    return NULL;
+}
+
+// 경로를 따라 내려간다 ("moov/trak/mdia")
+static const unsigned char *find_path(const unsigned char *p, const unsigned char *end,
+                                      const char *path, unsigned int *size)
+{
+    const unsigned char *box = NULL;
+    char type[5];
+
+    while(*path)
+    {
+        memcpy(type, path, 4);
+        type[4] = 0;
+        box = find_box(p, end, type, size);
+        if(!box)
+            return NULL;
+        end = box + *size;
+        p = box + 8;
+        path += 4;
+        if(*path == '/')
+            path++;
+    }
+    return box;
+}
+
+// 기대 NAL: 첫 IDR(SPS/PPS 확보) 이후 AU 에서 AUD 와 avcC 와 같은 SPS/PPS 를 뺀 것
+typedef struct
+{
+    const unsigned char *sps, *pps;
+    unsigned int sps_len, pps_len;
+} AVCC_PS;
+
+static int expected_nal(const unsigned char *nal, const H264_NALU *n, const AVCC_PS *ps)
+{
+    if(n->nal_unit_type == 9)
+        return 0;
+    if(n->nal_unit_type == 7 && n->size == ps->sps_len && memcmp(nal, ps->sps, n->size) == 0)
+        return 0;
+    if(n->nal_unit_type == 8 && n->size == ps->pps_len && memcmp(nal, ps->pps, n->size) == 0)
+        return 0;
+    return 1;
+}
+
+static int verify_file(const char *path, const unsigned char *in, const H264_NALU *nalus, int nal_count,
+                       const AU_RANGE *aus, int au_count, unsigned int fps)
+{
+    FILE *fp = fopen(path, "rb");
+    unsigned char *file;
+    const unsigned char *end, *p, *box;
+    unsigned int size, fsize, seq = 0, frag = 0;
+    unsigned long long next_dts = 0;
+    AVCC_PS ps;
+    int au = 0, nal_idx = 0, failures = 0, have_sps = 0, have_pps = 0;
+
+    if(!fp)
+        return 1;
+    fseek(fp, 0, SEEK_END);
+    fsize = (unsigned int)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    file = (unsigned char *)malloc(fsize ? fsize : 1);
+    if(!file || fread(file, 1, fsize, fp) != fsize)
+    {
+        fclose(fp);
+        free(file);
+        return 1;
+    }
+    fclose(fp);
+    end = file + fsize;
+
+    if(fsize < 8 || memcmp(file + 4, "ftyp", 4) != 0)
+    {
+        printf("불일치: ftyp 로 시작하지 않음\n");
+        free(file);
+        return 1;
+    }
+
+    // avcC
+    box = find_path(file, end, "moov/trak/mdia/minf/stbl/stsd", &size);
+    if(!box || size < 16 + 86)
+    {
+        printf("불일치: stsd 없음\n");
+        free(file);
+        return 1;
+    }
+    box = find_box(box + 16 + 86, box + size, "avcC", &size);
+    if(!box || box[8] != 1 || (box[12] & 3) != 3)
+    {
+        printf("불일치: avcC 없음 또는 lengthSize != 4\n");
+        free(file);
+        return 1;
+    }
+    ps.sps_len = (box[14] << 8) | box[15];
+    ps.sps = box + 16;
+    ps.pps_len = (ps.sps + ps.sps_len)[1] << 8 | (ps.sps + ps.sps_len)[2];
+    ps.pps = ps.sps + ps.sps_len + 3;
+
+    // 기대 시작점: SPS/PPS 를 본 뒤 처음 IDR 을 가진 AU
+    for(au = 0; au < au_count; au++)
+    {
+        int idr = 0;
+        for(; nal_idx < nal_count && nalus[nal_idx].offset < aus[au].end; nal_idx++)
+        {
+            if(nalus[nal_idx].nal_unit_type == 7) have_sps = 1;
+            if(nalus[nal_idx].nal_unit_type == 8) have_pps = 1;
+            if(nalus[nal_idx].nal_unit_type == 5) idr = 1;
+        }
+        if(idr && have_sps && have_pps)
+            break;
+    }
+    // 이 AU 의 첫 NAL 로 되돌림
+    while(nal_idx > 0 && nalus[nal_idx - 1].offset >= aus[au].start)
+        nal_idx--;
+
+    // 프래그먼트 순회
+    p = file;
+    while(p + 8 <= end && failures < 10)
+    {
+        const unsigned char *moof, *traf, *tfdt, *trun, *mdat, *data;
+        unsigned int moof_size, traf_size, tfdt_size, trun_size, mdat_size, n, i, off;
+        unsigned long long base, dur_sum = 0;
+
+        size = rd32(p);
+        if(size < 8 || p + size > end)
+        {
+            printf("불일치: 잘린 박스\n");
+            failures++;
+            break;
+        }
+        if(memcmp(p + 4, "moof", 4) != 0)
+        {
+            p += size;
+            continue;
+        }
+        moof = p;
+        moof_size = size;
+        mdat = moof + moof_size;
+        if(mdat + 8 > end || memcmp(mdat + 4, "mdat", 4) != 0)
+        {
+            printf("불일치: moof 뒤에 mdat 없음\n");
+            failures++;
+            break;
+        }
+        mdat_size = rd32(mdat);
+
+        box = find_path(moof + 8, moof + moof_size, "mfhd", &size);
+        if(!box || rd32(box + 12) != ++seq)
+        {
+            printf("불일치: mfhd sequence\n");
+            failures++;
+        }
+        traf = find_box(moof + 8, moof + moof_size, "traf", &traf_size);
+        tfdt = traf ? find_box(traf + 8, traf + traf_size, "tfdt", &tfdt_size) : NULL;
+        trun = traf ? find_box(traf + 8, traf + traf_size, "trun", &trun_size) : NULL;
+        if(!tfdt || !trun || tfdt[8] != 1 || (rd32(trun + 8) & 0xFFFFFF) != 0x000701)
+        {
+            printf("불일치: traf 구성\n");
+            failures++;
+            break;
+        }
+        base = rd64(tfdt + 12);
+        if(base != next_dts)
+        {
+            printf("불일치: 프래그먼트 %u tfdt %llu != %llu\n", frag, base, next_dts);
+            failures++;
+        }
+        n = rd32(trun + 12);
+        off = rd32(trun + 16);
+        if(off != moof_size + 8 || trun_size != 20 + n * 12)
+        {
+            printf("불일치: trun data_offset/크기\n");
+            failures++;
+            break;
+        }
+
+        data = moof + off;
+        for(i = 0; i < n; i++)
+        {
+            const unsigned char *e = trun + 20 + i * 12;
+            unsigned int dur = rd32(e), ssize = rd32(e + 4), flags = rd32(e + 8);
+            const unsigned char *s = data, *s_end = data + ssize;
+            int key = 0;
+
+            if(dur == 0 || s_end > mdat + mdat_size)
+            {
+                printf("불일치: 샘플 길이/크기\n");
+                failures++;
+                break;
+            }
+            dur_sum += dur;
+
+            if(au >= au_count)
+            {
+                printf("불일치: 입력보다 샘플이 많음\n");
+                failures++;
+                break;
+            }
+            // AVCC 샘플의 NAL 을 입력 AU 의 기대 NAL 과 순서대로 비교
+            while(s + 4 <= s_end)
+            {
+                unsigned int nl = rd32(s);
+                while(nal_idx < nal_count && nalus[nal_idx].offset < aus[au].end &&
+                      !expected_nal(in + nalus[nal_idx].offset, &nalus[nal_idx], &ps))
+                    nal_idx++;
+                if(nal_idx >= nal_count || nalus[nal_idx].offset >= aus[au].end ||
+                   nalus[nal_idx].size != nl || s + 4 + nl > s_end ||
+                   memcmp(in + nalus[nal_idx].offset, s + 4, nl) != 0)
+                {
+                    printf("불일치: 샘플 %u NAL 이 입력과 다름\n", i);
+                    failures++;
+                    break;
+                }
+                if(nalus[nal_idx].nal_unit_type == 5)
+                    key = 1;
+                nal_idx++;
+                s += 4 + nl;
+            }
+            while(nal_idx < nal_count && nalus[nal_idx].offset < aus[au].end)
+            {
+                if(expected_nal(in + nalus[nal_idx].offset, &nalus[nal_idx], &ps))
+                {
+                    printf("불일치: 샘플 %u 에 NAL 누락\n", i);
+                    failures++;
+                }
+                nal_idx++;
+            }
+            au++;
+
+            if(i == 0 && !key)
+            {
+                printf("불일치: 프래그먼트 %u 가 IDR 로 시작하지 않음\n", frag);
+                failures++;
+            }
+            if((flags == 0x02000000) != key)
+            {
+                printf("불일치: sample_flags sync 표시\n");
+                failures++;
+            }
+            data = s_end;
+        }
+        if(data != mdat + mdat_size)
+        {
+            printf("불일치: mdat 크기\n");
+            failures++;
+        }
+        next_dts = base + dur_sum;
+        frag++;
+        p = mdat + mdat_size;
+    }
+
+    if(au != au_count && failures == 0)
+    {
+        printf("불일치: 샘플 %d 개가 기록되지 않음\n", au_count - au);
+        failures++;
+    }
+    printf("파일 검증: 프래그먼트 %u, 총 길이 %.2f 초 (%u fps)\n", frag,
+           next_dts / (double)MP4_MUX_TIMESCALE, fps);
+    free(file);
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path = NULL, *out_path = "mp4_remux_test.mp4";
+    unsigned int fps = 30, len = 0, i;
+    unsigned char *in;
+    H264_NALU *nalus;
+    AU_RANGE *aus;
+    MP4_MUX *mux;
+    MP4_MUX_STATS st;
+    int nal_count, au_count, pass, failures = 0;
+
+    if(argc >= 2)
+        in_path = argv[1];
+    if(argc >= 3)
+        out_path = argv[2];
+    if(argc >= 4)
+        fps = (unsigned int)atoi(argv[3]);
+    if(fps == 0)
+    {
+        printf("사용법: %s [in.h264] [out.mp4] [fps]\n", argv[0]);
+        return 2;
+    }
+
+    if(in_path)
+    {
+        FILE *fp = fopen(in_path, "rb");
+        if(!fp)
+        {
+            printf("%s 열기 실패\n", in_path);
+            return 2;
+        }
+        fseek(fp, 0, SEEK_END);
+        len = (unsigned int)ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        in = (unsigned char *)malloc(len ? len : 1);
+        if(!in || fread(in, 1, len, fp) != len)
+        {
+            fclose(fp);
+            return 2;
+        }
+        fclose(fp);
+    }
+    else
+    {
+        in = synth_stream(&len);
+        printf("합성 스트림: %ux%u, %u 프레임, GOP %u (%u bytes)\n", SYN_WIDTH, SYN_HEIGHT, SYN_FRAMES, SYN_GOP, len);
+    }
+
+    nalus = (H264_NALU *)malloc(sizeof(H264_NALU) * MAX_NALUS);
+    aus = (AU_RANGE *)malloc(sizeof(AU_RANGE) * MAX_AUS);
+    if(!nalus || !aus)
+        return 2;
+    nal_count = H264ScanNALUs(in, len, nalus, MAX_NALUS);
+    au_count = split_access_units(in, len, nalus, nal_count, aus, MAX_AUS);
+    printf("입력: NAL %d 개, 액세스 유닛 %d 개\n", nal_count, au_count);
+    if(au_count == 0)
+    {
+        printf("H.264 NAL 을 찾지 못함\n");
+        return 1;
+    }
+
+    // 녹화 경로와 같은 muxer (timestamp 는 fps 로 생성)
+    for(pass = 0; pass < 2 && !failures; pass++)
+    {
+        FRAME_WRITER *writer = NULL;
+
+        if(pass == 1)
+        {
+            writer = FrameWriterCreate(NULL);
+            if(!writer)
+                return 1;
+            mux = Mp4MuxOpenWriter(out_path, writer);
+        }
+        else
+        {
+            mux = Mp4MuxOpen(out_path, 0);
+        }
+        if(!mux)
+            return 1;
+        for(i = 0; i < (unsigned int)au_count; i++)
+        {
+            struct timeval ts;
+            unsigned long long us = (unsigned long long)i * 1000000ULL / fps;
+
+            ts.tv_sec = (time_t)(us / 1000000ULL);
+            ts.tv_usec = (suseconds_t)(us % 1000000ULL);
+            if(Mp4MuxWriteFrame(mux, in + aus[i].start, aus[i].end - aus[i].start, &ts) < 0)
+            {
+                printf("Mp4MuxWriteFrame 실패\n");
+                failures++;
+                break;
+            }
+        }
+        if(Mp4MuxClose(mux, &st) < 0)
+            failures++;
+        if(writer)
+        {
+            FW_STATS fst;
+
+            FrameWriterFlush(writer);       // 마지막 청크까지 써지고 파일이 닫힌 뒤 돌아온다
+            FrameWriterGetStats(writer, &fst);
+            FrameWriterDestroy(writer);
+            printf("%s (frame writer): 샘플 %lu, 프래그먼트 %lu, %s, 쓰기 작업 %lu 회, 오류 %lu\n", out_path,
+                   st.frames, st.fragments, fst.direct_files ? "O_DIRECT" : "buffered", fst.completed, fst.errors);
+            if(fst.errors)
+                failures++;
+        }
+        else
+        {
+            printf("%s: 샘플 %lu, 버림 %lu, 프래그먼트 %lu, write() %lu 회 (프레임당 %.3f)\n", out_path,
+                   st.frames, st.skipped, st.fragments, st.write_calls,
+                   st.frames ? (double)st.write_calls / st.frames : 0.0);
+        }
+
+        if(!failures && st.frames == 0)
+        {
+            printf("SPS/PPS 와 IDR 을 찾지 못해 기록된 샘플이 없음\n");
+            failures++;
+        }
+        if(!failures)
+            failures += verify_file(out_path, in, nalus, nal_count, aus, au_count, fps);
+    }
+
+    printf("검증: %s\n", failures ? "실패" : "fMP4 샘플이 입력 NAL 과 일치");
+    if(!in_path && !failures && argc < 3)
+        remove(out_path);
+
+    free(in);
+    free(nalus);
+    free(aus);
+    return failures ? 1 : 0;
+}
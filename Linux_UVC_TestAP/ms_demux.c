@@ -0,0 +1,429 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "ms_demux.h"
+
+// 프레임 복사본. 받은 구독자 수만큼 refs 를 갖고, 마지막 소비자가 풀로 돌려준다
+typedef struct MS_PACKET
+{
+    struct MS_PACKET *next;         // 풀의 빈 목록
+    unsigned char *data;
+    unsigned int cap;
+    MS_FRAME frame;
+    int refs;
+} MS_PACKET;
+
+typedef struct
+{
+    MS_PACKET *pkt;
+    int discont;
+} MS_ENTRY;
+
+struct MS_SUBSCRIBER
+{
+    MS_DEMUX *demux;
+    char name[32];
+    unsigned int mask;
+    MS_POLICY policy;
+    int cpu;
+    MS_CONSUMER_FN fn;
+    void *user;
+
+    MS_ENTRY *queue;                // depth 크기의 원형 큐
+    unsigned int depth;
+    unsigned int head;
+    unsigned int count;
+    int pending_discont;
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    pthread_t thread;
+    MS_SUB_STATS stats;
+};
+
+struct MS_DEMUX
+{
+    MS_SUBSCRIBER *subs[MS_DEMUX_MAX_SUBSCRIBERS];
+    int sub_count;
+    int published;                  // 첫 publish 뒤에는 구독 추가 불가
+    int stopped;
+
+    unsigned int sequence[MS_STREAM_COUNT];
+
+    pthread_mutex_t pool_lock;
+    MS_PACKET *free_list;
+};
+
+static const char *stream_names[MS_STREAM_COUNT] = { "   HD", "  VGA", " QVGA", "QQVGA", "OTHER" };
+
+int MsDemuxClassify(unsigned int resolution)
+{
+    switch(resolution)
+    {
+    case MS_SIZE_HD:
+        return MS_STREAM_HD;
+    case MS_SIZE_VGA:
+        return MS_STREAM_VGA;
+    case MS_SIZE_QVGA:
+        return MS_STREAM_QVGA;
+    case MS_SIZE_QQVGA:
+        return MS_STREAM_QQVGA;
+    default:
+        return MS_STREAM_OTHER;
+    }
+}
+
+const char *MsDemuxStreamName(int stream)
+{
+    if(stream < 0 || stream >= MS_STREAM_COUNT)
+        return stream_names[MS_STREAM_OTHER];
+    return stream_names[stream];
+}
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// ===== 패킷 풀 =====
+
+static MS_PACKET *packet_get(MS_DEMUX *demux, unsigned int len)
+{
+    MS_PACKET *pkt;
+
+    pthread_mutex_lock(&demux->pool_lock);
+    pkt = demux->free_list;
+    if(pkt)
+        demux->free_list = pkt->next;
+    pthread_mutex_unlock(&demux->pool_lock);
+
+    if(!pkt)
+    {
+        pkt = (MS_PACKET *)calloc(1, sizeof(MS_PACKET));
+        if(!pkt)
+            return NULL;
+    }
+    if(pkt->cap < len)
+    {
+        // 한 번 커진 버퍼는 계속 재사용 (HD I 프레임 크기에서 안정됨)
+        unsigned char *p = (unsigned char *)realloc(pkt->data, len);
+        if(!p)
+        {
+            free(pkt->data);
+            free(pkt);
+            return NULL;
+        }
+        pkt->data = p;
+        pkt->cap = len;
+    }
+    pkt->next = NULL;
+    return pkt;
+}
+
+static void packet_put(MS_DEMUX *demux, MS_PACKET *pkt)
+{
+    pthread_mutex_lock(&demux->pool_lock);
+    if(--pkt->refs == 0)
+    {
+        pkt->next = demux->free_list;
+        demux->free_list = pkt;
+    }
+    pthread_mutex_unlock(&demux->pool_lock);
+}
+
+// ===== 구독자 =====
+
+static void *consumer_thread(void *arg)
+{
+    MS_SUBSCRIBER *sub = (MS_SUBSCRIBER *)arg;
+
+    for(;;)
+    {
+        MS_ENTRY e;
+        MS_FRAME frame;
+
+        pthread_mutex_lock(&sub->lock);
+        while(sub->count == 0 && !sub->stop)
+            pthread_cond_wait(&sub->not_empty, &sub->lock);
+        if(sub->count == 0)
+        {
+            pthread_mutex_unlock(&sub->lock);
+            break;
+        }
+        e = sub->queue[sub->head];
+        sub->head = (sub->head + 1) % sub->depth;
+        sub->count--;
+        pthread_cond_signal(&sub->not_full);
+        pthread_mutex_unlock(&sub->lock);
+
+        frame = e.pkt->frame;
+        frame.discont = e.discont;
+        sub->fn(&frame, sub->user);
+        packet_put(sub->demux, e.pkt);
+
+        pthread_mutex_lock(&sub->lock);
+        sub->stats.delivered++;
+        pthread_mutex_unlock(&sub->lock);
+    }
+    return NULL;
+}
+
+MS_DEMUX *MsDemuxCreate(void)
+{
+    MS_DEMUX *demux = (MS_DEMUX *)calloc(1, sizeof(MS_DEMUX));
+
+    if(!demux)
+        return NULL;
+    pthread_mutex_init(&demux->pool_lock, NULL);
+    return demux;
+}
+
+MS_SUBSCRIBER *MsDemuxSubscribe(MS_DEMUX *demux, const char *name, unsigned int stream_mask,
+                                MS_POLICY policy, unsigned int depth, int cpu,
+                                MS_CONSUMER_FN fn, void *user)
+{
+    MS_SUBSCRIBER *sub;
+
+    if(!demux || !fn || demux->published || demux->sub_count >= MS_DEMUX_MAX_SUBSCRIBERS)
+        return NULL;
+    if(depth == 0)
+        depth = MS_DEMUX_DEFAULT_DEPTH;
+
+    sub = (MS_SUBSCRIBER *)calloc(1, sizeof(MS_SUBSCRIBER));
+    if(!sub)
+        return NULL;
+    sub->queue = (MS_ENTRY *)calloc(depth, sizeof(MS_ENTRY));
+    if(!sub->queue)
+    {
+        free(sub);
+        return NULL;
+    }
+    sub->demux = demux;
+    snprintf(sub->name, sizeof(sub->name), "%s", name ? name : "consumer");
+    sub->mask = stream_mask;
+    sub->policy = policy;
+    sub->depth = depth;
+    sub->cpu = cpu;
+    sub->fn = fn;
+    sub->user = user;
+    pthread_mutex_init(&sub->lock, NULL);
+    pthread_cond_init(&sub->not_empty, NULL);
+    pthread_cond_init(&sub->not_full, NULL);
+
+    if(pthread_create(&sub->thread, NULL, consumer_thread, sub) != 0)
+    {
+        printf("MS demux: %s 스레드 생성 실패\n", sub->name);
+        pthread_cond_destroy(&sub->not_full);
+        pthread_cond_destroy(&sub->not_empty);
+        pthread_mutex_destroy(&sub->lock);
+        free(sub->queue);
+        free(sub);
+        return NULL;
+    }
+    if(cpu >= 0)
+    {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if(pthread_setaffinity_np(sub->thread, sizeof(set), &set) != 0)
+            printf("MS demux: %s 를 CPU %d 에 고정하지 못함 (계속 진행)\n", sub->name, cpu);
+    }
+
+    demux->subs[demux->sub_count++] = sub;
+    return sub;
+}
+
+// 가장 오래된 항목을 버린다 (sub->lock 을 잡은 상태)
+static void drop_oldest(MS_SUBSCRIBER *sub)
+{
+    MS_ENTRY e = sub->queue[sub->head];
+
+    sub->head = (sub->head + 1) % sub->depth;
+    sub->count--;
+    sub->stats.dropped++;
+    if(sub->count > 0)
+        sub->queue[sub->head].discont = 1;
+    else
+        sub->pending_discont = 1;
+    packet_put(sub->demux, e.pkt);
+}
+
+static void enqueue(MS_SUBSCRIBER *sub, MS_PACKET *pkt)
+{
+    MS_ENTRY *e;
+
+    pthread_mutex_lock(&sub->lock);
+    if(sub->count == sub->depth)
+    {
+        if(sub->policy == MS_POLICY_BLOCK)
+        {
+            unsigned long long t0 = now_us();
+
+            sub->stats.blocked++;
+            while(sub->count == sub->depth && !sub->stop)
+                pthread_cond_wait(&sub->not_full, &sub->lock);
+            sub->stats.blocked_us += now_us() - t0;
+        }
+        else
+        {
+            drop_oldest(sub);
+        }
+    }
+    if(sub->count == sub->depth)
+    {
+        // 종료 중에 BLOCK 이 풀린 경우
+        sub->stats.dropped++;
+        pthread_mutex_unlock(&sub->lock);
+        packet_put(sub->demux, pkt);
+        return;
+    }
+
+    e = &sub->queue[(sub->head + sub->count) % sub->depth];
+    e->pkt = pkt;
+    e->discont = sub->pending_discont;
+    sub->pending_discont = 0;
+    sub->count++;
+    if(sub->count > sub->stats.max_depth)
+        sub->stats.max_depth = sub->count;
+    pthread_cond_signal(&sub->not_empty);
+    pthread_mutex_unlock(&sub->lock);
+}
+
+static int wants(MS_SUBSCRIBER *sub, int stream, int keyframe)
+{
+    if(!(sub->mask & MS_STREAM_MASK(stream)))
+        return 0;
+    if(sub->policy == MS_POLICY_KEYFRAME_ONLY && !keyframe)
+    {
+        pthread_mutex_lock(&sub->lock);
+        sub->stats.skipped++;
+        pthread_mutex_unlock(&sub->lock);
+        return 0;
+    }
+    return 1;
+}
+
+int MsDemuxPublish(MS_DEMUX *demux, unsigned int resolution, const void *data, unsigned int len,
+                   const struct timeval *ts, int keyframe)
+{
+    unsigned char targets[MS_DEMUX_MAX_SUBSCRIBERS];
+    MS_PACKET *pkt;
+    int stream, i, n = 0;
+
+    if(!demux || demux->stopped || (!data && len))
+        return -1;
+    demux->published = 1;
+
+    stream = MsDemuxClassify(resolution);
+    for(i = 0; i < demux->sub_count; i++)
+    {
+        targets[i] = (unsigned char)wants(demux->subs[i], stream, keyframe);
+        n += targets[i];
+    }
+    if(n == 0)
+    {
+        demux->sequence[stream]++;
+        return stream;
+    }
+
+    pkt = packet_get(demux, len);
+    if(!pkt)
+        return -1;
+    if(len)
+        memcpy(pkt->data, data, len);
+    pkt->frame.data = pkt->data;
+    pkt->frame.len = len;
+    pkt->frame.stream = stream;
+    pkt->frame.sequence = demux->sequence[stream]++;
+    if(ts)
+        pkt->frame.timestamp = *ts;
+    else
+        memset(&pkt->frame.timestamp, 0, sizeof(pkt->frame.timestamp));
+    pkt->frame.keyframe = keyframe;
+    pkt->frame.discont = 0;
+    pkt->refs = n;
+
+    // 각 구독자 큐는 독립적이므로 느린 소비자는 자기 큐만 채운다 (BLOCK 만 publish 를 멈춤)
+    for(i = 0; i < demux->sub_count; i++)
+    {
+        if(targets[i])
+            enqueue(demux->subs[i], pkt);
+    }
+    return stream;
+}
+
+void MsDemuxGetStats(MS_SUBSCRIBER *sub, MS_SUB_STATS *stats)
+{
+    if(!stats)
+        return;
+    if(!sub)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    pthread_mutex_lock(&sub->lock);
+    *stats = sub->stats;
+    pthread_mutex_unlock(&sub->lock);
+}
+
+void MsDemuxStop(MS_DEMUX *demux)
+{
+    int i;
+
+    if(!demux || demux->stopped)
+        return;
+
+    for(i = 0; i < demux->sub_count; i++)
+    {
+        MS_SUBSCRIBER *sub = demux->subs[i];
+
+        pthread_mutex_lock(&sub->lock);
+        sub->stop = 1;
+        pthread_cond_broadcast(&sub->not_empty);
+        pthread_cond_broadcast(&sub->not_full);
+        pthread_mutex_unlock(&sub->lock);
+    }
+    for(i = 0; i < demux->sub_count; i++)
+        pthread_join(demux->subs[i]->thread, NULL);
+    demux->stopped = 1;
+}
+
+void MsDemuxDestroy(MS_DEMUX *demux)
+{
+    MS_PACKET *pkt;
+    int i;
+
+    if(!demux)
+        return;
+
+    MsDemuxStop(demux);
+    for(i = 0; i < demux->sub_count; i++)
+    {
+        MS_SUBSCRIBER *sub = demux->subs[i];
+
+        pthread_cond_destroy(&sub->not_full);
+        pthread_cond_destroy(&sub->not_empty);
+        pthread_mutex_destroy(&sub->lock);
+        free(sub->queue);
+        free(sub);
+    }
+
+    // 모든 소비자가 끝났으므로 패킷은 전부 빈 목록에 있다
+    while((pkt = demux->free_list) != NULL)
+    {
+        demux->free_list = pkt->next;
+        free(pkt->data);
+        free(pkt);
+    }
+    pthread_mutex_destroy(&demux->pool_lock);
+    free(demux);
+}
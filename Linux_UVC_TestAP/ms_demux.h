@@ -0,0 +1,99 @@
+#ifndef _MS_DEMUX_H_
+#define _MS_DEMUX_H_
+
+#include <sys/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// RER9421/9422 멀티 스트림 디먹스
+// 한 장치에서 번갈아 나오는 HD/VGA/QVGA/QQVGA 프레임을 한 번만 분류해서
+// 스트림을 구독한 소비자 큐로 나눠 준다. 소비자마다 자기 스레드(필요하면 CPU 고정)에서
+// 콜백이 돌고, 큐가 가득 찼을 때의 처리(backpressure)를 소비자별로 고른다.
+// 프레임은 내부 풀로 한 번 복사하므로 캡처 쪽은 publish 직후 V4L2 버퍼를 다시 큐에 넣을 수 있다.
+
+// 해상도 ((width << 16) | height), 드라이버가 v4l2_buffer.reserved 에 넣어 주는 값과 같다
+#define MS_SIZE_HD                  ((1280 << 16) | 720)
+#define MS_SIZE_VGA                 ((640 << 16) | 480)
+#define MS_SIZE_QVGA                ((320 << 16) | 240)
+#define MS_SIZE_QQVGA               ((160 << 16) | 112)
+
+#define MS_STREAM_HD                0
+#define MS_STREAM_VGA               1
+#define MS_STREAM_QVGA              2
+#define MS_STREAM_QQVGA             3
+#define MS_STREAM_OTHER             4           // 위 해상도가 아니거나 알 수 없음
+#define MS_STREAM_COUNT             5
+
+#define MS_STREAM_MASK(s)           (1u << (s))
+#define MS_STREAM_ALL_KNOWN         0x0F
+
+#define MS_DEMUX_MAX_SUBSCRIBERS    8
+#define MS_DEMUX_DEFAULT_DEPTH      8
+
+typedef enum
+{
+    MS_POLICY_DROP_OLDEST = 0,      // 큐가 차면 가장 오래된 프레임을 버림 (미리보기)
+    MS_POLICY_BLOCK,                // 큐가 차면 publish 가 기다림 (녹화, 프레임 손실 없음)
+    MS_POLICY_KEYFRAME_ONLY         // 키프레임만 받음, 큐가 차면 가장 오래된 것을 버림 (분석)
+} MS_POLICY;
+
+typedef struct
+{
+    const unsigned char *data;
+    unsigned int len;
+    int stream;                     // MS_STREAM_*
+    unsigned int sequence;          // 스트림별 publish 순번 (0 부터)
+    struct timeval timestamp;       // V4L2 버퍼 timestamp
+    int keyframe;
+    int discont;                    // 이 프레임 앞에서 이 소비자 몫의 프레임이 버려졌음
+} MS_FRAME;
+
+// 소비자 스레드에서 호출. frame 은 콜백이 끝나면 재사용된다
+typedef void (*MS_CONSUMER_FN)(const MS_FRAME *frame, void *user);
+
+typedef struct
+{
+    unsigned long delivered;        // 콜백까지 간 프레임
+    unsigned long dropped;          // 큐가 가득 차서 버린 프레임
+    unsigned long skipped;          // KEYFRAME_ONLY 가 건너뛴 비키프레임
+    unsigned long blocked;          // BLOCK 으로 publish 가 기다린 횟수
+    unsigned long long blocked_us;  // 기다린 총 시간
+    unsigned int max_depth;         // 관측한 최대 큐 길이
+} MS_SUB_STATS;
+
+typedef struct MS_DEMUX MS_DEMUX;
+typedef struct MS_SUBSCRIBER MS_SUBSCRIBER;
+
+// (width << 16) | height → MS_STREAM_*
+int MsDemuxClassify(unsigned int resolution);
+
+// 로그/파일 이름용 고정 폭 이름 ("   HD", "  VGA", ...)
+const char *MsDemuxStreamName(int stream);
+
+MS_DEMUX *MsDemuxCreate(void);
+
+// 첫 MsDemuxPublish 전에 등록한다. depth 가 0 이면 MS_DEMUX_DEFAULT_DEPTH,
+// cpu 가 0 이상이면 소비자 스레드를 그 CPU 에 고정. 실패 시 NULL
+MS_SUBSCRIBER *MsDemuxSubscribe(MS_DEMUX *demux, const char *name, unsigned int stream_mask,
+                                MS_POLICY policy, unsigned int depth, int cpu,
+                                MS_CONSUMER_FN fn, void *user);
+
+// 프레임 하나를 분류해서 구독자 큐에 넣는다. 분류된 MS_STREAM_* 반환, 실패 시 -1
+int MsDemuxPublish(MS_DEMUX *demux, unsigned int resolution, const void *data, unsigned int len,
+                   const struct timeval *ts, int keyframe);
+
+void MsDemuxGetStats(MS_SUBSCRIBER *sub, MS_SUB_STATS *stats);
+
+// 큐에 남은 프레임을 모두 소비자에게 넘긴 뒤 소비자 스레드를 끝낸다 (통계는 계속 읽을 수 있음)
+void MsDemuxStop(MS_DEMUX *demux);
+
+// MsDemuxStop 후 구독자와 풀을 해제한다
+void MsDemuxDestroy(MS_DEMUX *demux);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
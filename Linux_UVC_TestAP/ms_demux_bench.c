@@ -0,0 +1,279 @@
+//----------------------------------------------//
+//	멀티 스트림 디먹스 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./ms_demux_bench [rounds] [fps]
+// 카메라처럼 HD/VGA/QVGA/QQVGA 프레임을 한 라운드씩 번갈아 내보내고 세 소비자를 붙인다.
+//   HD 녹화     : BLOCK, 빠름 (프레임마다 내용 검사)
+//   VGA 미리보기 : DROP_OLDEST, 느림 (한 프레임 간격보다 오래 걸림)
+//   QVGA 분석   : KEYFRAME_ONLY, 느림
+//   inline : 기존 if/else 체인처럼 캡처 루프에서 소비자를 차례로 직접 호출
+//   demux  : MsDemuxPublish 로 소비자 큐에 넘김
+// 두 모드의 캡처 루프 지연(예정 시각 대비 늦어진 정도)을 비교하고, demux 모드에서
+//   녹화가 모든 HD 프레임을 순서대로 받았는지, 캡처 루프가 한 프레임 간격 이상 밀리지 않았는지,
+//   미리보기의 전달 + 드롭 = 발행 수이고 순번이 증가하며 끊긴 곳에 discont 가 있는지,
+//   분석이 키프레임만 받았는지 확인해서 하나라도 어긋나면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ms_demux.h"
+
+#define BENCH_GOP           30
+#define RECORD_WORK_US      1000
+#define PREVIEW_WORK_US     45000
+#define ANALYTICS_WORK_US   30000
+
+static const unsigned int bench_sizes[4] = { MS_SIZE_HD, MS_SIZE_VGA, MS_SIZE_QVGA, MS_SIZE_QQVGA };
+static const unsigned int bench_len[4] = { 60000, 20000, 8000, 3000 };
+
+typedef struct
+{
+    const char *name;
+    int stream;
+    unsigned int work_us;
+    // 검증 상태 (소비자 스레드만 씀)
+    unsigned long received;
+    unsigned long errors;
+    unsigned long gaps;             // 순번이 건너뛴 횟수
+    unsigned long gaps_flagged;     // 그 중 discont 가 켜진 것
+    unsigned long non_key;
+    long last_seq;
+} CONSUMER;
+
+static unsigned long long now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// 소비자 처리 시간 (디스크 쓰기, 디코드 등) 흉내
+static void simulate_work(unsigned int us)
+{
+    if(us)
+        usleep(us);
+}
+
+// 프레임 내용: (stream, sequence) 로 만든 패턴
+static void fill_frame(unsigned char *buf, unsigned int len, int stream, unsigned int seq)
+{
+    unsigned int i, v = seq * 2654435761u + (unsigned int)stream;
+
+    for(i = 0; i < len; i++)
+    {
+        v = v * 1103515245u + 12345u;
+        buf[i] = (unsigned char)(v >> 24);
+    }
+}
+
+static int frame_ok(const unsigned char *buf, unsigned int len, int stream, unsigned int seq)
+{
+    unsigned int i, v = seq * 2654435761u + (unsigned int)stream;
+
+    for(i = 0; i < len; i++)
+    {
+        v = v * 1103515245u + 12345u;
+        if(buf[i] != (unsigned char)(v >> 24))
+            return 0;
+    }
+    return 1;
+}
+
+static void consume(const MS_FRAME *frame, void *user)
+{
+    CONSUMER *c = (CONSUMER *)user;
+
+    if(frame->stream != c->stream || !frame_ok(frame->data, frame->len, frame->stream, frame->sequence))
+        c->errors++;
+    if(c->last_seq >= 0 && (long)frame->sequence != c->last_seq + 1)
+    {
+        if((long)frame->sequence <= c->last_seq)
+            c->errors++;            // 순서가 뒤집힘
+        c->gaps++;
+        if(frame->discont)
+            c->gaps_flagged++;
+    }
+    if(!frame->keyframe)
+        c->non_key++;
+    c->last_seq = frame->sequence;
+    c->received++;
+    simulate_work(c->work_us);
+}
+
+typedef struct
+{
+    unsigned long long max_late_us;
+    unsigned long late_rounds;      // 한 프레임 간격 이상 밀린 라운드
+    double seconds;
+    unsigned long published[4];
+    unsigned long keyframes[4];
+} RUN_RESULT;
+
+// 라운드마다 4 스트림을 하나씩 내보낸다 (demux 가 NULL 이면 inline 호출)
+static void run_capture(MS_DEMUX *demux, CONSUMER *cons, int ncons, int rounds, int fps, RUN_RESULT *res)
+{
+    unsigned long long interval = 1000000ULL / fps, start, deadline;
+    unsigned char *buf = (unsigned char *)malloc(bench_len[0] * 3);
+    int r, s, k;
+
+    memset(res, 0, sizeof(*res));
+    if(!buf)
+        return;
+    start = now_us();
+    for(r = 0; r < rounds; r++)
+    {
+        unsigned long long t;
+
+        deadline = start + r * interval;
+        t = now_us();
+        if(t < deadline)
+        {
+            usleep((useconds_t)(deadline - t));
+            t = now_us();
+        }
+        if(t - deadline > res->max_late_us)
+            res->max_late_us = t - deadline;
+        if(t - deadline >= interval)
+            res->late_rounds++;
+
+        for(s = 0; s < 4; s++)
+        {
+            int key = (r % BENCH_GOP) == 0;
+            unsigned int len = bench_len[s] * (key ? 3 : 1);
+            struct timeval tv;
+
+            fill_frame(buf, len, s, (unsigned int)r);
+            tv.tv_sec = (time_t)(t / 1000000ULL);
+            tv.tv_usec = (suseconds_t)(t % 1000000ULL);
+            res->published[s]++;
+            res->keyframes[s] += key;
+
+            if(demux)
+            {
+                MsDemuxPublish(demux, bench_sizes[s], buf, len, &tv, key);
+                continue;
+            }
+            // 기존 방식: 캡처 루프 안에서 해상도별 처리를 직접 실행
+            for(k = 0; k < ncons; k++)
+            {
+                if(cons[k].stream == s && (s != MS_STREAM_QVGA || key))
+                {
+                    MS_FRAME f;
+
+                    f.data = buf;
+                    f.len = len;
+                    f.stream = s;
+                    f.sequence = (unsigned int)r;
+                    f.timestamp = tv;
+                    f.keyframe = key;
+                    f.discont = 0;
+                    consume(&f, &cons[k]);
+                }
+            }
+        }
+    }
+    res->seconds = (now_us() - start) / 1e6;
+    free(buf);
+}
+
+static void init_consumers(CONSUMER *c)
+{
+    memset(c, 0, sizeof(CONSUMER) * 3);
+    c[0].name = "HD 녹화";
+    c[0].stream = MS_STREAM_HD;
+    c[0].work_us = RECORD_WORK_US;
+    c[1].name = "VGA 미리보기";
+    c[1].stream = MS_STREAM_VGA;
+    c[1].work_us = PREVIEW_WORK_US;
+    c[2].name = "QVGA 분석";
+    c[2].stream = MS_STREAM_QVGA;
+    c[2].work_us = ANALYTICS_WORK_US;
+    c[0].last_seq = c[1].last_seq = c[2].last_seq = -1;
+}
+
+static int check(int cond, const char *what)
+{
+    if(!cond)
+        printf("불일치: %s\n", what);
+    return cond ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *policy_names[3] = { "DROP_OLDEST", "BLOCK", "KEYFRAME_ONLY" };
+    static const MS_POLICY policies[3] = { MS_POLICY_BLOCK, MS_POLICY_DROP_OLDEST, MS_POLICY_KEYFRAME_ONLY };
+    static const unsigned int depths[3] = { 32, 2, 2 };
+    int rounds = 90, fps = 30, i, failures = 0;
+    CONSUMER cons[3];
+    MS_SUBSCRIBER *subs[3];
+    MS_SUB_STATS st[3];
+    RUN_RESULT inl, dmx;
+    MS_DEMUX *demux;
+
+    if(argc >= 2)
+        rounds = atoi(argv[1]);
+    if(argc >= 3)
+        fps = atoi(argv[2]);
+    if(rounds <= 0 || fps <= 0)
+    {
+        printf("사용법: %s [rounds] [fps]\n", argv[0]);
+        return 2;
+    }
+    printf("=== 멀티 스트림 디먹스 벤치마크 (4 스트림 x %d 라운드, %d fps, GOP %d) ===\n", rounds, fps, BENCH_GOP);
+
+    // inline
+    init_consumers(cons);
+    run_capture(NULL, cons, 3, rounds, fps, &inl);
+    printf("inline: %.2f 초, 캡처 루프 최대 지연 %6.1f ms, 한 간격 이상 밀린 라운드 %lu/%d\n",
+           inl.seconds, inl.max_late_us / 1000.0, inl.late_rounds, rounds);
+
+    // demux
+    init_consumers(cons);
+    demux = MsDemuxCreate();
+    if(!demux)
+        return 1;
+    for(i = 0; i < 3; i++)
+    {
+        subs[i] = MsDemuxSubscribe(demux, cons[i].name, MS_STREAM_MASK(cons[i].stream), policies[i],
+                                   depths[i], -1, consume, &cons[i]);
+        if(!subs[i])
+        {
+            printf("구독 실패\n");
+            return 1;
+        }
+    }
+    run_capture(demux, NULL, 0, rounds, fps, &dmx);
+    MsDemuxStop(demux);
+    printf("demux : %.2f 초, 캡처 루프 최대 지연 %6.1f ms, 한 간격 이상 밀린 라운드 %lu/%d\n",
+           dmx.seconds, dmx.max_late_us / 1000.0, dmx.late_rounds, rounds);
+
+    for(i = 0; i < 3; i++)
+    {
+        MsDemuxGetStats(subs[i], &st[i]);
+        printf("  %-16s %-13s 전달 %4lu  드롭 %4lu  건너뜀 %4lu  대기 %4lu회 %7.1f ms  최대 큐 %u\n",
+               cons[i].name, policy_names[policies[i]], st[i].delivered, st[i].dropped, st[i].skipped,
+               st[i].blocked, st[i].blocked_us / 1000.0, st[i].max_depth);
+    }
+
+    // 녹화: 손실/순서/내용
+    failures += check(cons[0].errors == 0 && cons[1].errors == 0 && cons[2].errors == 0, "프레임 내용 또는 순서");
+    failures += check(cons[0].received == dmx.published[MS_STREAM_HD] && cons[0].gaps == 0 && st[0].dropped == 0,
+                      "녹화가 모든 HD 프레임을 받지 못함");
+    // 느린 소비자가 캡처 루프를 막지 않음
+    failures += check(dmx.late_rounds == 0, "demux 모드에서 캡처 루프가 한 프레임 간격 이상 밀림");
+    // 미리보기: 드롭 회계와 discont
+    failures += check(st[1].delivered + st[1].dropped == dmx.published[MS_STREAM_VGA], "미리보기 전달 + 드롭 != 발행");
+    failures += check(st[1].dropped > 0 && cons[1].gaps > 0 && cons[1].gaps_flagged == cons[1].gaps,
+                      "미리보기 드롭 뒤 discont 표시");
+    // 분석: 키프레임만
+    failures += check(cons[2].non_key == 0 && st[2].delivered + st[2].dropped == dmx.keyframes[MS_STREAM_QVGA] &&
+                      st[2].skipped == dmx.published[MS_STREAM_QVGA] - dmx.keyframes[MS_STREAM_QVGA],
+                      "분석 구독자가 키프레임만 받지 않음");
+
+    MsDemuxDestroy(demux);
+    printf("검증: %s\n", failures ? "실패" : "느린 소비자가 있어도 캡처 루프와 녹화 스트림이 밀리지 않음");
+    return failures ? 1 : 0;
+}
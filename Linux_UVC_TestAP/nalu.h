@@ -3,9 +3,164 @@
 
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Annex-B NAL 유닛 위치 정보 (H264ScanNALUs 결과)
+typedef struct
+{
+    unsigned int offset;            // NAL 헤더 바이트 오프셋 (start code 다음)
+    unsigned int size;              // NAL 크기 (다음 start code 앞의 0 바이트 제외)
+    unsigned char start_code_len;   // 3 (00 00 01) 또는 4 (00 00 00 01)
+    unsigned char nal_ref_idc;
+    unsigned char nal_unit_type;    // 1: slice, 5: IDR, 6: SEI, 7: SPS, 8: PPS, 9: AUD
+} H264_NALU;
+
 //unsigned char* FindNextH264StartCode(unsigned char *pBuf, unsigned int Buf_len);
+// 3/4 바이트 start code 다음 위치를 반환, 없으면 pBuf_end
 unsigned char* FindNextH264StartCode(unsigned char *pBuf, unsigned char *pBuf_end);
 
+// 버퍼의 모든 NAL 유닛을 한 번에 찾는다. 찾은 개수 반환 (최대 max_nalus)
+int H264ScanNALUs(const unsigned char *pBuf, unsigned int nLen, H264_NALU *pNalus, int max_nalus);
+
+// emulation prevention byte (00 00 03 의 03) 제거. pDst == pSrc 허용, RBSP 길이 반환
+unsigned int H264NaluToRbsp(const unsigned char *pSrc, unsigned int nLen, unsigned char *pDst);
+
+// Exp-Golomb 비트 리더 (버퍼 경계 검사, emulation prevention byte 자동 건너뜀)
+typedef struct
+{
+    const unsigned char *buf;
+    unsigned int len;
+    unsigned int idx;           // 다음에 캐시로 읽어 올 바이트
+    unsigned int zeros;         // 직전 연속 0 바이트 수
+    unsigned long long cache;   // 왼쪽 정렬 비트 캐시
+    int bits;                   // cache 의 유효 비트 수
+    int pad;                    // 버퍼 끝 뒤에 채운 0 비트 수
+    int error;                  // 버퍼 끝을 넘어 읽었거나 잘못된 코드
+} H264_BITREADER;
+
+void H264BitReaderInit(H264_BITREADER *br, const unsigned char *buf, unsigned int len);
+unsigned int H264ReadBits(H264_BITREADER *br, int n);     // n <= 32
+unsigned int H264ReadUe(H264_BITREADER *br);
+int H264ReadSe(H264_BITREADER *br);
+
+typedef struct
+{
+    unsigned char profile_idc;
+    unsigned char constraint_flags;             // constraint_set0_flag 가 MSB
+    unsigned char level_idc;
+    unsigned char seq_parameter_set_id;
+    unsigned char chroma_format_idc;
+    unsigned char separate_colour_plane_flag;
+    unsigned char bit_depth_luma;
+    unsigned char bit_depth_chroma;
+    unsigned char log2_max_frame_num;
+    unsigned char pic_order_cnt_type;
+    unsigned char log2_max_pic_order_cnt_lsb;
+    unsigned char delta_pic_order_always_zero_flag;
+    unsigned char max_num_ref_frames;
+    unsigned char frame_mbs_only_flag;
+    unsigned short pic_width_in_mbs;
+    unsigned short pic_height_in_map_units;
+    int width;                                  // frame cropping 적용 후
+    int height;
+} H264_SPS;
+
+typedef struct
+{
+    unsigned char pic_parameter_set_id;
+    unsigned char seq_parameter_set_id;
+    unsigned char entropy_coding_mode_flag;     // 1: CABAC
+    unsigned char bottom_field_pic_order_in_frame_present_flag;
+    unsigned char num_slice_groups;
+    unsigned char num_ref_idx_l0_default_active;
+    unsigned char num_ref_idx_l1_default_active;
+    unsigned char weighted_pred_flag;
+    unsigned char weighted_bipred_idc;
+    unsigned char deblocking_filter_control_present_flag;
+    unsigned char constrained_intra_pred_flag;
+    unsigned char redundant_pic_cnt_present_flag;
+    signed char pic_init_qp;
+    signed char pic_init_qs;
+    signed char chroma_qp_index_offset;
+} H264_PPS;
+
+// slice_type 값 (% 5 적용)
+#define H264_SLICE_P    0
+#define H264_SLICE_B    1
+#define H264_SLICE_I    2
+#define H264_SLICE_SP   3
+#define H264_SLICE_SI   4
+
+typedef struct
+{
+    unsigned char nal_unit_type;
+    unsigned char nal_ref_idc;
+    unsigned char idr;
+    unsigned char slice_type;
+    unsigned char pic_parameter_set_id;
+    unsigned char field_pic_flag;
+    unsigned char bottom_field_flag;
+    unsigned int first_mb_in_slice;
+    unsigned int frame_num;
+    unsigned int idr_pic_id;
+    unsigned int pic_order_cnt_lsb;
+} H264_SLICE_HEADER;
+
+// 각 함수는 NAL 헤더 바이트부터 시작하는 NAL 을 받는다. 성공 시 0, 실패 시 -1
+int H264ParseSps(const unsigned char *pNal, unsigned int nLen, H264_SPS *pSps);
+int H264ParsePps(const unsigned char *pNal, unsigned int nLen, H264_PPS *pPps);
+int H264ParseSliceHeader(const unsigned char *pNal, unsigned int nLen, const H264_SPS *pSps, H264_SLICE_HEADER *pSh);
+
+// 스트림별 파서 상태. 0 으로 채우면 초기 상태 (동적 할당 없음)
+#define H264_PS_CACHE_SIZE  4
+#define H264_PS_RAW_MAX     128     // 이보다 긴 파라미터 셋은 캐시 비교 없이 매번 해석
+
+typedef struct
+{
+    unsigned int hash;          // NAL 바이트의 FNV-1a 해시
+    unsigned int len;
+    unsigned char valid;
+    unsigned char raw[H264_PS_RAW_MAX];
+} H264_PS_KEY;
+
+typedef struct
+{
+    H264_PS_KEY sps_key[H264_PS_CACHE_SIZE];
+    H264_SPS sps[H264_PS_CACHE_SIZE];
+    H264_PS_KEY pps_key[H264_PS_CACHE_SIZE];
+    H264_PPS pps[H264_PS_CACHE_SIZE];
+    int active_sps;             // 마지막 슬라이스가 참조한 SPS 슬롯 (슬라이스 전이면 마지막으로 받은 SPS)
+    int active_pps;
+    unsigned char sps_slot[32];     // seq_parameter_set_id -> 슬롯 + 1 (0: 없음)
+    unsigned char pps_slot[256];    // pic_parameter_set_id -> 슬롯 + 1
+    int next_sps_slot;
+    int next_pps_slot;
+    int idr_seen;
+    unsigned int frames_since_idr;
+    unsigned int gop_length;
+    unsigned long ps_cache_hits;
+    unsigned long ps_parsed;
+} H264_PARSER;
+
+typedef struct
+{
+    int width;                  // 슬라이스의 PPS 가 가리키는 SPS 기준 해상도
+    int height;
+    int has_sps;                // 이 프레임에 SPS/PPS 가 들어 있었는지
+    int has_pps;
+    int keyframe;               // IDR 프레임
+    int slice_type;             // 첫 슬라이스의 slice_type, 슬라이스가 없으면 -1
+    unsigned int frame_num;
+    unsigned int frames_since_idr;
+    unsigned int gop_length;    // 직전 두 IDR 사이 프레임 수 (0: 아직 모름)
+} H264_FRAME_INFO;
+
+// Annex-B 프레임 한 개의 메타데이터. 첫 슬라이스 헤더까지만 읽고 멈춘다
+// 활성 SPS 가 있으면 0, 없으면 -1
+int H264ParseFrame(H264_PARSER *pParser, const unsigned char *pBuf, unsigned int nLen, H264_FRAME_INFO *pInfo);
+
 bool h264_decode_seq_parameter_set(unsigned char *buf, unsigned int nLen, int *Width, int *Height);
 
 #if 0
@@ -24,4 +179,8 @@ typedef struct nalu_sps
 } NALU_SPS;
 #endif
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
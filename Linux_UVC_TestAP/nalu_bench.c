@@ -0,0 +1,478 @@
+//----------------------------------------------//
+//	H264 start code 스캐너 벤치마크 / 검증		//
+//----------------------------------------------//
+// 사용법: ./nalu_bench [file.h264] [iterations]
+// 파일을 주지 않으면 emulation prevention 이 들어간 합성 Annex-B 스트림을 만든다.
+// 새 스캐너의 NAL 목록이 바이트 단위 기준 구현과 같은지 먼저 확인하고
+// 경로별 처리량(GB/s)을 출력한다. 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nalu.h"
+
+#define MAX_NALUS 65536
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// 기존 FindNextH264StartCode 와 같은 바이트 단위 루프 (3 바이트 start code 허용)
+static unsigned char* legacy_find_start_code(unsigned char *pBuf, unsigned char *pBuf_end)
+{
+    unsigned char zero_cnt = 0;
+
+    while(pBuf != pBuf_end)
+    {
+        if(*pBuf == 0)
+        {
+            zero_cnt++;
+        }
+        else if((zero_cnt >= 2) && (*pBuf == 1))
+        {
+            pBuf++;
+            break;
+        }
+        else
+        {
+            zero_cnt = 0;
+        }
+        pBuf++;
+    }
+    return pBuf;
+}
+
+// 기준 구현: 바이트 단위 루프로 NAL 시작 오프셋만 수집
+static int legacy_scan(unsigned char *buf, unsigned int len, unsigned int *offsets, int max)
+{
+    unsigned char *p = buf;
+    unsigned char *end = buf + len;
+    int count = 0;
+
+    while(count < max)
+    {
+        p = legacy_find_start_code(p, end);
+        if(p == end)
+            break;
+        offsets[count++] = (unsigned int)(p - buf);
+    }
+    return count;
+}
+
+// 합성 스트림: 랜덤 페이로드에 emulation prevention 을 적용한 NAL 들 (3/4 바이트 start code 혼합)
+static unsigned char *make_stream(unsigned int target, unsigned int *out_len, int *out_epb)
+{
+    unsigned char *buf = (unsigned char*)malloc(target + 65536);
+    unsigned int seed = 12345;
+    unsigned int len = 0;
+    int epb = 0;
+
+    if(!buf)
+        return NULL;
+
+    while(len < target)
+    {
+        unsigned int size, i, zeros = 0;
+        static const unsigned char types[] = { 7, 8, 5, 1, 1, 1, 6, 9 };
+
+        seed = seed * 1103515245u + 12345u;
+        size = 64 + (seed >> 16) % 32768;
+        if((seed >> 8) & 1)
+            buf[len++] = 0;
+        buf[len++] = 0;
+        buf[len++] = 0;
+        buf[len++] = 1;
+        buf[len++] = 0x60 | types[(seed >> 4) & 7];
+
+        for(i = 0; i < size; i++)
+        {
+            unsigned char b;
+            seed = seed * 1103515245u + 12345u;
+            // 0 이 자주 나오도록 해서 escape 경로를 충분히 통과시킨다
+            b = ((seed >> 16) & 7) == 0 ? 0 : (unsigned char)(seed >> 20);
+            if(zeros >= 2 && b <= 3)
+            {
+                buf[len++] = 3;
+                zeros = 0;
+                epb++;
+            }
+            buf[len++] = b;
+            zeros = b ? 0 : zeros + 1;
+        }
+        // rbsp_stop_one_bit
+        buf[len++] = 0x80;
+    }
+
+    *out_len = len;
+    *out_epb = epb;
+    return buf;
+}
+
+static unsigned char *load_file(const char *path, unsigned int *out_len)
+{
+    FILE *fp = fopen(path, "rb");
+    unsigned char *buf;
+    long size;
+
+    if(!fp)
+        return NULL;
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = (unsigned char*)malloc(size > 0 ? size : 1);
+    if(!buf || fread(buf, 1, size, fp) != (size_t)size)
+    {
+        free(buf);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *out_len = (unsigned int)size;
+    return buf;
+}
+
+static int verify(unsigned char *buf, unsigned int len, H264_NALU *nalus, unsigned int *offsets)
+{
+    int ref_count = legacy_scan(buf, len, offsets, MAX_NALUS);
+    int count = H264ScanNALUs(buf, len, nalus, MAX_NALUS);
+    int failures = 0;
+    int i, j;
+
+    // 빈 NAL (연속 start code) 은 목록에서 빠지므로 비어 있지 않은 것만 비교
+    for(i = 0, j = 0; i < ref_count; i++)
+    {
+        unsigned int off = offsets[i];
+        unsigned int next = (i + 1 < ref_count) ? offsets[i + 1] - 3 : len;
+        while(next > off && buf[next - 1] == 0)
+            next--;
+        if(next == off)
+            continue;
+        if(j >= count || nalus[j].offset != off || nalus[j].size != next - off ||
+           nalus[j].nal_unit_type != (buf[off] & 0x1F))
+        {
+            printf("불일치: NAL %d offset=%u size=%u\n", j, off, next - off);
+            failures++;
+            break;
+        }
+        j++;
+    }
+    if(!failures && j != count)
+    {
+        printf("불일치: NAL 개수 %d != %d\n", count, j);
+        failures++;
+    }
+
+    // FindNextH264StartCode 가 기존 루프와 같은 위치를 반환하는지
+    if(!failures)
+    {
+        unsigned char *p = buf, *q = buf;
+        while(p != buf + len)
+        {
+            p = FindNextH264StartCode(p, buf + len);
+            q = legacy_find_start_code(q, buf + len);
+            if(p != q)
+            {
+                printf("불일치: FindNextH264StartCode %ld != %ld\n", (long)(p - buf), (long)(q - buf));
+                failures++;
+                break;
+            }
+        }
+    }
+
+    printf("검증: NAL %d개, %s\n", count, failures ? "실패" : "기준 구현과 일치");
+    return failures;
+}
+
+static int verify_rbsp(unsigned char *buf, unsigned int len, H264_NALU *nalus, int count)
+{
+    unsigned char *tmp = (unsigned char*)malloc(len);
+    unsigned char *ref = (unsigned char*)malloc(len);
+    int failures = 0;
+    int i;
+
+    for(i = 0; i < count && !failures; i++)
+    {
+        const unsigned char *src = buf + nalus[i].offset;
+        unsigned int n, k, m = 0, zeros = 0;
+
+        for(k = 0; k < nalus[i].size; k++)
+        {
+            if(zeros >= 2 && src[k] == 3)
+            {
+                zeros = 0;
+                continue;
+            }
+            zeros = src[k] ? 0 : zeros + 1;
+            ref[m++] = src[k];
+        }
+
+        n = H264NaluToRbsp(src, nalus[i].size, tmp);
+        if(n != m || memcmp(tmp, ref, m) != 0)
+        {
+            printf("불일치: RBSP 변환 NAL %d\n", i);
+            failures++;
+        }
+    }
+
+    free(tmp);
+    free(ref);
+    return failures;
+}
+
+// 파서 검증용 비트 writer (Annex-B 로 내보낼 때 emulation prevention 삽입)
+typedef struct
+{
+    unsigned char buf[512];
+    int bits;
+} BITW;
+
+static void put_bits(BITW *w, unsigned int v, int n)
+{
+    while(n-- > 0)
+    {
+        if((v >> n) & 1)
+            w->buf[w->bits >> 3] |= 0x80 >> (w->bits & 7);
+        w->bits++;
+    }
+}
+
+static void put_ue(BITW *w, unsigned int v)
+{
+    unsigned int x = v + 1;
+    int n = 0;
+
+    while((x >> n) > 1)
+        n++;
+    put_bits(w, 0, n);
+    put_bits(w, x, n + 1);
+}
+
+static unsigned int put_nal(unsigned char *out, BITW *w, int tail)
+{
+    unsigned int i, n = 0, zeros = 0, len;
+
+    put_bits(w, 1, 1);                                  // rbsp_stop_one_bit
+    len = (w->bits + 7) / 8;
+    while(tail-- > 0)                                   // 파서가 읽지 않는 VUI 자리 (긴 SPS 용)
+        w->buf[len++] = 0x5A;
+
+    out[n++] = 0; out[n++] = 0; out[n++] = 0; out[n++] = 1;
+    for(i = 0; i < len; i++)
+    {
+        if(zeros >= 2 && w->buf[i] <= 3)
+        {
+            out[n++] = 3;
+            zeros = 0;
+        }
+        zeros = w->buf[i] ? 0 : zeros + 1;
+        out[n++] = w->buf[i];
+    }
+    return n;
+}
+
+// Baseline SPS. tail 바이트를 덧붙여 H264_PS_RAW_MAX 보다 길게 만들 수 있다
+static unsigned int make_sps(unsigned char *out, int id, int log2_frame_num, int mbs_w, int mbs_h, int tail)
+{
+    BITW w;
+
+    memset(&w, 0, sizeof(w));
+    put_bits(&w, 0x67, 8);
+    put_bits(&w, 66, 8);                                // profile_idc
+    put_bits(&w, 0, 8);
+    put_bits(&w, 30, 8);                                // level_idc
+    put_ue(&w, id);
+    put_ue(&w, log2_frame_num - 4);
+    put_ue(&w, 0);                                      // pic_order_cnt_type
+    put_ue(&w, 0);                                      // log2_max_pic_order_cnt_lsb - 4
+    put_ue(&w, 1);                                      // max_num_ref_frames
+    put_bits(&w, 0, 1);
+    put_ue(&w, mbs_w - 1);
+    put_ue(&w, mbs_h - 1);
+    put_bits(&w, 1, 1);                                 // frame_mbs_only_flag
+    put_bits(&w, 1, 1);                                 // direct_8x8_inference_flag
+    put_bits(&w, 0, 1);                                 // frame_cropping_flag
+    put_bits(&w, 0, 1);                                 // vui_parameters_present_flag
+    return put_nal(out, &w, tail);
+}
+
+static unsigned int make_pps(unsigned char *out, int id, int sps_id)
+{
+    BITW w;
+
+    memset(&w, 0, sizeof(w));
+    put_bits(&w, 0x68, 8);
+    put_ue(&w, id);
+    put_ue(&w, sps_id);
+    put_bits(&w, 0, 2);
+    put_ue(&w, 0);                                      // num_slice_groups_minus1
+    put_ue(&w, 0);
+    put_ue(&w, 0);
+    put_bits(&w, 0, 3);
+    put_ue(&w, 0);                                      // pic_init_qp_minus26 (se 0)
+    put_ue(&w, 0);
+    put_ue(&w, 0);
+    put_bits(&w, 4, 3);                                 // deblocking_filter_control_present_flag
+    return put_nal(out, &w, 0);
+}
+
+static unsigned int make_slice(unsigned char *out, int idr, int pps_id, int log2_frame_num, unsigned int frame_num)
+{
+    BITW w;
+
+    memset(&w, 0, sizeof(w));
+    put_bits(&w, idr ? 0x65 : 0x41, 8);
+    put_ue(&w, 0);                                      // first_mb_in_slice
+    put_ue(&w, idr ? 7 : 5);                            // I / P
+    put_ue(&w, pps_id);
+    put_bits(&w, frame_num, log2_frame_num);
+    if(idr)
+        put_ue(&w, 0);                                  // idr_pic_id
+    put_bits(&w, 0, 4);                                 // pic_order_cnt_lsb
+    put_bits(&w, 0x2A5, 10);                            // 슬라이스 데이터 자리
+    return put_nal(out, &w, 0);
+}
+
+// 멀티 스트림처럼 id 가 다른 SPS/PPS 가 번갈아 오는 스트림에서 슬라이스가
+// 자기 PPS 가 가리키는 SPS 로 해석되는지, 긴 SPS 가 캐시를 밀어내지 않는지 확인
+static int verify_parser(void)
+{
+    static const struct { int sps_id, log2_fn, mbs_w, mbs_h, tail; } S[3] = {
+        { 0, 4, 80, 45, 0 },                            // 1280x720
+        { 1, 8, 40, 30, 0 },                            // 640x480
+        { 2, 6, 20, 15, 160 },                          // 320x240, H264_PS_RAW_MAX 보다 긴 SPS
+    };
+    unsigned char frame[1024];
+    H264_PARSER parser;
+    H264_FRAME_INFO info;
+    unsigned long hits;
+    int failures = 0;
+    int round, k;
+
+    memset(&parser, 0, sizeof(parser));
+    for(round = 0; round < 8; round++)
+    {
+        for(k = 0; k < 3; k++)
+        {
+            unsigned int n = 0;
+            unsigned int fn = (round * 3 + k) & ((1u << S[k].log2_fn) - 1);
+            int idr = (round % 2 == 0);
+
+            if(idr)
+            {
+                n += make_sps(frame + n, S[k].sps_id, S[k].log2_fn, S[k].mbs_w, S[k].mbs_h, S[k].tail);
+                n += make_pps(frame + n, 10 + k, S[k].sps_id);
+            }
+            n += make_slice(frame + n, idr, 10 + k, S[k].log2_fn, fn);
+
+            if(H264ParseFrame(&parser, frame, n, &info) != 0 ||
+               info.width != S[k].mbs_w * 16 || info.height != S[k].mbs_h * 16 ||
+               info.frame_num != fn || info.keyframe != idr)
+            {
+                printf("불일치: 파서 스트림 %d 회차 %d (%dx%d frame_num %u)\n",
+                       k, round, info.width, info.height, info.frame_num);
+                failures++;
+            }
+        }
+    }
+
+    // IDR 4 회: 짧은 SPS 2 + PPS 3 은 두 번째부터 캐시 적중, 긴 SPS 는 매번 해석하되
+    // 같은 슬롯을 다시 써서 짧은 SPS 를 밀어내지 않는다
+    hits = parser.ps_cache_hits;
+    if(hits != 3 * 5 || parser.ps_parsed != 6 + 3)
+    {
+        printf("불일치: 파라미터 셋 캐시 적중 %lu / 해석 %lu\n", hits, parser.ps_parsed);
+        failures++;
+    }
+
+    printf("검증: 파서 (SPS id 별 슬라이스 해석, 긴 SPS 비캐시) %s\n", failures ? "실패" : "일치");
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    int iterations = 20;
+    unsigned int len = 0;
+    unsigned char *buf;
+    int epb = 0;
+    int i, count = 0, failures;
+
+    if(argc >= 2 && strcmp(argv[1], "-") != 0) path = argv[1];
+    if(argc >= 3) iterations = atoi(argv[2]);
+    if(iterations <= 0)
+    {
+        printf("사용법: %s [file.h264|-] [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    if(path)
+    {
+        buf = load_file(path, &len);
+        if(!buf)
+        {
+            printf("파일을 읽을 수 없음: %s\n", path);
+            return 2;
+        }
+    }
+    else
+    {
+        buf = make_stream(64 * 1024 * 1024, &len, &epb);
+        if(!buf)
+        {
+            printf("메모리 할당 실패\n");
+            return 2;
+        }
+    }
+
+    H264_NALU *nalus = (H264_NALU*)malloc(sizeof(H264_NALU) * MAX_NALUS);
+    unsigned int *offsets = (unsigned int*)malloc(sizeof(unsigned int) * MAX_NALUS);
+    if(!nalus || !offsets)
+    {
+        printf("메모리 할당 실패\n");
+        return 2;
+    }
+
+    printf("=== H264 start code 스캐너 벤치마크 (%s, %.1f MB, %d회) ===\n",
+           path ? path : "합성 스트림", len / (1024.0 * 1024.0), iterations);
+    if(!path)
+        printf("emulation prevention byte: %d개\n", epb);
+
+    failures = verify(buf, len, nalus, offsets);
+    count = H264ScanNALUs(buf, len, nalus, MAX_NALUS);
+    failures += verify_rbsp(buf, len, nalus, count);
+    failures += verify_parser();
+
+    double t0 = now_ms();
+    for(i = 0; i < iterations; i++)
+        legacy_scan(buf, len, offsets, MAX_NALUS);
+    double legacy_ms = (now_ms() - t0) / iterations;
+    printf("%-14s: %8.3f ms  %6.2f GB/s\n", "legacy", legacy_ms, len / (legacy_ms * 1e6));
+
+    t0 = now_ms();
+    for(i = 0; i < iterations; i++)
+        H264ScanNALUs(buf, len, nalus, MAX_NALUS);
+    double scan_ms = (now_ms() - t0) / iterations;
+    printf("%-14s: %8.3f ms  %6.2f GB/s  (legacy 대비 x%.1f)\n", "H264ScanNALUs",
+           scan_ms, len / (scan_ms * 1e6), legacy_ms / scan_ms);
+
+    // RBSP 변환은 NAL 헤더가 작은 SPS/PPS/slice header 용이지만 전체 처리량도 측정
+    unsigned char *rbsp = (unsigned char*)malloc(len);
+    if(rbsp)
+    {
+        t0 = now_ms();
+        for(i = 0; i < iterations; i++)
+            H264NaluToRbsp(buf, len, rbsp);
+        double rbsp_ms = (now_ms() - t0) / iterations;
+        printf("%-14s: %8.3f ms  %6.2f GB/s\n", "H264NaluToRbsp", rbsp_ms, len / (rbsp_ms * 1e6));
+        free(rbsp);
+    }
+
+    free(buf);
+    free(nalus);
+    free(offsets);
+    return failures ? 1 : 0;
+}
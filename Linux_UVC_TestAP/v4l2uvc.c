@@ -32,6 +32,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include "v4l2uvc.h"
+#include "mjpeg_dht.h"
 #include "debug.h"
 
 static int debug = 0;
@@ -96,6 +97,7 @@ init_videoIn (struct vdIn *vd, char *device, int width, int height,
   snprintf (vd->videodevice, 12, "%s", device);
   vd->toggleAvi = 0;
   vd->getPict = 0;
+  vd->bus = NULL;
   vd->signalquit = 1;
   vd->width = width;
   vd->height = height;
@@ -274,10 +276,9 @@ video_disable (struct vdIn *vd)
 }
 
 int
-uvcGrab (struct vdIn *vd)
+uvcDequeue (struct vdIn *vd, struct iovec *iov)
 {
-#define HEADERFRAME1 0xaf
-  int ret;
+  int ret, cnt = 1;
 
   if (!vd->isstreaming)
     if (video_enable (vd))
@@ -290,39 +291,85 @@ uvcGrab (struct vdIn *vd)
     TestAp_Printf(TESTAP_DBG_ERR, "Unable to dequeue buffer (%d).\n", errno);
     goto err;
   }
+  iov[0].iov_base = vd->mem[vd->buf.index];
+  iov[0].iov_len = vd->buf.bytesused;
   switch (vd->formatIn) {
   case V4L2_PIX_FMT_MJPEG:
-
-    memcpy (vd->tmpbuffer, vd->mem[vd->buf.index], HEADERFRAME1);
-    memcpy (vd->tmpbuffer + HEADERFRAME1, dht_data, DHT_SIZE);
-    memcpy (vd->tmpbuffer + HEADERFRAME1 + DHT_SIZE,
-	    vd->mem[vd->buf.index] + HEADERFRAME1,
-	    (vd->buf.bytesused - HEADERFRAME1));
+    /* header | DHT | payload; frames that already carry a DHT (or don't parse) are passed as-is */
+    cnt = MjpegDhtIovec (vd->mem[vd->buf.index], vd->buf.bytesused, dht_data, DHT_SIZE, iov, NULL);
+    if (cnt < 0) {
+      TestAp_Printf(TESTAP_DBG_FLOW, "Unparsable MJPEG frame (%d bytes)\n", vd->buf.bytesused);
+      iov[0].iov_base = vd->mem[vd->buf.index];
+      iov[0].iov_len = vd->buf.bytesused;
+      cnt = 1;
+    }
     if (debug)
       TestAp_Printf(TESTAP_DBG_FLOW, "bytes in used %d \n", vd->buf.bytesused);
     break;
   case V4L2_PIX_FMT_YUYV:
     if (vd->buf.bytesused > vd->framesizeIn)
-      memcpy (vd->framebuffer, vd->mem[vd->buf.index],
-	      (size_t) vd->framesizeIn);
-    else
-      memcpy (vd->framebuffer, vd->mem[vd->buf.index],
-	      (size_t) vd->buf.bytesused);
+      iov[0].iov_len = vd->framesizeIn;
     break;
   default:
+    uvcRequeue (vd);
     goto err;
     break;
   }
+  if (vd->bus) {
+    /* the bus copies straight out of the driver buffer (DHT already spliced in) */
+    FB_META meta;
+    memset (&meta, 0, sizeof (meta));
+    meta.width = vd->width;
+    meta.height = vd->height;
+    meta.pixfmt = vd->formatIn;
+    meta.sequence = vd->buf.sequence;
+    meta.timestamp_us = (unsigned long long) vd->buf.timestamp.tv_sec * 1000000ULL +
+      vd->buf.timestamp.tv_usec;
+    FrameBusPublish (vd->bus, iov, cnt, &meta);
+  }
+  return cnt;
+err:
+  vd->signalquit = 0;
+  return -1;
+}
+
+int
+uvcRequeue (struct vdIn *vd)
+{
+  int ret;
+
   ret = ioctl (vd->fd, VIDIOC_QBUF, &vd->buf);
   if (ret < 0) {
     TestAp_Printf(TESTAP_DBG_ERR, "Unable to requeue buffer (%d).\n", errno);
-    goto err;
+    vd->signalquit = 0;
+    return -1;
   }
-
   return 0;
-err:
-  vd->signalquit = 0;
-  return -1;
+}
+
+int
+uvcGrab (struct vdIn *vd)
+{
+  struct iovec iov[MJPEG_IOV_MAX];
+  int cnt;
+
+  cnt = uvcDequeue (vd, iov);
+  if (cnt < 0)
+    return -1;
+  if (vd->formatIn == V4L2_PIX_FMT_MJPEG) {
+    vd->tmpbytes = MjpegGather (vd->tmpbuffer, vd->framesizeIn, iov, cnt);
+    if (vd->tmpbytes == 0)
+      TestAp_Printf(TESTAP_DBG_ERR, "MJPEG frame (%d bytes) larger than tmpbuffer\n", vd->buf.bytesused);
+  } else {
+    memcpy (vd->framebuffer, iov[0].iov_base, iov[0].iov_len);
+  }
+  return uvcRequeue (vd);
+}
+
+void
+uvcSetFrameBus (struct vdIn *vd, FRAME_BUS *bus)
+{
+  vd->bus = bus;
 }
 
 int
@@ -22,6 +22,9 @@
 #                                                                              #
 *******************************************************************************/
 
+#include <sys/uio.h>
+#include "frame_bus.h"
+
 #define NB_BUFFER 16
 #define DHT_SIZE 420
 
@@ -37,6 +40,7 @@ struct vdIn {
   struct v4l2_requestbuffers rb;
   void *mem[NB_BUFFER];
   unsigned char *tmpbuffer;
+  int tmpbytes;			/* MJPEG frame in tmpbuffer (DHT inserted) */
   unsigned char *framebuffer;
   int isstreaming;
   int grabmethod;
@@ -48,6 +52,7 @@ struct vdIn {
   int signalquit;
   int toggleAvi;
   int getPict;
+  FRAME_BUS *bus;		/* optional: every dequeued frame is also published here */
 
 };
 
@@ -55,6 +60,14 @@ int
   init_videoIn (struct vdIn *vd, char *device, int width, int height,
 		int format, int grabmethod);
 int uvcGrab (struct vdIn *vd);
+/* Zero-copy grab: fills iov (MJPEG_IOV_MAX entries) with the frame still in
+ * the driver buffer (MJPEG: header, DHT, payload) and returns the count.
+ * The buffer is owned by the caller until uvcRequeue(). */
+int uvcDequeue (struct vdIn *vd, struct iovec *iov);
+int uvcRequeue (struct vdIn *vd);
+/* Publish every frame seen by uvcDequeue()/uvcGrab() to a shared-memory
+ * frame bus (NULL detaches). The bus stays owned by the caller. */
+void uvcSetFrameBus (struct vdIn *vd, FRAME_BUS *bus);
 int close_v4l2 (struct vdIn *vd);
 
 int v4l2GetControl (int fd, int control);
@@ -0,0 +1,295 @@
+//----------------------------------------------//
+//	XU 컨트롤 전송 계층 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./xu_ctrl_bench [ms_per_transfer]
+// 실제 카메라 대신 ioctl 을 가로채는 모의 장치(스위치 명령 + 레지스터)를 두고
+// 시작 설정 / 상태 폴링 / 설정 재적용 시나리오를 세 가지 모드로 실행한다.
+//   legacy : 캐시 끔 (접근마다 스위치 + 데이터 전송 2회)
+//   cache  : 스위치 생략 + 섀도 레지스터
+//   txn    : cache + 시작 설정을 트랜잭션으로 묶음
+// 모드마다 최종 장치 레지스터 상태와 읽은 값이 legacy 와 같은지 확인하고
+// 불일치가 있으면 1 을 반환한다. 시간은 전송 횟수 x 전송당 지연(기본 2ms)으로 계산한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include "h264_xu_ctrls.h"
+
+// h264_xu_ctrls.c 가 참조하는 TestAP 전역
+struct H264Format *gH264fmt = NULL;
+int Dbg_Param = 0;
+
+#define MOCK_FD			42
+#define MOCK_MAX_REGS	64
+
+// 모의 장치: (unit, selector) 마다 현재 선택된 sub, (unit, selector, sub) 마다 레지스터 값
+typedef struct {
+    unsigned char unit, selector, sub;
+    unsigned char data[XU_CTRL_MAX_SIZE];
+} mock_reg_t;
+
+typedef struct {
+    unsigned char unit, selector;
+    int cur_sub;
+    int expect_data;
+} mock_sel_t;
+
+static struct {
+    mock_reg_t regs[MOCK_MAX_REGS];
+    int nregs;
+    mock_sel_t sels[16];
+    int nsels;
+    unsigned int transfers;
+    unsigned int switches;
+    unsigned int iframes;
+} mock;
+
+static mock_sel_t *mock_sel(unsigned char unit, unsigned char selector)
+{
+    int i;
+    for (i = 0; i < mock.nsels; i++)
+        if (mock.sels[i].unit == unit && mock.sels[i].selector == selector)
+            return &mock.sels[i];
+    mock.sels[mock.nsels].unit = unit;
+    mock.sels[mock.nsels].selector = selector;
+    mock.sels[mock.nsels].cur_sub = -1;
+    return &mock.sels[mock.nsels++];
+}
+
+static mock_reg_t *mock_reg(unsigned char unit, unsigned char selector, int sub)
+{
+    int i;
+    for (i = 0; i < mock.nregs; i++)
+        if (mock.regs[i].unit == unit && mock.regs[i].selector == selector && mock.regs[i].sub == sub)
+            return &mock.regs[i];
+    if (mock.nregs == MOCK_MAX_REGS)
+        return NULL;
+    memset(&mock.regs[mock.nregs], 0, sizeof(mock_reg_t));
+    mock.regs[mock.nregs].unit = unit;
+    mock.regs[mock.nregs].selector = selector;
+    mock.regs[mock.nregs].sub = (unsigned char)sub;
+    return &mock.regs[mock.nregs++];
+}
+
+static int mock_ioctl(int fd, unsigned long request, void *arg)
+{
+    struct uvc_xu_control_query *q = (struct uvc_xu_control_query *)arg;
+    mock_sel_t *s;
+    mock_reg_t *r;
+
+    if (fd != MOCK_FD || request != UVCIOC_CTRL_QUERY || q->size > XU_CTRL_MAX_SIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    mock.transfers++;
+    s = mock_sel(q->unit, q->selector);
+
+    if (q->query == UVC_SET_CUR && !s->expect_data && q->data[0] == 0x9A) {
+        s->cur_sub = q->data[1];
+        s->expect_data = 1;
+        mock.switches++;
+        return 0;
+    }
+    s->expect_data = 0;
+    if (s->cur_sub < 0) {
+        errno = EIO;
+        return -1;
+    }
+
+    // I-frame 요청은 값이 아닌 동작 (9422: USR H264 sub 0x04)
+    if (q->query == UVC_SET_CUR && q->unit == XU_RERVISION_USR_ID &&
+        q->selector == XU_RERVISION_USR_H264_CTRL && s->cur_sub == 0x04) {
+        mock.iframes++;
+        return 0;
+    }
+
+    r = mock_reg(q->unit, q->selector, s->cur_sub);
+    if (!r) {
+        errno = ENOSPC;
+        return -1;
+    }
+    if (q->query == UVC_SET_CUR)
+        memcpy(r->data, q->data, q->size);
+    else if (q->query == UVC_GET_CUR)
+        memcpy(q->data, r->data, q->size);
+    else {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+// 시나리오에서 읽은 값 (모드 간 비교용)
+typedef struct {
+    double bitrate;
+    int qp, mode, qp_after;
+    unsigned int gop;
+    unsigned char osd_line_size, osd_block_size, osd_font, osd_border, osd_en_line, osd_en_block, mirror;
+    unsigned int line_row, line_col, block_row, block_col;
+    double poll_bitrate_sum;
+    long poll_qp_sum;
+} readback_t;
+
+static int apply_startup(int fd, int use_txn)
+{
+    int err = 0;
+
+    if (use_txn)
+        XU_Txn_Begin(fd);
+    // 옵션 파싱 순서상 같은 값이 두 번 설정되는 경우 (기본값 → 사용자 값)
+    err |= XU_H264_Set_BitRate(fd, 1000000.0);
+    err |= XU_H264_Set_Mode(fd, 1);
+    err |= XU_H264_Set_BitRate(fd, 2000000.0);
+    err |= XU_H264_Set_QP(fd, 28);
+    err |= XU_H264_Set_GOP(fd, 30);
+    err |= XU_OSD_Set_Size(fd, 2, 3);
+    err |= XU_OSD_Set_Color(fd, 1, 0);
+    err |= XU_OSD_Set_Enable(fd, 1, 1);
+    err |= XU_OSD_Set_Start_Position(fd, 1, 4, 8);
+    err |= XU_IMG_Set_Mirror(fd, 1);
+    if (use_txn)
+        err |= XU_Txn_Commit(fd);
+    return err;
+}
+
+static int run_scenario(int use_txn, readback_t *rb)
+{
+    int fd = MOCK_FD;
+    int i, err = 0;
+
+    memset(rb, 0, sizeof(*rb));
+
+    err |= apply_startup(fd, use_txn);
+
+    // 설정 확인
+    err |= XU_H264_Get_BitRate(fd, &rb->bitrate);
+    err |= XU_H264_Get_Mode(fd, &rb->mode);
+    err |= XU_H264_Get_QP(fd, &rb->qp);
+    err |= XU_H264_Get_GOP(fd, &rb->gop);
+    err |= XU_OSD_Get_Size(fd, &rb->osd_line_size, &rb->osd_block_size);
+    err |= XU_OSD_Get_Color(fd, &rb->osd_font, &rb->osd_border);
+    err |= XU_OSD_Get_Enable(fd, &rb->osd_en_line, &rb->osd_en_block);
+    err |= XU_OSD_Get_Start_Position(fd, &rb->line_row, &rb->line_col, &rb->block_row, &rb->block_col);
+    err |= XU_IMG_Get_Mirror(fd, &rb->mirror);
+
+    // 상태 모니터처럼 주기적으로 읽기
+    for (i = 0; i < 100; i++) {
+        double br;
+        int qp;
+        err |= XU_H264_Get_BitRate(fd, &br);
+        err |= XU_H264_Get_QP(fd, &qp);
+        rb->poll_bitrate_sum += br;
+        rb->poll_qp_sum += qp;
+        if (i % 25 == 0)
+            err |= XU_H264_Set_IFRAME(fd);
+    }
+
+    // 같은 설정 재적용 (재연결/설정 다이얼로그 확인 등)
+    err |= apply_startup(fd, use_txn);
+
+    // 값 변경 후 읽기는 반드시 새 값이어야 한다
+    err |= XU_H264_Set_QP(fd, 30);
+    err |= XU_H264_Get_QP(fd, &rb->qp_after);
+
+    return err;
+}
+
+static void mock_reset(void)
+{
+    memset(&mock, 0, sizeof(mock));
+}
+
+static int regs_equal(const mock_reg_t *a, int na, const mock_reg_t *b, int nb)
+{
+    int i, j;
+
+    if (na != nb)
+        return 0;
+    for (i = 0; i < na; i++) {
+        for (j = 0; j < nb; j++)
+            if (a[i].unit == b[j].unit && a[i].selector == b[j].selector && a[i].sub == b[j].sub)
+                break;
+        if (j == nb || memcmp(a[i].data, b[j].data, XU_CTRL_MAX_SIZE) != 0)
+            return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[3] = { "legacy", "cache", "txn" };
+    double ms_per_transfer = 2.0;
+    mock_reg_t ref_regs[MOCK_MAX_REGS];
+    int ref_nregs = 0;
+    unsigned int ref_iframes = 0, legacy_transfers = 0;
+    readback_t ref_rb, rb;
+    int mode, failures = 0;
+
+    if (argc >= 2)
+        ms_per_transfer = atof(argv[1]);
+    if (ms_per_transfer <= 0) {
+        printf("사용법: %s [ms_per_transfer]\n", argv[0]);
+        return 2;
+    }
+
+    chip_id = CHIP_RER9422;
+    XU_Set_Ioctl(mock_ioctl);
+
+    printf("=== XU 컨트롤 전송 벤치마크 (전송당 %.1f ms 가정) ===\n", ms_per_transfer);
+
+    for (mode = 0; mode < 3; mode++) {
+        struct XU_Cache_Stats st;
+        int err;
+
+        mock_reset();
+        XU_Cache_Enable(mode != 0);
+        err = run_scenario(mode == 2, &rb);
+        if (err) {
+            printf("%s: XU 호출 실패\n", names[mode]);
+            failures++;
+        }
+
+        if (mode == 0) {
+            memcpy(ref_regs, mock.regs, sizeof(ref_regs));
+            ref_nregs = mock.nregs;
+            ref_iframes = mock.iframes;
+            ref_rb = rb;
+            legacy_transfers = mock.transfers;
+
+            if (rb.qp != 28 || rb.gop != 30 || rb.mode != 1 || rb.qp_after != 30 ||
+                rb.bitrate != 2000000.0 || rb.osd_line_size != 2 || rb.osd_block_size != 3 ||
+                rb.osd_font != 1 || rb.osd_en_line != 1 || rb.mirror != 1) {
+                printf("legacy: 읽은 값이 설정 값과 다름 (qp=%d gop=%u mode=%d bitrate=%.0f)\n",
+                       rb.qp, rb.gop, rb.mode, rb.bitrate);
+                failures++;
+            }
+        } else {
+            if (!regs_equal(ref_regs, ref_nregs, mock.regs, mock.nregs)) {
+                printf("불일치: %s 최종 레지스터 상태가 legacy 와 다름\n", names[mode]);
+                failures++;
+            }
+            if (memcmp(&ref_rb, &rb, sizeof(rb)) != 0) {
+                printf("불일치: %s 읽은 값이 legacy 와 다름 (qp_after=%d)\n", names[mode], rb.qp_after);
+                failures++;
+            }
+            if (mock.iframes != ref_iframes) {
+                printf("불일치: %s I-frame 요청 %u != %u\n", names[mode], mock.iframes, ref_iframes);
+                failures++;
+            }
+        }
+
+        printf("%-7s: 전송 %4u회 (스위치 %4u)  %8.1f ms", names[mode], mock.transfers, mock.switches,
+               mock.transfers * ms_per_transfer);
+        if (mode != 0 && XU_Cache_Get_Stats(MOCK_FD, &st) == 0)
+            printf("  x%.1f  [캐시 읽기 %u, 스위치 생략 %u, 쓰기 생략 %u, 병합 %u]",
+                   (double)legacy_transfers / mock.transfers, st.read_hits, st.switch_skipped,
+                   st.write_skipped, st.write_coalesced);
+        printf("\n");
+    }
+
+    printf("검증: %s\n", failures ? "실패" : "모든 모드의 장치 상태와 읽은 값이 legacy 와 일치");
+    return failures ? 1 : 0;
+}
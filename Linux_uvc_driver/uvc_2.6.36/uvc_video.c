@@ -598,8 +598,15 @@ static void uvc_video_decode_isoc(struct urb *urb, struct uvc_streaming *stream,
 			if(((stream->dev->RER_Chip == CHIP_9421)||(stream->dev->RER_Chip == CHIP_9422))&& 
 				stream->cur_format->fcc == V4L2_PIX_FMT_H264)
 			{
-				mem = stream->queue.mem + buf->buf.m.offset+4;
-				h264_decode_seq_parameter_set(mem, buf->buf.bytesused, &width, &height);
+				unsigned char *nal;
+
+				/* Only the leading SPS is decoded here; PPS/slice
+				 * parsing is left to user space. */
+				mem = stream->queue.mem + buf->buf.m.offset;
+				nal = FindNextH264StartCode(mem, mem + buf->buf.bytesused);
+				width = height = 0;
+				if (nal < mem + buf->buf.bytesused && (nal[0] & 0x1F) == 7)
+					h264_decode_seq_parameter_set(nal, mem + buf->buf.bytesused - nal, &width, &height);
 				//printk("[w,h]=[%d,%d](%d)\n", width, height,  buf->buf.bytesused);
 				buf->buf.reserved = ((width & 0xFFFF) << 16) | (height & 0xFFFF);
 			}
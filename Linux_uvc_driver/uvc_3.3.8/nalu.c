@@ -3,198 +3,789 @@
 //----------------------------------------------//
 
 #include <linux/videodev2.h>
+#ifdef __KERNEL__
+#include <linux/string.h>
+#else
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NALU_SCAN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NALU_SCAN_NEON
+#endif
+#endif
 #include "nalu.h"
 
+// [p, end) 에서 00 00 <last> 패턴의 첫 위치를 찾는다 (없으면 end)
+// last 가 1 이면 start code, 3 이면 emulation prevention 시퀀스
+static const unsigned char* nalu_find_00xx(const unsigned char *p, const unsigned char *end, unsigned char last)
+{
+#if defined(NALU_SCAN_SSE2)
+    // 16 바이트씩 p[i]==0 && p[i+1]==0 && p[i+2]==last 를 한 번에 비교
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tail = _mm_set1_epi8((char)last);
+
+    while(end - p >= 18)
+    {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p + 2));
+        __m128i m = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                  _mm_cmpeq_epi8(b2, tail));
+        int mask = _mm_movemask_epi8(m);
+        if(mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#elif defined(NALU_SCAN_NEON)
+    const uint8x16_t tail = vdupq_n_u8(last);
+
+    while(end - p >= 18)
+    {
+        uint8x16_t b0 = vld1q_u8(p);
+        uint8x16_t b1 = vld1q_u8(p + 1);
+        uint8x16_t b2 = vld1q_u8(p + 2);
+        uint8x16_t m = vandq_u8(vandq_u8(vceqq_u8(b0, vdupq_n_u8(0)), vceqq_u8(b1, vdupq_n_u8(0))),
+                                vceqq_u8(b2, tail));
+        uint64x2_t m64 = vreinterpretq_u64_u8(m);
+        unsigned long long lo = vgetq_lane_u64(m64, 0);
+        unsigned long long hi = vgetq_lane_u64(m64, 1);
+        if(lo)
+            return p + (__builtin_ctzll(lo) >> 3);
+        if(hi)
+            return p + 8 + (__builtin_ctzll(hi) >> 3);
+        p += 16;
+    }
+#else
+    // SIMD 를 쓸 수 없으면 (커널 포함) memchr 로 마지막 바이트 후보만 확인
+    const unsigned char *q = p + 2;
+
+    while(q < end)
+    {
+        q = (const unsigned char*)memchr(q, last, end - q);
+        if(!q)
+            return end;
+        if(q[-1] == 0 && q[-2] == 0)
+            return q - 2;
+        q++;
+    }
+    return end;
+#endif
+
+    // 나머지 (18 바이트 미만): p[2] 가 0/last 가 아니면 3 바이트씩 건너뜀
+    while(end - p >= 3)
+    {
+        if(p[2] > last)
+            p += 3;
+        else if(p[2] == last && p[1] == 0 && p[0] == 0)
+            return p;
+        else
+            p++;
+    }
+    return end;
+}
+
 unsigned char* FindNextH264StartCode(unsigned char *pBuf, unsigned char *pBuf_end)
 {
-    unsigned char zero_cnt;
-    zero_cnt = 0;
+    const unsigned char *p;
+
+    if(pBuf >= pBuf_end)
+        return pBuf_end;
+
+    p = nalu_find_00xx(pBuf, pBuf_end, 1);
+    if(p == pBuf_end)
+        return pBuf_end;
+
+    // 4 바이트 start code 의 앞 0 은 00 00 01 바로 앞에 있으므로 별도 처리 불필요
+    return (unsigned char*)p + 3;
+}
+
+int H264ScanNALUs(const unsigned char *pBuf, unsigned int nLen, H264_NALU *pNalus, int max_nalus)
+{
+    const unsigned char *end = pBuf + nLen;
+    const unsigned char *sc;
+    int count = 0;
 
-    while(1)
+    if(!pBuf || !pNalus || max_nalus <= 0)
+        return 0;
+
+    sc = nalu_find_00xx(pBuf, end, 1);
+    while(sc != end && count < max_nalus)
     {
-        if(pBuf == pBuf_end)
+        const unsigned char *payload = sc + 3;
+        const unsigned char *next = nalu_find_00xx(payload, end, 1);
+        const unsigned char *stop = next;
+        H264_NALU *nalu = &pNalus[count];
+
+        // 다음 4 바이트 start code 의 첫 0 과 trailing_zero_8bits 는 NAL 에 포함하지 않는다
+        while(stop > payload && stop[-1] == 0)
+            stop--;
+
+        nalu->offset = (unsigned int)(payload - pBuf);
+        nalu->size = (unsigned int)(stop - payload);
+        nalu->start_code_len = (sc > pBuf && sc[-1] == 0) ? 4 : 3;
+        if(nalu->size > 0)
         {
-            break;
+            nalu->nal_ref_idc = (payload[0] >> 5) & 0x03;
+            nalu->nal_unit_type = payload[0] & 0x1F;
+            count++;
         }
-        if(*pBuf == 0)
+        sc = next;
+    }
+    return count;
+}
+
+unsigned int H264NaluToRbsp(const unsigned char *pSrc, unsigned int nLen, unsigned char *pDst)
+{
+    const unsigned char *p = pSrc;
+    const unsigned char *end = pSrc + nLen;
+    unsigned int out = 0;
+
+    while(p < end)
+    {
+        const unsigned char *epb = nalu_find_00xx(p, end, 3);
+        unsigned int chunk;
+
+        if(epb == end)
         {
-            zero_cnt++;
+            chunk = (unsigned int)(end - p);
+            memmove(pDst + out, p, chunk);
+            out += chunk;
+            break;
         }
-        else if((zero_cnt >= 3) && (*pBuf == 1))
+
+        // 00 00 까지 복사하고 03 은 버린다
+        chunk = (unsigned int)(epb + 2 - p);
+        memmove(pDst + out, p, chunk);
+        out += chunk;
+        p = epb + 3;
+    }
+    return out;
+}
+
+//----------------------------------------------//
+//	Bit reader (Exp-Golomb)						//
+//----------------------------------------------//
+
+void H264BitReaderInit(H264_BITREADER *br, const unsigned char *buf, unsigned int len)
+{
+    br->buf = buf;
+    br->len = buf ? len : 0;
+    br->idx = 0;
+    br->zeros = 0;
+    br->cache = 0;
+    br->bits = 0;
+    br->pad = 0;
+    br->error = 0;
+}
+
+// 캐시를 57 비트 이상으로 채운다. 00 00 03 의 03 은 여기서 버려진다
+static void h264_br_refill(H264_BITREADER *br)
+{
+    while(br->bits <= 56)
+    {
+        unsigned int byte;
+
+        if(br->idx < br->len)
         {
-            zero_cnt = 0;
-            pBuf++;
-            break;
+            byte = br->buf[br->idx++];
+            if(br->zeros >= 2 && byte == 3)
+            {
+                br->zeros = 0;
+                continue;
+            }
+            br->zeros = byte ? 0 : br->zeros + 1;
         }
         else
         {
-            zero_cnt = 0;
+            // 버퍼 끝: 0 으로 채우되 실제로 읽으면 error
+            byte = 0;
+            br->pad += 8;
         }
-        pBuf++;
+        br->cache |= (unsigned long long)byte << (56 - br->bits);
+        br->bits += 8;
     }
-    return pBuf;
 }
 
-unsigned int Ue(unsigned char *pBuff, unsigned int nLen, unsigned int *nStartBit)
+unsigned int H264ReadBits(H264_BITREADER *br, int n)
 {
-	unsigned int i=0;
-    unsigned int nZeroNum = 0;
-	unsigned long dwRet = 0;
-	
-    while((*nStartBit) < (nLen * 8))
-    {
-        if(pBuff[(*nStartBit) / 8] & (0x80 >> ((*nStartBit) % 8)))
-            break;
+    unsigned int val;
 
-        nZeroNum++;
-        (*nStartBit)++;
+    if(n <= 0)
+        return 0;
+    if(n > 32 || br->error)
+    {
+        br->error = 1;
+        return 0;
+    }
+    if(br->bits < n)
+        h264_br_refill(br);
+    if(n > br->bits - br->pad)
+    {
+        br->error = 1;
+        return 0;
     }
-    (*nStartBit) ++;
 
-    for(i=0; i<nZeroNum; i++)
+    val = (unsigned int)(br->cache >> (64 - n));
+    br->cache <<= n;
+    br->bits -= n;
+    return val;
+}
+
+unsigned int H264ReadUe(H264_BITREADER *br)
+{
+    int lz = 0;
+
+    if(br->error)
+        return 0;
+    if(br->bits < 33)
+        h264_br_refill(br);
+
+    while(lz < 32 && !(br->cache & (0x8000000000000000ULL >> lz)))
+        lz++;
+    if(lz >= 32)
     {
-        dwRet <<= 1;
-        if((pBuff[(*nStartBit) / 8]) & (0x80 >> ((*nStartBit) % 8)))
-        {
-            dwRet += 1;
-        }
-        (*nStartBit)++;
+        // 32 비트를 넘는 코드는 H.264 구문에 없다
+        br->error = 1;
+        return 0;
     }
-    return (1 << nZeroNum) - 1 + dwRet;
+
+    H264ReadBits(br, lz + 1);
+    if(lz == 0)
+        return 0;
+    return ((1u << lz) - 1) + H264ReadBits(br, lz);
 }
 
-int Se(unsigned char *pBuff, unsigned int nLen, unsigned int *nStartBit)
+int H264ReadSe(H264_BITREADER *br)
 {
-#if 0
-    int UeVal=Ue(pBuff,nLen,*nStartBit);
-	double k=UeVal;
-	int nValue=ceil(k/2);
-    
-    if(UeVal % 2==0)
-        nValue=-nValue;
+    unsigned int k = H264ReadUe(br);
 
-    return nValue;
-#else
-    int UeVal=Ue(pBuff,nLen,nStartBit);
-	int nValue = UeVal / 2;
-	if( nValue > 0) nValue += UeVal & 0x01;
-	if(UeVal % 2==0)
-		nValue=-nValue;
+    if(k & 1)
+        return (int)((k >> 1) + 1);
+    return -(int)(k >> 1);
+}
 
-	return nValue;
-#endif
+//----------------------------------------------//
+//	SPS / PPS / slice header					//
+//----------------------------------------------//
+
+static void h264_skip_scaling_list(H264_BITREADER *br, int size)
+{
+    int last = 8, next = 8, j;
+
+    for(j = 0; j < size && !br->error; j++)
+    {
+        if(next != 0)
+            next = (last + H264ReadSe(br) + 256) % 256;
+        if(next != 0)
+            last = next;
+    }
 }
 
-unsigned long u(unsigned int BitCount,unsigned char * buf,unsigned int *nStartBit)
+int H264ParseSps(const unsigned char *pNal, unsigned int nLen, H264_SPS *pSps)
 {
-    unsigned long dwRet = 0;
-	unsigned int i = 0;
-	
-	for(i=0; i<BitCount; i++)
+    H264_BITREADER br;
+    unsigned int val, crop_left = 0, crop_right = 0, crop_top = 0, crop_bottom = 0;
+    int crop_unit_x, crop_unit_y, i;
+
+    if(!pNal || nLen < 4 || !pSps)
+        return -1;
+
+    memset(pSps, 0, sizeof(*pSps));
+    H264BitReaderInit(&br, pNal, nLen);
+
+    H264ReadBits(&br, 1);                               // forbidden_zero_bit
+    H264ReadBits(&br, 2);                               // nal_ref_idc
+    if(H264ReadBits(&br, 5) != 7)                       // nal_unit_type
+        return -1;
+
+    pSps->profile_idc = H264ReadBits(&br, 8);
+    pSps->constraint_flags = H264ReadBits(&br, 8);
+    pSps->level_idc = H264ReadBits(&br, 8);
+    val = H264ReadUe(&br);
+    if(val > 31)
+        return -1;
+    pSps->seq_parameter_set_id = val;
+
+    pSps->chroma_format_idc = 1;
+    pSps->bit_depth_luma = 8;
+    pSps->bit_depth_chroma = 8;
+
+    switch(pSps->profile_idc)
     {
-        dwRet <<= 1;
-        if(buf[(*nStartBit) / 8] & (0x80 >> ((*nStartBit) % 8)))
+    case 100: case 110: case 122: case 244: case 44:
+    case 83: case 86: case 118: case 128: case 138:
+    case 139: case 134: case 135:
+        val = H264ReadUe(&br);
+        if(val > 3)
+            return -1;
+        pSps->chroma_format_idc = val;
+        if(val == 3)
+            pSps->separate_colour_plane_flag = H264ReadBits(&br, 1);
+        val = H264ReadUe(&br);
+        if(val > 6)
+            return -1;
+        pSps->bit_depth_luma = 8 + val;
+        val = H264ReadUe(&br);
+        if(val > 6)
+            return -1;
+        pSps->bit_depth_chroma = 8 + val;
+        H264ReadBits(&br, 1);                           // qpprime_y_zero_transform_bypass_flag
+        if(H264ReadBits(&br, 1))                        // seq_scaling_matrix_present_flag
         {
-            dwRet += 1;
+            for(i = 0; i < ((pSps->chroma_format_idc != 3) ? 8 : 12); i++)
+            {
+                if(H264ReadBits(&br, 1))                // seq_scaling_list_present_flag
+                    h264_skip_scaling_list(&br, (i < 6) ? 16 : 64);
+            }
         }
-        (*nStartBit)++;
+        break;
+    default:
+        break;
+    }
+
+    val = H264ReadUe(&br);
+    if(val > 12)
+        return -1;
+    pSps->log2_max_frame_num = 4 + val;
+
+    val = H264ReadUe(&br);
+    if(val > 2)
+        return -1;
+    pSps->pic_order_cnt_type = val;
+    if(val == 0)
+    {
+        val = H264ReadUe(&br);
+        if(val > 12)
+            return -1;
+        pSps->log2_max_pic_order_cnt_lsb = 4 + val;
+    }
+    else if(val == 1)
+    {
+        unsigned int cycle;
+
+        pSps->delta_pic_order_always_zero_flag = H264ReadBits(&br, 1);
+        H264ReadSe(&br);                                // offset_for_non_ref_pic
+        H264ReadSe(&br);                                // offset_for_top_to_bottom_field
+        cycle = H264ReadUe(&br);
+        if(cycle > 255)
+            return -1;
+        for(val = 0; val < cycle && !br.error; val++)
+            H264ReadSe(&br);                            // offset_for_ref_frame
     }
 
-    return dwRet;
+    val = H264ReadUe(&br);
+    if(val > 32)
+        return -1;
+    pSps->max_num_ref_frames = val;
+    H264ReadBits(&br, 1);                               // gaps_in_frame_num_value_allowed_flag
+
+    val = H264ReadUe(&br);
+    if(val >= 1024)
+        return -1;
+    pSps->pic_width_in_mbs = val + 1;
+    val = H264ReadUe(&br);
+    if(val >= 1024)
+        return -1;
+    pSps->pic_height_in_map_units = val + 1;
+
+    pSps->frame_mbs_only_flag = H264ReadBits(&br, 1);
+    if(!pSps->frame_mbs_only_flag)
+        H264ReadBits(&br, 1);                           // mb_adaptive_frame_field_flag
+    H264ReadBits(&br, 1);                               // direct_8x8_inference_flag
+    if(H264ReadBits(&br, 1))                            // frame_cropping_flag
+    {
+        crop_left = H264ReadUe(&br);
+        crop_right = H264ReadUe(&br);
+        crop_top = H264ReadUe(&br);
+        crop_bottom = H264ReadUe(&br);
+    }
+
+    if(br.error)
+        return -1;
+
+    // ChromaArrayType 에 따른 크롭 단위
+    if(pSps->separate_colour_plane_flag || pSps->chroma_format_idc == 0)
+    {
+        crop_unit_x = 1;
+        crop_unit_y = 2 - pSps->frame_mbs_only_flag;
+    }
+    else
+    {
+        crop_unit_x = (pSps->chroma_format_idc == 3) ? 1 : 2;
+        crop_unit_y = ((pSps->chroma_format_idc == 1) ? 2 : 1) * (2 - pSps->frame_mbs_only_flag);
+    }
+
+    pSps->width = pSps->pic_width_in_mbs * 16;
+    pSps->height = (2 - pSps->frame_mbs_only_flag) * pSps->pic_height_in_map_units * 16;
+    if((crop_left + crop_right) * crop_unit_x >= (unsigned int)pSps->width ||
+       (crop_top + crop_bottom) * crop_unit_y >= (unsigned int)pSps->height)
+        return -1;
+    pSps->width -= (crop_left + crop_right) * crop_unit_x;
+    pSps->height -= (crop_top + crop_bottom) * crop_unit_y;
+
+    return 0;
 }
 
-bool h264_decode_seq_parameter_set(unsigned char * buf, unsigned int nLen, int *Width, int *Height)
+int H264ParsePps(const unsigned char *pNal, unsigned int nLen, H264_PPS *pPps)
 {
-    unsigned int StartBit=0;
-    int forbidden_zero_bit, nal_ref_idc, nal_unit_type;
-	
-	forbidden_zero_bit=u(1,buf,&StartBit);
-    nal_ref_idc=u(2,buf,&StartBit);
-    nal_unit_type=u(5,buf,&StartBit);
-	
-    if(nal_unit_type==7)
-    {
-		int profile_idc, constraint_set0_flag, constraint_set1_flag, constraint_set2_flag, constraint_set3_flag, reserved_zero_4bits, level_idc;
-		int seq_parameter_set_id, log2_max_frame_num_minus4, pic_order_cnt_type;
-		int num_ref_frames, gaps_in_frame_num_value_allowed_flag, pic_width_in_mbs_minus1, pic_height_in_map_units_minus1;
-		
-		profile_idc=u(8,buf,&StartBit);
-        constraint_set0_flag=u(1,buf,&StartBit);//(buf[1] & 0x80)>>7;
-        constraint_set1_flag=u(1,buf,&StartBit);//(buf[1] & 0x40)>>6;
-        constraint_set2_flag=u(1,buf,&StartBit);//(buf[1] & 0x20)>>5;
-        constraint_set3_flag=u(1,buf,&StartBit);//(buf[1] & 0x10)>>4;
-        reserved_zero_4bits=u(4,buf,&StartBit);
-        level_idc=u(8,buf,&StartBit);
-		
-        seq_parameter_set_id=Ue(buf,nLen,&StartBit);
-
-        if((profile_idc == 100) || (profile_idc == 110) || (profile_idc == 122) || (profile_idc == 144))
+    H264_BITREADER br;
+    unsigned int val, i;
+
+    if(!pNal || nLen < 2 || !pPps)
+        return -1;
+
+    memset(pPps, 0, sizeof(*pPps));
+    H264BitReaderInit(&br, pNal, nLen);
+
+    H264ReadBits(&br, 3);
+    if(H264ReadBits(&br, 5) != 8)
+        return -1;
+
+    val = H264ReadUe(&br);
+    if(val > 255)
+        return -1;
+    pPps->pic_parameter_set_id = val;
+    val = H264ReadUe(&br);
+    if(val > 31)
+        return -1;
+    pPps->seq_parameter_set_id = val;
+    pPps->entropy_coding_mode_flag = H264ReadBits(&br, 1);
+    pPps->bottom_field_pic_order_in_frame_present_flag = H264ReadBits(&br, 1);
+
+    val = H264ReadUe(&br);
+    if(val > 7)
+        return -1;
+    pPps->num_slice_groups = val + 1;
+    if(val > 0)
+    {
+        unsigned int map_type = H264ReadUe(&br);
+
+        if(map_type == 0)
+        {
+            for(i = 0; i <= val; i++)
+                H264ReadUe(&br);                        // run_length_minus1
+        }
+        else if(map_type == 2)
         {
-			int chroma_format_idc, residual_colour_transform_flag, bit_depth_luma_minus8, bit_depth_chroma_minus8, qpprime_y_zero_transform_bypass_flag;
-			int seq_scaling_matrix_present_flag;
-            
-			chroma_format_idc=Ue(buf,nLen,&StartBit);
-			residual_colour_transform_flag = 0;
-			
-            if(chroma_format_idc == 3)
-                residual_colour_transform_flag=u(1,buf,&StartBit);
-
-            bit_depth_luma_minus8=Ue(buf,nLen,&StartBit);
-            bit_depth_chroma_minus8=Ue(buf,nLen,&StartBit);
-            qpprime_y_zero_transform_bypass_flag=u(1,buf,&StartBit);
-            seq_scaling_matrix_present_flag=u(1,buf,&StartBit);
-
-            if(seq_scaling_matrix_present_flag)
+            for(i = 0; i < val; i++)
             {
-				int seq_scaling_list_present_flag[8];
-				int i=0;
-                for( i = 0; i < 8; i++ )
-                {
-                    seq_scaling_list_present_flag[i]=u(1,buf,&StartBit);
-                }
+                H264ReadUe(&br);                        // top_left
+                H264ReadUe(&br);                        // bottom_right
             }
         }
-        
-		log2_max_frame_num_minus4=Ue(buf,nLen,&StartBit);
-        pic_order_cnt_type=Ue(buf,nLen,&StartBit);
-		
-        if(pic_order_cnt_type == 0)
+        else if(map_type >= 3 && map_type <= 5)
         {
-            int log2_max_pic_order_cnt_lsb_minus4=Ue(buf,nLen,&StartBit);
+            H264ReadBits(&br, 1);                       // slice_group_change_direction_flag
+            H264ReadUe(&br);                            // slice_group_change_rate_minus1
         }
-        else if(pic_order_cnt_type == 1)
+        else if(map_type == 6)
         {
-            int delta_pic_order_always_zero_flag=u(1,buf,&StartBit);
-            int offset_for_non_ref_pic=Se(buf,nLen,&StartBit);
-            int offset_for_top_to_bottom_field=Se(buf,nLen,&StartBit);
-            int num_ref_frames_in_pic_order_cnt_cycle=Ue(buf,nLen,&StartBit);
-#if 0
-            int *offset_for_ref_frame=new int[num_ref_frames_in_pic_order_cnt_cycle];
-            for(int i = 0; i < num_ref_frames_in_pic_order_cnt_cycle; i++)
-                offset_for_ref_frame[i]=Se(buf,nLen,&StartBit);
-
-            delete [] offset_for_ref_frame;
-#else
-			int offset_for_ref_frame = 0;
-			int i = 0;
-            for(i = 0; i < num_ref_frames_in_pic_order_cnt_cycle; i++)
-                offset_for_ref_frame =Se(buf,nLen,&StartBit);
-#endif
+            unsigned int units = H264ReadUe(&br) + 1;
+            int id_bits = 0;
 
+            while((1u << id_bits) < val + 1)
+                id_bits++;
+            if(units > 1024 * 1024)
+                return -1;
+            for(i = 0; i < units && !br.error; i++)
+                H264ReadBits(&br, id_bits);             // slice_group_id
         }
+        else if(map_type > 6)
+        {
+            return -1;
+        }
+    }
+
+    val = H264ReadUe(&br);
+    if(val > 31)
+        return -1;
+    pPps->num_ref_idx_l0_default_active = val + 1;
+    val = H264ReadUe(&br);
+    if(val > 31)
+        return -1;
+    pPps->num_ref_idx_l1_default_active = val + 1;
+    pPps->weighted_pred_flag = H264ReadBits(&br, 1);
+    pPps->weighted_bipred_idc = H264ReadBits(&br, 2);
+    pPps->pic_init_qp = 26 + H264ReadSe(&br);
+    pPps->pic_init_qs = 26 + H264ReadSe(&br);
+    pPps->chroma_qp_index_offset = H264ReadSe(&br);
+    pPps->deblocking_filter_control_present_flag = H264ReadBits(&br, 1);
+    pPps->constrained_intra_pred_flag = H264ReadBits(&br, 1);
+    pPps->redundant_pic_cnt_present_flag = H264ReadBits(&br, 1);
 
-        num_ref_frames=Ue(buf,nLen,&StartBit);
-        gaps_in_frame_num_value_allowed_flag=u(1,buf,&StartBit);
-        pic_width_in_mbs_minus1=Ue(buf,nLen,&StartBit);
-        pic_height_in_map_units_minus1=Ue(buf,nLen,&StartBit);
+    return br.error ? -1 : 0;
+}
+
+int H264ParseSliceHeader(const unsigned char *pNal, unsigned int nLen, const H264_SPS *pSps, H264_SLICE_HEADER *pSh)
+{
+    H264_BITREADER br;
+    unsigned int val;
 
-        *Width=(pic_width_in_mbs_minus1+1)*16;
-        *Height=(pic_height_in_map_units_minus1+1)*16;
-		
-        return true;
+    if(!pNal || nLen < 2 || !pSps || !pSh)
+        return -1;
+
+    memset(pSh, 0, sizeof(*pSh));
+    H264BitReaderInit(&br, pNal, nLen);
+
+    H264ReadBits(&br, 1);
+    pSh->nal_ref_idc = H264ReadBits(&br, 2);
+    pSh->nal_unit_type = H264ReadBits(&br, 5);
+    if(pSh->nal_unit_type != 1 && pSh->nal_unit_type != 5)
+        return -1;
+    pSh->idr = (pSh->nal_unit_type == 5);
+
+    pSh->first_mb_in_slice = H264ReadUe(&br);
+    val = H264ReadUe(&br);
+    if(val > 9)
+        return -1;
+    pSh->slice_type = val % 5;
+    val = H264ReadUe(&br);
+    if(val > 255)
+        return -1;
+    pSh->pic_parameter_set_id = val;
+
+    if(pSps->separate_colour_plane_flag)
+        H264ReadBits(&br, 2);                           // colour_plane_id
+    pSh->frame_num = H264ReadBits(&br, pSps->log2_max_frame_num);
+    if(!pSps->frame_mbs_only_flag)
+    {
+        pSh->field_pic_flag = H264ReadBits(&br, 1);
+        if(pSh->field_pic_flag)
+            pSh->bottom_field_flag = H264ReadBits(&br, 1);
     }
-    else
+    if(pSh->idr)
+        pSh->idr_pic_id = H264ReadUe(&br);
+    if(pSps->pic_order_cnt_type == 0)
+        pSh->pic_order_cnt_lsb = H264ReadBits(&br, pSps->log2_max_pic_order_cnt_lsb);
+
+    return br.error ? -1 : 0;
+}
+
+//----------------------------------------------//
+//	Per-stream parser with SPS/PPS cache		//
+//----------------------------------------------//
+
+static unsigned int h264_ps_hash(const unsigned char *p, unsigned int len)
+{
+    unsigned int hash = 2166136261u;
+    unsigned int i;
+
+    for(i = 0; i < len; i++)
     {
-        return false;
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 같은 바이트의 파라미터 셋이 캐시에 있으면 슬롯 번호, 없으면 -1
+// 원본 전체를 보관할 수 없는 긴 셋은 해시가 같아도 같다고 볼 수 없으므로 항상 -1
+static int h264_ps_lookup(const H264_PS_KEY *keys, const unsigned char *nal, unsigned int len, unsigned int hash)
+{
+    int i;
+
+    if(len > H264_PS_RAW_MAX)
+        return -1;
+
+    for(i = 0; i < H264_PS_CACHE_SIZE; i++)
+    {
+        if(keys[i].valid && keys[i].hash == hash && keys[i].len == len &&
+           memcmp(keys[i].raw, nal, len) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void h264_ps_store(H264_PS_KEY *key, const unsigned char *nal, unsigned int len, unsigned int hash)
+{
+    key->hash = hash;
+    key->len = len;
+    if(len <= H264_PS_RAW_MAX)
+        memcpy(key->raw, nal, len);
+    key->valid = 1;
+}
+
+// 새 셋을 넣을 슬롯: 캐시하지 않는 긴 셋은 같은 id 의 슬롯을 덮어써서 다른 셋을 밀어내지 않는다
+static int h264_ps_slot(const H264_PS_KEY *keys, const unsigned char *slot_by_id, unsigned int id,
+                        unsigned int len, int *next_slot)
+{
+    int slot = slot_by_id[id] - 1;
+
+    if(len > H264_PS_RAW_MAX && slot >= 0 && keys[slot].valid && keys[slot].len > H264_PS_RAW_MAX)
+        return slot;
+
+    slot = *next_slot;
+    *next_slot = (slot + 1) % H264_PS_CACHE_SIZE;
+    return slot;
+}
+
+static int h264_parser_sps(H264_PARSER *p, const unsigned char *nal, unsigned int len)
+{
+    unsigned int hash = h264_ps_hash(nal, len);
+    int slot = h264_ps_lookup(p->sps_key, nal, len, hash);
+    H264_SPS sps;
+
+    if(slot >= 0)
+    {
+        p->ps_cache_hits++;
+        p->active_sps = slot;
+        p->sps_slot[p->sps[slot].seq_parameter_set_id] = slot + 1;
+        return 0;
+    }
+
+    if(H264ParseSps(nal, len, &sps) < 0)
+        return -1;
+
+    slot = h264_ps_slot(p->sps_key, p->sps_slot, sps.seq_parameter_set_id, len, &p->next_sps_slot);
+    p->sps[slot] = sps;
+    h264_ps_store(&p->sps_key[slot], nal, len, hash);
+    p->active_sps = slot;
+    p->sps_slot[sps.seq_parameter_set_id] = slot + 1;
+    p->ps_parsed++;
+    return 0;
+}
+
+static int h264_parser_pps(H264_PARSER *p, const unsigned char *nal, unsigned int len)
+{
+    unsigned int hash = h264_ps_hash(nal, len);
+    int slot = h264_ps_lookup(p->pps_key, nal, len, hash);
+    H264_PPS pps;
+
+    if(slot >= 0)
+    {
+        p->ps_cache_hits++;
+        p->active_pps = slot;
+        p->pps_slot[p->pps[slot].pic_parameter_set_id] = slot + 1;
+        return 0;
     }
+
+    if(H264ParsePps(nal, len, &pps) < 0)
+        return -1;
+
+    slot = h264_ps_slot(p->pps_key, p->pps_slot, pps.pic_parameter_set_id, len, &p->next_pps_slot);
+    p->pps[slot] = pps;
+    h264_ps_store(&p->pps_key[slot], nal, len, hash);
+    p->active_pps = slot;
+    p->pps_slot[pps.pic_parameter_set_id] = slot + 1;
+    p->ps_parsed++;
+    return 0;
+}
+
+// 슬라이스의 pic_parameter_set_id -> PPS -> seq_parameter_set_id 로 SPS 슬롯을 찾는다. 없으면 -1
+// 슬롯이 다른 id 의 셋으로 바뀌었으면 그 id 의 셋은 더 이상 없는 것으로 본다
+static int h264_parser_slice_sps(const H264_PARSER *p, const unsigned char *nal, unsigned int len)
+{
+    H264_BITREADER br;
+    unsigned int pps_id;
+    int pps_slot, sps_slot;
+
+    H264BitReaderInit(&br, nal, len);
+    H264ReadBits(&br, 8);                               // NAL 헤더
+    H264ReadUe(&br);                                    // first_mb_in_slice
+    H264ReadUe(&br);                                    // slice_type
+    pps_id = H264ReadUe(&br);
+    if(br.error || pps_id > 255)
+        return -1;
+
+    pps_slot = p->pps_slot[pps_id] - 1;
+    if(pps_slot < 0 || !p->pps_key[pps_slot].valid || p->pps[pps_slot].pic_parameter_set_id != pps_id)
+        return -1;
+
+    sps_slot = p->sps_slot[p->pps[pps_slot].seq_parameter_set_id] - 1;
+    if(sps_slot < 0 || !p->sps_key[sps_slot].valid ||
+       p->sps[sps_slot].seq_parameter_set_id != p->pps[pps_slot].seq_parameter_set_id)
+        return -1;
+    return sps_slot;
+}
+
+int H264ParseFrame(H264_PARSER *pParser, const unsigned char *pBuf, unsigned int nLen, H264_FRAME_INFO *pInfo)
+{
+    const unsigned char *end = pBuf + nLen;
+    const unsigned char *sc;
+
+    if(!pParser || !pBuf || !pInfo)
+        return -1;
+
+    memset(pInfo, 0, sizeof(*pInfo));
+    pInfo->slice_type = -1;
+
+    sc = nalu_find_00xx(pBuf, end, 1);
+    while(sc != end)
+    {
+        const unsigned char *nal = sc + 3;
+        const unsigned char *next;
+        unsigned int type;
+
+        if(nal >= end)
+            break;
+        type = nal[0] & 0x1F;
+
+        if(type == 1 || type == 5)
+        {
+            // 슬라이스 데이터는 스캔하지 않는다: 헤더는 NAL 앞부분에 있으므로
+            // 버퍼 끝까지를 길이로 주고 비트 리더의 경계 검사에 맡긴다
+            H264_SLICE_HEADER sh;
+            int sps_slot = h264_parser_slice_sps(pParser, nal, (unsigned int)(end - nal));
+
+            if(sps_slot >= 0 &&
+               H264ParseSliceHeader(nal, (unsigned int)(end - nal), &pParser->sps[sps_slot], &sh) == 0)
+            {
+                pParser->active_sps = sps_slot;
+                pInfo->slice_type = sh.slice_type;
+                pInfo->frame_num = sh.frame_num;
+                pInfo->keyframe = sh.idr;
+
+                if(sh.idr)
+                {
+                    if(pParser->idr_seen)
+                        pParser->gop_length = pParser->frames_since_idr;
+                    pParser->idr_seen = 1;
+                    pParser->frames_since_idr = 0;
+                }
+                pInfo->frames_since_idr = pParser->frames_since_idr;
+                pParser->frames_since_idr++;
+            }
+            break;
+        }
+
+        next = nalu_find_00xx(nal, end, 1);
+        if(type == 7)
+        {
+            const unsigned char *stop = next;
+            while(stop > nal && stop[-1] == 0)
+                stop--;
+            if(h264_parser_sps(pParser, nal, (unsigned int)(stop - nal)) == 0)
+                pInfo->has_sps = 1;
+        }
+        else if(type == 8)
+        {
+            const unsigned char *stop = next;
+            while(stop > nal && stop[-1] == 0)
+                stop--;
+            if(h264_parser_pps(pParser, nal, (unsigned int)(stop - nal)) == 0)
+                pInfo->has_pps = 1;
+        }
+        sc = next;
+    }
+
+    pInfo->gop_length = pParser->gop_length;
+    if(!pParser->sps_key[pParser->active_sps].valid)
+        return -1;
+    pInfo->width = pParser->sps[pParser->active_sps].width;
+    pInfo->height = pParser->sps[pParser->active_sps].height;
+    return 0;
+}
+
+bool h264_decode_seq_parameter_set(unsigned char * buf, unsigned int nLen, int *Width, int *Height)
+{
+    H264_SPS sps;
+
+    if(H264ParseSps(buf, nLen, &sps) < 0)
+        return false;
+
+    *Width = sps.width;
+    *Height = sps.height;
+    return true;
 }
@@ -1189,8 +1189,15 @@ static void uvc_video_decode_isoc(struct urb *urb, struct uvc_streaming *stream,
 			if(((stream->dev->RER_Chip == CHIP_RER9421)||(stream->dev->RER_Chip == CHIP_RER9422))&& 
 				stream->cur_format->fcc == V4L2_PIX_FMT_H264)
 			{
-				mem = buf->mem+4;
-				h264_decode_seq_parameter_set(mem, buf->bytesused, &width, &height);
+				unsigned char *nal;
+
+				/* Only the leading SPS is decoded here; PPS/slice
+				 * parsing is left to user space. */
+				mem = buf->mem;
+				nal = FindNextH264StartCode(mem, mem + buf->bytesused);
+				width = height = 0;
+				if (nal < mem + buf->bytesused && (nal[0] & 0x1F) == 7)
+					h264_decode_seq_parameter_set(nal, mem + buf->bytesused - nal, &width, &height);
 				//printk("[w,h]=[%d,%d](%d)\n", width, height,  buf->bytesused);
 				buf->buf.v4l2_buf.reserved = ((width & 0xFFFF) << 16) | (height & 0xFFFF);
 			}
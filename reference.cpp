@@ -1,9 +1,10 @@
 #include <iostream>
 #include <string>
 #include <chrono>
-#include <thread>
+#include <cstdio>
 #include <signal.h>
 #include <opencv2/opencv.hpp>
+#include "text_overlay.h"   // test_linux_sdk/text_overlay.c (글리프 아틀라스 텍스트 오버레이)
 
 // ===== 설정 영역 (여기서 원하는 값으로 변경하세요) =====
 const int TARGET_WIDTH = 1280;    // 원하는 해상도 너비
@@ -61,26 +62,36 @@ int main(int argc, char** argv) {
     // 윈도우 생성
     cv::namedWindow("USB Webcam - Real-time Viewer", cv::WINDOW_AUTOSIZE);
     
+    // 정보 텍스트: 글자가 바뀐 줄만 다시 렌더링해 프레임에 합성 (설정 줄은 한 번만)
+    ovl_t *overlay = ovl_create(2);
+    char text[OVL_MAX_TEXT];
+    snprintf(text, sizeof(text), "Config: %dx%d @ %dfps", width, height, target_fps);
+    ovl_set_text(overlay, 1, 10, 42, 1, 0x00FFFF, text);
+    
     int frame_count = 0;
     auto start_time = std::chrono::high_resolution_clock::now();
-    auto last_frame_time = start_time;
     
-    // FPS 제어를 위한 프레임 간격 계산 (마이크로초 단위)
-    int frame_interval_us = 1000000 / target_fps; // 마이크로초 단위
+    // FPS 제어: 벽시계 sleep 대신 장치 timestamp 기준 출력 슬롯
+    // (sleep 은 카메라 주기와 어긋나면서 드라이버 큐에 프레임이 쌓여 지연이 늘어난다)
+    double frame_interval_ms = 1000.0 / target_fps;
+    double next_slot_ms = 0;
     
     while (keep_running) {
-        // FPS 제어: 프레임 간격만큼 대기
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed_since_last = std::chrono::duration_cast<std::chrono::microseconds>(now - last_frame_time);
+        // 프레임 읽기: grab() 은 장치가 프레임을 줄 때까지 블록
+        if (!cap.grab()) {
+            std::cout << "Error: Could not read frame" << std::endl;
+            break;
+        }
         
-        if (elapsed_since_last.count() < frame_interval_us) {
-            int sleep_us = frame_interval_us - elapsed_since_last.count();
-            std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+        // 카메라가 목표 FPS 보다 빠르면 슬롯 전에 온 프레임은 디코드 없이 건너뜀
+        double ts_ms = cap.get(cv::CAP_PROP_POS_MSEC);  // V4L2 백엔드: 버퍼 timestamp
+        if (ts_ms > 0 && ts_ms + frame_interval_ms / 4 < next_slot_ms) {
+            continue;
         }
+        next_slot_ms = ts_ms + frame_interval_ms;
         
-        // 프레임 읽기
         cv::Mat frame;
-        cap >> frame;
+        cap.retrieve(frame);
         
         if (frame.empty()) {
             std::cout << "Error: Could not read frame" << std::endl;
@@ -88,7 +99,6 @@ int main(int argc, char** argv) {
         }
         
         frame_count++;
-        last_frame_time = std::chrono::high_resolution_clock::now();
         
         // FPS 계산
         auto current_time = std::chrono::high_resolution_clock::now();
@@ -96,22 +106,17 @@ int main(int argc, char** argv) {
         double actual_fps_calculated = frame_count / (elapsed_time.count() / 1000.0);
         
         // 프레임 정보 표시
-        std::string info_text = "Frame: " + std::to_string(frame_count) + 
-                               ", FPS: " + std::to_string(static_cast<int>(actual_fps_calculated)) + 
-                               " (Target: " + std::to_string(target_fps) + ")" +
-                               ", Size: " + std::to_string(frame.cols) + "x" + std::to_string(frame.rows);
-        
-        cv::putText(frame, info_text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 255, 0), 2);
-        
-        // 추가 정보 표시
-        std::string config_text = "Config: " + std::to_string(width) + "x" + std::to_string(height) + 
-                                 " @ " + std::to_string(target_fps) + "fps";
-        cv::putText(frame, config_text, cv::Point(10, 60), cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 255, 0), 2);
+        snprintf(text, sizeof(text), "Frame: %d, FPS: %d (Target: %d), Size: %dx%d",
+                 frame_count, static_cast<int>(actual_fps_calculated), target_fps, frame.cols, frame.rows);
+        ovl_set_text(overlay, 0, 10, 12, 1, 0x00FF00, text);
+        if (frame.type() == CV_8UC3) {
+            ovl_composite(overlay, frame.data, static_cast<int>(frame.step), frame.cols, frame.rows, OVL_FMT_BGR24);
+        }
         
         // 화면에 표시
         cv::imshow("USB Webcam - Real-time Viewer", frame);
         
-        // 키 입력 처리 (FPS 제어를 위해 waitKey 시간 조정)
+        // 키 입력 처리 (프레임 간격은 장치가 정하므로 이벤트만 처리)
         int key = cv::waitKey(1);
         if (key == 'q' || key == 'Q') {
             break;
@@ -126,6 +131,7 @@ int main(int argc, char** argv) {
     // 정리
     cap.release();
     cv::destroyAllWindows();
+    ovl_destroy(overlay);
     
     auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now() - start_time);
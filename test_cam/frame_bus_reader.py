@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# 공유 메모리 프레임 버스 리더 (Linux_UVC_TestAP/frame_bus.h 와 같은 배치)
+#
+# 카메라를 연 프로세스가 게시하는 프레임을 복사 없이 읽는다:
+#   ./test_cam_pipe /dev/video0 640 480 0 cam0      (또는 test_cam_mjpeg, frame_bus_bench --serve cam0)
+#   python3 frame_bus_reader.py cam0 [--latest] [--show]
+#
+# /dev/shm/<name> 을 읽기 전용으로 매핑하고, 새 프레임은 futex 로 기다린다 (폴링 없음).
+# frame.data 는 공유 메모리를 가리키는 memoryview 라서 라이터가 그 슬롯을 덮어쓰기 전까지만 유효하다.
+# 다 쓴 뒤 reader.valid(frame) 로 확인한다 (C 의 FrameBusValid).
+import ctypes
+import ctypes.util
+import os
+import platform
+import struct
+import sys
+import time
+
+FB_MAGIC = 0x42435655
+FB_VERSION = 1
+FB_FLAG_KEYFRAME = 0x01
+FB_FLAG_EOS = 0x80
+
+HEADER = struct.Struct("<8IQQ2Q")           # FB_HEADER, 64 바이트
+SLOT = struct.Struct("<3Q6I4I")             # FB_SLOT_DESC, 64 바이트
+NOTIFY_OFFSET = 28                          # FB_HEADER.notify
+PUBLISHED_OFFSET = 32                       # FB_HEADER.published
+
+V4L2_PIX_FMT_YUYV = 0x56595559
+V4L2_PIX_FMT_MJPEG = 0x47504A4D
+
+PROT_READ = 1
+MAP_SHARED = 1
+FUTEX_WAIT = 0
+SYS_FUTEX = {"x86_64": 202, "aarch64": 98, "armv7l": 240, "armv6l": 240, "i686": 240, "i386": 240}
+
+_libc = ctypes.CDLL(ctypes.util.find_library("c"), use_errno=True)
+_libc.mmap.restype = ctypes.c_void_p
+_libc.mmap.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_long]
+_libc.munmap.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+_libc.syscall.restype = ctypes.c_long
+
+
+class _Timespec(ctypes.Structure):
+    _fields_ = [("tv_sec", ctypes.c_long), ("tv_nsec", ctypes.c_long)]
+
+
+class Frame:
+    __slots__ = ("data", "bytes", "width", "height", "pixfmt", "sequence", "flags",
+                 "frame", "timestamp_us", "publish_ns", "skipped")
+
+
+class FrameBusReader:
+    def __init__(self, name, latest=False):
+        path = "/dev/shm/" + name.lstrip("/")
+        fd = os.open(path, os.O_RDONLY)
+        try:
+            size = os.fstat(fd).st_size
+            hdr = HEADER.unpack(os.pread(fd, HEADER.size, 0))
+            if hdr[0] != FB_MAGIC or hdr[1] != FB_VERSION:
+                raise ValueError("%s: not a frame bus" % path)
+            addr = _libc.mmap(None, size, PROT_READ, MAP_SHARED, fd, 0)
+            if addr in (None, ctypes.c_void_p(-1).value):
+                raise OSError(ctypes.get_errno(), "mmap " + path)
+        finally:
+            os.close(fd)
+
+        self.addr = addr
+        self.size = size
+        self.mem = memoryview((ctypes.c_char * size).from_address(addr)).cast("B")
+        (_, _, self.slot_count, self.slot_size, self.slot_stride,
+         self.data_offset, self.writer_pid) = hdr[:7]
+        self.latest = latest
+        self.cursor = self._published()
+        self.frames = 0
+        self.skipped = 0
+        self.torn = 0
+        self._futex = SYS_FUTEX.get(platform.machine())
+
+    def _published(self):
+        return struct.unpack_from("<Q", self.mem, PUBLISHED_OFFSET)[0]
+
+    def _seq(self, frame):
+        return struct.unpack_from("<Q", self.mem, HEADER.size + (frame % self.slot_count) * SLOT.size)[0]
+
+    def _wait(self, seen, timeout):
+        if self._futex is None:
+            time.sleep(0.001)
+            return
+        ts = None
+        if timeout is not None:
+            ts = _Timespec(int(timeout), int((timeout % 1) * 1e9))
+        _libc.syscall(ctypes.c_long(self._futex), ctypes.c_void_p(self.addr + NOTIFY_OFFSET),
+                      ctypes.c_int(FUTEX_WAIT), ctypes.c_uint(seen),
+                      ctypes.byref(ts) if ts else None, None, ctypes.c_int(0))
+
+    def next(self, timeout=None):
+        """다음 프레임 (latest=True 면 최신 프레임). 시간 초과면 None"""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while True:
+            # notify 를 먼저 읽어야 그 뒤의 게시를 놓치지 않는다
+            seen = struct.unpack_from("<I", self.mem, NOTIFY_OFFSET)[0]
+            pub = self._published()
+            if pub > self.cursor:
+                target = self.cursor
+                if self.latest:
+                    target = pub - 1
+                elif pub - target > self.slot_count - 1:
+                    target = pub - (self.slot_count - 1)
+                d = SLOT.unpack_from(self.mem, HEADER.size + (target % self.slot_count) * SLOT.size)
+                if d[0] != 2 * target + 2 or self._seq(target) != d[0]:
+                    # 설명자를 읽는 사이 덮어써짐
+                    self.skipped += target + 1 - self.cursor
+                    self.cursor = target + 1
+                    continue
+                f = Frame()
+                (_, f.timestamp_us, f.publish_ns, nbytes, f.width, f.height,
+                 f.pixfmt, f.sequence, f.flags) = d[:9]
+                f.bytes = min(nbytes, self.slot_size)
+                off = self.data_offset + (target % self.slot_count) * self.slot_stride
+                f.data = self.mem[off:off + f.bytes]
+                f.frame = target
+                f.skipped = target - self.cursor
+                self.skipped += f.skipped
+                self.frames += 1
+                self.cursor = target + 1
+                return f
+
+            remaining = None
+            if deadline is not None:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    return None
+            self._wait(seen, remaining)
+
+    def valid(self, frame):
+        """frame 을 다 쓴 뒤 호출: 그동안 덮어써지지 않았으면 True"""
+        if self._seq(frame.frame) == 2 * frame.frame + 2:
+            return True
+        self.torn += 1
+        return False
+
+    def close(self):
+        if self.mem is not None:
+            self.mem.release()
+            self.mem = None
+            _libc.munmap(ctypes.c_void_p(self.addr), self.size)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    if not args:
+        print("usage: %s NAME [--latest] [--show]" % sys.argv[0])
+        return 1
+    latest = "--latest" in sys.argv
+    show = "--show" in sys.argv
+    cv2 = np = None
+    if show:
+        import cv2
+        import numpy as np
+
+    with FrameBusReader(args[0], latest=latest) as bus:
+        print("bus %s: %d slots x %d bytes, writer pid %d" % (args[0], bus.slot_count, bus.slot_size, bus.writer_pid))
+        t0 = time.monotonic()
+        last = t0
+        count = 0
+        lat_sum = 0.0
+        while True:
+            f = bus.next(timeout=5.0)
+            if f is None:
+                print("timeout")
+                break
+            if f.flags & FB_FLAG_EOS:
+                print("EOS")
+                break
+            # 게시 → 받음 지연 (같은 CLOCK_MONOTONIC)
+            lat_sum += time.clock_gettime_ns(time.CLOCK_MONOTONIC) - f.publish_ns
+            count += 1
+
+            if show:
+                if f.pixfmt == V4L2_PIX_FMT_YUYV:
+                    # 머리가 붙어 있으면 (frame_bus_bench) 끝에서부터 자른다
+                    n = f.width * f.height * 2
+                    yuyv = np.frombuffer(f.data[f.bytes - n:], dtype=np.uint8).reshape(f.height, f.width, 2)
+                    img = cv2.cvtColor(yuyv, cv2.COLOR_YUV2BGR_YUYV)
+                elif f.pixfmt == V4L2_PIX_FMT_MJPEG:
+                    img = cv2.imdecode(np.frombuffer(f.data, dtype=np.uint8), cv2.IMREAD_COLOR)
+                else:
+                    img = None
+                # 변환이 끝난 뒤 확인: 덮어써졌으면 보여주지 않는다
+                if img is not None and bus.valid(f):
+                    cv2.imshow("frame bus " + args[0], img)
+                if cv2.waitKey(1) & 0xFF == ord("q"):
+                    break
+            else:
+                bus.valid(f)
+
+            now = time.monotonic()
+            if now - last >= 1.0:
+                print("%.1f fps, frames %d, skipped %d, torn %d, latency %.2f ms" %
+                      (count / (now - t0), bus.frames, bus.skipped, bus.torn, lat_sum / count / 1e6))
+                last = now
+        print("frames %d, skipped %d, torn %d" % (bus.frames, bus.skipped, bus.torn))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -8,57 +8,13 @@
 
 #include "../Linux_UVC_TestAP/v4l2uvc.h"
 #include "../Linux_UVC_TestAP/debug.h"
+#include "../test_linux_sdk/color_convert.h"
 
 int Dbg_Param = TESTAP_DBG_ERR;
 
 static volatile int keep_running = 1;
 static void handle_sigint(int sig) { (void)sig; keep_running = 0; }
 
-// YUYV to RGB 변환 함수
-void yuyv_to_rgb(uint8_t *yuyv, uint8_t *rgb, int width, int height) {
-    int i, j;
-    int y, u, v;
-    int r, g, b;
-    
-    for (i = 0; i < height; i++) {
-        for (j = 0; j < width; j += 2) {
-            // YUYV 포맷: Y0 U Y1 V
-            y = yuyv[i * width * 2 + j * 2 + 0];
-            u = yuyv[i * width * 2 + j * 2 + 1];
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            v = yuyv[i * width * 2 + j * 2 + 3];
-            
-            // YUV to RGB 변환 (첫 번째 픽셀)
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + j * 3 + 0] = r;
-            rgb[i * width * 3 + j * 3 + 1] = g;
-            rgb[i * width * 3 + j * 3 + 2] = b;
-            
-            // 두 번째 픽셀
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + (j + 1) * 3 + 0] = r;
-            rgb[i * width * 3 + (j + 1) * 3 + 1] = g;
-            rgb[i * width * 3 + (j + 1) * 3 + 2] = b;
-        }
-    }
-}
-
 static gboolean update_image(GtkWidget *drawing_area, struct vdIn *cam, uint8_t *rgb_buffer) {
     // 프레임 읽기
     int ret = uvcGrab(cam);
@@ -67,8 +23,9 @@ static gboolean update_image(GtkWidget *drawing_area, struct vdIn *cam, uint8_t
         return G_SOURCE_REMOVE;
     }
     
-    // YUYV to RGB 변환
-    yuyv_to_rgb(cam->pFramebuffer, rgb_buffer, cam->width, cam->height);
+    // YUYV to RGB 변환 (cairo RGB24 는 픽셀당 32비트 BGRX)
+    yuyv_convert(cam->pFramebuffer, cam->width * 2, rgb_buffer, cam->width * 4,
+                 cam->width, cam->height, CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_FULL);
     
     // GTK 위젯 업데이트
     gtk_widget_queue_draw(drawing_area);
@@ -83,7 +40,7 @@ static gboolean draw_callback(GtkWidget *widget, cairo_t *cr, gpointer data) {
     
     // RGB 데이터를 cairo surface로 변환
     cairo_surface_t *surface = cairo_image_surface_create_for_data(
-        rgb_buffer, CAIRO_FORMAT_RGB24, width, height, width * 3);
+        rgb_buffer, CAIRO_FORMAT_RGB24, width, height, width * 4);
     
     // 화면에 그리기
     cairo_set_source_surface(cr, surface, 0, 0);
@@ -136,7 +93,7 @@ int main(int argc, char** argv) {
     printf("Press Ctrl+C to quit\n");
     
     // RGB 버퍼 할당
-    uint8_t* rgb_buffer = malloc(width * height * 3);
+    uint8_t* rgb_buffer = malloc(width * height * 4);
     if (!rgb_buffer) {
         printf("Failed to allocate RGB buffer\n");
         return -1;
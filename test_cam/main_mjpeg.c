@@ -8,6 +8,7 @@
 #include <linux/videodev2.h>
 
 #include "../Linux_UVC_TestAP/v4l2uvc.h"
+#include "../Linux_UVC_TestAP/mjpeg_dht.h"
 #include "../Linux_UVC_TestAP/debug.h"
 
 int Dbg_Param = TESTAP_DBG_ERR;
@@ -25,11 +26,14 @@ int main(int argc, char** argv) {
 	int height = 480;
 	unsigned int pixfmt = V4L2_PIX_FMT_MJPEG; // MJPEG 포맷 사용
 	int use_ffplay = 1;
+	const char* bus_name = NULL;	// 공유 메모리 프레임 버스 이름 (/dev/shm/<name>)
+	FRAME_BUS* bus = NULL;
 
 	if (argc >= 2) device = argv[1];
 	if (argc >= 3) width = atoi(argv[2]);
 	if (argc >= 4) height = atoi(argv[3]);
 	if (argc >= 5) use_ffplay = atoi(argv[4]);
+	if (argc >= 6) bus_name = argv[5];
 
 	Dbg_Param = TESTAP_DBG_ERR;
 
@@ -46,11 +50,23 @@ int main(int argc, char** argv) {
 	height = cam.height;
 	fprintf(stderr, "Camera initialized: %dx%d (MJPEG)\n", width, height);
 
+	// 다른 로컬 프로세스(x11_viewer bus:<name>, frame_bus_reader.py)가 같은 프레임을 읽도록 게시
+	if (bus_name) {
+		bus = FrameBusCreate(bus_name, FB_DEFAULT_SLOTS, cam.framesizeIn + DHT_SIZE);
+		if (!bus) {
+			fprintf(stderr, "FrameBusCreate(%s) failed\n", bus_name);
+			close_v4l2(&cam);
+			return 1;
+		}
+		uvcSetFrameBus(&cam, bus);
+		fprintf(stderr, "Publishing frames on /dev/shm/%s\n", bus_name[0] == '/' ? bus_name + 1 : bus_name);
+	}
+
 	signal(SIGINT, handle_sigint);
 
 	int pipefd[2] = {-1,-1};
 	pid_t child = -1;
-	FILE* out = stdout;
+	FILE* out = (bus && !use_ffplay) ? NULL : stdout;	// 버스만 쓸 때는 stdout 으로 내보내지 않음
 
 	if (use_ffplay && have_ffplay()) {
 		if (pipe(pipefd) == 0) {
@@ -71,16 +87,20 @@ int main(int argc, char** argv) {
 	}
 
 	while (keep_running) {
-		if (uvcGrab(&cam) < 0) {
-			fprintf(stderr, "uvcGrab failed\n");
+		struct iovec iov[MJPEG_IOV_MAX];
+		int cnt = uvcDequeue(&cam, iov);
+		if (cnt < 0) {
+			fprintf(stderr, "uvcDequeue failed\n");
 			break;
 		}
 		
-		// MJPEG 데이터를 그대로 전송
-		if (cam.framebuffer && cam.framesizeIn > 0) {
-			fwrite(cam.framebuffer, 1, cam.framesizeIn, out);
-			fflush(out);
+		// 드라이버 버퍼에서 바로 [헤더, DHT, 페이로드] 를 writev (프레임 복사 없음)
+		if (out && MjpegWritev(fileno(out), iov, cnt) < 0) {
+			uvcRequeue(&cam);
+			break;
 		}
+		if (uvcRequeue(&cam) < 0)
+			break;
 	}
 
 	if (out && out != stdout) fclose(out);
@@ -89,5 +109,6 @@ int main(int argc, char** argv) {
 		waitpid(child, &status, 0);
 	}
 	close_v4l2(&cam);
+	FrameBusDestroy(bus);	// 리더에게 EOS
 	return 0;
 } 
\ No newline at end of file
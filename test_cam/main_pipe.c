@@ -25,11 +25,14 @@ int main(int argc, char** argv) {
 	int height = 480;
 	unsigned int pixfmt = V4L2_PIX_FMT_YUYV;
 	int use_ffplay = 1;
+	const char* bus_name = NULL;	// shared-memory frame bus name (/dev/shm/<name>)
+	FRAME_BUS* bus = NULL;
 
 	if (argc >= 2) device = argv[1];
 	if (argc >= 3) width = atoi(argv[2]);
 	if (argc >= 4) height = atoi(argv[3]);
 	if (argc >= 5) use_ffplay = atoi(argv[4]);
+	if (argc >= 6) bus_name = argv[5];
 
 	Dbg_Param = TESTAP_DBG_ERR;
 
@@ -46,11 +49,23 @@ int main(int argc, char** argv) {
 	height = cam.height;
 	fprintf(stderr, "Camera initialized: %dx%d\n", width, height);
 
+	// Publish every frame so other local processes (x11_viewer bus:<name>, frame_bus_reader.py) can read it
+	if (bus_name) {
+		bus = FrameBusCreate(bus_name, FB_DEFAULT_SLOTS, cam.framesizeIn + DHT_SIZE);
+		if (!bus) {
+			fprintf(stderr, "FrameBusCreate(%s) failed\n", bus_name);
+			close_v4l2(&cam);
+			return 1;
+		}
+		uvcSetFrameBus(&cam, bus);
+		fprintf(stderr, "Publishing frames on /dev/shm/%s\n", bus_name[0] == '/' ? bus_name + 1 : bus_name);
+	}
+
 	signal(SIGINT, handle_sigint);
 
 	int pipefd[2] = {-1,-1};
 	pid_t child = -1;
-	FILE* out = stdout;
+	FILE* out = (bus && !use_ffplay) ? NULL : stdout;	// bus only: nothing goes to stdout
 
 	if (use_ffplay && have_ffplay()) {
 		if (pipe(pipefd) == 0) {
@@ -79,7 +94,7 @@ int main(int argc, char** argv) {
 		}
 		
 		// Only write if we have valid data
-		if (cam.framebuffer && cam.framesizeIn > 0) {
+		if (out && cam.framebuffer && cam.framesizeIn > 0) {
 			fwrite(cam.framebuffer, 1, cam.framesizeIn, out);
 			fflush(out);
 		}
@@ -91,5 +106,6 @@ int main(int argc, char** argv) {
 		waitpid(child, &status, 0);
 	}
 	close_v4l2(&cam);
+	FrameBusDestroy(bus);	// readers see EOS
 	return 0;
 } 
\ No newline at end of file
@@ -8,57 +8,13 @@
 
 #include "../Linux_UVC_TestAP/v4l2uvc.h"
 #include "../Linux_UVC_TestAP/debug.h"
+#include "../test_linux_sdk/color_convert.h"
 
 int Dbg_Param = TESTAP_DBG_ERR;
 
 static volatile int keep_running = 1;
 static void handle_sigint(int sig) { (void)sig; keep_running = 0; }
 
-// YUYV to RGB 변환 함수
-void yuyv_to_rgb(uint8_t *yuyv, uint8_t *rgb, int width, int height) {
-    int i, j;
-    int y, u, v;
-    int r, g, b;
-    
-    for (i = 0; i < height; i++) {
-        for (j = 0; j < width; j += 2) {
-            // YUYV 포맷: Y0 U Y1 V
-            y = yuyv[i * width * 2 + j * 2 + 0];
-            u = yuyv[i * width * 2 + j * 2 + 1];
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            v = yuyv[i * width * 2 + j * 2 + 3];
-            
-            // YUV to RGB 변환 (첫 번째 픽셀)
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + j * 3 + 0] = r;
-            rgb[i * width * 3 + j * 3 + 1] = g;
-            rgb[i * width * 3 + j * 3 + 2] = b;
-            
-            // 두 번째 픽셀
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + (j + 1) * 3 + 0] = r;
-            rgb[i * width * 3 + (j + 1) * 3 + 1] = g;
-            rgb[i * width * 3 + (j + 1) * 3 + 2] = b;
-        }
-    }
-}
-
 int main(int argc, char** argv) {
     const char* device = "/dev/video0";
     int width = 640;
@@ -143,7 +99,8 @@ int main(int argc, char** argv) {
         frame_count++;
         
         // YUYV to RGB 변환
-        yuyv_to_rgb(cam.pFramebuffer, rgb_buffer, cam.width, cam.height);
+        yuyv_convert(cam.pFramebuffer, cam.width * 2, rgb_buffer, cam.width * 3,
+                     cam.width, cam.height, CC_FMT_RGB24, CC_MATRIX_BT601, CC_RANGE_FULL);
         
         // 텍스처 업데이트
         SDL_UpdateTexture(texture, NULL, rgb_buffer, cam.width * 3);
@@ -10,57 +10,13 @@
 
 #include "../Linux_UVC_TestAP/v4l2uvc.h"
 #include "../Linux_UVC_TestAP/debug.h"
+#include "../test_linux_sdk/color_convert.h"
 
 int Dbg_Param = TESTAP_DBG_ERR;
 
 static volatile int keep_running = 1;
 static void handle_sigint(int sig) { (void)sig; keep_running = 0; }
 
-// YUYV to RGB 변환 함수 (간단한 버전)
-void yuyv_to_rgb(uint8_t *yuyv, uint8_t *rgb, int width, int height) {
-    int i, j;
-    int y, u, v;
-    int r, g, b;
-    
-    for (i = 0; i < height; i++) {
-        for (j = 0; j < width; j += 2) {
-            // YUYV 포맷: Y0 U Y1 V
-            y = yuyv[i * width * 2 + j * 2 + 0];
-            u = yuyv[i * width * 2 + j * 2 + 1];
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            v = yuyv[i * width * 2 + j * 2 + 3];
-            
-            // YUV to RGB 변환 (첫 번째 픽셀)
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + j * 3 + 0] = r;
-            rgb[i * width * 3 + j * 3 + 1] = g;
-            rgb[i * width * 3 + j * 3 + 2] = b;
-            
-            // 두 번째 픽셀
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + (j + 1) * 3 + 0] = r;
-            rgb[i * width * 3 + (j + 1) * 3 + 1] = g;
-            rgb[i * width * 3 + (j + 1) * 3 + 2] = b;
-        }
-    }
-}
-
 int main(int argc, char** argv) {
     char* device = "/dev/video0";
     int width = 640;
@@ -100,8 +56,8 @@ int main(int argc, char** argv) {
     printf("Camera initialized: %dx%d\n", cam.width, cam.height);
     printf("Press 'q' to quit\n");
     
-    // RGB 버퍼 할당
-    uint8_t* rgb_buffer = malloc(width * height * 3);
+    // BGRX 버퍼 할당 (24비트 visual 의 ZPixmap 은 픽셀당 32비트)
+    uint8_t* rgb_buffer = malloc(width * height * 4);
     if (!rgb_buffer) {
         printf("Failed to allocate RGB buffer\n");
         return -1;
@@ -110,7 +66,7 @@ int main(int argc, char** argv) {
     // X11 이미지 생성 (한 번만)
     XImage *image = XCreateImage(display, DefaultVisual(display, screen),
                                DefaultDepth(display, screen), ZPixmap, 0,
-                               (char*)rgb_buffer, width, height, 8, 0);
+                               (char*)rgb_buffer, width, height, 32, 0);
     
     if (!image) {
         printf("Failed to create X11 image\n");
@@ -141,8 +97,9 @@ int main(int argc, char** argv) {
         
         frame_count++;
         
-        // YUYV to RGB 변환
-        yuyv_to_rgb(cam.framebuffer, rgb_buffer, cam.width, cam.height);
+        // YUYV to BGRX 변환
+        yuyv_convert(cam.framebuffer, cam.width * 2, rgb_buffer, cam.width * 4,
+                     cam.width, cam.height, CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_FULL);
         
         // 화면에 그리기
         GC gc = DefaultGC(display, screen);
@@ -155,6 +112,7 @@ int main(int argc, char** argv) {
     printf("Total frames: %d\n", frame_count);
     
     // 정리
+    image->data = NULL;  // rgb_buffer 는 아래에서 직접 해제
     XDestroyImage(image);
     free(rgb_buffer);
     close_v4l2(&cam);
@@ -10,57 +10,14 @@
 
 #include "../Linux_UVC_TestAP/v4l2uvc.h"
 #include "../Linux_UVC_TestAP/debug.h"
+#include "../test_linux_sdk/color_convert.h"
+#include "../test_linux_sdk/x11_display.h"
 
 int Dbg_Param = TESTAP_DBG_ERR;
 
 static volatile int keep_running = 1;
 static void handle_sigint(int sig) { (void)sig; keep_running = 0; }
 
-// YUYV to RGB 변환 함수
-void yuyv_to_rgb(uint8_t *yuyv, uint8_t *rgb, int width, int height) {
-    int i, j;
-    int y, u, v;
-    int r, g, b;
-    
-    for (i = 0; i < height; i++) {
-        for (j = 0; j < width; j += 2) {
-            // YUYV 포맷: Y0 U Y1 V
-            y = yuyv[i * width * 2 + j * 2 + 0];
-            u = yuyv[i * width * 2 + j * 2 + 1];
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            v = yuyv[i * width * 2 + j * 2 + 3];
-            
-            // YUV to RGB 변환 (첫 번째 픽셀)
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + j * 3 + 0] = r;
-            rgb[i * width * 3 + j * 3 + 1] = g;
-            rgb[i * width * 3 + j * 3 + 2] = b;
-            
-            // 두 번째 픽셀
-            y = yuyv[i * width * 2 + j * 2 + 2];
-            
-            r = y + 1.402 * (v - 128);
-            g = y - 0.344 * (u - 128) - 0.714 * (v - 128);
-            b = y + 1.772 * (u - 128);
-            
-            r = (r > 255) ? 255 : ((r < 0) ? 0 : r);
-            g = (g > 255) ? 255 : ((g < 0) ? 0 : g);
-            b = (b > 255) ? 255 : ((b < 0) ? 0 : b);
-            
-            rgb[i * width * 3 + (j + 1) * 3 + 0] = r;
-            rgb[i * width * 3 + (j + 1) * 3 + 1] = g;
-            rgb[i * width * 3 + (j + 1) * 3 + 2] = b;
-        }
-    }
-}
-
 int main(int argc, char** argv) {
     char* device = "/dev/video0";
     int width = 640;
@@ -71,6 +28,25 @@ int main(int argc, char** argv) {
     if (argc >= 3) width = atoi(argv[2]);
     if (argc >= 4) height = atoi(argv[3]);
     
+    // "bus:<name>": 카메라 대신 다른 프로세스가 게시하는 공유 메모리 프레임 버스에서 읽는다 (YUYV)
+    FB_READER *bus = NULL;
+    FB_FRAME bf;
+    if (strncmp(device, "bus:", 4) == 0) {
+        bus = FrameBusOpen(device + 4, FB_READ_LATEST);
+        if (!bus) {
+            printf("Cannot open frame bus %s\n", device + 4);
+            return -1;
+        }
+        // 첫 프레임으로 크기를 정한다
+        if (FrameBusNext(bus, &bf, 5000) <= 0 || (bf.flags & FB_FLAG_EOS)) {
+            printf("No frame on bus %s\n", device + 4);
+            FrameBusClose(bus);
+            return -1;
+        }
+        width = bf.width;
+        height = bf.height;
+    }
+    
     signal(SIGINT, handle_sigint);
     
     // X11 디스플레이 연결
@@ -92,18 +68,25 @@ int main(int argc, char** argv) {
     
     // 카메라 초기화
     struct vdIn cam;
-    if (init_videoIn(&cam, device, width, height, pixfmt, 1) < 0) {
-        printf("Failed to initialize camera\n");
-        return -1;
+    memset(&cam, 0, sizeof(cam));
+    if (bus) {
+        cam.width = width;
+        cam.height = height;
+        printf("Frame bus %s: %dx%d\n", device + 4, width, height);
+    } else {
+        if (init_videoIn(&cam, device, width, height, pixfmt, 1) < 0) {
+            printf("Failed to initialize camera\n");
+            return -1;
+        }
+        printf("Camera initialized: %dx%d\n", cam.width, cam.height);
     }
-    
-    printf("Camera initialized: %dx%d\n", cam.width, cam.height);
     printf("Press 'q' to quit\n");
     
-    // RGB 버퍼 할당
-    uint8_t* rgb_buffer = malloc(width * height * 3);
-    if (!rgb_buffer) {
-        printf("Failed to allocate RGB buffer\n");
+    // 영구 XImage 할당 (MIT-SHM 지원 시 공유 메모리, 프레임마다 재생성하지 않음)
+    x11_display_t xdisp;
+    if (x11_display_init(&xdisp, display, window, DefaultGC(display, screen), 1) < 0 ||
+        x11_display_resize(&xdisp, cam.width, cam.height) < 0) {
+        printf("Failed to allocate display buffers\n");
         return -1;
     }
     
@@ -114,6 +97,8 @@ int main(int argc, char** argv) {
         // X11 이벤트 처리
         while (XPending(display)) {
             XNextEvent(display, &event);
+            if (x11_display_handle_event(&xdisp, &event))
+                continue;
             if (event.type == KeyPress) {
                 char key = XLookupKeysym(&event.xkey, 0);
                 if (key == 'q' || key == 'Q') {
@@ -122,6 +107,34 @@ int main(int argc, char** argv) {
             }
         }
         
+        if (bus) {
+            // 게시될 때까지 futex 로 기다림 (X11 이벤트 처리를 위해 100ms 마다 깨어남)
+            int rc = FrameBusNext(bus, &bf, 100);
+            if (rc < 0 || (rc > 0 && (bf.flags & FB_FLAG_EOS)))
+                break;
+            if (rc == 0 || bf.pixfmt != V4L2_PIX_FMT_YUYV ||
+                bf.bytes < bf.width * bf.height * 2)
+                continue;
+            if ((int)bf.width != cam.width || (int)bf.height != cam.height) {
+                if (x11_display_resize(&xdisp, bf.width, bf.height) < 0)
+                    break;
+                cam.width = bf.width;
+                cam.height = bf.height;
+            }
+            int stride = 0;
+            uint8_t* dst = x11_display_back_buffer(&xdisp, &stride);
+            if (!dst)
+                break;
+            // 공유 메모리에서 바로 변환한 뒤, 그동안 덮어써졌으면 버린다
+            yuyv_convert(bf.data, bf.width * 2, dst, stride,
+                         bf.width, bf.height, xdisp.format, CC_MATRIX_BT601, CC_RANGE_FULL);
+            if (!FrameBusValid(bus, &bf))
+                continue;
+            x11_display_present(&xdisp, 0, 0);
+            frame_count++;
+            continue;
+        }
+        
         // 프레임 읽기
         int ret = uvcGrab(&cam);
         if (ret < 0) {
@@ -131,19 +144,17 @@ int main(int argc, char** argv) {
         
         frame_count++;
         
-        // YUYV to RGB 변환
-        yuyv_to_rgb(cam.framebuffer, rgb_buffer, cam.width, cam.height);
-        
-        // X11 이미지 생성
-        XImage *image = XCreateImage(display, DefaultVisual(display, screen),
-                                   DefaultDepth(display, screen), ZPixmap, 0,
-                                   (char*)rgb_buffer, width, height, 8, 0);
+        // YUYV 를 백 버퍼에 직접 변환
+        int stride = 0;
+        uint8_t* dst = x11_display_back_buffer(&xdisp, &stride);
+        if (!dst) {
+            break;
+        }
+        yuyv_convert(cam.framebuffer, cam.width * 2, dst, stride,
+                     cam.width, cam.height, xdisp.format, CC_MATRIX_BT601, CC_RANGE_FULL);
         
         // 화면에 그리기
-        GC gc = DefaultGC(display, screen);
-        XPutImage(display, window, gc, image, 0, 0, 0, 0, width, height);
-        
-        XDestroyImage(image);
+        x11_display_present(&xdisp, 0, 0);
         
         // 프레임 레이트 제어
         usleep(33000); // ~30fps
@@ -152,8 +163,15 @@ int main(int argc, char** argv) {
     printf("Total frames: %d\n", frame_count);
     
     // 정리
-    free(rgb_buffer);
-    close_v4l2(&cam);
+    x11_display_destroy(&xdisp);
+    if (bus) {
+        FB_READER_STATS st;
+        FrameBusReaderStats(bus, &st);
+        printf("Bus frames: %llu, skipped: %llu, torn: %lu\n", st.frames, st.skipped, st.torn);
+        FrameBusClose(bus);
+    } else {
+        close_v4l2(&cam);
+    }
     XCloseDisplay(display);
     
     return 0;
@@ -0,0 +1,200 @@
+//----------------------------------------------//
+//	캡처 → 출력 지연 벤치마크 (sleep vs epoll)		//
+//----------------------------------------------//
+// 사용법: ./capture_latency_bench [camera_fps] [output_fps] [seconds]
+// 합성 소스(카메라처럼 마감 시각마다 버퍼를 채우고 빈 버퍼가 없으면 드롭)를 두고
+//   sleep : 기존 waitForNextFrame() 방식 (출력 간격만큼 nanosleep 후 가장 오래된 프레임 디큐)
+//   epoll : CaptureEventLoop (소스 fd + 출력 timerfd, 장치 timestamp 기준 페이싱)
+// 두 모드의 glass-to-glass (프레임 timestamp → 변환 완료) 분위수를 비교한다.
+// 카메라 주기가 요청한 출력 FPS 와 조금만 달라도(또는 sleep 오버슈트만으로도)
+// sleep 방식은 드라이버 큐가 가득 찬 상태로 굳어 (버퍼 수 - 1) 프레임만큼 늦게 출력한다.
+// epoll 모드의 p50 이 sleep 모드보다 출력 한 프레임 간격 이상 낮지 않으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include "frame_source.h"
+#include "capture_ring.h"
+#include "capture_loop.h"
+#include "color_convert.h"
+#include "pipeline_metrics.h"
+
+#define BENCH_WIDTH     320
+#define BENCH_HEIGHT    240
+#define BENCH_BUFFERS   4
+
+// 화면 대신 BGRX 버퍼로 변환만 하는 출력
+class HeadlessPresenter : public FramePresenter {
+private:
+    CaptureRing *ring;
+    pipeline_metrics_t *metrics;
+    unsigned char *dst;
+
+public:
+    unsigned long frames;
+
+    HeadlessPresenter(CaptureRing *ring_, pipeline_metrics_t *metrics_) {
+        ring = ring_;
+        metrics = metrics_;
+        dst = (unsigned char *)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+        frames = 0;
+    }
+    virtual ~HeadlessPresenter() { free(dst); }
+
+    int ok() const { return dst != NULL; }
+
+    // 변환만 하고 버퍼 반환
+    void draw(FrameRef *ref) {
+        uint64_t t0 = pm_now_ns();
+        yuyv_convert(ref->data, BENCH_WIDTH * 2, dst, BENCH_WIDTH * 4, BENCH_WIDTH, BENCH_HEIGHT,
+                     CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_FULL);
+        pm_record_since(metrics, PM_STAGE_CONVERT, t0);
+        ring->release(ref);
+        frames++;
+    }
+
+    virtual int onFrame(const FrameRef *ref) {
+        pm_frame(metrics, ref->sequence);
+        return 1;
+    }
+
+    virtual void present(FrameRef *ref) { draw(ref); }
+};
+
+static void timespec_add_ns(struct timespec *ts, long ns)
+{
+    ts->tv_nsec += ns;
+    while (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// 기존 방식: 마지막 출력 시각 + 간격까지 nanosleep, 그 다음 프레임 하나 디큐
+static void run_sleep_mode(CaptureRing *ring, HeadlessPresenter *out, pipeline_metrics_t *m,
+                           int output_fps, uint64_t end_ns)
+{
+    long interval_ns = 1000000000L / output_fps;
+    int fd = ring->getSource()->fd();
+    struct timespec last;
+
+    clock_gettime(CLOCK_MONOTONIC, &last);
+    while (pm_now_ns() < end_ns) {
+        // waitForNextFrame(): 목표 시각까지 남은 시간만큼 sleep, 깨어난 시각이 다음 기준
+        struct timespec now, target = last, sleep_time;
+        timespec_add_ns(&target, interval_ns);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        sleep_time.tv_sec = target.tv_sec - now.tv_sec;
+        sleep_time.tv_nsec = target.tv_nsec - now.tv_nsec;
+        if (sleep_time.tv_nsec < 0) {
+            sleep_time.tv_sec--;
+            sleep_time.tv_nsec += 1000000000L;
+        }
+        if (sleep_time.tv_sec > 0 || (sleep_time.tv_sec == 0 && sleep_time.tv_nsec > 0)) {
+            nanosleep(&sleep_time, NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &last);
+
+        FrameRef ref;
+        uint64_t wait_start = pm_now_ns();
+        while (ring->acquire(&ref) < 0) {
+            if (errno != EAGAIN) return;
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, 100);
+        }
+        pm_record_since(m, PM_STAGE_DQBUF_WAIT, wait_start);
+        pm_frame(m, ref.sequence);
+
+        uint64_t ts = frameRefTimestampNs(&ref);
+        out->draw(&ref);
+        pm_record_since(m, PM_STAGE_E2E, ts);
+    }
+}
+
+typedef struct {
+    double p50_ms, p99_ms, fps;
+    unsigned long long seq_drops;
+} mode_result_t;
+
+static int run_mode(int use_epoll, int camera_fps, int output_fps, double seconds,
+                    mode_result_t *res)
+{
+    SyntheticFrameSource source(BENCH_WIDTH, BENCH_HEIGHT, BENCH_BUFFERS);
+    pipeline_metrics_t m;
+
+    source.setFrameRate(camera_fps);
+    if (source.fd() < 0 || source.start() < 0) {
+        printf("합성 소스 시작 실패\n");
+        return -1;
+    }
+
+    pm_init(&m);
+    CaptureRing ring(&source);
+    ring.setMetrics(&m);
+    HeadlessPresenter out(&ring, &m);
+    if (!out.ok()) return -1;
+
+    uint64_t start = pm_now_ns();
+    uint64_t end_ns = start + (uint64_t)(seconds * 1e9);
+
+    if (use_epoll) {
+        CaptureEventLoop loop(&ring, &out, &m);
+        if (loop.init(output_fps) < 0) return -1;
+        while (pm_now_ns() < end_ns) {
+            if (loop.runOnce(100) < 0) return -1;
+        }
+    } else {
+        run_sleep_mode(&ring, &out, &m, output_fps, end_ns);
+    }
+
+    const pm_hist_t *h = &m.stages[PM_STAGE_E2E];
+    res->p50_ms = pm_hist_percentile(h, 0.50) / 1e6;
+    res->p99_ms = pm_hist_percentile(h, 0.99) / 1e6;
+    res->fps = out.frames / ((pm_now_ns() - start) / 1e9);
+    res->seq_drops = (unsigned long long)m.seq_drops;
+
+    source.stop();
+    return h->count ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[2] = { "sleep", "epoll" };
+    int camera_fps = 125, output_fps = 120;
+    double seconds = 2.0;
+    mode_result_t res[2];
+
+    if (argc >= 2) camera_fps = atoi(argv[1]);
+    if (argc >= 3) output_fps = atoi(argv[2]);
+    if (argc >= 4) seconds = atof(argv[3]);
+    if (camera_fps <= 0 || output_fps <= 0 || seconds <= 0) {
+        printf("사용법: %s [camera_fps] [output_fps] [seconds]\n", argv[0]);
+        return 2;
+    }
+
+    double interval_ms = 1000.0 / output_fps;
+    printf("=== 캡처 지연 벤치마크 (카메라 %d fps, 출력 %d fps, 버퍼 %d, %.1f초) ===\n",
+           camera_fps, output_fps, BENCH_BUFFERS, seconds);
+
+    for (int mode = 0; mode < 2; mode++) {
+        if (run_mode(mode, camera_fps, output_fps, seconds, &res[mode]) < 0) {
+            printf("%s: 실행 실패\n", names[mode]);
+            return 1;
+        }
+        printf("%-6s: glass-to-glass p50 %7.2f ms  p99 %7.2f ms  출력 %6.1f fps  장치 드롭 %llu\n",
+               names[mode], res[mode].p50_ms, res[mode].p99_ms, res[mode].fps, res[mode].seq_drops);
+    }
+
+    double gain = res[0].p50_ms - res[1].p50_ms;
+    printf("p50 감소: %.2f ms (출력 간격 %.2f ms 의 %.1f 배)\n", gain, interval_ms, gain / interval_ms);
+
+    int ok = gain >= interval_ms;
+    printf("검증: %s\n", ok ? "epoll 모드가 한 프레임 간격 이상 빠름" : "실패 (감소폭이 한 프레임 간격 미만)");
+    return ok ? 0 : 1;
+}
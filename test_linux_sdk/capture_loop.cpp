@@ -0,0 +1,206 @@
+#include "capture_loop.h"
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+CaptureEventLoop::CaptureEventLoop(CaptureRing *ring_, FramePresenter *presenter_,
+                                   pipeline_metrics_t *metrics_) {
+    ring = ring_;
+    presenter = presenter_;
+    metrics = metrics_;
+    epoll_fd = -1;
+    timer_fd = -1;
+    source_fd = -1;
+    extra_count = 0;
+    for (int i = 0; i < CAPTURE_LOOP_MAX_FDS; i++) extra_fds[i] = -1;
+    out_interval_ns = 0;
+    slack_ns = 0;
+    next_slot_ns = 0;
+    memset(&pending, 0, sizeof(pending));
+    pending.index = -1;
+    wait_start = 0;
+    presented = 0;
+    paced_drops = 0;
+}
+
+CaptureEventLoop::~CaptureEventLoop() {
+    if (ring) ring->release(&pending);
+    if (timer_fd >= 0) close(timer_fd);
+    if (epoll_fd >= 0) close(epoll_fd);
+}
+
+int CaptureEventLoop::init(int output_fps) {
+    if (!ring || !presenter || epoll_fd >= 0) return -1;
+
+    source_fd = ring->getSource()->fd();
+    if (source_fd < 0) {
+        printf("이벤트 루프: 프레임 소스에 poll 가능한 fd 가 없음\n");
+        return -1;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        printf("epoll_create1 실패: %s\n", strerror(errno));
+        return -1;
+    }
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        printf("timerfd_create 실패: %s\n", strerror(errno));
+        return -1;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = source_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, source_fd, &ev) < 0) {
+        printf("epoll_ctl(소스) 실패: %s\n", strerror(errno));
+        return -1;
+    }
+    ev.data.fd = timer_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) < 0) {
+        printf("epoll_ctl(timerfd) 실패: %s\n", strerror(errno));
+        return -1;
+    }
+
+    out_interval_ns = output_fps > 0 ? 1000000000ULL / output_fps : 0;
+    slack_ns = out_interval_ns / 4;
+    next_slot_ns = 0;
+    wait_start = pm_now_ns();
+    return 0;
+}
+
+int CaptureEventLoop::addFd(int fd) {
+    if (epoll_fd < 0 || fd < 0 || extra_count >= CAPTURE_LOOP_MAX_FDS) return -1;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        printf("epoll_ctl(%d) 실패: %s\n", fd, strerror(errno));
+        return -1;
+    }
+    extra_fds[extra_count++] = fd;
+    return 0;
+}
+
+// 출력 타이머 설정 (deadline_ns == 0 이면 해제)
+void CaptureEventLoop::armTimer(uint64_t deadline_ns) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = deadline_ns / 1000000000ULL;
+    its.it_value.tv_nsec = deadline_ns % 1000000000ULL;
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+// 준비된 프레임을 모두 디큐 (이벤트 하나에 여러 프레임이 쌓여 있을 수 있음)
+int CaptureEventLoop::drainSource() {
+    int count = ring->getSource()->bufferCount();
+
+    for (int n = 0; n < count; n++) {
+        FrameRef ref;
+        if (ring->acquire(&ref) < 0) {
+            if (errno == EAGAIN) break;
+            if (errno == ENODATA) {
+                printf("프레임 소스 끝 (재생 파일)\n");
+                return -1;
+            }
+            printf("VIDIOC_DQBUF 실패: %s\n", strerror(errno));
+            return -1;
+        }
+        if (n == 0) pm_record_since(metrics, PM_STAGE_DQBUF_WAIT, wait_start);
+
+        if (!presenter->onFrame(&ref)) {
+            ring->release(&ref);
+            continue;
+        }
+        offer(&ref);
+    }
+    wait_start = pm_now_ns();
+    return 0;
+}
+
+// 출력 후보 교체 (아직 출력하지 않은 이전 후보는 드롭)
+void CaptureEventLoop::offer(FrameRef *ref) {
+    if (frameRefValid(&pending)) {
+        ring->release(&pending);
+        pm_display_drop(metrics);
+        paced_drops++;
+    }
+    pending = *ref;
+    ref->ring = NULL;
+    ref->index = -1;
+}
+
+void CaptureEventLoop::presentFrame(FrameRef *ref) {
+    uint64_t ts = frameRefTimestampNs(ref);
+
+    presenter->present(ref);
+
+    uint64_t now = pm_now_ns();
+    if (ts && now > ts) pm_record(metrics, PM_STAGE_E2E, now - ts);
+    presented++;
+
+    // 다음 슬롯은 방금 출력한 프레임의 장치 timestamp 기준
+    // (장치 클록과 출력 주기가 조금 달라도 드리프트가 쌓이지 않음)
+    if (out_interval_ns) next_slot_ns = ts + out_interval_ns;
+}
+
+int CaptureEventLoop::runOnce(int timeout_ms) {
+    if (epoll_fd < 0) return -1;
+
+    presenter->onIdle();
+
+    struct epoll_event events[CAPTURE_LOOP_MAX_FDS + 2];
+    int n = epoll_wait(epoll_fd, events, CAPTURE_LOOP_MAX_FDS + 2, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) return 0;
+        printf("epoll_wait 실패: %s\n", strerror(errno));
+        return -1;
+    }
+
+    int slot_expired = 0;
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (fd == source_fd) {
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                printf("캡처 장치 오류 (events=0x%x)\n", events[i].events);
+                return -1;
+            }
+            if (drainSource() < 0) return -1;
+        } else if (fd == timer_fd) {
+            uint64_t expirations;
+            if (read(timer_fd, &expirations, sizeof(expirations)) < 0) {
+                // EAGAIN: 이미 다시 설정됨
+            }
+            slot_expired = 1;
+        } else {
+            presenter->onFdReady(fd);
+        }
+    }
+
+    if (!frameRefValid(&pending)) return 0;
+
+    // 장치 timestamp 가 다음 슬롯에 (지터 허용치 안에서) 도달했거나,
+    // 슬롯이 지나도록 더 새 프레임이 오지 않았으면 출력
+    uint64_t ts = frameRefTimestampNs(&pending);
+    if (!out_interval_ns || slot_expired || ts + slack_ns >= next_slot_ns) {
+        FrameRef ref = pending;
+        pending.ring = NULL;
+        pending.index = -1;
+        armTimer(0);
+        presentFrame(&ref);
+    } else {
+        armTimer(next_slot_ns + slack_ns);
+    }
+    return 0;
+}
+
+int CaptureEventLoop::run(std::atomic<int> *running) {
+    while (running->load()) {
+        if (runOnce(100) < 0) return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#ifndef CAPTURE_LOOP_H
+#define CAPTURE_LOOP_H
+
+#include <atomic>
+#include "capture_ring.h"
+#include "pipeline_metrics.h"
+
+#define CAPTURE_LOOP_MAX_FDS 4
+
+// 이벤트 루프가 프레임과 추가 fd 이벤트를 넘겨주는 대상 (뷰어, 벤치마크 등)
+class FramePresenter {
+public:
+    virtual ~FramePresenter() {}
+
+    // 디큐된 모든 프레임마다 호출 (통계, H.264 파싱 등)
+    // 0 을 반환하면 화면에 내보내지 않고 바로 반환한다
+    virtual int onFrame(const FrameRef *ref) { (void)ref; return 1; }
+
+    // 화면 출력. ref 의 소유권을 넘겨받으므로 다 쓰면 release() 해야 한다
+    virtual void present(FrameRef *ref) = 0;
+
+    // addFd() 로 등록한 fd 가 readable
+    virtual void onFdReady(int fd) { (void)fd; }
+
+    // epoll_wait 직전 (Xlib 처럼 소켓을 이미 읽어 내부 큐에 쌓아두는 경우 비우기)
+    virtual void onIdle() {}
+};
+
+// 단일 스레드 epoll 캡처 루프
+// - 소스 fd (V4L2 / 합성 timerfd): 준비된 프레임을 모두 디큐하고 가장 최신 것만 남긴다
+// - 출력 timerfd: 출력 FPS 가 장치보다 낮을 때 장치 timestamp 기준 슬롯으로 페이싱
+// - 추가 fd (X11 연결 등): presenter->onFdReady()
+// 벽시계 sleep 이 없으므로 프레임은 장치가 내준 직후에 출력된다.
+class CaptureEventLoop {
+private:
+    CaptureRing *ring;
+    FramePresenter *presenter;
+    pipeline_metrics_t *metrics;
+
+    int epoll_fd;
+    int timer_fd;
+    int source_fd;
+    int extra_fds[CAPTURE_LOOP_MAX_FDS];
+    int extra_count;
+
+    uint64_t out_interval_ns;   // 0 이면 들어오는 대로 출력
+    uint64_t slack_ns;          // 장치 timestamp 지터 허용치
+    uint64_t next_slot_ns;      // 다음 출력 슬롯 (장치 timestamp 기준)
+    FrameRef pending;           // 슬롯을 기다리는 프레임
+    uint64_t wait_start;
+
+    unsigned long presented;
+    unsigned long paced_drops;
+
+    int drainSource();
+    void offer(FrameRef *ref);
+    void presentFrame(FrameRef *ref);
+    void armTimer(uint64_t deadline_ns);
+
+public:
+    CaptureEventLoop(CaptureRing *ring, FramePresenter *presenter, pipeline_metrics_t *metrics);
+    ~CaptureEventLoop();
+
+    // output_fps 가 0 이면 페이싱 없이 모든 최신 프레임을 바로 출력
+    int init(int output_fps);
+
+    // 함께 기다릴 fd 추가 (X11 ConnectionNumber 등)
+    int addFd(int fd);
+
+    // 이벤트 한 번 처리. 오류면 -1
+    int runOnce(int timeout_ms);
+
+    // running 이 0 이 될 때까지 반복 (100ms 마다 플래그 확인)
+    int run(std::atomic<int> *running);
+
+    unsigned long presentedCount() const { return presented; }
+    unsigned long pacedDropCount() const { return paced_drops; }
+};
+
+#endif // CAPTURE_LOOP_H
@@ -0,0 +1,135 @@
+#include "capture_ring.h"
+#include <errno.h>
+
+CaptureRing::CaptureRing(FrameSource *source_) {
+    source = source_;
+    memset(slots, 0, sizeof(slots));
+    for (int i = 0; i < FRAME_SOURCE_MAX_BUFFERS; i++) {
+        refcount[i].store(0, std::memory_order_relaxed);
+    }
+    outstanding.store(0, std::memory_order_relaxed);
+    metrics = NULL;
+}
+
+CaptureRing::~CaptureRing() {
+    if (outstanding.load() > 0) {
+        printf("경고: 캡처 링 해제 시 %d 개 버퍼가 반환되지 않음\n", outstanding.load());
+    }
+}
+
+int CaptureRing::acquire(FrameRef *ref) {
+    if (!source || !ref) return -1;
+
+    FrameDesc desc;
+    if (source->dequeue(&desc) < 0) {
+        return -1;
+    }
+    if (desc.index < 0 || desc.index >= FRAME_SOURCE_MAX_BUFFERS) {
+        printf("잘못된 버퍼 인덱스: %d\n", desc.index);
+        errno = EINVAL;
+        return -1;
+    }
+
+    slots[desc.index] = desc;
+    refcount[desc.index].store(1, std::memory_order_release);
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+
+    ref->ring = this;
+    ref->index = desc.index;
+    ref->data = desc.data;
+    ref->bytesused = desc.bytesused;
+    ref->sequence = desc.sequence;
+    ref->timestamp = desc.timestamp;
+    return 0;
+}
+
+int CaptureRing::retain(const FrameRef *src, FrameRef *dst) {
+    if (!frameRefValid(src) || src->ring != this || !dst) return -1;
+
+    refcount[src->index].fetch_add(1, std::memory_order_relaxed);
+    *dst = *src;
+    return 0;
+}
+
+void CaptureRing::release(FrameRef *ref) {
+    if (!frameRefValid(ref) || ref->ring != this) return;
+
+    int index = ref->index;
+    ref->ring = NULL;
+    ref->index = -1;
+    ref->data = NULL;
+    ref->bytesused = 0;
+
+    if (refcount[index].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        outstanding.fetch_sub(1, std::memory_order_relaxed);
+        uint64_t t0 = metrics ? pm_now_ns() : 0;
+        source->enqueue(index);
+        pm_record_since(metrics, PM_STAGE_QBUF, t0);
+    }
+}
+
+int CaptureRing::adopt(int index, FrameRef *ref) {
+    if (index < 0 || index >= FRAME_SOURCE_MAX_BUFFERS || !ref) return -1;
+
+    const FrameDesc *desc = &slots[index];
+    ref->ring = this;
+    ref->index = index;
+    ref->data = desc->data;
+    ref->bytesused = desc->bytesused;
+    ref->sequence = desc->sequence;
+    ref->timestamp = desc->timestamp;
+    return 0;
+}
+
+// ===== LatestFrameSlot =====
+
+LatestFrameSlot::LatestFrameSlot() {
+    ring = NULL;
+    index.store(-1, std::memory_order_relaxed);
+    published.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+}
+
+LatestFrameSlot::~LatestFrameSlot() {
+    clear();
+}
+
+void LatestFrameSlot::attach(CaptureRing *ring_) {
+    clear();
+    ring = ring_;
+    published.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+}
+
+int LatestFrameSlot::publish(FrameRef *ref) {
+    if (!frameRefValid(ref) || ref->ring != ring) return -1;
+
+    int prev = index.exchange(ref->index, std::memory_order_acq_rel);
+    ref->ring = NULL;
+    ref->index = -1;
+    published.fetch_add(1, std::memory_order_relaxed);
+
+    if (prev < 0) return 0;
+
+    // 소비자가 가져가지 않은 이전 프레임은 드롭
+    FrameRef stale;
+    ring->adopt(prev, &stale);
+    ring->release(&stale);
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+int LatestFrameSlot::take(FrameRef *ref) {
+    if (!ring || !ref) return -1;
+
+    int idx = index.exchange(-1, std::memory_order_acq_rel);
+    if (idx < 0) return -1;
+    return ring->adopt(idx, ref);
+}
+
+void LatestFrameSlot::clear() {
+    FrameRef ref;
+    if (take(&ref) == 0) {
+        ring->release(&ref);
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef CAPTURE_RING_H
+#define CAPTURE_RING_H
+
+#include <atomic>
+#include "frame_source.h"
+#include "pipeline_metrics.h"
+
+class CaptureRing;
+
+// 캡처 버퍼에 대한 참조 (mmap 메모리를 그대로 가리킴)
+// index < 0 이면 빈 참조
+typedef struct {
+    CaptureRing *ring;
+    int index;
+    const unsigned char *data;
+    unsigned int bytesused;
+    unsigned int sequence;
+    struct timeval timestamp;
+} FrameRef;
+
+#define FRAME_REF_INIT { NULL, -1, NULL, 0, 0, { 0, 0 } }
+
+// 제로카피 캡처 링
+// 소스에서 디큐한 버퍼를 참조 카운트로 관리하고,
+// 마지막 소비자가 release() 할 때에만 소스에 다시 큐잉(VIDIOC_QBUF)한다.
+class CaptureRing {
+private:
+    FrameSource *source;
+    FrameDesc slots[FRAME_SOURCE_MAX_BUFFERS];
+    std::atomic<int> refcount[FRAME_SOURCE_MAX_BUFFERS];
+    std::atomic<int> outstanding;
+    pipeline_metrics_t *metrics;   // QBUF 지연 기록 (없으면 NULL)
+
+public:
+    explicit CaptureRing(FrameSource *source);
+    ~CaptureRing();
+
+    // 다음 프레임을 디큐해서 참조 카운트 1 로 넘겨준다.
+    // 프레임이 없으면 -1 (errno == EAGAIN)
+    int acquire(FrameRef *ref);
+
+    // 같은 버퍼에 대한 추가 참조를 만든다 (다른 소비자에게 전달용)
+    int retain(const FrameRef *src, FrameRef *dst);
+
+    // 참조 해제, 마지막 참조면 버퍼를 소스에 반환
+    void release(FrameRef *ref);
+
+    // 이미 소유한 참조를 인덱스만으로 복원 (참조 카운트 변화 없음)
+    // LatestFrameSlot 처럼 인덱스만 주고받는 핸드오프에서 사용
+    int adopt(int index, FrameRef *ref);
+
+    // 소비자에게 나가 있는 버퍼 수
+    int outstandingCount() const { return outstanding.load(std::memory_order_relaxed); }
+
+    FrameSource *getSource() const { return source; }
+
+    void setMetrics(pipeline_metrics_t *m) { metrics = m; }
+};
+
+// 단일 슬롯 "최신 프레임" 핸드오프 (lock-free)
+// 생산자는 publish() 로 참조 소유권을 넘기고, 소비자는 take() 로 가져간다.
+// 소비자가 가져가기 전에 새 프레임이 들어오면 이전 프레임은 즉시 반환(드롭)되므로
+// 느린 소비자가 캡처를 막지 않는다.
+class LatestFrameSlot {
+private:
+    CaptureRing *ring;
+    std::atomic<int> index;  // -1 이면 비어있음
+    std::atomic<unsigned long> published;
+    std::atomic<unsigned long> dropped;
+
+public:
+    LatestFrameSlot();
+    ~LatestFrameSlot();
+
+    void attach(CaptureRing *ring);
+
+    // ref 의 소유권을 슬롯으로 넘긴다. 읽히지 않은 이전 프레임을 버렸으면 1 반환
+    int publish(FrameRef *ref);
+
+    // 최신 프레임의 소유권을 가져온다. 비어있으면 -1
+    int take(FrameRef *ref);
+
+    // 남아있는 프레임 반환
+    void clear();
+
+    unsigned long publishedCount() const { return published.load(std::memory_order_relaxed); }
+    unsigned long droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+static inline int frameRefValid(const FrameRef *ref) {
+    return ref && ref->ring && ref->index >= 0;
+}
+
+// 프레임 캡처 시각 (CLOCK_MONOTONIC ns, pm_now_ns() 와 같은 기준)
+static inline uint64_t frameRefTimestampNs(const FrameRef *ref) {
+    return (uint64_t)ref->timestamp.tv_sec * 1000000000ULL + (uint64_t)ref->timestamp.tv_usec * 1000ULL;
+}
+
+#endif // CAPTURE_RING_H
@@ -0,0 +1,526 @@
+//----------------------------------------------//
+//	YUYV → RGB color conversion					//
+//----------------------------------------------//
+
+#include <stdio.h>
+#include <string.h>
+#include "color_convert.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CC_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CC_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Q13 고정소수점 계수
+// R = ((Y - yoff) * cy + crv * V' + 4096) >> 13
+// G = ((Y - yoff) * cy - cgu * U' - cgv * V' + 4096) >> 13
+// B = ((Y - yoff) * cy + cbu * U' + 4096) >> 13   (U' = U - 128, V' = V - 128)
+#define CC_SHIFT 13
+#define CC_ROUND (1 << (CC_SHIFT - 1))
+
+typedef struct {
+    int yoff;
+    int cy;
+    int crv;
+    int cgu;
+    int cgv;
+    int cbu;
+} cc_coef;
+
+// [matrix][range]
+static const cc_coef cc_coefs[2][2] = {
+    // BT.601
+    {
+        { 16, 9539, 13075, 3209, 6660, 16525 },    // limited
+        {  0, 8192, 11485, 2819, 5850, 14516 },    // full
+    },
+    // BT.709
+    {
+        { 16, 9539, 14686, 1747, 4366, 17305 },    // limited
+        {  0, 8192, 12901, 1535, 3835, 15201 },    // full
+    },
+};
+
+typedef void (*cc_row_fn)(const uint8_t *src, uint8_t *dst, int width,
+                          cc_format_t fmt, const cc_coef *c);
+
+static inline uint8_t cc_clamp8(int v)
+{
+    // 분기 없는 클램프 (채도가 높은 장면에서도 분기 예측 실패가 없도록)
+    v &= ~(v >> 31);            // 음수 → 0
+    v |= (255 - v) >> 31;       // 255 초과 → 하위 8비트 모두 1
+    return (uint8_t)v;
+}
+
+static inline void cc_store_pixel(uint8_t *d, cc_format_t fmt, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint16_t p;
+
+    switch (fmt) {
+    case CC_FMT_RGB24:
+        d[0] = r;
+        d[1] = g;
+        d[2] = b;
+        break;
+    case CC_FMT_BGRX32:
+        d[0] = b;
+        d[1] = g;
+        d[2] = r;
+        d[3] = 0xFF;
+        break;
+    case CC_FMT_RGB565:
+        p = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+        d[0] = (uint8_t)(p & 0xFF);
+        d[1] = (uint8_t)(p >> 8);
+        break;
+    }
+}
+
+//------------------------------------------------------------------------------
+// 스칼라 기준 구현 (모든 SIMD 경로의 비트 단위 기준)
+//------------------------------------------------------------------------------
+
+// 포맷 분기를 루프 밖으로 빼기 위해 포맷별로 루프를 펼친다 (계수는 호출 측 지역 변수)
+#define CC_SCALAR_LOOP(BPP, FMT)                                            \
+    for (; x < width; x += 2) {                                             \
+        const uint8_t *s = src + x * 2;                                     \
+        int u = s[1] - 128;                                                 \
+        int v = s[3] - 128;                                                 \
+        int rv = crv * v;                                                   \
+        int guv = -cgu * u - cgv * v;                                       \
+        int bu = cbu * u;                                                   \
+        int y0 = (s[0] - yoff) * cy + CC_ROUND;                             \
+        int y1 = (s[2] - yoff) * cy + CC_ROUND;                             \
+        uint8_t *d = dst + x * (BPP);                                       \
+        cc_store_pixel(d, FMT,                                              \
+                       cc_clamp8((y0 + rv) >> CC_SHIFT),                    \
+                       cc_clamp8((y0 + guv) >> CC_SHIFT),                   \
+                       cc_clamp8((y0 + bu) >> CC_SHIFT));                   \
+        cc_store_pixel(d + (BPP), FMT,                                      \
+                       cc_clamp8((y1 + rv) >> CC_SHIFT),                    \
+                       cc_clamp8((y1 + guv) >> CC_SHIFT),                   \
+                       cc_clamp8((y1 + bu) >> CC_SHIFT));                   \
+    }
+
+static void cc_row_scalar_from(const uint8_t *src, uint8_t *dst, int x, int width,
+                               cc_format_t fmt, const cc_coef *c)
+{
+    // dst(uint8_t*) 저장이 계수 재로드를 유발하지 않도록 지역 변수로 복사
+    const int yoff = c->yoff, cy = c->cy;
+    const int crv = c->crv, cgu = c->cgu, cgv = c->cgv, cbu = c->cbu;
+
+    switch (fmt) {
+    case CC_FMT_RGB24:
+        CC_SCALAR_LOOP(3, CC_FMT_RGB24)
+        break;
+    case CC_FMT_BGRX32:
+        CC_SCALAR_LOOP(4, CC_FMT_BGRX32)
+        break;
+    case CC_FMT_RGB565:
+        CC_SCALAR_LOOP(2, CC_FMT_RGB565)
+        break;
+    }
+}
+
+static void cc_row_scalar(const uint8_t *src, uint8_t *dst, int width,
+                          cc_format_t fmt, const cc_coef *c)
+{
+    cc_row_scalar_from(src, dst, 0, width, fmt, c);
+}
+
+static void cc_store_rgb24_8(uint8_t *d, const uint8_t *r, const uint8_t *g, const uint8_t *b, int n)
+{
+    int i;
+    for (i = 0; i < n; i++) {
+        d[i * 3 + 0] = r[i];
+        d[i * 3 + 1] = g[i];
+        d[i * 3 + 2] = b[i];
+    }
+}
+
+#ifdef CC_HAVE_X86
+
+static inline int cc_pack_coef(int lo, int hi)
+{
+    return (int)(((uint32_t)(uint16_t)hi << 16) | (uint16_t)lo);
+}
+
+//------------------------------------------------------------------------------
+// SSE2: 8 픽셀 / 반복
+//------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static inline void cc_sse2_yuyv8(__m128i x, const cc_coef *c,
+                                 __m128i *r8, __m128i *g8, __m128i *b8)
+{
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i round = _mm_set1_epi32(CC_ROUND);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k_yv = _mm_set1_epi32(cc_pack_coef(c->cy, c->crv));
+    const __m128i k_yu_b = _mm_set1_epi32(cc_pack_coef(c->cy, c->cbu));
+    const __m128i k_yu_g = _mm_set1_epi32(cc_pack_coef(c->cy, -c->cgu));
+    const __m128i k_v_g = _mm_set1_epi32(cc_pack_coef(-c->cgv, 0));
+
+    // Y0..Y7, (U0 V0 U1 V1 U2 V2 U3 V3) - 128
+    __m128i ys = _mm_sub_epi16(_mm_and_si128(x, mask), _mm_set1_epi16((short)c->yoff));
+    __m128i uv = _mm_sub_epi16(_mm_srli_epi16(x, 8), c128);
+    __m128i uu = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+    __m128i vv = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+    __m128i yv_lo = _mm_unpacklo_epi16(ys, vv);
+    __m128i yv_hi = _mm_unpackhi_epi16(ys, vv);
+    __m128i yu_lo = _mm_unpacklo_epi16(ys, uu);
+    __m128i yu_hi = _mm_unpackhi_epi16(ys, uu);
+    __m128i v0_lo = _mm_unpacklo_epi16(vv, zero);
+    __m128i v0_hi = _mm_unpackhi_epi16(vv, zero);
+
+    __m128i r_lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv_lo, k_yv), round), CC_SHIFT);
+    __m128i r_hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv_hi, k_yv), round), CC_SHIFT);
+    __m128i b_lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, k_yu_b), round), CC_SHIFT);
+    __m128i b_hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, k_yu_b), round), CC_SHIFT);
+    __m128i g_lo = _mm_add_epi32(_mm_madd_epi16(yu_lo, k_yu_g), _mm_madd_epi16(v0_lo, k_v_g));
+    __m128i g_hi = _mm_add_epi32(_mm_madd_epi16(yu_hi, k_yu_g), _mm_madd_epi16(v0_hi, k_v_g));
+    g_lo = _mm_srai_epi32(_mm_add_epi32(g_lo, round), CC_SHIFT);
+    g_hi = _mm_srai_epi32(_mm_add_epi32(g_hi, round), CC_SHIFT);
+
+    __m128i r16 = _mm_packs_epi32(r_lo, r_hi);
+    __m128i g16 = _mm_packs_epi32(g_lo, g_hi);
+    __m128i b16 = _mm_packs_epi32(b_lo, b_hi);
+
+    *r8 = _mm_packus_epi16(r16, r16);
+    *g8 = _mm_packus_epi16(g16, g16);
+    *b8 = _mm_packus_epi16(b16, b16);
+}
+
+__attribute__((target("sse2")))
+static void cc_row_sse2(const uint8_t *src, uint8_t *dst, int width,
+                        cc_format_t fmt, const cc_coef *c)
+{
+    const __m128i ff = _mm_set1_epi8((char)0xFF);
+    const __m128i zero = _mm_setzero_si128();
+    int bpp = cc_bytes_per_pixel(fmt);
+    int x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i r8, g8, b8;
+        cc_sse2_yuyv8(_mm_loadu_si128((const __m128i *)(src + x * 2)), c, &r8, &g8, &b8);
+        uint8_t *d = dst + x * bpp;
+
+        if (fmt == CC_FMT_BGRX32) {
+            __m128i bg = _mm_unpacklo_epi8(b8, g8);
+            __m128i rx = _mm_unpacklo_epi8(r8, ff);
+            _mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi16(bg, rx));
+            _mm_storeu_si128((__m128i *)(d + 16), _mm_unpackhi_epi16(bg, rx));
+        } else if (fmt == CC_FMT_RGB565) {
+            __m128i r = _mm_unpacklo_epi8(r8, zero);
+            __m128i g = _mm_unpacklo_epi8(g8, zero);
+            __m128i b = _mm_unpacklo_epi8(b8, zero);
+            __m128i p = _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(r, 3), 11),
+                        _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(g, 2), 5),
+                                     _mm_srli_epi16(b, 3)));
+            _mm_storeu_si128((__m128i *)d, p);
+        } else {
+            uint8_t rr[16], gg[16], bb[16];
+            _mm_storeu_si128((__m128i *)rr, r8);
+            _mm_storeu_si128((__m128i *)gg, g8);
+            _mm_storeu_si128((__m128i *)bb, b8);
+            cc_store_rgb24_8(d, rr, gg, bb, 8);
+        }
+    }
+
+    cc_row_scalar_from(src, dst, x, width, fmt, c);
+}
+
+//------------------------------------------------------------------------------
+// AVX2: 16 픽셀 / 반복 (128비트 레인 단위 연산이므로 저장 시 레인 순서를 맞춘다)
+//------------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static void cc_row_avx2(const uint8_t *src, uint8_t *dst, int width,
+                        cc_format_t fmt, const cc_coef *c)
+{
+    const __m256i mask = _mm256_set1_epi16(0x00FF);
+    const __m256i c128 = _mm256_set1_epi16(128);
+    const __m256i yoff = _mm256_set1_epi16((short)c->yoff);
+    const __m256i round = _mm256_set1_epi32(CC_ROUND);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ff = _mm256_set1_epi8((char)0xFF);
+    const __m256i k_yv = _mm256_set1_epi32(cc_pack_coef(c->cy, c->crv));
+    const __m256i k_yu_b = _mm256_set1_epi32(cc_pack_coef(c->cy, c->cbu));
+    const __m256i k_yu_g = _mm256_set1_epi32(cc_pack_coef(c->cy, -c->cgu));
+    const __m256i k_v_g = _mm256_set1_epi32(cc_pack_coef(-c->cgv, 0));
+    int bpp = cc_bytes_per_pixel(fmt);
+    int x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src + x * 2));
+        uint8_t *d = dst + x * bpp;
+
+        __m256i ys = _mm256_sub_epi16(_mm256_and_si256(v, mask), yoff);
+        __m256i uv = _mm256_sub_epi16(_mm256_srli_epi16(v, 8), c128);
+        __m256i uu = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+        __m256i vv = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+        __m256i yv_lo = _mm256_unpacklo_epi16(ys, vv);
+        __m256i yv_hi = _mm256_unpackhi_epi16(ys, vv);
+        __m256i yu_lo = _mm256_unpacklo_epi16(ys, uu);
+        __m256i yu_hi = _mm256_unpackhi_epi16(ys, uu);
+        __m256i v0_lo = _mm256_unpacklo_epi16(vv, zero);
+        __m256i v0_hi = _mm256_unpackhi_epi16(vv, zero);
+
+        __m256i r_lo = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yv_lo, k_yv), round), CC_SHIFT);
+        __m256i r_hi = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yv_hi, k_yv), round), CC_SHIFT);
+        __m256i b_lo = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yu_lo, k_yu_b), round), CC_SHIFT);
+        __m256i b_hi = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yu_hi, k_yu_b), round), CC_SHIFT);
+        __m256i g_lo = _mm256_add_epi32(_mm256_madd_epi16(yu_lo, k_yu_g), _mm256_madd_epi16(v0_lo, k_v_g));
+        __m256i g_hi = _mm256_add_epi32(_mm256_madd_epi16(yu_hi, k_yu_g), _mm256_madd_epi16(v0_hi, k_v_g));
+        g_lo = _mm256_srai_epi32(_mm256_add_epi32(g_lo, round), CC_SHIFT);
+        g_hi = _mm256_srai_epi32(_mm256_add_epi32(g_hi, round), CC_SHIFT);
+
+        // 레인 0: 픽셀 0..7, 레인 1: 픽셀 8..15
+        __m256i r16 = _mm256_packs_epi32(r_lo, r_hi);
+        __m256i g16 = _mm256_packs_epi32(g_lo, g_hi);
+        __m256i b16 = _mm256_packs_epi32(b_lo, b_hi);
+        __m256i r8 = _mm256_packus_epi16(r16, r16);
+        __m256i g8 = _mm256_packus_epi16(g16, g16);
+        __m256i b8 = _mm256_packus_epi16(b16, b16);
+
+        if (fmt == CC_FMT_BGRX32) {
+            __m256i bg = _mm256_unpacklo_epi8(b8, g8);
+            __m256i rx = _mm256_unpacklo_epi8(r8, ff);
+            __m256i lo = _mm256_unpacklo_epi16(bg, rx);   // 픽셀 0..3 | 8..11
+            __m256i hi = _mm256_unpackhi_epi16(bg, rx);   // 픽셀 4..7 | 12..15
+            _mm256_storeu_si256((__m256i *)d, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i *)(d + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+        } else if (fmt == CC_FMT_RGB565) {
+            __m256i r = _mm256_unpacklo_epi8(r8, zero);
+            __m256i g = _mm256_unpacklo_epi8(g8, zero);
+            __m256i b = _mm256_unpacklo_epi8(b8, zero);
+            __m256i p = _mm256_or_si256(_mm256_slli_epi16(_mm256_srli_epi16(r, 3), 11),
+                        _mm256_or_si256(_mm256_slli_epi16(_mm256_srli_epi16(g, 2), 5),
+                                        _mm256_srli_epi16(b, 3)));
+            _mm256_storeu_si256((__m256i *)d, p);
+        } else {
+            uint8_t rr[32], gg[32], bb[32];
+            _mm256_storeu_si256((__m256i *)rr, r8);
+            _mm256_storeu_si256((__m256i *)gg, g8);
+            _mm256_storeu_si256((__m256i *)bb, b8);
+            cc_store_rgb24_8(d, rr, gg, bb, 8);
+            cc_store_rgb24_8(d + 24, rr + 16, gg + 16, bb + 16, 8);
+        }
+    }
+
+    cc_row_scalar_from(src, dst, x, width, fmt, c);
+}
+
+#endif // CC_HAVE_X86
+
+#ifdef CC_HAVE_NEON
+
+//------------------------------------------------------------------------------
+// NEON: 16 픽셀 / 반복 (짝수/홀수 픽셀을 따로 계산한 뒤 zip)
+//------------------------------------------------------------------------------
+
+static inline uint8x8_t cc_neon_chan(int16x8_t ys, int16x8_t a, int16_t ka,
+                                     int16x8_t b, int16_t kb, int16_t cy)
+{
+    const int32x4_t round = vdupq_n_s32(CC_ROUND);
+    int32x4_t lo = vmull_n_s16(vget_low_s16(ys), cy);
+    int32x4_t hi = vmull_n_s16(vget_high_s16(ys), cy);
+
+    lo = vmlal_n_s16(lo, vget_low_s16(a), ka);
+    hi = vmlal_n_s16(hi, vget_high_s16(a), ka);
+    lo = vmlal_n_s16(lo, vget_low_s16(b), kb);
+    hi = vmlal_n_s16(hi, vget_high_s16(b), kb);
+
+    lo = vaddq_s32(lo, round);
+    hi = vaddq_s32(hi, round);
+
+    return vqmovun_s16(vcombine_s16(vqshrn_n_s32(lo, CC_SHIFT), vqshrn_n_s32(hi, CC_SHIFT)));
+}
+
+static inline void cc_neon_store(uint8_t *d, cc_format_t fmt, uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+    if (fmt == CC_FMT_BGRX32) {
+        uint8x8x4_t px;
+        px.val[0] = b;
+        px.val[1] = g;
+        px.val[2] = r;
+        px.val[3] = vdup_n_u8(0xFF);
+        vst4_u8(d, px);
+    } else if (fmt == CC_FMT_RGB565) {
+        uint16x8_t p = vshlq_n_u16(vmovl_u8(vshr_n_u8(r, 3)), 11);
+        p = vorrq_u16(p, vshlq_n_u16(vmovl_u8(vshr_n_u8(g, 2)), 5));
+        p = vorrq_u16(p, vmovl_u8(vshr_n_u8(b, 3)));
+        vst1q_u16((uint16_t *)d, p);
+    } else {
+        uint8x8x3_t px;
+        px.val[0] = r;
+        px.val[1] = g;
+        px.val[2] = b;
+        vst3_u8(d, px);
+    }
+}
+
+static void cc_row_neon(const uint8_t *src, uint8_t *dst, int width,
+                        cc_format_t fmt, const cc_coef *c)
+{
+    const uint8x8_t c128 = vdup_n_u8(128);
+    const uint8x8_t yoff = vdup_n_u8((uint8_t)c->yoff);
+    const int16_t cy = (int16_t)c->cy;
+    int bpp = cc_bytes_per_pixel(fmt);
+    int x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        // val[0]=Y(짝수), val[1]=U, val[2]=Y(홀수), val[3]=V
+        uint8x8x4_t p = vld4_u8(src + x * 2);
+        int16x8_t u = vreinterpretq_s16_u16(vsubl_u8(p.val[1], c128));
+        int16x8_t v = vreinterpretq_s16_u16(vsubl_u8(p.val[3], c128));
+        int16x8_t ye = vreinterpretq_s16_u16(vsubl_u8(p.val[0], yoff));
+        int16x8_t yo = vreinterpretq_s16_u16(vsubl_u8(p.val[2], yoff));
+        int16x8_t zero = vdupq_n_s16(0);
+
+        uint8x8x2_t r = vzip_u8(cc_neon_chan(ye, v, (int16_t)c->crv, zero, 0, cy),
+                                cc_neon_chan(yo, v, (int16_t)c->crv, zero, 0, cy));
+        uint8x8x2_t g = vzip_u8(cc_neon_chan(ye, u, (int16_t)-c->cgu, v, (int16_t)-c->cgv, cy),
+                                cc_neon_chan(yo, u, (int16_t)-c->cgu, v, (int16_t)-c->cgv, cy));
+        uint8x8x2_t b = vzip_u8(cc_neon_chan(ye, u, (int16_t)c->cbu, zero, 0, cy),
+                                cc_neon_chan(yo, u, (int16_t)c->cbu, zero, 0, cy));
+
+        uint8_t *d = dst + x * bpp;
+        cc_neon_store(d, fmt, r.val[0], g.val[0], b.val[0]);
+        cc_neon_store(d + 8 * bpp, fmt, r.val[1], g.val[1], b.val[1]);
+    }
+
+    cc_row_scalar_from(src, dst, x, width, fmt, c);
+}
+
+#endif // CC_HAVE_NEON
+
+//------------------------------------------------------------------------------
+// 디스패치
+//------------------------------------------------------------------------------
+
+int cc_bytes_per_pixel(cc_format_t fmt)
+{
+    switch (fmt) {
+    case CC_FMT_RGB24:  return 3;
+    case CC_FMT_BGRX32: return 4;
+    case CC_FMT_RGB565: return 2;
+    }
+    return 0;
+}
+
+int cc_impl_supported(cc_impl_t impl)
+{
+    switch (impl) {
+    case CC_IMPL_AUTO:
+    case CC_IMPL_SCALAR:
+        return 1;
+#ifdef CC_HAVE_X86
+    case CC_IMPL_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case CC_IMPL_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef CC_HAVE_NEON
+    case CC_IMPL_NEON:
+        return 1;
+#endif
+    default:
+        return 0;
+    }
+}
+
+cc_impl_t cc_best_impl(void)
+{
+    static cc_impl_t best = CC_IMPL_AUTO;
+
+    // CPU 기능은 바뀌지 않으므로 첫 호출 결과를 캐시 (경쟁 시에도 같은 값이 기록됨)
+    if (best == CC_IMPL_AUTO) {
+        if (cc_impl_supported(CC_IMPL_AVX2))
+            best = CC_IMPL_AVX2;
+        else if (cc_impl_supported(CC_IMPL_SSE2))
+            best = CC_IMPL_SSE2;
+        else if (cc_impl_supported(CC_IMPL_NEON))
+            best = CC_IMPL_NEON;
+        else
+            best = CC_IMPL_SCALAR;
+    }
+    return best;
+}
+
+const char *cc_impl_name(cc_impl_t impl)
+{
+    switch (impl) {
+    case CC_IMPL_AUTO:   return "auto";
+    case CC_IMPL_SCALAR: return "scalar";
+    case CC_IMPL_SSE2:   return "sse2";
+    case CC_IMPL_AVX2:   return "avx2";
+    case CC_IMPL_NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+static cc_row_fn cc_row_function(cc_impl_t impl)
+{
+    switch (impl) {
+#ifdef CC_HAVE_X86
+    case CC_IMPL_SSE2: return cc_row_sse2;
+    case CC_IMPL_AVX2: return cc_row_avx2;
+#endif
+#ifdef CC_HAVE_NEON
+    case CC_IMPL_NEON: return cc_row_neon;
+#endif
+    case CC_IMPL_SCALAR: return cc_row_scalar;
+    default: return NULL;
+    }
+}
+
+int yuyv_convert_impl(const uint8_t *src, int src_stride,
+                      uint8_t *dst, int dst_stride,
+                      int width, int height,
+                      cc_format_t fmt, cc_matrix_t matrix, cc_range_t range,
+                      cc_impl_t impl)
+{
+    const cc_coef *c;
+    cc_row_fn row;
+    int y;
+
+    if (!src || !dst || width <= 0 || height <= 0 || (width & 1))
+        return -1;
+    if ((unsigned)matrix > CC_MATRIX_BT709 || (unsigned)range > CC_RANGE_FULL)
+        return -1;
+    if (cc_bytes_per_pixel(fmt) == 0)
+        return -1;
+
+    if (impl == CC_IMPL_AUTO)
+        impl = cc_best_impl();
+    if (!cc_impl_supported(impl))
+        return -1;
+
+    row = cc_row_function(impl);
+    if (!row)
+        return -1;
+
+    c = &cc_coefs[matrix][range];
+    for (y = 0; y < height; y++)
+        row(src + (size_t)y * src_stride, dst + (size_t)y * dst_stride, width, fmt, c);
+
+    return 0;
+}
+
+int yuyv_convert(const uint8_t *src, int src_stride,
+                 uint8_t *dst, int dst_stride,
+                 int width, int height,
+                 cc_format_t fmt, cc_matrix_t matrix, cc_range_t range)
+{
+    return yuyv_convert_impl(src, src_stride, dst, dst_stride, width, height,
+                             fmt, matrix, range, CC_IMPL_AUTO);
+}
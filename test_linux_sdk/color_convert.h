@@ -0,0 +1,73 @@
+#ifndef COLOR_CONVERT_H
+#define COLOR_CONVERT_H
+
+// YUYV(YUY2) → RGB 색변환 라이브러리
+// 모든 뷰어(test_cam, test_linux_sdk)가 공용으로 사용한다.
+//
+// 계산은 Q13 고정소수점 정수 연산만 사용하므로
+// 스칼라/SSE2/AVX2/NEON 경로의 결과가 비트 단위로 동일하다.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 색 행렬
+typedef enum {
+    CC_MATRIX_BT601 = 0,    // SD (대부분의 UVC 카메라 기본값)
+    CC_MATRIX_BT709         // HD
+} cc_matrix_t;
+
+// 입력 레인지
+typedef enum {
+    CC_RANGE_LIMITED = 0,   // Y 16..235, C 16..240
+    CC_RANGE_FULL           // Y/C 0..255 (JPEG)
+} cc_range_t;
+
+// 출력 포맷
+typedef enum {
+    CC_FMT_RGB24 = 0,       // R, G, B (SDL_PIXELFORMAT_RGB24)
+    CC_FMT_BGRX32,          // B, G, R, 0xFF (XImage 24/32bpp, cairo RGB24)
+    CC_FMT_RGB565           // 리틀엔디안 16비트 R5 G6 B5
+} cc_format_t;
+
+// 구현 경로
+typedef enum {
+    CC_IMPL_AUTO = 0,       // 런타임 CPU 감지로 최적 경로 선택
+    CC_IMPL_SCALAR,
+    CC_IMPL_SSE2,
+    CC_IMPL_AVX2,
+    CC_IMPL_NEON
+} cc_impl_t;
+
+// 출력 포맷의 픽셀당 바이트 수
+int cc_bytes_per_pixel(cc_format_t fmt);
+
+// 현재 CPU 에서 사용 가능한 구현인지 확인
+int cc_impl_supported(cc_impl_t impl);
+
+// CC_IMPL_AUTO 가 선택하는 구현
+cc_impl_t cc_best_impl(void);
+
+const char *cc_impl_name(cc_impl_t impl);
+
+// YUYV → RGB 변환 (width 는 짝수, stride 는 바이트 단위)
+// 성공 시 0, 잘못된 인자나 지원되지 않는 구현이면 -1
+int yuyv_convert(const uint8_t *src, int src_stride,
+                 uint8_t *dst, int dst_stride,
+                 int width, int height,
+                 cc_format_t fmt, cc_matrix_t matrix, cc_range_t range);
+
+// 구현 경로를 직접 지정하는 버전 (벤치마크/검증용)
+int yuyv_convert_impl(const uint8_t *src, int src_stride,
+                      uint8_t *dst, int dst_stride,
+                      int width, int height,
+                      cc_format_t fmt, cc_matrix_t matrix, cc_range_t range,
+                      cc_impl_t impl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COLOR_CONVERT_H
@@ -0,0 +1,166 @@
+//----------------------------------------------//
+//	YUYV → RGB 변환 벤치마크 / 비트 일치 검증		//
+//----------------------------------------------//
+// 사용법: ./color_convert_bench [width] [height] [iterations]
+// 모든 SIMD 경로가 스칼라 기준 구현과 비트 단위로 같은지 먼저 확인한 뒤
+// 경로별 프레임당 변환 시간을 출력한다. 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "color_convert.h"
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// 재현 가능한 의사 난수 프레임 (극단값 포함)
+static void fill_frame(unsigned char *buf, size_t size)
+{
+    unsigned int seed = 12345;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (unsigned char)(seed >> 16);
+    }
+    for (i = 0; i + 4 <= size && i < 64; i += 4) {
+        buf[i + 0] = (i & 8) ? 255 : 0;
+        buf[i + 1] = (i & 4) ? 255 : 0;
+        buf[i + 2] = (i & 16) ? 0 : 255;
+        buf[i + 3] = (i & 32) ? 0 : 255;
+    }
+}
+
+// 기존 뷰어들에 있던 double 기반 변환 (비교 기준)
+static void legacy_yuyv_to_bgrx(const unsigned char *yuyv, unsigned char *rgb, int width, int height)
+{
+    int i;
+    for (i = 0; i < width * height / 2; i++) {
+        int y0 = yuyv[i*4 + 0];
+        int u  = yuyv[i*4 + 1];
+        int y1 = yuyv[i*4 + 2];
+        int v  = yuyv[i*4 + 3];
+        int r0 = y0 + 1.402 * (v - 128);
+        int g0 = y0 - 0.344 * (u - 128) - 0.714 * (v - 128);
+        int b0 = y0 + 1.772 * (u - 128);
+        int r1 = y1 + 1.402 * (v - 128);
+        int g1 = y1 - 0.344 * (u - 128) - 0.714 * (v - 128);
+        int b1 = y1 + 1.772 * (u - 128);
+        rgb[i*8 + 0] = (b0 < 0) ? 0 : (b0 > 255) ? 255 : b0;
+        rgb[i*8 + 1] = (g0 < 0) ? 0 : (g0 > 255) ? 255 : g0;
+        rgb[i*8 + 2] = (r0 < 0) ? 0 : (r0 > 255) ? 255 : r0;
+        rgb[i*8 + 3] = 0;
+        rgb[i*8 + 4] = (b1 < 0) ? 0 : (b1 > 255) ? 255 : b1;
+        rgb[i*8 + 5] = (g1 < 0) ? 0 : (g1 > 255) ? 255 : g1;
+        rgb[i*8 + 6] = (r1 < 0) ? 0 : (r1 > 255) ? 255 : r1;
+        rgb[i*8 + 7] = 0;
+    }
+}
+
+static int verify(const unsigned char *src, int width, int height,
+                  unsigned char *ref, unsigned char *out)
+{
+    static const cc_impl_t impls[] = { CC_IMPL_SSE2, CC_IMPL_AVX2, CC_IMPL_NEON };
+    static const char *fmt_names[] = { "RGB24", "BGRX32", "RGB565" };
+    int failures = 0;
+    int f, m, r, k, w;
+
+    // 꼬리 처리 경로까지 확인하기 위해 16 의 배수가 아닌 폭도 검사
+    int widths[2];
+    widths[0] = width;
+    widths[1] = width > 18 ? width - 18 : width;
+
+    for (k = 0; k < (int)(sizeof(impls) / sizeof(impls[0])); k++) {
+        if (!cc_impl_supported(impls[k]))
+            continue;
+        for (w = 0; w < 2; w++) {
+            for (f = CC_FMT_RGB24; f <= CC_FMT_RGB565; f++) {
+                for (m = CC_MATRIX_BT601; m <= CC_MATRIX_BT709; m++) {
+                    for (r = CC_RANGE_LIMITED; r <= CC_RANGE_FULL; r++) {
+                        int cw = widths[w];
+                        int stride = cw * cc_bytes_per_pixel((cc_format_t)f);
+                        size_t bytes = (size_t)stride * height;
+
+                        memset(ref, 0xAA, bytes);
+                        memset(out, 0x55, bytes);
+                        yuyv_convert_impl(src, width * 2, ref, stride, cw, height,
+                                          (cc_format_t)f, (cc_matrix_t)m, (cc_range_t)r, CC_IMPL_SCALAR);
+                        yuyv_convert_impl(src, width * 2, out, stride, cw, height,
+                                          (cc_format_t)f, (cc_matrix_t)m, (cc_range_t)r, impls[k]);
+                        if (memcmp(ref, out, bytes) != 0) {
+                            printf("불일치: %s %s BT.%s %s width=%d\n",
+                                   cc_impl_name(impls[k]), fmt_names[f],
+                                   m == CC_MATRIX_BT601 ? "601" : "709",
+                                   r == CC_RANGE_FULL ? "full" : "limited", cw);
+                            failures++;
+                        }
+                    }
+                }
+            }
+        }
+        printf("검증 %-6s: %s\n", cc_impl_name(impls[k]), failures ? "실패" : "스칼라와 비트 일치");
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    int width = 1280;
+    int height = 720;
+    int iterations = 200;
+    int i, k;
+
+    if (argc >= 2) width = atoi(argv[1]) & ~1;
+    if (argc >= 3) height = atoi(argv[2]);
+    if (argc >= 4) iterations = atoi(argv[3]);
+    if (width <= 0 || height <= 0 || iterations <= 0) {
+        printf("사용법: %s [width] [height] [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    size_t src_size = (size_t)width * height * 2;
+    size_t dst_size = (size_t)width * height * 4;
+    unsigned char *src = (unsigned char *)malloc(src_size);
+    unsigned char *ref = (unsigned char *)malloc(dst_size);
+    unsigned char *out = (unsigned char *)malloc(dst_size);
+    if (!src || !ref || !out) {
+        printf("메모리 할당 실패\n");
+        return 2;
+    }
+    fill_frame(src, src_size);
+
+    printf("=== YUYV → RGB 변환 벤치마크 (%dx%d, %d회) ===\n", width, height, iterations);
+    printf("자동 선택 경로: %s\n", cc_impl_name(cc_best_impl()));
+
+    int failures = verify(src, width, height, ref, out);
+
+    // legacy double 루프
+    double t0 = now_ms();
+    for (i = 0; i < iterations; i++)
+        legacy_yuyv_to_bgrx(src, out, width, height);
+    double legacy_ms = (now_ms() - t0) / iterations;
+    printf("%-8s BGRX32: %8.3f ms/frame\n", "legacy", legacy_ms);
+
+    static const cc_impl_t impls[] = { CC_IMPL_SCALAR, CC_IMPL_SSE2, CC_IMPL_AVX2, CC_IMPL_NEON };
+    for (k = 0; k < (int)(sizeof(impls) / sizeof(impls[0])); k++) {
+        if (!cc_impl_supported(impls[k]))
+            continue;
+        t0 = now_ms();
+        for (i = 0; i < iterations; i++)
+            yuyv_convert_impl(src, width * 2, out, width * 4, width, height,
+                              CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_LIMITED, impls[k]);
+        double ms = (now_ms() - t0) / iterations;
+        printf("%-8s BGRX32: %8.3f ms/frame  %8.1f Mpix/s  (legacy 대비 x%.1f)\n",
+               cc_impl_name(impls[k]), ms, width * height / (ms * 1000.0), legacy_ms / ms);
+    }
+
+    free(src);
+    free(ref);
+    free(out);
+    return failures ? 1 : 0;
+}
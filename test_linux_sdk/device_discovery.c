@@ -0,0 +1,424 @@
+//----------------------------------------------//
+//	V4L2 장치 탐색 (sysfs + 동시 QUERYCAP)		//
+//----------------------------------------------//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/videodev2.h>
+#include "device_discovery.h"
+
+#ifndef V4L2_CAP_META_CAPTURE
+#define V4L2_CAP_META_CAPTURE   0x00800000
+#endif
+#ifndef V4L2_PIX_FMT_H264
+#define V4L2_PIX_FMT_H264       v4l2_fourcc('H', '2', '6', '4')
+#endif
+
+// h264_xu_ctrls.h 의 UVC_GUID_RERVISION_SYS_HW_CTRL / UVC_GUID_RERVISION_USR_HW_CTRL
+static const uint8_t dd_guid_sys[16] = {
+    0x70, 0x33, 0xf0, 0x28, 0x11, 0x63, 0x2e, 0x4a, 0xba, 0x2c, 0x68, 0x90, 0xeb, 0x33, 0x40, 0x16
+};
+static const uint8_t dd_guid_usr[16] = {
+    0x94, 0x73, 0xDF, 0xDD, 0x3E, 0x97, 0x27, 0x47, 0xBE, 0xD9, 0x04, 0xED, 0x64, 0x26, 0xDC, 0x67
+};
+
+// USB / UVC 디스크립터 값
+#define DD_DT_INTERFACE             0x04
+#define DD_DT_CS_INTERFACE          0x24
+#define DD_CLASS_VIDEO              0x0E
+#define DD_SUBCLASS_CONTROL         0x01
+#define DD_SUBCLASS_STREAMING       0x02
+#define DD_VC_HEADER                0x01
+#define DD_VC_EXTENSION_UNIT        0x06
+#define DD_VS_FORMAT_UNCOMPRESSED   0x04
+#define DD_VS_FORMAT_MJPEG          0x06
+#define DD_VS_FORMAT_FRAME_BASED    0x10
+
+#define DD_DESC_MAX                 65536
+
+static double dd_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int dd_ioctl(int fd, unsigned long request, void *arg)
+{
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r < 0 && errno == EINTR);
+    return r;
+}
+
+// sysfs 속성 한 줄 (끝의 개행 제거). 길이, 없으면 -1
+static int dd_read_attr(const char *dir, const char *attr, char *buf, size_t size)
+{
+    char path[PATH_MAX];
+    int fd;
+    ssize_t n;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, attr);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    n = read(fd, buf, size - 1);
+    close(fd);
+    if (n < 0)
+        return -1;
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' '))
+        n--;
+    buf[n] = '\0';
+    return (int)n;
+}
+
+static long dd_read_hex(const char *dir, const char *attr)
+{
+    char buf[32];
+    if (dd_read_attr(dir, attr, buf, sizeof(buf)) <= 0)
+        return -1;
+    return strtol(buf, NULL, 16);
+}
+
+static void dd_add_format(dd_device_t *d, uint32_t pixfmt)
+{
+    int i;
+    for (i = 0; i < d->format_count; i++)
+        if (d->formats[i] == pixfmt)
+            return;
+    if (d->format_count < DD_MAX_FORMATS)
+        d->formats[d->format_count++] = pixfmt;
+}
+
+// 설정 디스크립터에서 VideoControl 인터페이스 vc_if 의 기능만 본다:
+// VC 헤더의 스트리밍 인터페이스 목록, 확장 유닛 GUID, 그 스트리밍 인터페이스들의 포맷
+static void dd_parse_descriptors(dd_device_t *d, const uint8_t *p, size_t len, int vc_if)
+{
+    int cur_if = -1, cur_sub = -1;
+    uint8_t streaming[32];
+    int nstreaming = 0;
+    size_t off = 0;
+
+    while (off + 2 <= len) {
+        uint8_t blen = p[off], type = p[off + 1];
+        const uint8_t *q = p + off;
+        if (blen < 2 || off + blen > len)
+            break;
+
+        if (type == DD_DT_INTERFACE && blen >= 9) {
+            cur_if = q[5] == DD_CLASS_VIDEO ? q[2] : -1;
+            cur_sub = q[6];
+        } else if (type == DD_DT_CS_INTERFACE && blen >= 3 && cur_if >= 0) {
+            if (cur_sub == DD_SUBCLASS_CONTROL && cur_if == vc_if) {
+                if (q[2] == DD_VC_HEADER && blen >= 12) {
+                    int n = q[11], i;
+                    for (i = 0; i < n && 12 + i < blen && nstreaming < 32; i++)
+                        streaming[nstreaming++] = q[12 + i];
+                } else if (q[2] == DD_VC_EXTENSION_UNIT && blen >= 20) {
+                    if (!memcmp(q + 4, dd_guid_sys, 16)) d->xu_sys = 1;
+                    if (!memcmp(q + 4, dd_guid_usr, 16)) d->xu_usr = 1;
+                }
+            } else if (cur_sub == DD_SUBCLASS_STREAMING) {
+                int mine = 0, i;
+                for (i = 0; i < nstreaming; i++)
+                    if (streaming[i] == cur_if)
+                        mine = 1;
+                if (mine) {
+                    // 비압축 / 프레임 기반 포맷 GUID 의 앞 4 바이트가 FOURCC
+                    if (q[2] == DD_VS_FORMAT_UNCOMPRESSED && blen >= 21) {
+                        if (!memcmp(q + 5, "YUY2", 4)) dd_add_format(d, V4L2_PIX_FMT_YUYV);
+                        else if (!memcmp(q + 5, "NV12", 4)) dd_add_format(d, V4L2_PIX_FMT_NV12);
+                    } else if (q[2] == DD_VS_FORMAT_MJPEG) {
+                        dd_add_format(d, V4L2_PIX_FMT_MJPEG);
+                    } else if (q[2] == DD_VS_FORMAT_FRAME_BASED && blen >= 21) {
+                        if (!memcmp(q + 5, "H264", 4)) dd_add_format(d, V4L2_PIX_FMT_H264);
+                    }
+                }
+            }
+        }
+        off += blen;
+    }
+}
+
+// video4linux 노드 하나의 sysfs 정보
+static void dd_read_sysfs(dd_device_t *d, const char *class_dir, const char *dev_root)
+{
+    char dir[PATH_MAX], link[PATH_MAX], iface[PATH_MAX], usb[PATH_MAX], buf[64];
+    char *slash;
+
+    d->number = atoi(d->name + 5);
+    d->node_index = -1;
+    d->interface_num = -1;
+    snprintf(d->path, sizeof(d->path), "%s/video%d", dev_root, d->number);
+
+    if (snprintf(dir, sizeof(dir), "%s/video%d", class_dir, d->number) >= (int)sizeof(dir))
+        return;
+    dd_read_attr(dir, "name", d->card, sizeof(d->card));
+    if (dd_read_attr(dir, "index", buf, sizeof(buf)) > 0)
+        d->node_index = atoi(buf);
+
+    // device → USB 인터페이스 디렉터리 (1-1.2:1.0), 그 부모가 USB 장치
+    if (snprintf(link, sizeof(link), "%s/device", dir) >= (int)sizeof(link) || !realpath(link, iface))
+        return;
+    long ifnum = dd_read_hex(iface, "bInterfaceNumber");
+    slash = strrchr(iface, '/');
+    if (ifnum < 0 || !slash)
+        return;
+    memcpy(usb, iface, slash - iface);
+    usb[slash - iface] = '\0';
+
+    long vid = dd_read_hex(usb, "idVendor");
+    long pid = dd_read_hex(usb, "idProduct");
+    if (vid < 0 || pid < 0)
+        return;
+    d->interface_num = (int)ifnum;
+    d->vid = (uint16_t)vid;
+    d->pid = (uint16_t)pid;
+    long bcd = dd_read_hex(usb, "bcdDevice");
+    d->bcd_device = bcd > 0 ? (uint16_t)bcd : 0;
+    dd_read_attr(usb, "serial", d->serial, sizeof(d->serial));
+    dd_read_attr(usb, "manufacturer", d->manufacturer, sizeof(d->manufacturer));
+    dd_read_attr(usb, "product", d->product, sizeof(d->product));
+    slash = strrchr(usb, '/');
+    if (snprintf(d->usb_port, sizeof(d->usb_port), "%s", slash ? slash + 1 : usb) >= (int)sizeof(d->usb_port))
+        d->usb_port[0] = '\0';
+
+    // 장치 디스크립터 + 활성 설정 디스크립터 (커널 캐시, USB 전송 없음)
+    char path[PATH_MAX];
+    int fd = -1;
+    if (snprintf(path, sizeof(path), "%s/descriptors", usb) < (int)sizeof(path))
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        uint8_t *desc = (uint8_t *)malloc(DD_DESC_MAX);
+        ssize_t n = desc ? read(fd, desc, DD_DESC_MAX) : -1;
+        if (n > 0)
+            dd_parse_descriptors(d, desc, (size_t)n, d->interface_num);
+        free(desc);
+        close(fd);
+    }
+    if (d->xu_sys)
+        d->chip = d->xu_usr ? DD_CHIP_RER9422 : DD_CHIP_RER9420;
+}
+
+// 노드 하나 열기 + QUERYCAP + ENUM_FMT (스레드마다 하나)
+static void *dd_probe_thread(void *arg)
+{
+    dd_device_t *d = (dd_device_t *)arg;
+    double t0 = dd_now_ms();
+    struct v4l2_capability cap;
+    int fd;
+
+    fd = open(d->path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        d->probe_error = errno;
+        d->probe_ms = dd_now_ms() - t0;
+        return NULL;
+    }
+
+    memset(&cap, 0, sizeof(cap));
+    if (dd_ioctl(fd, VIDIOC_QUERYCAP, &cap) < 0) {
+        d->probe_error = errno;
+    } else {
+        d->probed = 1;
+        d->device_caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+        snprintf(d->card, sizeof(d->card), "%s", (const char *)cap.card);
+        snprintf(d->driver, sizeof(d->driver), "%s", (const char *)cap.driver);
+        snprintf(d->bus_info, sizeof(d->bus_info), "%s", (const char *)cap.bus_info);
+
+        if (d->device_caps & V4L2_CAP_VIDEO_CAPTURE) {
+            struct v4l2_fmtdesc desc;
+            d->format_count = 0;
+            memset(&desc, 0, sizeof(desc));
+            desc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            for (desc.index = 0; dd_ioctl(fd, VIDIOC_ENUM_FMT, &desc) == 0; desc.index++)
+                dd_add_format(d, desc.pixelformat);
+        }
+    }
+    close(fd);
+    d->probe_ms = dd_now_ms() - t0;
+    return NULL;
+}
+
+static void dd_classify(dd_device_t *d)
+{
+    if (d->probed) {
+        if (d->device_caps & V4L2_CAP_VIDEO_CAPTURE)
+            d->node = DD_NODE_CAPTURE;
+        else if (d->device_caps & V4L2_CAP_META_CAPTURE)
+            d->node = DD_NODE_METADATA;
+        else
+            d->node = DD_NODE_OTHER;
+    } else if (d->vid && d->node_index >= 0) {
+        // uvcvideo 는 기능마다 index 0 = 영상, 1 = 메타데이터
+        d->node = d->node_index == 0 ? DD_NODE_CAPTURE : DD_NODE_METADATA;
+    } else {
+        d->node = DD_NODE_UNKNOWN;
+    }
+
+    d->score = 0;
+    if (d->node == DD_NODE_CAPTURE) d->score += 1000;
+    else if (d->node == DD_NODE_UNKNOWN) d->score += 100;
+    if (d->node == DD_NODE_CAPTURE || d->node == DD_NODE_UNKNOWN) {
+        if (d->chip != DD_CHIP_NONE) d->score += 300;
+        if (dd_has_format(d, V4L2_PIX_FMT_H264)) d->score += 200;
+        if (dd_has_format(d, V4L2_PIX_FMT_MJPEG)) d->score += 100;
+        if (dd_has_format(d, V4L2_PIX_FMT_YUYV)) d->score += 20;
+    }
+    // 다른 프로세스가 쓰는 중
+    if (d->probe_error == EBUSY) d->score -= 500;
+}
+
+static int dd_compare(const void *a, const void *b)
+{
+    const dd_device_t *x = (const dd_device_t *)a;
+    const dd_device_t *y = (const dd_device_t *)b;
+    if (x->score != y->score)
+        return y->score - x->score;
+    return x->number - y->number;
+}
+
+int dd_discover(dd_list_t *list, const char *sysfs_root, const char *dev_root, int probe)
+{
+    char class_dir[PATH_MAX];
+    DIR *dir;
+    struct dirent *ent;
+    double t0 = dd_now_ms();
+    int i;
+
+    if (!list)
+        return -1;
+    memset(list, 0, sizeof(*list));
+    if (!sysfs_root) sysfs_root = "/sys";
+    if (!dev_root) dev_root = "/dev";
+
+    snprintf(class_dir, sizeof(class_dir), "%s/class/video4linux", sysfs_root);
+    dir = opendir(class_dir);
+    if (!dir)
+        return -1;
+    while ((ent = readdir(dir)) != NULL && list->count < DD_MAX_DEVICES) {
+        if (strncmp(ent->d_name, "video", 5) || ent->d_name[5] < '0' || ent->d_name[5] > '9' ||
+            strlen(ent->d_name) >= sizeof(list->dev[0].name))
+            continue;
+        dd_device_t *d = &list->dev[list->count++];
+        memcpy(d->name, ent->d_name, strlen(ent->d_name) + 1);
+        dd_read_sysfs(d, class_dir, dev_root);
+    }
+    closedir(dir);
+    list->sysfs_ms = dd_now_ms() - t0;
+
+    if (probe) {
+        pthread_t threads[DD_MAX_DEVICES];
+        int started[DD_MAX_DEVICES];
+        double p0 = dd_now_ms();
+
+        for (i = 0; i < list->count; i++) {
+            dd_device_t *d = &list->dev[i];
+            struct stat st;
+            started[i] = 0;
+            if (stat(d->path, &st) < 0) {
+                d->probe_error = errno;
+                continue;
+            }
+            if (!S_ISCHR(st.st_mode)) {
+                d->probe_error = ENODEV;
+                continue;
+            }
+            if (pthread_create(&threads[i], NULL, dd_probe_thread, d) == 0)
+                started[i] = 1;
+            else
+                dd_probe_thread(d);
+        }
+        for (i = 0; i < list->count; i++) {
+            if (started[i])
+                pthread_join(threads[i], NULL);
+            list->probe_sum_ms += list->dev[i].probe_ms;
+        }
+        list->probe_ms = dd_now_ms() - p0;
+    }
+
+    for (i = 0; i < list->count; i++)
+        dd_classify(&list->dev[i]);
+    qsort(list->dev, list->count, sizeof(dd_device_t), dd_compare);
+    list->total_ms = dd_now_ms() - t0;
+    return list->count;
+}
+
+int dd_has_format(const dd_device_t *d, uint32_t pixfmt)
+{
+    int i;
+    for (i = 0; i < d->format_count; i++)
+        if (d->formats[i] == pixfmt)
+            return 1;
+    return 0;
+}
+
+const dd_device_t *dd_best(const dd_list_t *list, uint32_t pixfmt)
+{
+    int i;
+    for (i = 0; i < list->count; i++) {
+        const dd_device_t *d = &list->dev[i];
+        if (d->node != DD_NODE_CAPTURE || d->probe_error == EBUSY)
+            continue;
+        if (!pixfmt || dd_has_format(d, pixfmt))
+            return d;
+    }
+    return NULL;
+}
+
+const char *dd_node_name(dd_node_t node)
+{
+    switch (node) {
+        case DD_NODE_CAPTURE:   return "capture";
+        case DD_NODE_METADATA:  return "metadata";
+        case DD_NODE_OTHER:     return "other";
+        default:                return "unknown";
+    }
+}
+
+const char *dd_chip_name(dd_chip_t chip)
+{
+    switch (chip) {
+        case DD_CHIP_RER9420:   return "RER9420";
+        case DD_CHIP_RER9422:   return "RER9421/9422";
+        default:                return "-";
+    }
+}
+
+void dd_print(const dd_list_t *list, FILE *fp)
+{
+    int i, k;
+
+    fprintf(fp, "장치 %d 개: sysfs %.2f ms, QUERYCAP %.2f ms (노드별 합 %.2f ms), 전체 %.2f ms\n",
+            list->count, list->sysfs_ms, list->probe_ms, list->probe_sum_ms, list->total_ms);
+    for (i = 0; i < list->count; i++) {
+        const dd_device_t *d = &list->dev[i];
+        char fmts[64] = "";
+        size_t len = 0;
+        for (k = 0; k < d->format_count && len + 6 < sizeof(fmts); k++) {
+            uint32_t f = d->formats[k];
+            len += snprintf(fmts + len, sizeof(fmts) - len, "%s%c%c%c%c", k ? "," : "",
+                            f & 0xFF, (f >> 8) & 0xFF, (f >> 16) & 0xFF, (f >> 24) & 0xFF);
+        }
+        fprintf(fp, "  %-12s %-8s %5d  %-24s", d->path, dd_node_name(d->node), d->score, d->card);
+        if (d->vid) {
+            fprintf(fp, " %04x:%04x fw %04x usb %s if%d serial \"%s\" chip %s", d->vid, d->pid, d->bcd_device,
+                    d->usb_port, d->interface_num, d->serial, dd_chip_name(d->chip));
+        }
+        fprintf(fp, " [%s]", fmts);
+        if (d->probe_error)
+            fprintf(fp, " (확인 실패: %s)", strerror(d->probe_error));
+        else if (d->probed)
+            fprintf(fp, " %.2f ms", d->probe_ms);
+        fprintf(fp, "\n");
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef DEVICE_DISCOVERY_H
+#define DEVICE_DISCOVERY_H
+
+// V4L2 장치 탐색 (sysfs + 동시 QUERYCAP)
+// - /sys/class/video4linux 를 훑어 노드마다 USB 장치 속성(VID / PID / 시리얼 / 포트)을 읽고,
+//   USB 장치의 descriptors 파일(설정 디스크립터 원본)에서 그 UVC 기능의 확장 유닛 GUID 와
+//   스트리밍 포맷(YUY2 / MJPEG / H.264)을 읽는다. 제어 전송이 없으므로 RER942x 계열도 XU 읽기 없이 구분한다
+// - 장치 노드 열기 + VIDIOC_QUERYCAP / ENUM_FMT 는 노드마다 스레드 하나로 동시에 한다
+//   (uvcvideo 는 open 때 USB 를 깨우므로 순서대로 열면 노드 수만큼 늘어난다)
+// - 결과는 캡처 노드 우선, RER 칩 / H.264 / MJPEG 지원 순으로 정렬한다
+// sysfs / dev 경로를 바꿔 가짜 트리로 시험할 수 있다.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DD_MAX_DEVICES      32
+#define DD_MAX_FORMATS      8
+
+typedef enum {
+    DD_NODE_UNKNOWN = 0,        // 열어 보지 못했고 sysfs 로도 알 수 없음 (USB 가 아닌 노드 등)
+    DD_NODE_CAPTURE,
+    DD_NODE_METADATA,           // uvcvideo 메타데이터 노드 (프레임 없음)
+    DD_NODE_OTHER               // M2M 코덱, 출력 등
+} dd_node_t;
+
+typedef enum {
+    DD_CHIP_NONE = 0,
+    DD_CHIP_RER9420,            // SYS XU 만 (h264_xu_ctrls 의 rervision_xu_sys_ctrls)
+    DD_CHIP_RER9422             // SYS + USR XU (RER9421 / RER9422, rervision_xu_usr_ctrls)
+} dd_chip_t;
+
+typedef struct {
+    char name[32];              // video0
+    char path[64];              // /dev/video0
+    int number;                 // N
+    int node_index;             // sysfs index (같은 기능 안에서 0 = 주 노드, 없으면 -1)
+    char card[64];              // QUERYCAP card (열지 못했으면 sysfs name)
+
+    // USB (USB 가 아니면 vid == 0)
+    char usb_port[32];          // 1-1.2
+    int interface_num;          // VideoControl 인터페이스 번호
+    uint16_t vid;
+    uint16_t pid;
+    uint16_t bcd_device;        // 펌웨어 버전
+    char serial[64];
+    char manufacturer[64];
+    char product[64];
+
+    // 디스크립터
+    int xu_sys;                 // UVC_GUID_RERVISION_SYS_HW_CTRL 확장 유닛
+    int xu_usr;                 // UVC_GUID_RERVISION_USR_HW_CTRL 확장 유닛
+    dd_chip_t chip;
+    int format_count;
+    uint32_t formats[DD_MAX_FORMATS];   // V4L2_PIX_FMT_* (열었으면 ENUM_FMT, 아니면 디스크립터)
+
+    // QUERYCAP
+    int probed;                 // 1: QUERYCAP 성공
+    int probe_error;            // errno (0 이면 성공)
+    char driver[16];
+    char bus_info[64];
+    uint32_t device_caps;
+    double probe_ms;            // 열기 + QUERYCAP + ENUM_FMT
+
+    dd_node_t node;
+    int score;                  // 정렬 기준 (클수록 앞)
+} dd_device_t;
+
+typedef struct {
+    int count;
+    double sysfs_ms;            // sysfs / 디스크립터 읽기
+    double probe_ms;            // 동시 QUERYCAP 전체 (벽시계)
+    double probe_sum_ms;        // 노드별 시간 합 (순서대로 열었을 때)
+    double total_ms;
+    dd_device_t dev[DD_MAX_DEVICES];
+} dd_list_t;
+
+// sysfs_root / dev_root 가 NULL 이면 "/sys", "/dev". probe 가 0 이면 장치 노드를 열지 않는다
+// 찾은 노드 수 (없으면 0), video4linux 디렉터리를 열 수 없으면 -1
+int dd_discover(dd_list_t *list, const char *sysfs_root, const char *dev_root, int probe);
+
+int dd_has_format(const dd_device_t *d, uint32_t pixfmt);
+
+// 정렬된 목록에서 pixfmt 를 지원하는 첫 캡처 노드 (pixfmt 0 이면 첫 캡처 노드). 없으면 NULL
+const dd_device_t *dd_best(const dd_list_t *list, uint32_t pixfmt);
+
+const char *dd_node_name(dd_node_t node);
+const char *dd_chip_name(dd_chip_t chip);
+
+void dd_print(const dd_list_t *list, FILE *fp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEVICE_DISCOVERY_H
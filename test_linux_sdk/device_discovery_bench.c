@@ -0,0 +1,384 @@
+//----------------------------------------------//
+//	장치 탐색 벤치마크 / 검증				//
+//----------------------------------------------//
+// 사용법: ./device_discovery_bench
+//   1) 가짜 sysfs 트리 (RER9422 H.264 카메라 두 기능 + 메타데이터 노드, 일반 웹캠, RER9420 카메라,
+//      USB 가 아닌 코덱 노드) 에서 VID / PID / 시리얼 / 포트 / 인터페이스, 확장 유닛으로 본 칩 계열,
+//      디스크립터 포맷, 캡처 / 메타데이터 구분, 정렬 순서를 확인
+//   2) 같은 트리의 노드를 /dev/null 로 연결해 동시 QUERYCAP 경로가 모든 노드를 열고 (ENOTTY)
+//      sysfs 분류로 물러나는지 확인
+//   3) 카메라 16 대 (노드 32 개) 트리의 탐색 시간, 이 시스템의 실제 장치 목록과 시간
+// 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <linux/videodev2.h>
+#include "device_discovery.h"
+
+#ifndef V4L2_PIX_FMT_H264
+#define V4L2_PIX_FMT_H264       v4l2_fourcc('H', '2', '6', '4')
+#endif
+
+static int failures = 0;
+static char root[64];
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        printf("  실패: %s\n", what);
+        failures++;
+    }
+}
+
+static void mkdirs(const char *path)
+{
+    char tmp[512];
+    char *p;
+
+    snprintf(tmp, sizeof(tmp), "%s", path);
+    for (p = tmp + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(tmp, 0755);
+            *p = '/';
+        }
+    }
+    mkdir(tmp, 0755);
+}
+
+static void write_file(const char *dir, const char *name, const void *data, size_t len)
+{
+    char path[512];
+    FILE *fp;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    fp = fopen(path, "wb");
+    if (!fp)
+        return;
+    fwrite(data, 1, len, fp);
+    fclose(fp);
+}
+
+static void write_attr(const char *dir, const char *name, const char *value)
+{
+    char line[128];
+    snprintf(line, sizeof(line), "%s\n", value);
+    write_file(dir, name, line, strlen(line));
+}
+
+// ===== USB 설정 디스크립터 만들기 =====
+
+typedef struct {
+    uint8_t buf[1024];
+    size_t len;
+} desc_t;
+
+static void put(desc_t *d, const uint8_t *p, size_t n)
+{
+    memcpy(d->buf + d->len, p, n);
+    d->len += n;
+}
+
+static const uint8_t guid_sys[16] = {
+    0x70, 0x33, 0xf0, 0x28, 0x11, 0x63, 0x2e, 0x4a, 0xba, 0x2c, 0x68, 0x90, 0xeb, 0x33, 0x40, 0x16
+};
+static const uint8_t guid_usr[16] = {
+    0x94, 0x73, 0xDF, 0xDD, 0x3E, 0x97, 0x27, 0x47, 0xBE, 0xD9, 0x04, 0xED, 0x64, 0x26, 0xDC, 0x67
+};
+static const uint8_t guid_other[16] = {
+    0x41, 0x76, 0x9e, 0xa2, 0x04, 0xde, 0xe3, 0x47, 0x8b, 0x2b, 0xf4, 0x34, 0x1a, 0xff, 0x00, 0x3b
+};
+
+#define F_YUY2      0x01
+#define F_MJPEG     0x02
+#define F_H264      0x04
+
+static void put_interface(desc_t *d, int num, int subclass)
+{
+    uint8_t p[9] = { 9, 0x04, (uint8_t)num, 0, 0, 0x0E, (uint8_t)subclass, 0, 0 };
+    put(d, p, sizeof(p));
+}
+
+// VideoControl (vc_if) + VideoStreaming (vc_if + 1) 한 기능
+static void put_function(desc_t *d, int vc_if, int xu_sys, int xu_usr, int formats)
+{
+    uint8_t iad[8] = { 8, 0x0B, (uint8_t)vc_if, 2, 0x0E, 0x03, 0, 0 };
+    uint8_t hdr[13] = { 13, 0x24, 0x01, 0x00, 0x01, 0, 0, 0, 0, 0, 0, 1, (uint8_t)(vc_if + 1) };
+    uint8_t xu[26];
+    uint8_t it[18] = { 18, 0x24, 0x02, 1, 0x01, 0x02, 0, 0 };
+
+    put(d, iad, sizeof(iad));
+    put_interface(d, vc_if, 0x01);
+    put(d, hdr, sizeof(hdr));
+    put(d, it, sizeof(it));
+    memset(xu, 0, sizeof(xu));
+    xu[0] = sizeof(xu);
+    xu[1] = 0x24;
+    xu[2] = 0x06;
+    xu[3] = 3;
+    memcpy(xu + 4, guid_other, 16);     // 다른 제조사 XU 는 무시
+    put(d, xu, sizeof(xu));
+    if (xu_sys) {
+        memcpy(xu + 4, guid_sys, 16);
+        put(d, xu, sizeof(xu));
+    }
+    if (xu_usr) {
+        xu[3] = 4;
+        memcpy(xu + 4, guid_usr, 16);
+        put(d, xu, sizeof(xu));
+    }
+
+    put_interface(d, vc_if + 1, 0x02);
+    if (formats & F_YUY2) {
+        uint8_t f[27] = { 27, 0x24, 0x04, 1, 1, 'Y', 'U', 'Y', '2', 0x00, 0x00, 0x10, 0x00,
+                          0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71, 16 };
+        put(d, f, sizeof(f));
+    }
+    if (formats & F_MJPEG) {
+        uint8_t f[11] = { 11, 0x24, 0x06, 2, 1, 1, 1, 0, 0, 0, 0 };
+        put(d, f, sizeof(f));
+    }
+    if (formats & F_H264) {
+        uint8_t f[28] = { 28, 0x24, 0x10, 3, 1, 'H', '2', '6', '4', 0x00, 0x00, 0x10, 0x00,
+                          0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71, 16 };
+        put(d, f, sizeof(f));
+    }
+    // 대체 설정 (같은 인터페이스 번호 반복)
+    uint8_t alt[9] = { 9, 0x04, (uint8_t)(vc_if + 1), 1, 1, 0x0E, 0x02, 0, 0 };
+    put(d, alt, sizeof(alt));
+}
+
+typedef struct {
+    const char *port;
+    uint16_t vid, pid, bcd;
+    const char *serial;
+    const char *product;
+    int functions;          // UVC 기능 수 (기능마다 영상 + 메타데이터 노드)
+    int xu_sys, xu_usr;
+    int formats[2];         // 기능별
+} fake_camera_t;
+
+// USB 카메라 하나와 그 video4linux 노드들. 다음 노드 번호를 돌려준다
+static int add_camera(const fake_camera_t *cam, int node)
+{
+    char usb[256], iface[320], cls[256], path[512], buf[32];
+    desc_t d;
+    int f;
+
+    snprintf(usb, sizeof(usb), "%s/sys/devices/platform/soc/usb1/%s", root, cam->port);
+    mkdirs(usb);
+    snprintf(buf, sizeof(buf), "%04x", cam->vid);
+    write_attr(usb, "idVendor", buf);
+    snprintf(buf, sizeof(buf), "%04x", cam->pid);
+    write_attr(usb, "idProduct", buf);
+    snprintf(buf, sizeof(buf), "%04x", cam->bcd);
+    write_attr(usb, "bcdDevice", buf);
+    if (cam->serial)
+        write_attr(usb, "serial", cam->serial);
+    write_attr(usb, "manufacturer", "HD Camera Manufacturer");
+    write_attr(usb, "product", cam->product);
+
+    memset(&d, 0, sizeof(d));
+    uint8_t dev[18] = { 18, 0x01, 0x00, 0x02, 0xEF, 0x02, 0x01, 64,
+                        (uint8_t)cam->vid, (uint8_t)(cam->vid >> 8), (uint8_t)cam->pid, (uint8_t)(cam->pid >> 8) };
+    uint8_t cfg[9] = { 9, 0x02, 0, 0, (uint8_t)(cam->functions * 2), 1, 0, 0x80, 250 };
+    put(&d, dev, sizeof(dev));
+    put(&d, cfg, sizeof(cfg));
+    for (f = 0; f < cam->functions; f++)
+        put_function(&d, f * 2, cam->xu_sys, cam->xu_usr, cam->formats[f]);
+    write_file(usb, "descriptors", d.buf, d.len);
+
+    for (f = 0; f < cam->functions; f++) {
+        int k;
+        snprintf(iface, sizeof(iface), "%s/%s:1.%d", usb, cam->port, f * 2);
+        mkdirs(iface);
+        snprintf(buf, sizeof(buf), "%02x", f * 2);
+        write_attr(iface, "bInterfaceNumber", buf);
+        for (k = 0; k < 2; k++, node++) {
+            snprintf(cls, sizeof(cls), "%s/sys/class/video4linux/video%d", root, node);
+            mkdirs(cls);
+            write_attr(cls, "name", cam->product);
+            snprintf(buf, sizeof(buf), "%d", k);
+            write_attr(cls, "index", buf);
+            snprintf(path, sizeof(path), "%s/device", cls);
+            if (symlink(iface, path) < 0 && errno != EEXIST)
+                check(0, "device 링크 생성");
+        }
+    }
+    return node;
+}
+
+static void add_platform_node(int node)
+{
+    char dir[256], cls[256], path[512];
+    snprintf(dir, sizeof(dir), "%s/sys/devices/platform/soc/codec", root);
+    mkdirs(dir);
+    snprintf(cls, sizeof(cls), "%s/sys/class/video4linux/video%d", root, node);
+    mkdirs(cls);
+    write_attr(cls, "name", "bcm2835-codec-decode");
+    write_attr(cls, "index", "0");
+    snprintf(path, sizeof(path), "%s/device", cls);
+    if (symlink(dir, path) < 0 && errno != EEXIST)
+        check(0, "device 링크 생성");
+}
+
+static const dd_device_t *find(const dd_list_t *l, const char *name)
+{
+    int i;
+    for (i = 0; i < l->count; i++)
+        if (!strcmp(l->dev[i].name, name))
+            return &l->dev[i];
+    return NULL;
+}
+
+static void remove_tree(void)
+{
+    char cmd[128];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", root);
+    if (system(cmd) != 0)
+        printf("  %s 삭제 실패\n", root);
+}
+
+// ===== 1) / 2) 가짜 트리 검증 =====
+
+static void verify_fake_tree(void)
+{
+    static const fake_camera_t rer9422 = {
+        "1-1.2", 0x0c45, 0x6366, 0x0102, "SN0001", "H264 USB Camera", 2, 1, 1, { F_YUY2 | F_MJPEG, F_H264 }
+    };
+    static const fake_camera_t webcam = {
+        "1-1.3", 0x046d, 0x0825, 0x0012, NULL, "UVC Camera", 1, 0, 0, { F_YUY2 | F_MJPEG, 0 }
+    };
+    static const fake_camera_t rer9420 = {
+        "1-1.4", 0x0c45, 0x62c0, 0x0100, "SN0420", "USB Camera", 1, 1, 0, { F_YUY2 | F_MJPEG, 0 }
+    };
+    char sysfs[128], dev[128], path[256], target[256];
+    dd_list_t *list = (dd_list_t *)malloc(sizeof(dd_list_t));
+    int node = 0, i;
+
+    if (!list)
+        return;
+    snprintf(sysfs, sizeof(sysfs), "%s/sys", root);
+    snprintf(dev, sizeof(dev), "%s/dev", root);
+    node = add_camera(&rer9422, node);      // video0..3
+    node = add_camera(&webcam, node);       // video4, 5
+    node = add_camera(&rer9420, node);      // video6, 7
+    add_platform_node(10);
+
+    printf("[가짜 sysfs] 장치 노드 없이 (sysfs / 디스크립터만)\n");
+    int n = dd_discover(list, sysfs, dev, 0);
+    dd_print(list, stdout);
+    check(n == 9, "노드 9 개");
+
+    static const char *order[] = { "video2", "video0", "video6", "video4", "video10",
+                                   "video1", "video3", "video5", "video7" };
+    int ordered = n == 9;
+    for (i = 0; ordered && i < 9; i++)
+        ordered = !strcmp(list->dev[i].name, order[i]);
+    check(ordered, "정렬: H.264 RER > RER MJPEG > 일반 웹캠 > 알 수 없음 > 메타데이터");
+
+    const dd_device_t *d = find(list, "video2");
+    check(d && d->vid == 0x0c45 && d->pid == 0x6366 && d->bcd_device == 0x0102 &&
+          !strcmp(d->serial, "SN0001") && !strcmp(d->usb_port, "1-1.2") && d->interface_num == 2,
+          "video2 USB 속성 (VID / PID / 펌웨어 / 시리얼 / 포트 / 인터페이스)");
+    check(d && d->chip == DD_CHIP_RER9422 && d->node == DD_NODE_CAPTURE &&
+          d->format_count == 1 && dd_has_format(d, V4L2_PIX_FMT_H264), "video2: RER9422, H.264 만");
+    d = find(list, "video0");
+    check(d && d->interface_num == 0 && dd_has_format(d, V4L2_PIX_FMT_YUYV) &&
+          dd_has_format(d, V4L2_PIX_FMT_MJPEG) && !dd_has_format(d, V4L2_PIX_FMT_H264),
+          "video0: 첫 기능의 YUYV / MJPEG 만 (다른 기능 포맷 섞이지 않음)");
+    d = find(list, "video6");
+    check(d && d->chip == DD_CHIP_RER9420, "video6: SYS XU 만 → RER9420");
+    d = find(list, "video4");
+    check(d && d->chip == DD_CHIP_NONE && d->serial[0] == '\0' && d->node == DD_NODE_CAPTURE,
+          "video4: 일반 웹캠 (XU 없음, 시리얼 없음)");
+    d = find(list, "video5");
+    check(d && d->node == DD_NODE_METADATA, "video5: 메타데이터 노드");
+    d = find(list, "video10");
+    check(d && d->vid == 0 && d->node == DD_NODE_UNKNOWN, "video10: USB 아님");
+    d = dd_best(list, V4L2_PIX_FMT_MJPEG);
+    check(d && !strcmp(d->name, "video0"), "MJPEG 최선 = video0");
+    d = dd_best(list, 0);
+    check(d && !strcmp(d->name, "video2"), "최선 = video2");
+
+    // 2) 노드를 문자 장치(/dev/null)로 연결: 모든 노드를 동시에 열고 QUERYCAP 은 ENOTTY
+    mkdirs(dev);
+    for (i = 0; i < 11; i++) {
+        snprintf(path, sizeof(path), "%s/video%d", dev, i);
+        snprintf(target, sizeof(target), "/dev/null");
+        if (i == 8 || i == 9)
+            continue;
+        if (symlink(target, path) < 0 && errno != EEXIST)
+            check(0, "dev 링크 생성");
+    }
+    printf("[가짜 sysfs] 노드 → /dev/null, 동시 QUERYCAP\n");
+    n = dd_discover(list, sysfs, dev, 1);
+    dd_print(list, stdout);
+    int all_enotty = n == 9;
+    for (i = 0; i < n; i++)
+        all_enotty &= list->dev[i].probe_error == ENOTTY && !list->dev[i].probed;
+    check(all_enotty, "모든 노드를 열고 QUERYCAP 이 ENOTTY");
+    ordered = n == 9;
+    for (i = 0; ordered && i < 9; i++)
+        ordered = !strcmp(list->dev[i].name, order[i]);
+    check(ordered, "QUERYCAP 실패 시 sysfs 분류로 같은 순서");
+
+    free(list);
+}
+
+// ===== 3) 시간 =====
+
+static void bench_scale(void)
+{
+    char sysfs[128], dev[128], port[16];
+    dd_list_t *list = (dd_list_t *)malloc(sizeof(dd_list_t));
+    int node = 0, i;
+    double best = 1e9;
+
+    if (!list)
+        return;
+    for (i = 0; i < 16; i++) {
+        fake_camera_t cam = { port, 0x0c45, 0x6366, 0x0102, "SN", "H264 USB Camera", 1, 1, 1, { F_YUY2 | F_MJPEG, 0 } };
+        snprintf(port, sizeof(port), "2-1.%d", i + 1);
+        node = add_camera(&cam, node);
+    }
+    snprintf(sysfs, sizeof(sysfs), "%s/sys", root);
+    snprintf(dev, sizeof(dev), "%s/nodev", root);
+    for (i = 0; i < 10; i++) {
+        dd_discover(list, sysfs, dev, 1);
+        if (list->total_ms < best)
+            best = list->total_ms;
+    }
+    printf("[시간] 가짜 트리 노드 %d 개 탐색: %.2f ms (10 회 중 최소)\n", list->count, best);
+    check(list->count == DD_MAX_DEVICES, "노드 32 개");
+
+    printf("[시간] 이 시스템의 장치\n");
+    if (dd_discover(list, NULL, NULL, 1) < 0)
+        printf("  /sys/class/video4linux 없음\n");
+    else
+        dd_print(list, stdout);
+    free(list);
+}
+
+int main(void)
+{
+    snprintf(root, sizeof(root), "/tmp/device_discovery_bench_%d", (int)getpid());
+    mkdirs(root);
+
+    verify_fake_tree();
+    remove_tree();
+    mkdirs(root);
+    bench_scale();
+    remove_tree();
+
+    if (failures) {
+        printf("실패 %d 건\n", failures);
+        return 1;
+    }
+    printf("모두 통과\n");
+    return 0;
+}
@@ -0,0 +1,276 @@
+//----------------------------------------------//
+//	캡처 포맷 / 해상도 / 프레임 간격 표		//
+//----------------------------------------------//
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <linux/videodev2.h>
+#include "format_table.h"
+
+// STEPWISE / CONTINUOUS 크기에서 고를 후보
+static const int ft_common_sizes[][2] = {
+    {160, 120}, {320, 240}, {352, 288}, {640, 360}, {640, 480}, {800, 600},
+    {1024, 768}, {1280, 720}, {1280, 960}, {1280, 1024}, {1600, 1200}, {1920, 1080},
+    {2560, 1440}, {3840, 2160}
+};
+
+// STEPWISE / CONTINUOUS 간격에서 고를 후보 (fps)
+static const int ft_common_rates[] = { 120, 90, 60, 50, 30, 25, 24, 20, 15, 10, 5 };
+
+static int ft_ioctl(int fd, unsigned long request, void *arg)
+{
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r < 0 && errno == EINTR);
+    return r;
+}
+
+// a 가 b 보다 빠른 간격이면 음수
+static int ft_interval_cmp(const ft_interval_t *a, const ft_interval_t *b)
+{
+    uint64_t l = (uint64_t)a->num * b->den;
+    uint64_t r = (uint64_t)b->num * a->den;
+    return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+static void ft_add_rate(ft_size_t *s, uint32_t num, uint32_t den)
+{
+    ft_interval_t iv;
+    int i, j;
+
+    if (!num || !den || s->rate_count >= FT_MAX_RATES)
+        return;
+    iv.num = num;
+    iv.den = den;
+    for (i = 0; i < s->rate_count; i++) {
+        int c = ft_interval_cmp(&iv, &s->rates[i]);
+        if (c == 0)
+            return;
+        if (c < 0)
+            break;
+    }
+    for (j = s->rate_count; j > i; j--)
+        s->rates[j] = s->rates[j - 1];
+    s->rates[i] = iv;
+    s->rate_count++;
+}
+
+static void ft_probe_rates(int fd, ft_size_t *s)
+{
+    struct v4l2_frmivalenum ival;
+
+    memset(&ival, 0, sizeof(ival));
+    ival.pixel_format = s->pixfmt;
+    ival.width = s->width;
+    ival.height = s->height;
+    for (ival.index = 0; ft_ioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &ival) == 0; ival.index++) {
+        if (ival.type == V4L2_FRMIVAL_TYPE_DISCRETE) {
+            ft_add_rate(s, ival.discrete.numerator, ival.discrete.denominator);
+            continue;
+        }
+        // 연속/계단형: 범위 안의 흔한 FPS 와 양 끝
+        const struct v4l2_fract *lo = &ival.stepwise.min;   // 가장 짧은 간격
+        const struct v4l2_fract *hi = &ival.stepwise.max;
+        size_t k;
+        ft_add_rate(s, lo->numerator, lo->denominator);
+        for (k = 0; k < sizeof(ft_common_rates) / sizeof(ft_common_rates[0]); k++) {
+            ft_interval_t iv = { 1, (uint32_t)ft_common_rates[k] };
+            ft_interval_t a = { lo->numerator, lo->denominator };
+            ft_interval_t b = { hi->numerator, hi->denominator };
+            if (ft_interval_cmp(&iv, &a) >= 0 && ft_interval_cmp(&iv, &b) <= 0)
+                ft_add_rate(s, iv.num, iv.den);
+        }
+        ft_add_rate(s, hi->numerator, hi->denominator);
+        break;
+    }
+}
+
+static void ft_add_size(int fd, ft_table_t *t, uint32_t pixfmt, int width, int height)
+{
+    struct v4l2_format fmt;
+    ft_size_t *s;
+    int i;
+
+    if (t->count >= FT_MAX_SIZES || ft_find(t, pixfmt, width, height))
+        return;
+
+    // 면적 순으로 끼워 넣는다 (같은 포맷 안에서)
+    for (i = 0; i < t->count; i++) {
+        const ft_size_t *o = &t->sizes[i];
+        if (o->pixfmt == pixfmt && o->width * o->height > width * height)
+            break;
+    }
+    memmove(&t->sizes[i + 1], &t->sizes[i], (t->count - i) * sizeof(ft_size_t));
+    t->count++;
+
+    s = &t->sizes[i];
+    memset(s, 0, sizeof(*s));
+    s->pixfmt = pixfmt;
+    s->width = width;
+    s->height = height;
+
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.pixelformat = pixfmt;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    s->validated = ft_ioctl(fd, VIDIOC_TRY_FMT, &fmt) == 0 && fmt.fmt.pix.pixelformat == pixfmt &&
+                   (int)fmt.fmt.pix.width == width && (int)fmt.fmt.pix.height == height;
+
+    ft_probe_rates(fd, s);
+}
+
+int ft_probe(int fd, ft_table_t *t)
+{
+    struct v4l2_fmtdesc desc;
+
+    if (fd < 0 || !t)
+        return -1;
+    memset(t, 0, sizeof(*t));
+
+    memset(&desc, 0, sizeof(desc));
+    desc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    for (desc.index = 0; ft_ioctl(fd, VIDIOC_ENUM_FMT, &desc) == 0; desc.index++) {
+        struct v4l2_frmsizeenum fs;
+        memset(&fs, 0, sizeof(fs));
+        fs.pixel_format = desc.pixelformat;
+        for (fs.index = 0; ft_ioctl(fd, VIDIOC_ENUM_FRAMESIZES, &fs) == 0; fs.index++) {
+            if (fs.type == V4L2_FRMSIZE_TYPE_DISCRETE) {
+                ft_add_size(fd, t, desc.pixelformat, fs.discrete.width, fs.discrete.height);
+                continue;
+            }
+            size_t k;
+            for (k = 0; k < sizeof(ft_common_sizes) / sizeof(ft_common_sizes[0]); k++) {
+                uint32_t w = ft_common_sizes[k][0], h = ft_common_sizes[k][1];
+                if (w < fs.stepwise.min_width || w > fs.stepwise.max_width ||
+                    h < fs.stepwise.min_height || h > fs.stepwise.max_height)
+                    continue;
+                if ((fs.stepwise.step_width && (w - fs.stepwise.min_width) % fs.stepwise.step_width) ||
+                    (fs.stepwise.step_height && (h - fs.stepwise.min_height) % fs.stepwise.step_height))
+                    continue;
+                ft_add_size(fd, t, desc.pixelformat, w, h);
+            }
+            break;
+        }
+    }
+    return t->count ? t->count : -1;
+}
+
+const ft_size_t *ft_find(const ft_table_t *t, uint32_t pixfmt, int width, int height)
+{
+    int i;
+
+    for (i = 0; t && i < t->count; i++) {
+        const ft_size_t *s = &t->sizes[i];
+        if (s->pixfmt == pixfmt && s->width == width && s->height == height)
+            return s;
+    }
+    return NULL;
+}
+
+int ft_pick_rate(const ft_size_t *s, int fps, ft_interval_t *out)
+{
+    int i;
+
+    if (!s || s->rate_count == 0)
+        return -1;
+    // rates 는 빠른 순이므로 뒤에서부터 fps 이상인 첫 간격
+    for (i = s->rate_count - 1; i >= 0; i--) {
+        if (ft_interval_fps(&s->rates[i]) + 0.01 >= fps) {
+            *out = s->rates[i];
+            return 0;
+        }
+    }
+    *out = s->rates[0];
+    return 0;
+}
+
+const ft_size_t *ft_snap(const ft_table_t *t, uint32_t pixfmt, int *width, int *height, int *fps)
+{
+    const ft_size_t *best = NULL;
+    long best_cost = 0;
+    int i;
+
+    for (i = 0; t && i < t->count; i++) {
+        const ft_size_t *s = &t->sizes[i];
+        if (s->pixfmt != pixfmt || !s->validated)
+            continue;
+        // 크기 차이 (면적 차이가 같으면 가로세로 차이가 작은 쪽)
+        long cost = labs((long)s->width * s->height - (long)*width * *height) * 4 +
+                    labs((long)s->width - *width) + labs((long)s->height - *height);
+        if (!best || cost < best_cost) {
+            best = s;
+            best_cost = cost;
+        }
+    }
+    if (!best)
+        return NULL;
+
+    *width = best->width;
+    *height = best->height;
+    ft_interval_t iv;
+    if (ft_pick_rate(best, *fps, &iv) == 0)
+        *fps = (int)(ft_interval_fps(&iv) + 0.5);
+    return best;
+}
+
+int ft_resolutions(const ft_table_t *t, uint32_t pixfmt, int (*out)[2], int max_count)
+{
+    int i, n = 0;
+
+    for (i = 0; t && i < t->count && n < max_count; i++) {
+        const ft_size_t *s = &t->sizes[i];
+        if (s->pixfmt != pixfmt || !s->validated)
+            continue;
+        out[n][0] = s->width;
+        out[n][1] = s->height;
+        n++;
+    }
+    return n;
+}
+
+int ft_frame_rates(const ft_table_t *t, uint32_t pixfmt, int width, int height, int *out, int max_count)
+{
+    const ft_size_t *s = ft_find(t, pixfmt, width, height);
+    int i, j, n = 0;
+
+    if (!s)
+        return 0;
+    // 느린 순 (오름차순), 정수로 반올림한 값이 같으면 하나만
+    for (i = s->rate_count - 1; i >= 0 && n < max_count; i--) {
+        int fps = (int)(ft_interval_fps(&s->rates[i]) + 0.5);
+        for (j = 0; j < n && out[j] != fps; j++)
+            ;
+        if (j == n && fps > 0)
+            out[n++] = fps;
+    }
+    return n;
+}
+
+void ft_print(FILE *fp, const ft_table_t *t)
+{
+    uint32_t last = 0;
+    int i, k;
+
+    for (i = 0; t && i < t->count; i++) {
+        const ft_size_t *s = &t->sizes[i];
+        if (s->pixfmt != last) {
+            fprintf(fp, "%c%c%c%c:\n", (int)(s->pixfmt & 0xff), (int)((s->pixfmt >> 8) & 0xff),
+                    (int)((s->pixfmt >> 16) & 0xff), (int)((s->pixfmt >> 24) & 0xff));
+            last = s->pixfmt;
+        }
+        fprintf(fp, "  %4dx%-4d%s", s->width, s->height, s->validated ? " " : "?");
+        for (k = 0; k < s->rate_count; k++) {
+            const ft_interval_t *iv = &s->rates[k];
+            if (iv->num == 1)
+                fprintf(fp, " %u", iv->den);
+            else
+                fprintf(fp, " %.2f", ft_interval_fps(iv));
+        }
+        fprintf(fp, " fps\n");
+    }
+}
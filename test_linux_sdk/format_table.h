@@ -0,0 +1,67 @@
+#ifndef FORMAT_TABLE_H
+#define FORMAT_TABLE_H
+
+// 카메라가 실제로 지원하는 포맷 / 해상도 / 프레임 간격 표
+// VIDIOC_ENUM_FMT → ENUM_FRAMESIZES → ENUM_FRAMEINTERVALS 로 한 번만 만들고,
+// 항목마다 VIDIOC_TRY_FMT 로 드라이버가 그 크기를 그대로 받는지 확인해 둔다 (스트리밍 중에도 안전).
+// 스트리밍 중 포맷 전환은 이 표로 요청을 먼저 맞춰 두므로 S_FMT / S_PARM 이 실패해 멈추는 일이 없다.
+//
+// 연속/계단형(STEPWISE) 크기는 흔한 해상도 목록 중 범위 안에 드는 것만 넣는다.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FT_MAX_SIZES        64
+#define FT_MAX_RATES        12
+
+typedef struct {
+    uint32_t num;               // timeperframe = num / den 초
+    uint32_t den;
+} ft_interval_t;
+
+typedef struct {
+    uint32_t pixfmt;
+    int width;
+    int height;
+    int validated;              // TRY_FMT 가 같은 크기를 돌려줌
+    int rate_count;
+    ft_interval_t rates[FT_MAX_RATES];  // 빠른 순
+} ft_size_t;
+
+typedef struct {
+    int count;
+    ft_size_t sizes[FT_MAX_SIZES];  // 포맷, 면적 순
+} ft_table_t;
+
+// fd 의 캡처 포맷 표를 만든다. 항목 수, 실패 -1
+int ft_probe(int fd, ft_table_t *t);
+
+const ft_size_t *ft_find(const ft_table_t *t, uint32_t pixfmt, int width, int height);
+
+// fps 를 낼 수 있는 가장 느린 간격 (없으면 가장 빠른 간격). 항목에 간격이 없으면 -1
+int ft_pick_rate(const ft_size_t *s, int fps, ft_interval_t *out);
+
+static inline double ft_interval_fps(const ft_interval_t *iv)
+{
+    return iv->num ? (double)iv->den / iv->num : 0.0;
+}
+
+// 요청을 표에서 가장 가까운 검증된 크기 / 간격으로 맞춘다 (같은 포맷 안에서)
+// width/height/fps 를 고쳐 쓰고 항목을 돌려준다. 포맷이 표에 없으면 NULL
+const ft_size_t *ft_snap(const ft_table_t *t, uint32_t pixfmt, int *width, int *height, int *fps);
+
+// 포맷 하나의 해상도 / 정수 FPS 목록 (중복 제거, 오름차순). 개수
+int ft_resolutions(const ft_table_t *t, uint32_t pixfmt, int (*out)[2], int max_count);
+int ft_frame_rates(const ft_table_t *t, uint32_t pixfmt, int width, int height, int *out, int max_count);
+
+void ft_print(FILE *fp, const ft_table_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FORMAT_TABLE_H
@@ -0,0 +1,790 @@
+#include "frame_source.h"
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <sys/timerfd.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "sdk_deps/OSD-Linux_H264_AP_0724/v4l2uvc.h"
+#include "sdk_deps/OSD-Linux_H264_AP_0724/nalu.h"
+#include "sdk_deps/OSD-Linux_H264_AP_0724/mjpeg_dht.h"
+
+static int source_ioctl(int fd, unsigned long request, void *arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (-1 == r && EINTR == errno);
+    return r;
+}
+
+// ===== V4L2FrameSource =====
+
+V4L2FrameSource::V4L2FrameSource(struct vdIn *vd_, int width_, int height_,
+                                 unsigned int pixfmt_, int buffer_count_) {
+    vd = vd_;
+    frame_width = width_;
+    frame_height = height_;
+    pixfmt = pixfmt_;
+    buffer_count = buffer_count_;
+    if (buffer_count > FRAME_SOURCE_MAX_BUFFERS) buffer_count = FRAME_SOURCE_MAX_BUFFERS;
+    if (buffer_count < 2) buffer_count = 2;
+    streaming = 0;
+    memset(lengths, 0, sizeof(lengths));
+}
+
+V4L2FrameSource::~V4L2FrameSource() {
+    stop();
+}
+
+int V4L2FrameSource::start() {
+    if (!vd || vd->fd < 0) return -1;
+    if (streaming) return 0;
+
+    // 버퍼 요청
+    struct v4l2_requestbuffers req;
+    memset(&req, 0, sizeof(req));
+    req.count = buffer_count;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+
+    if (-1 == source_ioctl(vd->fd, VIDIOC_REQBUFS, &req)) {
+        printf("VIDIOC_REQBUFS 실패: %s\n", strerror(errno));
+        return -1;
+    }
+    if (req.count < 2) {
+        printf("버퍼 수 부족: %u\n", req.count);
+        return -1;
+    }
+    if (req.count > FRAME_SOURCE_MAX_BUFFERS) req.count = FRAME_SOURCE_MAX_BUFFERS;
+    buffer_count = req.count;
+
+    // 버퍼 매핑 및 큐잉
+    for (int i = 0; i < buffer_count; i++) {
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+
+        if (-1 == source_ioctl(vd->fd, VIDIOC_QUERYBUF, &buf)) {
+            printf("VIDIOC_QUERYBUF 실패\n");
+            return -1;
+        }
+
+        vd->mem[i] = mmap(NULL, buf.length, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, vd->fd, buf.m.offset);
+        if (MAP_FAILED == vd->mem[i]) {
+            vd->mem[i] = NULL;
+            printf("mmap 실패\n");
+            return -1;
+        }
+        lengths[i] = buf.length;
+
+        if (-1 == source_ioctl(vd->fd, VIDIOC_QBUF, &buf)) {
+            printf("VIDIOC_QBUF 실패\n");
+            return -1;
+        }
+    }
+
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (-1 == source_ioctl(vd->fd, VIDIOC_STREAMON, &type)) {
+        printf("VIDIOC_STREAMON 실패\n");
+        return -1;
+    }
+
+    streaming = 1;
+    return 0;
+}
+
+int V4L2FrameSource::stop() {
+    if (!vd) return 0;
+
+    if (streaming) {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (-1 == source_ioctl(vd->fd, VIDIOC_STREAMOFF, &type)) {
+            printf("VIDIOC_STREAMOFF 실패\n");
+        }
+        streaming = 0;
+    }
+
+    for (int i = 0; i < FRAME_SOURCE_MAX_BUFFERS; i++) {
+        if (vd->mem[i] && lengths[i]) {
+            munmap(vd->mem[i], lengths[i]);
+            vd->mem[i] = NULL;
+            lengths[i] = 0;
+        }
+    }
+
+    // 큐 해제 (vb2 큐가 남아 있으면 uvcvideo 가 S_FMT 를 EBUSY 로 거부한다)
+    if (vd->fd >= 0) {
+        struct v4l2_requestbuffers req;
+        memset(&req, 0, sizeof(req));
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        if (-1 == source_ioctl(vd->fd, VIDIOC_REQBUFS, &req)) {
+            printf("VIDIOC_REQBUFS(0) 실패\n");
+        }
+    }
+    return 0;
+}
+
+int V4L2FrameSource::dequeue(FrameDesc *desc) {
+    if (!streaming || !desc) return -1;
+
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+
+    if (-1 == source_ioctl(vd->fd, VIDIOC_DQBUF, &buf)) {
+        return -1;  // errno 그대로 전달 (EAGAIN 포함)
+    }
+
+    desc->index = buf.index;
+    desc->data = (unsigned char *)vd->mem[buf.index];
+    desc->bytesused = buf.bytesused;
+    desc->sequence = buf.sequence;
+    desc->timestamp = buf.timestamp;
+
+    // 오래된 드라이버는 gettimeofday 기준 timestamp 를 준다 → CLOCK_MONOTONIC 으로 변환
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) != V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        struct timespec mono, real;
+        clock_gettime(CLOCK_MONOTONIC, &mono);
+        clock_gettime(CLOCK_REALTIME, &real);
+        long long age_us = 0;
+        if (buf.timestamp.tv_sec || buf.timestamp.tv_usec) {
+            age_us = ((long long)real.tv_sec - buf.timestamp.tv_sec) * 1000000LL +
+                     real.tv_nsec / 1000 - buf.timestamp.tv_usec;
+            if (age_us < 0) age_us = 0;
+        }
+        long long mono_us = (long long)mono.tv_sec * 1000000LL + mono.tv_nsec / 1000 - age_us;
+        desc->timestamp.tv_sec = mono_us / 1000000LL;
+        desc->timestamp.tv_usec = mono_us % 1000000LL;
+    }
+    return 0;
+}
+
+int V4L2FrameSource::enqueue(int index) {
+    if (!streaming || index < 0 || index >= buffer_count) return -1;
+
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+
+    if (-1 == source_ioctl(vd->fd, VIDIOC_QBUF, &buf)) {
+        printf("VIDIOC_QBUF 실패: %s\n", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int V4L2FrameSource::fd() const {
+    return vd ? vd->fd : -1;
+}
+
+// ===== PacedFrameSource =====
+
+static int timespec_before(const struct timespec *a, const struct timespec *b) {
+    return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec <= b->tv_nsec);
+}
+
+static void timespec_offset(struct timespec *dst, const struct timespec *base, long long ns) {
+    long long nsec = base->tv_nsec + ns % 1000000000LL;
+    dst->tv_sec = base->tv_sec + (time_t)(ns / 1000000000LL);
+    if (nsec >= 1000000000LL) {
+        dst->tv_sec++;
+        nsec -= 1000000000LL;
+    }
+    dst->tv_nsec = (long)nsec;
+}
+
+PacedFrameSource::PacedFrameSource(int buffer_count_) {
+    buffer_count = buffer_count_;
+    if (buffer_count > FRAME_SOURCE_MAX_BUFFERS) buffer_count = FRAME_SOURCE_MAX_BUFFERS;
+    if (buffer_count < 2) buffer_count = 2;
+    sequence = 0;
+    next_index = 0;
+    streaming = 0;
+    realtime = 1;
+    end_of_stream = 0;
+    done_head = 0;
+    done_count = 0;
+    memset(&base_time, 0, sizeof(base_time));
+    memset(&next_deadline, 0, sizeof(next_deadline));
+    memset(state, 0, sizeof(state));
+    memset(seqs, 0, sizeof(seqs));
+    memset(stamps, 0, sizeof(stamps));
+    memset(done, 0, sizeof(done));
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        printf("프레임 소스 timerfd 생성 실패: %s\n", strerror(errno));
+    }
+    pthread_mutex_init(&lock, NULL);
+}
+
+PacedFrameSource::~PacedFrameSource() {
+    if (timer_fd >= 0) close(timer_fd);
+    pthread_mutex_destroy(&lock);
+}
+
+int PacedFrameSource::start() {
+    if (streaming) return 0;
+    if (prepare() < 0) return -1;
+
+    for (int i = 0; i < buffer_count; i++) {
+        state[i] = BUF_QUEUED;
+    }
+
+    pthread_mutex_lock(&lock);
+    sequence = 0;
+    next_index = 0;
+    done_head = 0;
+    done_count = 0;
+    end_of_stream = 0;
+    clock_gettime(CLOCK_MONOTONIC, &base_time);
+    next_deadline = base_time;
+    streaming = 1;
+    armTimer();
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+int PacedFrameSource::stop() {
+    pthread_mutex_lock(&lock);
+    streaming = 0;
+    armTimer();
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+// next_index 부터 큐에 있는 버퍼 하나 (없으면 -1)
+int PacedFrameSource::findQueued() const {
+    for (int n = 0; n < buffer_count; n++) {
+        int i = (next_index + n) % buffer_count;
+        if (state[i] == BUF_QUEUED) return i;
+    }
+    return -1;
+}
+
+// 지금까지 지난 마감 시각마다 큐에 있는 버퍼 하나를 채운다 (lock 보유 상태에서 호출)
+void PacedFrameSource::produce(const struct timespec *now) {
+    if (!realtime) return;
+
+    while (!end_of_stream) {
+        long long offset = frameOffsetNs(sequence);
+        if (offset < 0) {
+            end_of_stream = 1;
+            break;
+        }
+        timespec_offset(&next_deadline, &base_time, offset);
+        if (!timespec_before(&next_deadline, now)) break;
+
+        int index = findQueued();
+        unsigned int seq = sequence++;
+        if (index >= 0) {
+            // 내용은 dequeue() 에서 채운다 (버려지는 프레임에는 비용을 쓰지 않음)
+            state[index] = BUF_FILLED;
+            seqs[index] = seq;
+            stamps[index] = next_deadline;
+            done[(done_head + done_count) % FRAME_SOURCE_MAX_BUFFERS] = index;
+            done_count++;
+            next_index = (index + 1) % buffer_count;
+        }
+        // 빈 버퍼가 없으면 실제 드라이버처럼 이 프레임은 사라진다
+    }
+}
+
+// 꺼낼 프레임이 있으면 즉시, 없으면 다음 마감 시각에 timerfd 가 readable 이 되도록 설정
+// (timerfd_settime 은 누적된 만료 횟수를 0 으로 되돌린다)
+void PacedFrameSource::armTimer() {
+    if (timer_fd < 0) return;
+
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    int flags = 0;
+    // 스트림 끝도 readable 로 알려 소비자가 ENODATA 를 받게 한다
+    int ready = done_count > 0 || end_of_stream;
+    if (!realtime && !ready) {
+        // 페이싱 없음: 큐에 버퍼가 하나라도 있으면 바로 꺼낼 수 있다
+        ready = findQueued() >= 0;
+    }
+    if (!streaming || (!ready && !realtime)) {
+        // 타이머 해제 (enqueue() 에서 다시 설정)
+    } else if (ready) {
+        its.it_value.tv_nsec = 1;
+    } else {
+        its.it_value = next_deadline;
+        flags = TFD_TIMER_ABSTIME;
+    }
+    timerfd_settime(timer_fd, flags, &its, NULL);
+}
+
+int PacedFrameSource::dequeue(FrameDesc *desc) {
+    if (!desc) return -1;
+
+    pthread_mutex_lock(&lock);
+    if (!streaming) {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    produce(&now);
+
+    int index = -1;
+    if (done_count > 0) {
+        index = done[done_head];
+        done_head = (done_head + 1) % FRAME_SOURCE_MAX_BUFFERS;
+        done_count--;
+    } else if (!realtime && !end_of_stream) {
+        // 페이싱 없음: 큐에 있는 버퍼를 바로 채운다
+        if (frameOffsetNs(sequence) < 0) {
+            end_of_stream = 1;
+        } else {
+            index = findQueued();
+            if (index >= 0) {
+                seqs[index] = sequence++;
+                stamps[index] = now;
+                next_index = (index + 1) % buffer_count;
+            }
+        }
+    }
+    if (index < 0) {
+        // 아직 마감 시각 전이거나 모든 버퍼가 소비자에게 나가 있음 (V4L2 와 동일하게 EAGAIN)
+        int eos = end_of_stream;
+        armTimer();
+        pthread_mutex_unlock(&lock);
+        errno = eos ? ENODATA : EAGAIN;
+        return -1;
+    }
+    state[index] = BUF_DEQUEUED;
+    unsigned int seq = seqs[index];
+    struct timespec stamp = stamps[index];
+    armTimer();
+    pthread_mutex_unlock(&lock);
+
+    fill(index, seq, desc);
+
+    desc->index = index;
+    desc->sequence = seq;
+    desc->timestamp.tv_sec = stamp.tv_sec;
+    desc->timestamp.tv_usec = stamp.tv_nsec / 1000;
+    return 0;
+}
+
+int PacedFrameSource::enqueue(int index) {
+    if (index < 0 || index >= buffer_count) return -1;
+
+    pthread_mutex_lock(&lock);
+    state[index] = BUF_QUEUED;
+    if (!realtime) armTimer();
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+// ===== SyntheticFrameSource =====
+
+SyntheticFrameSource::SyntheticFrameSource(int width_, int height_, int buffer_count_)
+    : PacedFrameSource(buffer_count_) {
+    frame_width = width_ & ~1;
+    frame_height = height_;
+    frame_size = (size_t)frame_width * frame_height * 2;
+    frame_interval_ns = 1000000000L / 30;
+    pattern = FRAME_PATTERN_BARS;
+    realtime = 0;       // setFrameRate() 전에는 페이싱 없음
+    memset(buffers, 0, sizeof(buffers));
+}
+
+SyntheticFrameSource::~SyntheticFrameSource() {
+    stop();
+    for (int i = 0; i < FRAME_SOURCE_MAX_BUFFERS; i++) {
+        free(buffers[i]);
+        buffers[i] = NULL;
+    }
+}
+
+void SyntheticFrameSource::setFrameRate(int fps) {
+    if (fps > 0) frame_interval_ns = 1000000000L / fps;
+    realtime = fps > 0;
+}
+
+long long SyntheticFrameSource::frameOffsetNs(unsigned int seq) {
+    return (long long)seq * frame_interval_ns;
+}
+
+int SyntheticFrameSource::prepare() {
+    for (int i = 0; i < buffer_count; i++) {
+        if (!buffers[i]) {
+            buffers[i] = (unsigned char *)malloc(frame_size);
+            if (!buffers[i]) {
+                printf("합성 버퍼 할당 실패\n");
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+void SyntheticFrameSource::fill(int index, unsigned int seq, FrameDesc *desc) {
+    switch (pattern) {
+        case FRAME_PATTERN_BOX:
+            renderBox(buffers[index], seq);
+            break;
+        case FRAME_PATTERN_NOISE:
+            renderNoise(buffers[index], seq);
+            break;
+        default:
+            renderBars(buffers[index], seq);
+            break;
+    }
+    desc->data = buffers[index];
+    desc->bytesused = (unsigned int)frame_size;
+}
+
+// 시퀀스에 따라 이동하는 세로 컬러 바 패턴
+void SyntheticFrameSource::renderBars(unsigned char *dst, unsigned int seq) {
+    static const unsigned char bars[8][3] = {
+        // Y, U, V (BT.601 limited range 컬러 바)
+        {235, 128, 128}, {210,  16, 146}, {170, 166,  16}, {145,  54,  34},
+        {106, 202, 222}, { 81,  90, 240}, { 41, 240, 110}, { 16, 128, 128},
+    };
+    int bar_width = frame_width / 8;
+    if (bar_width < 2) bar_width = 2;
+    int shift = (int)((seq * 4) % (unsigned int)frame_width) & ~1;
+
+    unsigned char *row0 = dst;
+    for (int x = 0; x < frame_width; x += 2) {
+        const unsigned char *c = bars[((x + shift) % frame_width) / bar_width % 8];
+        row0[x * 2 + 0] = c[0];
+        row0[x * 2 + 1] = c[1];
+        row0[x * 2 + 2] = c[0];
+        row0[x * 2 + 3] = c[2];
+    }
+    size_t stride = (size_t)frame_width * 2;
+    for (int y = 1; y < frame_height; y++) {
+        memcpy(dst + y * stride, row0, stride);
+    }
+}
+
+// 세로 휘도 그라데이션 배경 위에서 좌우로 왕복하는 흰 상자
+void SyntheticFrameSource::renderBox(unsigned char *dst, unsigned int seq) {
+    size_t stride = (size_t)frame_width * 2;
+    int box_w = (frame_width / 8) & ~1;
+    int box_h = frame_height / 6;
+    if (box_w < 2) box_w = 2;
+    if (box_h < 1) box_h = 1;
+    int travel = frame_width - box_w;
+    int box_x = 0;
+    if (travel > 0) {
+        int pos = (int)((seq * 8) % (unsigned int)(travel * 2));
+        box_x = (pos < travel ? pos : travel * 2 - pos) & ~1;
+    }
+    int box_y = (frame_height - box_h) / 2;
+
+    for (int y = 0; y < frame_height; y++) {
+        unsigned char *row = dst + y * stride;
+        memset(row, 64 + y * 128 / frame_height, stride);
+        for (size_t x = 1; x < stride; x += 2) row[x] = 128;
+        if (y >= box_y && y < box_y + box_h) {
+            for (int x = box_x; x < box_x + box_w; x++) row[x * 2] = 235;
+        }
+    }
+}
+
+// xorshift 휘도 잡음 (시퀀스마다 다른 시드, 색차는 회색)
+void SyntheticFrameSource::renderNoise(unsigned char *dst, unsigned int seq) {
+    unsigned long long s = 0x9E3779B97F4A7C15ULL * (seq + 1);
+    size_t n = frame_size;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        dst[i + 0] = (unsigned char)s;
+        dst[i + 1] = 128;
+        dst[i + 2] = (unsigned char)(s >> 8);
+        dst[i + 3] = 128;
+        dst[i + 4] = (unsigned char)(s >> 16);
+        dst[i + 5] = 128;
+        dst[i + 6] = (unsigned char)(s >> 24);
+        dst[i + 7] = 128;
+    }
+    for (; i < n; i += 2) {
+        dst[i] = (unsigned char)(s >> 32);
+        dst[i + 1] = 128;
+    }
+}
+
+// ===== FileFrameSource =====
+
+FileFrameSource::FileFrameSource(int buffer_count_) : PacedFrameSource(buffer_count_) {
+    file_fd = -1;
+    map = NULL;
+    map_size = 0;
+    frames = NULL;
+    frame_count = 0;
+    frame_capacity = 0;
+    loop_ns = 0;
+    frame_interval_ns = 1000000000L / 30;
+    loop = 0;
+    has_pts = 0;
+    frame_width = 0;
+    frame_height = 0;
+    pixfmt = 0;
+}
+
+FileFrameSource::~FileFrameSource() {
+    stop();
+    if (map) munmap(map, map_size);
+    if (file_fd >= 0) close(file_fd);
+    free(frames);
+}
+
+void FileFrameSource::setFrameRate(int fps) {
+    if (fps > 0) frame_interval_ns = 1000000000L / fps;
+}
+
+int FileFrameSource::addFrame(size_t offset, size_t size) {
+    if (size == 0 || size > 0xFFFFFFFFu) return 0;
+    if (frame_count == frame_capacity) {
+        int cap = frame_capacity ? frame_capacity * 2 : 1024;
+        FileFrame *p = (FileFrame *)realloc(frames, cap * sizeof(FileFrame));
+        if (!p) {
+            printf("재생 색인 할당 실패\n");
+            return -1;
+        }
+        frames = p;
+        frame_capacity = cap;
+    }
+    frames[frame_count].offset = offset;
+    frames[frame_count].size = (unsigned int)size;
+    frames[frame_count].pts_ns = (long long)frame_count * frame_interval_ns;
+    frame_count++;
+    return 0;
+}
+
+int FileFrameSource::indexYUYV() {
+    if (frame_width <= 0 || frame_height <= 0) {
+        printf("YUYV 재생에는 해상도가 필요합니다\n");
+        return -1;
+    }
+    size_t size = (size_t)frame_width * frame_height * 2;
+    size_t count = map_size / size;
+    for (size_t i = 0; i < count; i++) {
+        if (addFrame(i * size, size) < 0) return -1;
+    }
+    if (map_size % size) {
+        printf("YUYV 파일 끝 %zu 바이트 무시 (프레임 크기 %zu)\n", map_size % size, size);
+    }
+    return 0;
+}
+
+// SOI 를 찾고, 마커 세그먼트를 따라 엔트로피 데이터까지 건너뛴 뒤 EOI 를 찾는다
+// (엔트로피 데이터의 FF 는 00 / RSTn / FF 채움만 뒤따르므로 FF D9 는 EOI 뿐)
+int FileFrameSource::indexMJPEG() {
+    size_t pos = 0;
+    unsigned long skipped = 0;
+
+    while (pos + 4 <= map_size) {
+        unsigned char *soi = (unsigned char *)memchr(map + pos, 0xFF, map_size - pos - 1);
+        if (!soi) break;
+        if (soi[1] != 0xD8) {
+            pos = soi - map + 1;
+            continue;
+        }
+        size_t start = soi - map;
+        size_t avail = map_size - start;
+        MJPEG_INFO info;
+        if (MjpegParse(soi, avail > 0xFFFFFFFFu ? 0xFFFFFFFFu : (unsigned int)avail, &info) < 0) {
+            skipped++;
+            pos = start + 2;
+            continue;
+        }
+        size_t p = start + info.data_offset;
+        size_t end = 0;
+        while (p + 1 < map_size) {
+            unsigned char *ff = (unsigned char *)memchr(map + p, 0xFF, map_size - p - 1);
+            if (!ff) break;
+            if (ff[1] == 0xD9) {
+                end = ff - map + 2;
+                break;
+            }
+            p = ff - map + 1;
+        }
+        if (!end) {
+            skipped++;      // 잘린 마지막 프레임
+            break;
+        }
+        if (frame_count == 0) {
+            frame_width = info.width;
+            frame_height = info.height;
+        }
+        if (addFrame(start, end - start) < 0) return -1;
+        pos = end;
+    }
+    if (skipped) printf("MJPEG 재생: 손상/잘린 프레임 %lu 개 건너뜀\n", skipped);
+    return 0;
+}
+
+// 액세스 유닛 경계: VCL NAL 이 나온 뒤의 AUD/SEI/SPS/PPS(14~18 포함) 또는
+// first_mb_in_slice == 0 (ue(v) 첫 비트 1) 인 새 슬라이스
+int FileFrameSource::indexH264() {
+    unsigned char *end = map + map_size;
+    unsigned char *p = FindNextH264StartCode(map, end);
+    long long au_start = -1;
+    int au_has_vcl = 0;
+    int have_sps = 0;
+
+    while (p < end) {
+        unsigned char *sc = p - 3;
+        if (sc > map && sc[-1] == 0) sc--;
+        unsigned char *next = FindNextH264StartCode(p, end);
+        int type = p[0] & 0x1F;
+        int vcl = type == 1 || type == 5;
+        int starts_au = 0;
+
+        if (vcl) {
+            starts_au = au_has_vcl && p + 1 < end && (p[1] & 0x80);
+        } else if (type == 6 || type == 7 || type == 8 || type == 9 || (type >= 14 && type <= 18)) {
+            starts_au = au_has_vcl;
+        }
+        if (au_start < 0) {
+            au_start = sc - map;
+        } else if (starts_au) {
+            if (addFrame((size_t)au_start, (size_t)(sc - map - au_start)) < 0) return -1;
+            au_start = sc - map;
+            au_has_vcl = 0;
+        }
+        if (vcl) au_has_vcl = 1;
+
+        if (type == 7 && !have_sps) {
+            unsigned char *stop = next < end ? next - 3 : end;
+            while (stop > p && stop[-1] == 0) stop--;
+            H264_SPS sps;
+            if (H264ParseSps(p, (unsigned int)(stop - p), &sps) == 0) {
+                frame_width = sps.width;
+                frame_height = sps.height;
+                have_sps = 1;
+            }
+        }
+        p = next;
+    }
+    if (au_start >= 0 && addFrame((size_t)au_start, map_size - (size_t)au_start) < 0) return -1;
+    if (!have_sps) printf("H.264 재생: SPS 없음 (해상도 모름)\n");
+    return 0;
+}
+
+// "<파일>.pts": '#' 줄은 무시, 나머지 줄마다 프레임 하나의 timestamp (ms, 소수 허용)
+// 줄 수가 프레임보다 적으면 나머지는 마지막 간격으로 이어 붙인다
+void FileFrameSource::loadTimestamps(const char *path) {
+    char name[512];
+    snprintf(name, sizeof(name), "%s.pts", path);
+    FILE *fp = fopen(name, "r");
+    if (!fp) return;
+
+    char line[128];
+    int n = 0;
+    double first = 0, prev = 0;
+    while (n < frame_count && fgets(line, sizeof(line), fp)) {
+        char *endp;
+        if (line[0] == '#') continue;
+        double ms = strtod(line, &endp);
+        if (endp == line) continue;
+        if (n == 0) first = ms;
+        if (ms < prev) ms = prev;   // 역행하는 timestamp 는 직전 값으로
+        frames[n].pts_ns = (long long)((ms - first) * 1e6);
+        prev = ms;
+        n++;
+    }
+    fclose(fp);
+    if (n == 0) return;
+
+    long long step = n >= 2 ? frames[n - 1].pts_ns - frames[n - 2].pts_ns : frame_interval_ns;
+    for (int i = n; i < frame_count; i++) {
+        frames[i].pts_ns = frames[i - 1].pts_ns + step;
+    }
+    has_pts = 1;
+    printf("재생 timestamp: %s (%d / %d 프레임)\n", name, n, frame_count);
+}
+
+int FileFrameSource::open(const char *path, unsigned int pixfmt_, int width_, int height_) {
+    if (map || !path) return -1;
+
+    file_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (file_fd < 0) {
+        printf("재생 파일 열기 실패: %s (%s)\n", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(file_fd, &st) < 0 || st.st_size < 4) {
+        printf("재생 파일이 비어 있음: %s\n", path);
+        return -1;
+    }
+    map_size = (size_t)st.st_size;
+    // MAP_PRIVATE + 쓰기 허용: 소비자가 버퍼에 써도 그 페이지만 복사된다
+    void *m = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_fd, 0);
+    if (m == MAP_FAILED) {
+        printf("재생 파일 mmap 실패: %s\n", strerror(errno));
+        map_size = 0;
+        return -1;
+    }
+    map = (unsigned char *)m;
+    madvise(map, map_size, MADV_WILLNEED);
+
+    if (pixfmt_ == 0) {
+        if (map[0] == 0xFF && map[1] == 0xD8) {
+            pixfmt_ = V4L2_PIX_FMT_MJPEG;
+        } else if (map[0] == 0 && map[1] == 0 && (map[2] == 1 || (map[2] == 0 && map[3] == 1))) {
+            pixfmt_ = V4L2_PIX_FMT_H264;
+        } else {
+            pixfmt_ = V4L2_PIX_FMT_YUYV;
+        }
+    }
+    pixfmt = pixfmt_;
+    frame_width = width_ & ~1;
+    frame_height = height_;
+
+    int r;
+    if (pixfmt == V4L2_PIX_FMT_MJPEG) {
+        r = indexMJPEG();
+    } else if (pixfmt == V4L2_PIX_FMT_H264) {
+        r = indexH264();
+    } else if (pixfmt == V4L2_PIX_FMT_YUYV) {
+        r = indexYUYV();
+    } else {
+        printf("재생할 수 없는 포맷: 0x%08X\n", pixfmt);
+        r = -1;
+    }
+    if (r < 0 || frame_count == 0) {
+        if (r == 0) printf("재생 파일에 프레임이 없음: %s\n", path);
+        return -1;
+    }
+
+    loadTimestamps(path);
+    long long last = frame_count >= 2 ? frames[frame_count - 1].pts_ns - frames[frame_count - 2].pts_ns
+                                      : frame_interval_ns;
+    loop_ns = frames[frame_count - 1].pts_ns + (last > 0 ? last : frame_interval_ns);
+    return 0;
+}
+
+long long FileFrameSource::frameOffsetNs(unsigned int seq) {
+    if (frame_count == 0) return -1;
+    if (!loop && seq >= (unsigned int)frame_count) return -1;
+    unsigned int n = seq % (unsigned int)frame_count;
+    return (long long)(seq / (unsigned int)frame_count) * loop_ns + frames[n].pts_ns;
+}
+
+void FileFrameSource::fill(int index, unsigned int seq, FrameDesc *desc) {
+    (void)index;
+    const FileFrame *f = &frames[seq % (unsigned int)frame_count];
+    desc->data = map + f->offset;
+    desc->bytesused = f->size;
+}
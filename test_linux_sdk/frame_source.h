@@ -0,0 +1,231 @@
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+#include <linux/videodev2.h>
+
+// v4l2uvc.h 에는 include guard 가 없으므로 전방 선언만 사용
+struct vdIn;
+
+// 소스가 관리할 수 있는 최대 버퍼 수 (v4l2uvc.h 의 NB_BUFFER 와 동일)
+#define FRAME_SOURCE_MAX_BUFFERS 16
+
+// 디큐된 프레임 하나에 대한 설명
+typedef struct {
+    int index;                  // 소스 내부 버퍼 인덱스
+    unsigned char *data;        // mmap/소스 버퍼를 직접 가리킴 (복사 없음)
+    unsigned int bytesused;
+    unsigned int sequence;      // v4l2_buffer.sequence
+    struct timeval timestamp;   // 캡처 시각 (항상 CLOCK_MONOTONIC 기준)
+} FrameDesc;
+
+// 프레임 소스 인터페이스
+// dequeue()로 받은 버퍼는 enqueue()로 돌려주기 전까지 소스가 재사용하지 않는다.
+// dequeue()는 사용 가능한 프레임이 없으면 -1 을 반환하고 errno 를 EAGAIN 으로 설정한다.
+// (재생 파일처럼 끝이 있는 소스는 끝나면 errno 를 ENODATA 로 설정)
+// (블록하지 않으므로 fd() 를 poll()/epoll 로 기다린 뒤 호출)
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+
+    virtual int start() = 0;
+    virtual int stop() = 0;
+    virtual int dequeue(FrameDesc *desc) = 0;
+    virtual int enqueue(int index) = 0;
+
+    virtual int bufferCount() const = 0;
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+    virtual unsigned int pixelFormat() const = 0;
+
+    // poll()/epoll 용 파일 디스크립터 (없으면 -1)
+    virtual int fd() const { return -1; }
+};
+
+// V4L2 mmap 소스 (이미 열리고 포맷이 설정된 vdIn 을 사용)
+class V4L2FrameSource : public FrameSource {
+private:
+    struct vdIn *vd;
+    int buffer_count;
+    size_t lengths[FRAME_SOURCE_MAX_BUFFERS];
+    int frame_width;
+    int frame_height;
+    unsigned int pixfmt;
+    int streaming;
+
+public:
+    V4L2FrameSource(struct vdIn *vd, int width, int height, unsigned int pixfmt,
+                    int buffer_count);
+    virtual ~V4L2FrameSource();
+
+    virtual int start();
+    virtual int stop();
+    virtual int dequeue(FrameDesc *desc);
+    virtual int enqueue(int index);
+
+    virtual int bufferCount() const { return buffer_count; }
+    virtual int width() const { return frame_width; }
+    virtual int height() const { return frame_height; }
+    virtual unsigned int pixelFormat() const { return pixfmt; }
+    virtual int fd() const;
+};
+
+// 카메라를 흉내 내는 소프트웨어 소스의 공통 큐/페이싱 (합성, 파일 재생)
+// 실시간 모드에서는 카메라처럼 소비 속도와 무관하게 마감 시각마다 큐에 있는 버퍼를 채우고,
+// 빈 버퍼가 없으면 그 프레임을 버린다 (sequence 는 증가).
+// 채워진 버퍼의 timestamp 는 마감 시각이므로 지연 측정의 기준이 된다.
+// 페이싱 없음 모드에서는 큐에 버퍼가 있는 한 바로 다음 프레임을 내주고 timestamp 는 디큐 시각.
+// 스트림이 끝나면 fd() 가 readable 이 되고 dequeue() 는 -1, errno = ENODATA.
+class PacedFrameSource : public FrameSource {
+protected:
+    enum { BUF_QUEUED, BUF_FILLED, BUF_DEQUEUED };
+
+    int state[FRAME_SOURCE_MAX_BUFFERS];
+    unsigned int seqs[FRAME_SOURCE_MAX_BUFFERS];
+    struct timespec stamps[FRAME_SOURCE_MAX_BUFFERS];
+    int done[FRAME_SOURCE_MAX_BUFFERS];   // 채워진 버퍼 FIFO (드라이버의 done 큐)
+    int done_head;
+    int done_count;
+    int buffer_count;
+    unsigned int sequence;
+    int next_index;
+    int streaming;
+    int realtime;                   // 0 이면 페이싱 없음
+    int end_of_stream;
+    struct timespec base_time;      // start() 시각 (프레임 오프셋의 기준)
+    struct timespec next_deadline;
+    int timer_fd;                   // fd() 로 노출: 꺼낼 프레임이 있으면 readable
+    pthread_mutex_t lock;
+
+    // seq 번째 프레임의 시작 기준 오프셋 (ns). 스트림 끝이면 -1 (lock 보유 상태에서 호출)
+    virtual long long frameOffsetNs(unsigned int seq) = 0;
+    // start() 에서 한 번 (버퍼 할당 등)
+    virtual int prepare() { return 0; }
+    // 디큐된 버퍼에 seq 번째 프레임을 채우고 data/bytesused 를 설정 (lock 밖에서 호출)
+    virtual void fill(int index, unsigned int seq, FrameDesc *desc) = 0;
+
+    int findQueued() const;
+    void produce(const struct timespec *now);
+    void armTimer();
+
+public:
+    explicit PacedFrameSource(int buffer_count);
+    virtual ~PacedFrameSource();
+
+    // 1: 실시간 페이싱 (기본), 0: 가능한 한 빠르게
+    void setRealtime(int on) { realtime = on; }
+
+    virtual int start();
+    virtual int stop();
+    virtual int dequeue(FrameDesc *desc);
+    virtual int enqueue(int index);
+
+    virtual int bufferCount() const { return buffer_count; }
+    virtual int fd() const { return timer_fd; }
+};
+
+// 합성 YUYV 패턴 (카메라 없이 파이프라인 테스트용)
+enum {
+    FRAME_PATTERN_BARS = 0,         // 시퀀스에 따라 이동하는 컬러 바 (모든 픽셀이 변함)
+    FRAME_PATTERN_BOX,              // 정지 배경 위를 움직이는 밝은 상자 (모션 감지 셀 몇 개만 변함)
+    FRAME_PATTERN_NOISE             // 프레임마다 새 휘도 잡음 (압축/차분 최악 조건)
+};
+
+class SyntheticFrameSource : public PacedFrameSource {
+private:
+    unsigned char *buffers[FRAME_SOURCE_MAX_BUFFERS];
+    int frame_width;
+    int frame_height;
+    size_t frame_size;
+    long frame_interval_ns;
+    int pattern;
+
+    void renderBars(unsigned char *dst, unsigned int seq);
+    void renderBox(unsigned char *dst, unsigned int seq);
+    void renderNoise(unsigned char *dst, unsigned int seq);
+
+protected:
+    virtual long long frameOffsetNs(unsigned int seq);
+    virtual int prepare();
+    virtual void fill(int index, unsigned int seq, FrameDesc *desc);
+
+public:
+    SyntheticFrameSource(int width, int height, int buffer_count);
+    virtual ~SyntheticFrameSource();
+
+    // 카메라처럼 fps 간격으로 프레임을 내보낸다 (0 이면 가능한 한 빠르게)
+    void setFrameRate(int fps);
+    void setPattern(int pattern_) { pattern = pattern_; }
+
+    virtual int width() const { return frame_width; }
+    virtual int height() const { return frame_height; }
+    virtual unsigned int pixelFormat() const { return V4L2_PIX_FMT_YUYV; }
+};
+
+// 녹화 파일 재생 소스 (raw YUYV, MJPEG 연결, Annex-B H.264)
+// 파일을 mmap 하고 open() 에서 프레임 경계를 한 번 색인한다. 프레임 데이터는 매핑을 직접
+// 가리키므로 복사가 없다 (MAP_PRIVATE 라 소비자가 써도 파일은 바뀌지 않음).
+// - YUYV: width * height * 2 바이트씩
+// - MJPEG: SOI ~ EOI (마커 세그먼트를 따라 SOS 까지 건너뛰고 엔트로피 데이터에서 EOI 검색)
+// - H.264: 액세스 유닛 (AUD/SPS/PPS/SEI 또는 first_mb_in_slice == 0 인 슬라이스에서 시작)
+// 원래 timestamp 는 "<파일>.pts" (mkvmerge timestamp format v2: 줄마다 ms) 가 있으면 그대로 쓰고,
+// 없으면 setFrameRate() 간격. 실시간 모드는 이 간격을 재현한다.
+class FileFrameSource : public PacedFrameSource {
+private:
+    typedef struct {
+        size_t offset;
+        unsigned int size;
+        long long pts_ns;           // 첫 프레임 기준
+    } FileFrame;
+
+    int file_fd;
+    unsigned char *map;
+    size_t map_size;
+    FileFrame *frames;
+    int frame_count;
+    int frame_capacity;
+    long long loop_ns;              // 한 바퀴 길이 (마지막 프레임 간격 포함)
+    long frame_interval_ns;         // .pts 가 없을 때
+    int loop;
+    int has_pts;
+    int frame_width;
+    int frame_height;
+    unsigned int pixfmt;
+
+    int addFrame(size_t offset, size_t size);
+    int indexYUYV();
+    int indexMJPEG();
+    int indexH264();
+    void loadTimestamps(const char *path);
+
+protected:
+    virtual long long frameOffsetNs(unsigned int seq);
+    virtual void fill(int index, unsigned int seq, FrameDesc *desc);
+
+public:
+    explicit FileFrameSource(int buffer_count);
+    virtual ~FileFrameSource();
+
+    // .pts 가 없을 때의 재생 간격 (기본 30 fps). open() 전에 호출
+    void setFrameRate(int fps);
+    // 1 이면 끝에서 처음으로 돌아간다 (timestamp 는 계속 증가)
+    void setLoop(int on) { loop = on; }
+
+    // pixfmt 가 0 이면 내용으로 판별 (FF D8 → MJPEG, start code → H.264, 그 외 YUYV).
+    // YUYV 는 width/height 가 필요하고, MJPEG/H.264 는 첫 프레임 헤더에서 읽는다. 실패 시 -1
+    int open(const char *path, unsigned int pixfmt, int width, int height);
+
+    int frameCount() const { return frame_count; }
+    int hasTimestamps() const { return has_pts; }
+
+    virtual int width() const { return frame_width; }
+    virtual int height() const { return frame_height; }
+    virtual unsigned int pixelFormat() const { return pixfmt; }
+};
+
+#endif // FRAME_SOURCE_H
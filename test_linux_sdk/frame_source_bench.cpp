@@ -0,0 +1,502 @@
+//----------------------------------------------//
+//	프레임 소스 재생 / 합성 벤치마크			//
+//----------------------------------------------//
+// 사용법: ./frame_source_bench [recording [fps]]
+// 카메라 없이 파이프라인을 측정할 수 있도록 FileFrameSource / SyntheticFrameSource 를 검증한다.
+//   1) raw YUYV, MJPEG 연결(APP 세그먼트 안의 FF D9, 바이트 채움, RSTn, 프레임 사이 쓰레기 포함),
+//      Annex-B H.264(3/4 바이트 start code, 다중 슬라이스, SEI/AUD) 파일을 만들어
+//      색인한 프레임 경계와 바이트가 원본과 같은지, 해상도를 헤더에서 읽는지, 끝에서 ENODATA 인지 확인
+//   2) 흔들리는 .pts 를 붙인 MJPEG 을 실시간 모드로 재생해 timestamp 가 원본 간격 그대로이고
+//      각 프레임이 제 마감 시각에 도착하는지 확인 (반복 재생 시 timestamp 연속성 포함)
+//   3) 페이싱 없음 모드의 재생 / 합성 패턴 처리량 (프레임 전체를 한 번 읽는 소비자 기준)
+// 인자로 녹화 파일을 주면 그 파일을 색인하고 페이싱 없이 한 번 재생한 결과만 출력한다.
+// 하나라도 어긋나면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include "frame_source.h"
+
+#define YUYV_WIDTH      640
+#define YUYV_HEIGHT     480
+#define YUYV_FRAMES     60
+#define MJPEG_FRAMES    40
+#define H264_FRAMES     45
+#define H264_GOP        15
+#define SYN_SECONDS     0.5
+
+static int failures = 0;
+static volatile unsigned long long touch_sink;     // 소비자 읽기가 최적화로 사라지지 않게
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        printf("  실패: %s\n", what);
+        failures++;
+    }
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long long tv_ns(const struct timeval *tv)
+{
+    return (long long)tv->tv_sec * 1000000000LL + (long long)tv->tv_usec * 1000LL;
+}
+
+// ===== 테스트 파일 생성 =====
+
+typedef struct {
+    unsigned char *buf;
+    size_t len;
+    size_t cap;
+    size_t offsets[256];    // 기대하는 프레임 시작
+    size_t sizes[256];
+    int count;
+} stream_t;
+
+static void put(stream_t *s, const void *data, size_t n)
+{
+    if (s->len + n > s->cap) {
+        s->cap = (s->len + n) * 2;
+        s->buf = (unsigned char *)realloc(s->buf, s->cap);
+    }
+    memcpy(s->buf + s->len, data, n);
+    s->len += n;
+}
+
+static void put_byte(stream_t *s, unsigned char b)
+{
+    put(s, &b, 1);
+}
+
+static void begin_frame(stream_t *s)
+{
+    s->offsets[s->count] = s->len;
+}
+
+static void end_frame(stream_t *s)
+{
+    s->sizes[s->count] = s->len - s->offsets[s->count];
+    s->count++;
+}
+
+static unsigned int rng_state = 12345;
+
+static unsigned int rng(void)
+{
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+static int write_file(const char *path, const unsigned char *buf, size_t len)
+{
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    size_t n = fwrite(buf, 1, len, fp);
+    fclose(fp);
+    return n == len ? 0 : -1;
+}
+
+static void build_yuyv(stream_t *s)
+{
+    size_t size = (size_t)YUYV_WIDTH * YUYV_HEIGHT * 2;
+    unsigned char *frame = (unsigned char *)malloc(size);
+    for (int f = 0; f < YUYV_FRAMES; f++) {
+        for (size_t i = 0; i < size; i++) frame[i] = (unsigned char)(rng() ^ f);
+        begin_frame(s);
+        put(s, frame, size);
+        end_frame(s);
+    }
+    free(frame);
+}
+
+static void put_segment(stream_t *s, unsigned char marker, const unsigned char *payload, unsigned int n)
+{
+    put_byte(s, 0xFF);
+    put_byte(s, marker);
+    put_byte(s, (unsigned char)((n + 2) >> 8));
+    put_byte(s, (unsigned char)(n + 2));
+    put(s, payload, n);
+}
+
+// DHT 없는 UVC 스타일 baseline 프레임 (디코드는 하지 않으므로 엔트로피 데이터는 임의 바이트)
+static void build_mjpeg(stream_t *s, int width, int height)
+{
+    static const unsigned char app0[] = { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 };
+    // 썸네일처럼 세그먼트 안에 들어 있는 FF D8 / FF D9 (마커가 아님)
+    static const unsigned char app1[] = { 'E', 'x', 'i', 'f', 0, 0, 0xFF, 0xD8, 0xFF, 0xD9, 0x12, 0x34 };
+    unsigned char dqt[65];
+    unsigned char sof[] = { 8, (unsigned char)(height >> 8), (unsigned char)height,
+                            (unsigned char)(width >> 8), (unsigned char)width, 3,
+                            1, 0x21, 0, 2, 0x11, 1, 3, 0x11, 1 };
+    static const unsigned char dri[] = { 0, 8 };
+    static const unsigned char sos[] = { 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 };
+
+    dqt[0] = 0;
+    for (int i = 1; i < 65; i++) dqt[i] = (unsigned char)(1 + i % 7);
+
+    for (int f = 0; f < MJPEG_FRAMES; f++) {
+        // 가끔 프레임 사이에 0 채움 (UVC 페이로드 끝 여분 등)
+        if (f % 7 == 3) {
+            for (int i = 0; i < 5; i++) put_byte(s, 0);
+        }
+        begin_frame(s);
+        put_byte(s, 0xFF);
+        put_byte(s, 0xD8);
+        put_segment(s, 0xE0, app0, sizeof(app0));
+        if (f % 5 == 0) put_segment(s, 0xE1, app1, sizeof(app1));
+        put_segment(s, 0xDB, dqt, sizeof(dqt));
+        put_segment(s, 0xC0, sof, sizeof(sof));
+        put_segment(s, 0xDD, dri, sizeof(dri));
+        put_segment(s, 0xDA, sos, sizeof(sos));
+        int n = 2000 + (int)(rng() % 6000);
+        int rst = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned char b = (unsigned char)rng();
+            if (b == 0xFF) {
+                put_byte(s, 0xFF);
+                put_byte(s, 0x00);      // 바이트 채움
+            } else {
+                put_byte(s, b);
+            }
+            if (i % 700 == 699) {
+                put_byte(s, 0xFF);
+                put_byte(s, (unsigned char)(0xD0 + (rst++ & 7)));
+            }
+        }
+        put_byte(s, 0xFF);
+        put_byte(s, 0xD9);
+        end_frame(s);
+    }
+}
+
+// H.264 비트 쓰기 (SPS 용, emulation prevention 불필요한 짧은 값만)
+typedef struct {
+    unsigned char buf[32];
+    int bits;
+} bits_t;
+
+static void put_bits(bits_t *b, unsigned int v, int n)
+{
+    for (int i = n - 1; i >= 0; i--) {
+        if ((v >> i) & 1) b->buf[b->bits >> 3] |= (unsigned char)(0x80 >> (b->bits & 7));
+        b->bits++;
+    }
+}
+
+static void put_ue(bits_t *b, unsigned int v)
+{
+    int len = 0;
+    while ((v + 1) >> (len + 1)) len++;
+    put_bits(b, 0, len);
+    put_bits(b, v + 1, len + 1);
+}
+
+static void put_nal(stream_t *s, int long_sc, const unsigned char *nal, size_t n)
+{
+    static const unsigned char sc4[] = { 0, 0, 0, 1 };
+    put(s, long_sc ? sc4 : sc4 + 1, long_sc ? 4 : 3);
+    put(s, nal, n);
+}
+
+// 슬라이스: NAL 헤더 + first_mb_in_slice(ue) 로 시작하는 임의 페이로드 (00 00 0x 가 생기지 않게)
+static void put_slice(stream_t *s, int long_sc, int idr, unsigned int first_mb)
+{
+    bits_t b;
+    memset(&b, 0, sizeof(b));
+    put_bits(&b, idr ? 0x65 : 0x41, 8);
+    put_ue(&b, first_mb);
+    put_ue(&b, idr ? 7 : 5);   // slice_type
+    put_bits(&b, 1, 1);
+    unsigned char nal[600];
+    int head = (b.bits + 7) >> 3;
+    memcpy(nal, b.buf, head);
+    int n = head + 100 + (int)(rng() % 400);
+    for (int i = head; i < n; i++) nal[i] = (unsigned char)(1 + rng() % 255);
+    put_nal(s, long_sc, nal, n);
+}
+
+static void build_h264(stream_t *s, int width, int height)
+{
+    bits_t sps;
+    memset(&sps, 0, sizeof(sps));
+    put_bits(&sps, 0x67, 8);
+    put_bits(&sps, 66, 8);              // Baseline
+    put_bits(&sps, 0xC0, 8);
+    put_bits(&sps, 30, 8);
+    put_ue(&sps, 0);                    // seq_parameter_set_id
+    put_ue(&sps, 0);                    // log2_max_frame_num_minus4
+    put_ue(&sps, 2);                    // pic_order_cnt_type
+    put_ue(&sps, 1);                    // max_num_ref_frames
+    put_bits(&sps, 0, 1);
+    put_ue(&sps, width / 16 - 1);
+    put_ue(&sps, height / 16 - 1);
+    put_bits(&sps, 1, 1);               // frame_mbs_only_flag
+    put_bits(&sps, 1, 1);               // direct_8x8_inference_flag
+    put_bits(&sps, 0, 1);               // frame_cropping_flag
+    put_bits(&sps, 0, 1);               // vui_parameters_present_flag
+    put_bits(&sps, 1, 1);               // rbsp_stop_one_bit
+    static const unsigned char pps[] = { 0x68, 0xCE, 0x38, 0x80 };
+    static const unsigned char aud[] = { 0x09, 0xF0 };
+    static const unsigned char sei[] = { 0x06, 0x05, 0x01, 0xAA, 0x80 };
+    unsigned int mbs = (unsigned int)(width / 16) * (height / 16);
+
+    for (int f = 0; f < H264_FRAMES; f++) {
+        int idr = f % H264_GOP == 0;
+        begin_frame(s);
+        if (f % 4 == 1) put_nal(s, 1, aud, sizeof(aud));
+        if (idr) {
+            put_nal(s, 1, sps.buf, (sps.bits + 7) >> 3);
+            put_nal(s, 1, pps, sizeof(pps));
+        }
+        if (f % 6 == 2) put_nal(s, 0, sei, sizeof(sei));
+        put_slice(s, f & 1, idr, 0);
+        // 일부 프레임은 슬라이스 여러 개 (first_mb_in_slice != 0 은 같은 프레임)
+        if (f % 3 == 0) put_slice(s, 0, idr, mbs / 3);
+        if (f % 9 == 0) put_slice(s, 1, idr, mbs * 2 / 3);
+        end_frame(s);
+    }
+}
+
+// ===== 검증 =====
+
+// 페이싱 없이 끝까지 재생하며 경계 / 바이트 비교
+static void verify_replay(const char *name, const char *path, const stream_t *s, unsigned int pixfmt,
+                          int width, int height)
+{
+    FileFrameSource src(4);
+    src.setRealtime(0);
+    int w = pixfmt == V4L2_PIX_FMT_YUYV ? width : 0;
+    int h = pixfmt == V4L2_PIX_FMT_YUYV ? height : 0;
+    char msg[128];
+
+    if (src.open(path, 0, w, h) < 0 || src.start() < 0) {
+        snprintf(msg, sizeof(msg), "%s 열기", name);
+        check(0, msg);
+        return;
+    }
+    check(src.pixelFormat() == pixfmt, "포맷 판별");
+    check(src.width() == width && src.height() == height, "해상도");
+    check(src.frameCount() == s->count, "프레임 수");
+
+    int n = 0, mismatch = 0;
+    FrameDesc d;
+    for (;;) {
+        if (src.dequeue(&d) < 0) {
+            if (errno == EAGAIN) continue;
+            break;
+        }
+        if (n >= s->count || d.sequence != (unsigned int)n || d.bytesused != s->sizes[n] ||
+            memcmp(d.data, s->buf + s->offsets[n], d.bytesused) != 0) {
+            mismatch++;
+        }
+        n++;
+        src.enqueue(d.index);
+    }
+    check(errno == ENODATA, "스트림 끝 ENODATA");
+    check(n == s->count && mismatch == 0, "프레임 경계 / 내용");
+    printf("  %-6s %3d 프레임 %4dx%-4d 불일치 %d\n", name, n, src.width(), src.height(), mismatch);
+}
+
+// 실시간 재생: timestamp 는 .pts 간격 그대로, 도착은 마감 시각 근처
+static void verify_realtime(const char *path, const double *pts_ms, int count)
+{
+    FileFrameSource src(4);
+    src.setLoop(1);
+    if (src.open(path, 0, 0, 0) < 0 || src.start() < 0) {
+        check(0, "실시간 재생 열기");
+        return;
+    }
+    check(src.hasTimestamps(), ".pts 로드");
+
+    int total = count + count / 2;      // 한 바퀴 반 (반복 구간의 timestamp 연속성)
+    double loop_ms = pts_ms[count - 1] - pts_ms[0] + (pts_ms[count - 1] - pts_ms[count - 2]);
+    long long first_ns = 0;
+    double max_err_us = 0, max_late_ms = 0;
+    int got = 0, gaps = 0;
+    double t0 = now_sec();
+
+    while (got < total) {
+        struct pollfd pfd;
+        pfd.fd = src.fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        poll(&pfd, 1, 200);
+
+        FrameDesc d;
+        if (src.dequeue(&d) < 0) {
+            if (errno == EAGAIN) continue;
+            check(0, "실시간 재생 중 오류");
+            return;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long long ts = tv_ns(&d.timestamp);
+        if (got == 0) first_ns = ts;
+        if (d.sequence != (unsigned int)got) gaps++;
+
+        int k = got % count;
+        double expect_ms = (got / count) * loop_ms + pts_ms[k] - pts_ms[0];
+        double err_us = (ts - first_ns) / 1e3 - expect_ms * 1e3;
+        if (err_us < 0) err_us = -err_us;
+        if (err_us > max_err_us) max_err_us = err_us;
+        double late_ms = ((long long)now.tv_sec * 1000000000LL + now.tv_nsec - ts) / 1e6;
+        if (late_ms > max_late_ms) max_late_ms = late_ms;
+        got++;
+        src.enqueue(d.index);
+    }
+    double elapsed = now_sec() - t0;
+    double span = (total / count) * loop_ms + pts_ms[(total - 1) % count] - pts_ms[0];
+
+    printf("  %d 프레임 (반복 포함) %.0f ms 재생 (원본 %.0f ms), timestamp 오차 최대 %.1f us, "
+           "마감 후 도착 최대 %.2f ms, 시퀀스 건너뜀 %d\n",
+           total, elapsed * 1e3, span, max_err_us, max_late_ms, gaps);
+    check(max_err_us <= 2.0, "timestamp 가 원본 간격과 일치");
+    check(gaps == 0, "소비자가 빠르면 드롭 없음");
+    check(elapsed * 1e3 >= span - 1.0 && elapsed * 1e3 <= span + 50.0, "재생 시간이 원본과 같음");
+}
+
+// 프레임 전체를 읽는 소비자 (8 바이트 XOR)
+static unsigned long long touch(const unsigned char *p, unsigned int n)
+{
+    unsigned long long x = 0, v;
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        memcpy(&v, p + i, 8);
+        x ^= v;
+    }
+    for (; i < n; i++) x ^= p[i];
+    return x;
+}
+
+static void run_fast(FrameSource *src, const char *name, double seconds, int max_frames)
+{
+    unsigned long long sink = 0, bytes = 0;
+    int frames = 0;
+    double t0 = now_sec(), t = t0;
+
+    while ((max_frames == 0 || frames < max_frames) && (seconds == 0 || t - t0 < seconds)) {
+        FrameDesc d;
+        if (src->dequeue(&d) < 0) {
+            if (errno == EAGAIN) continue;
+            break;
+        }
+        sink ^= touch(d.data, d.bytesused);
+        bytes += d.bytesused;
+        frames++;
+        src->enqueue(d.index);
+        if ((frames & 7) == 0) t = now_sec();
+    }
+    t = now_sec() - t0;
+    touch_sink = sink;
+    printf("  %-12s %6d 프레임 %8.0f fps %8.1f MB/s\n", name, frames, frames / t, bytes / t / 1e6);
+}
+
+static int replay_file(const char *path, int fps)
+{
+    FileFrameSource src(4);
+    src.setFrameRate(fps);
+    src.setRealtime(0);
+    if (src.open(path, 0, 0, 0) < 0 || src.start() < 0) return 1;
+    printf("%s: 포맷 0x%08X %dx%d, %d 프레임, timestamp %s\n", path, src.pixelFormat(), src.width(),
+           src.height(), src.frameCount(), src.hasTimestamps() ? ".pts" : "없음 (fps 간격)");
+    run_fast(&src, "재생", 0, 0);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2) return replay_file(argv[1], argc >= 3 ? atoi(argv[2]) : 30);
+
+    char dir[] = "/tmp/frame_source_bench.XXXXXX";
+    if (!mkdtemp(dir)) {
+        printf("임시 디렉터리 생성 실패\n");
+        return 1;
+    }
+    char yuyv_path[64], mjpeg_path[64], h264_path[64], pts_path[80];
+    snprintf(yuyv_path, sizeof(yuyv_path), "%s/clip.yuyv", dir);
+    snprintf(mjpeg_path, sizeof(mjpeg_path), "%s/clip.mjpg", dir);
+    snprintf(h264_path, sizeof(h264_path), "%s/clip.h264", dir);
+    snprintf(pts_path, sizeof(pts_path), "%s.pts", mjpeg_path);
+
+    stream_t yuyv, mjpeg, h264;
+    memset(&yuyv, 0, sizeof(yuyv));
+    memset(&mjpeg, 0, sizeof(mjpeg));
+    memset(&h264, 0, sizeof(h264));
+    build_yuyv(&yuyv);
+    build_mjpeg(&mjpeg, 1280, 720);
+    build_h264(&h264, 320, 240);
+
+    // 카메라처럼 흔들리는 20 ms 간격 + 중간에 100 ms 끊김
+    double pts_ms[MJPEG_FRAMES];
+    FILE *fp = fopen(pts_path, "w");
+    int ok = fp && write_file(yuyv_path, yuyv.buf, yuyv.len) == 0 &&
+             write_file(mjpeg_path, mjpeg.buf, mjpeg.len) == 0 &&
+             write_file(h264_path, h264.buf, h264.len) == 0;
+    if (fp) {
+        fprintf(fp, "# timestamp format v2\n");
+        double t = 1234.5;
+        for (int i = 0; i < MJPEG_FRAMES; i++) {
+            pts_ms[i] = t;
+            fprintf(fp, "%.3f\n", t);
+            t += (i == 20) ? 100.0 : 20.0 + (int)(rng() % 5000) / 1000.0 - 2.5;
+        }
+        fclose(fp);
+    }
+    if (!ok) {
+        printf("테스트 파일 쓰기 실패 (%s)\n", dir);
+        return 1;
+    }
+
+    printf("=== 프레임 소스 벤치마크 ===\n");
+    printf("색인 / 내용:\n");
+    verify_replay("YUYV", yuyv_path, &yuyv, V4L2_PIX_FMT_YUYV, YUYV_WIDTH, YUYV_HEIGHT);
+    verify_replay("MJPEG", mjpeg_path, &mjpeg, V4L2_PIX_FMT_MJPEG, 1280, 720);
+    verify_replay("H.264", h264_path, &h264, V4L2_PIX_FMT_H264, 320, 240);
+
+    printf("실시간 재생 (.pts):\n");
+    verify_realtime(mjpeg_path, pts_ms, MJPEG_FRAMES);
+
+    printf("페이싱 없음 처리량 (%.1f 초):\n", SYN_SECONDS);
+    {
+        FileFrameSource src(4);
+        src.setRealtime(0);
+        src.setLoop(1);
+        if (src.open(yuyv_path, V4L2_PIX_FMT_YUYV, YUYV_WIDTH, YUYV_HEIGHT) == 0 && src.start() == 0) {
+            run_fast(&src, "재생 YUYV", SYN_SECONDS, 0);
+        } else {
+            check(0, "YUYV 반복 재생 열기");
+        }
+    }
+    static const char *patterns[] = { "합성 bars", "합성 box", "합성 noise" };
+    for (int p = 0; p < 3; p++) {
+        SyntheticFrameSource syn(YUYV_WIDTH, YUYV_HEIGHT, 4);
+        syn.setPattern(p);
+        if (syn.start() < 0) {
+            check(0, "합성 소스 시작");
+            continue;
+        }
+        run_fast(&syn, patterns[p], SYN_SECONDS, 0);
+    }
+
+    unlink(pts_path);
+    unlink(yuyv_path);
+    unlink(mjpeg_path);
+    unlink(h264_path);
+    rmdir(dir);
+    free(yuyv.buf);
+    free(mjpeg.buf);
+    free(h264.buf);
+
+    printf("검증: %s\n", failures ? "실패" : "모든 재생 경계 / timestamp 일치");
+    return failures ? 1 : 0;
+}
@@ -3,9 +3,16 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 // 전역 변수 (extern으로 선언만)
 
+// 1-6 키 해상도 (장치 포맷 표의 가장 가까운 크기로 맞춘다)
+static const int kResolutionKeys[6][2] = {
+    {320, 240}, {640, 480}, {800, 600}, {1024, 768}, {1280, 720}, {1920, 1080}
+};
+
 // 유틸리티 함수
 int xioctl(int fd, int request, void *arg) {
     int r;
@@ -26,14 +33,32 @@ RaspberryPiViewer::RaspberryPiViewer() {
     display = NULL;
     window = 0;
     gc = 0;
-    ximage = NULL;
-    frame_buffer = NULL;
-    frame_buffer_size = 0;
+    memset(&xdisp, 0, sizeof(xdisp));
+    win_width = 0;
+    win_height = 0;
+    source = NULL;
+    ring = NULL;
+    memset(&current_frame, 0, sizeof(current_frame));
+    current_frame.index = -1;
     frame_width = 0;
     frame_height = 0;
     h264_fmt = NULL;
     h264_decoder_initialized = 0;
+    memset(&h264_parser, 0, sizeof(h264_parser));
+    mjpeg_pool = NULL;
+    mjpeg_errors = 0;
+    motion = NULL;
+    memset(motion_result, 0, sizeof(motion_result));
     running = 0;
+    pipeline_running.store(0);
+    threads_started = 0;
+    wake_fd = -1;
+    stop_fd = -1;
+    memset(&formats, 0, sizeof(formats));
+    pending_format.store(0);
+    switch_start_ns.store(0);
+    overlay = NULL;
+    overlay_composited = false;
     
     // FPS 컨트롤러 초기화
     memset(&fps_ctrl, 0, sizeof(FPSController));
@@ -42,15 +67,18 @@ RaspberryPiViewer::RaspberryPiViewer() {
     // 통계 초기화
     memset(&stats, 0, sizeof(stats));
     clock_gettime(CLOCK_MONOTONIC, &stats.session_start);
+    pm_init(&metrics);
     
     // 뮤텍스 초기화
     pthread_mutex_init(&frame_mutex, NULL);
+    pthread_mutex_init(&motion_mutex, NULL);
 }
 
 // RaspberryPiViewer 소멸자
 RaspberryPiViewer::~RaspberryPiViewer() {
     cleanup();
     pthread_mutex_destroy(&frame_mutex);
+    pthread_mutex_destroy(&motion_mutex);
 }
 
 // 초기화
@@ -66,26 +94,83 @@ int RaspberryPiViewer::initialize(const CameraConfig *cfg) {
     printf("포맷: 0x%08X\n", config.format);
     printf("=====================================\n");
     
-    // 카메라 열기
-    if (openCamera(config.device_name) < 0) {
-        printf("카메라 열기 실패\n");
-        return -1;
-    }
-    
-    // 포맷 설정
-    if (setFormat(config.width, config.height, config.fps) < 0) {
-        printf("포맷 설정 실패\n");
-        return -1;
+    if (config.replay_file[0]) {
+        // 포맷/해상도는 파일 헤더에서 (raw YUYV 는 -F 0x56595559 와 -w/-h)
+        FileFrameSource probe(MAX_BUFFERS);
+        unsigned int fmt = config.format == V4L2_PIX_FMT_YUYV ? V4L2_PIX_FMT_YUYV : 0;
+        if (probe.open(config.replay_file, fmt, config.width, config.height) < 0) {
+            printf("재생 파일 열기 실패\n");
+            return -1;
+        }
+        printf("녹화 파일 재생: %s (%d 프레임, %s)\n", config.replay_file, probe.frameCount(),
+               probe.hasTimestamps() ? "원본 timestamp" : "FPS 간격");
+        config.format = probe.pixelFormat();
+        frame_width = probe.width();
+        frame_height = probe.height();
+        if (frame_width <= 0 || frame_height <= 0) {
+            frame_width = config.width & ~1;
+            frame_height = config.height;
+        }
+    } else if (config.synthetic) {
+        // 합성 소스는 YUYV 만 생성
+        printf("합성 프레임 소스 사용 (카메라 없음)\n");
+        config.format = V4L2_PIX_FMT_YUYV;
+        frame_width = config.width & ~1;
+        frame_height = config.height;
+    } else {
+        // 카메라 열기
+        if (openCamera(config.device_name) < 0) {
+            printf("카메라 열기 실패\n");
+            return -1;
+        }
+        
+        // 포맷 설정
+        if (setFormat(config.width, config.height, config.fps) < 0) {
+            printf("포맷 설정 실패\n");
+            return -1;
+        }
     }
     
     // H.264 파라미터 설정 (H.264 포맷인 경우)
-    if (config.format == V4L2_PIX_FMT_H264) {
+    if (config.format == V4L2_PIX_FMT_H264 && vd) {
         if (setH264Parameters(config.bitrate, config.quality, 30) < 0) {
             printf("H.264 파라미터 설정 실패\n");
             return -1;
         }
     }
     
+    // MJPEG 디코더 풀: 디스플레이 스레드가 슬라이스 하나를 맡으므로 워커는 코어 수 - 1
+    if (config.format == V4L2_PIX_FMT_MJPEG) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        mjpeg_pool = mjd_pool_create(cores > 1 ? (int)cores - 1 : 0, 1);
+        if (!mjpeg_pool) {
+            printf("MJPEG 디코더 생성 실패\n");
+            return -1;
+        }
+        printf("MJPEG 디코더 워커: %d\n", mjd_pool_workers(mjpeg_pool));
+    }
+    
+    // 소프트웨어 모션 감지: YUYV 의 Y 를 변환 없이 바로 사용
+    if (config.motion_threshold > 0) {
+        if (config.format != V4L2_PIX_FMT_YUYV) {
+            printf("소프트웨어 모션 감지는 YUYV 포맷에서만 지원 (무시)\n");
+        } else {
+            md_config_t mcfg;
+            md_default_config(&mcfg);
+            mcfg.threshold = (uint16_t)config.motion_threshold;
+            motion = md_create(frame_width, frame_height, &mcfg);
+            if (!motion) {
+                printf("모션 감지 엔진 생성 실패\n");
+                return -1;
+            }
+            if (config.motion_mask_set) {
+                md_set_mask(motion, config.motion_mask);
+            }
+            md_set_callback(motion, motionEvent, this);
+            printf("소프트웨어 모션 감지: 임계값 0x%04X\n", config.motion_threshold);
+        }
+    }
+    
     // X11 디스플레이 초기화
     if (initializeX11Display() < 0) {
         printf("X11 디스플레이 초기화 실패\n");
@@ -125,13 +210,21 @@ int RaspberryPiViewer::openCamera(const char *device) {
         return -1;
     }
     
-    vd->fd = open(device, O_RDWR);
+    // 논블로킹: 이벤트 루프가 준비된 프레임을 EAGAIN 까지 연속으로 디큐한다
+    vd->fd = open(device, O_RDWR | O_NONBLOCK);
     if (-1 == vd->fd) {
         printf("Cannot open '%s': %d, %s\n", device, errno, strerror(errno));
         return -1;
     }
     
     printf("카메라 %s 열기 성공\n", device);
+    
+    // 지원 포맷 표 (전환 요청을 여기에 맞춘다)
+    if (ft_probe(vd->fd, &formats) > 0) {
+        printf("지원 포맷 표: %d 개 항목\n", formats.count);
+    } else {
+        printf("ENUM_FRAMESIZES 미지원: 요청한 포맷을 그대로 사용\n");
+    }
     return 0;
 }
 
@@ -139,6 +232,13 @@ int RaspberryPiViewer::openCamera(const char *device) {
 int RaspberryPiViewer::setFormat(int width, int height, int fps) {
     if (!vd) return -1;
     
+    // 표가 있으면 지원하는 가장 가까운 크기 / 간격으로 맞춘다
+    int req_w = width, req_h = height, req_fps = fps;
+    if (ft_snap(&formats, config.format, &width, &height, &fps) &&
+        (width != req_w || height != req_h || fps != req_fps)) {
+        printf("지원 포맷으로 조정: %dx%d @ %d → %dx%d @ %d\n", req_w, req_h, req_fps, width, height, fps);
+    }
+    
     printf("포맷 설정: %dx%d @ %dfps\n", width, height, fps);
     
     // V4L2 포맷 설정
@@ -175,10 +275,115 @@ int RaspberryPiViewer::setFormat(int width, int height, int fps) {
     
     frame_width = fmt.fmt.pix.width;
     frame_height = fmt.fmt.pix.height;
+    config.width = frame_width;
+    config.height = frame_height;
+    config.fps = fps;
     
     return 0;
 }
 
+// 스트리밍 중 해상도 / FPS 전환 (메인 스레드에서 호출)
+// 스레드 정지 → STREAMOFF / 버퍼 해제 (REQBUFS 0) → S_FMT / S_PARM → REQBUFS / mmap / STREAMON → 스레드 재시작
+// 장치 fd, X11 창, 디코더 풀, 포맷 표는 그대로 둔다. 단계별 시간을 출력하고 첫 프레임에서 전체 지연을 출력한다
+int RaspberryPiViewer::switchFormat(int width, int height, int fps) {
+    if (config.replay_file[0]) {
+        printf("재생 파일은 포맷을 바꿀 수 없음\n");
+        return -1;
+    }
+    if (fps < MIN_FPS || fps > MAX_FPS || width <= 0 || height <= 0) return -1;
+    
+    if (!running) {
+        if (vd && setFormat(width, height, fps) < 0) return -1;
+        if (!vd) {
+            frame_width = config.width = width & ~1;
+            frame_height = config.height = height;
+            config.fps = fps;
+        }
+        return setTargetFPS(config.fps);
+    }
+    
+    ft_snap(&formats, config.format, &width, &height, &fps);
+    width &= ~1;
+    if (width == frame_width && height == frame_height && fps == config.fps) return 0;
+    
+    int old_w = frame_width, old_h = frame_height, old_fps = config.fps;
+    int had_threads = threads_started;
+    
+    uint64_t t0 = pm_now_ns();
+    stopThreads();
+    uint64_t t1 = pm_now_ns();
+    stopStreaming();
+    uint64_t t2 = pm_now_ns();
+    
+    int rc = 0;
+    if (config.synthetic) {
+        frame_width = config.width = width & ~1;
+        frame_height = config.height = height;
+        config.fps = fps;
+    } else {
+        rc = setFormat(width, height, fps);
+        if (rc < 0) {
+            printf("포맷 전환 실패, 이전 포맷으로 복구\n");
+            if (setFormat(old_w, old_h, old_fps) < 0) {
+                printf("이전 포맷 %dx%d@%d 복구 실패\n", old_w, old_h, old_fps);
+            }
+        }
+    }
+    uint64_t t3 = pm_now_ns();
+    
+    // 모션 엔진 격자는 해상도에 묶여 있다
+    if (motion && (frame_width != old_w || frame_height != old_h)) {
+        uint8_t mask[MD_MASK_BYTES];
+        md_config_t mcfg;
+        md_get_mask(motion, mask);
+        md_destroy(motion);
+        md_default_config(&mcfg);
+        mcfg.threshold = (uint16_t)config.motion_threshold;
+        motion = md_create(frame_width, frame_height, &mcfg);
+        if (motion) {
+            md_set_mask(motion, mask);
+            md_set_callback(motion, motionEvent, this);
+        }
+        pthread_mutex_lock(&motion_mutex);
+        memset(motion_result, 0, sizeof(motion_result));
+        pthread_mutex_unlock(&motion_mutex);
+    }
+    
+    setTargetFPS(config.fps);
+    if (startStreaming() < 0) {
+        printf("포맷 전환 후 스트리밍 재시작 실패\n");
+        g_running = 0;
+        return -1;
+    }
+    uint64_t t4 = pm_now_ns();
+    switch_start_ns.store(t0);
+    if (had_threads && startThreads() < 0) {
+        g_running = 0;
+        return -1;
+    }
+    uint64_t t5 = pm_now_ns();
+    
+    printf("포맷 전환 %dx%d@%d → %dx%d@%d: 스레드 정지 %.1f ms, STREAMOFF/해제 %.1f ms, "
+           "S_FMT/S_PARM %.1f ms, REQBUFS/mmap/STREAMON %.1f ms, 스레드 시작 %.1f ms (합계 %.1f ms)\n",
+           old_w, old_h, old_fps, frame_width, frame_height, config.fps,
+           (t1 - t0) / 1e6, (t2 - t1) / 1e6, (t3 - t2) / 1e6, (t4 - t3) / 1e6, (t5 - t4) / 1e6,
+           (t5 - t0) / 1e6);
+    return rc;
+}
+
+void RaspberryPiViewer::requestFormat(int width, int height, int fps) {
+    if (width <= 0 || height <= 0 || fps <= 0) return;
+    pending_format.store(((uint64_t)(width & 0xffff) << 32) | ((uint64_t)(height & 0xffff) << 16) |
+                         (uint64_t)(fps & 0xffff));
+}
+
+// 키 입력 등으로 요청된 전환을 적용 (없으면 0)
+int RaspberryPiViewer::applyPendingFormat() {
+    uint64_t req = pending_format.exchange(0);
+    if (!req) return 0;
+    return switchFormat((int)((req >> 32) & 0xffff), (int)((req >> 16) & 0xffff), (int)(req & 0xffff));
+}
+
 // H.264 파라미터 설정
 int RaspberryPiViewer::setH264Parameters(int bitrate, int quality, int keyframe_interval) {
     if (!vd) return -1;
@@ -186,8 +391,29 @@ int RaspberryPiViewer::setH264Parameters(int bitrate, int quality, int keyframe_
     printf("H.264 파라미터 설정: bitrate=%d, quality=%d, keyframe=%d\n", 
            bitrate, quality, keyframe_interval);
     
-    // Linux SDK의 H.264 XU 컨트롤 사용
-    // 실제 구현에서는 h264_xu_ctrls.c의 함수들을 사용
+    // XU 컨트롤은 RERVISION 칩에서만 동작한다 (그 외 카메라는 기본값으로 진행)
+    if (chip_id == (unsigned int)CHIP_NONE && XU_Init_Ctrl(vd->fd) < 0) {
+        printf("XU 컨트롤 초기화 실패, H.264 파라미터는 카메라 기본값 사용\n");
+        return 0;
+    }
+    
+    // 한 트랜잭션으로 묶어 같은 선택자 전환과 중복 쓰기를 줄인다
+    XU_Txn_Begin(vd->fd);
+    if (bitrate > 0)
+        XU_H264_Set_BitRate(vd->fd, (double)bitrate);
+    if (quality > 0 && quality <= 100)
+        XU_H264_Set_QP(vd->fd, (100 - quality) * 51 / 100);  // 품질 1..100 → QP 50..0
+    if (keyframe_interval > 0)
+        XU_H264_Set_GOP(vd->fd, keyframe_interval);
+    if (XU_Txn_Commit(vd->fd) < 0) {
+        printf("H.264 XU 파라미터 적용 실패\n");
+        return -1;
+    }
+    
+    struct XU_Cache_Stats xu_stats;
+    if (XU_Cache_Get_Stats(vd->fd, &xu_stats) == 0)
+        printf("XU 전송: %u회 (스위치 생략 %u, 중복 쓰기 생략 %u)\n",
+               xu_stats.bus_transfers, xu_stats.switch_skipped, xu_stats.write_skipped);
     
     return 0;
 }
@@ -218,55 +444,16 @@ void RaspberryPiViewer::updateFPSControl() {
     fps_ctrl.frame_count++;
     stats.total_frames++;
     
-    // FPS 계산
-    struct timespec elapsed;
-    elapsed.tv_sec = now.tv_sec - fps_ctrl.start_time.tv_sec;
-    elapsed.tv_nsec = now.tv_sec - fps_ctrl.start_time.tv_nsec;
-    
-    if (elapsed.tv_nsec < 0) {
-        elapsed.tv_sec--;
-        elapsed.tv_nsec += 1000000000;
+    // 평균 FPS: 세션 시작 이후
+    double session_seconds = (now.tv_sec - stats.session_start.tv_sec) +
+                             (now.tv_nsec - stats.session_start.tv_nsec) / 1000000000.0;
+    if (session_seconds > 0) {
+        stats.avg_fps = stats.total_frames / session_seconds;
     }
     
-    double elapsed_seconds = elapsed.tv_sec + elapsed.tv_nsec / 1000000000.0;
-    if (elapsed_seconds > 0) {
-        stats.current_fps = fps_ctrl.frame_count / elapsed_seconds;
-        stats.avg_fps = stats.total_frames / 
-                       ((now.tv_sec - stats.session_start.tv_sec) + 
-                        (now.tv_sec - stats.session_start.tv_sec) / 1000000000.0);
-    }
-}
-
-// 다음 프레임까지 대기
-void RaspberryPiViewer::waitForNextFrame() {
-    struct timespec now, target;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    
-    // 목표 시간 계산
-    target.tv_sec = fps_ctrl.last_frame_time.tv_sec + fps_ctrl.frame_interval.tv_sec;
-    target.tv_nsec = fps_ctrl.last_frame_time.tv_nsec + fps_ctrl.frame_interval.tv_nsec;
-    
-    if (target.tv_nsec >= 1000000000) {
-        target.tv_sec++;
-        target.tv_nsec -= 1000000000;
-    }
-    
-    // 대기 시간 계산
-    struct timespec sleep_time;
-    sleep_time.tv_sec = target.tv_sec - now.tv_sec;
-    sleep_time.tv_nsec = target.tv_nsec - now.tv_nsec;
-    
-    if (sleep_time.tv_nsec < 0) {
-        sleep_time.tv_sec--;
-        sleep_time.tv_nsec += 1000000000;
-    }
-    
-    // 대기
-    if (sleep_time.tv_sec > 0 || sleep_time.tv_nsec > 0) {
-        nanosleep(&sleep_time, NULL);
-    }
-    
-    clock_gettime(CLOCK_MONOTONIC, &fps_ctrl.last_frame_time);
+    // 현재 FPS: 최근 2초 슬라이딩 윈도우
+    stats.current_fps = pm_fps_window(&metrics);
+    fps_ctrl.actual_fps = (int)(stats.current_fps + 0.5);
 }
 
 // 스트리밍 시작
@@ -275,50 +462,43 @@ int RaspberryPiViewer::startStreaming() {
     
     printf("스트리밍 시작...\n");
     
-    // 버퍼 요청
-    struct v4l2_requestbuffers req;
-    CLEAR(req);
-    req.count = MAX_BUFFERS;
-    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    req.memory = V4L2_MEMORY_MMAP;
-    
-    if (-1 == xioctl(vd->fd, VIDIOC_REQBUFS, &req)) {
-        printf("VIDIOC_REQBUFS 실패\n");
-        return -1;
-    }
-    
-    // 버퍼 매핑
-    for (int i = 0; i < req.count; i++) {
-        struct v4l2_buffer buf;
-        CLEAR(buf);
-        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf.memory = V4L2_MEMORY_MMAP;
-        buf.index = i;
-        
-        if (-1 == xioctl(vd->fd, VIDIOC_QUERYBUF, &buf)) {
-            printf("VIDIOC_QUERYBUF 실패\n");
-            return -1;
-        }
-        
-        vd->mem[i] = mmap(NULL, buf.length, PROT_READ | PROT_WRITE, 
-                          MAP_SHARED, vd->fd, buf.m.offset);
-        
-        if (MAP_FAILED == vd->mem[i]) {
-            printf("mmap 실패\n");
+    // 프레임 소스 생성
+    if (config.replay_file[0]) {
+        FileFrameSource *file = new FileFrameSource(MAX_BUFFERS);
+        file->setFrameRate(config.fps);
+        file->setLoop(1);
+        file->setRealtime(!config.fast_source);
+        if (file->open(config.replay_file, config.format, frame_width, frame_height) < 0) {
+            delete file;
             return -1;
         }
+        source = file;
+    } else if (config.synthetic) {
+        SyntheticFrameSource *synth = new SyntheticFrameSource(frame_width, frame_height, MAX_BUFFERS);
+        synth->setPattern(config.synthetic_pattern);
+        synth->setFrameRate(config.fast_source ? 0 : config.fps);
+        source = synth;
+    } else {
+        if (!vd) return -1;
+        source = new V4L2FrameSource(vd, frame_width, frame_height, config.format, MAX_BUFFERS);
     }
     
-    // 스트리밍 시작
-    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (-1 == xioctl(vd->fd, VIDIOC_STREAMON, &type)) {
-        printf("VIDIOC_STREAMON 실패\n");
+    // 버퍼 요청, 매핑, 큐잉 및 스트리밍 시작
+    if (source->start() < 0) {
+        printf("프레임 소스 시작 실패\n");
+        delete source;
+        source = NULL;
         return -1;
     }
     
+    ring = new CaptureRing(source);
+    latest.attach(ring);
+    pm_init(&metrics);
+    ring->setMetrics(&metrics);
+    printf("캡처 링: %d 개 버퍼\n", source->bufferCount());
+    
     running = 1;
     clock_gettime(CLOCK_MONOTONIC, &fps_ctrl.start_time);
-    clock_gettime(CLOCK_MONOTONIC, &fps_ctrl.last_frame_time);
     
     printf("스트리밍 시작 완료\n");
     return 0;
@@ -330,73 +510,313 @@ int RaspberryPiViewer::stopStreaming() {
     
     printf("스트리밍 정지...\n");
     
+    // 파이프라인 스레드가 돌고 있으면 먼저 종료
+    stopThreads();
+    
     running = 0;
     
-    // 스트리밍 정지
-    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (-1 == xioctl(vd->fd, VIDIOC_STREAMOFF, &type)) {
-        printf("VIDIOC_STREAMOFF 실패\n");
-    }
+    // 슬롯과 디스플레이가 잡고 있던 버퍼 반환
+    latest.clear();
+    pthread_mutex_lock(&frame_mutex);
+    if (ring) ring->release(&current_frame);
+    pthread_mutex_unlock(&frame_mutex);
     
-    // 버퍼 언매핑
-    for (int i = 0; i < MAX_BUFFERS; i++) {
-        if (vd->mem[i]) {
-            munmap(vd->mem[i], 0);  // 길이는 드라이버가 관리
-            vd->mem[i] = NULL;
-        }
+    // 스트리밍 정지, 버퍼 언매핑 및 해제 (REQBUFS 0)
+    if (source) {
+        source->stop();
     }
+    delete ring;
+    ring = NULL;
+    delete source;
+    source = NULL;
     
     printf("스트리밍 정지 완료\n");
     return 0;
 }
 
-// 프레임 캡처
-int RaspberryPiViewer::captureFrame() {
-    if (!running) return -1;
-    
-    struct v4l2_buffer buf;
-    CLEAR(buf);
-    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
+// 파이프라인 스레드 시작
+int RaspberryPiViewer::startThreads() {
+    if (!running || threads_started) return -1;
     
-    // 버퍼 가져오기
-    if (-1 == xioctl(vd->fd, VIDIOC_DQBUF, &buf)) {
-        if (errno == EAGAIN) {
-            // 버퍼가 비어있음
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        return errnoexit("eventfd");
+    }
+    stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    
+    pipeline_running.store(1);
+    
+    if (config.event_loop) {
+        if (pthread_create(&capture_thread, NULL, eventThreadMain, this) != 0) {
+            printf("이벤트 루프 스레드 생성 실패\n");
+            pipeline_running.store(0);
+            close(wake_fd);
+            wake_fd = -1;
+            if (stop_fd >= 0) close(stop_fd);
+            stop_fd = -1;
             return -1;
         }
-        printf("VIDIOC_DQBUF 실패\n");
+        threads_started = 1;
+        printf("이벤트 루프 스레드 시작 (epoll: 캡처 fd + 출력 timerfd%s)\n",
+               display ? " + X11" : "");
+        return 0;
+    }
+    
+    if (pthread_create(&capture_thread, NULL, captureThreadMain, this) != 0) {
+        printf("캡처 스레드 생성 실패\n");
+        pipeline_running.store(0);
+        close(wake_fd);
+        wake_fd = -1;
+        if (stop_fd >= 0) close(stop_fd);
+        stop_fd = -1;
+        return -1;
+    }
+    if (pthread_create(&display_thread, NULL, displayThreadMain, this) != 0) {
+        printf("디스플레이 스레드 생성 실패\n");
+        pipeline_running.store(0);
+        pthread_join(capture_thread, NULL);
+        close(wake_fd);
+        wake_fd = -1;
+        if (stop_fd >= 0) close(stop_fd);
+        stop_fd = -1;
         return -1;
     }
     
-    printf("프레임 캡처: %d bytes, 포맷: 0x%08X\n", buf.bytesused, config.format);
+    threads_started = 1;
+    printf("캡처/디스플레이 스레드 시작\n");
+    return 0;
+}
+
+// 파이프라인 스레드 종료
+void RaspberryPiViewer::stopThreads() {
+    if (!threads_started) return;
     
-    // 프레임 데이터 처리
-    pthread_mutex_lock(&frame_mutex);
+    pipeline_running.store(0);
     
-    if (config.format == V4L2_PIX_FMT_H264) {
-        // H.264 디코딩
-        decodeH264Frame((unsigned char*)vd->mem[buf.index], buf.bytesused);
-    } else {
-        // 직접 복사 (MJPEG, YUV 등)
-        if (frame_buffer_size < buf.bytesused) {
-            frame_buffer = (unsigned char*)realloc(frame_buffer, buf.bytesused);
-            frame_buffer_size = buf.bytesused;
-            printf("프레임 버퍼 크기 조정: %d bytes\n", frame_buffer_size);
+    // 디스플레이 / 캡처 스레드 깨우기
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) {
+        // 이미 카운터가 차 있으면 무시
+    }
+    if (stop_fd >= 0 && write(stop_fd, &one, sizeof(one)) < 0) {
+        // 위와 같음
+    }
+    
+    pthread_join(capture_thread, NULL);
+    if (!config.event_loop) {
+        pthread_join(display_thread, NULL);
+    }
+    
+    close(wake_fd);
+    wake_fd = -1;
+    if (stop_fd >= 0) {
+        close(stop_fd);
+        stop_fd = -1;
+    }
+    threads_started = 0;
+    
+    printf("캡처/디스플레이 스레드 종료 (디스플레이 드롭: %lu)\n", latest.droppedCount());
+}
+
+void *RaspberryPiViewer::captureThreadMain(void *arg) {
+    ((RaspberryPiViewer *)arg)->captureLoop();
+    return NULL;
+}
+
+void *RaspberryPiViewer::displayThreadMain(void *arg) {
+    ((RaspberryPiViewer *)arg)->displayLoop();
+    return NULL;
+}
+
+void *RaspberryPiViewer::eventThreadMain(void *arg) {
+    ((RaspberryPiViewer *)arg)->runEventLoop();
+    return NULL;
+}
+
+// 캡처 스레드: 장치가 프레임을 내줄 때까지 poll()/DQBUF 에서 대기
+void RaspberryPiViewer::captureLoop() {
+    int fd = source->fd();
+    uint64_t wait_start = pm_now_ns();
+    
+    while (pipeline_running.load()) {
+        if (fd >= 0) {
+            struct pollfd pfd[2];
+            pfd[0].fd = fd;
+            pfd[0].events = POLLIN;
+            pfd[0].revents = 0;
+            pfd[1].fd = stop_fd;
+            pfd[1].events = POLLIN;
+            pfd[1].revents = 0;
+            
+            // 종료 플래그를 확인할 수 있도록 타임아웃을 둔다 (stopThreads 는 stop_fd 로 바로 깨운다)
+            int r = poll(pfd, stop_fd >= 0 ? 2 : 1, 100);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                errnoexit("poll");
+                break;
+            }
+            if (r == 0 || !pipeline_running.load()) continue;
+            if (pfd[0].revents & (POLLERR | POLLHUP)) {
+                printf("캡처 장치 오류 (revents=0x%x)\n", pfd[0].revents);
+                break;
+            }
+            if (!(pfd[0].revents & POLLIN)) continue;
+        }
+        
+        FrameRef ref;
+        if (ring->acquire(&ref) < 0) {
+            if (errno == EAGAIN) {
+                // 모든 버퍼가 소비자에게 나가 있음
+                usleep(1000);
+                continue;
+            }
+            printf("VIDIOC_DQBUF 실패\n");
+            break;
+        }
+        
+        pm_record_since(&metrics, PM_STAGE_DQBUF_WAIT, wait_start);
+        updateStatistics(&ref);
+        detectMotion(&ref);
+        
+        if (config.format == V4L2_PIX_FMT_H264) {
+            uint64_t t0 = pm_now_ns();
+            decodeH264Frame((unsigned char*)ref.data, ref.bytesused);
+            pm_record_since(&metrics, PM_STAGE_CONVERT, t0);
+            ring->release(&ref);
+            wait_start = pm_now_ns();
+            continue;
+        }
+        
+        // 디스플레이가 아직 가져가지 않은 프레임은 여기서 드롭된다
+        if (latest.publish(&ref) > 0) {
+            pm_display_drop(&metrics);
+        }
+        
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0) {
+            // 디스플레이가 아직 이전 알림을 읽지 않음
         }
-        memcpy(frame_buffer, vd->mem[buf.index], buf.bytesused);
-        printf("프레임 데이터 복사 완료: %d bytes\n", buf.bytesused);
+        wait_start = pm_now_ns();
     }
     
-    pthread_mutex_unlock(&frame_mutex);
+    // 오류로 빠져나온 경우만 전체 종료 (stopThreads 에 의한 정지는 포맷 전환일 수 있음)
+    if (pipeline_running.load()) g_running = 0;
+}
+
+// 디스플레이 스레드: X11 이벤트와 새 프레임 알림을 함께 대기하고 최신 프레임만 그린다
+void RaspberryPiViewer::displayLoop() {
+    struct pollfd pfds[2];
+    int nfds = 1;
     
-    // 버퍼 반환
-    if (-1 == xioctl(vd->fd, VIDIOC_QBUF, &buf)) {
-        printf("VIDIOC_QBUF 실패\n");
-        return -1;
+    pfds[0].fd = wake_fd;
+    pfds[0].events = POLLIN;
+    if (display) {
+        pfds[1].fd = ConnectionNumber(display);
+        pfds[1].events = POLLIN;
+        nfds = 2;
     }
     
-    return 0;
+    while (pipeline_running.load()) {
+        pfds[0].revents = 0;
+        if (nfds > 1) pfds[1].revents = 0;
+        
+        int r = poll(pfds, nfds, 100);
+        if (r < 0 && errno != EINTR) {
+            errnoexit("poll");
+            break;
+        }
+        
+        if (pfds[0].revents & POLLIN) {
+            uint64_t count;
+            if (read(wake_fd, &count, sizeof(count)) < 0) {
+                // EAGAIN: 다른 경로에서 이미 비워짐
+            }
+        }
+        
+        // 최신 프레임으로 교체 (이전 프레임은 마지막 참조 해제 시 QBUF)
+        FrameRef ref;
+        uint64_t frame_ts = 0;
+        if (latest.take(&ref) == 0) {
+            FrameRef old;
+            frame_ts = frameRefTimestampNs(&ref);
+            pthread_mutex_lock(&frame_mutex);
+            old = current_frame;
+            current_frame = ref;
+            pthread_mutex_unlock(&frame_mutex);
+            ring->release(&old);
+        }
+        
+        updateDisplay();
+        
+        uint64_t now = pm_now_ns();
+        if (frame_ts && now > frame_ts) {
+            pm_record(&metrics, PM_STAGE_E2E, now - frame_ts);
+        }
+    }
+}
+
+// 이벤트 루프 스레드: 캡처 fd, 출력 timerfd, X11 연결을 epoll 하나로 기다린다
+// (프레임은 장치 timestamp 기준으로 페이싱되고, 스레드 간 핸드오프가 없다)
+void RaspberryPiViewer::runEventLoop() {
+    CaptureEventLoop loop(ring, this, &metrics);
+    
+    if (loop.init(fps_ctrl.target_fps) < 0) {
+        printf("이벤트 루프 초기화 실패\n");
+        g_running = 0;
+        return;
+    }
+    if (display && loop.addFd(ConnectionNumber(display)) < 0) {
+        printf("X11 연결을 이벤트 루프에 등록하지 못함\n");
+    }
+    // stopThreads() 가 epoll 대기를 바로 끝내도록 (포맷 전환 지연 단축)
+    if (stop_fd >= 0) {
+        loop.addFd(stop_fd);
+    }
+    
+    if (loop.run(&pipeline_running) < 0) {
+        printf("이벤트 루프 오류로 종료\n");
+    }
+    printf("이벤트 루프 종료 (출력 %lu, 페이싱 드롭 %lu)\n",
+           loop.presentedCount(), loop.pacedDropCount());
+    
+    if (pipeline_running.load()) g_running = 0;
+}
+
+// 디큐된 모든 프레임: 통계, H.264 는 여기서 파싱하고 바로 반환
+int RaspberryPiViewer::onFrame(const FrameRef *ref) {
+    updateStatistics(ref);
+    detectMotion(ref);
+    
+    if (config.format == V4L2_PIX_FMT_H264) {
+        uint64_t t0 = pm_now_ns();
+        decodeH264Frame((unsigned char*)ref->data, ref->bytesused);
+        pm_record_since(&metrics, PM_STAGE_CONVERT, t0);
+        return 0;
+    }
+    return 1;
+}
+
+// 출력 슬롯에 도달한 프레임 (소유권을 넘겨받아 current_frame 으로 교체)
+void RaspberryPiViewer::present(FrameRef *ref) {
+    FrameRef old;
+    pthread_mutex_lock(&frame_mutex);
+    old = current_frame;
+    current_frame = *ref;
+    pthread_mutex_unlock(&frame_mutex);
+    ref->ring = NULL;
+    ref->index = -1;
+    ring->release(&old);
+    
+    renderCurrentFrame();
+}
+
+void RaspberryPiViewer::onFdReady(int fd) {
+    (void)fd;
+    handleX11Events();
+}
+
+void RaspberryPiViewer::onIdle() {
+    handleX11Events();
 }
 
 // H.264 프레임 디코딩
@@ -404,10 +824,22 @@ int RaspberryPiViewer::decodeH264Frame(unsigned char *data, int size) {
     // 실제 구현에서는 FFmpeg 라이브러리나 하드웨어 디코더 사용
     // 여기서는 간단한 예시만 제공
     
-    printf("H.264 프레임 디코딩: %d bytes\n", size);
+    // NAL 유닛 파싱 (Linux SDK의 nalu.c)
+    // 같은 SPS/PPS 는 캐시 비교만 하고, 첫 슬라이스 헤더까지만 읽는다
+    H264_FRAME_INFO info;
+    if (H264ParseFrame(&h264_parser, data, size, &info) < 0) {
+        printf("H.264 프레임: SPS 대기 중 (%d bytes)\n", size);
+        return -1;
+    }
     
-    // NAL 유닛 파싱 (Linux SDK의 nalu.c 사용)
-    // 실제 구현에서는 h264_xu_ctrls.c의 함수들과 연동
+    if (info.has_sps && (info.width != frame_width || info.height != frame_height)) {
+        printf("H.264 SPS 해상도: %dx%d\n", info.width, info.height);
+    }
+    
+    static const char slice_names[] = "PBIsi";
+    printf("H.264 프레임 디코딩: %d bytes, %c 슬라이스, IDR 이후 %u번째 (GOP %u)%s\n",
+           size, info.slice_type >= 0 ? slice_names[info.slice_type] : '-',
+           info.frames_since_idr, info.gop_length, info.keyframe ? " [IDR]" : "");
     
     return 0;
 }
@@ -440,7 +872,7 @@ int RaspberryPiViewer::createWindow(int width, int height) {
     XStoreName(display, window, "Raspberry Pi SDK Viewer");
     
     // 이벤트 마스크 설정
-    XSelectInput(display, window, ExposureMask | KeyPressMask);
+    XSelectInput(display, window, ExposureMask | KeyPressMask | StructureNotifyMask);
     
     // 윈도우 표시
     XMapWindow(display, window);
@@ -448,6 +880,17 @@ int RaspberryPiViewer::createWindow(int width, int height) {
     
     // GC 생성
     gc = XCreateGC(display, window, 0, NULL);
+    win_width = width;
+    win_height = height;
+    
+    // 영구 XImage 백엔드 (이미지는 첫 프레임에서 해상도에 맞춰 할당)
+    if (x11_display_init(&xdisp, display, window, gc, 1) < 0) {
+        printf("디스플레이 백엔드 초기화 실패\n");
+        return -1;
+    }
+    
+    // 실패해도 XDrawString 으로 대신 그린다
+    overlay = ovl_create(3);
     
     printf("윈도우 생성 완료: %dx%d\n", width, height);
     return 0;
@@ -455,28 +898,64 @@ int RaspberryPiViewer::createWindow(int width, int height) {
 
 // 디스플레이 업데이트
 void RaspberryPiViewer::updateDisplay() {
+    handleX11Events();
+    renderCurrentFrame();
+}
+
+// X11 이벤트 처리 (Xlib 내부 큐에 쌓인 이벤트까지 모두 비운다)
+void RaspberryPiViewer::handleX11Events() {
     if (!display || !window) return;
     
-    // X11 이벤트 처리
     XEvent event;
     while (XPending(display)) {
         XNextEvent(display, &event);
+        if (x11_display_handle_event(&xdisp, &event))
+            continue;
         switch (event.type) {
             case Expose:
                 // 윈도우 다시 그리기
                 break;
-            case KeyPress:
+            case ConfigureNotify:
+                // 윈도우 크기 캐시 (프레임마다 XGetWindowAttributes 왕복 방지)
+                win_width = event.xconfigure.width;
+                win_height = event.xconfigure.height;
+                break;
+            case KeyPress: {
                 // 키 입력 처리
                 if (event.xkey.keycode == 9) {  // Escape
                     g_running = 0;
+                    break;
+                }
+                // 1-6: 고정 해상도 (포맷 표의 가장 가까운 크기로 맞춤), F1-F4: 지원 FPS 순서
+                // 메인 스레드가 스트리밍 중 전환
+                KeySym sym = XLookupKeysym(&event.xkey, 0);
+                if (sym >= XK_1 && sym <= XK_6) {
+                    int i = (int)(sym - XK_1);
+                    int w = kResolutionKeys[i][0], h = kResolutionKeys[i][1], f = config.fps;
+                    ft_snap(&formats, config.format, &w, &h, &f);
+                    requestFormat(w, h, f);
+                } else if (sym >= XK_F1 && sym <= XK_F4) {
+                    int rates[FT_MAX_RATES];
+                    int n = getSupportedFPS(rates, FT_MAX_RATES);
+                    int i = (int)(sym - XK_F1);
+                    if (i < n) requestFormat(frame_width, frame_height, rates[i]);
+                } else if (sym == XK_f || sym == XK_F) {
+                    printSupportedFormats();
                 }
                 break;
+            }
         }
     }
+}
+
+// 현재 프레임과 오버레이 그리기
+void RaspberryPiViewer::renderCurrentFrame() {
+    if (!display || !window) return;
     
     // 프레임 데이터가 있으면 화면에 그리기
+    overlay_composited = false;
     pthread_mutex_lock(&frame_mutex);
-    if (frame_buffer && frame_buffer_size > 0) {
+    if (frameRefValid(&current_frame) && current_frame.bytesused > 0) {
         drawFrame();
     }
     pthread_mutex_unlock(&frame_mutex);
@@ -489,16 +968,12 @@ void RaspberryPiViewer::updateDisplay() {
 
 // 프레임 그리기
 void RaspberryPiViewer::drawFrame() {
-    if (!display || !window || !gc || !frame_buffer) return;
-    
-    // 윈도우 크기 가져오기
-    XWindowAttributes attr;
-    XGetWindowAttributes(display, window, &attr);
+    if (!display || !window || !gc || !frameRefValid(&current_frame)) return;
     
     // 이미지 데이터를 X11 이미지로 변환
     if (config.format == V4L2_PIX_FMT_MJPEG) {
-        // MJPEG는 JPEG 디코딩 필요 (간단한 예시)
-        drawRawFrame();
+        // MJPEG를 백 버퍼에 바로 디코딩 (libjpeg-turbo)
+        drawMJPEGFrame();
     } else if (config.format == V4L2_PIX_FMT_YUYV) {
         // YUYV를 RGB로 변환하여 그리기
         drawYUYVFrame();
@@ -510,120 +985,197 @@ void RaspberryPiViewer::drawFrame() {
 
 // 원시 프레임 그리기 (간단한 버전)
 void RaspberryPiViewer::drawRawFrame() {
-    if (!display || !window || !gc || !frame_buffer) return;
-    
-    // 윈도우 크기 가져오기
-    XWindowAttributes attr;
-    XGetWindowAttributes(display, window, &attr);
+    if (!display || !window || !gc || !frameRefValid(&current_frame)) return;
     
     // 간단한 테스트 패턴 그리기 (실제 이미지 대신)
     XSetForeground(display, gc, 0x0000FF);  // 파란색
-    XFillRectangle(display, window, gc, 0, 0, attr.width, attr.height);
+    XFillRectangle(display, window, gc, 0, 0, win_width, win_height);
     
     // 프레임 정보 표시
     char frame_info[128];
-    snprintf(frame_info, sizeof(frame_info), "Frame: %d bytes", frame_buffer_size);
+    snprintf(frame_info, sizeof(frame_info), "Frame: %u bytes", current_frame.bytesused);
     XSetForeground(display, gc, 0xFFFFFF);  // 흰색
     XDrawString(display, window, gc, 10, 50, frame_info, strlen(frame_info));
 }
 
 // YUYV 프레임 그리기
 void RaspberryPiViewer::drawYUYVFrame() {
-    if (!display || !window || !gc || !frame_buffer) return;
+    if (!display || !window || !gc || !frameRefValid(&current_frame)) return;
     
-    // 윈도우 크기 가져오기
-    XWindowAttributes attr;
-    XGetWindowAttributes(display, window, &attr);
+    int width = frame_width;
+    int height = frame_height;
     
-    // YUYV를 RGB로 변환 (간단한 구현)
-    int width = config.width;
-    int height = config.height;
-    
-    // XImage 생성
-    XImage *image = XCreateImage(display, DefaultVisual(display, DefaultScreen(display)),
-                                24, ZPixmap, 0, NULL, width, height, 32, 0);
+    // 해상도가 바뀐 경우에만 이미지 재할당
+    if (x11_display_resize(&xdisp, width, height) < 0) {
+        return;
+    }
     
-    if (!image) {
-        printf("XImage 생성 실패\n");
+    // 서버가 읽고 있지 않은 백 버퍼에 직접 변환
+    int stride = 0;
+    uint8_t *dst = x11_display_back_buffer(&xdisp, &stride);
+    if (!dst) {
         return;
     }
     
-    // 메모리 할당
-    image->data = (char*)malloc(width * height * 4);
-    if (!image->data) {
-        XDestroyImage(image);
-        printf("이미지 메모리 할당 실패\n");
+    // YUYV를 화면 포맷으로 변환 (SIMD 경로 자동 선택)
+    uint64_t t0 = pm_now_ns();
+    yuyv_convert(current_frame.data, width * 2, dst, stride,
+                 width, height, xdisp.format, CC_MATRIX_BT601, CC_RANGE_FULL);
+    uint64_t t1 = pm_now_ns();
+    pm_record(&metrics, PM_STAGE_CONVERT, t1 - t0);
+    
+    compositeOverlay(dst, stride, width, height);
+    
+    // 이미지를 윈도우에 그리기 (MIT-SHM 사용 시 XShmPutImage)
+    x11_display_present(&xdisp, 0, 0);
+    pm_record_since(&metrics, PM_STAGE_DRAW, t1);
+}
+
+// MJPEG 프레임 그리기
+void RaspberryPiViewer::drawMJPEGFrame() {
+    if (!display || !window || !gc || !frameRefValid(&current_frame) || !mjpeg_pool) return;
+    
+    // 해상도는 V4L2 포맷이 아니라 JPEG 헤더 기준
+    mjd_info_t info;
+    if (mjd_probe(current_frame.data, current_frame.bytesused, &info) < 0) {
+        mjpeg_errors++;
+        return;
+    }
+    if (x11_display_resize(&xdisp, info.width, info.height) < 0) {
         return;
     }
     
-    // YUYV를 RGB로 변환
-    unsigned char *yuyv = frame_buffer;
-    unsigned char *rgb = (unsigned char*)image->data;
+    int stride = 0;
+    uint8_t *dst = x11_display_back_buffer(&xdisp, &stride);
+    if (!dst) {
+        return;
+    }
     
-    for (int i = 0; i < width * height / 2; i++) {
-        int y0 = yuyv[i*4 + 0];
-        int u  = yuyv[i*4 + 1];
-        int y1 = yuyv[i*4 + 2];
-        int v  = yuyv[i*4 + 3];
-        
-        // YUV to RGB 변환 (간단한 버전)
-        int r0 = y0 + 1.402 * (v - 128);
-        int g0 = y0 - 0.344 * (u - 128) - 0.714 * (v - 128);
-        int b0 = y0 + 1.772 * (u - 128);
-        
-        int r1 = y1 + 1.402 * (v - 128);
-        int g1 = y1 - 0.344 * (u - 128) - 0.714 * (v - 128);
-        int b1 = y1 + 1.772 * (u - 128);
-        
-        // 클램핑
-        r0 = (r0 < 0) ? 0 : (r0 > 255) ? 255 : r0;
-        g0 = (g0 < 0) ? 0 : (g0 > 255) ? 255 : g0;
-        b0 = (b0 < 0) ? 0 : (b0 > 255) ? 255 : b0;
-        
-        r1 = (r1 < 0) ? 0 : (r1 > 255) ? 255 : r1;
-        g1 = (g1 < 0) ? 0 : (g1 > 255) ? 255 : g1;
-        b1 = (b1 < 0) ? 0 : (b1 > 255) ? 255 : b1;
-        
-        // RGB 저장
-        rgb[i*8 + 0] = r0;  // B
-        rgb[i*8 + 1] = g0;  // G
-        rgb[i*8 + 2] = b0;  // R
-        rgb[i*8 + 3] = 0;   // A
-        
-        rgb[i*8 + 4] = r1;  // B
-        rgb[i*8 + 5] = g1;  // G
-        rgb[i*8 + 6] = b1;  // R
-        rgb[i*8 + 7] = 0;   // A
+    mjd_image_t img;
+    memset(&img, 0, sizeof(img));
+    img.plane[0] = dst;
+    img.stride[0] = stride;
+    
+    // 서버가 읽지 않는 백 버퍼에 화면 포맷으로 직접 디코딩 (색변환 단계 없음)
+    uint64_t t0 = pm_now_ns();
+    int rc = mjd_pool_decode(mjpeg_pool, current_frame.data, current_frame.bytesused,
+                             xdisp.format == CC_FMT_RGB565 ? MJD_OUT_RGB565 : MJD_OUT_BGRX32, &img);
+    uint64_t t1 = pm_now_ns();
+    pm_record(&metrics, PM_STAGE_CONVERT, t1 - t0);
+    if (rc < 0) {
+        mjpeg_errors++;
+        return;
     }
     
-    // 이미지를 윈도우에 그리기
-    XPutImage(display, window, gc, image, 0, 0, 0, 0, width, height);
+    compositeOverlay(dst, stride, info.width, info.height);
     
-    // 정리
-    free(image->data);
-    XDestroyImage(image);
+    x11_display_present(&xdisp, 0, 0);
+    pm_record_since(&metrics, PM_STAGE_DRAW, t1);
+}
+
+// 정보 텍스트를 백 버퍼에 합성 (present 직전, 디스플레이 스레드)
+// 바뀌는 주기가 다른 값끼리 줄을 나눠 두어 프레임 번호 줄만 매 프레임 다시 렌더링된다
+void RaspberryPiViewer::compositeOverlay(uint8_t *dst, int stride, int width, int height) {
+    if (!overlay) return;
+    
+    ovl_format_t fmt;
+    if (xdisp.format == CC_FMT_BGRX32) fmt = OVL_FMT_BGRX32;
+    else if (xdisp.format == CC_FMT_RGB565) fmt = OVL_FMT_RGB565;
+    else if (xdisp.format == CC_FMT_RGB24) fmt = OVL_FMT_RGB24;
+    else return;
+    
+    char text[OVL_MAX_TEXT];
+    snprintf(text, sizeof(text), "FPS: %.1f (Target: %d) | Size: %dx%d | Platform: Raspberry Pi",
+             pm_fps_window(&metrics), fps_ctrl.target_fps, frame_width, frame_height);
+    ovl_set_text(overlay, 0, 10, 6, 1, 0xFFFFFF, text);
+    snprintf(text, sizeof(text), "Frames: %llu | Drops: %llu",
+             (unsigned long long)pm_frames(&metrics), (unsigned long long)pm_dropped(&metrics));
+    ovl_set_text(overlay, 1, 10, 6 + OVL_CELL_H + 2, 1, 0xFFFFFF, text);
+    
+    if (ovl_composite(overlay, dst, stride, width, height, fmt) == 0) {
+        overlay_composited = true;
+    }
 }
 
-// 오버레이 그리기
+// 오버레이 그리기 (텍스트를 합성하지 못한 프레임만 XDrawString)
 void RaspberryPiViewer::drawOverlay() {
     if (!display || !window || !gc) return;
     
-    char info_text[256];
-    snprintf(info_text, sizeof(info_text), 
-             "FPS: %.1f (Target: %d) | Frames: %lu | Size: %dx%d | Platform: Raspberry Pi",
-             stats.current_fps, fps_ctrl.target_fps, 
-             stats.total_frames, frame_width, frame_height);
+    if (!overlay_composited) {
+        char info_text[256];
+        snprintf(info_text, sizeof(info_text), 
+                 "FPS: %.1f (Target: %d) | Frames: %llu | Drops: %llu | Size: %dx%d | Platform: Raspberry Pi",
+                 pm_fps_window(&metrics), fps_ctrl.target_fps, 
+                 (unsigned long long)pm_frames(&metrics), (unsigned long long)pm_dropped(&metrics),
+                 frame_width, frame_height);
+        
+        // 텍스트 그리기
+        XSetForeground(display, gc, 0xFFFFFF);  // 흰색
+        XDrawString(display, window, gc, 10, 20, info_text, strlen(info_text));
+    }
     
-    // 텍스트 그리기
-    XSetForeground(display, gc, 0xFFFFFF);  // 흰색
-    XDrawString(display, window, gc, 10, 20, info_text, strlen(info_text));
+    drawMotionCells();
+}
+
+// 움직임이 잡힌 셀을 빨간 사각형으로 표시 (프레임은 윈도우 (0,0) 에 원본 크기로 그려짐)
+void RaspberryPiViewer::drawMotionCells() {
+    if (!motion) return;
+    
+    uint8_t result[MD_MASK_BYTES];
+    pthread_mutex_lock(&motion_mutex);
+    memcpy(result, motion_result, sizeof(result));
+    pthread_mutex_unlock(&motion_mutex);
+    
+    XSetForeground(display, gc, 0xFF0000);  // 빨간색
+    for (int r = 0; r < MD_GRID_ROWS; r++) {
+        for (int c = 0; c < MD_GRID_COLS; c++) {
+            if (!md_cell_get(result, c, r)) continue;
+            int x0, y0, x1, y1;
+            md_cell_rect(motion, c, r, &x0, &y0, &x1, &y1);
+            XDrawRectangle(display, window, gc, x0, y0, x1 - x0 - 1, y1 - y0 - 1);
+        }
+    }
 }
 
 // 통계 업데이트
-void RaspberryPiViewer::updateStatistics() {
+void RaspberryPiViewer::updateStatistics(const FrameRef *ref) {
+    // 포맷 전환 후 첫 프레임: 전환 시작부터 새 포맷 프레임이 디큐될 때까지
+    if (switch_start_ns.load(std::memory_order_relaxed)) {
+        uint64_t t0 = switch_start_ns.exchange(0);
+        if (t0) {
+            printf("포맷 전환 → 첫 프레임 %.1f ms (%dx%d, %u bytes)\n", (pm_now_ns() - t0) / 1e6,
+                   frame_width, frame_height, ref->bytesused);
+        }
+    }
+    pm_frame(&metrics, ref->sequence);
+    stats.dropped_frames = pm_dropped(&metrics);
     updateFPSControl();
 }
 
+// 소프트웨어 모션 감지 (캡처 스레드 / 이벤트 루프, 디큐된 모든 프레임)
+void RaspberryPiViewer::detectMotion(const FrameRef *ref) {
+    if (!motion || ref->bytesused < (unsigned int)(frame_width * 2 * frame_height)) return;
+    
+    md_process(motion, (const uint8_t *)ref->data, frame_width * 2, MD_INPUT_YUYV,
+               frameRefTimestampNs(ref), ref->sequence);
+    
+    pthread_mutex_lock(&motion_mutex);
+    md_get_result(motion, motion_result);
+    pthread_mutex_unlock(&motion_mutex);
+}
+
+// 모션 이벤트 출력 (md_process 를 부른 스레드에서 호출)
+void RaspberryPiViewer::motionEvent(const md_event_t *ev, void *user) {
+    static const char *names[] = { "START", "UPDATE", "END" };
+    (void)user;
+    
+    printf("[MD] %-6s #%u t=%.3f s 셀 %d 최대 레벨 %.1f\n", names[ev->type], ev->sequence,
+           ev->timestamp_ns / 1e9, ev->active_cells, ev->peak_level / 256.0);
+    if (ev->type == MD_EVENT_END) {
+        printf("[MD] 지속 시간 %.2f s\n", (ev->timestamp_ns - ev->start_ns) / 1e9);
+    }
+}
+
 // 통계 출력
 void RaspberryPiViewer::printStatistics() {
     printf("\n=== 세션 통계 ===\n");
@@ -632,16 +1184,49 @@ void RaspberryPiViewer::printStatistics() {
     printf("평균 FPS: %.2f\n", stats.avg_fps);
     printf("현재 FPS: %.2f\n", stats.current_fps);
     printf("목표 FPS: %d\n", fps_ctrl.target_fps);
+    if (mjpeg_pool) {
+        mjd_pool_stats_t ms;
+        mjd_pool_get_stats(mjpeg_pool, &ms);
+        printf("MJPEG 디코딩: %llu 프레임 (슬라이스 %llu 프레임 / %llu 조각), 오류 %llu, 경고 %llu\n",
+               (unsigned long long)ms.frames, (unsigned long long)ms.sliced_frames,
+               (unsigned long long)ms.slices, (unsigned long long)(ms.errors + mjpeg_errors),
+               (unsigned long long)ms.warnings);
+    }
+    if (motion) {
+        md_stats_t mst;
+        md_get_stats(motion, &mst);
+        printf("모션 감지: %llu 프레임, 이벤트 %llu, 움직임 프레임 %llu, 평균 %.3f ms\n",
+               (unsigned long long)mst.frames, (unsigned long long)mst.events,
+               (unsigned long long)mst.motion_frames,
+               mst.frames ? mst.process_ns / 1e6 / mst.frames : 0.0);
+    }
     printf("플랫폼: Raspberry Pi\n");
+    
+    pm_snapshot_t snap;
+    pm_snapshot(&metrics, &snap);
+    printf("드롭 내역: sequence 간격 %llu, 디스플레이 %llu\n",
+           (unsigned long long)snap.seq_drops, (unsigned long long)snap.display_drops);
+    printf("%-14s %8s %9s %9s %9s %9s %9s\n", "단계(us)", "count", "mean", "p50", "p90", "p99", "max");
+    for (int i = 0; i < PM_STAGE_COUNT; i++) {
+        const pm_stage_summary_t *st = &snap.stages[i];
+        printf("%-14s %8llu %9.1f %9.1f %9.1f %9.1f %9.1f\n", pm_stage_name((pm_stage_t)i),
+               (unsigned long long)st->count, st->mean_us, st->p50_us, st->p90_us, st->p99_us, st->max_us);
+    }
     printf("================\n");
 }
 
+// 메트릭 스냅샷을 JSON 한 줄로 출력 (SIGUSR1 / -m 주기)
+void RaspberryPiViewer::dumpMetrics(FILE *fp) {
+    pm_dump_json(&metrics, fp);
+}
+
 // 통계 리셋
 void RaspberryPiViewer::resetStatistics() {
     memset(&stats, 0, sizeof(stats));
     fps_ctrl.frame_count = 0;
     clock_gettime(CLOCK_MONOTONIC, &stats.session_start);
     clock_gettime(CLOCK_MONOTONIC, &fps_ctrl.start_time);
+    pm_init(&metrics);
     printf("통계 리셋 완료\n");
 }
 
@@ -657,12 +1242,8 @@ void RaspberryPiViewer::cleanup() {
         vd = NULL;
     }
     
-    if (frame_buffer) {
-        free(frame_buffer);
-        frame_buffer = NULL;
-    }
-    
     if (display) {
+        x11_display_destroy(&xdisp);
         if (window) {
             XDestroyWindow(display, window);
         }
@@ -673,9 +1254,82 @@ void RaspberryPiViewer::cleanup() {
         display = NULL;
     }
     
+    if (mjpeg_pool) {
+        mjd_pool_destroy(mjpeg_pool);
+        mjpeg_pool = NULL;
+    }
+    
+    if (motion) {
+        md_destroy(motion);
+        motion = NULL;
+    }
+    
+    if (overlay) {
+        ovl_destroy(overlay);
+        overlay = NULL;
+    }
+    
     printf("정리 완료\n");
 }
 
+// 지원 해상도 (포맷 표에서 검증된 것, 표가 없으면 기본 목록)
+int RaspberryPiViewer::getSupportedResolutions(Resolution *resolutions, int max_count) {
+    static const int defaults[][2] = {
+        {320, 240}, {640, 480}, {800, 600}, {1024, 768}, {1280, 720}, {1920, 1080}
+    };
+    int sizes[FT_MAX_SIZES][2];
+    int n = ft_resolutions(&formats, config.format, sizes, FT_MAX_SIZES);
+    
+    if (n == 0) {
+        n = sizeof(defaults) / sizeof(defaults[0]);
+        memcpy(sizes, defaults, sizeof(defaults));
+    }
+    if (n > max_count) n = max_count;
+    for (int i = 0; i < n; i++) {
+        resolutions[i].width = sizes[i][0];
+        resolutions[i].height = sizes[i][1];
+        resolutions[i].supported = 1;
+    }
+    return n;
+}
+
+// 현재 해상도에서 지원하는 FPS (느린 순)
+int RaspberryPiViewer::getSupportedFPS(int *fps_list, int max_count) {
+    static const int defaults[] = { 15, 24, 25, 30 };
+    int n = ft_frame_rates(&formats, config.format, frame_width, frame_height, fps_list, max_count);
+    
+    if (n == 0) {
+        for (n = 0; n < (int)(sizeof(defaults) / sizeof(defaults[0])) && n < max_count; n++) {
+            fps_list[n] = defaults[n];
+        }
+    }
+    return n;
+}
+
+void RaspberryPiViewer::printSupportedFormats() {
+    printf("=== 지원 포맷 ===\n");
+    if (formats.count) {
+        ft_print(stdout, &formats);
+        printf("(? = TRY_FMT 가 다른 크기를 돌려줌, 전환 대상에서 제외)\n");
+    } else {
+        printf("포맷 표 없음 (합성/재생 소스 또는 ENUM_FRAMESIZES 미지원)\n");
+    }
+    
+    printf("해상도 키:");
+    for (int i = 0; i < 6; i++) {
+        int w = kResolutionKeys[i][0], h = kResolutionKeys[i][1], f = config.fps;
+        ft_snap(&formats, config.format, &w, &h, &f);
+        printf(" %d=%dx%d", i + 1, w, h);
+    }
+    int rates[FT_MAX_RATES];
+    int n = getSupportedFPS(rates, FT_MAX_RATES);
+    printf("\nFPS 키:");
+    for (int i = 0; i < n && i < 4; i++) {
+        printf(" F%d=%d", i + 1, rates[i]);
+    }
+    printf("\n=================\n");
+}
+
 // 시그널 핸들러
 void RaspberryPiViewer::signalHandler(int sig) {
     printf("\n시그널 %d 수신, 종료 중...\n", sig);
@@ -686,13 +1340,25 @@ void RaspberryPiViewer::signalHandler(int sig) {
 void printUsage(const char *program_name) {
     printf("사용법: %s [옵션]\n", program_name);
     printf("옵션:\n");
-    printf("  -d <device>     카메라 장치 (기본: /dev/video0)\n");
+    printf("  -d <device>     카메라 장치 (기본: /dev/video0, auto = 탐색해서 -F 를 지원하는 첫 캡처 노드)\n");
     printf("  -w <width>      해상도 너비 (기본: 640)\n");
     printf("  -h <height>     해상도 높이 (기본: 480)\n");
     printf("  -f <fps>        FPS (기본: 30)\n");
     printf("  -b <bitrate>    비트레이트 (H.264용, 기본: 1000000)\n");
     printf("  -q <quality>    품질 (H.264용, 기본: 80)\n");
     printf("  -F <format>     포맷 (0x00000021=H.264, 0x47504A4D=MJPEG)\n");
+    printf("  -S              합성 프레임 소스 사용 (카메라 없이 테스트)\n");
+    printf("  -P <pattern>    합성 패턴 (bars, box, noise)\n");
+    printf("  -R <file>       녹화 파일 반복 재생 (MJPEG / Annex-B H.264 / raw YUYV, <file>.pts 가 있으면 원본 timestamp)\n");
+    printf("  -A              합성/재생 소스를 페이싱 없이 가능한 한 빠르게\n");
+    printf("  -m <sec>        메트릭 JSON 주기 출력 (SIGUSR1 로도 출력)\n");
+    printf("  -E              epoll 이벤트 루프 모드 (장치 timestamp 페이싱, 단일 스레드)\n");
+    printf("  -M <threshold>  소프트웨어 모션 감지 (YUYV, 임계값 0~65535, 0x600 = 평균 휘도 차 6)\n");
+    printf("  -K \"m1 ... m24\" 모션 감지 마스크 (16진수 24 바이트, --xuset-mdm 과 같은 배치)\n");
+    printf("  -D <list>       모자이크 모드: 장치 / synth[:패턴] 를 쉼표로 (예: /dev/video0,/dev/video2,synth:box)\n");
+    printf("                  -w/-h/-f 는 카메라마다 요청, -F 는 YUYV(0x56595559) 또는 MJPEG (H.264 는 YUYV 로)\n");
+    printf("  -C <cpus>       모자이크 카메라별 캡처 스레드 코어 (예: 0,1,2,3)\n");
+    printf("  -L              장치 탐색 결과 (sysfs + 동시 QUERYCAP) 출력 후 종료\n");
     printf("  -v              상세 출력\n");
     printf("  -?              이 도움말\n");
     printf("\n");
@@ -711,8 +1377,20 @@ int parseCommandLine(int argc, char **argv, CameraConfig *config) {
     config->format = V4L2_PIX_FMT_H264;  // H.264 기본
     config->bitrate = 1000000;
     config->quality = 80;
-    
-    while ((opt = getopt(argc, argv, "d:w:h:f:b:q:F:v?")) != -1) {
+    config->synthetic = 0;
+    config->synthetic_pattern = FRAME_PATTERN_BARS;
+    config->replay_file[0] = '\0';
+    config->fast_source = 0;
+    config->metrics_interval = 0;
+    config->event_loop = 0;
+    config->motion_threshold = 0;
+    config->motion_mask_set = 0;
+    memset(config->motion_mask, 0xFF, sizeof(config->motion_mask));
+    config->mosaic_sources[0] = '\0';
+    config->mosaic_cpus[0] = '\0';
+    config->list_devices = 0;
+    
+    while ((opt = getopt(argc, argv, "d:w:h:f:b:q:F:SP:R:Am:EM:K:D:C:Lv?")) != -1) {
         switch (opt) {
             case 'd':
                 strncpy(config->device_name, optarg, sizeof(config->device_name)-1);
@@ -735,6 +1413,68 @@ int parseCommandLine(int argc, char **argv, CameraConfig *config) {
             case 'F':
                 config->format = strtol(optarg, NULL, 16);
                 break;
+            case 'S':
+                config->synthetic = 1;
+                break;
+            case 'P':
+                if (!strcmp(optarg, "bars")) {
+                    config->synthetic_pattern = FRAME_PATTERN_BARS;
+                } else if (!strcmp(optarg, "box")) {
+                    config->synthetic_pattern = FRAME_PATTERN_BOX;
+                } else if (!strcmp(optarg, "noise")) {
+                    config->synthetic_pattern = FRAME_PATTERN_NOISE;
+                } else {
+                    printf("합성 패턴은 bars, box, noise\n");
+                    return -1;
+                }
+                config->synthetic = 1;
+                break;
+            case 'R':
+                strncpy(config->replay_file, optarg, sizeof(config->replay_file) - 1);
+                config->replay_file[sizeof(config->replay_file) - 1] = '\0';
+                break;
+            case 'A':
+                config->fast_source = 1;
+                break;
+            case 'm':
+                config->metrics_interval = atoi(optarg);
+                break;
+            case 'E':
+                config->event_loop = 1;
+                break;
+            case 'M':
+                config->motion_threshold = strtol(optarg, NULL, 0);
+                if (config->motion_threshold < 0 || config->motion_threshold > 65535) {
+                    printf("모션 감지 임계값은 0~65535\n");
+                    return -1;
+                }
+                break;
+            case 'K': {
+                char *p = optarg;
+                for (int i = 0; i < MD_MASK_BYTES; i++) {
+                    char *end;
+                    long v = strtol(p, &end, 16);
+                    if (end == p || v < 0 || v > 0xFF) {
+                        printf("모션 감지 마스크는 16진수 24 바이트\n");
+                        return -1;
+                    }
+                    config->motion_mask[i] = (uint8_t)v;
+                    p = end;
+                }
+                config->motion_mask_set = 1;
+                break;
+            }
+            case 'D':
+                strncpy(config->mosaic_sources, optarg, sizeof(config->mosaic_sources) - 1);
+                config->mosaic_sources[sizeof(config->mosaic_sources) - 1] = '\0';
+                break;
+            case 'C':
+                strncpy(config->mosaic_cpus, optarg, sizeof(config->mosaic_cpus) - 1);
+                config->mosaic_cpus[sizeof(config->mosaic_cpus) - 1] = '\0';
+                break;
+            case 'L':
+                config->list_devices = 1;
+                break;
             case 'v':
                 // 상세 출력 플래그
                 break;
@@ -749,3 +1489,194 @@ int parseCommandLine(int argc, char **argv, CameraConfig *config) {
     
     return 0;
 }
+
+// -L / -d auto / -D auto: 장치 노드를 sysfs 와 동시 QUERYCAP 으로 찾는다 (노드를 하나씩 열어 보지 않음)
+// 선택한 장치로 config 를 고친다. 찾지 못하면 -1
+int resolveDevices(CameraConfig *config) {
+    int want_single = !strcmp(config->device_name, "auto");
+    int want_mosaic = !strcmp(config->mosaic_sources, "auto");
+    if (!config->list_devices && !want_single && !want_mosaic) return 0;
+
+    dd_list_t *list = (dd_list_t *)malloc(sizeof(dd_list_t));
+    if (!list) return -1;
+    if (dd_discover(list, NULL, NULL, 1) < 0) {
+        printf("장치 탐색 실패: /sys/class/video4linux 없음\n");
+        free(list);
+        return -1;
+    }
+    dd_print(list, stdout);
+
+    // 모자이크는 H.264 대신 YUYV 로 캡처하므로 그 포맷으로 고른다
+    unsigned int pixfmt = config->format;
+    if (want_mosaic && pixfmt != V4L2_PIX_FMT_MJPEG) pixfmt = V4L2_PIX_FMT_YUYV;
+
+    int r = 0;
+    if (want_single) {
+        const dd_device_t *d = dd_best(list, pixfmt);
+        if (!d) d = dd_best(list, 0);
+        if (d && snprintf(config->device_name, sizeof(config->device_name), "%s", d->path) >=
+                     (int)sizeof(config->device_name)) {
+            printf("장치 경로가 너무 김: %s\n", d->path);
+            r = -1;
+        } else if (d) {
+            printf("장치 선택: %s (%s, %s)\n", d->path, d->card, dd_chip_name(d->chip));
+        } else {
+            printf("캡처 장치를 찾지 못함\n");
+            r = -1;
+        }
+    }
+    if (want_mosaic) {
+        size_t len = 0;
+        int n = 0;
+        config->mosaic_sources[0] = '\0';
+        for (int i = 0; i < list->count && n < MULTI_CAPTURE_MAX_CAMERAS; i++) {
+            const dd_device_t *d = &list->dev[i];
+            if (d->node != DD_NODE_CAPTURE || d->probe_error == EBUSY || !dd_has_format(d, pixfmt)) continue;
+            int w = snprintf(config->mosaic_sources + len, sizeof(config->mosaic_sources) - len,
+                             "%s%s", n ? "," : "", d->path);
+            if (w < 0 || len + w >= sizeof(config->mosaic_sources)) break;
+            len += w;
+            n++;
+        }
+        if (n == 0) {
+            printf("모자이크에 쓸 캡처 장치를 찾지 못함\n");
+            r = -1;
+        } else {
+            printf("모자이크 장치 %d 대: %s\n", n, config->mosaic_sources);
+        }
+    }
+    free(list);
+    return r;
+}
+
+// 모자이크 모드: 카메라마다 캡처 스레드 하나 (코어 고정), 메인 스레드가 30Hz 로 합성해 한 윈도우에 출력
+// X11 이 없으면 화면 없이 캡처만 하고 통계를 출력한다
+int runMosaicViewer(const CameraConfig *config) {
+    unsigned int pixfmt = config->format == V4L2_PIX_FMT_MJPEG ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
+    if (config->format != (int)pixfmt) {
+        printf("모자이크는 YUYV / MJPEG 만 지원: YUYV 로 캡처\n");
+    }
+
+    int cpus[MULTI_CAPTURE_MAX_CAMERAS];
+    int ncpus = 0;
+    char list[256];
+    char *save = NULL;
+    snprintf(list, sizeof(list), "%s", config->mosaic_cpus);
+    for (char *tok = strtok_r(list, ",", &save); tok && ncpus < MULTI_CAPTURE_MAX_CAMERAS;
+         tok = strtok_r(NULL, ",", &save)) {
+        cpus[ncpus++] = atoi(tok);
+    }
+
+    MultiCameraCapture mosaic;
+    int index = 0;
+    snprintf(list, sizeof(list), "%s", config->mosaic_sources);
+    for (char *tok = strtok_r(list, ",", &save); tok; tok = strtok_r(NULL, ",", &save), index++) {
+        int cpu = ncpus > 0 ? cpus[index % ncpus] : -1;
+        int r;
+        if (!strncmp(tok, "synth", 5)) {
+            int pattern = FRAME_PATTERN_BARS;
+            if (!strcmp(tok + 5, ":box")) pattern = FRAME_PATTERN_BOX;
+            else if (!strcmp(tok + 5, ":noise")) pattern = FRAME_PATTERN_NOISE;
+            SyntheticFrameSource *syn = new SyntheticFrameSource(config->width, config->height, 4);
+            syn->setPattern(pattern);
+            syn->setFrameRate(config->fps);
+            r = mosaic.addSource(syn, tok, cpu);
+            if (r < 0) delete syn;
+        } else {
+            r = mosaic.addDevice(tok, config->width, config->height, config->fps, pixfmt, cpu);
+        }
+        if (r < 0) {
+            printf("모자이크 소스 추가 실패: %s\n", tok);
+            return -1;
+        }
+    }
+
+    if (mosaic.start(MOSAIC_WIDTH, MOSAIC_HEIGHT) < 0) {
+        printf("모자이크 캡처 시작 실패\n");
+        return -1;
+    }
+
+    Display *display = XOpenDisplay(NULL);
+    Window window = 0;
+    GC gc = 0;
+    x11_display_t xdisp;
+    memset(&xdisp, 0, sizeof(xdisp));
+    if (display) {
+        int screen = DefaultScreen(display);
+        window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, MOSAIC_WIDTH, MOSAIC_HEIGHT,
+                                     1, BlackPixel(display, screen), WhitePixel(display, screen));
+        XStoreName(display, window, "Raspberry Pi SDK Viewer - Mosaic");
+        XSelectInput(display, window, ExposureMask | KeyPressMask | StructureNotifyMask);
+        XMapWindow(display, window);
+        gc = XCreateGC(display, window, 0, NULL);
+        if (x11_display_init(&xdisp, display, window, gc, 1) < 0 ||
+            x11_display_resize(&xdisp, MOSAIC_WIDTH, MOSAIC_HEIGHT) < 0) {
+            printf("디스플레이 백엔드 초기화 실패\n");
+            g_running = 0;
+        }
+    } else {
+        printf("X11 디스플레이 없음: 화면 없이 캡처만 (2초마다 통계)\n");
+    }
+
+    printf("\n=== 모자이크 %d 대 (%dx%d) ===\n", mosaic.cameraCount(), MOSAIC_WIDTH, MOSAIC_HEIGHT);
+    printf("제어: ESC - 종료, I - 카메라별 통계\n\n");
+
+    struct timespec next_dump;
+    clock_gettime(CLOCK_MONOTONIC, &next_dump);
+    int dump_interval = config->metrics_interval > 0 ? config->metrics_interval : (display ? 0 : 2);
+    next_dump.tv_sec += dump_interval;
+
+    while (g_running) {
+        if (display) {
+            XEvent event;
+            while (XPending(display)) {
+                XNextEvent(display, &event);
+                if (x11_display_handle_event(&xdisp, &event))
+                    continue;
+                if (event.type == KeyPress) {
+                    KeySym sym = XLookupKeysym(&event.xkey, 0);
+                    if (sym == XK_Escape) {
+                        g_running = 0;
+                    } else if (sym == XK_i || sym == XK_I) {
+                        g_dump_metrics = 1;
+                    }
+                }
+            }
+
+            int stride;
+            uint8_t *dst = x11_display_back_buffer(&xdisp, &stride);
+            if (dst) {
+                mosaic.composite(dst, stride, xdisp.format);
+                x11_display_present(&xdisp, 0, 0);
+                XFlush(display);
+            }
+        }
+        usleep(33000);  // 약 30Hz (카메라 타일은 각자 캡처 스레드가 갱신)
+
+        if (dump_interval > 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec > next_dump.tv_sec ||
+                (now.tv_sec == next_dump.tv_sec && now.tv_nsec >= next_dump.tv_nsec)) {
+                g_dump_metrics = 1;
+                next_dump.tv_sec += dump_interval;
+            }
+        }
+        if (g_dump_metrics) {
+            g_dump_metrics = 0;
+            mosaic.printStats(stdout);
+        }
+    }
+
+    mosaic.stop();
+    printf("\n=== 모자이크 통계 ===\n");
+    mosaic.printStats(stdout);
+
+    if (display) {
+        x11_display_destroy(&xdisp);
+        if (window) XDestroyWindow(display, window);
+        if (gc) XFreeGC(display, gc);
+        XCloseDisplay(display);
+    }
+    return 0;
+}
@@ -36,19 +36,35 @@
 #include "sdk_deps/OSD-Linux_H264_AP_0724/sdk_definitions.h"
 #include "sdk_deps/OSD-Linux_H264_AP_0724/v4l2uvc.h"
 #include "sdk_deps/OSD-Linux_H264_AP_0724/h264_xu_ctrls.h"
+#include "sdk_deps/OSD-Linux_H264_AP_0724/nalu.h"
+
+// 캡처 파이프라인
+#include "frame_source.h"
+#include "capture_ring.h"
+#include "capture_loop.h"
+#include "color_convert.h"
+#include "x11_display.h"
+#include "pipeline_metrics.h"
+#include "mjpeg_decode.h"
+#include "motion_detect.h"
+#include "format_table.h"
+#include "text_overlay.h"
+#include "multi_capture.h"
+#include "device_discovery.h"
 
 // 설정 상수
 #define MAX_DEVICES 10
 #define MAX_BUFFERS 16
 #define MAX_FPS 120
 #define MIN_FPS 1
+#define MOSAIC_WIDTH 1280    // 모자이크 캔버스 (윈도우) 크기
+#define MOSAIC_HEIGHT 720
 
 // FPS 제어 구조체
 typedef struct {
     int target_fps;
     int actual_fps;
     struct timespec frame_interval;
-    struct timespec last_frame_time;
     int frame_count;
     struct timespec start_time;
 } FPSController;
@@ -69,10 +85,22 @@ typedef struct {
     int format;  // V4L2_PIX_FMT_H264, V4L2_PIX_FMT_MJPEG 등
     int quality;
     int bitrate;
+    int synthetic;  // 1 이면 카메라 대신 합성 프레임 소스 사용
+    int synthetic_pattern;  // FRAME_PATTERN_* (합성 소스)
+    char replay_file[256];  // 비어 있지 않으면 카메라 대신 녹화 파일 재생 (반복)
+    int fast_source;        // 1 이면 합성/재생 소스를 페이싱 없이 가능한 한 빠르게
+    int metrics_interval;  // 메트릭 JSON 주기 출력 간격 (초, 0 이면 SIGUSR1 때만)
+    int event_loop;        // 1 이면 캡처/디스플레이를 epoll 이벤트 루프 스레드 하나로 처리
+    int motion_threshold;  // 소프트웨어 모션 감지 임계값 (Q8, 0 이면 끔)
+    int motion_mask_set;   // 1 이면 motion_mask 사용 (아니면 전체 셀)
+    uint8_t motion_mask[MD_MASK_BYTES];  // XU_MD_Set_Mask 와 같은 배치
+    char mosaic_sources[256];  // 비어 있지 않으면 모자이크 모드 (장치 또는 synth[:패턴], 쉼표 구분)
+    char mosaic_cpus[64];      // 카메라별 캡처 스레드 코어 (쉼표 구분, 비어 있으면 고정 안 함)
+    int list_devices;          // 1 이면 장치 탐색 결과만 출력하고 끝
 } CameraConfig;
 
 // 라즈베리파이 전용 뷰어 클래스
-class RaspberryPiViewer {
+class RaspberryPiViewer : public FramePresenter {
 private:
     struct vdIn *vd;
     FPSController fps_ctrl;
@@ -81,24 +109,42 @@ private:
     pthread_t capture_thread;
     pthread_t display_thread;
     pthread_mutex_t frame_mutex;
+    std::atomic<int> pipeline_running;  // 캡처/디스플레이 스레드 실행 플래그
+    int threads_started;
+    int wake_fd;                        // 새 프레임 알림용 eventfd (캡처 → 디스플레이)
+    int stop_fd;                        // stopThreads() 가 캡처 스레드의 poll 을 바로 깨우는 eventfd
     
     // X11 디스플레이 관련
     Display *display;
     Window window;
     GC gc;
-    XImage *ximage;
+    x11_display_t xdisp;     // 영구 XImage / MIT-SHM 더블 버퍼
+    int win_width;           // ConfigureNotify 로 갱신되는 윈도우 크기
+    int win_height;
     
-    // 프레임 버퍼
-    unsigned char *frame_buffer;
-    int frame_buffer_size;
+    // 캡처 소스와 제로카피 링
+    FrameSource *source;
+    CaptureRing *ring;
+    FrameRef current_frame;  // 디스플레이가 참조 중인 최신 프레임 (frame_mutex 보호)
+    LatestFrameSlot latest;  // 캡처 스레드 → 디스플레이 스레드 단일 슬롯 핸드오프
     int frame_width;
     int frame_height;
     
     // H.264 관련
     struct H264Format *h264_fmt;
     int h264_decoder_initialized;
+    H264_PARSER h264_parser;  // SPS/PPS 캐시 + GOP 추적
+    
+    // MJPEG 디코더 풀 (재시작 마커가 있으면 슬라이스를 코어마다 나눠 디코딩)
+    mjd_pool_t *mjpeg_pool;
+    unsigned long mjpeg_errors;
     
-    // 통계 정보
+    // 소프트웨어 모션 감지 (캡처 스레드에서 실행, 결과는 오버레이가 읽음)
+    md_engine_t *motion;
+    pthread_mutex_t motion_mutex;
+    uint8_t motion_result[MD_MASK_BYTES];  // 마지막 프레임 결과 (motion_mutex 보호)
+    
+    // 통계 정보 (캡처 스레드 전용, 다른 스레드는 metrics 를 읽는다)
     struct {
         unsigned long total_frames;
         unsigned long dropped_frames;
@@ -106,6 +152,19 @@ private:
         double current_fps;
         struct timespec session_start;
     } stats;
+    
+    // 단계별 지연 히스토그램, sequence 드롭, 슬라이딩 윈도우 FPS
+    pipeline_metrics_t metrics;
+    
+    // ENUM_FRAMESIZES / ENUM_FRAMEINTERVALS 로 만든 지원 포맷 표 (카메라일 때만)
+    ft_table_t formats;
+    // 스트리밍 중 포맷 전환: 키 입력이 요청 (w << 32 | h << 16 | fps), 메인 스레드가 적용
+    std::atomic<uint64_t> pending_format;
+    std::atomic<uint64_t> switch_start_ns;  // 전환 시작 시각 (첫 프레임에서 지연 출력 후 0)
+    
+    // 정보 텍스트 오버레이 (디스플레이 스레드). 글자가 바뀐 줄만 다시 렌더링해 백 버퍼에 합성
+    ovl_t *overlay;
+    bool overlay_composited;    // 이번 프레임에 합성했으면 XDrawString 생략
 
 public:
     RaspberryPiViewer();
@@ -115,21 +174,39 @@ public:
     int initialize(const CameraConfig *cfg);
     int openCamera(const char *device);
     int setFormat(int width, int height, int fps);
+    int switchFormat(int width, int height, int fps);   // 스트리밍 중에도 가능 (메인 스레드)
+    void requestFormat(int width, int height, int fps); // 아무 스레드 (다음 applyPendingFormat 에서)
+    int applyPendingFormat();
     int setH264Parameters(int bitrate, int quality, int keyframe_interval);
     
     // FPS 제어
     int setTargetFPS(int fps);
     int getCurrentFPS();
     void updateFPSControl();
-    void waitForNextFrame();
     
     // 스트리밍 제어
     int startStreaming();
     int stopStreaming();
     int isStreaming() const { return running; }
     
+    // 파이프라인 스레드 (캡처는 poll()/DQBUF 에서 대기, 디스플레이는 최신 프레임만 렌더링)
+    // -E: 두 스레드 대신 CaptureEventLoop 스레드 하나 (V4L2 fd + 출력 timerfd + X11 fd)
+    int startThreads();
+    void stopThreads();
+    void captureLoop();
+    void displayLoop();
+    void runEventLoop();
+    static void *captureThreadMain(void *arg);
+    static void *displayThreadMain(void *arg);
+    static void *eventThreadMain(void *arg);
+    
+    // FramePresenter (이벤트 루프 콜백)
+    virtual int onFrame(const FrameRef *ref);
+    virtual void present(FrameRef *ref);
+    virtual void onFdReady(int fd);
+    virtual void onIdle();
+    
     // 프레임 처리
-    int captureFrame();
     int decodeH264Frame(unsigned char *data, int size);
     int displayFrame();
     
@@ -137,15 +214,23 @@ public:
     int initializeX11Display();
     int createWindow(int width, int height);
     void updateDisplay();
+    void handleX11Events();
+    void renderCurrentFrame();
     void drawFrame();
     void drawRawFrame();
     void drawYUYVFrame();
+    void drawMJPEGFrame();
     void drawOverlay();
+    void compositeOverlay(uint8_t *dst, int stride, int width, int height);
+    void drawMotionCells();
     
     // 통계 및 모니터링
-    void updateStatistics();
+    void updateStatistics(const FrameRef *ref);
+    void detectMotion(const FrameRef *ref);
+    static void motionEvent(const md_event_t *ev, void *user);
     void printStatistics();
     void resetStatistics();
+    void dumpMetrics(FILE *fp);
     
     // 유틸리티
     int getSupportedResolutions(Resolution *resolutions, int max_count);
@@ -161,12 +246,15 @@ public:
 // 전역 변수 선언
 extern RaspberryPiViewer *g_viewer;
 extern volatile int g_running;
+extern volatile sig_atomic_t g_dump_metrics;
 
 // 유틸리티 함수들
 int xioctl(int fd, int request, void *arg);
 int errnoexit(const char *s);
 void printUsage(const char *program_name);
 int parseCommandLine(int argc, char **argv, CameraConfig *config);
+int resolveDevices(CameraConfig *config);
+int runMosaicViewer(const CameraConfig *config);
 
 // 라즈베리파이 전용 매크로
 #define CLEAR(x) memset(&(x), 0, sizeof(x))
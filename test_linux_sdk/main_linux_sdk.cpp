@@ -4,6 +4,7 @@
 // 전역 변수
 RaspberryPiViewer *g_viewer = NULL;
 volatile int g_running = 1;
+volatile sig_atomic_t g_dump_metrics = 0;
 
 // 시그널 핸들러
 void signalHandler(int sig) {
@@ -11,6 +12,12 @@ void signalHandler(int sig) {
     g_running = 0;
 }
 
+// SIGUSR1: 메인 루프에서 메트릭 JSON 출력
+void metricsSignalHandler(int sig) {
+    (void)sig;
+    g_dump_metrics = 1;
+}
+
 // 메인 함수
 int main(int argc, char **argv) {
     CameraConfig config;
@@ -25,9 +32,23 @@ int main(int argc, char **argv) {
         return -1;
     }
     
+    // 장치 탐색 (-L 목록, -d auto / -D auto 선택)
+    if (resolveDevices(&config) < 0) {
+        return -1;
+    }
+    if (config.list_devices) {
+        return 0;
+    }
+    
     // 시그널 핸들러 설정
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    signal(SIGUSR1, metricsSignalHandler);
+    
+    // 여러 카메라를 한 화면에 (뷰어 대신 MultiCameraCapture)
+    if (config.mosaic_sources[0]) {
+        return runMosaicViewer(&config) < 0 ? -1 : 0;
+    }
     
     // 라즈베리파이 SDK 뷰어 생성
     g_viewer = new RaspberryPiViewer();
@@ -56,26 +77,46 @@ int main(int argc, char **argv) {
     printf("  R - 통계 리셋\n");
     printf("  I - 카메라 정보\n");
     printf("  F - 지원 포맷\n");
+    printf("  1-6 - 해상도 전환 (320x240 ~ 1920x1080, 스트리밍 유지)\n");
+    printf("  F1-F4 - FPS 전환\n");
     printf("====================\n\n");
     
-    // 메인 루프
+    // 캡처 스레드와 디스플레이 스레드 시작
+    // (X11 이벤트는 디스플레이 스레드의 updateDisplay, -E 모드에서는 이벤트 루프의 onFdReady/onIdle 에서 처리됨)
+    if (g_viewer->startThreads() < 0) {
+        printf("파이프라인 스레드 시작 실패\n");
+        delete g_viewer;
+        return -1;
+    }
+    
+    // 메인 스레드는 종료 신호와 메트릭 출력 요청만 처리한다
+    struct timespec next_dump;
+    clock_gettime(CLOCK_MONOTONIC, &next_dump);
+    next_dump.tv_sec += config.metrics_interval;
+    
     while (g_running) {
-        // 프레임 캡처
-        if (g_viewer->captureFrame() == 0) {
-            // FPS 제어
-            g_viewer->waitForNextFrame();
-            
-            // 통계 업데이트
-            g_viewer->updateStatistics();
-            
-            // 디스플레이 업데이트
-            g_viewer->updateDisplay();
-        }
+        usleep(100000);  // 100ms
         
-        // 키 입력 처리 (X11 이벤트는 updateDisplay에서 처리됨)
-        usleep(1000);  // 1ms 대기
+        // 키 입력으로 요청된 해상도 / FPS 전환 (스레드 정지·재시작은 메인 스레드에서)
+        g_viewer->applyPendingFormat();
+        
+        if (config.metrics_interval > 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec > next_dump.tv_sec ||
+                (now.tv_sec == next_dump.tv_sec && now.tv_nsec >= next_dump.tv_nsec)) {
+                g_dump_metrics = 1;
+                next_dump.tv_sec += config.metrics_interval;
+            }
+        }
+        if (g_dump_metrics) {
+            g_dump_metrics = 0;
+            g_viewer->dumpMetrics(stdout);
+        }
     }
     
+    g_viewer->stopThreads();
+    
     printf("\n=== 종료 중 ===\n");
     
     // 통계 출력
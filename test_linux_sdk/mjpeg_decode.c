@@ -0,0 +1,795 @@
+//----------------------------------------------//
+//	MJPEG 디코드 단계 (libjpeg-turbo 워커 풀)	//
+//----------------------------------------------//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <jpeglib.h>
+#include <jerror.h>
+#include "mjpeg_decode.h"
+#include "sdk_deps/OSD-Linux_H264_AP_0724/mjpeg_dht.h"
+
+#ifndef JCS_EXTENSIONS
+#error "mjpeg_decode 는 libjpeg-turbo (JCS_EXT_BGRX, JCS_RGB565) 가 필요합니다"
+#endif
+
+// 슬라이스 하나: [SOF 앞 헤더, 높이를 고친 SOF, SOF 뒤 ~ SOS, 엔트로피 구간, EOI]
+#define MJD_IOV_MAX         5
+#define MJD_MAX_SLICES      (MJD_MAX_WORKERS + 1)
+#define MJD_SOF_MAX         (2 + 8 + 3 * 3)
+
+static const JOCTET mjd_eoi[2] = { 0xFF, JPEG_EOI };
+
+//----------------------------------------------
+// iovec 소스 매니저 (jpeg_mem_src 대신, 복사 없이 여러 조각을 이어 읽는다)
+//----------------------------------------------
+typedef struct {
+    struct jpeg_source_mgr pub;
+    struct iovec iov[MJD_IOV_MAX];
+    int cnt;
+    int next;
+} mjd_source_t;
+
+static void src_init(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+static boolean src_fill(j_decompress_ptr cinfo)
+{
+    mjd_source_t *src = (mjd_source_t *)cinfo->src;
+
+    while (src->next < src->cnt && src->iov[src->next].iov_len == 0)
+        src->next++;
+    if (src->next >= src->cnt) {
+        // 잘린 프레임: jdatasrc.c 와 같이 EOI 를 넣어 남은 MCU 를 채우게 한다
+        WARNMS(cinfo, JWRN_JPEG_EOF);
+        src->pub.next_input_byte = mjd_eoi;
+        src->pub.bytes_in_buffer = sizeof(mjd_eoi);
+        return TRUE;
+    }
+    src->pub.next_input_byte = (const JOCTET *)src->iov[src->next].iov_base;
+    src->pub.bytes_in_buffer = src->iov[src->next].iov_len;
+    src->next++;
+    return TRUE;
+}
+
+static void src_skip(j_decompress_ptr cinfo, long num_bytes)
+{
+    mjd_source_t *src = (mjd_source_t *)cinfo->src;
+
+    if (num_bytes <= 0)
+        return;
+    while (num_bytes > (long)src->pub.bytes_in_buffer) {
+        num_bytes -= (long)src->pub.bytes_in_buffer;
+        src_fill(cinfo);
+    }
+    src->pub.next_input_byte += num_bytes;
+    src->pub.bytes_in_buffer -= num_bytes;
+}
+
+static void src_term(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+//----------------------------------------------
+// 디코더
+//----------------------------------------------
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jump;
+} mjd_error_t;
+
+struct mjd_decoder {
+    struct jpeg_decompress_struct cinfo;
+    mjd_error_t err;
+    mjd_source_t src;
+    unsigned long warnings;
+    long last_warnings;         // 마지막 디코딩의 경고 수
+};
+
+static void err_exit(j_common_ptr cinfo)
+{
+    longjmp(((mjd_error_t *)cinfo->err)->jump, 1);
+}
+
+// 경고/오류 메시지는 출력하지 않는다 (UVC 프레임은 끝이 잘린 경우가 흔함)
+static void err_output(j_common_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+mjd_decoder_t *mjd_decoder_create(void)
+{
+    mjd_decoder_t *volatile dec = (mjd_decoder_t *)calloc(1, sizeof(*dec));
+    if (!dec)
+        return NULL;
+
+    dec->cinfo.err = jpeg_std_error(&dec->err.pub);
+    dec->err.pub.error_exit = err_exit;
+    dec->err.pub.output_message = err_output;
+    if (setjmp(dec->err.jump)) {
+        free(dec);
+        return NULL;
+    }
+    jpeg_create_decompress(&dec->cinfo);
+
+    dec->src.pub.init_source = src_init;
+    dec->src.pub.fill_input_buffer = src_fill;
+    dec->src.pub.skip_input_data = src_skip;
+    dec->src.pub.resync_to_restart = jpeg_resync_to_restart;
+    dec->src.pub.term_source = src_term;
+    return dec;
+}
+
+void mjd_decoder_destroy(mjd_decoder_t *dec)
+{
+    if (!dec)
+        return;
+    jpeg_destroy_decompress(&dec->cinfo);
+    free(dec);
+}
+
+unsigned long mjd_decoder_warnings(const mjd_decoder_t *dec)
+{
+    return dec ? dec->warnings : 0;
+}
+
+// 한 iMCU 행씩 Y/Cb/Cr 평면에 직접 읽는다 (색변환/업샘플링 없음)
+static void read_raw(j_decompress_ptr cinfo, const mjd_image_t *dst)
+{
+    JSAMPROW rows[3][4 * DCTSIZE];
+    JSAMPARRAY planes[3] = { rows[0], rows[1], rows[2] };
+    JDIMENSION lines = (JDIMENSION)(cinfo->max_v_samp_factor * DCTSIZE);
+    int c, r;
+
+    while (cinfo->output_scanline < cinfo->output_height) {
+        JDIMENSION imcu = cinfo->output_scanline / lines;
+
+        for (c = 0; c < cinfo->num_components; c++) {
+            int v = cinfo->comp_info[c].v_samp_factor;
+            uint8_t *base = dst->plane[c] + (size_t)imcu * v * DCTSIZE * dst->stride[c];
+            for (r = 0; r < v * DCTSIZE; r++)
+                rows[c][r] = base + (size_t)r * dst->stride[c];
+        }
+        jpeg_read_raw_data(cinfo, planes, lines);
+    }
+}
+
+static void read_pixels(j_decompress_ptr cinfo, const mjd_image_t *dst)
+{
+    JSAMPROW rows[16];
+    int i;
+
+    while (cinfo->output_scanline < cinfo->output_height) {
+        JDIMENSION left = cinfo->output_height - cinfo->output_scanline;
+        int n = left < 16 ? (int)left : 16;
+        for (i = 0; i < n; i++)
+            rows[i] = dst->plane[0] + (size_t)(cinfo->output_scanline + i) * dst->stride[0];
+        jpeg_read_scanlines(cinfo, rows, (JDIMENSION)n);
+    }
+}
+
+static int decode_iov(mjd_decoder_t *dec, const struct iovec *iov, int cnt,
+                      mjd_output_t out, const mjd_image_t *dst, int fancy)
+{
+    j_decompress_ptr cinfo = &dec->cinfo;
+
+    memcpy(dec->src.iov, iov, sizeof(*iov) * cnt);
+    dec->src.cnt = cnt;
+    dec->src.next = 0;
+    dec->src.pub.next_input_byte = NULL;
+    dec->src.pub.bytes_in_buffer = 0;
+    cinfo->src = &dec->src.pub;
+    dec->err.pub.num_warnings = 0;
+
+    if (setjmp(dec->err.jump)) {
+        jpeg_abort_decompress(cinfo);
+        dec->last_warnings = dec->err.pub.num_warnings;
+        dec->warnings += dec->last_warnings;
+        return -1;
+    }
+
+    // DHT 가 없는 프레임은 libjpeg-turbo 가 표준 Huffman 테이블로 채운다
+    jpeg_read_header(cinfo, TRUE);
+    if (cinfo->num_components > 3)
+        ERREXIT(cinfo, JERR_CONVERSION_NOTIMPL);
+
+    switch (out) {
+    case MJD_OUT_YUV:
+        cinfo->raw_data_out = TRUE;
+        cinfo->out_color_space = cinfo->jpeg_color_space;
+        break;
+    case MJD_OUT_RGB24:
+        cinfo->out_color_space = JCS_RGB;
+        break;
+    case MJD_OUT_BGRX32:
+        cinfo->out_color_space = JCS_EXT_BGRX;
+        break;
+    case MJD_OUT_RGB565:
+        cinfo->out_color_space = JCS_RGB565;
+        cinfo->dither_mode = JDITHER_NONE;
+        break;
+    default:
+        ERREXIT(cinfo, JERR_CONVERSION_NOTIMPL);
+    }
+    cinfo->dct_method = JDCT_ISLOW;
+    cinfo->do_fancy_upsampling = fancy ? TRUE : FALSE;
+
+    jpeg_start_decompress(cinfo);
+    if (out == MJD_OUT_YUV)
+        read_raw(cinfo, dst);
+    else
+        read_pixels(cinfo, dst);
+    jpeg_finish_decompress(cinfo);
+
+    dec->last_warnings = dec->err.pub.num_warnings;
+    dec->warnings += dec->last_warnings;
+    return 0;
+}
+
+//----------------------------------------------
+// 헤더 분석
+//----------------------------------------------
+typedef struct {
+    mjd_info_t info;
+    MJPEG_INFO marker;
+    int h_samp[3];
+    int v_samp[3];
+    int max_v;
+    int fancy;                  // 세로 업샘플링이 없으면 fancy upsampling 사용
+} mjd_header_t;
+
+static int parse_header(const uint8_t *jpeg, size_t len, mjd_header_t *hdr)
+{
+    mjd_info_t *info = &hdr->info;
+    const uint8_t *sof;
+    int c, max_h = 1, max_v = 1;
+
+    memset(hdr, 0, sizeof(*hdr));
+    if (len > 0xFFFFFFFFu || MjpegParse(jpeg, (unsigned int)len, &hdr->marker) < 0)
+        return -1;
+    if (hdr->marker.sof_marker == 0 || hdr->marker.height == 0 ||
+        hdr->marker.width == 0 || hdr->marker.components > 3)
+        return -1;
+
+    // SOF: 마커(2) 길이(2) 정밀도(1) 높이(2) 너비(2) 성분 수(1), 성분마다 ID/샘플링/양자화 테이블
+    sof = jpeg + hdr->marker.sof_offset;
+    for (c = 0; c < hdr->marker.components; c++) {
+        hdr->h_samp[c] = sof[11 + 3 * c] >> 4;
+        hdr->v_samp[c] = sof[11 + 3 * c] & 0x0F;
+        if (hdr->h_samp[c] < 1 || hdr->h_samp[c] > 4 || hdr->v_samp[c] < 1 || hdr->v_samp[c] > 4)
+            return -1;
+        if (hdr->h_samp[c] > max_h)
+            max_h = hdr->h_samp[c];
+        if (hdr->v_samp[c] > max_v)
+            max_v = hdr->v_samp[c];
+    }
+    hdr->max_v = max_v;
+
+    info->width = hdr->marker.width;
+    info->height = hdr->marker.height;
+    info->components = hdr->marker.components;
+    info->progressive = hdr->marker.sof_marker != 0xC0 && hdr->marker.sof_marker != 0xC1;
+    info->restart_interval = hdr->marker.restart_interval;
+    info->mcu_width = max_h * DCTSIZE;
+    info->mcu_height = max_v * DCTSIZE;
+    info->mcus_per_row = (info->width + info->mcu_width - 1) / info->mcu_width;
+    info->mcu_rows = (info->height + info->mcu_height - 1) / info->mcu_height;
+
+    hdr->fancy = 1;
+    for (c = 0; c < info->components; c++) {
+        info->plane_width[c] = (info->width * hdr->h_samp[c] + max_h - 1) / max_h;
+        info->plane_height[c] = (info->height * hdr->v_samp[c] + max_v - 1) / max_v;
+        info->pad_width[c] = info->mcus_per_row * hdr->h_samp[c] * DCTSIZE;
+        info->pad_height[c] = info->mcu_rows * hdr->v_samp[c] * DCTSIZE;
+        if (hdr->v_samp[c] != max_v)
+            hdr->fancy = 0;
+    }
+    return 0;
+}
+
+int mjd_probe(const uint8_t *jpeg, size_t len, mjd_info_t *info)
+{
+    mjd_header_t hdr;
+
+    if (!info || parse_header(jpeg, len, &hdr) < 0)
+        return -1;
+    *info = hdr.info;
+    return 0;
+}
+
+int mjd_bytes_per_pixel(mjd_output_t out)
+{
+    switch (out) {
+    case MJD_OUT_RGB24:  return 3;
+    case MJD_OUT_BGRX32: return 4;
+    case MJD_OUT_RGB565: return 2;
+    default:             return 1;
+    }
+}
+
+int mjd_decode(mjd_decoder_t *dec, const uint8_t *jpeg, size_t len,
+               mjd_output_t out, const mjd_image_t *dst)
+{
+    mjd_header_t hdr;
+    struct iovec iov;
+
+    if (!dec || !dst || parse_header(jpeg, len, &hdr) < 0)
+        return -1;
+    iov.iov_base = (void *)jpeg;
+    iov.iov_len = len;
+    return decode_iov(dec, &iov, 1, out, dst, hdr.fancy);
+}
+
+//----------------------------------------------
+// 재시작 마커 슬라이스
+//----------------------------------------------
+// RSTn 뒤에서는 DC 예측값이 초기화되므로 재시작 구간 경계에서 잘라도 독립적으로 디코딩된다.
+// 슬라이스 시작은 (1) MCU 행의 시작이고 (2) 구간 번호가 8 의 배수여야 한다.
+// (2) 를 지키면 슬라이스 안의 RSTn 이 RST0 부터 시작하므로 마커 번호를 고칠 필요가 없다.
+typedef struct {
+    struct iovec iov[MJD_IOV_MAX];
+    int cnt;
+    mjd_image_t dst;            // 슬라이스 첫 행으로 옮긴 출력 위치
+    uint8_t sof[MJD_SOF_MAX];   // 높이를 슬라이스 높이로 바꾼 SOF 세그먼트
+} mjd_slice_t;
+
+static int gcd_int(int a, int b)
+{
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void slice_dst(const mjd_header_t *hdr, mjd_output_t out, const mjd_image_t *dst,
+                      int y, mjd_image_t *sdst)
+{
+    int c;
+
+    *sdst = *dst;
+    if (out != MJD_OUT_YUV) {
+        sdst->plane[0] = dst->plane[0] + (size_t)y * dst->stride[0];
+        return;
+    }
+    // y 는 MCU 행 경계이므로 성분별 행 = y * v / max_v
+    for (c = 0; c < hdr->info.components; c++)
+        sdst->plane[c] = dst->plane[c] + (size_t)(y / hdr->max_v * hdr->v_samp[c]) * dst->stride[c];
+}
+
+// 슬라이스 계획. 나눌 수 없으면 0 (호출 측이 한 번에 디코딩)
+static int plan_slices(const uint8_t *jpeg, size_t len, const mjd_header_t *hdr,
+                       mjd_output_t out, const mjd_image_t *dst,
+                       int max_slices, mjd_slice_t *slices)
+{
+    const mjd_info_t *info = &hdr->info;
+    const MJPEG_INFO *mk = &hdr->marker;
+    int mpr = info->mcus_per_row;
+    int ri = info->restart_interval;
+    int starts[MJD_MAX_SLICES];         // 슬라이스가 시작하는 재시작 구간 번호
+    size_t begin[MJD_MAX_SLICES];       // 엔트로피 데이터 시작 위치
+    size_t end[MJD_MAX_SLICES];
+    long total, step, candidates, idx, want;
+    unsigned int sof_len, sof_end;
+    const uint8_t *p, *stop;
+    int n, k;
+
+    if (max_slices < 2 || info->progressive || info->components != 3 || ri <= 0 || info->mcu_rows < 2)
+        return 0;
+    if (jpeg[mk->sos_offset + 4] != 3)                      // 세 성분이 한 스캔에 인터리브된 경우만
+        return 0;
+
+    total = ((long)mpr * info->mcu_rows + ri - 1) / ri;     // 재시작 구간 수
+    step = mpr / gcd_int(ri, mpr);                          // 구간 * ri 가 행 경계가 되는 최소 간격
+    step = step / gcd_int((int)step, 8) * 8;                // lcm(step, 8)
+    candidates = (total - 1) / step;
+    if (candidates < 1)
+        return 0;
+
+    n = max_slices;
+    if (n > MJD_MAX_SLICES)
+        n = MJD_MAX_SLICES;
+    if (n > candidates + 1)
+        n = (int)candidates + 1;
+    starts[0] = 0;
+    for (k = 1; k < n; k++)
+        starts[k] = (int)((long)k * (candidates + 1) / n * step);
+
+    // 엔트로피 데이터에서 RSTn 위치를 센다 (번호가 어긋나면 손상된 프레임이므로 나누지 않음)
+    begin[0] = mk->data_offset;
+    p = jpeg + mk->data_offset;
+    stop = jpeg + len;
+    idx = 0;                            // 지금까지 지난 RST 수
+    want = 1;                           // 다음으로 찾는 슬라이스
+    while (want < n && p + 1 < stop) {
+        const uint8_t *ff = (const uint8_t *)memchr(p, 0xFF, (size_t)(stop - p - 1));
+        uint8_t m;
+
+        if (!ff)
+            break;
+        m = ff[1];
+        if (m >= 0xD0 && m <= 0xD7) {
+            if ((long)(m - 0xD0) != idx % 8)
+                return 0;
+            idx++;
+            if (idx == starts[want]) {
+                end[want - 1] = (size_t)(ff - jpeg);
+                begin[want] = (size_t)(ff + 2 - jpeg);
+                want++;
+            }
+            p = ff + 2;
+        } else if (m == 0xFF) {
+            p = ff + 1;                 // 채움 바이트
+        } else if (m == 0x00) {
+            p = ff + 2;                 // 바이트 스터핑
+        } else {
+            break;                      // EOI 또는 예상 밖 마커
+        }
+    }
+    if (want < n)
+        return 0;
+    end[n - 1] = len;
+
+    sof_len = 2 + (((unsigned int)jpeg[mk->sof_offset + 2] << 8) | jpeg[mk->sof_offset + 3]);
+    sof_end = mk->sof_offset + sof_len;
+    if (sof_len > MJD_SOF_MAX || sof_end > mk->data_offset)
+        return 0;
+
+    for (k = 0; k < n; k++) {
+        mjd_slice_t *s = &slices[k];
+        int y = (int)((long)starts[k] * ri / mpr) * info->mcu_height;
+        int y_end = k + 1 < n ? (int)((long)starts[k + 1] * ri / mpr) * info->mcu_height : info->height;
+        int h = y_end - y;
+
+        memcpy(s->sof, jpeg + mk->sof_offset, sof_len);
+        s->sof[5] = (uint8_t)(h >> 8);
+        s->sof[6] = (uint8_t)h;
+
+        s->iov[0].iov_base = (void *)jpeg;
+        s->iov[0].iov_len = mk->sof_offset;
+        s->iov[1].iov_base = s->sof;
+        s->iov[1].iov_len = sof_len;
+        s->iov[2].iov_base = (void *)(jpeg + sof_end);
+        s->iov[2].iov_len = mk->data_offset - sof_end;
+        s->iov[3].iov_base = (void *)(jpeg + begin[k]);
+        s->iov[3].iov_len = end[k] - begin[k];
+        s->iov[4].iov_base = (void *)mjd_eoi;
+        s->iov[4].iov_len = sizeof(mjd_eoi);
+        s->cnt = k + 1 < n ? 5 : 4;     // 마지막 슬라이스는 원래 EOI 까지 포함
+        slice_dst(hdr, out, dst, y, &s->dst);
+    }
+    return n;
+}
+
+//----------------------------------------------
+// 워커 풀
+//----------------------------------------------
+typedef struct {
+    const uint8_t *jpeg;
+    size_t len;
+    mjd_output_t out;
+    mjd_image_t dst;
+    mjd_done_fn done;
+    void *user;
+} mjd_job_t;
+
+struct mjd_pool {
+    pthread_t threads[MJD_MAX_WORKERS];
+    mjd_decoder_t *decoders[MJD_MAX_WORKERS + 1];  // [workers] 는 호출 스레드용
+    int workers;
+    int started;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;       // 새 작업 / 종료
+    pthread_cond_t done_cond;       // 슬라이스 완료 / 큐 비움
+    int stop;
+
+    // 프레임 단위 작업 (원형 큐)
+    mjd_job_t *queue;
+    int queue_depth;
+    int head;
+    int count;
+    int active;
+
+    // mjd_pool_decode 한 건의 슬라이스 (프레임 작업보다 먼저 처리)
+    mjd_slice_t slices[MJD_MAX_SLICES];
+    mjd_output_t slice_out;
+    int slice_fancy;
+    int slice_count;
+    int slice_next;
+    int slice_pending;
+    int slice_errors;
+
+    mjd_pool_stats_t stats;
+};
+
+static int run_slice(mjd_pool_t *pool, mjd_decoder_t *dec, int k)
+{
+    mjd_slice_t *s = &pool->slices[k];
+    return decode_iov(dec, s->iov, s->cnt, pool->slice_out, &s->dst, pool->slice_fancy);
+}
+
+static int run_job(mjd_decoder_t *dec, const mjd_job_t *job)
+{
+    return mjd_decode(dec, job->jpeg, job->len, job->out, &job->dst);
+}
+
+// lock 을 잡은 상태로 호출. 남은 슬라이스를 하나 처리했으면 1
+static int take_slice(mjd_pool_t *pool, mjd_decoder_t *dec)
+{
+    int k, rc;
+
+    if (pool->slice_next >= pool->slice_count)
+        return 0;
+    k = pool->slice_next++;
+    pthread_mutex_unlock(&pool->lock);
+    rc = run_slice(pool, dec, k);
+    pthread_mutex_lock(&pool->lock);
+
+    pool->stats.warnings += (uint64_t)dec->last_warnings;
+    if (rc < 0)
+        pool->slice_errors++;
+    if (--pool->slice_pending == 0)
+        pthread_cond_broadcast(&pool->done_cond);
+    return 1;
+}
+
+static void *worker_main(void *arg)
+{
+    mjd_pool_t *pool = (mjd_pool_t *)arg;
+    mjd_decoder_t *dec;
+    int id;
+
+    pthread_mutex_lock(&pool->lock);
+    id = pool->started++;
+    dec = pool->decoders[id];
+
+    for (;;) {
+        mjd_job_t job;
+        int rc;
+
+        if (take_slice(pool, dec))
+            continue;
+        if (pool->count > 0) {
+            job = pool->queue[pool->head];
+            pool->head = (pool->head + 1) % pool->queue_depth;
+            pool->count--;
+            pool->active++;
+            pthread_mutex_unlock(&pool->lock);
+
+            rc = run_job(dec, &job);
+            if (job.done)
+                job.done(job.user, rc);
+
+            pthread_mutex_lock(&pool->lock);
+            pool->active--;
+            pool->stats.warnings += (uint64_t)dec->last_warnings;
+            if (rc < 0)
+                pool->stats.errors++;
+            else
+                pool->stats.frames++;
+            if (pool->count == 0 && pool->active == 0)
+                pthread_cond_broadcast(&pool->done_cond);
+            continue;
+        }
+        if (pool->stop)
+            break;
+        pthread_cond_wait(&pool->work_cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static void pool_free(mjd_pool_t *pool)
+{
+    int i;
+
+    for (i = 0; i <= MJD_MAX_WORKERS; i++)
+        mjd_decoder_destroy(pool->decoders[i]);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->queue);
+    free(pool);
+}
+
+mjd_pool_t *mjd_pool_create(int workers, int queue_depth)
+{
+    mjd_pool_t *pool;
+    int i;
+
+    if (workers < 0)
+        workers = 0;
+    if (workers > MJD_MAX_WORKERS)
+        workers = MJD_MAX_WORKERS;
+    if (queue_depth < 1)
+        queue_depth = 1;
+
+    pool = (mjd_pool_t *)calloc(1, sizeof(*pool));
+    if (!pool)
+        return NULL;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+    pool->queue_depth = queue_depth;
+    pool->queue = (mjd_job_t *)calloc((size_t)queue_depth, sizeof(mjd_job_t));
+    if (!pool->queue) {
+        pool_free(pool);
+        return NULL;
+    }
+    for (i = 0; i <= workers; i++) {
+        pool->decoders[i] = mjd_decoder_create();
+        if (!pool->decoders[i]) {
+            pool_free(pool);
+            return NULL;
+        }
+    }
+
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0)
+            break;
+    }
+    pool->workers = i;
+    if (i < workers)
+        printf("mjpeg_decode: 워커 %d/%d 개만 시작됨\n", i, workers);
+    return pool;
+}
+
+void mjd_pool_destroy(mjd_pool_t *pool)
+{
+    int i;
+
+    if (!pool)
+        return;
+    mjd_pool_flush(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->workers; i++)
+        pthread_join(pool->threads[i], NULL);
+    pool_free(pool);
+}
+
+int mjd_pool_workers(const mjd_pool_t *pool)
+{
+    return pool ? pool->workers : 0;
+}
+
+int mjd_pool_decode(mjd_pool_t *pool, const uint8_t *jpeg, size_t len,
+                    mjd_output_t out, const mjd_image_t *dst)
+{
+    mjd_decoder_t *dec;
+    mjd_header_t hdr;
+    int n, rc;
+
+    if (!pool || !dst || parse_header(jpeg, len, &hdr) < 0) {
+        if (pool) {
+            pthread_mutex_lock(&pool->lock);
+            pool->stats.errors++;
+            pthread_mutex_unlock(&pool->lock);
+        }
+        return -1;
+    }
+    dec = pool->decoders[pool->workers];
+
+    // slice_count 가 0 인 동안 워커는 slices 를 보지 않으므로 계획은 lock 밖에서 세운다
+    n = plan_slices(jpeg, len, &hdr, out, dst, pool->workers + 1, pool->slices);
+    if (n < 2) {
+        struct iovec iov;
+
+        iov.iov_base = (void *)jpeg;
+        iov.iov_len = len;
+        rc = decode_iov(dec, &iov, 1, out, dst, hdr.fancy);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->stats.warnings += (uint64_t)dec->last_warnings;
+        if (rc < 0)
+            pool->stats.errors++;
+        else
+            pool->stats.frames++;
+        pthread_mutex_unlock(&pool->lock);
+        return rc;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->slice_out = out;
+    pool->slice_fancy = hdr.fancy;
+    pool->slice_count = n;
+    pool->slice_next = 0;
+    pool->slice_pending = n;
+    pool->slice_errors = 0;
+    pthread_cond_broadcast(&pool->work_cond);
+
+    // 호출 스레드도 슬라이스를 가져다 처리한 뒤 나머지를 기다린다
+    while (take_slice(pool, dec))
+        ;
+    while (pool->slice_pending > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+
+    rc = pool->slice_errors ? -1 : 0;
+    pool->slice_count = 0;
+    pool->slice_next = 0;
+    if (rc < 0) {
+        pool->stats.errors++;
+    } else {
+        pool->stats.frames++;
+        pool->stats.sliced_frames++;
+        pool->stats.slices += (uint64_t)n;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return rc;
+}
+
+int mjd_pool_submit(mjd_pool_t *pool, const uint8_t *jpeg, size_t len,
+                    mjd_output_t out, const mjd_image_t *dst,
+                    mjd_done_fn done, void *user)
+{
+    mjd_job_t *job;
+
+    if (!pool || !dst)
+        return -1;
+
+    // 워커가 없으면 호출 스레드에서 바로 디코딩
+    if (pool->workers == 0) {
+        mjd_decoder_t *dec = pool->decoders[0];
+        int rc = mjd_decode(dec, jpeg, len, out, dst);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->stats.warnings += (uint64_t)dec->last_warnings;
+        if (rc < 0)
+            pool->stats.errors++;
+        else
+            pool->stats.frames++;
+        pthread_mutex_unlock(&pool->lock);
+        if (done)
+            done(user, rc);
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->count >= pool->queue_depth) {
+        pool->stats.queue_drops++;
+        pthread_mutex_unlock(&pool->lock);
+        return -1;
+    }
+    job = &pool->queue[(pool->head + pool->count) % pool->queue_depth];
+    job->jpeg = jpeg;
+    job->len = len;
+    job->out = out;
+    job->dst = *dst;
+    job->done = done;
+    job->user = user;
+    pool->count++;
+    pthread_cond_signal(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+void mjd_pool_flush(mjd_pool_t *pool)
+{
+    if (!pool)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->count > 0 || pool->active > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void mjd_pool_get_stats(mjd_pool_t *pool, mjd_pool_stats_t *stats)
+{
+    if (!pool || !stats)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    *stats = pool->stats;
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,127 @@
+#ifndef MJPEG_DECODE_H
+#define MJPEG_DECODE_H
+
+// MJPEG 디코드 단계 (libjpeg-turbo)
+// - 디코더마다 jpeg_decompress_struct 를 하나 만들어 프레임마다 재사용한다
+// - DHT 없는 UVC 프레임은 libjpeg-turbo 가 표준 Huffman 테이블로 채운다 (DHT 삽입 복사 없음)
+// - 입력은 iovec 소스 매니저로 읽으므로 슬라이스 헤더를 만들 때도 페이로드를 복사하지 않는다
+// - 워커 풀:
+//   mjd_pool_decode : 재시작 마커(DRI/RSTn)가 있으면 MCU 행 경계에서 프레임을 슬라이스로 나눠
+//                     워커와 호출 스레드가 나눠 디코딩한다 (한 프레임 지연 단축, 화면 출력용)
+//   mjd_pool_submit : 프레임 단위 비동기 디코딩 (여러 프레임을 코어마다 동시에, 분석/녹화용)
+// - MJD_OUT_YUV 는 색변환/업샘플링 없이 JPEG 원본 샘플링 그대로 Y/Cb/Cr 평면을 내준다
+//
+// 슬라이스 디코딩 결과는 한 번에 디코딩한 결과와 비트 단위로 같다.
+// (4:2:0 은 세로 업샘플링이 슬라이스 경계를 넘으므로 RGB 출력에서 fancy upsampling 을 끈다)
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MJD_MAX_WORKERS     16
+
+// 출력 포맷
+typedef enum {
+    MJD_OUT_YUV = 0,        // Y/Cb/Cr 평면 (JPEG 샘플링 그대로, 흑백은 Y 만)
+    MJD_OUT_RGB24,          // R, G, B
+    MJD_OUT_BGRX32,         // B, G, R, 0xFF (XImage 24/32bpp)
+    MJD_OUT_RGB565          // 리틀엔디안 16비트 R5 G6 B5
+} mjd_output_t;
+
+// 프레임 헤더 정보 (mjd_probe)
+typedef struct {
+    int width;
+    int height;
+    int components;
+    int progressive;            // baseline(SOF0/SOF1) 이 아님: SOF2 등 (슬라이스 불가)
+    int restart_interval;       // DRI (MCU 단위, 없으면 0)
+    int mcu_width;              // 픽셀
+    int mcu_height;
+    int mcus_per_row;
+    int mcu_rows;
+    // MJD_OUT_YUV 평면 크기. pad_* 는 디코더가 실제로 쓰는 범위(블록/MCU 단위 올림)이며
+    // 버퍼는 stride >= pad_width, 행 수 >= pad_height 로 잡아야 한다
+    int plane_width[3];
+    int plane_height[3];
+    int pad_width[3];
+    int pad_height[3];
+} mjd_info_t;
+
+// 출력 버퍼. RGB 계열은 plane[0]/stride[0] 만 사용
+typedef struct {
+    uint8_t *plane[3];
+    int stride[3];              // 바이트 단위
+} mjd_image_t;
+
+// 헤더(SOI~SOS)만 읽어 정보를 채운다. 성공 0, JPEG 가 아니면 -1
+int mjd_probe(const uint8_t *jpeg, size_t len, mjd_info_t *info);
+
+// 출력 포맷의 픽셀당 바이트 수 (YUV 는 1)
+int mjd_bytes_per_pixel(mjd_output_t out);
+
+//----------------------------------------------
+// 단일 디코더 (한 스레드 전용)
+//----------------------------------------------
+typedef struct mjd_decoder mjd_decoder_t;
+
+mjd_decoder_t *mjd_decoder_create(void);
+void mjd_decoder_destroy(mjd_decoder_t *dec);
+
+// 프레임 전체를 dst 에 디코딩한다. 성공 0, 실패 -1
+// 잘린 프레임처럼 libjpeg 가 경고만 내고 끝까지 디코딩한 경우도 0 (warnings 에 누적)
+int mjd_decode(mjd_decoder_t *dec, const uint8_t *jpeg, size_t len,
+               mjd_output_t out, const mjd_image_t *dst);
+
+// 누적 경고 수 (손상된 엔트로피 데이터 등)
+unsigned long mjd_decoder_warnings(const mjd_decoder_t *dec);
+
+//----------------------------------------------
+// 디코더 풀
+//----------------------------------------------
+typedef struct mjd_pool mjd_pool_t;
+
+// 프레임 단위 비동기 디코딩 완료 콜백 (워커 스레드에서 호출, status 0 성공 / -1 실패)
+typedef void (*mjd_done_fn)(void *user, int status);
+
+typedef struct {
+    uint64_t frames;            // 디코딩 완료 프레임 (동기 + 비동기)
+    uint64_t sliced_frames;     // 슬라이스로 나눠 디코딩한 프레임
+    uint64_t slices;            // 디코딩한 슬라이스 수 (sliced_frames 기준)
+    uint64_t errors;
+    uint64_t queue_drops;       // 큐가 가득 차서 mjd_pool_submit 이 거절한 프레임
+    uint64_t warnings;
+} mjd_pool_stats_t;
+
+// workers 개의 디코딩 스레드를 만든다 (0 이면 모든 디코딩을 호출 스레드에서 수행)
+// queue_depth: mjd_pool_submit 으로 대기할 수 있는 최대 프레임 수
+mjd_pool_t *mjd_pool_create(int workers, int queue_depth);
+
+// 대기 중인 작업을 모두 끝낸 뒤 스레드를 정리한다
+void mjd_pool_destroy(mjd_pool_t *pool);
+
+int mjd_pool_workers(const mjd_pool_t *pool);
+
+// 동기 디코딩. 재시작 마커가 MCU 행 경계에 맞으면 최대 (workers + 1) 슬라이스로 나눈다
+// 한 번에 한 스레드에서만 호출한다 (pm_frame 과 같은 규칙). 성공 0, 실패 -1
+int mjd_pool_decode(mjd_pool_t *pool, const uint8_t *jpeg, size_t len,
+                    mjd_output_t out, const mjd_image_t *dst);
+
+// 비동기 프레임 디코딩. jpeg/dst 는 done 이 불릴 때까지 유지되어야 한다
+// 큐가 가득 차면 -1 (queue_drops 증가, done 은 불리지 않음)
+int mjd_pool_submit(mjd_pool_t *pool, const uint8_t *jpeg, size_t len,
+                    mjd_output_t out, const mjd_image_t *dst,
+                    mjd_done_fn done, void *user);
+
+// 제출한 비동기 작업이 모두 끝날 때까지 대기
+void mjd_pool_flush(mjd_pool_t *pool);
+
+void mjd_pool_get_stats(mjd_pool_t *pool, mjd_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MJPEG_DECODE_H
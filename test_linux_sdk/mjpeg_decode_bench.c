@@ -0,0 +1,452 @@
+//----------------------------------------------//
+//	MJPEG 디코드 풀 벤치마크 / 비트 일치 검증		//
+//----------------------------------------------//
+// 사용법: ./mjpeg_decode_bench [iterations]
+// libjpeg 로 합성 프레임을 인코딩한 뒤 UVC 처럼 DHT 를 떼어 내고,
+// 단일 디코더 / 재시작 마커 슬라이스 / 비동기 프레임 풀 결과가
+// DHT 가 있는 원본을 표준 libjpeg 경로로 디코딩한 결과와 비트 단위로 같은지 확인한 다음
+// 1080p 프레임의 디코딩 속도를 출력한다. 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <jpeglib.h>
+#include "mjpeg_decode.h"
+#include "sdk_deps/OSD-Linux_H264_AP_0724/mjpeg_dht.h"
+
+#define CHECK_WORKERS   3
+#define ASYNC_FRAMES    8
+
+typedef struct {
+    const char *name;
+    int width;
+    int height;
+    int h_samp;             // Y 샘플링 (Cb/Cr 는 1x1)
+    int v_samp;
+    int restart;            // DRI (MCU 단위, 0 이면 -1 → MCU 한 행)
+    int expect_slices;      // CHECK_WORKERS 풀에서 슬라이스로 나뉘어야 하는지
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    { "422-nodri",  1920, 1080, 2, 1,  0, 0 },
+    { "422-row",    1920, 1080, 2, 1, -1, 1 },
+    { "420-row",    1920, 1080, 2, 2, -1, 1 },  // 마지막 MCU 행이 반만 찬다
+    { "422-ri3",    1920, 1080, 2, 1,  3, 1 },
+    { "444-ri7",     640,  480, 1, 1,  7, 1 },
+    { "422-small",   640,  360, 2, 1, 40, 1 },
+    { "420-tiny",     48,   32, 2, 2,  1, 0 },  // 행 경계 + 8 의 배수 조건을 만족하는 후보가 없음
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// 재현 가능한 합성 영상 (그라디언트 + 잡음 + 경계가 뚜렷한 사각형)
+static unsigned char *make_image(int w, int h)
+{
+    unsigned char *rgb = (unsigned char *)malloc((size_t)w * h * 3);
+    unsigned int seed = 12345;
+    int x, y;
+
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            unsigned char *p = rgb + ((size_t)y * w + x) * 3;
+            int box = ((x / 37) ^ (y / 29)) & 1;
+            seed = seed * 1103515245u + 12345u;
+            p[0] = (unsigned char)(x * 255 / w);
+            p[1] = (unsigned char)(box ? 230 : (y * 255 / h));
+            p[2] = (unsigned char)(((x + y) & 0x3F) * 4 + ((seed >> 16) & 0x0F));
+        }
+    }
+    return rgb;
+}
+
+static int encode(const bench_case_t *c, const unsigned char *rgb, unsigned char **out, unsigned long *out_len)
+{
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    JSAMPROW row;
+
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    *out = NULL;
+    *out_len = 0;
+    jpeg_mem_dest(&cinfo, out, out_len);
+
+    cinfo.image_width = (JDIMENSION)c->width;
+    cinfo.image_height = (JDIMENSION)c->height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 80, TRUE);
+    cinfo.optimize_coding = FALSE;      // UVC 카메라와 같이 표준 Huffman 테이블
+    cinfo.comp_info[0].h_samp_factor = c->h_samp;
+    cinfo.comp_info[0].v_samp_factor = c->v_samp;
+    if (c->restart < 0)
+        cinfo.restart_in_rows = 1;
+    else
+        cinfo.restart_interval = (unsigned int)c->restart;
+
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        row = (JSAMPROW)(rgb + (size_t)cinfo.next_scanline * c->width * 3);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return 0;
+}
+
+// SOS 앞의 DHT 세그먼트를 모두 제거한다 (UVC MJPEG 프레임 흉내)
+static unsigned long strip_dht(const unsigned char *src, unsigned long len, unsigned char *dst)
+{
+    unsigned long pos = 2, out = 2;
+
+    memcpy(dst, src, 2);
+    while (pos + 4 <= len) {
+        unsigned int m = src[pos + 1];
+        unsigned long seg = 2 + (((unsigned long)src[pos + 2] << 8) | src[pos + 3]);
+
+        if (m == 0xDA)
+            break;
+        if (m != 0xC4) {
+            memcpy(dst + out, src + pos, seg);
+            out += seg;
+        }
+        pos += seg;
+    }
+    memcpy(dst + out, src + pos, len - pos);
+    return out + (len - pos);
+}
+
+// 표준 libjpeg 경로 (jpeg_mem_src + jpeg_read_scanlines) 로 디코딩한 비교 기준
+static int reference_decode(const unsigned char *jpeg, unsigned long len, J_COLOR_SPACE cs, int fancy,
+                            unsigned char *dst, int stride)
+{
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg, len);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = cs;
+    cinfo.dct_method = JDCT_ISLOW;
+    cinfo.dither_mode = JDITHER_NONE;
+    cinfo.do_fancy_upsampling = fancy ? TRUE : FALSE;
+    jpeg_start_decompress(&cinfo);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = dst + (size_t)cinfo.output_scanline * stride;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return 0;
+}
+
+typedef struct {
+    uint8_t *buf;
+    mjd_image_t img;
+    size_t size;
+} frame_buf_t;
+
+static void alloc_image(const mjd_info_t *info, mjd_output_t out, frame_buf_t *fb)
+{
+    size_t off[3];
+    int c;
+
+    memset(fb, 0, sizeof(*fb));
+    if (out != MJD_OUT_YUV) {
+        fb->img.stride[0] = info->width * mjd_bytes_per_pixel(out);
+        fb->size = (size_t)fb->img.stride[0] * info->height;
+        fb->buf = (uint8_t *)calloc(1, fb->size);
+        fb->img.plane[0] = fb->buf;
+        return;
+    }
+    for (c = 0; c < info->components; c++) {
+        off[c] = fb->size;
+        fb->img.stride[c] = info->pad_width[c];
+        fb->size += (size_t)info->pad_width[c] * info->pad_height[c];
+    }
+    fb->buf = (uint8_t *)calloc(1, fb->size);
+    for (c = 0; c < info->components; c++)
+        fb->img.plane[c] = fb->buf + off[c];
+}
+
+// 보이는 영역만 비교 (YUV 패딩은 제외)
+static int same_image(const mjd_info_t *info, mjd_output_t out, const frame_buf_t *a, const frame_buf_t *b)
+{
+    int c, y;
+
+    if (out != MJD_OUT_YUV)
+        return memcmp(a->buf, b->buf, a->size) == 0;
+    for (c = 0; c < info->components; c++)
+        for (y = 0; y < info->plane_height[c]; y++)
+            if (memcmp(a->img.plane[c] + (size_t)y * a->img.stride[c],
+                       b->img.plane[c] + (size_t)y * b->img.stride[c], info->plane_width[c]) != 0)
+                return 0;
+    return 1;
+}
+
+static int async_done_count;
+static int async_fail_count;
+
+static void async_done(void *user, int status)
+{
+    (void)user;
+    __atomic_fetch_add(status == 0 ? &async_done_count : &async_fail_count, 1, __ATOMIC_RELAXED);
+}
+
+static const char *out_names[] = { "yuv", "rgb24", "bgrx32", "rgb565" };
+
+static int check_case(const bench_case_t *c, mjd_decoder_t *dec, mjd_pool_t *pool)
+{
+    unsigned char *rgb = make_image(c->width, c->height);
+    unsigned char *orig = NULL, *uvc;
+    unsigned long orig_len, uvc_len;
+    MJPEG_INFO mk;
+    mjd_info_t info;
+    mjd_pool_stats_t before, after;
+    int fancy = c->v_samp == 1;
+    int failures = 0, o, i;
+
+    encode(c, rgb, &orig, &orig_len);
+    uvc = (unsigned char *)malloc(orig_len);
+    uvc_len = strip_dht(orig, orig_len, uvc);
+    if (MjpegParse(uvc, (unsigned int)uvc_len, &mk) < 0 || mk.has_dht || mjd_probe(uvc, uvc_len, &info) < 0) {
+        printf("  %-10s 합성 프레임 생성 실패\n", c->name);
+        return 1;
+    }
+
+    for (o = MJD_OUT_YUV; o <= MJD_OUT_RGB565; o++) {
+        mjd_output_t out = (mjd_output_t)o;
+        frame_buf_t single, sliced, ref;
+        int ok_single, ok_sliced = 1, ok_ref = 1, split;
+
+        alloc_image(&info, out, &single);
+        alloc_image(&info, out, &sliced);
+        ok_single = mjd_decode(dec, uvc, uvc_len, out, &single.img) == 0;
+
+        mjd_pool_get_stats(pool, &before);
+        if (mjd_pool_decode(pool, uvc, uvc_len, out, &sliced.img) < 0)
+            ok_sliced = 0;
+        mjd_pool_get_stats(pool, &after);
+        split = after.sliced_frames > before.sliced_frames;
+        ok_sliced = ok_sliced && same_image(&info, out, &single, &sliced);
+
+        // RGB 계열은 DHT 가 있는 원본을 표준 경로로 디코딩한 결과와도 비교
+        if (out != MJD_OUT_YUV) {
+            static const J_COLOR_SPACE cs[] = { JCS_UNKNOWN, JCS_RGB, JCS_EXT_BGRX, JCS_RGB565 };
+            alloc_image(&info, out, &ref);
+            reference_decode(orig, orig_len, cs[o], fancy, ref.buf, ref.img.stride[0]);
+            ok_ref = same_image(&info, out, &single, &ref);
+            free(ref.buf);
+        }
+
+        printf("  %-10s %-7s 단일 %s  슬라이스 %s (%s, %llu 조각)  표준 경로 %s\n",
+               c->name, out_names[o], ok_single ? "OK" : "FAIL", ok_sliced ? "OK" : "MISMATCH",
+               split ? "분할" : "분할 안 됨",
+               (unsigned long long)(split ? after.slices - before.slices : 1),
+               out == MJD_OUT_YUV ? "-" : (ok_ref ? "OK" : "MISMATCH"));
+        if (!ok_single || !ok_sliced || !ok_ref || split != c->expect_slices)
+            failures++;
+        free(single.buf);
+        free(sliced.buf);
+    }
+
+    // 비동기 프레임 풀: 같은 프레임을 버퍼 여러 개에 동시에 디코딩
+    {
+        frame_buf_t ref, bufs[ASYNC_FRAMES];
+        int submitted = 0, ok = 1;
+
+        alloc_image(&info, MJD_OUT_BGRX32, &ref);
+        mjd_decode(dec, uvc, uvc_len, MJD_OUT_BGRX32, &ref.img);
+        async_done_count = 0;
+        async_fail_count = 0;
+        for (i = 0; i < ASYNC_FRAMES; i++) {
+            alloc_image(&info, MJD_OUT_BGRX32, &bufs[i]);
+            if (mjd_pool_submit(pool, uvc, uvc_len, MJD_OUT_BGRX32, &bufs[i].img, async_done, NULL) == 0)
+                submitted++;
+        }
+        mjd_pool_flush(pool);
+        for (i = 0; i < ASYNC_FRAMES; i++) {
+            if (!same_image(&info, MJD_OUT_BGRX32, &ref, &bufs[i]))
+                ok = 0;
+            free(bufs[i].buf);
+        }
+        free(ref.buf);
+        ok = ok && submitted == ASYNC_FRAMES && async_done_count == ASYNC_FRAMES && async_fail_count == 0;
+        printf("  %-10s async   %d/%d 프레임 %s\n", c->name, async_done_count, ASYNC_FRAMES, ok ? "OK" : "MISMATCH");
+        if (!ok)
+            failures++;
+    }
+
+    free(rgb);
+    free(orig);
+    free(uvc);
+    return failures;
+}
+
+// 잘못된 입력: 크래시 없이 -1 또는 경고로 끝나야 한다
+static int check_errors(mjd_decoder_t *dec, mjd_pool_t *pool)
+{
+    static const bench_case_t c = { "broken", 320, 240, 2, 1, -1, 1 };
+    unsigned char garbage[256];
+    unsigned char *rgb = make_image(c.width, c.height);
+    unsigned char *jpeg = NULL;
+    unsigned long len;
+    mjd_info_t info;
+    frame_buf_t fb;
+    unsigned long warn0;
+    int failures = 0, rc_trunc, rc_pool, i;
+
+    memset(garbage, 0xA5, sizeof(garbage));
+    encode(&c, rgb, &jpeg, &len);
+    mjd_probe(jpeg, len, &info);
+    alloc_image(&info, MJD_OUT_BGRX32, &fb);
+
+    if (mjd_decode(dec, garbage, sizeof(garbage), MJD_OUT_BGRX32, &fb.img) != -1 ||
+        mjd_pool_decode(pool, garbage, sizeof(garbage), MJD_OUT_BGRX32, &fb.img) != -1) {
+        printf("  garbage    -1 이 아님\n");
+        failures++;
+    }
+    if (mjd_decode(dec, jpeg, 40, MJD_OUT_BGRX32, &fb.img) != -1) {
+        printf("  헤더 잘림  -1 이 아님\n");
+        failures++;
+    }
+
+    // 엔트로피 데이터가 반만 온 프레임: 경고와 함께 끝까지 디코딩
+    warn0 = mjd_decoder_warnings(dec);
+    rc_trunc = mjd_decode(dec, jpeg, len / 2, MJD_OUT_BGRX32, &fb.img);
+    rc_pool = mjd_pool_decode(pool, jpeg, len / 2, MJD_OUT_BGRX32, &fb.img);
+    if (rc_trunc != 0 || mjd_decoder_warnings(dec) == warn0 || rc_pool < -1 || rc_pool > 0) {
+        printf("  데이터 잘림 rc=%d pool=%d\n", rc_trunc, rc_pool);
+        failures++;
+    }
+
+    // RST 번호가 어긋난 프레임은 나누지 않고 libjpeg 의 재동기화에 맡긴다
+    for (i = (int)len - 3; i > 0; i--) {
+        if (jpeg[i] == 0xFF && jpeg[i + 1] >= 0xD0 && jpeg[i + 1] <= 0xD7) {
+            jpeg[i + 1] = (unsigned char)(0xD0 + ((jpeg[i + 1] - 0xD0 + 3) & 7));
+            break;
+        }
+    }
+    if (mjd_pool_decode(pool, jpeg, len, MJD_OUT_BGRX32, &fb.img) < -1) {
+        printf("  RST 손상  실패\n");
+        failures++;
+    }
+    printf("  잘못된 입력 처리 %s (누적 경고 %lu)\n", failures ? "FAIL" : "OK", mjd_decoder_warnings(dec));
+
+    free(fb.buf);
+    free(rgb);
+    free(jpeg);
+    return failures;
+}
+
+typedef struct {
+    double ms_per_frame;
+    double fps;
+} bench_result_t;
+
+static void bench_speed(int iterations)
+{
+    static const bench_case_t c = { "1080p", 1920, 1080, 2, 1, -1, 1 };
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int workers = cores > 1 ? (int)cores - 1 : 0;
+    unsigned char *rgb = make_image(c.width, c.height);
+    unsigned char *orig = NULL, *uvc;
+    unsigned long orig_len, uvc_len;
+    mjd_info_t info;
+    mjd_decoder_t *dec = mjd_decoder_create();
+    mjd_pool_t *sliced = mjd_pool_create(workers, 1);
+    mjd_pool_t *frames = mjd_pool_create(cores > 0 ? (int)cores : 1, ASYNC_FRAMES);
+    frame_buf_t bufs[ASYNC_FRAMES], yuv;
+    double t0, ms;
+    int i, o;
+
+    encode(&c, rgb, &orig, &orig_len);
+    uvc = (unsigned char *)malloc(orig_len);
+    uvc_len = strip_dht(orig, orig_len, uvc);
+    mjd_probe(uvc, uvc_len, &info);
+    for (i = 0; i < ASYNC_FRAMES; i++)
+        alloc_image(&info, MJD_OUT_BGRX32, &bufs[i]);
+    alloc_image(&info, MJD_OUT_YUV, &yuv);
+
+    printf("\n1920x1080 4:2:2 MJPEG (%lu bytes, RST 매 MCU 행), CPU %ld 개\n", uvc_len, cores);
+    printf("%-32s %10s %8s\n", "경로", "ms/frame", "fps");
+
+    for (o = 0; o < 2; o++) {
+        mjd_output_t out = o ? MJD_OUT_YUV : MJD_OUT_BGRX32;
+        const mjd_image_t *img = o ? &yuv.img : &bufs[0].img;
+
+        mjd_decode(dec, uvc, uvc_len, out, img);
+        t0 = now_ms();
+        for (i = 0; i < iterations; i++)
+            mjd_decode(dec, uvc, uvc_len, out, img);
+        ms = (now_ms() - t0) / iterations;
+        printf("%-32s %10.3f %8.1f\n", o ? "단일 디코더 (YUV 평면)" : "단일 디코더 (BGRX32)", ms, 1000.0 / ms);
+    }
+
+    t0 = now_ms();
+    for (i = 0; i < iterations; i++)
+        mjd_pool_decode(sliced, uvc, uvc_len, MJD_OUT_BGRX32, &bufs[0].img);
+    ms = (now_ms() - t0) / iterations;
+    printf("슬라이스 (워커 %d + 호출 스레드)   %10.3f %8.1f\n", workers, ms, 1000.0 / ms);
+
+    async_done_count = 0;
+    t0 = now_ms();
+    for (i = 0; i < iterations; i++) {
+        while (mjd_pool_submit(frames, uvc, uvc_len, MJD_OUT_BGRX32, &bufs[i % ASYNC_FRAMES].img,
+                               async_done, NULL) < 0)
+            usleep(200);
+    }
+    mjd_pool_flush(frames);
+    ms = (now_ms() - t0) / iterations;
+    printf("프레임 풀 (워커 %d, 비동기)        %10.3f %8.1f\n", mjd_pool_workers(frames), ms, 1000.0 / ms);
+
+    mjd_pool_destroy(sliced);
+    mjd_pool_destroy(frames);
+    mjd_decoder_destroy(dec);
+    for (i = 0; i < ASYNC_FRAMES; i++)
+        free(bufs[i].buf);
+    free(yuv.buf);
+    free(rgb);
+    free(orig);
+    free(uvc);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 30;
+    mjd_decoder_t *dec = mjd_decoder_create();
+    mjd_pool_t *pool = mjd_pool_create(CHECK_WORKERS, ASYNC_FRAMES);
+    int failures = 0;
+    size_t i;
+
+    if (!dec || !pool) {
+        printf("디코더 생성 실패\n");
+        return 1;
+    }
+    if (iterations <= 0)
+        iterations = 30;
+
+    printf("비트 일치 검증 (DHT 제거 프레임, 워커 %d)\n", mjd_pool_workers(pool));
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        failures += check_case(&cases[i], dec, pool);
+    failures += check_errors(dec, pool);
+
+    mjd_pool_destroy(pool);
+    mjd_decoder_destroy(dec);
+    if (failures) {
+        printf("\n불일치 %d 건\n", failures);
+        return 1;
+    }
+
+    bench_speed(iterations);
+    return 0;
+}
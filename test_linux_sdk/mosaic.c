@@ -0,0 +1,414 @@
+//----------------------------------------------//
+//	multi-camera mosaic: YUYV downscale			//
+//----------------------------------------------//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mosaic.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MOS_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MOS_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 2:1 한 행: r0/r1 의 (2 * out_width) 픽셀 → dst 의 out_width 픽셀 (짝수)
+// dst 는 r0 과 같은 버퍼여도 된다 (읽은 위치보다 앞에만 쓴다)
+typedef void (*mos_half_fn)(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int out_width);
+
+struct mos_scaler {
+    int src_w;
+    int src_h;
+    int dst_w;
+    int dst_h;
+    int levels;
+    int lw;                     // 2:1 단계 뒤 크기
+    int lh;
+    uint8_t *scratch;           // 첫 단계 결과 크기, 이후 단계는 제자리
+    int scratch_stride;
+    int *xmap;                  // 출력 매크로픽셀마다 (Y0, Y1, U) 바이트 오프셋
+    int *ymap;                  // 출력 행마다 입력 행
+};
+
+static inline uint8_t mos_avg(uint8_t a, uint8_t b)
+{
+    return (uint8_t)((a + b + 1) >> 1);
+}
+
+//------------------------------------------------------------------------------
+// 스칼라
+//------------------------------------------------------------------------------
+
+static void mos_half_scalar(const uint8_t *r0, const uint8_t *r1, uint8_t *d, int out_width)
+{
+    int m, i;
+
+    // 출력 매크로픽셀 m ← 입력 매크로픽셀 2m, 2m+1 (Y0 U Y1 V | Y0 U Y1 V)
+    for (m = 0; m < out_width / 2; m++) {
+        uint8_t v[8];
+        for (i = 0; i < 8; i++)
+            v[i] = mos_avg(r0[m * 8 + i], r1[m * 8 + i]);
+        d[m * 4 + 0] = mos_avg(v[0], v[2]);
+        d[m * 4 + 1] = mos_avg(v[1], v[5]);
+        d[m * 4 + 2] = mos_avg(v[4], v[6]);
+        d[m * 4 + 3] = mos_avg(v[3], v[7]);
+    }
+}
+
+#ifdef MOS_HAVE_X86
+//------------------------------------------------------------------------------
+// SSE2: 출력 4 매크로픽셀 / 반복
+//------------------------------------------------------------------------------
+
+// 세로 평균이 끝난 입력 8 매크로픽셀 (a, b) → 출력 4 매크로픽셀
+__attribute__((target("sse2")))
+static inline __m128i mos_sse2_half(__m128i a, __m128i b)
+{
+    const __m128i lo8 = _mm_set1_epi16(0x00FF);
+    const __m128i lo16 = _mm_set1_epi32(0x0000FFFF);
+
+    // Y 16 개 → 인접한 두 Y 평균 8 개 (16비트 레인 = 출력 Y 순서)
+    __m128i y8 = _mm_packus_epi16(_mm_and_si128(a, lo8), _mm_and_si128(b, lo8));
+    __m128i y = _mm_avg_epu16(_mm_and_si128(y8, lo8), _mm_srli_epi16(y8, 8));
+    // (U V) 8 쌍 → 32비트 레인마다 이웃한 두 쌍 평균, 하위 2 바이트에 (U' V')
+    __m128i c8 = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+    __m128i c = _mm_avg_epu8(_mm_and_si128(c8, lo16), _mm_srli_epi32(c8, 16));
+    __m128i u = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000FF)), 8);
+    __m128i v = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000FF00)), 16);
+
+    return _mm_or_si128(y, _mm_or_si128(u, v));
+}
+
+__attribute__((target("sse2")))
+static void mos_half_sse2(const uint8_t *r0, const uint8_t *r1, uint8_t *d, int out_width)
+{
+    int mp = out_width / 2;
+    int m = 0;
+
+    for (; m + 4 <= mp; m += 4) {
+        __m128i a = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(r0 + m * 8)),
+                                 _mm_loadu_si128((const __m128i *)(r1 + m * 8)));
+        __m128i b = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(r0 + m * 8 + 16)),
+                                 _mm_loadu_si128((const __m128i *)(r1 + m * 8 + 16)));
+        _mm_storeu_si128((__m128i *)(d + m * 4), mos_sse2_half(a, b));
+    }
+    if (m < mp)
+        mos_half_scalar(r0 + m * 8, r1 + m * 8, d + m * 4, (mp - m) * 2);
+}
+
+//------------------------------------------------------------------------------
+// AVX2: 출력 8 매크로픽셀 / 반복
+//------------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static void mos_half_avx2(const uint8_t *r0, const uint8_t *r1, uint8_t *d, int out_width)
+{
+    const __m256i lo8 = _mm256_set1_epi16(0x00FF);
+    const __m256i lo16 = _mm256_set1_epi32(0x0000FFFF);
+    const __m256i ub = _mm256_set1_epi32(0x000000FF);
+    const __m256i vb = _mm256_set1_epi32(0x0000FF00);
+    int mp = out_width / 2;
+    int m = 0;
+
+    for (; m + 8 <= mp; m += 8) {
+        __m256i x0 = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i *)(r0 + m * 8)),
+                                     _mm256_loadu_si256((const __m256i *)(r1 + m * 8)));
+        __m256i x1 = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i *)(r0 + m * 8 + 32)),
+                                     _mm256_loadu_si256((const __m256i *)(r1 + m * 8 + 32)));
+        // pack 은 128비트 레인 안에서만 동작하므로 레인마다 연속된 32 바이트가 오도록 재배치
+        __m256i a = _mm256_permute2x128_si256(x0, x1, 0x20);
+        __m256i b = _mm256_permute2x128_si256(x0, x1, 0x31);
+
+        __m256i y8 = _mm256_packus_epi16(_mm256_and_si256(a, lo8), _mm256_and_si256(b, lo8));
+        __m256i y = _mm256_avg_epu16(_mm256_and_si256(y8, lo8), _mm256_srli_epi16(y8, 8));
+        __m256i c8 = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        __m256i c = _mm256_avg_epu8(_mm256_and_si256(c8, lo16), _mm256_srli_epi32(c8, 16));
+        __m256i u = _mm256_slli_epi32(_mm256_and_si256(c, ub), 8);
+        __m256i v = _mm256_slli_epi32(_mm256_and_si256(c, vb), 16);
+
+        _mm256_storeu_si256((__m256i *)(d + m * 4), _mm256_or_si256(y, _mm256_or_si256(u, v)));
+    }
+    if (m < mp)
+        mos_half_scalar(r0 + m * 8, r1 + m * 8, d + m * 4, (mp - m) * 2);
+}
+#endif
+
+#ifdef MOS_HAVE_NEON
+//------------------------------------------------------------------------------
+// NEON: 출력 8 매크로픽셀 / 반복
+//------------------------------------------------------------------------------
+
+static void mos_half_neon(const uint8_t *r0, const uint8_t *r1, uint8_t *d, int out_width)
+{
+    int mp = out_width / 2;
+    int m = 0;
+
+    for (; m + 8 <= mp; m += 8) {
+        // 입력 16 매크로픽셀을 Y0 / U / Y1 / V 로 분리
+        uint8x16x4_t p = vld4q_u8(r0 + m * 8);
+        uint8x16x4_t q = vld4q_u8(r1 + m * 8);
+        uint8x16_t y = vrhaddq_u8(vrhaddq_u8(p.val[0], q.val[0]), vrhaddq_u8(p.val[2], q.val[2]));
+        uint8x16_t u = vrhaddq_u8(p.val[1], q.val[1]);
+        uint8x16_t v = vrhaddq_u8(p.val[3], q.val[3]);
+        uint8x16x2_t yz = vuzpq_u8(y, y);
+        uint8x16x2_t uz = vuzpq_u8(u, u);
+        uint8x16x2_t vz = vuzpq_u8(v, v);
+        uint8x8x4_t o;
+
+        o.val[0] = vget_low_u8(yz.val[0]);
+        o.val[1] = vrhadd_u8(vget_low_u8(uz.val[0]), vget_low_u8(uz.val[1]));
+        o.val[2] = vget_low_u8(yz.val[1]);
+        o.val[3] = vrhadd_u8(vget_low_u8(vz.val[0]), vget_low_u8(vz.val[1]));
+        vst4_u8(d + m * 4, o);
+    }
+    if (m < mp)
+        mos_half_scalar(r0 + m * 8, r1 + m * 8, d + m * 4, (mp - m) * 2);
+}
+#endif
+
+static mos_half_fn mos_half_function(cc_impl_t impl)
+{
+    switch (impl) {
+#ifdef MOS_HAVE_X86
+    case CC_IMPL_SSE2: return mos_half_sse2;
+    case CC_IMPL_AVX2: return mos_half_avx2;
+#endif
+#ifdef MOS_HAVE_NEON
+    case CC_IMPL_NEON: return mos_half_neon;
+#endif
+    case CC_IMPL_SCALAR: return mos_half_scalar;
+    default: return NULL;
+    }
+}
+
+//------------------------------------------------------------------------------
+// 배치
+//------------------------------------------------------------------------------
+
+int mos_layout(int count, int canvas_w, int canvas_h, mos_rect_t *cell)
+{
+    int cols = 1, rows, cell_w, cell_h, i;
+
+    if (count <= 0 || count > MOS_MAX_TILES || !cell)
+        return -1;
+    while (cols * cols < count)
+        cols++;
+    rows = (count + cols - 1) / cols;
+    cell_w = (canvas_w / cols) & ~1;
+    cell_h = canvas_h / rows;
+    if (cell_w < 2 || cell_h < 1)
+        return -1;
+
+    for (i = 0; i < count; i++) {
+        cell[i].x = (i % cols) * cell_w;
+        cell[i].y = (i / cols) * cell_h;
+        cell[i].width = cell_w;
+        cell[i].height = cell_h;
+    }
+    return cols;
+}
+
+void mos_fit(const mos_rect_t *cell, int src_w, int src_h, mos_rect_t *image)
+{
+    int w = cell->width & ~1;
+    int h = src_w > 0 ? (int)((long long)w * src_h / src_w) : cell->height;
+
+    if (h > cell->height) {
+        h = cell->height;
+        w = (int)((long long)h * src_w / (src_h > 0 ? src_h : 1)) & ~1;
+    }
+    if (w < 2)
+        w = 2;
+    if (h < 1)
+        h = 1;
+    image->x = cell->x + (((cell->width - w) / 2) & ~1);
+    image->y = cell->y + (cell->height - h) / 2;
+    image->width = w;
+    image->height = h;
+}
+
+//------------------------------------------------------------------------------
+// 축소기
+//------------------------------------------------------------------------------
+
+mos_scaler_t *mos_scaler_create(int src_w, int src_h, int dst_w, int dst_h)
+{
+    mos_scaler_t *s;
+    int w, h, j;
+
+    if (src_w < 2 || src_h < 1 || dst_w < 2 || dst_h < 1 || (src_w & 1) || (dst_w & 1))
+        return NULL;
+
+    s = (mos_scaler_t *)calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->src_w = src_w;
+    s->src_h = src_h;
+    s->dst_w = dst_w;
+    s->dst_h = dst_h;
+
+    // 목표의 2배 이상 남아 있는 동안 2:1 (너비는 짝수 유지, 홀수 끝 행/열은 버림)
+    w = src_w;
+    h = src_h;
+    while (((w / 2) & ~1) >= dst_w && h / 2 >= dst_h) {
+        w = (w / 2) & ~1;
+        h /= 2;
+        s->levels++;
+        if (s->levels == 1) {
+            s->scratch_stride = (w * 2 + 31) & ~31;
+            s->scratch = (uint8_t *)malloc((size_t)s->scratch_stride * h);
+            if (!s->scratch) {
+                free(s);
+                return NULL;
+            }
+        }
+    }
+    s->lw = w;
+    s->lh = h;
+
+    // 남은 비율은 픽셀 중심 기준 최근접
+    s->xmap = (int *)malloc(sizeof(int) * 3 * (dst_w / 2));
+    s->ymap = (int *)malloc(sizeof(int) * dst_h);
+    if (!s->xmap || !s->ymap) {
+        mos_scaler_destroy(s);
+        return NULL;
+    }
+    for (j = 0; j < dst_w / 2; j++) {
+        int x0 = (int)(((2LL * (2 * j) + 1) * w) / (2LL * dst_w));
+        int x1 = (int)(((2LL * (2 * j + 1) + 1) * w) / (2LL * dst_w));
+        if (x0 > w - 1) x0 = w - 1;
+        if (x1 > w - 1) x1 = w - 1;
+        s->xmap[3 * j + 0] = x0 * 2;
+        s->xmap[3 * j + 1] = x1 * 2;
+        s->xmap[3 * j + 2] = (x0 / 2) * 4 + 1;
+    }
+    for (j = 0; j < dst_h; j++) {
+        int y = (int)(((2LL * j + 1) * h) / (2LL * dst_h));
+        s->ymap[j] = y > h - 1 ? h - 1 : y;
+    }
+    return s;
+}
+
+void mos_scaler_destroy(mos_scaler_t *s)
+{
+    if (!s)
+        return;
+    free(s->scratch);
+    free(s->xmap);
+    free(s->ymap);
+    free(s);
+}
+
+int mos_scaler_levels(const mos_scaler_t *s)
+{
+    return s ? s->levels : 0;
+}
+
+int mos_scale_yuyv_impl(mos_scaler_t *s, const uint8_t *src, int src_stride,
+                        uint8_t *dst, int dst_stride, cc_impl_t impl)
+{
+    const uint8_t *cur = src;
+    int cur_stride = src_stride;
+    mos_half_fn half;
+    int w = s ? s->src_w : 0, h = s ? s->src_h : 0;
+    int level, x, y;
+
+    if (!s || !src || !dst)
+        return -1;
+    if (impl == CC_IMPL_AUTO)
+        impl = cc_best_impl();
+    if (!cc_impl_supported(impl))
+        return -1;
+    half = mos_half_function(impl);
+    if (!half)
+        return -1;
+
+    for (level = 0; level < s->levels; level++) {
+        int nw = (w / 2) & ~1, nh = h / 2;
+        for (y = 0; y < nh; y++)
+            half(cur + (size_t)(2 * y) * cur_stride, cur + (size_t)(2 * y + 1) * cur_stride,
+                 s->scratch + (size_t)y * s->scratch_stride, nw);
+        cur = s->scratch;
+        cur_stride = s->scratch_stride;
+        w = nw;
+        h = nh;
+    }
+
+    if (w == s->dst_w && h == s->dst_h) {
+        for (y = 0; y < h; y++)
+            memcpy(dst + (size_t)y * dst_stride, cur + (size_t)y * cur_stride, (size_t)w * 2);
+        return 0;
+    }
+
+    for (y = 0; y < s->dst_h; y++) {
+        const uint8_t *row = cur + (size_t)s->ymap[y] * cur_stride;
+        uint8_t *d = dst + (size_t)y * dst_stride;
+        const int *xm = s->xmap;
+        for (x = 0; x < s->dst_w / 2; x++, xm += 3, d += 4) {
+            d[0] = row[xm[0]];
+            d[1] = row[xm[2]];
+            d[2] = row[xm[1]];
+            d[3] = row[xm[2] + 2];
+        }
+    }
+    return 0;
+}
+
+int mos_scale_yuyv(mos_scaler_t *s, const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride)
+{
+    return mos_scale_yuyv_impl(s, src, src_stride, dst, dst_stride, CC_IMPL_AUTO);
+}
+
+//------------------------------------------------------------------------------
+// 평면 → YUYV, 검정 채우기
+//------------------------------------------------------------------------------
+
+void mos_pack_planar(const uint8_t *const plane[3], const int stride[3],
+                     int width, int height, int chroma_w, int chroma_h,
+                     uint8_t *dst, int dst_stride)
+{
+    int gray = !plane[1] || !plane[2] || chroma_w <= 0 || chroma_h <= 0;
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        const uint8_t *py = plane[0] + (size_t)y * stride[0];
+        const uint8_t *pu = NULL, *pv = NULL;
+        uint8_t *d = dst + (size_t)y * dst_stride;
+
+        if (!gray) {
+            int cy = (int)((long long)y * chroma_h / height);
+            pu = plane[1] + (size_t)cy * stride[1];
+            pv = plane[2] + (size_t)cy * stride[2];
+        }
+        for (x = 0; x < width / 2; x++, d += 4) {
+            d[0] = py[2 * x];
+            d[2] = py[2 * x + 1];
+            if (gray) {
+                d[1] = 128;
+                d[3] = 128;
+            } else {
+                // 4:2:2 / 4:2:0 는 cx == x, 4:4:4 는 2x
+                int cx = chroma_w * 2 == width ? x : (int)(2LL * x * chroma_w / width);
+                d[1] = pu[cx];
+                d[3] = pv[cx];
+            }
+        }
+    }
+}
+
+void mos_fill_black_yuyv(uint8_t *dst, int stride, int width, int height)
+{
+    static const uint8_t black[4] = { 0, 128, 0, 128 };
+    int x, y;
+
+    for (y = 0; y < height; y++) {
+        uint8_t *d = dst + (size_t)y * stride;
+        for (x = 0; x < width / 2; x++)
+            memcpy(d + x * 4, black, 4);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef MOSAIC_H
+#define MOSAIC_H
+
+// 멀티 카메라 모자이크용 YUYV 축소 / 배치
+// - 축소는 2:1 박스 평균(세로 2행 평균 → 가로 2픽셀 평균)을 목표 크기의 2배 미만이 될 때까지 반복하고,
+//   남은 비율(1~2배)은 미리 계산한 표로 최근접 샘플링한다. 비율이 정확히 맞으면 마지막 단계는 행 복사
+// - 2:1 단계는 SSE2 / AVX2 / NEON 경로가 있고 스칼라와 비트 단위로 같다 (pavgb 와 같은 (a + b + 1) >> 1 두 번)
+// - 중간 버퍼와 표는 mos_scaler_create 에서 한 번만 할당한다 (프레임마다 malloc 없음)
+// - 출력은 YUYV 그대로라서 모자이크 전체를 한 번에 yuyv_convert 하거나 타일마다 변환할 수 있다
+
+#include <stdint.h>
+#include "color_convert.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOS_MAX_TILES       16
+
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} mos_rect_t;
+
+// count 개 칸을 canvas 에 격자로 배치한다 (열 = ceil(sqrt(count)), x / 너비는 짝수)
+// 성공 시 열 수, 잘못된 인자면 -1
+int mos_layout(int count, int canvas_w, int canvas_h, mos_rect_t *cell);
+
+// 칸 안에서 src_w:src_h 비율을 유지하는 가장 큰 영상 위치 (가운데, x / 너비는 짝수)
+void mos_fit(const mos_rect_t *cell, int src_w, int src_h, mos_rect_t *image);
+
+typedef struct mos_scaler mos_scaler_t;
+
+// src_w x src_h → dst_w x dst_h (너비는 모두 짝수, dst 가 src 보다 크면 최근접 확대)
+mos_scaler_t *mos_scaler_create(int src_w, int src_h, int dst_w, int dst_h);
+void mos_scaler_destroy(mos_scaler_t *s);
+
+// 2:1 단계 수 (0 이면 최근접만)
+int mos_scaler_levels(const mos_scaler_t *s);
+
+// YUYV 축소. 같은 scaler 는 한 스레드에서만 사용한다 (중간 버퍼 공유). 성공 0
+int mos_scale_yuyv(mos_scaler_t *s, const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride);
+
+// 구현 경로를 직접 지정하는 버전 (벤치마크/검증용, 지원하지 않으면 -1)
+int mos_scale_yuyv_impl(mos_scaler_t *s, const uint8_t *src, int src_stride,
+                        uint8_t *dst, int dst_stride, cc_impl_t impl);
+
+// JPEG 디코딩 결과 (mjd MJD_OUT_YUV 평면, 샘플링 그대로) → YUYV
+// plane[1]/plane[2] 가 NULL 이면 (흑백) 색차 128. chroma_w/h 는 색차 평면 크기
+void mos_pack_planar(const uint8_t *const plane[3], const int stride[3],
+                     int width, int height, int chroma_w, int chroma_h,
+                     uint8_t *dst, int dst_stride);
+
+// YUYV 사각형을 검정으로 (Y 0, U/V 128: 풀 레인지 검정)
+void mos_fill_black_yuyv(uint8_t *dst, int stride, int width, int height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOSAIC_H
@@ -0,0 +1,489 @@
+//----------------------------------------------//
+//	호스트 소프트웨어 모션 감지 (블록 SAD)		//
+//----------------------------------------------//
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "motion_detect.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MD_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MD_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 배경은 Q7 (휘도 * 128, 최대 32640) 이므로 차이가 int16 범위에 들어간다
+#define MD_BG_SHIFT     7
+#define MD_BG_ROUND     (1 << (MD_BG_SHIFT - 1))
+
+typedef uint32_t (*md_row_fn)(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update);
+
+struct md_engine {
+    int width;
+    int height;
+    md_config_t cfg;
+    md_row_fn row;
+    uint16_t *bg;
+
+    uint8_t mask[MD_MASK_BYTES];
+    int cell_x[MD_GRID_COLS + 1];
+    int cell_y[MD_GRID_ROWS + 1];
+    uint32_t cell_pixels[MD_CELLS];     // row_step 을 반영한 표본 화소 수
+    uint16_t levels[MD_CELLS];
+    uint16_t on_frames[MD_CELLS];       // 연속으로 움직임이 잡힌 프레임 수
+
+    uint8_t result[MD_MASK_BYTES];
+    uint8_t reported[MD_MASK_BYTES];    // 마지막으로 알린 결과
+    uint64_t frames_seen;               // md_reset 이후 프레임
+    int in_motion;
+    int quiet;
+    uint64_t start_ns;
+
+    md_event_fn fn;
+    void *user;
+    md_stats_t stats;
+};
+
+static uint64_t md_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+// 행 커널: sum |Y - round(bg)|, update 면 bg += (Y*128 - bg) >> shift
+//------------------------------------------------------------------------------
+
+static uint32_t md_row_scalar(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update)
+{
+    uint32_t sad = 0;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        int y = src[i * step];
+        int b = (bg[i] + MD_BG_ROUND) >> MD_BG_SHIFT;
+        sad += (uint32_t)(y > b ? y - b : b - y);
+        if (update)
+            bg[i] = (uint16_t)(bg[i] + (((y << MD_BG_SHIFT) - bg[i]) >> shift));
+    }
+    return sad;
+}
+
+#ifdef MD_HAVE_X86
+
+__attribute__((target("sse2")))
+static uint32_t md_row_sse2(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i luma = _mm_set1_epi16(0x00FF);
+    const __m128i round = _mm_set1_epi16(MD_BG_ROUND);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    __m128i acc = zero;
+    uint32_t sad;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m128i y16, b, b16;
+
+        if (step == 1)
+            y16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + i)), zero);
+        else
+            y16 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + i * 2)), luma);
+        b = _mm_loadu_si128((const __m128i *)(bg + i));
+        b16 = _mm_srli_epi16(_mm_add_epi16(b, round), MD_BG_SHIFT);
+
+        // psadbw: 8 바이트씩 절대차 합
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_packus_epi16(y16, zero), _mm_packus_epi16(b16, zero)));
+        if (update) {
+            __m128i d = _mm_sub_epi16(_mm_slli_epi16(y16, MD_BG_SHIFT), b);
+            _mm_storeu_si128((__m128i *)(bg + i), _mm_add_epi16(b, _mm_sra_epi16(d, count)));
+        }
+    }
+    sad = (uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+    return sad + md_row_scalar(src + i * step, step, bg + i, n - i, shift, update);
+}
+
+__attribute__((target("avx2")))
+static uint32_t md_row_avx2(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i luma = _mm256_set1_epi16(0x00FF);
+    const __m256i round = _mm256_set1_epi16(MD_BG_ROUND);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    __m256i acc = zero;
+    __m128i sum;
+    int i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        __m256i y16, b, b16;
+
+        if (step == 1)
+            y16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + i)));
+        else
+            y16 = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(src + i * 2)), luma);
+        b = _mm256_loadu_si256((const __m256i *)(bg + i));
+        b16 = _mm256_srli_epi16(_mm256_add_epi16(b, round), MD_BG_SHIFT);
+
+        // packus 는 128비트 레인 단위로 섞지만 y/b 를 같은 순서로 묶으므로 SAD 합은 같다
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_packus_epi16(y16, zero),
+                                                     _mm256_packus_epi16(b16, zero)));
+        if (update) {
+            __m256i d = _mm256_sub_epi16(_mm256_slli_epi16(y16, MD_BG_SHIFT), b);
+            _mm256_storeu_si256((__m256i *)(bg + i), _mm256_add_epi16(b, _mm256_sra_epi16(d, count)));
+        }
+    }
+    sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+    // 꼬리는 비 VEX SSE2 코드이므로 상위 레인을 비워 AVX→SSE 전환 지연을 피한다
+    _mm256_zeroupper();
+    return (uint32_t)_mm_cvtsi128_si32(sum) + md_row_sse2(src + i * step, step, bg + i, n - i, shift, update);
+}
+
+#endif // MD_HAVE_X86
+
+#ifdef MD_HAVE_NEON
+
+static uint32_t md_row_neon(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update)
+{
+    const int16x8_t count = vdupq_n_s16((int16_t)-shift);
+    uint32x4_t acc = vdupq_n_u32(0);
+    uint32_t sad;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        uint8x8_t y8 = step == 1 ? vld1_u8(src + i) : vld2_u8(src + i * 2).val[0];
+        uint16x8_t b = vld1q_u16(bg + i);
+        uint8x8_t b8 = vmovn_u16(vrshrq_n_u16(b, MD_BG_SHIFT));
+
+        acc = vpadalq_u16(acc, vabdl_u8(y8, b8));
+        if (update) {
+            int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vshll_n_u8(y8, MD_BG_SHIFT)),
+                                    vreinterpretq_s16_u16(b));
+            // 음수 시프트 = 산술 오른쪽 시프트 (내림, 스칼라 >> 와 같음)
+            d = vshlq_s16(d, count);
+            vst1q_u16(bg + i, vreinterpretq_u16_s16(vaddq_s16(vreinterpretq_s16_u16(b), d)));
+        }
+    }
+    sad = vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+    return sad + md_row_scalar(src + i * step, step, bg + i, n - i, shift, update);
+}
+
+#endif // MD_HAVE_NEON
+
+static md_row_fn md_row_function(cc_impl_t impl)
+{
+    switch (impl) {
+#ifdef MD_HAVE_X86
+    case CC_IMPL_SSE2: return md_row_sse2;
+    case CC_IMPL_AVX2: return md_row_avx2;
+#endif
+#ifdef MD_HAVE_NEON
+    case CC_IMPL_NEON: return md_row_neon;
+#endif
+    case CC_IMPL_SCALAR: return md_row_scalar;
+    default: return NULL;
+    }
+}
+
+uint32_t md_row_impl(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update,
+                     cc_impl_t impl)
+{
+    md_row_fn row;
+
+    if (impl == CC_IMPL_AUTO)
+        impl = cc_best_impl();
+    if (!cc_impl_supported(impl) || !(row = md_row_function(impl)))
+        return 0;
+    return row(src, step, bg, n, shift, update);
+}
+
+//------------------------------------------------------------------------------
+// 엔진
+//------------------------------------------------------------------------------
+
+void md_default_config(md_config_t *cfg)
+{
+    if (!cfg)
+        return;
+    cfg->threshold = 0x0600;
+    cfg->learn_shift = 5;
+    cfg->row_step = 1;
+    cfg->min_cells = 1;
+    cfg->hold_frames = 15;
+    cfg->absorb_frames = 300;
+    cfg->warmup_frames = 8;
+    cfg->impl = CC_IMPL_AUTO;
+}
+
+static void md_layout(md_engine_t *md)
+{
+    int c, r, y;
+
+    for (c = 0; c <= MD_GRID_COLS; c++)
+        md->cell_x[c] = c * md->width / MD_GRID_COLS;
+    for (r = 0; r <= MD_GRID_ROWS; r++)
+        md->cell_y[r] = r * md->height / MD_GRID_ROWS;
+
+    for (r = 0; r < MD_GRID_ROWS; r++) {
+        uint32_t rows = 0;
+        for (y = md->cell_y[r]; y < md->cell_y[r + 1]; y++)
+            if (y % md->cfg.row_step == 0)
+                rows++;
+        for (c = 0; c < MD_GRID_COLS; c++)
+            md->cell_pixels[r * MD_GRID_COLS + c] = rows * (uint32_t)(md->cell_x[c + 1] - md->cell_x[c]);
+    }
+}
+
+md_engine_t *md_create(int width, int height, const md_config_t *cfg)
+{
+    md_engine_t *md;
+    cc_impl_t impl;
+
+    // 격자 한 칸이 최소 한 화소는 되어야 한다
+    if (width < MD_GRID_COLS || height < MD_GRID_ROWS)
+        return NULL;
+
+    md = (md_engine_t *)calloc(1, sizeof(*md));
+    if (!md)
+        return NULL;
+    if (cfg)
+        md->cfg = *cfg;
+    else
+        md_default_config(&md->cfg);
+    if (md->cfg.learn_shift < 1)
+        md->cfg.learn_shift = 1;
+    if (md->cfg.learn_shift > MD_BG_SHIFT)
+        md->cfg.learn_shift = MD_BG_SHIFT;
+    if (md->cfg.row_step < 1)
+        md->cfg.row_step = 1;
+    if (md->cfg.min_cells < 1)
+        md->cfg.min_cells = 1;
+    if (md->cfg.hold_frames < 1)
+        md->cfg.hold_frames = 1;
+
+    impl = md->cfg.impl == CC_IMPL_AUTO ? cc_best_impl() : md->cfg.impl;
+    md->row = cc_impl_supported(impl) ? md_row_function(impl) : NULL;
+    md->bg = (uint16_t *)malloc((size_t)width * height * sizeof(uint16_t));
+    if (!md->row || !md->bg) {
+        md_destroy(md);
+        return NULL;
+    }
+
+    md->width = width;
+    md->height = height;
+    memset(md->mask, 0xFF, sizeof(md->mask));
+    md_layout(md);
+    md_reset(md);
+    return md;
+}
+
+void md_destroy(md_engine_t *md)
+{
+    if (!md)
+        return;
+    free(md->bg);
+    free(md);
+}
+
+void md_reset(md_engine_t *md)
+{
+    if (!md)
+        return;
+    md->frames_seen = 0;
+    md->in_motion = 0;
+    md->quiet = 0;
+    md->start_ns = 0;
+    memset(md->levels, 0, sizeof(md->levels));
+    memset(md->on_frames, 0, sizeof(md->on_frames));
+    memset(md->result, 0, sizeof(md->result));
+    memset(md->reported, 0, sizeof(md->reported));
+}
+
+int md_set_mask(md_engine_t *md, const uint8_t mask[MD_MASK_BYTES])
+{
+    if (!md)
+        return -1;
+    if (mask)
+        memcpy(md->mask, mask, MD_MASK_BYTES);
+    else
+        memset(md->mask, 0xFF, MD_MASK_BYTES);
+    // 꺼져 있던 셀은 배경이 갱신되지 않았으므로 처음부터 다시 학습
+    md_reset(md);
+    return 0;
+}
+
+void md_get_mask(const md_engine_t *md, uint8_t mask[MD_MASK_BYTES])
+{
+    if (md && mask)
+        memcpy(mask, md->mask, MD_MASK_BYTES);
+}
+
+void md_set_threshold(md_engine_t *md, uint16_t threshold)
+{
+    if (md)
+        md->cfg.threshold = threshold;
+}
+
+void md_set_callback(md_engine_t *md, md_event_fn fn, void *user)
+{
+    if (!md)
+        return;
+    md->fn = fn;
+    md->user = user;
+}
+
+static void md_emit(md_engine_t *md, md_event_type_t type, uint64_t timestamp_ns, uint32_t sequence,
+                    int active, uint16_t peak)
+{
+    md_event_t ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.timestamp_ns = timestamp_ns;
+    ev.start_ns = md->start_ns;
+    ev.sequence = sequence;
+    ev.active_cells = active;
+    ev.peak_level = peak;
+    if (type != MD_EVENT_END)
+        memcpy(ev.result, md->result, MD_MASK_BYTES);
+    memcpy(md->reported, ev.result, MD_MASK_BYTES);
+
+    md->stats.events++;
+    if (md->fn)
+        md->fn(&ev, md->user);
+}
+
+int md_process(md_engine_t *md, const uint8_t *src, int stride, md_input_t input,
+               uint64_t timestamp_ns, uint32_t sequence)
+{
+    uint32_t sad[MD_CELLS];
+    uint64_t t0 = md_now_ns();
+    int step = input == MD_INPUT_YUYV ? 2 : 1;
+    int seed, warm, shift, active = 0, motion, r, c, y;
+    uint16_t peak = 0;
+
+    if (!md || !src || stride < md->width * step)
+        return -1;
+
+    // 첫 프레임은 배경을 그대로 채우고, 워밍업 동안은 빠르게(1/2) 학습한다
+    seed = md->frames_seen == 0;
+    warm = seed || md->frames_seen < (uint64_t)md->cfg.warmup_frames;
+    shift = seed ? 0 : (warm ? 1 : md->cfg.learn_shift);
+
+    memset(sad, 0, sizeof(sad));
+    for (r = 0; r < MD_GRID_ROWS; r++) {
+        int upd[MD_GRID_COLS];
+
+        for (c = 0; c < MD_GRID_COLS; c++) {
+            int n = md->on_frames[r * MD_GRID_COLS + c];
+            // 직전 프레임에 움직임이 잡힌 셀은 물체를 배경에 섞지 않는다 (오래 남으면 흡수)
+            upd[c] = warm || n == 0 || n > md->cfg.absorb_frames;
+        }
+        for (y = md->cell_y[r]; y < md->cell_y[r + 1]; y++) {
+            const uint8_t *line;
+            uint16_t *bgl;
+
+            if (y % md->cfg.row_step)
+                continue;
+            line = src + (size_t)y * stride;
+            bgl = md->bg + (size_t)y * md->width;
+            for (c = 0; c < MD_GRID_COLS; c++) {
+                int x0 = md->cell_x[c];
+                if (!md_cell_get(md->mask, c, r))
+                    continue;
+                sad[r * MD_GRID_COLS + c] += md->row(line + x0 * step, step, bgl + x0,
+                                                     md->cell_x[c + 1] - x0, shift, upd[c]);
+            }
+        }
+    }
+
+    memset(md->result, 0, sizeof(md->result));
+    for (r = 0; r < MD_CELLS; r++) {
+        uint64_t level;
+
+        if (!md_cell_get(md->mask, r % MD_GRID_COLS, r / MD_GRID_COLS) || md->cell_pixels[r] == 0) {
+            md->levels[r] = 0;
+            md->on_frames[r] = 0;
+            continue;
+        }
+        level = ((uint64_t)sad[r] << 8) / md->cell_pixels[r];
+        md->levels[r] = (uint16_t)(level > 0xFFFF ? 0xFFFF : level);
+        if (!warm && md->levels[r] > md->cfg.threshold) {
+            md_cell_set(md->result, r % MD_GRID_COLS, r / MD_GRID_COLS, 1);
+            if (md->on_frames[r] < 0xFFFF)
+                md->on_frames[r]++;
+            if (md->levels[r] > peak)
+                peak = md->levels[r];
+            active++;
+        } else {
+            md->on_frames[r] = 0;
+        }
+    }
+    md->frames_seen++;
+
+    motion = active >= md->cfg.min_cells;
+    if (motion) {
+        md->quiet = 0;
+        md->stats.motion_frames++;
+        if (!md->in_motion) {
+            md->in_motion = 1;
+            md->start_ns = timestamp_ns;
+            md_emit(md, MD_EVENT_START, timestamp_ns, sequence, active, peak);
+        } else if (memcmp(md->result, md->reported, MD_MASK_BYTES) != 0) {
+            md_emit(md, MD_EVENT_UPDATE, timestamp_ns, sequence, active, peak);
+        }
+    } else if (md->in_motion && ++md->quiet >= md->cfg.hold_frames) {
+        md->in_motion = 0;
+        md_emit(md, MD_EVENT_END, timestamp_ns, sequence, 0, 0);
+    }
+
+    md->stats.frames++;
+    md->stats.process_ns += md_now_ns() - t0;
+    return motion;
+}
+
+void md_get_result(const md_engine_t *md, uint8_t result[MD_MASK_BYTES])
+{
+    if (md && result)
+        memcpy(result, md->result, MD_MASK_BYTES);
+}
+
+const uint16_t *md_levels(const md_engine_t *md)
+{
+    return md ? md->levels : NULL;
+}
+
+void md_get_stats(const md_engine_t *md, md_stats_t *stats)
+{
+    if (md && stats)
+        *stats = md->stats;
+}
+
+void md_cell_rect(const md_engine_t *md, int col, int row, int *x0, int *y0, int *x1, int *y1)
+{
+    if (!md || col < 0 || col >= MD_GRID_COLS || row < 0 || row >= MD_GRID_ROWS)
+        return;
+    *x0 = md->cell_x[col];
+    *x1 = md->cell_x[col + 1];
+    *y0 = md->cell_y[row];
+    *y1 = md->cell_y[row + 1];
+}
+
+void md_print_grid(FILE *fp, const uint8_t bits[MD_MASK_BYTES])
+{
+    int r, c;
+
+    fprintf(fp, "     1   2   3   4   5   6   7   8   9  10  11  12  13  14  15  16 \n");
+    for (r = 0; r < MD_GRID_ROWS; r++) {
+        fprintf(fp, "%2d   ", r + 1);
+        for (c = 0; c < MD_GRID_COLS; c++)
+            fprintf(fp, "%d   ", md_cell_get(bits, c, r));
+        fprintf(fp, "\n");
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef MOTION_DETECT_H
+#define MOTION_DETECT_H
+
+// 호스트 소프트웨어 모션 감지
+// 카메라의 하드웨어 모션 감지(XU_MD_*)와 같은 16x12 격자, 같은 24 바이트 마스크/결과 배치를 쓰므로
+// --xuset-mdm 마스크를 그대로 옮겨 쓸 수 있고, RER9422 가 없는 카메라나 녹화 영상에서도 돌릴 수 있다.
+//
+// - 배경 모델: 화소마다 Q7 고정소수점 지수 이동 평균 (bg += (Y*128 - bg) >> learn_shift)
+// - 셀 레벨: 셀 안 화소의 평균 |Y - 배경| (Q8), threshold 를 넘으면 그 셀에 움직임
+// - 한 번의 행 순회에서 SAD 계산과 배경 갱신을 같이 한다 (SSE2/AVX2/NEON, 스칼라와 비트 단위로 동일)
+// - 입력은 휘도 평면(MJPEG 디코딩 Y 평면 등) 또는 YUYV 그대로
+// - 움직임 시작/변화/종료를 프레임 timestamp 와 함께 콜백으로 알린다
+//
+// md_process 는 한 스레드에서만 호출한다 (콜백도 그 스레드에서 불린다).
+
+#include <stdint.h>
+#include <stdio.h>
+#include "color_convert.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// XU_MD_Set_Mask / XU_MD_Get_RESULT 와 같은 배치:
+// 행 r (0..11) 마다 2 바이트, 바이트 r*2 + c/8 의 비트 (c % 8) 가 열 c (0..15)
+#define MD_GRID_COLS        16
+#define MD_GRID_ROWS        12
+#define MD_CELLS            (MD_GRID_COLS * MD_GRID_ROWS)
+#define MD_MASK_BYTES       24
+
+typedef enum {
+    MD_INPUT_LUMA = 0,      // 8비트 휘도 평면 (stride 는 바이트)
+    MD_INPUT_YUYV           // YUYV 4:2:2 (Y 만 사용, stride 는 바이트)
+} md_input_t;
+
+typedef enum {
+    MD_EVENT_START = 0,     // 움직임 시작
+    MD_EVENT_UPDATE,        // 움직이는 셀 집합이 바뀜
+    MD_EVENT_END            // hold_frames 동안 조용함
+} md_event_type_t;
+
+typedef struct {
+    uint16_t threshold;     // 셀 평균 |Y - 배경| (Q8, XU 임계값과 같은 16비트). 0x0600 = 휘도 6
+    int learn_shift;        // 배경 학습 속도 2^-k (1..7, 기본 5 → 약 32 프레임)
+    int row_step;           // 1 이면 모든 행, 2 이면 격행 ... (고해상도에서 부하 감소)
+    int min_cells;          // 움직임으로 볼 최소 셀 수
+    int hold_frames;        // 이만큼 조용하면 END
+    int absorb_frames;      // 이보다 오래 켜진 셀은 배경으로 흡수 (조명 변화, 놓인 물체)
+    int warmup_frames;      // 처음 N 프레임은 배경만 학습
+    cc_impl_t impl;         // CC_IMPL_AUTO 면 런타임 CPU 감지
+} md_config_t;
+
+typedef struct {
+    md_event_type_t type;
+    uint64_t timestamp_ns;          // 이벤트를 만든 프레임의 timestamp (md_process 인자)
+    uint64_t start_ns;              // 이번 움직임이 시작된 프레임의 timestamp
+    uint32_t sequence;
+    int active_cells;
+    uint16_t peak_level;            // 가장 큰 셀 레벨 (Q8)
+    uint8_t result[MD_MASK_BYTES];  // XU_MD_Get_RESULT 와 같은 배치 (END 면 0)
+} md_event_t;
+
+typedef void (*md_event_fn)(const md_event_t *ev, void *user);
+
+typedef struct {
+    uint64_t frames;
+    uint64_t events;
+    uint64_t motion_frames;
+    uint64_t process_ns;            // md_process 누적 시간
+} md_stats_t;
+
+typedef struct md_engine md_engine_t;
+
+void md_default_config(md_config_t *cfg);
+
+// width x height 휘도 기준 엔진 (cfg 가 NULL 이면 기본값). 마스크는 전체 켜짐
+md_engine_t *md_create(int width, int height, const md_config_t *cfg);
+void md_destroy(md_engine_t *md);
+
+// 마스크를 바꾸면 배경을 다시 학습한다 (NULL 이면 전체 셀)
+int md_set_mask(md_engine_t *md, const uint8_t mask[MD_MASK_BYTES]);
+void md_get_mask(const md_engine_t *md, uint8_t mask[MD_MASK_BYTES]);
+void md_set_threshold(md_engine_t *md, uint16_t threshold);
+void md_set_callback(md_engine_t *md, md_event_fn fn, void *user);
+
+// 배경과 이벤트 상태를 처음으로 되돌린다 (해상도/장면 전환)
+void md_reset(md_engine_t *md);
+
+// 프레임 하나 처리. 움직임이 있으면 1, 없으면 0, 잘못된 인자 -1
+int md_process(md_engine_t *md, const uint8_t *src, int stride, md_input_t input,
+               uint64_t timestamp_ns, uint32_t sequence);
+
+// 마지막 프레임의 셀별 결과 (XU_MD_Get_RESULT 배치) / 레벨 (Q8, 행 우선 MD_CELLS 개)
+void md_get_result(const md_engine_t *md, uint8_t result[MD_MASK_BYTES]);
+const uint16_t *md_levels(const md_engine_t *md);
+
+void md_get_stats(const md_engine_t *md, md_stats_t *stats);
+
+// 셀 좌표 (픽셀, x1/y1 은 포함하지 않음)
+void md_cell_rect(const md_engine_t *md, int col, int row, int *x0, int *y0, int *x1, int *y1);
+
+static inline int md_cell_get(const uint8_t bits[MD_MASK_BYTES], int col, int row)
+{
+    return (bits[row * 2 + col / 8] >> (col % 8)) & 1;
+}
+
+static inline void md_cell_set(uint8_t bits[MD_MASK_BYTES], int col, int row, int on)
+{
+    if (on)
+        bits[row * 2 + col / 8] |= (uint8_t)(1 << (col % 8));
+    else
+        bits[row * 2 + col / 8] &= (uint8_t)~(1 << (col % 8));
+}
+
+// XU_MD_Get_Mask 와 같은 모양으로 격자를 출력
+void md_print_grid(FILE *fp, const uint8_t bits[MD_MASK_BYTES]);
+
+// SAD + 배경 갱신 행 커널 (검증/벤치마크용). step 1 = 휘도, 2 = YUYV
+uint32_t md_row_impl(const uint8_t *src, int step, uint16_t *bg, int n, int shift, int update,
+                     cc_impl_t impl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOTION_DETECT_H
@@ -0,0 +1,406 @@
+//----------------------------------------------//
+//	소프트웨어 모션 감지 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./motion_detect_bench                       합성 장면 검증 + 처리 속도
+//         ./motion_detect_bench clip.yuyv W H [thr]   녹화된 YUYV 클립에서 이벤트 출력
+// SIMD 행 커널이 스칼라와 비트 단위로 같은지, 합성 장면에서 움직임 셀/이벤트가 맞는지 확인한다.
+// 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "motion_detect.h"
+
+#define SCENE_W         640
+#define SCENE_H         480
+#define SCENE_FRAMES    300
+#define OBJ_SIZE        60
+#define OBJ_FIRST       40      // 물체가 나타나는 프레임
+#define OBJ_LAST        79      // 마지막으로 보이는 프레임
+#define LIGHT_FRAME     130     // 조명이 바뀌는 프레임
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static unsigned int rng_state = 12345;
+
+static unsigned int rng(void)
+{
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 16;
+}
+
+//------------------------------------------------------------------------------
+// 커널 비트 일치
+//------------------------------------------------------------------------------
+
+static int verify_kernels(void)
+{
+    static const int lengths[] = { 1, 7, 8, 15, 16, 17, 31, 33, 40, 120, 641 };
+    static const cc_impl_t impls[] = { CC_IMPL_SSE2, CC_IMPL_AVX2, CC_IMPL_NEON };
+    uint8_t src[641 * 2];
+    uint16_t bg_ref[641], bg_out[641], bg_init[641];
+    int failures = 0, checked = 0;
+    size_t k, l;
+    int step, shift, update, i;
+
+    for (i = 0; i < (int)sizeof(src); i++)
+        src[i] = (uint8_t)rng();
+    src[0] = 0;
+    src[2] = 255;
+    for (i = 0; i < 641; i++)
+        bg_init[i] = (uint16_t)(rng() % 32641);
+    bg_init[1] = 32640;
+    bg_init[3] = 0;
+
+    for (k = 0; k < sizeof(impls) / sizeof(impls[0]); k++) {
+        if (!cc_impl_supported(impls[k]))
+            continue;
+        for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            for (step = 1; step <= 2; step++) {
+                for (shift = 0; shift <= 7; shift++) {
+                    for (update = 0; update <= 1; update++) {
+                        uint32_t a, b;
+                        int n = lengths[l];
+
+                        memcpy(bg_ref, bg_init, sizeof(bg_ref));
+                        memcpy(bg_out, bg_init, sizeof(bg_out));
+                        a = md_row_impl(src, step, bg_ref, n, shift, update, CC_IMPL_SCALAR);
+                        b = md_row_impl(src, step, bg_out, n, shift, update, impls[k]);
+                        checked++;
+                        if (a != b || memcmp(bg_ref, bg_out, sizeof(bg_ref)) != 0) {
+                            if (failures < 5)
+                                printf("  %s n=%d step=%d shift=%d update=%d: sad %u != %u 또는 배경 불일치\n",
+                                       cc_impl_name(impls[k]), n, step, shift, update, a, b);
+                            failures++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("행 커널 비트 일치: %d 조합 %s\n", checked, failures ? "FAIL" : "OK");
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// 합성 장면: 잡음이 있는 정지 배경 + 움직이는 사각형 + 조명 변화
+//------------------------------------------------------------------------------
+
+typedef struct {
+    int count[3];           // START / UPDATE / END
+    int first_start;        // 첫 START 프레임 (sequence)
+    int first_end;
+    int last_end;
+    int bad_cells;          // 물체와 겹치지 않는 셀이 켜진 횟수
+    int missed_cells;       // 물체가 완전히 덮은 셀이 꺼진 횟수
+    uint64_t start_ns;
+} scene_log_t;
+
+static void scene_event(const md_event_t *ev, void *user)
+{
+    scene_log_t *log = (scene_log_t *)user;
+
+    log->count[ev->type]++;
+    if (ev->type == MD_EVENT_START && log->first_start < 0) {
+        log->first_start = (int)ev->sequence;
+        log->start_ns = ev->start_ns;
+    }
+    if (ev->type == MD_EVENT_END) {
+        if (log->first_end < 0)
+            log->first_end = (int)ev->sequence;
+        log->last_end = (int)ev->sequence;
+    }
+}
+
+static void object_pos(int frame, int *ox, int *oy)
+{
+    *ox = 20 + (frame - OBJ_FIRST) * 13;
+    *oy = 200 + (frame - OBJ_FIRST) * 2;
+}
+
+// 배경 텍스처 + 프레임마다 다른 센서 잡음 (±2)
+static void render_scene(int frame, const uint8_t *texture, uint8_t *yuyv, uint8_t *luma)
+{
+    int light = frame >= LIGHT_FRAME ? 40 : 0;
+    int x, y, ox = -1000, oy = -1000;
+
+    if (frame >= OBJ_FIRST && frame <= OBJ_LAST)
+        object_pos(frame, &ox, &oy);
+
+    for (y = 0; y < SCENE_H; y++) {
+        for (x = 0; x < SCENE_W; x++) {
+            int v = texture[y * SCENE_W + x] + light + (int)(rng() % 5) - 2;
+            if (x >= ox && x < ox + OBJ_SIZE && y >= oy && y < oy + OBJ_SIZE)
+                v = 235;
+            v = v < 0 ? 0 : (v > 255 ? 255 : v);
+            luma[y * SCENE_W + x] = (uint8_t)v;
+            yuyv[(y * SCENE_W + x) * 2] = (uint8_t)v;
+            yuyv[(y * SCENE_W + x) * 2 + 1] = (uint8_t)(x & 1 ? 140 : 110);
+        }
+    }
+}
+
+static void check_cells(md_engine_t *md, int frame, scene_log_t *log)
+{
+    uint8_t result[MD_MASK_BYTES];
+    int ox, oy, c, r;
+
+    if (frame < OBJ_FIRST || frame > OBJ_LAST)
+        return;
+    object_pos(frame, &ox, &oy);
+    md_get_result(md, result);
+    for (r = 0; r < MD_GRID_ROWS; r++) {
+        for (c = 0; c < MD_GRID_COLS; c++) {
+            int x0, y0, x1, y1, overlap, covered;
+            md_cell_rect(md, c, r, &x0, &y0, &x1, &y1);
+            overlap = ox < x1 && ox + OBJ_SIZE > x0 && oy < y1 && oy + OBJ_SIZE > y0;
+            covered = ox <= x0 && ox + OBJ_SIZE >= x1 && oy <= y0 && oy + OBJ_SIZE >= y1;
+            if (md_cell_get(result, c, r) && !overlap)
+                log->bad_cells++;
+            if (covered && !md_cell_get(result, c, r))
+                log->missed_cells++;
+        }
+    }
+}
+
+// expect: 0 = 이벤트 없음, 1 = 조명 변화만, 2 = 물체 + 조명 변화
+static int run_scene(const char *name, const uint8_t *mask, int expect)
+{
+    uint8_t *texture = (uint8_t *)malloc(SCENE_W * SCENE_H);
+    uint8_t *yuyv = (uint8_t *)malloc(SCENE_W * SCENE_H * 2);
+    uint8_t *luma = (uint8_t *)malloc(SCENE_W * SCENE_H);
+    md_config_t cfg;
+    md_engine_t *md_yuyv, *md_luma;
+    scene_log_t log, log_luma;
+    int frame, x, y, diverged = 0, failures = 0;
+
+    for (y = 0; y < SCENE_H; y++)
+        for (x = 0; x < SCENE_W; x++)
+            texture[y * SCENE_W + x] = (uint8_t)(60 + ((x / 16 + y / 16) & 1) * 50 + (x * 40) / SCENE_W);
+
+    md_default_config(&cfg);
+    cfg.absorb_frames = 30;
+    md_yuyv = md_create(SCENE_W, SCENE_H, &cfg);
+    md_luma = md_create(SCENE_W, SCENE_H, &cfg);
+    memset(&log, 0, sizeof(log));
+    log.first_start = log.first_end = log.last_end = -1;
+    log_luma = log;
+    md_set_callback(md_yuyv, scene_event, &log);
+    md_set_callback(md_luma, scene_event, &log_luma);
+    if (mask) {
+        md_set_mask(md_yuyv, mask);
+        md_set_mask(md_luma, mask);
+    }
+
+    rng_state = 777;
+    for (frame = 0; frame < SCENE_FRAMES; frame++) {
+        uint8_t ra[MD_MASK_BYTES], rb[MD_MASK_BYTES];
+        uint64_t ts = (uint64_t)frame * 33333333ULL;
+
+        render_scene(frame, texture, yuyv, luma);
+        md_process(md_yuyv, yuyv, SCENE_W * 2, MD_INPUT_YUYV, ts, (uint32_t)frame);
+        md_process(md_luma, luma, SCENE_W, MD_INPUT_LUMA, ts, (uint32_t)frame);
+        md_get_result(md_yuyv, ra);
+        md_get_result(md_luma, rb);
+        if (memcmp(ra, rb, sizeof(ra)) != 0 ||
+            memcmp(md_levels(md_yuyv), md_levels(md_luma), MD_CELLS * sizeof(uint16_t)) != 0)
+            diverged++;
+        if (!mask)
+            check_cells(md_yuyv, frame, &log);
+    }
+
+    printf("  %-12s START %d (첫 %d) UPDATE %d END %d (첫 %d, 마지막 %d)  엉뚱한 셀 %d  놓친 셀 %d  YUYV/휘도 %s\n",
+           name, log.count[MD_EVENT_START], log.first_start, log.count[MD_EVENT_UPDATE],
+           log.count[MD_EVENT_END], log.first_end, log.last_end,
+           log.bad_cells, log.missed_cells, diverged ? "불일치" : "일치");
+
+    if (diverged)
+        failures++;
+    if (expect == 2) {
+        // 물체 구간: 나타난 프레임에 START, 사라지고 hold_frames 뒤에 END
+        // 조명 변화: 다시 START, absorb_frames 뒤 배경에 흡수되어 END
+        if (log.first_start != OBJ_FIRST || log.start_ns != (uint64_t)OBJ_FIRST * 33333333ULL ||
+            log.first_end != OBJ_LAST + cfg.hold_frames ||
+            log.count[MD_EVENT_START] != 2 || log.count[MD_EVENT_END] != 2 ||
+            log.last_end <= LIGHT_FRAME + cfg.absorb_frames ||
+            log.count[MD_EVENT_UPDATE] < (OBJ_LAST - OBJ_FIRST) / 2 ||
+            log.bad_cells || log.missed_cells)
+            failures++;
+    } else if (expect == 1) {
+        if (log.first_start != LIGHT_FRAME || log.count[MD_EVENT_START] != 1 ||
+            log.count[MD_EVENT_END] != 1 || log.last_end <= LIGHT_FRAME + cfg.absorb_frames)
+            failures++;
+    } else if (log.count[MD_EVENT_START] != 0) {
+        failures++;
+    }
+
+    md_destroy(md_yuyv);
+    md_destroy(md_luma);
+    free(texture);
+    free(yuyv);
+    free(luma);
+    return failures;
+}
+
+static int verify_scenes(void)
+{
+    uint8_t mask[MD_MASK_BYTES];
+    int failures = 0, c, r;
+
+    printf("합성 장면 (%dx%d, %d 프레임)\n", SCENE_W, SCENE_H, SCENE_FRAMES);
+    failures += run_scene("전체 마스크", NULL, 2);
+
+    // 물체가 지나가는 행(5..8)을 끄면 조명 변화만 남는다
+    memset(mask, 0, sizeof(mask));
+    for (r = 0; r < MD_GRID_ROWS; r++)
+        for (c = 0; c < MD_GRID_COLS; c++)
+            md_cell_set(mask, c, r, r < 5 || r > 8);
+    failures += run_scene("물체 행 끔", mask, 1);
+
+    memset(mask, 0, sizeof(mask));
+    failures += run_scene("마스크 전부 끔", mask, 0);
+
+    // XU 마스크 배치: 열 9, 행 3 → 바이트 3*2+1 의 비트 1
+    memset(mask, 0, sizeof(mask));
+    md_cell_set(mask, 9, 3, 1);
+    if (mask[7] != 0x02) {
+        printf("  마스크 배치 불일치 (byte7=0x%02x)\n", mask[7]);
+        failures++;
+    }
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// 속도
+//------------------------------------------------------------------------------
+
+static void bench_speed(void)
+{
+    static const int sizes[][2] = { { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+    static const cc_impl_t impls[] = { CC_IMPL_SCALAR, CC_IMPL_SSE2, CC_IMPL_AVX2, CC_IMPL_NEON };
+    size_t s, k;
+
+    printf("\n%-10s %-7s %-6s %12s %12s\n", "해상도", "구현", "입력", "ms/frame", "Mpix/s");
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int w = sizes[s][0], h = sizes[s][1];
+        uint8_t *frames[2];
+        int f, i;
+
+        for (f = 0; f < 2; f++) {
+            frames[f] = (uint8_t *)malloc((size_t)w * h * 2);
+            for (i = 0; i < w * h * 2; i++)
+                frames[f][i] = (uint8_t)rng();
+        }
+        for (k = 0; k < sizeof(impls) / sizeof(impls[0]); k++) {
+            md_config_t cfg;
+            int input;
+
+            if (!cc_impl_supported(impls[k]))
+                continue;
+            md_default_config(&cfg);
+            cfg.impl = impls[k];
+            for (input = MD_INPUT_LUMA; input <= MD_INPUT_YUYV; input++) {
+                md_engine_t *md = md_create(w, h, &cfg);
+                int stride = input == MD_INPUT_YUYV ? w * 2 : w;
+                int iterations = 30;
+                double t0, ms;
+
+                for (i = 0; i < 10; i++)
+                    md_process(md, frames[i & 1], stride, (md_input_t)input, 0, (uint32_t)i);
+                t0 = now_ms();
+                for (i = 0; i < iterations; i++)
+                    md_process(md, frames[i & 1], stride, (md_input_t)input, 0, (uint32_t)i);
+                ms = (now_ms() - t0) / iterations;
+                printf("%4dx%-5d %-7s %-6s %12.3f %12.1f\n", w, h, cc_impl_name(impls[k]),
+                       input == MD_INPUT_YUYV ? "yuyv" : "luma", ms, w * h / (ms * 1000.0));
+                md_destroy(md);
+            }
+        }
+        free(frames[0]);
+        free(frames[1]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// 녹화 클립
+//------------------------------------------------------------------------------
+
+static void clip_event(const md_event_t *ev, void *user)
+{
+    static const char *names[] = { "START", "UPDATE", "END" };
+    (void)user;
+    printf("[%8.3f s] #%-6u %-6s 셀 %3d  최대 레벨 %5.1f\n", ev->timestamp_ns / 1e9, ev->sequence,
+           names[ev->type], ev->active_cells, ev->peak_level / 256.0);
+    if (ev->type == MD_EVENT_START)
+        md_print_grid(stdout, ev->result);
+}
+
+static int run_clip(const char *path, int w, int h, unsigned int threshold)
+{
+    FILE *fp = fopen(path, "rb");
+    size_t frame_size = (size_t)w * h * 2;
+    uint8_t *buf = (uint8_t *)malloc(frame_size);
+    md_config_t cfg;
+    md_engine_t *md;
+    md_stats_t st;
+    uint32_t n = 0;
+
+    if (!fp || !buf) {
+        printf("%s 를 열 수 없음\n", path);
+        free(buf);
+        if (fp)
+            fclose(fp);
+        return 2;
+    }
+    md_default_config(&cfg);
+    if (threshold)
+        cfg.threshold = (uint16_t)threshold;
+    md = md_create(w, h, &cfg);
+    if (!md) {
+        printf("해상도 %dx%d 를 사용할 수 없음\n", w, h);
+        fclose(fp);
+        free(buf);
+        return 2;
+    }
+    md_set_callback(md, clip_event, NULL);
+
+    // 타임스탬프는 30fps 로 가정
+    while (fread(buf, 1, frame_size, fp) == frame_size) {
+        md_process(md, buf, w * 2, MD_INPUT_YUYV, (uint64_t)n * 33333333ULL, n);
+        n++;
+    }
+    md_get_stats(md, &st);
+    printf("%u 프레임, 이벤트 %llu, 움직임 프레임 %llu, 평균 %.3f ms/frame\n", n,
+           (unsigned long long)st.events, (unsigned long long)st.motion_frames,
+           st.frames ? st.process_ns / 1e6 / st.frames : 0.0);
+
+    md_destroy(md);
+    fclose(fp);
+    free(buf);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int failures = 0;
+
+    if (argc >= 4)
+        return run_clip(argv[1], atoi(argv[2]), atoi(argv[3]),
+                        argc >= 5 ? (unsigned int)strtoul(argv[4], NULL, 0) : 0);
+
+    printf("=== 소프트웨어 모션 감지 (자동 선택 경로: %s) ===\n", cc_impl_name(cc_best_impl()));
+    failures += verify_kernels();
+    failures += verify_scenes();
+    if (failures) {
+        printf("\n불일치 %d 건\n", failures);
+        return 1;
+    }
+    bench_speed();
+    return 0;
+}
@@ -0,0 +1,613 @@
+#include "multi_capture.h"
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+
+#include "sdk_deps/OSD-Linux_H264_AP_0724/v4l2uvc.h"
+
+// 카메라마다 드라이버 버퍼 수 (8 대면 YUYV 1080p 에서도 수십 MB 를 넘지 않도록 작게)
+#define MULTI_CAPTURE_BUFFERS 4
+
+// 타일 3중 버퍼: ready 에 최신 타일 인덱스와 "아직 합성기가 가져가지 않음" 비트
+#define TILE_INDEX  0x3
+#define TILE_FRESH  0x4
+
+struct MultiCameraCapture::Camera {
+    MultiCameraCapture *owner;
+    char label[64];
+    char device[64];                // 비어 있으면 addSource 로 받은 소스
+    int req_width;
+    int req_height;
+    int req_fps;
+    unsigned int req_pixfmt;
+    int cpu;
+
+    struct vdIn *vd;
+    FrameSource *source;
+    int ok;                         // 소스 시작됨
+    double open_ms;
+
+    int width;
+    int height;
+    unsigned int pixfmt;
+    mos_rect_t cell;
+    mos_rect_t image;               // 칸 안의 영상 위치 (= 타일 크기)
+    mos_scaler_t *scaler;
+
+    // MJPEG: JPEG 샘플링 그대로 디코딩 → 원본 크기 YUYV 로 묶은 뒤 축소
+    mjd_decoder_t *decoder;
+    uint8_t *planes;
+    mjd_image_t planar;
+    mjd_info_t jpeg;
+    uint8_t *packed;
+
+    uint8_t *tiles[3];
+    int tile_stride;
+    long long tile_seq[3];
+    uint64_t tile_ts[3];
+    std::atomic<int> ready;
+    int back;                       // 캡처 스레드 전용
+    int front;                      // 합성 스레드 전용
+
+    pthread_t thread;
+    int thread_started;
+    pipeline_metrics_t metrics;     // 캡처 FPS, sequence 드롭, 타일 교체(display_drops), 축소 시간(CONVERT)
+    std::atomic<uint64_t> tiles_done;
+    std::atomic<uint64_t> stale_drops;
+    std::atomic<uint64_t> decode_errors;
+    std::atomic<uint64_t> bytes;
+};
+
+static int multi_ioctl(int fd, unsigned long request, void *arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (-1 == r && EINTR == errno);
+    return r;
+}
+
+static double ns_to_ms(uint64_t ns) {
+    return ns / 1e6;
+}
+
+MultiCameraCapture::MultiCameraCapture() {
+    memset(cams, 0, sizeof(cams));
+    count = 0;
+    canvas_width = 0;
+    canvas_height = 0;
+    stop_fd = -1;
+    running.store(0);
+    start_ns = 0;
+    memset(&skew, 0, sizeof(skew));
+    memset(&composite_time, 0, sizeof(composite_time));
+    composites = 0;
+}
+
+MultiCameraCapture::~MultiCameraCapture() {
+    stop();
+    for (int i = 0; i < count; i++) {
+        Camera *cam = cams[i];
+        delete cam->source;
+        if (cam->vd) {
+            if (cam->vd->fd >= 0) close(cam->vd->fd);
+            free(cam->vd);
+        }
+        mos_scaler_destroy(cam->scaler);
+        if (cam->decoder) mjd_decoder_destroy(cam->decoder);
+        free(cam->planes);
+        free(cam->packed);
+        for (int t = 0; t < 3; t++) free(cam->tiles[t]);
+        delete cam;
+    }
+    if (stop_fd >= 0) close(stop_fd);
+}
+
+static MultiCameraCapture::Camera *newCamera(MultiCameraCapture *owner, const char *label, int cpu) {
+    MultiCameraCapture::Camera *cam = new MultiCameraCapture::Camera();
+    cam->owner = owner;
+    snprintf(cam->label, sizeof(cam->label), "%s", label ? label : "");
+    cam->cpu = cpu;
+    for (int t = 0; t < 3; t++) cam->tile_seq[t] = -1;
+    cam->ready.store(1);
+    cam->back = 0;
+    cam->front = 2;
+    pm_init(&cam->metrics);
+    return cam;
+}
+
+int MultiCameraCapture::addDevice(const char *device, int width, int height, int fps,
+                                  unsigned int pixfmt, int cpu) {
+    if (!device || count >= MULTI_CAPTURE_MAX_CAMERAS || running.load()) return -1;
+    if (pixfmt != V4L2_PIX_FMT_YUYV && pixfmt != V4L2_PIX_FMT_MJPEG) {
+        printf("%s: 모자이크는 YUYV / MJPEG 만 지원\n", device);
+        return -1;
+    }
+
+    Camera *cam = newCamera(this, device, cpu);
+    snprintf(cam->device, sizeof(cam->device), "%s", device);
+    cam->req_width = width;
+    cam->req_height = height;
+    cam->req_fps = fps;
+    cam->req_pixfmt = pixfmt;
+    cams[count] = cam;
+    return count++;
+}
+
+int MultiCameraCapture::addSource(FrameSource *source, const char *label, int cpu) {
+    if (!source || count >= MULTI_CAPTURE_MAX_CAMERAS || running.load()) return -1;
+    if (source->pixelFormat() != V4L2_PIX_FMT_YUYV && source->pixelFormat() != V4L2_PIX_FMT_MJPEG) {
+        printf("%s: 모자이크는 YUYV / MJPEG 만 지원\n", label ? label : "source");
+        return -1;
+    }
+
+    Camera *cam = newCamera(this, label, cpu);
+    cam->source = source;
+    cams[count] = cam;
+    return count++;
+}
+
+// 장치 열기 ~ STREAMON (열기 스레드에서 카메라마다 동시에)
+int MultiCameraCapture::openDevice(Camera *cam) {
+    uint64_t t0 = pm_now_ns();
+    struct stat st;
+
+    if (stat(cam->device, &st) < 0 || !S_ISCHR(st.st_mode)) {
+        printf("%s: 장치 없음\n", cam->device);
+        return -1;
+    }
+
+    cam->vd = (struct vdIn *)calloc(1, sizeof(struct vdIn));
+    if (!cam->vd) return -1;
+    cam->vd->fd = open(cam->device, O_RDWR | O_NONBLOCK);
+    if (cam->vd->fd < 0) {
+        printf("%s: 열기 실패: %s\n", cam->device, strerror(errno));
+        return -1;
+    }
+
+    struct v4l2_format fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = cam->req_width;
+    fmt.fmt.pix.height = cam->req_height;
+    fmt.fmt.pix.pixelformat = cam->req_pixfmt;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    if (multi_ioctl(cam->vd->fd, VIDIOC_S_FMT, &fmt) < 0) {
+        printf("%s: VIDIOC_S_FMT 실패: %s\n", cam->device, strerror(errno));
+        return -1;
+    }
+    if (fmt.fmt.pix.pixelformat != cam->req_pixfmt) {
+        printf("%s: 요청한 포맷을 지원하지 않음\n", cam->device);
+        return -1;
+    }
+
+    // FPS 는 실패해도 장치 기본값으로 진행
+    struct v4l2_streamparm parm;
+    memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1;
+    parm.parm.capture.timeperframe.denominator = cam->req_fps > 0 ? cam->req_fps : 30;
+    multi_ioctl(cam->vd->fd, VIDIOC_S_PARM, &parm);
+
+    cam->source = new V4L2FrameSource(cam->vd, fmt.fmt.pix.width, fmt.fmt.pix.height,
+                                      fmt.fmt.pix.pixelformat, MULTI_CAPTURE_BUFFERS);
+    if (cam->source->start() < 0) {
+        printf("%s: 스트리밍 시작 실패\n", cam->device);
+        return -1;
+    }
+    cam->open_ms = ns_to_ms(pm_now_ns() - t0);
+    return 0;
+}
+
+void *MultiCameraCapture::openThreadMain(void *arg) {
+    Camera *cam = (Camera *)arg;
+    cam->ok = cam->owner->openDevice(cam) == 0;
+    return NULL;
+}
+
+// 타일 위치 / 축소기 / 3중 버퍼 (프레임마다 할당하지 않도록 시작할 때 한 번)
+int MultiCameraCapture::prepareCamera(Camera *cam) {
+    cam->width = cam->source->width();
+    cam->height = cam->source->height();
+    cam->pixfmt = cam->source->pixelFormat();
+    if (cam->width < 2 || cam->height < 1) return -1;
+
+    mos_fit(&cam->cell, cam->width, cam->height, &cam->image);
+    cam->scaler = mos_scaler_create(cam->width & ~1, cam->height, cam->image.width, cam->image.height);
+    if (!cam->scaler) return -1;
+
+    cam->tile_stride = (cam->image.width * 2 + 31) & ~31;
+    for (int t = 0; t < 3; t++) {
+        cam->tiles[t] = (uint8_t *)malloc((size_t)cam->tile_stride * cam->image.height);
+        if (!cam->tiles[t]) return -1;
+    }
+
+    if (cam->pixfmt == V4L2_PIX_FMT_MJPEG) {
+        cam->decoder = mjd_decoder_create();
+        if (!cam->decoder) return -1;
+    }
+    return 0;
+}
+
+int MultiCameraCapture::start(int canvas_width_, int canvas_height_) {
+    if (count == 0 || running.load()) return -1;
+
+    canvas_width = canvas_width_ & ~1;
+    canvas_height = canvas_height_;
+    mos_rect_t cells[MULTI_CAPTURE_MAX_CAMERAS];
+    if (mos_layout(count, canvas_width, canvas_height, cells) < 0) {
+        printf("모자이크 배치 실패: %d 개, %dx%d\n", count, canvas_width, canvas_height);
+        return -1;
+    }
+
+    stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_fd < 0) return -1;
+
+    // 장치는 모두 동시에 연다
+    uint64_t t0 = pm_now_ns();
+    double open_sum = 0;
+    int opened = 0;
+    pthread_t openers[MULTI_CAPTURE_MAX_CAMERAS];
+    int spawned[MULTI_CAPTURE_MAX_CAMERAS];
+    for (int i = 0; i < count; i++) {
+        Camera *cam = cams[i];
+        spawned[i] = 0;
+        if (cam->device[0]) {
+            if (pthread_create(&openers[i], NULL, openThreadMain, cam) == 0) {
+                spawned[i] = 1;
+            } else {
+                cam->ok = openDevice(cam) == 0;
+            }
+        } else {
+            cam->ok = cam->source->start() == 0;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (spawned[i]) pthread_join(openers[i], NULL);
+        if (cams[i]->device[0] && cams[i]->ok) {
+            open_sum += cams[i]->open_ms;
+            opened++;
+        }
+    }
+    if (opened > 0) {
+        printf("장치 %d 개 열기: %.1f ms (순서대로 열면 %.1f ms)\n", opened, ns_to_ms(pm_now_ns() - t0), open_sum);
+    }
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    start_ns = pm_now_ns();
+    running.store(1, std::memory_order_release);
+
+    int started = 0;
+    for (int i = 0; i < count; i++) {
+        Camera *cam = cams[i];
+        cam->cell = cells[i];
+        cam->image = cells[i];
+        if (cam->cpu >= 0) cam->cpu %= ncpu;
+        if (!cam->ok) continue;
+        if (prepareCamera(cam) < 0) {
+            printf("%s: 타일 준비 실패\n", cam->label);
+            cam->source->stop();
+            cam->ok = 0;
+            continue;
+        }
+        pm_init(&cam->metrics);
+        if (pthread_create(&cam->thread, NULL, captureThreadMain, cam) != 0) {
+            cam->source->stop();
+            cam->ok = 0;
+            continue;
+        }
+        cam->thread_started = 1;
+        started++;
+    }
+    if (started == 0) {
+        running.store(0);
+        return -1;
+    }
+    return 0;
+}
+
+void MultiCameraCapture::stop() {
+    if (!running.exchange(0)) return;
+
+    if (stop_fd >= 0) {
+        uint64_t one = 1;
+        if (write(stop_fd, &one, sizeof(one)) < 0) {
+            // poll 타임아웃(100ms)으로도 끝난다
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        Camera *cam = cams[i];
+        if (cam->thread_started) {
+            pthread_join(cam->thread, NULL);
+            cam->thread_started = 0;
+        }
+        if (cam->ok) cam->source->stop();
+    }
+}
+
+void *MultiCameraCapture::captureThreadMain(void *arg) {
+    Camera *cam = (Camera *)arg;
+    cam->owner->captureLoop(cam);
+    return NULL;
+}
+
+void MultiCameraCapture::captureLoop(Camera *cam) {
+    if (cam->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cam->cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            printf("%s: 코어 %d 고정 실패\n", cam->label, cam->cpu);
+        }
+    }
+
+    struct pollfd pfd[2];
+    pfd[0].fd = cam->source->fd();
+    pfd[0].events = POLLIN;
+    pfd[1].fd = stop_fd;
+    pfd[1].events = POLLIN;
+
+    while (running.load(std::memory_order_acquire)) {
+        pfd[0].revents = 0;
+        pfd[1].revents = 0;
+        if (poll(pfd, 2, 100) < 0 && errno != EINTR) break;
+        if (pfd[1].revents) break;
+
+        // 준비된 프레임을 모두 꺼내고 최신 것만 축소 (밀린 프레임은 바로 돌려준다)
+        FrameDesc latest, desc;
+        latest.index = -1;
+        int err = 0;
+        while (cam->source->dequeue(&desc) == 0) {
+            pm_frame(&cam->metrics, desc.sequence);
+            cam->bytes.fetch_add(desc.bytesused, std::memory_order_relaxed);
+            if (latest.index >= 0) {
+                cam->source->enqueue(latest.index);
+                cam->stale_drops.fetch_add(1, std::memory_order_relaxed);
+            }
+            latest = desc;
+        }
+        err = errno;
+
+        if (latest.index >= 0) {
+            uint64_t t0 = pm_now_ns();
+            if (processFrame(cam, &latest) == 0) {
+                int b = cam->back;
+                cam->tile_seq[b] = latest.sequence;
+                cam->tile_ts[b] = (uint64_t)latest.timestamp.tv_sec * 1000000000ULL +
+                                  (uint64_t)latest.timestamp.tv_usec * 1000ULL;
+                int prev = cam->ready.exchange(b | TILE_FRESH, std::memory_order_acq_rel);
+                if (prev & TILE_FRESH) pm_display_drop(&cam->metrics);
+                cam->back = prev & TILE_INDEX;
+                cam->tiles_done.fetch_add(1, std::memory_order_relaxed);
+            }
+            pm_record_since(&cam->metrics, PM_STAGE_CONVERT, t0);
+            cam->source->enqueue(latest.index);
+        }
+
+        if (err == ENODATA) break;      // 재생 파일 끝
+        if (err != EAGAIN && err != EINTR) {
+            printf("%s: 캡처 오류: %s\n", cam->label, strerror(err));
+            break;
+        }
+    }
+}
+
+// 최신 프레임 하나를 back 타일로 (YUYV 는 mmap 버퍼에서 바로 축소)
+int MultiCameraCapture::processFrame(Camera *cam, const FrameDesc *desc) {
+    uint8_t *tile = cam->tiles[cam->back];
+
+    if (cam->pixfmt == V4L2_PIX_FMT_YUYV) {
+        if (desc->bytesused < (unsigned int)(cam->width * cam->height * 2)) return -1;
+        return mos_scale_yuyv(cam->scaler, desc->data, cam->width * 2, tile, cam->tile_stride);
+    }
+
+    mjd_info_t info;
+    if (mjd_probe(desc->data, desc->bytesused, &info) < 0 || (info.width & 1)) {
+        cam->decode_errors.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+    // 크기 / 샘플링이 바뀌었을 때만 평면과 축소기를 다시 준비
+    if (!cam->planes || info.width != cam->jpeg.width || info.height != cam->jpeg.height ||
+        info.components != cam->jpeg.components ||
+        info.pad_width[1] != cam->jpeg.pad_width[1] || info.pad_height[1] != cam->jpeg.pad_height[1]) {
+        size_t off[3], total = 0;
+        for (int c = 0; c < 3; c++) {
+            off[c] = total;
+            if (c < info.components) total += (size_t)info.pad_width[c] * info.pad_height[c];
+        }
+        free(cam->planes);
+        free(cam->packed);
+        cam->planes = (uint8_t *)malloc(total);
+        cam->packed = (uint8_t *)malloc((size_t)info.width * info.height * 2);
+        if (!cam->planes || !cam->packed) {
+            free(cam->planes);
+            free(cam->packed);
+            cam->planes = NULL;
+            cam->packed = NULL;
+            return -1;
+        }
+        for (int c = 0; c < 3; c++) {
+            cam->planar.plane[c] = c < info.components ? cam->planes + off[c] : NULL;
+            cam->planar.stride[c] = c < info.components ? info.pad_width[c] : 0;
+        }
+        if (info.width != cam->width || info.height != cam->height) {
+            mos_scaler_t *s = mos_scaler_create(info.width, info.height, cam->image.width, cam->image.height);
+            if (!s) return -1;
+            mos_scaler_destroy(cam->scaler);
+            cam->scaler = s;
+            cam->width = info.width;
+            cam->height = info.height;
+        }
+        cam->jpeg = info;
+    }
+
+    if (mjd_decode(cam->decoder, desc->data, desc->bytesused, MJD_OUT_YUV, &cam->planar) < 0) {
+        cam->decode_errors.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    mos_pack_planar(cam->planar.plane, cam->planar.stride, info.width, info.height,
+                    info.components >= 3 ? info.plane_width[1] : 0,
+                    info.components >= 3 ? info.plane_height[1] : 0,
+                    cam->packed, info.width * 2);
+    return mos_scale_yuyv(cam->scaler, cam->packed, info.width * 2, tile, cam->tile_stride);
+}
+
+static void fill_black(uint8_t *dst, int stride, const mos_rect_t *r, int bpp, int yuyv) {
+    if (r->width <= 0 || r->height <= 0) return;
+    uint8_t *p = dst + (size_t)r->y * stride + (size_t)r->x * bpp;
+    if (yuyv) {
+        mos_fill_black_yuyv(p, stride, r->width, r->height);
+        return;
+    }
+    for (int y = 0; y < r->height; y++)
+        memset(p + (size_t)y * stride, 0, (size_t)r->width * bpp);
+}
+
+int MultiCameraCapture::draw(uint8_t *dst, int stride, cc_format_t fmt, int yuyv) {
+    if (!dst || count == 0 || canvas_width == 0) return -1;
+
+    int bpp = yuyv ? 2 : cc_bytes_per_pixel(fmt);
+    if (bpp == 0) return -1;
+
+    uint64_t t0 = pm_now_ns();
+    uint64_t oldest = 0, newest = 0;
+    int shown = 0;
+
+    for (int i = 0; i < count; i++) {
+        Camera *cam = cams[i];
+        const mos_rect_t *c = &cam->cell, *im = &cam->image;
+
+        // 칸에서 영상 밖 (위/아래, 왼쪽/오른쪽 여백)
+        mos_rect_t strip;
+        strip = *c;
+        strip.height = im->y - c->y;
+        fill_black(dst, stride, &strip, bpp, yuyv);
+        strip.y = im->y + im->height;
+        strip.height = c->y + c->height - strip.y;
+        fill_black(dst, stride, &strip, bpp, yuyv);
+        strip.y = im->y;
+        strip.height = im->height;
+        strip.width = im->x - c->x;
+        fill_black(dst, stride, &strip, bpp, yuyv);
+        strip.x = im->x + im->width;
+        strip.width = c->x + c->width - strip.x;
+        fill_black(dst, stride, &strip, bpp, yuyv);
+
+        if (cam->ok && (cam->ready.load(std::memory_order_acquire) & TILE_FRESH)) {
+            int prev = cam->ready.exchange(cam->front, std::memory_order_acq_rel);
+            cam->front = prev & TILE_INDEX;
+        }
+        if (!cam->ok || cam->tile_seq[cam->front] < 0) {
+            fill_black(dst, stride, im, bpp, yuyv);
+            continue;
+        }
+
+        const uint8_t *tile = cam->tiles[cam->front];
+        uint8_t *out = dst + (size_t)im->y * stride + (size_t)im->x * bpp;
+        if (yuyv) {
+            for (int y = 0; y < im->height; y++)
+                memcpy(out + (size_t)y * stride, tile + (size_t)y * cam->tile_stride, (size_t)im->width * 2);
+        } else {
+            yuyv_convert(tile, cam->tile_stride, out, stride, im->width, im->height,
+                         fmt, CC_MATRIX_BT601, CC_RANGE_FULL);
+        }
+
+        uint64_t ts = cam->tile_ts[cam->front];
+        if (!shown || ts < oldest) oldest = ts;
+        if (!shown || ts > newest) newest = ts;
+        shown++;
+    }
+
+    if (shown >= 2) pm_hist_record(&skew, newest - oldest);
+    pm_hist_record(&composite_time, pm_now_ns() - t0);
+    composites++;
+    return shown;
+}
+
+int MultiCameraCapture::composite(uint8_t *dst, int stride, cc_format_t fmt) {
+    return draw(dst, stride, fmt, 0);
+}
+
+int MultiCameraCapture::compositeYUYV(uint8_t *dst, int stride) {
+    return draw(dst, stride, CC_FMT_BGRX32, 1);
+}
+
+long long MultiCameraCapture::tileSequence(int camera) const {
+    if (camera < 0 || camera >= count) return -1;
+    return cams[camera]->tile_seq[cams[camera]->front];
+}
+
+void MultiCameraCapture::getStats(MultiCaptureStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->cameras = count;
+    stats->uptime_s = start_ns ? (pm_now_ns() - start_ns) / 1e9 : 0;
+
+    uint64_t total_bytes = 0;
+    for (int i = 0; i < count; i++) {
+        Camera *cam = cams[i];
+        CameraCaptureStats *cs = &stats->camera[i];
+        pm_snapshot_t snap;
+        pm_snapshot(&cam->metrics, &snap);
+
+        snprintf(cs->label, sizeof(cs->label), "%s", cam->label);
+        cs->width = cam->width;
+        cs->height = cam->height;
+        cs->pixfmt = cam->pixfmt;
+        cs->cpu = cam->cpu;
+        cs->open_ms = cam->open_ms;
+        cs->captured = snap.frames;
+        cs->tiles = cam->tiles_done.load(std::memory_order_relaxed);
+        cs->seq_drops = snap.seq_drops;
+        cs->stale_drops = cam->stale_drops.load(std::memory_order_relaxed);
+        cs->tile_drops = snap.display_drops;
+        cs->decode_errors = cam->decode_errors.load(std::memory_order_relaxed);
+        cs->bytes = cam->bytes.load(std::memory_order_relaxed);
+        cs->fps = cam->ok ? snap.fps_window : 0;
+        cs->scale_mean_us = snap.stages[PM_STAGE_CONVERT].mean_us;
+        cs->scale_p99_us = snap.stages[PM_STAGE_CONVERT].p99_us;
+
+        stats->fps_total += cs->fps;
+        total_bytes += cs->bytes;
+    }
+    if (stats->uptime_s > 0) stats->mbytes_per_s = total_bytes / 1e6 / stats->uptime_s;
+
+    stats->composites = composites;
+    if (skew.count) {
+        stats->skew_mean_ms = ns_to_ms(skew.sum_ns / skew.count);
+        stats->skew_p50_ms = ns_to_ms(pm_hist_percentile(&skew, 0.50));
+        stats->skew_p99_ms = ns_to_ms(pm_hist_percentile(&skew, 0.99));
+        stats->skew_max_ms = ns_to_ms(skew.max_ns);
+    }
+    if (composite_time.count) {
+        stats->composite_mean_us = composite_time.sum_ns / 1e3 / composite_time.count;
+    }
+}
+
+void MultiCameraCapture::printStats(FILE *fp) {
+    MultiCaptureStats st;
+    getStats(&st);
+
+    fprintf(fp, "카메라 %d 대, %.1f 초: 합계 %.1f fps, %.1f MB/s, 합성 %llu 회 (평균 %.0f us)\n",
+            st.cameras, st.uptime_s, st.fps_total, st.mbytes_per_s,
+            (unsigned long long)st.composites, st.composite_mean_us);
+    fprintf(fp, "  타일 간 timestamp 차이: 평균 %.1f ms, p50 %.1f ms, p99 %.1f ms, 최대 %.1f ms\n",
+            st.skew_mean_ms, st.skew_p50_ms, st.skew_p99_ms, st.skew_max_ms);
+    fprintf(fp, "  %-16s %-10s %4s %7s %7s %6s %6s %6s %5s %7s %8s %8s\n",
+            "camera", "size", "cpu", "fps", "frames", "drop", "stale", "tile", "err", "open ms", "scale us", "p99 us");
+    for (int i = 0; i < st.cameras; i++) {
+        const CameraCaptureStats *c = &st.camera[i];
+        char size[24];
+        snprintf(size, sizeof(size), "%dx%d", c->width, c->height);
+        fprintf(fp, "  %-16s %-10s %4d %7.1f %7llu %6llu %6llu %6llu %5llu %7.1f %8.0f %8.0f\n",
+                c->label, size, c->cpu, c->fps, (unsigned long long)c->captured,
+                (unsigned long long)c->seq_drops, (unsigned long long)c->stale_drops,
+                (unsigned long long)c->tile_drops, (unsigned long long)c->decode_errors,
+                c->open_ms, c->scale_mean_us, c->scale_p99_us);
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef MULTI_CAPTURE_H
+#define MULTI_CAPTURE_H
+
+#include <atomic>
+#include <pthread.h>
+#include "frame_source.h"
+#include "pipeline_metrics.h"
+#include "color_convert.h"
+#include "mjpeg_decode.h"
+#include "mosaic.h"
+
+#define MULTI_CAPTURE_MAX_CAMERAS MOS_MAX_TILES
+
+// 카메라 하나의 통계
+typedef struct {
+    char label[64];
+    int width;                  // 캡처 크기 (장치가 정한 실제 값)
+    int height;
+    unsigned int pixfmt;
+    int cpu;                    // 캡처 스레드를 고정한 코어 (-1 이면 고정 안 함)
+    double open_ms;             // 장치 열기 ~ STREAMON (합성/재생 소스는 0)
+    uint64_t captured;          // 디큐한 프레임
+    uint64_t tiles;             // 타일로 만든 프레임
+    uint64_t seq_drops;         // 장치/드라이버가 잃은 프레임 (sequence 간격)
+    uint64_t stale_drops;       // 더 새 프레임이 이미 와 있어 타일로 만들지 않고 바로 돌려준 프레임
+    uint64_t tile_drops;        // 합성기가 가져가기 전에 다음 타일로 교체된 타일
+    uint64_t decode_errors;     // MJPEG 디코딩 실패
+    uint64_t bytes;             // 받은 데이터 (bytesused 합)
+    double fps;                 // 최근 2초 캡처 FPS
+    double scale_mean_us;       // 디코딩 + 축소
+    double scale_p99_us;
+} CameraCaptureStats;
+
+typedef struct {
+    int cameras;
+    double uptime_s;
+    double fps_total;           // 모든 카메라 캡처 FPS 합 (최근 2초)
+    double mbytes_per_s;        // 받은 데이터 (시작 이후 평균)
+    uint64_t composites;
+    // 한 번의 합성에 들어간 타일들의 캡처 시각 차이 (가장 늦은 - 가장 이른)
+    double skew_mean_ms;
+    double skew_p50_ms;
+    double skew_p99_ms;
+    double skew_max_ms;
+    double composite_mean_us;   // 합성 (색변환 포함) 한 번
+    CameraCaptureStats camera[MULTI_CAPTURE_MAX_CAMERAS];
+} MultiCaptureStats;
+
+// 멀티 카메라 캡처 + 모자이크 합성
+// - start() 는 추가된 V4L2 장치를 장치마다 스레드 하나로 동시에 연다 (S_FMT / REQBUFS / STREAMON 이
+//   카메라마다 수백 ms 걸리므로 순서대로 열면 카메라 수만큼 늘어난다)
+// - 카메라마다 캡처 스레드 하나 (지정한 코어에 고정): poll → 준비된 프레임을 모두 디큐해 최신 것만 남기고
+//   (MJPEG 은 디코딩 후) 미리 할당한 타일 크기로 바로 축소한 뒤 버퍼를 즉시 돌려준다
+// - 타일은 카메라마다 3중 버퍼 (lock-free 교환): 캡처 스레드와 합성 스레드가 서로 기다리지 않는다
+// - composite() 는 각 카메라의 최신 타일을 모아 한 번에 출력 포맷으로 그리고 타일 간 timestamp 차이를 기록
+class MultiCameraCapture {
+public:
+    struct Camera;
+
+private:
+    Camera *cams[MULTI_CAPTURE_MAX_CAMERAS];
+    int count;
+    int canvas_width;
+    int canvas_height;
+    int stop_fd;                    // stop() 이 캡처 스레드의 poll 을 바로 깨우는 eventfd
+    std::atomic<int> running;
+    uint64_t start_ns;
+
+    // 합성 (composite 를 부르는 한 스레드 전용)
+    pm_hist_t skew;
+    pm_hist_t composite_time;
+    uint64_t composites;
+
+    int openDevice(Camera *cam);
+    int prepareCamera(Camera *cam);
+    void captureLoop(Camera *cam);
+    int processFrame(Camera *cam, const FrameDesc *desc);
+    int draw(uint8_t *dst, int stride, cc_format_t fmt, int yuyv);
+    static void *openThreadMain(void *arg);
+    static void *captureThreadMain(void *arg);
+
+public:
+    MultiCameraCapture();
+    ~MultiCameraCapture();
+
+    // V4L2 장치 추가 (start() 에서 모두 동시에 연다). pixfmt 는 YUYV 또는 MJPEG, cpu < 0 이면 고정 안 함
+    int addDevice(const char *device, int width, int height, int fps, unsigned int pixfmt, int cpu);
+
+    // 이미 만든 소스 추가 (합성 / 재생, YUYV 또는 MJPEG). 소유권을 넘겨받는다
+    int addSource(FrameSource *source, const char *label, int cpu);
+
+    // 장치를 열고 타일 배치 / 축소기 / 버퍼를 준비한 뒤 캡처 스레드를 시작한다
+    // 열지 못한 장치는 빈 타일로 남는다. 하나도 시작하지 못하면 -1
+    int start(int canvas_width, int canvas_height);
+    void stop();
+
+    int cameraCount() const { return count; }
+    int canvasWidth() const { return canvas_width; }
+    int canvasHeight() const { return canvas_height; }
+
+    // 각 카메라의 최신 타일로 canvas 크기 dst 를 그린다 (한 스레드에서만 호출)
+    int composite(uint8_t *dst, int stride, cc_format_t fmt);
+    int compositeYUYV(uint8_t *dst, int stride);
+
+    // 마지막 composite 에 쓰인 타일의 sequence (아직 없으면 -1)
+    long long tileSequence(int camera) const;
+
+    void getStats(MultiCaptureStats *stats);
+    void printStats(FILE *fp);
+};
+
+#endif // MULTI_CAPTURE_H
@@ -0,0 +1,473 @@
+//----------------------------------------------//
+//	멀티 카메라 모자이크 벤치마크				//
+//----------------------------------------------//
+// 사용법: ./multi_capture_bench [seconds]
+//   1) 2:1 축소 SIMD 경로(SSE2 / AVX2 / NEON)가 스칼라와 비트 단위로 같은지 (홀수 매크로픽셀 / 남는 행 포함),
+//      단색 입력이 단색 그대로인지, MJPEG 평면(4:2:2 / 4:2:0 / 흑백) → YUYV 묶기, 격자 배치 확인
+//   2) 1080p 한 장을 타일 크기로 줄이는 비용 (경로별)
+//   3) 합성 YUYV 카메라 3 대 (1280x720 30fps) + MJPEG 재생 1 대를 각자 코어에 고정해 동시에 돌리며
+//      모자이크를 30Hz 로 합성: 카메라별 FPS / 드롭 / 축소 시간, 타일 간 timestamp 차이 출력.
+//      끝에 마지막 모자이크의 각 타일을 그 sequence 의 원본을 스칼라로 축소한 결과와 비교한다
+// 하나라도 어긋나면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <jpeglib.h>
+#include "multi_capture.h"
+
+#define RUN_SECONDS     2.0
+#define CAM_WIDTH       1280
+#define CAM_HEIGHT      720
+#define CAM_FPS         30
+#define JPEG_WIDTH      640
+#define JPEG_HEIGHT     480
+#define JPEG_FRAMES     20
+#define CANVAS_WIDTH    1280
+#define CANVAS_HEIGHT   720
+#define TIMING_ROUNDS   30
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        printf("  실패: %s\n", what);
+        failures++;
+    }
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill_random(uint8_t *p, size_t n, unsigned int seed)
+{
+    unsigned int s = seed * 2654435761u + 1;
+    for (size_t i = 0; i < n; i++) {
+        s = s * 1103515245u + 12345u;
+        p[i] = (uint8_t)(s >> 16);
+    }
+}
+
+static const cc_impl_t simd_impls[] = { CC_IMPL_SSE2, CC_IMPL_AVX2, CC_IMPL_NEON };
+
+// ===== 1) 정확도 =====
+
+static void verify_exact(void)
+{
+    static const int sizes[][4] = {
+        { 1920, 1080, 640, 360 },       // 2:1 한 번 + 행 복사
+        { 1920, 1080, 480, 270 },       // 2:1 두 번
+        { 1280, 720, 426, 240 },        // 2:1 + 최근접
+        { 1282, 722, 300, 170 },        // 홀수 매크로픽셀 / 남는 행
+        { 646, 482, 160, 120 },
+        { 640, 480, 640, 480 },         // 크기 그대로
+        { 320, 240, 400, 300 },         // 확대
+    };
+    char what[128];
+
+    printf("[정확도] 2:1 SIMD 경로 vs 스칼라\n");
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        int sw = sizes[k][0], sh = sizes[k][1], dw = sizes[k][2], dh = sizes[k][3];
+        int src_stride = sw * 2 + 64;   // stride 가 너비보다 큰 경우
+        int dst_stride = dw * 2 + 32;
+        uint8_t *src = (uint8_t *)malloc((size_t)src_stride * sh);
+        uint8_t *ref = (uint8_t *)malloc((size_t)dst_stride * dh);
+        uint8_t *out = (uint8_t *)malloc((size_t)dst_stride * dh);
+        mos_scaler_t *s = mos_scaler_create(sw, sh, dw, dh);
+        snprintf(what, sizeof(what), "%dx%d -> %dx%d 축소기 생성", sw, sh, dw, dh);
+        check(src && ref && out && s, what);
+        if (!src || !ref || !out || !s) {
+            free(src); free(ref); free(out);
+            mos_scaler_destroy(s);
+            continue;
+        }
+
+        fill_random(src, (size_t)src_stride * sh, (unsigned int)k + 1);
+        mos_scale_yuyv_impl(s, src, src_stride, ref, dst_stride, CC_IMPL_SCALAR);
+        printf("  %4dx%-4d -> %4dx%-4d 2:1 %d 단계:", sw, sh, dw, dh, mos_scaler_levels(s));
+        for (size_t i = 0; i < sizeof(simd_impls) / sizeof(simd_impls[0]); i++) {
+            cc_impl_t impl = simd_impls[i];
+            if (!cc_impl_supported(impl)) continue;
+            memset(out, 0xAA, (size_t)dst_stride * dh);
+            int r = mos_scale_yuyv_impl(s, src, src_stride, out, dst_stride, impl);
+            int same = r == 0;
+            for (int y = 0; same && y < dh; y++)
+                same = memcmp(ref + (size_t)y * dst_stride, out + (size_t)y * dst_stride, (size_t)dw * 2) == 0;
+            printf(" %s %s", cc_impl_name(impl), same ? "일치" : "불일치");
+            snprintf(what, sizeof(what), "%dx%d -> %dx%d %s 가 스칼라와 다름", sw, sh, dw, dh, cc_impl_name(impl));
+            check(same, what);
+        }
+        printf("\n");
+
+        // 단색은 평균을 몇 번 해도 단색
+        for (int y = 0; y < sh; y++) {
+            uint8_t *row = src + (size_t)y * src_stride;
+            for (int x = 0; x < sw; x += 2) {
+                row[x * 2 + 0] = 77;
+                row[x * 2 + 1] = 33;
+                row[x * 2 + 2] = 77;
+                row[x * 2 + 3] = 200;
+            }
+        }
+        mos_scale_yuyv(s, src, src_stride, out, dst_stride);
+        int flat = 1;
+        for (int y = 0; flat && y < dh; y++) {
+            const uint8_t *row = out + (size_t)y * dst_stride;
+            for (int x = 0; flat && x < dw; x += 2)
+                flat = row[x * 2] == 77 && row[x * 2 + 1] == 33 && row[x * 2 + 2] == 77 && row[x * 2 + 3] == 200;
+        }
+        snprintf(what, sizeof(what), "%dx%d -> %dx%d 단색 입력이 단색이 아님", sw, sh, dw, dh);
+        check(flat, what);
+
+        mos_scaler_destroy(s);
+        free(src);
+        free(ref);
+        free(out);
+    }
+}
+
+static void verify_pack(void)
+{
+    // 6x4, 색차 3x4 (4:2:2) / 3x2 (4:2:0) / 없음 (흑백)
+    uint8_t y[4][8], u[4][4], v[4][4];
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 8; c++) y[r][c] = (uint8_t)(r * 16 + c);
+        for (int c = 0; c < 4; c++) {
+            u[r][c] = (uint8_t)(100 + r * 4 + c);
+            v[r][c] = (uint8_t)(200 + r * 4 + c);
+        }
+    }
+    const uint8_t *planes[3] = { &y[0][0], &u[0][0], &v[0][0] };
+    const uint8_t *gray[3] = { &y[0][0], NULL, NULL };
+    const int stride[3] = { 8, 4, 4 };
+    uint8_t out[4][12];
+    int ok422 = 1, ok420 = 1, okgray = 1;
+
+    mos_pack_planar(planes, stride, 6, 4, 3, 4, &out[0][0], 12);
+    for (int r = 0; r < 4; r++)
+        for (int m = 0; m < 3; m++)
+            ok422 &= out[r][m * 4] == y[r][m * 2] && out[r][m * 4 + 1] == u[r][m] &&
+                     out[r][m * 4 + 2] == y[r][m * 2 + 1] && out[r][m * 4 + 3] == v[r][m];
+
+    mos_pack_planar(planes, stride, 6, 4, 3, 2, &out[0][0], 12);
+    for (int r = 0; r < 4; r++)
+        for (int m = 0; m < 3; m++)
+            ok420 &= out[r][m * 4 + 1] == u[r / 2][m] && out[r][m * 4 + 3] == v[r / 2][m];
+
+    mos_pack_planar(gray, stride, 6, 4, 0, 0, &out[0][0], 12);
+    for (int r = 0; r < 4; r++)
+        for (int m = 0; m < 3; m++)
+            okgray &= out[r][m * 4] == y[r][m * 2] && out[r][m * 4 + 1] == 128 && out[r][m * 4 + 3] == 128;
+
+    printf("[정확도] MJPEG 평면 묶기: 4:2:2 %s, 4:2:0 %s, 흑백 %s\n",
+           ok422 ? "일치" : "불일치", ok420 ? "일치" : "불일치", okgray ? "일치" : "불일치");
+    check(ok422 && ok420 && okgray, "MJPEG 평면 → YUYV 묶기");
+}
+
+static void verify_layout(void)
+{
+    int ok = 1;
+    for (int n = 1; n <= MOS_MAX_TILES; n++) {
+        mos_rect_t cell[MOS_MAX_TILES], image;
+        int cols = mos_layout(n, CANVAS_WIDTH, CANVAS_HEIGHT, cell);
+        ok &= cols > 0 && cols * cols >= n;
+        for (int i = 0; ok && i < n; i++) {
+            ok &= cell[i].x >= 0 && cell[i].y >= 0 && !(cell[i].x & 1) && !(cell[i].width & 1) &&
+                  cell[i].x + cell[i].width <= CANVAS_WIDTH && cell[i].y + cell[i].height <= CANVAS_HEIGHT;
+            for (int j = 0; j < i; j++)
+                ok &= cell[i].x >= cell[j].x + cell[j].width || cell[j].x >= cell[i].x + cell[i].width ||
+                      cell[i].y >= cell[j].y + cell[j].height || cell[j].y >= cell[i].y + cell[i].height;
+            // 4:3 영상은 칸 안에 가운데
+            mos_fit(&cell[i], 640, 480, &image);
+            ok &= !(image.x & 1) && !(image.width & 1) && image.x >= cell[i].x && image.y >= cell[i].y &&
+                  image.x + image.width <= cell[i].x + cell[i].width &&
+                  image.y + image.height <= cell[i].y + cell[i].height;
+        }
+    }
+    printf("[정확도] 격자 배치 1~%d 개: %s\n", MOS_MAX_TILES, ok ? "정상" : "겹침/범위 밖");
+    check(ok, "모자이크 격자 배치");
+}
+
+// ===== 2) 축소 비용 =====
+
+static void bench_scale(void)
+{
+    static const int targets[][2] = { { 640, 360 }, { 480, 270 }, { 426, 240 } };
+    int sw = 1920, sh = 1080;
+    uint8_t *src = (uint8_t *)malloc((size_t)sw * sh * 2);
+    uint8_t *dst = (uint8_t *)malloc((size_t)640 * 360 * 2);
+    if (!src || !dst) {
+        free(src);
+        free(dst);
+        return;
+    }
+    fill_random(src, (size_t)sw * sh * 2, 7);
+
+    printf("[비용] 1920x1080 YUYV 한 장 축소 (%d 회 평균)\n", TIMING_ROUNDS);
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+        int dw = targets[t][0], dh = targets[t][1];
+        mos_scaler_t *s = mos_scaler_create(sw, sh, dw, dh);
+        if (!s) continue;
+        printf("  -> %dx%d:", dw, dh);
+        cc_impl_t impls[] = { CC_IMPL_SCALAR, CC_IMPL_SSE2, CC_IMPL_AVX2, CC_IMPL_NEON };
+        for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+            if (!cc_impl_supported(impls[i])) continue;
+            mos_scale_yuyv_impl(s, src, sw * 2, dst, dw * 2, impls[i]);
+            double t0 = now_sec();
+            for (int r = 0; r < TIMING_ROUNDS; r++)
+                mos_scale_yuyv_impl(s, src, sw * 2, dst, dw * 2, impls[i]);
+            printf(" %s %.2f ms", cc_impl_name(impls[i]), (now_sec() - t0) * 1000.0 / TIMING_ROUNDS);
+        }
+        printf("\n");
+        mos_scaler_destroy(s);
+    }
+    free(src);
+    free(dst);
+}
+
+// ===== 3) 동시 캡처 + 합성 =====
+
+typedef struct {
+    unsigned char *data[JPEG_FRAMES];
+    unsigned long size[JPEG_FRAMES];
+} jpeg_clip_t;
+
+// 합성 상자 패턴을 4:2:2 JPEG 로 인코딩해 연결 파일로 쓴다 (프레임은 검증용으로 보관)
+static int make_mjpeg_clip(const char *path, jpeg_clip_t *clip)
+{
+    SyntheticFrameSource syn(JPEG_WIDTH, JPEG_HEIGHT, 2);
+    syn.setPattern(FRAME_PATTERN_BOX);
+    if (syn.start() < 0) return -1;
+
+    unsigned char *bgrx = (unsigned char *)malloc((size_t)JPEG_WIDTH * JPEG_HEIGHT * 4);
+    FILE *fp = fopen(path, "wb");
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+
+    int ok = bgrx && fp;
+    for (int i = 0; ok && i < JPEG_FRAMES; i++) {
+        FrameDesc d;
+        if (syn.dequeue(&d) < 0) {
+            ok = 0;
+            break;
+        }
+        yuyv_convert(d.data, JPEG_WIDTH * 2, bgrx, JPEG_WIDTH * 4, JPEG_WIDTH, JPEG_HEIGHT,
+                     CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_FULL);
+        syn.enqueue(d.index);
+
+        jpeg_mem_dest(&cinfo, &clip->data[i], &clip->size[i]);
+        cinfo.image_width = JPEG_WIDTH;
+        cinfo.image_height = JPEG_HEIGHT;
+        cinfo.input_components = 4;
+        cinfo.in_color_space = JCS_EXT_BGRX;
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, 85, TRUE);
+        // UVC MJPEG 와 같은 4:2:2
+        cinfo.comp_info[0].h_samp_factor = 2;
+        cinfo.comp_info[0].v_samp_factor = 1;
+        jpeg_start_compress(&cinfo, TRUE);
+        while (cinfo.next_scanline < cinfo.image_height) {
+            JSAMPROW row = (JSAMPROW)(bgrx + (size_t)cinfo.next_scanline * JPEG_WIDTH * 4);
+            jpeg_write_scanlines(&cinfo, &row, 1);
+        }
+        jpeg_finish_compress(&cinfo);
+        ok = fwrite(clip->data[i], 1, clip->size[i], fp) == clip->size[i];
+    }
+
+    jpeg_destroy_compress(&cinfo);
+    if (fp) fclose(fp);
+    free(bgrx);
+    return ok ? 0 : -1;
+}
+
+// 합성 소스의 seq 번째 프레임 (페이싱 없이 다시 만든다)
+static int synthetic_frame(int pattern, unsigned int seq, uint8_t *dst)
+{
+    SyntheticFrameSource syn(CAM_WIDTH, CAM_HEIGHT, 2);
+    syn.setPattern(pattern);
+    syn.setRealtime(0);
+    if (syn.start() < 0) return -1;
+    FrameDesc d;
+    while (syn.dequeue(&d) == 0) {
+        if (d.sequence == seq) {
+            memcpy(dst, d.data, d.bytesused);
+            return 0;
+        }
+        syn.enqueue(d.index);
+    }
+    return -1;
+}
+
+// MJPEG 프레임을 캡처 스레드와 같은 경로로 YUYV 원본 크기까지 (디코딩 → 묶기)
+static int jpeg_frame(const unsigned char *jpg, unsigned long len, uint8_t *dst)
+{
+    mjd_info_t info;
+    if (mjd_probe(jpg, len, &info) < 0) return -1;
+    size_t total = 0;
+    for (int c = 0; c < info.components; c++) total += (size_t)info.pad_width[c] * info.pad_height[c];
+    uint8_t *planes = (uint8_t *)malloc(total);
+    mjd_decoder_t *dec = mjd_decoder_create();
+    mjd_image_t img;
+    memset(&img, 0, sizeof(img));
+    int r = -1;
+    if (planes && dec) {
+        size_t off = 0;
+        for (int c = 0; c < info.components; c++) {
+            img.plane[c] = planes + off;
+            img.stride[c] = info.pad_width[c];
+            off += (size_t)info.pad_width[c] * info.pad_height[c];
+        }
+        if (mjd_decode(dec, jpg, len, MJD_OUT_YUV, &img) == 0) {
+            mos_pack_planar(img.plane, img.stride, info.width, info.height,
+                            info.components >= 3 ? info.plane_width[1] : 0,
+                            info.components >= 3 ? info.plane_height[1] : 0, dst, info.width * 2);
+            r = 0;
+        }
+    }
+    if (dec) mjd_decoder_destroy(dec);
+    free(planes);
+    return r;
+}
+
+static void run_mosaic(double seconds)
+{
+    static const int patterns[] = { FRAME_PATTERN_BARS, FRAME_PATTERN_BOX, FRAME_PATTERN_NOISE };
+    static const char *names[] = { "synth-bars", "synth-box", "synth-noise" };
+    char clip_path[64];
+    jpeg_clip_t clip;
+    memset(&clip, 0, sizeof(clip));
+    snprintf(clip_path, sizeof(clip_path), "/tmp/multi_capture_bench_%d.mjpg", (int)getpid());
+
+    printf("[동시 캡처] 합성 YUYV %dx%d@%d x3 + MJPEG 재생 %dx%d@%d x1 → %dx%d 모자이크, %.1f 초\n",
+           CAM_WIDTH, CAM_HEIGHT, CAM_FPS, JPEG_WIDTH, JPEG_HEIGHT, CAM_FPS,
+           CANVAS_WIDTH, CANVAS_HEIGHT, seconds);
+    if (make_mjpeg_clip(clip_path, &clip) < 0) {
+        check(0, "MJPEG 재생 파일 생성");
+        unlink(clip_path);
+        return;
+    }
+
+    MultiCameraCapture *mc = new MultiCameraCapture();
+    for (int i = 0; i < 3; i++) {
+        SyntheticFrameSource *syn = new SyntheticFrameSource(CAM_WIDTH, CAM_HEIGHT, 4);
+        syn->setPattern(patterns[i]);
+        syn->setFrameRate(CAM_FPS);
+        mc->addSource(syn, names[i], i);
+    }
+    FileFrameSource *file = new FileFrameSource(4);
+    file->setFrameRate(CAM_FPS);
+    file->setLoop(1);
+    if (file->open(clip_path, V4L2_PIX_FMT_MJPEG, JPEG_WIDTH, JPEG_HEIGHT) < 0) {
+        delete file;
+        check(0, "MJPEG 재생 파일 열기");
+    } else {
+        mc->addSource(file, "file-mjpeg", 3);
+    }
+
+    int cams = mc->cameraCount();
+    size_t bgrx_stride = (size_t)CANVAS_WIDTH * 4;
+    size_t yuyv_stride = (size_t)CANVAS_WIDTH * 2;
+    uint8_t *bgrx = (uint8_t *)malloc(bgrx_stride * CANVAS_HEIGHT);
+    uint8_t *canvas = (uint8_t *)malloc(yuyv_stride * CANVAS_HEIGHT);
+    check(mc->start(CANVAS_WIDTH, CANVAS_HEIGHT) == 0, "캡처 시작");
+
+    // 화면 갱신처럼 30Hz 로 합성
+    double t0 = now_sec();
+    int frames = 0;
+    while (now_sec() - t0 < seconds) {
+        mc->composite(bgrx, (int)bgrx_stride, CC_FMT_BGRX32);
+        frames++;
+        double next = t0 + frames / 30.0;
+        double wait = next - now_sec();
+        if (wait > 0) usleep((useconds_t)(wait * 1e6));
+    }
+    mc->stop();
+    mc->compositeYUYV(canvas, (int)yuyv_stride);
+    mc->printStats(stdout);
+
+    MultiCaptureStats st;
+    mc->getStats(&st);
+    check(st.cameras == cams && cams == 4, "카메라 4 대 등록");
+    check(st.skew_p50_ms < 1000.0 / CAM_FPS * 4, "타일 간 timestamp 차이가 4 프레임 이상");
+    for (int i = 0; i < st.cameras; i++) {
+        char what[128];
+        snprintf(what, sizeof(what), "%s: 타일이 만들어지지 않음", st.camera[i].label);
+        check(st.camera[i].tiles > 0, what);
+        snprintf(what, sizeof(what), "%s: 디코딩 오류", st.camera[i].label);
+        check(st.camera[i].decode_errors == 0, what);
+    }
+
+    // 마지막 모자이크의 각 타일 = 그 sequence 의 원본을 스칼라로 축소한 것
+    mos_rect_t cell[MOS_MAX_TILES];
+    mos_layout(cams, CANVAS_WIDTH, CANVAS_HEIGHT, cell);
+    uint8_t *frame = (uint8_t *)malloc((size_t)CAM_WIDTH * CAM_HEIGHT * 2);
+    printf("  마지막 모자이크 타일 검증:");
+    for (int i = 0; i < cams && frame; i++) {
+        long long seq = mc->tileSequence(i);
+        int w = i < 3 ? CAM_WIDTH : JPEG_WIDTH;
+        int h = i < 3 ? CAM_HEIGHT : JPEG_HEIGHT;
+        mos_rect_t image;
+        mos_fit(&cell[i], w, h, &image);
+
+        int r = -1;
+        if (seq >= 0) {
+            if (i < 3) r = synthetic_frame(patterns[i], (unsigned int)seq, frame);
+            else r = jpeg_frame(clip.data[seq % JPEG_FRAMES], clip.size[seq % JPEG_FRAMES], frame);
+        }
+        int same = 0;
+        if (r == 0) {
+            int ts = image.width * 2;
+            uint8_t *tile = (uint8_t *)malloc((size_t)ts * image.height);
+            mos_scaler_t *s = mos_scaler_create(w, h, image.width, image.height);
+            if (tile && s && mos_scale_yuyv_impl(s, frame, w * 2, tile, ts, CC_IMPL_SCALAR) == 0) {
+                same = 1;
+                for (int y = 0; same && y < image.height; y++)
+                    same = memcmp(canvas + (size_t)(image.y + y) * yuyv_stride + (size_t)image.x * 2,
+                                  tile + (size_t)y * ts, (size_t)ts) == 0;
+            }
+            mos_scaler_destroy(s);
+            free(tile);
+        }
+        printf(" %s(seq %lld) %s", st.camera[i].label, seq, same ? "일치" : "불일치");
+        char what[128];
+        snprintf(what, sizeof(what), "%s: 모자이크 타일이 원본 축소와 다름", st.camera[i].label);
+        check(same, what);
+    }
+    printf("\n");
+
+    delete mc;
+    free(frame);
+    free(bgrx);
+    free(canvas);
+    for (int i = 0; i < JPEG_FRAMES; i++) free(clip.data[i]);
+    unlink(clip_path);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : RUN_SECONDS;
+    if (seconds <= 0) seconds = RUN_SECONDS;
+
+    printf("최적 축소 경로: %s\n", cc_impl_name(cc_best_impl()));
+    verify_exact();
+    verify_pack();
+    verify_layout();
+    bench_scale();
+    run_mosaic(seconds);
+
+    if (failures) {
+        printf("실패 %d 건\n", failures);
+        return 1;
+    }
+    printf("모두 통과\n");
+    return 0;
+}
@@ -0,0 +1,585 @@
+//----------------------------------------------//
+//	엔드투엔드 캡처 파이프라인 벤치마크			//
+//----------------------------------------------//
+// 사용법: ./pipeline_bench [-n frames] [-o out.json] [-r WxH] [-s yuyv|mjpeg] [-p fps] [-R recording]
+// 카메라 없이 재생 소스(FileFrameSource)로 뷰어/녹화 파이프라인 단계를 돌리고
+// 해상도(webcam_viewer_sdk.cpp getSupportedResolutions() 와 같은 목록) x 소스 포맷마다
+//   처리량, 단계별 지연 p50/p99/p999 (pipeline_metrics 히스토그램, 상대 오차 12.5% 이하),
+//   프레임당 CPU 시간(모든 스레드), 최대 RSS
+// 를 측정해 표로 출력하고 -o 를 주면 회귀 추적용 JSON 으로 쓴다 ("-" 이면 stdout).
+//
+// 파이프라인 (소스 포맷별):
+//   yuyv  : capture → convert(YUYV→BGRX) → encode(BGRX→JPEG, 스냅샷/녹화) → mux(.mjpg + .pts) → display
+//   mjpeg : capture → decode(mjd_pool_decode, 슬라이스) → mux(카메라 JPEG 그대로) → display
+// display 는 X 서버 없이 창 크기 백 버퍼로 복사하는 것 (XShmPutImage 의 서버 쪽 복사에 해당).
+// 재생 클립은 합성 box 패턴 8 프레임을 반복하며, MJPEG 는 UVC 카메라처럼 4:2:2 + 재시작 마커.
+// 실행마다 fork 한 자식 프로세스에서 돌리므로 RSS / CPU 가 서로 섞이지 않는다.
+// 기본은 페이싱 없음 (-p 로 카메라 속도 재생). 프레임 수가 모자라거나 디코딩 오류가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <jpeglib.h>
+#include "frame_source.h"
+#include "color_convert.h"
+#include "mjpeg_decode.h"
+#include "pipeline_metrics.h"
+
+#define CLIP_FRAMES         8
+#define DEFAULT_FRAMES      60
+#define JPEG_QUALITY        80
+#define MAX_RESOLUTIONS     8
+#define RESULT_JSON_MAX     4096
+
+enum {
+    ST_CAPTURE = 0,
+    ST_DECODE,
+    ST_CONVERT,
+    ST_ENCODE,
+    ST_MUX,
+    ST_DISPLAY,
+    ST_E2E,                 // 프레임 timestamp → display 완료
+    ST_COUNT
+};
+
+static const char *stage_names[ST_COUNT] = {
+    "capture", "decode", "convert", "encode", "mux", "display", "e2e"
+};
+
+// webcam_viewer_sdk.cpp 의 getSupportedResolutions()
+static const int supported_resolutions[][2] = {
+    {320, 240}, {640, 480}, {800, 600}, {1024, 768}, {1280, 720}, {1920, 1080}
+};
+
+typedef struct {
+    int frames;
+    int pace_fps;           // 0 이면 페이싱 없음
+    int workers;            // MJPEG 디코더 풀 워커
+    char dir[64];           // 클립 / 녹화 임시 디렉터리
+} bench_opts_t;
+
+typedef struct {
+    int width;
+    int height;
+    unsigned int pixfmt;
+    const char *path;       // 재생 파일
+    const char *name;       // "yuyv" / "mjpeg" / 녹화 파일 이름
+} bench_run_t;
+
+// ===== 재생 클립 생성 =====
+
+static int encode_jpeg(struct jpeg_compress_struct *cinfo, const unsigned char *bgrx, int w, int h,
+                       int restart_rows, unsigned char **out, unsigned long *out_len)
+{
+    jpeg_mem_dest(cinfo, out, out_len);
+    cinfo->image_width = w;
+    cinfo->image_height = h;
+    cinfo->input_components = 4;
+    cinfo->in_color_space = JCS_EXT_BGRX;
+    jpeg_set_defaults(cinfo);
+    jpeg_set_quality(cinfo, JPEG_QUALITY, TRUE);
+    // UVC MJPEG 와 같은 4:2:2
+    cinfo->comp_info[0].h_samp_factor = 2;
+    cinfo->comp_info[0].v_samp_factor = 1;
+    cinfo->restart_in_rows = restart_rows;
+    jpeg_start_compress(cinfo, TRUE);
+    while (cinfo->next_scanline < cinfo->image_height) {
+        JSAMPROW row = (JSAMPROW)(bgrx + (size_t)cinfo->next_scanline * w * 4);
+        jpeg_write_scanlines(cinfo, &row, 1);
+    }
+    jpeg_finish_compress(cinfo);
+    return 0;
+}
+
+// 합성 box 패턴 CLIP_FRAMES 장을 raw YUYV 와 MJPEG 연결 파일로 쓴다
+static int make_clips(int w, int h, const char *yuyv_path, const char *mjpeg_path)
+{
+    SyntheticFrameSource syn(w, h, 2);
+    syn.setPattern(FRAME_PATTERN_BOX);
+    if (syn.start() < 0) return -1;
+
+    unsigned char *bgrx = (unsigned char *)malloc((size_t)w * h * 4);
+    FILE *fy = fopen(yuyv_path, "wb");
+    FILE *fm = fopen(mjpeg_path, "wb");
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+
+    int ok = bgrx && fy && fm;
+    for (int i = 0; ok && i < CLIP_FRAMES; i++) {
+        FrameDesc d;
+        if (syn.dequeue(&d) < 0) {
+            ok = 0;
+            break;
+        }
+        ok = fwrite(d.data, 1, d.bytesused, fy) == d.bytesused;
+        yuyv_convert(d.data, w * 2, bgrx, w * 4, w, h, CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_FULL);
+        syn.enqueue(d.index);
+
+        unsigned char *jpg = NULL;
+        unsigned long len = 0;
+        encode_jpeg(&cinfo, bgrx, w, h, 1, &jpg, &len);
+        if (ok) ok = fwrite(jpg, 1, len, fm) == len;
+        free(jpg);
+    }
+
+    jpeg_destroy_compress(&cinfo);
+    if (fy) fclose(fy);
+    if (fm) fclose(fm);
+    free(bgrx);
+    return ok ? 0 : -1;
+}
+
+// ===== 파이프라인 실행 (자식 프로세스) =====
+
+static uint64_t timeval_ns(const struct timeval *tv)
+{
+    return (uint64_t)tv->tv_sec * 1000000000ULL + (uint64_t)tv->tv_usec * 1000ULL;
+}
+
+static long read_status_kb(const char *key)
+{
+    char line[128];
+    long kb = -1;
+    size_t n = strlen(key);
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp) return -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (!strncmp(line, key, n)) {
+            kb = atol(line + n);
+            break;
+        }
+    }
+    fclose(fp);
+    return kb;
+}
+
+static int append(char *buf, size_t size, int len, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static int append(char *buf, size_t size, int len, const char *fmt, ...)
+{
+    va_list ap;
+    if (len < 0 || (size_t)len >= size) return len;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf + len, size - len, fmt, ap);
+    va_end(ap);
+    return n < 0 ? -1 : len + n;
+}
+
+// 결과 JSON 객체 하나를 out 에 쓴다. 실패 -1
+static int run_pipeline(const bench_run_t *run, const bench_opts_t *opts, char *out, size_t out_size)
+{
+    // fork 시 부모에게서 물려받은 최대 RSS 를 현재 값으로 되돌린다 (Linux 4.0+)
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd >= 0) {
+        if (write(fd, "5", 1) < 0) {
+            // 지원하지 않는 커널: 부모 RSS 가 포함된 값이 나온다
+        }
+        close(fd);
+    }
+
+    FileFrameSource src(4);
+    src.setLoop(1);
+    if (opts->pace_fps > 0) {
+        src.setFrameRate(opts->pace_fps);
+    } else {
+        src.setRealtime(0);
+    }
+    if (src.open(run->path, run->pixfmt, run->width, run->height) < 0 || src.start() < 0) return -1;
+
+    int w = src.width(), h = src.height();
+    unsigned int pixfmt = src.pixelFormat();
+    if (w <= 0 || h <= 0 || (pixfmt != V4L2_PIX_FMT_YUYV && pixfmt != V4L2_PIX_FMT_MJPEG)) {
+        fprintf(stderr, "%s: YUYV / MJPEG 재생만 측정할 수 있음\n", run->path);
+        return -1;
+    }
+
+    size_t frame_bytes = (size_t)w * h * 4;
+    unsigned char *bgrx = (unsigned char *)malloc(frame_bytes);
+    unsigned char *window = (unsigned char *)malloc(frame_bytes);
+    unsigned char *jpg = NULL;
+    unsigned long jpg_len = 0;
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    mjd_pool_t *pool = NULL;
+    pm_hist_t *stages = (pm_hist_t *)calloc(ST_COUNT, sizeof(pm_hist_t));
+
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    if (pixfmt == V4L2_PIX_FMT_MJPEG) pool = mjd_pool_create(opts->workers, 1);
+
+    char rec_path[96], pts_path[104];
+    snprintf(rec_path, sizeof(rec_path), "%s/rec-%dx%d-%s.mjpg", opts->dir, w, h, run->name);
+    snprintf(pts_path, sizeof(pts_path), "%s.pts", rec_path);
+    int rec_fd = open(rec_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    FILE *pts_fp = fopen(pts_path, "w");
+
+    if (!bgrx || !window || !stages || !pts_fp || rec_fd < 0 ||
+        (pixfmt == V4L2_PIX_FMT_MJPEG && !pool)) {
+        fprintf(stderr, "%s: 자원 할당 실패\n", run->name);
+        return -1;
+    }
+    // 첫 프레임의 페이지 폴트가 display 단계에 섞이지 않게
+    memset(window, 0, frame_bytes);
+
+    mjd_image_t img;
+    memset(&img, 0, sizeof(img));
+    img.plane[0] = bgrx;
+    img.stride[0] = w * 4;
+
+    struct rusage ru0, ru1;
+    getrusage(RUSAGE_SELF, &ru0);
+    uint64_t start = pm_now_ns();
+    int frames = 0, errors = 0;
+
+    while (frames < opts->frames) {
+        uint64_t t0 = pm_now_ns();
+        FrameDesc d;
+        while (src.dequeue(&d) < 0) {
+            if (errno != EAGAIN) {
+                errors++;
+                goto done;
+            }
+            struct pollfd pfd;
+            pfd.fd = src.fd();
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, 100);
+        }
+        uint64_t t1 = pm_now_ns();
+        pm_hist_record(&stages[ST_CAPTURE], t1 - t0);
+
+        const unsigned char *mux_data;
+        unsigned long mux_len;
+        if (pixfmt == V4L2_PIX_FMT_MJPEG) {
+            if (mjd_pool_decode(pool, d.data, d.bytesused, MJD_OUT_BGRX32, &img) < 0) errors++;
+            uint64_t t2 = pm_now_ns();
+            pm_hist_record(&stages[ST_DECODE], t2 - t1);
+            mux_data = d.data;
+            mux_len = d.bytesused;
+            t1 = t2;
+        } else {
+            yuyv_convert(d.data, w * 2, bgrx, w * 4, w, h, CC_FMT_BGRX32, CC_MATRIX_BT601, CC_RANGE_FULL);
+            uint64_t t2 = pm_now_ns();
+            pm_hist_record(&stages[ST_CONVERT], t2 - t1);
+            encode_jpeg(&cinfo, bgrx, w, h, 0, &jpg, &jpg_len);
+            uint64_t t3 = pm_now_ns();
+            pm_hist_record(&stages[ST_ENCODE], t3 - t2);
+            mux_data = jpg;
+            mux_len = jpg_len;
+            t1 = t3;
+        }
+
+        // 녹화: TestAP raw 녹화와 같은 JPEG 연결 + timestamp format v2
+        if (write(rec_fd, mux_data, mux_len) != (ssize_t)mux_len) errors++;
+        fprintf(pts_fp, "%.3f\n", timeval_ns(&d.timestamp) / 1e6);
+        uint64_t t2 = pm_now_ns();
+        pm_hist_record(&stages[ST_MUX], t2 - t1);
+
+        for (int y = 0; y < h; y++) {
+            memcpy(window + (size_t)y * w * 4, bgrx + (size_t)y * w * 4, (size_t)w * 4);
+        }
+        uint64_t t3 = pm_now_ns();
+        pm_hist_record(&stages[ST_DISPLAY], t3 - t2);
+        pm_hist_record(&stages[ST_E2E], t3 - timeval_ns(&d.timestamp));
+
+        src.enqueue(d.index);
+        frames++;
+    }
+done:
+    uint64_t elapsed = pm_now_ns() - start;
+    getrusage(RUSAGE_SELF, &ru1);
+
+    if (pool) {
+        mjd_pool_stats_t st;
+        mjd_pool_get_stats(pool, &st);
+        errors += (int)st.errors;
+        mjd_pool_destroy(pool);
+    }
+    jpeg_destroy_compress(&cinfo);
+    fclose(pts_fp);
+    close(rec_fd);
+    unlink(rec_path);
+    unlink(pts_path);
+
+    double cpu_us = (ru1.ru_utime.tv_sec - ru0.ru_utime.tv_sec) * 1e6 + (ru1.ru_utime.tv_usec - ru0.ru_utime.tv_usec) +
+                    (ru1.ru_stime.tv_sec - ru0.ru_stime.tv_sec) * 1e6 + (ru1.ru_stime.tv_usec - ru0.ru_stime.tv_usec);
+    long peak_kb = read_status_kb("VmHWM:");
+    if (peak_kb < 0) peak_kb = ru1.ru_maxrss;
+    double seconds = elapsed / 1e9;
+
+    int len = 0;
+    len = append(out, out_size, len,
+                 "{\"resolution\":\"%dx%d\",\"width\":%d,\"height\":%d,\"source\":\"%s\",\"frames\":%d,"
+                 "\"errors\":%d,\"seconds\":%.4f,\"fps\":%.2f,\"cpu_ms_per_frame\":%.4f,\"cpu_util\":%.3f,"
+                 "\"peak_rss_kb\":%ld,\"stages\":{",
+                 w, h, w, h, run->name, frames, errors, seconds, frames / (seconds > 0 ? seconds : 1),
+                 frames ? cpu_us / 1e3 / frames : 0.0, seconds > 0 ? cpu_us / 1e6 / seconds : 0.0, peak_kb);
+    int first = 1;
+    for (int s = 0; s < ST_COUNT; s++) {
+        const pm_hist_t *hs = &stages[s];
+        if (!hs->count) continue;
+        len = append(out, out_size, len,
+                     "%s\"%s\":{\"count\":%llu,\"mean_us\":%.2f,\"p50_us\":%.2f,\"p99_us\":%.2f,"
+                     "\"p999_us\":%.2f,\"max_us\":%.2f}",
+                     first ? "" : ",", stage_names[s], (unsigned long long)hs->count,
+                     hs->sum_ns / 1e3 / hs->count, pm_hist_percentile(hs, 0.50) / 1e3,
+                     pm_hist_percentile(hs, 0.99) / 1e3, pm_hist_percentile(hs, 0.999) / 1e3,
+                     hs->max_ns / 1e3);
+        first = 0;
+    }
+    len = append(out, out_size, len, "}}");
+
+    free(stages);
+    free(jpg);
+    free(bgrx);
+    free(window);
+    if (len < 0 || (size_t)len >= out_size) return -1;
+    return (frames == opts->frames && errors == 0) ? 0 : -1;
+}
+
+// 자식 프로세스에서 실행하고 결과 JSON 을 파이프로 받는다
+static int run_isolated(const bench_run_t *run, const bench_opts_t *opts, char *out, size_t out_size)
+{
+    int fds[2];
+    if (pipe(fds) < 0) return -1;
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        static char buf[RESULT_JSON_MAX];
+        int rc = run_pipeline(run, opts, buf, sizeof(buf));
+        size_t n = strnlen(buf, sizeof(buf));
+        if (rc == 0 && write(fds[1], buf, n) != (ssize_t)n) rc = -1;
+        close(fds[1]);
+        _exit(rc == 0 ? 0 : 1);
+    }
+
+    close(fds[1]);
+    size_t got = 0;
+    for (;;) {
+        ssize_t r = read(fds[0], out + got, out_size - 1 - got);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += r;
+        if (got >= out_size - 1) break;
+    }
+    out[got] = '\0';
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0 && got > 0) ? 0 : -1;
+}
+
+// 결과 JSON 에서 숫자 하나 (표 출력용, 단순 검색)
+static double json_number(const char *json, const char *stage, const char *key)
+{
+    const char *p = json;
+    char pat[48];
+    if (stage) {
+        snprintf(pat, sizeof(pat), "\"%s\":{", stage);
+        p = strstr(json, pat);
+        if (!p) return -1;
+    }
+    snprintf(pat, sizeof(pat), "\"%s\":", key);
+    p = strstr(p, pat);
+    return p ? atof(p + strlen(pat)) : -1;
+}
+
+static void print_row(const char *json)
+{
+    static const int shown[] = { ST_CAPTURE, ST_DECODE, ST_CONVERT, ST_ENCODE, ST_MUX, ST_DISPLAY, ST_E2E };
+    const char *res = strstr(json, "\"resolution\":\"");
+    const char *src = strstr(json, "\"source\":\"");
+    char res_s[16] = "", src_s[16] = "";
+    if (res) sscanf(res + 14, "%15[^\"]", res_s);
+    if (src) sscanf(src + 10, "%15[^\"]", src_s);
+
+    printf("%-10s %-6s %8.1f %8.2f %8ld", res_s, src_s, json_number(json, NULL, "fps"),
+           json_number(json, NULL, "cpu_ms_per_frame"), (long)json_number(json, NULL, "peak_rss_kb") / 1024);
+    for (size_t i = 0; i < sizeof(shown) / sizeof(shown[0]); i++) {
+        double p50 = json_number(json, stage_names[shown[i]], "p50_us");
+        double p99 = json_number(json, stage_names[shown[i]], "p99_us");
+        if (p50 < 0) {
+            printf(" %15s", "-");
+        } else {
+            printf(" %7.2f/%-7.2f", p50 / 1e3, p99 / 1e3);
+        }
+    }
+    printf("\n");
+}
+
+static void usage(const char *prog)
+{
+    printf("사용법: %s [-n frames] [-o out.json|-] [-r WxH] [-s yuyv|mjpeg] [-p fps] [-w workers] [-R recording]\n", prog);
+    printf("  -n  실행마다 측정할 프레임 수 (기본 %d)\n", DEFAULT_FRAMES);
+    printf("  -o  결과 JSON 경로 (- 이면 stdout)\n");
+    printf("  -r  해상도 하나만 (기본: 지원 해상도 전체)\n");
+    printf("  -s  소스 포맷 하나만\n");
+    printf("  -p  카메라처럼 fps 로 페이싱 (기본: 가능한 한 빠르게)\n");
+    printf("  -w  MJPEG 디코더 워커 수 (기본: 코어 수 - 1, 뷰어와 같음)\n");
+    printf("  -R  합성 클립 대신 녹화 파일 (MJPEG 연결 / raw YUYV 는 -r 필요)\n");
+}
+
+int main(int argc, char **argv)
+{
+    bench_opts_t opts;
+    const char *json_path = NULL;
+    const char *recording = NULL;
+    const char *only_source = NULL;
+    int only_w = 0, only_h = 0;
+    int opt;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.frames = DEFAULT_FRAMES;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    opts.workers = cores > 1 ? (int)cores - 1 : 0;
+
+    while ((opt = getopt(argc, argv, "n:o:r:s:p:w:R:?")) != -1) {
+        switch (opt) {
+            case 'n': opts.frames = atoi(optarg); break;
+            case 'o': json_path = optarg; break;
+            case 'r':
+                if (sscanf(optarg, "%dx%d", &only_w, &only_h) != 2) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 's': only_source = optarg; break;
+            case 'p': opts.pace_fps = atoi(optarg); break;
+            case 'w': opts.workers = atoi(optarg); break;
+            case 'R': recording = optarg; break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (opts.frames <= 0 || opts.workers < 0 || opts.workers > MJD_MAX_WORKERS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    strcpy(opts.dir, "/tmp/pipeline_bench.XXXXXX");
+    if (!mkdtemp(opts.dir)) {
+        printf("임시 디렉터리 생성 실패\n");
+        return 1;
+    }
+
+    bench_run_t runs[MAX_RESOLUTIONS * 2 + 1];
+    char paths[MAX_RESOLUTIONS * 2][96];
+    int nruns = 0;
+    if (recording) {
+        runs[0].width = only_w;
+        runs[0].height = only_h;
+        runs[0].pixfmt = 0;
+        runs[0].path = recording;
+        runs[0].name = "replay";
+        nruns = 1;
+    } else {
+        for (size_t i = 0; i < sizeof(supported_resolutions) / sizeof(supported_resolutions[0]); i++) {
+            int w = supported_resolutions[i][0], h = supported_resolutions[i][1];
+            if (only_w && (w != only_w || h != only_h)) continue;
+            char *yuyv = paths[i * 2];
+            char *mjpeg = paths[i * 2 + 1];
+            snprintf(yuyv, 96, "%s/clip-%dx%d.yuyv", opts.dir, w, h);
+            snprintf(mjpeg, 96, "%s/clip-%dx%d.mjpg", opts.dir, w, h);
+            if (make_clips(w, h, yuyv, mjpeg) < 0) {
+                printf("%dx%d 재생 클립 생성 실패\n", w, h);
+                return 1;
+            }
+            static const char *names[2] = { "yuyv", "mjpeg" };
+            static const unsigned int fmts[2] = { V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_MJPEG };
+            for (int k = 0; k < 2; k++) {
+                if (only_source && strcmp(only_source, names[k])) continue;
+                runs[nruns].width = w;
+                runs[nruns].height = h;
+                runs[nruns].pixfmt = fmts[k];
+                runs[nruns].path = k ? mjpeg : yuyv;
+                runs[nruns].name = names[k];
+                nruns++;
+            }
+        }
+    }
+    if (nruns == 0) {
+        printf("측정할 해상도 / 소스가 없음\n");
+        rmdir(opts.dir);
+        return 2;
+    }
+
+    printf("=== 파이프라인 벤치마크 (%d 프레임/실행, %s, MJPEG 워커 %d, 색변환 %s) ===\n", opts.frames,
+           opts.pace_fps ? "페이싱" : "페이싱 없음", opts.workers, cc_impl_name(cc_best_impl()));
+    printf("%-10s %-6s %8s %8s %8s %15s %15s %15s %15s %15s %15s %15s\n", "해상도", "소스", "fps", "cpu ms",
+           "RSS MB", "capture p50/99", "decode", "convert", "encode", "mux", "display", "e2e (ms)");
+
+    static char results[MAX_RESOLUTIONS * 2 + 1][RESULT_JSON_MAX];
+    int failed = 0;
+    for (int i = 0; i < nruns; i++) {
+        if (run_isolated(&runs[i], &opts, results[i], sizeof(results[i])) < 0) {
+            printf("%dx%d %s: 실행 실패\n", runs[i].width, runs[i].height, runs[i].name);
+            results[i][0] = '\0';
+            failed++;
+            continue;
+        }
+        print_row(results[i]);
+    }
+
+    // 임시 파일 정리
+    if (!recording) {
+        for (size_t i = 0; i < sizeof(supported_resolutions) / sizeof(supported_resolutions[0]); i++) {
+            char p[96];
+            snprintf(p, sizeof(p), "%s/clip-%dx%d.yuyv", opts.dir, supported_resolutions[i][0], supported_resolutions[i][1]);
+            unlink(p);
+            snprintf(p, sizeof(p), "%s/clip-%dx%d.mjpg", opts.dir, supported_resolutions[i][0], supported_resolutions[i][1]);
+            unlink(p);
+        }
+    }
+    rmdir(opts.dir);
+
+    if (json_path) {
+        FILE *fp = strcmp(json_path, "-") ? fopen(json_path, "w") : stdout;
+        if (!fp) {
+            printf("JSON 쓰기 실패: %s\n", json_path);
+            return 1;
+        }
+        struct utsname un;
+        uname(&un);
+        fprintf(fp, "{\"benchmark\":\"pipeline\",\"version\":1,\"time\":%ld,\"host\":{\"machine\":\"%s\","
+                "\"kernel\":\"%s\",\"cpus\":%ld,\"convert_impl\":\"%s\"},\"frames_per_run\":%d,\"paced_fps\":%d,"
+                "\"mjpeg_workers\":%d,\"runs\":[",
+                (long)time(NULL), un.machine, un.release, cores, cc_impl_name(cc_best_impl()), opts.frames,
+                opts.pace_fps, opts.workers);
+        int first = 1;
+        for (int i = 0; i < nruns; i++) {
+            if (!results[i][0]) continue;
+            fprintf(fp, "%s\n%s", first ? "" : ",", results[i]);
+            first = 0;
+        }
+        fprintf(fp, "\n]}\n");
+        if (fp != stdout) {
+            fclose(fp);
+            printf("JSON: %s\n", json_path);
+        }
+    }
+
+    printf("검증: %s\n", failed ? "실패한 실행 있음" : "모든 실행 완료 (프레임 수 / 디코딩 오류 없음)");
+    return failed ? 1 : 0;
+}
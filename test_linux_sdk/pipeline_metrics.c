@@ -0,0 +1,266 @@
+//----------------------------------------------//
+//	캡처 파이프라인 메트릭 (lock-free 카운터)	//
+//----------------------------------------------//
+
+#include <string.h>
+#include "pipeline_metrics.h"
+
+#define PM_HIST_SUB_COUNT   (1 << PM_HIST_SUB_BITS)
+#define PM_HIST_SUB_MASK    (PM_HIST_SUB_COUNT - 1)
+
+#define PM_LOAD(p)          __atomic_load_n((p), __ATOMIC_RELAXED)
+#define PM_ADD(p, v)        __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+
+static const char *pm_stage_names[PM_STAGE_COUNT] = {
+    "dqbuf_wait", "convert", "draw", "qbuf", "glass_to_glass"
+};
+
+void pm_init(pipeline_metrics_t *m)
+{
+    if (!m)
+        return;
+    memset(m, 0, sizeof(*m));
+    m->start_ns = pm_now_ns();
+}
+
+int pm_hist_bucket(uint64_t ns)
+{
+    int e, bucket;
+
+    if (ns < PM_HIST_SUB_COUNT)
+        return (int)ns;
+
+    e = 63 - __builtin_clzll(ns);
+    bucket = ((e - PM_HIST_SUB_BITS + 1) << PM_HIST_SUB_BITS) +
+             (int)((ns >> (e - PM_HIST_SUB_BITS)) & PM_HIST_SUB_MASK);
+    return bucket < PM_HIST_BUCKETS ? bucket : PM_HIST_BUCKETS - 1;
+}
+
+uint64_t pm_hist_bucket_floor(int bucket)
+{
+    int e;
+
+    if (bucket < PM_HIST_SUB_COUNT)
+        return (uint64_t)bucket;
+
+    e = (bucket >> PM_HIST_SUB_BITS) + PM_HIST_SUB_BITS - 1;
+    return (1ULL << e) | ((uint64_t)(bucket & PM_HIST_SUB_MASK) << (e - PM_HIST_SUB_BITS));
+}
+
+static uint64_t pm_hist_bucket_width(int bucket)
+{
+    if (bucket < PM_HIST_SUB_COUNT)
+        return 1;
+    return 1ULL << ((bucket >> PM_HIST_SUB_BITS) - 1);
+}
+
+void pm_record(pipeline_metrics_t *m, pm_stage_t stage, uint64_t ns)
+{
+    if (!m || (int)stage < 0 || (int)stage >= PM_STAGE_COUNT)
+        return;
+
+    pm_hist_record(&m->stages[stage], ns);
+}
+
+void pm_hist_record(pm_hist_t *h, uint64_t ns)
+{
+    uint64_t max;
+
+    PM_ADD(&h->buckets[pm_hist_bucket(ns)], 1);
+    PM_ADD(&h->sum_ns, ns);
+    PM_ADD(&h->count, 1);
+
+    max = PM_LOAD(&h->max_ns);
+    while (ns > max &&
+           !__atomic_compare_exchange_n(&h->max_ns, &max, ns, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // 실패하면 max 가 현재 값으로 갱신된다
+    }
+}
+
+void pm_frame(pipeline_metrics_t *m, uint32_t sequence)
+{
+    uint64_t slot;
+    int i;
+
+    if (!m)
+        return;
+
+    PM_ADD(&m->frames, 1);
+
+    if (m->has_sequence) {
+        uint32_t diff = sequence - m->last_sequence;
+        if (diff >= 1 && diff <= 0x7FFFFFFFu)
+            PM_ADD(&m->seq_drops, diff - 1);
+        else if (diff != 0)
+            PM_ADD(&m->seq_restarts, 1);
+    }
+    m->last_sequence = sequence;
+    m->has_sequence = 1;
+
+    // 새 슬롯이면 카운트를 먼저 비우고 epoch 를 게시한다
+    slot = (pm_now_ns() - m->start_ns) / PM_FPS_SLOT_NS + 1;
+    i = (int)(slot % PM_FPS_SLOTS);
+    if (__atomic_load_n(&m->fps_epoch[i], __ATOMIC_RELAXED) != slot) {
+        __atomic_store_n(&m->fps_count[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&m->fps_epoch[i], slot, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&m->fps_count[i], PM_LOAD(&m->fps_count[i]) + 1, __ATOMIC_RELAXED);
+}
+
+void pm_display_drop(pipeline_metrics_t *m)
+{
+    if (m)
+        PM_ADD(&m->display_drops, 1);
+}
+
+uint64_t pm_dropped(const pipeline_metrics_t *m)
+{
+    if (!m)
+        return 0;
+    return PM_LOAD(&m->seq_drops) + PM_LOAD(&m->display_drops);
+}
+
+uint64_t pm_frames(const pipeline_metrics_t *m)
+{
+    if (!m)
+        return 0;
+    return PM_LOAD(&m->frames);
+}
+
+uint64_t pm_hist_percentile(const pm_hist_t *h, double q)
+{
+    uint64_t total = 0, target, seen = 0;
+    uint64_t counts[PM_HIST_BUCKETS];
+    uint64_t max = PM_LOAD(&h->max_ns);
+    int i;
+
+    for (i = 0; i < PM_HIST_BUCKETS; i++) {
+        counts[i] = PM_LOAD(&h->buckets[i]);
+        total += counts[i];
+    }
+    if (total == 0)
+        return 0;
+
+    target = (uint64_t)(q * total + 0.5);
+    if (target < 1)
+        target = 1;
+    if (target > total)
+        target = total;
+
+    for (i = 0; i < PM_HIST_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            uint64_t mid = pm_hist_bucket_floor(i) + pm_hist_bucket_width(i) / 2;
+            return mid < max ? mid : max;
+        }
+    }
+    return max;
+}
+
+double pm_fps_window(const pipeline_metrics_t *m)
+{
+    uint64_t now, elapsed, slot, window_frames = 0, window_ns;
+    int i;
+
+    if (!m)
+        return 0.0;
+
+    now = pm_now_ns();
+    elapsed = now - m->start_ns;
+
+    // 현재 슬롯을 포함한 최근 PM_FPS_SLOTS 개 슬롯
+    slot = elapsed / PM_FPS_SLOT_NS + 1;
+    for (i = 0; i < PM_FPS_SLOTS; i++) {
+        uint64_t epoch = __atomic_load_n(&m->fps_epoch[i], __ATOMIC_ACQUIRE);
+        if (epoch + PM_FPS_SLOTS > slot && epoch <= slot)
+            window_frames += PM_LOAD(&m->fps_count[i]);
+    }
+    window_ns = (PM_FPS_SLOTS - 1) * PM_FPS_SLOT_NS + elapsed % PM_FPS_SLOT_NS;
+    if (window_ns > elapsed)
+        window_ns = elapsed;
+    return window_ns ? window_frames * 1e9 / window_ns : 0.0;
+}
+
+void pm_snapshot(const pipeline_metrics_t *m, pm_snapshot_t *snap)
+{
+    uint64_t now = pm_now_ns();
+    int i;
+
+    memset(snap, 0, sizeof(*snap));
+    if (!m)
+        return;
+
+    snap->uptime_s = (now - m->start_ns) / 1e9;
+    snap->frames = PM_LOAD(&m->frames);
+    snap->seq_drops = PM_LOAD(&m->seq_drops);
+    snap->display_drops = PM_LOAD(&m->display_drops);
+    snap->seq_restarts = PM_LOAD(&m->seq_restarts);
+    if (snap->uptime_s > 0)
+        snap->fps_avg = snap->frames / snap->uptime_s;
+
+    snap->fps_window = pm_fps_window(m);
+
+    for (i = 0; i < PM_STAGE_COUNT; i++) {
+        const pm_hist_t *h = &m->stages[i];
+        pm_stage_summary_t *s = &snap->stages[i];
+
+        s->count = PM_LOAD(&h->count);
+        if (!s->count)
+            continue;
+        s->mean_us = PM_LOAD(&h->sum_ns) / 1000.0 / s->count;
+        s->p50_us = pm_hist_percentile(h, 0.50) / 1000.0;
+        s->p90_us = pm_hist_percentile(h, 0.90) / 1000.0;
+        s->p99_us = pm_hist_percentile(h, 0.99) / 1000.0;
+        s->max_us = PM_LOAD(&h->max_ns) / 1000.0;
+    }
+}
+
+const char *pm_stage_name(pm_stage_t stage)
+{
+    if ((int)stage < 0 || (int)stage >= PM_STAGE_COUNT)
+        return "unknown";
+    return pm_stage_names[stage];
+}
+
+int pm_snapshot_json(const pm_snapshot_t *snap, char *buf, size_t size)
+{
+    size_t len = 0;
+    int n, i;
+
+#define PM_APPEND(...) \
+    do { \
+        n = snprintf(buf + (len < size ? len : size), len < size ? size - len : 0, __VA_ARGS__); \
+        if (n < 0) return -1; \
+        len += (size_t)n; \
+    } while (0)
+
+    PM_APPEND("{\"uptime_s\":%.3f,\"frames\":%llu,\"seq_drops\":%llu,\"display_drops\":%llu,"
+              "\"seq_restarts\":%llu,\"fps_window\":%.2f,\"fps_avg\":%.2f,\"stages\":{",
+              snap->uptime_s, (unsigned long long)snap->frames,
+              (unsigned long long)snap->seq_drops, (unsigned long long)snap->display_drops,
+              (unsigned long long)snap->seq_restarts, snap->fps_window, snap->fps_avg);
+
+    for (i = 0; i < PM_STAGE_COUNT; i++) {
+        const pm_stage_summary_t *s = &snap->stages[i];
+        PM_APPEND("%s\"%s\":{\"count\":%llu,\"mean_us\":%.1f,\"p50_us\":%.1f,"
+                  "\"p90_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f}",
+                  i ? "," : "", pm_stage_name((pm_stage_t)i), (unsigned long long)s->count,
+                  s->mean_us, s->p50_us, s->p90_us, s->p99_us, s->max_us);
+    }
+    PM_APPEND("}}");
+
+#undef PM_APPEND
+    return (int)len;
+}
+
+void pm_dump_json(const pipeline_metrics_t *m, FILE *fp)
+{
+    pm_snapshot_t snap;
+    char buf[1024];
+
+    pm_snapshot(m, &snap);
+    if (pm_snapshot_json(&snap, buf, sizeof(buf)) < 0)
+        return;
+    fprintf(fp, "%s\n", buf);
+    fflush(fp);
+}
@@ -0,0 +1,139 @@
+#ifndef PIPELINE_METRICS_H
+#define PIPELINE_METRICS_H
+
+// 캡처 파이프라인 메트릭
+// - 단계별 지연 히스토그램 (HDR 방식 로그 버킷: 2 의 거듭제곱 구간을 8 등분, 상대 오차 12.5% 이하)
+// - v4l2_buffer.sequence 간격으로 드롭 감지
+// - 슬라이딩 윈도우 FPS
+// 기록 함수는 GCC __atomic 내장 함수만 사용하므로 락 없이 여러 스레드에서 호출할 수 있다.
+// (pm_frame 은 프레임 순서를 보는 단일 스레드(캡처)에서만 호출)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 측정 단계
+typedef enum {
+    PM_STAGE_DQBUF_WAIT = 0,    // 프레임 대기 (poll + VIDIOC_DQBUF)
+    PM_STAGE_CONVERT,           // 색변환 / H.264 헤더 파싱
+    PM_STAGE_DRAW,              // 화면 출력 (XShmPutImage 등)
+    PM_STAGE_QBUF,              // VIDIOC_QBUF
+    PM_STAGE_E2E,               // 프레임 timestamp → 화면 출력 완료 (glass-to-glass)
+    PM_STAGE_COUNT
+} pm_stage_t;
+
+#define PM_HIST_SUB_BITS    3
+#define PM_HIST_MAX_BITS    40      // 2^40 ns (약 18분) 이상은 마지막 버킷
+#define PM_HIST_BUCKETS     ((PM_HIST_MAX_BITS - PM_HIST_SUB_BITS + 1) << PM_HIST_SUB_BITS)
+
+// 슬라이딩 윈도우 FPS: 250ms 슬롯 8개 (2초)
+#define PM_FPS_SLOT_NS      250000000ULL
+#define PM_FPS_SLOTS        8
+
+typedef struct {
+    uint64_t buckets[PM_HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+} pm_hist_t;
+
+typedef struct pipeline_metrics {
+    pm_hist_t stages[PM_STAGE_COUNT];
+
+    uint64_t start_ns;
+    uint64_t frames;
+    uint64_t seq_drops;         // 드라이버/장치에서 잃어버린 프레임 (sequence 간격)
+    uint64_t display_drops;     // 디스플레이가 가져가기 전에 교체된 프레임
+    uint64_t seq_restarts;      // sequence 가 뒤로 간 횟수 (스트림 재시작)
+
+    // pm_frame 호출 스레드 전용
+    uint32_t last_sequence;
+    int has_sequence;
+
+    uint64_t fps_epoch[PM_FPS_SLOTS];
+    uint64_t fps_count[PM_FPS_SLOTS];
+} pipeline_metrics_t;
+
+// 단계별 요약
+typedef struct {
+    uint64_t count;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double max_us;
+} pm_stage_summary_t;
+
+typedef struct {
+    double uptime_s;
+    uint64_t frames;
+    uint64_t seq_drops;
+    uint64_t display_drops;
+    uint64_t seq_restarts;
+    double fps_window;          // 최근 2초
+    double fps_avg;             // 시작 이후 평균
+    pm_stage_summary_t stages[PM_STAGE_COUNT];
+} pm_snapshot_t;
+
+static inline uint64_t pm_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void pm_init(pipeline_metrics_t *m);
+
+// 단계 지연 기록 (ns)
+void pm_record(pipeline_metrics_t *m, pm_stage_t stage, uint64_t ns);
+
+// 시작 시각부터 지금까지를 기록
+static inline void pm_record_since(pipeline_metrics_t *m, pm_stage_t stage, uint64_t start_ns)
+{
+    if (m)
+        pm_record(m, stage, pm_now_ns() - start_ns);
+}
+
+// 캡처한 프레임 하나 (sequence 간격으로 드롭 계산, FPS 윈도우 갱신)
+void pm_frame(pipeline_metrics_t *m, uint32_t sequence);
+
+void pm_display_drop(pipeline_metrics_t *m);
+
+// sequence 간격 드롭 + 디스플레이 드롭
+uint64_t pm_dropped(const pipeline_metrics_t *m);
+
+// pm_frame 으로 받은 프레임 수 (다른 스레드에서 읽어도 안전)
+uint64_t pm_frames(const pipeline_metrics_t *m);
+
+// 최근 2초 FPS (스냅샷 없이 오버레이 등에서 매 프레임 호출 가능)
+double pm_fps_window(const pipeline_metrics_t *m);
+
+// 파이프라인 밖의 히스토그램에 직접 기록 (벤치마크의 추가 단계 등)
+void pm_hist_record(pm_hist_t *h, uint64_t ns);
+
+// 히스토그램 버킷 ↔ 값 변환 (버킷 하한 ns)
+int pm_hist_bucket(uint64_t ns);
+uint64_t pm_hist_bucket_floor(int bucket);
+
+// 히스토그램의 q (0..1) 분위수 (버킷 중앙값, ns)
+uint64_t pm_hist_percentile(const pm_hist_t *h, double q);
+
+void pm_snapshot(const pipeline_metrics_t *m, pm_snapshot_t *snap);
+
+const char *pm_stage_name(pm_stage_t stage);
+
+// 스냅샷을 한 줄 JSON 으로 기록. 기록한 길이 (잘렸으면 필요한 길이) 반환
+int pm_snapshot_json(const pm_snapshot_t *snap, char *buf, size_t size);
+
+// 스냅샷을 찍어 JSON 한 줄을 fp 에 출력
+void pm_dump_json(const pipeline_metrics_t *m, FILE *fp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIPELINE_METRICS_H
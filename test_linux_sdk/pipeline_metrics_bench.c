@@ -0,0 +1,195 @@
+//----------------------------------------------//
+//	파이프라인 메트릭 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./pipeline_metrics_bench [samples]
+// - 로그 버킷 분위수가 정렬 기반 정확한 분위수와 버킷 오차 안에서 일치하는지
+// - 여러 스레드가 동시에 기록해도 카운트가 빠지지 않는지
+// - sequence 간격 드롭 / 재시작 감지
+// 를 확인하고 pm_record 호출 비용을 출력한다. 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "pipeline_metrics.h"
+
+#define BENCH_THREADS 4
+
+static pipeline_metrics_t shared_metrics;
+static int thread_samples;
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void *record_thread(void *arg)
+{
+    unsigned int seed = (unsigned int)(uintptr_t)arg;
+    int i;
+
+    for (i = 0; i < thread_samples; i++) {
+        seed = seed * 1103515245u + 12345u;
+        pm_record(&shared_metrics, PM_STAGE_CONVERT, 1000 + (seed >> 12));
+    }
+    return NULL;
+}
+
+// 로그-정규 분포 비슷한 지연 (수 us ~ 수십 ms)
+static uint64_t sample_latency(unsigned int *seed)
+{
+    uint64_t v = 1;
+    int k;
+
+    for (k = 0; k < 3; k++) {
+        *seed = *seed * 1103515245u + 12345u;
+        v *= 20 + ((*seed >> 16) % 300);
+    }
+    return v;
+}
+
+static int verify_percentiles(int samples)
+{
+    static const double qs[] = { 0.50, 0.90, 0.99, 0.999 };
+    pipeline_metrics_t m;
+    uint64_t *values = (uint64_t *)malloc(sizeof(uint64_t) * samples);
+    unsigned int seed = 777;
+    int i, failures = 0;
+
+    if (!values)
+        return 1;
+
+    pm_init(&m);
+    for (i = 0; i < samples; i++) {
+        values[i] = sample_latency(&seed);
+        pm_record(&m, PM_STAGE_DRAW, values[i]);
+    }
+    qsort(values, samples, sizeof(uint64_t), cmp_u64);
+
+    for (i = 0; i < (int)(sizeof(qs) / sizeof(qs[0])); i++) {
+        uint64_t target = (uint64_t)(qs[i] * samples + 0.5);
+        uint64_t exact = values[(target ? target : 1) - 1];
+        uint64_t approx = pm_hist_percentile(&m.stages[PM_STAGE_DRAW], qs[i]);
+        double err = exact ? (double)(approx > exact ? approx - exact : exact - approx) / exact : 0.0;
+
+        printf("p%-5g exact %10llu ns  hist %10llu ns  오차 %5.2f%%\n", qs[i] * 100,
+               (unsigned long long)exact, (unsigned long long)approx, err * 100);
+        // 버킷 폭은 값의 1/8 이하이므로 중앙값 오차는 6.25% 이하
+        if (err > 0.0625) {
+            printf("불일치: 분위수 오차가 버킷 폭을 넘음\n");
+            failures++;
+        }
+    }
+    if (m.stages[PM_STAGE_DRAW].max_ns != values[samples - 1]) {
+        printf("불일치: max %llu != %llu\n", (unsigned long long)m.stages[PM_STAGE_DRAW].max_ns,
+               (unsigned long long)values[samples - 1]);
+        failures++;
+    }
+
+    // 버킷 경계 왕복
+    for (i = 0; i < PM_HIST_BUCKETS; i++) {
+        if (pm_hist_bucket(pm_hist_bucket_floor(i)) != i) {
+            printf("불일치: 버킷 %d 경계\n", i);
+            failures++;
+            break;
+        }
+    }
+
+    free(values);
+    return failures;
+}
+
+static int verify_sequence(void)
+{
+    static const uint32_t seqs[] = { 10, 11, 12, 15, 16, 16, 20, 3, 4, 0xFFFFFFFFu, 0, 1 };
+    pipeline_metrics_t m;
+    int i, failures = 0;
+
+    pm_init(&m);
+    for (i = 0; i < (int)(sizeof(seqs) / sizeof(seqs[0])); i++)
+        pm_frame(&m, seqs[i]);
+
+    // 12→15: 2, 16→20: 3, 20→3: 재시작, 4→0xFFFFFFFF: 재시작, 0xFFFFFFFF→0: 정상 랩어라운드
+    if (m.seq_drops != 5 || m.seq_restarts != 2 || m.frames != sizeof(seqs) / sizeof(seqs[0])) {
+        printf("불일치: seq_drops=%llu seq_restarts=%llu frames=%llu\n",
+               (unsigned long long)m.seq_drops, (unsigned long long)m.seq_restarts,
+               (unsigned long long)m.frames);
+        failures++;
+    }
+    printf("sequence 드롭 감지: %s\n", failures ? "실패" : "일치");
+    return failures;
+}
+
+static int verify_threads(int samples)
+{
+    pthread_t threads[BENCH_THREADS];
+    uint64_t total = 0;
+    int i, failures = 0;
+    char json[1024];
+    pm_snapshot_t snap;
+
+    pm_init(&shared_metrics);
+    thread_samples = samples;
+
+    uint64_t t0 = pm_now_ns();
+    for (i = 0; i < BENCH_THREADS; i++)
+        pthread_create(&threads[i], NULL, record_thread, (void *)(uintptr_t)(i + 1));
+    for (i = 0; i < BENCH_THREADS; i++)
+        pthread_join(threads[i], NULL);
+    double elapsed = (double)(pm_now_ns() - t0);
+
+    for (i = 0; i < PM_HIST_BUCKETS; i++)
+        total += shared_metrics.stages[PM_STAGE_CONVERT].buckets[i];
+    if (total != (uint64_t)samples * BENCH_THREADS ||
+        shared_metrics.stages[PM_STAGE_CONVERT].count != total) {
+        printf("불일치: 동시 기록 %llu != %llu\n", (unsigned long long)total,
+               (unsigned long long)samples * BENCH_THREADS);
+        failures++;
+    }
+    printf("동시 기록 %d 스레드: %.1f ns/기록 (경합 포함)\n", BENCH_THREADS,
+           elapsed / samples);
+
+    pm_snapshot(&shared_metrics, &snap);
+    if (pm_snapshot_json(&snap, json, sizeof(json)) >= (int)sizeof(json)) {
+        printf("불일치: JSON 이 버퍼보다 김\n");
+        failures++;
+    }
+    printf("JSON: %s\n", json);
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    int samples = 1000000;
+    int i, failures = 0;
+    pipeline_metrics_t m;
+
+    if (argc >= 2)
+        samples = atoi(argv[1]);
+    if (samples <= 0) {
+        printf("사용법: %s [samples]\n", argv[0]);
+        return 2;
+    }
+
+    printf("=== 파이프라인 메트릭 벤치마크 (%d 샘플) ===\n", samples);
+
+    failures += verify_percentiles(samples);
+    failures += verify_sequence();
+
+    pm_init(&m);
+    uint64_t t0 = pm_now_ns();
+    for (i = 0; i < samples; i++)
+        pm_record(&m, PM_STAGE_QBUF, (uint64_t)i * 37);
+    printf("단일 스레드: %.1f ns/기록\n", (double)(pm_now_ns() - t0) / samples);
+
+    t0 = pm_now_ns();
+    for (i = 0; i < samples; i++)
+        pm_frame(&m, (uint32_t)i);
+    printf("pm_frame: %.1f ns/프레임\n", (double)(pm_now_ns() - t0) / samples);
+
+    failures += verify_threads(samples);
+
+    printf("검증: %s\n", failures ? "실패" : "정확한 분위수/카운트와 일치");
+    return failures ? 1 : 0;
+}
@@ -6,6 +6,7 @@
 #include <errno.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <pthread.h>
 #include "h264_xu_ctrls.h"
 #include "debug.h"
 
@@ -342,47 +343,604 @@ static struct uvc_xu_control_mapping rervision_xu_usr_mappings[] =
     },	
 };
 
-int XU_Set_Cur(int fd, __u8 xu_unit, __u8 xu_selector, __u16 xu_size, __u8 *xu_data)
+// XU transfer layer -------------------------------------------------
+//
+// Every accessor below talks to the camera in two steps: a "switch command"
+// SET_CUR (data[0] = 0x9A, data[1] = sub-selection) that chooses which
+// register of the selector is addressed, then the real GET_CUR/SET_CUR.
+// Each step is one USB control transfer. This layer sits under
+// XU_Set_Cur/XU_Get_Cur and, per device:
+//  - defers switch commands for plain configuration registers and drops them
+//    when the device already has that sub-selection active,
+//  - keeps a shadow copy of the last value read/written for those registers,
+//    so a GET_CUR of an unchanged control never reaches the bus and a SET_CUR
+//    of the value already written is skipped,
+//  - inside XU_Txn_Begin/XU_Txn_Commit, queues configuration writes and
+//    coalesces repeated writes to the same register (last write wins).
+// Action/status registers (I-frame request, RTC, strings, ASIC, format info,
+// multi-stream per-stream values, ...) always go straight to the device.
+// The MD result is a status register that is polled: its value is never
+// shadowed, but its switch command is elided like a configuration register,
+// so a repeated XU_MD_Read_RESULT costs one transfer instead of two.
+// Switch elision relies on the firmware keeping the sub-selection between
+// transfers; XU_Cache_Enable(0) restores the plain two-transfer path.
+
+#define XU_SWITCH_TAG			0x9A
+#define XU_CACHE_MAX_DEV		4
+#define XU_CACHE_MAX_SEL		16
+#define XU_CACHE_MAX_REGS		48
+#define XU_TXN_MAX_OPS			32
+
+struct xu_sel_state
+{
+	__u8 used;
+	__u8 unit;
+	__u8 selector;
+	__u8 expect_data;		// switch command seen, next SET_CUR carries its data
+	int pending_sub;		// sub-selection requested by the caller (-1: none)
+	int active_sub;			// sub-selection known to be active on the device (-1: unknown)
+	__u16 switch_size;
+};
+
+struct xu_shadow_reg
+{
+	__u8 used;
+	__u8 unit;
+	__u8 selector;
+	__u8 sub;
+	__u16 size;
+	__u8 has_read;
+	__u8 has_written;
+	__u8 read_data[XU_CTRL_MAX_SIZE];
+	__u8 written_data[XU_CTRL_MAX_SIZE];
+};
+
+struct xu_txn_op
+{
+	__u8 unit;
+	__u8 selector;
+	__u8 sub;
+	__u16 size;
+	__u8 data[XU_CTRL_MAX_SIZE];
+};
+
+struct xu_dev_state
+{
+	int used;
+	int fd;
+	int in_txn;
+	int nops;
+	struct xu_sel_state sels[XU_CACHE_MAX_SEL];
+	struct xu_shadow_reg regs[XU_CACHE_MAX_REGS];
+	struct xu_txn_op ops[XU_TXN_MAX_OPS];
+	struct XU_Cache_Stats stats;
+};
+
+// Sub-selections that are plain configuration values (bit n = sub n)
+static const struct
+{
+	__u8 unit;
+	__u8 selector;
+	unsigned int subs;
+} xu_cacheable_regs[] =
+{
+	{ XU_RERVISION_SYS_ID, XU_RERVISION_SYS_H264_CTRL,			(1 << 0x01) | (1 << 0x02) | (1 << 0x03) | (1 << 0x05) },
+	{ XU_RERVISION_SYS_ID, XU_RERVISION_SYS_MJPG_CTRL,			(1 << 0x02) },
+	{ XU_RERVISION_SYS_ID, XU_RERVISION_SYS_IMG_SETTING,		(1 << 0x01) | (1 << 0x02) | (1 << 0x03) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_H264_CTRL,			(1 << 0x01) | (1 << 0x02) | (1 << 0x03) | (1 << 0x05) | (1 << 0x06) | (1 << 0x07) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_MJPG_CTRL,			(1 << 0x01) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_OSD_CTRL,			(1 << 0x02) | (1 << 0x03) | (1 << 0x04) | (1 << 0x05) | (1 << 0x06) | (1 << 0x08) | (1 << 0x09) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_MOTION_DETECTION,	(1 << 0x01) | (1 << 0x02) | (1 << 0x03) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_IMG_SETTING,		(1 << 0x01) | (1 << 0x02) | (1 << 0x03) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_MULTI_STREAM_CTRL,	(1 << 0x03) },
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_DYNAMIC_FPS_CTRL,	(1 << 0x01) | (1 << 0x02) },
+};
+
+// Sub-selections whose value changes on the device side (switch elided, value never shadowed)
+static const struct
+{
+	__u8 unit;
+	__u8 selector;
+	unsigned int subs;
+} xu_status_regs[] =
+{
+	{ XU_RERVISION_USR_ID, XU_RERVISION_USR_MOTION_DETECTION,	(1 << 0x04) },
+};
+
+static int xu_default_ioctl(int fd, unsigned long request, void *arg)
+{
+	return ioctl(fd, request, arg);
+}
+
+static XU_IOCTL_FN xu_ioctl_fn = xu_default_ioctl;
+static int xu_cache_enabled = 1;
+static struct xu_dev_state xu_devs[XU_CACHE_MAX_DEV];
+static pthread_mutex_t xu_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int xu_raw_xfer(int fd, __u8 xu_unit, __u8 xu_selector, int set, __u16 xu_size, __u8 *xu_data)
 {
-	int err=0;
 #if LINUX_VERSION_CODE > KERNEL_VERSION (3, 0, 36)
 	struct uvc_xu_control_query xctrl;
 	xctrl.unit = xu_unit;
 	xctrl.selector = xu_selector;
-	xctrl.query = UVC_SET_CUR;
+	xctrl.query = set ? UVC_SET_CUR : UVC_GET_CUR;
 	xctrl.size = xu_size;
 	xctrl.data = xu_data;
-	err=ioctl(fd, UVCIOC_CTRL_QUERY, &xctrl);
+	return xu_ioctl_fn(fd, UVCIOC_CTRL_QUERY, &xctrl);
 #else
 	struct uvc_xu_control xctrl;	
 	xctrl.unit = xu_unit;
 	xctrl.selector = xu_selector;
 	xctrl.size = xu_size;
 	xctrl.data = xu_data;
-	err=ioctl(fd, UVCIOC_CTRL_SET, &xctrl);
-#endif		
+	return xu_ioctl_fn(fd, set ? UVCIOC_CTRL_SET : UVCIOC_CTRL_GET, &xctrl);
+#endif
+}
+
+static int xu_dev_xfer(struct xu_dev_state *dev, __u8 xu_unit, __u8 xu_selector, int set, __u16 xu_size, __u8 *xu_data)
+{
+	dev->stats.bus_transfers++;
+	return xu_raw_xfer(dev->fd, xu_unit, xu_selector, set, xu_size, xu_data);
+}
+
+static struct xu_dev_state *xu_dev_get(int fd)
+{
+	int i;
+	struct xu_dev_state *free_dev = NULL;
+
+	for(i = 0; i < XU_CACHE_MAX_DEV; i++)
+	{
+		if(xu_devs[i].used && xu_devs[i].fd == fd)
+			return &xu_devs[i];
+		if(!xu_devs[i].used && !free_dev)
+			free_dev = &xu_devs[i];
+	}
+	if(free_dev)
+	{
+		memset(free_dev, 0, sizeof(*free_dev));
+		free_dev->used = 1;
+		free_dev->fd = fd;
+	}
+	return free_dev;
+}
+
+static struct xu_sel_state *xu_sel_get(struct xu_dev_state *dev, __u8 xu_unit, __u8 xu_selector)
+{
+	int i;
+	struct xu_sel_state *s;
+
+	for(i = 0; i < XU_CACHE_MAX_SEL; i++)
+	{
+		s = &dev->sels[i];
+		if(!s->used)
+		{
+			s->used = 1;
+			s->unit = xu_unit;
+			s->selector = xu_selector;
+			s->pending_sub = -1;
+			s->active_sub = -1;
+			return s;
+		}
+		if(s->unit == xu_unit && s->selector == xu_selector)
+			return s;
+	}
+	return NULL;
+}
+
+static struct xu_shadow_reg *xu_reg_get(struct xu_dev_state *dev, __u8 xu_unit, __u8 xu_selector, __u8 sub, __u16 xu_size)
+{
+	int i;
+	struct xu_shadow_reg *r;
+
+	for(i = 0; i < XU_CACHE_MAX_REGS; i++)
+	{
+		r = &dev->regs[i];
+		if(!r->used)
+		{
+			memset(r, 0, sizeof(*r));
+			r->used = 1;
+			r->unit = xu_unit;
+			r->selector = xu_selector;
+			r->sub = sub;
+			r->size = xu_size;
+			return r;
+		}
+		if(r->unit == xu_unit && r->selector == xu_selector && r->sub == sub && r->size == xu_size)
+			return r;
+	}
+	return NULL;
+}
+
+static int xu_switch_cacheable(__u8 xu_unit, __u8 xu_selector, __u16 xu_size, const __u8 *xu_data)
+{
+	unsigned int i;
+
+	if(xu_size < 2 || xu_size > XU_CTRL_MAX_SIZE || xu_data[1] >= 32)
+		return 0;
+	// Only the plain form (tag, sub, zero padding) identifies a register
+	for(i = 2; i < xu_size; i++)
+		if(xu_data[i])
+			return 0;
+	for(i = 0; i < sizeof(xu_cacheable_regs) / sizeof(xu_cacheable_regs[0]); i++)
+	{
+		if(xu_cacheable_regs[i].unit == xu_unit && xu_cacheable_regs[i].selector == xu_selector)
+		{
+			if((xu_cacheable_regs[i].subs >> xu_data[1]) & 1)
+				return 1;
+			break;
+		}
+	}
+	for(i = 0; i < sizeof(xu_status_regs) / sizeof(xu_status_regs[0]); i++)
+	{
+		if(xu_status_regs[i].unit == xu_unit && xu_status_regs[i].selector == xu_selector)
+			return (xu_status_regs[i].subs >> xu_data[1]) & 1;
+	}
+	return 0;
+}
+
+static int xu_sub_is_status(__u8 xu_unit, __u8 xu_selector, int sub)
+{
+	unsigned int i;
+
+	for(i = 0; i < sizeof(xu_status_regs) / sizeof(xu_status_regs[0]); i++)
+	{
+		if(xu_status_regs[i].unit == xu_unit && xu_status_regs[i].selector == xu_selector)
+			return (xu_status_regs[i].subs >> sub) & 1;
+	}
+	return 0;
+}
+
+// A write may change any value behind the same selector (e.g. rate control
+// mode vs. bitrate/QP), so drop the shadow copies of that selector.
+static void xu_invalidate_sel(struct xu_dev_state *dev, __u8 xu_unit, __u8 xu_selector)
+{
+	int i;
+
+	for(i = 0; i < XU_CACHE_MAX_REGS; i++)
+	{
+		if(dev->regs[i].used && dev->regs[i].unit == xu_unit && dev->regs[i].selector == xu_selector)
+		{
+			dev->regs[i].has_read = 0;
+			dev->regs[i].has_written = 0;
+		}
+	}
+}
+
+static void xu_invalidate_all(struct xu_dev_state *dev)
+{
+	int i;
+
+	for(i = 0; i < XU_CACHE_MAX_REGS; i++)
+	{
+		dev->regs[i].has_read = 0;
+		dev->regs[i].has_written = 0;
+	}
+}
+
+static void xu_forget(struct xu_dev_state *dev)
+{
+	int i;
+
+	xu_invalidate_all(dev);
+	for(i = 0; i < XU_CACHE_MAX_SEL; i++)
+	{
+		dev->sels[i].active_sub = -1;
+		dev->sels[i].expect_data = 0;
+	}
+}
+
+static int xu_send_switch(struct xu_dev_state *dev, struct xu_sel_state *s, int sub, __u16 xu_size)
+{
+	__u8 data[XU_CTRL_MAX_SIZE];
+	int err;
+
+	if(s->active_sub == sub)
+	{
+		dev->stats.switch_skipped++;
+		return 0;
+	}
+
+	memset(data, 0, xu_size);
+	data[0] = XU_SWITCH_TAG;
+	data[1] = sub;
+	err = xu_dev_xfer(dev, s->unit, s->selector, 1, xu_size, data);
+	s->active_sub = (err < 0) ? -1 : sub;
+	return err;
+}
+
+// Write one configuration register (switch if needed + data) and update its shadow
+static int xu_write_reg(struct xu_dev_state *dev, struct xu_sel_state *s, int sub, __u16 switch_size,
+						struct xu_shadow_reg *r, __u16 xu_size, __u8 *xu_data)
+{
+	int err;
+
+	err = xu_send_switch(dev, s, sub, switch_size);
+	if(err >= 0)
+		err = xu_dev_xfer(dev, s->unit, s->selector, 1, xu_size, xu_data);
+	xu_invalidate_sel(dev, s->unit, s->selector);
+	if(err < 0)
+	{
+		s->active_sub = -1;
+		return err;
+	}
+	if(r)
+	{
+		memcpy(r->written_data, xu_data, xu_size);
+		r->has_written = 1;
+	}
+	return err;
+}
+
+// Send the queued transaction writes in the order they were issued
+static int xu_txn_flush(struct xu_dev_state *dev)
+{
+	int i, err, ret = 0;
+	struct xu_txn_op *op;
+	struct xu_sel_state *s;
+
+	for(i = 0; i < dev->nops; i++)
+	{
+		op = &dev->ops[i];
+		s = xu_sel_get(dev, op->unit, op->selector);
+		if(!s)
+			continue;
+		err = xu_write_reg(dev, s, op->sub, op->size,
+						   xu_reg_get(dev, op->unit, op->selector, op->sub, op->size), op->size, op->data);
+		if(err < 0 && ret == 0)
+			ret = err;
+	}
+	dev->nops = 0;
+	return ret;
+}
+
+static int xu_txn_queue(struct xu_dev_state *dev, struct xu_sel_state *s, __u16 xu_size, const __u8 *xu_data)
+{
+	int i, err;
+	struct xu_txn_op *op;
+
+	for(i = 0; i < dev->nops; i++)
+	{
+		op = &dev->ops[i];
+		if(op->unit == s->unit && op->selector == s->selector && op->sub == s->pending_sub && op->size == xu_size)
+		{
+			memcpy(op->data, xu_data, xu_size);
+			dev->stats.write_coalesced++;
+			return 0;
+		}
+	}
+	if(dev->nops == XU_TXN_MAX_OPS)
+	{
+		err = xu_txn_flush(dev);
+		if(err < 0)
+			return err;
+	}
+	op = &dev->ops[dev->nops++];
+	op->unit = s->unit;
+	op->selector = s->selector;
+	op->sub = s->pending_sub;
+	op->size = xu_size;
+	memcpy(op->data, xu_data, xu_size);
+	return 0;
+}
+
+void XU_Set_Ioctl(XU_IOCTL_FN fn)
+{
+	xu_ioctl_fn = fn ? fn : xu_default_ioctl;
+}
+
+void XU_Cache_Enable(int enable)
+{
+	int i;
+
+	pthread_mutex_lock(&xu_lock);
+	xu_cache_enabled = enable;
+	for(i = 0; i < XU_CACHE_MAX_DEV; i++)
+		xu_devs[i].used = 0;
+	pthread_mutex_unlock(&xu_lock);
+}
+
+void XU_Cache_Invalidate(int fd)
+{
+	int i;
+
+	pthread_mutex_lock(&xu_lock);
+	for(i = 0; i < XU_CACHE_MAX_DEV; i++)
+	{
+		if(xu_devs[i].used && xu_devs[i].fd == fd)
+			xu_devs[i].used = 0;
+	}
+	pthread_mutex_unlock(&xu_lock);
+}
+
+int XU_Cache_Get_Stats(int fd, struct XU_Cache_Stats *stats)
+{
+	int i, ret = -1;
+
+	pthread_mutex_lock(&xu_lock);
+	for(i = 0; i < XU_CACHE_MAX_DEV; i++)
+	{
+		if(xu_devs[i].used && xu_devs[i].fd == fd)
+		{
+			*stats = xu_devs[i].stats;
+			ret = 0;
+		}
+	}
+	pthread_mutex_unlock(&xu_lock);
+	return ret;
+}
+
+int XU_Txn_Begin(int fd)
+{
+	struct xu_dev_state *dev;
+	int ret = 0;
+
+	if(!xu_cache_enabled)
+		return 0;
+
+	pthread_mutex_lock(&xu_lock);
+	dev = xu_dev_get(fd);
+	if(dev)
+		dev->in_txn = 1;
+	else
+		ret = -1;
+	pthread_mutex_unlock(&xu_lock);
+	return ret;
+}
+
+int XU_Txn_Commit(int fd)
+{
+	struct xu_dev_state *dev;
+	int ret = 0;
+
+	if(!xu_cache_enabled)
+		return 0;
+
+	pthread_mutex_lock(&xu_lock);
+	dev = xu_dev_get(fd);
+	if(dev)
+	{
+		ret = xu_txn_flush(dev);
+		dev->in_txn = 0;
+	}
+	pthread_mutex_unlock(&xu_lock);
+	if(ret < 0)
+		TestAp_Printf(TESTAP_DBG_ERR,"XU_Txn_Commit ==> ioctl(UVCIOC_CTRL_SET) FAILED (%i)\n",ret);
+	return ret;
+}
+
+int XU_Set_Cur(int fd, __u8 xu_unit, __u8 xu_selector, __u16 xu_size, __u8 *xu_data)
+{
+	int err=0;
+	struct xu_dev_state *dev = NULL;
+	struct xu_sel_state *s = NULL;
+	struct xu_shadow_reg *r;
+
+	if(!xu_cache_enabled)
+		return xu_raw_xfer(fd, xu_unit, xu_selector, 1, xu_size, xu_data);
+
+	pthread_mutex_lock(&xu_lock);
+	dev = xu_dev_get(fd);
+	if(dev && xu_size <= XU_CTRL_MAX_SIZE)
+		s = xu_sel_get(dev, xu_unit, xu_selector);
+	if(!s)
+	{
+		// Not tracked: send as is and forget what we knew about the device
+		if(dev)
+		{
+			err = xu_txn_flush(dev);
+			xu_forget(dev);
+		}
+		if(err >= 0)
+			err = xu_raw_xfer(fd, xu_unit, xu_selector, 1, xu_size, xu_data);
+		pthread_mutex_unlock(&xu_lock);
+		return err;
+	}
+
+	if(!s->expect_data && xu_size >= 2 && xu_data[0] == XU_SWITCH_TAG)
+	{
+		// Switch command
+		s->expect_data = 1;
+		if(xu_switch_cacheable(xu_unit, xu_selector, xu_size, xu_data))
+		{
+			s->pending_sub = xu_data[1];
+			s->switch_size = xu_size;
+		}
+		else
+		{
+			s->pending_sub = -1;
+			err = xu_txn_flush(dev);
+			if(err >= 0)
+				err = xu_dev_xfer(dev, xu_unit, xu_selector, 1, xu_size, xu_data);
+			s->active_sub = -1;
+		}
+		pthread_mutex_unlock(&xu_lock);
+		return err;
+	}
+
+	s->expect_data = 0;
+	if(s->pending_sub >= 0)
+	{
+		r = xu_sub_is_status(xu_unit, xu_selector, s->pending_sub) ? NULL :
+			xu_reg_get(dev, xu_unit, xu_selector, s->pending_sub, xu_size);
+		if(r && r->has_written && memcmp(r->written_data, xu_data, xu_size) == 0)
+		{
+			dev->stats.write_skipped++;
+		}
+		else if(r && dev->in_txn)
+		{
+			err = xu_txn_queue(dev, s, xu_size, xu_data);
+			xu_invalidate_sel(dev, xu_unit, xu_selector);
+		}
+		else
+		{
+			err = xu_txn_flush(dev);
+			if(err >= 0)
+				err = xu_write_reg(dev, s, s->pending_sub, s->switch_size, r, xu_size, xu_data);
+		}
+	}
+	else
+	{
+		// Unknown register (action, string, ASIC, ...): anything may change
+		err = xu_txn_flush(dev);
+		if(err >= 0)
+			err = xu_dev_xfer(dev, xu_unit, xu_selector, 1, xu_size, xu_data);
+		xu_invalidate_all(dev);
+	}
+	pthread_mutex_unlock(&xu_lock);
 	return err;
 }
 
 int XU_Get_Cur(int fd, __u8 xu_unit, __u8 xu_selector, __u16 xu_size, __u8 *xu_data)
 {
 	int err=0;
-#if LINUX_VERSION_CODE > KERNEL_VERSION (3, 0, 36)
-	struct uvc_xu_control_query xctrl;
-	xctrl.unit = xu_unit;
-	xctrl.selector = xu_selector;
-	xctrl.query = UVC_GET_CUR;
-	xctrl.size = xu_size;
-	xctrl.data = xu_data;
-	err=ioctl(fd, UVCIOC_CTRL_QUERY, &xctrl);
-#else
-	struct uvc_xu_control xctrl;	
-	xctrl.unit = xu_unit;
-	xctrl.selector = xu_selector;
-	xctrl.size = xu_size;
-	xctrl.data = xu_data;
-	err=ioctl(fd, UVCIOC_CTRL_GET, &xctrl);
-#endif	
+	struct xu_dev_state *dev = NULL;
+	struct xu_sel_state *s = NULL;
+	struct xu_shadow_reg *r = NULL;
+
+	if(!xu_cache_enabled)
+		return xu_raw_xfer(fd, xu_unit, xu_selector, 0, xu_size, xu_data);
+
+	pthread_mutex_lock(&xu_lock);
+	dev = xu_dev_get(fd);
+	if(dev && xu_size <= XU_CTRL_MAX_SIZE)
+		s = xu_sel_get(dev, xu_unit, xu_selector);
+	if(!s)
+	{
+		if(dev)
+			err = xu_txn_flush(dev);
+		if(err >= 0)
+			err = xu_raw_xfer(fd, xu_unit, xu_selector, 0, xu_size, xu_data);
+		pthread_mutex_unlock(&xu_lock);
+		return err;
+	}
+
+	s->expect_data = 0;
+	if(s->pending_sub >= 0)
+	{
+		r = xu_sub_is_status(xu_unit, xu_selector, s->pending_sub) ? NULL :
+			xu_reg_get(dev, xu_unit, xu_selector, s->pending_sub, xu_size);
+		if(r && r->has_read)
+		{
+			memcpy(xu_data, r->read_data, xu_size);
+			dev->stats.read_hits++;
+			pthread_mutex_unlock(&xu_lock);
+			return 0;
+		}
+	}
+
+	err = xu_txn_flush(dev);
+	if(err >= 0 && s->pending_sub >= 0)
+		err = xu_send_switch(dev, s, s->pending_sub, s->switch_size);
+	if(err >= 0)
+		err = xu_dev_xfer(dev, xu_unit, xu_selector, 0, xu_size, xu_data);
+	if(err < 0)
+		s->active_sub = -1;
+	else if(r)
+	{
+		memcpy(r->read_data, xu_data, xu_size);
+		r->has_read = 1;
+	}
+	pthread_mutex_unlock(&xu_lock);
 	return err;
 }
 
@@ -442,6 +1000,9 @@ int XU_Init_Ctrl(int fd)
 	struct uvc_xu_control_info *xu_infos;
 	struct uvc_xu_control_mapping *xu_mappings;
 	
+	// The fd may belong to a different device than the last time it was used
+	XU_Cache_Invalidate(fd);
+
 	// Add xu READ ASIC first
 	err = XU_Ctrl_Add(fd, &rervision_xu_sys_ctrls[i], &rervision_xu_sys_mappings[i]);
 	if (err == EEXIST){}
@@ -4028,12 +4589,10 @@ int XU_MD_Set_RESULT(int fd, unsigned char *Result)
 	return 0;
 }
 
-int XU_MD_Get_RESULT(int fd, unsigned char *Result)
+int XU_MD_Read_RESULT(int fd, unsigned char *Result)
 {	
-	//TestAp_Printf(TESTAP_DBG_FLOW, "XU_MD_Get_RESULT  ==>\n");
-
 	int err = 0;
-	int i,j,k,l;
+	int i;
 	__u8 ctrldata[24]={0};
 
 	//uvc_xu_control parmeters
@@ -4042,13 +4601,13 @@ int XU_MD_Get_RESULT(int fd, unsigned char *Result)
 	__u16 xu_size= 24;
 	__u8 *xu_data= ctrldata;
 
-	// Switch command
+	// Switch command (elided by the transfer layer while the result stays selected)
 	xu_data[0] = 0x9A;				// Tag
 	xu_data[1] = 0x04;				// Motion detection Result
 
 	if ((err=XU_Set_Cur(fd, xu_unit, xu_selector, xu_size, xu_data)) < 0) 
 	{
-		TestAp_Printf(TESTAP_DBG_ERR,"XU_MD_Get_RESULT ==> Switch cmd : ioctl(UVCIOC_CTRL_SET) FAILED (%i)  \n",err);
+		TestAp_Printf(TESTAP_DBG_ERR,"XU_MD_Read_RESULT ==> Switch cmd : ioctl(UVCIOC_CTRL_SET) FAILED (%i)  \n",err);
 		if(err==EINVAL)
 			TestAp_Printf(TESTAP_DBG_ERR,"Invalid arguments\n");
 		return err;
@@ -4058,17 +4617,21 @@ int XU_MD_Get_RESULT(int fd, unsigned char *Result)
 	memset(xu_data, 0, xu_size);
 	if ((err=XU_Get_Cur(fd, xu_unit, xu_selector, xu_size, xu_data)) < 0)
 	{
-		TestAp_Printf(TESTAP_DBG_ERR,"XU_MD_Get_RESULT ==> ioctl(UVCIOC_CTRL_GET) FAILED (%i) \n",err);
+		TestAp_Printf(TESTAP_DBG_ERR,"XU_MD_Read_RESULT ==> ioctl(UVCIOC_CTRL_GET) FAILED (%i) \n",err);
 		if(err==EINVAL)
 			TestAp_Printf(TESTAP_DBG_ERR,"Invalid arguments\n");
 		return err;
 	}
 
 	for(i=0; i<24; i++)
-	{
-		//TestAp_Printf(TESTAP_DBG_FLOW, "      Get data[%d] : 0x%x\n", i, xu_data[i]);
 		Result[i] = xu_data[i];
-	}
+
+	return 0;
+}
+
+void XU_MD_Print_RESULT(const unsigned char *Result)
+{
+	int i,j,k;
 
 	system("clear");
 	TestAp_Printf(TESTAP_DBG_FLOW, "               ------   Motion Detect Result   ------                \n");
@@ -4084,6 +4647,18 @@ int XU_MD_Get_RESULT(int fd, unsigned char *Result)
 		}
 		TestAp_Printf(TESTAP_DBG_FLOW, "\n");
 	}
+}
+
+int XU_MD_Get_RESULT(int fd, unsigned char *Result)
+{	
+	//TestAp_Printf(TESTAP_DBG_FLOW, "XU_MD_Get_RESULT  ==>\n");
+
+	int err = 0;
+
+	if ((err=XU_MD_Read_RESULT(fd, Result)) < 0)
+		return err;
+
+	XU_MD_Print_RESULT(Result);
 
 	//TestAp_Printf(TESTAP_DBG_FLOW, "XU_MD_Get_RESULT <== Success \n");
 	
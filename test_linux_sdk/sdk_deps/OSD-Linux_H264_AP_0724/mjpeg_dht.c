@@ -0,0 +1,197 @@
+//----------------------------------------------//
+//	MJPEG marker parser / DHT iovec				//
+//----------------------------------------------//
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "mjpeg_dht.h"
+
+#define M_SOI       0xD8
+#define M_EOI       0xD9
+#define M_SOS       0xDA
+#define M_DQT       0xDB
+#define M_DRI       0xDD
+#define M_DHT       0xC4
+#define M_JPG       0xC8
+#define M_DAC       0xCC
+#define M_TEM       0x01
+
+static unsigned int rd16(const unsigned char *p)
+{
+    return ((unsigned int)p[0] << 8) | p[1];
+}
+
+// SOF0..SOF15 (DHT, JPG, DAC 제외)
+static int is_sof(unsigned char m)
+{
+    return m >= 0xC0 && m <= 0xCF && m != M_DHT && m != M_JPG && m != M_DAC;
+}
+
+static int parse_sof(const unsigned char *seg, unsigned int seg_len, unsigned char marker, MJPEG_INFO *info)
+{
+    unsigned int n;
+
+    // 길이(2) 정밀도(1) 높이(2) 너비(2) 성분 수(1) + 성분마다 3 바이트
+    if(seg_len < 8)
+        return -1;
+    n = seg[7];
+    if(n == 0 || seg_len < 8 + 3 * n)
+        return -1;
+    info->sof_marker = marker;
+    info->height = (unsigned short)rd16(seg + 3);
+    info->width = (unsigned short)rd16(seg + 5);
+    info->components = (unsigned char)n;
+    info->h_samp = seg[9] >> 4;
+    info->v_samp = seg[9] & 0x0F;
+    return 0;
+}
+
+int MjpegParse(const unsigned char *buf, unsigned int len, MJPEG_INFO *info)
+{
+    unsigned int pos = 2;
+
+    memset(info, 0, sizeof(*info));
+    if(!buf || len < 4 || buf[0] != 0xFF || buf[1] != M_SOI)
+        return -1;
+
+    // 세그먼트 길이를 따라 SOS 까지만 걷는다 (엔트로피 데이터는 보지 않음)
+    while(pos < len)
+    {
+        unsigned int mpos, seg_len;
+        unsigned char m;
+
+        if(buf[pos] != 0xFF)
+            return -1;
+        while(pos < len && buf[pos] == 0xFF)    // 마커 앞 채움 바이트
+            pos++;
+        if(pos >= len)
+            return -1;
+        mpos = pos - 1;
+        m = buf[pos++];
+        if(m == M_TEM || (m >= 0xD0 && m <= 0xD7))
+            continue;                           // 길이 없는 마커
+        if(m == 0x00 || m == M_SOI || m == M_EOI)
+            return -1;                          // SOS 전에는 나올 수 없음
+        if(pos + 2 > len)
+            return -1;
+        seg_len = rd16(buf + pos);
+        if(seg_len < 2 || seg_len > len - pos)
+            return -1;
+
+        if(is_sof(m))
+        {
+            if(info->sof_marker == 0)
+            {
+                if(parse_sof(buf + pos, seg_len, m, info) < 0)
+                    return -1;
+                info->sof_offset = mpos;
+            }
+        }
+        else if(m == M_DHT)
+        {
+            info->has_dht = 1;
+        }
+        else if(m == M_DQT)
+        {
+            info->has_dqt = 1;
+        }
+        else if(m == M_DRI && seg_len >= 4)
+        {
+            info->restart_interval = (unsigned short)rd16(buf + pos + 2);
+        }
+        else if(m == M_SOS)
+        {
+            info->sos_offset = mpos;
+            info->data_offset = pos + seg_len;
+            return 0;
+        }
+        pos += seg_len;
+    }
+    return -1;                                  // SOS 없음
+}
+
+int MjpegDhtIovec(const unsigned char *buf, unsigned int len,
+                  const unsigned char *dht, unsigned int dht_len,
+                  struct iovec iov[MJPEG_IOV_MAX], MJPEG_INFO *info)
+{
+    MJPEG_INFO local;
+    unsigned int at;
+
+    if(!info)
+        info = &local;
+    if(MjpegParse(buf, len, info) < 0)
+        return -1;
+
+    if(info->has_dht || !dht || dht_len == 0)
+    {
+        iov[0].iov_base = (void *)buf;
+        iov[0].iov_len = len;
+        return 1;
+    }
+
+    // DHT 는 SOS 앞 어디든 되지만 기존 코드와 같이 SOFn 바로 앞에 넣는다
+    at = info->sof_offset ? info->sof_offset : info->sos_offset;
+    iov[0].iov_base = (void *)buf;
+    iov[0].iov_len = at;
+    iov[1].iov_base = (void *)dht;
+    iov[1].iov_len = dht_len;
+    iov[2].iov_base = (void *)(buf + at);
+    iov[2].iov_len = len - at;
+    return 3;
+}
+
+unsigned int MjpegGather(unsigned char *dst, unsigned int dst_size, const struct iovec *iov, int iovcnt)
+{
+    unsigned int total = 0;
+    int i;
+
+    for(i = 0; i < iovcnt; i++)
+        total += (unsigned int)iov[i].iov_len;
+    if(total > dst_size)
+        return 0;
+
+    total = 0;
+    for(i = 0; i < iovcnt; i++)
+    {
+        memcpy(dst + total, iov[i].iov_base, iov[i].iov_len);
+        total += (unsigned int)iov[i].iov_len;
+    }
+    return total;
+}
+
+int MjpegWritev(int fd, const struct iovec *iov, int iovcnt)
+{
+    struct iovec part[MJPEG_IOV_MAX];
+    size_t skip = 0;                // iov[i] 중 이미 쓴 바이트
+    int i = 0;
+
+    while(i < iovcnt)
+    {
+        ssize_t n;
+        int k;
+
+        for(k = 0; k < MJPEG_IOV_MAX && i + k < iovcnt; k++)
+            part[k] = iov[i + k];
+        part[0].iov_base = (char *)part[0].iov_base + skip;
+        part[0].iov_len -= skip;
+
+        n = writev(fd, part, k);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return -1;
+        }
+
+        // 쓴 만큼 앞으로
+        while(i < iovcnt && (size_t)n >= iov[i].iov_len - skip)
+        {
+            n -= (ssize_t)(iov[i].iov_len - skip);
+            skip = 0;
+            i++;
+        }
+        skip += (size_t)n;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef _MJPEG_DHT_H_
+#define _MJPEG_DHT_H_
+
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// UVC MJPEG 프레임 마커 파서 / DHT 삽입
+// UVC 카메라는 대부분 Huffman 테이블(DHT) 없이 표준 테이블을 가정한 프레임을 보낸다.
+// 마커 세그먼트 길이를 따라 SOS 까지만 걸어서 실제 삽입 위치(SOFn 앞)와 DHT 유무를 찾고,
+// 결과를 [헤더, DHT, 페이로드] iovec 로 내준다. writev/sendmsg/디코더가 그대로 쓰면
+// 수백 KB 페이로드를 복사하지 않는다.
+
+#define MJPEG_IOV_MAX               3
+
+typedef struct
+{
+    unsigned int sof_offset;        // SOFn 마커 위치 (SOS 전에 없으면 0)
+    unsigned int sos_offset;        // SOS 마커 위치
+    unsigned int data_offset;       // 엔트로피 코딩 데이터 시작 (SOS 세그먼트 다음)
+    unsigned char sof_marker;       // 0xC0 (baseline), 0xC1, 0xC2 ...
+    unsigned char components;
+    unsigned char h_samp;           // 첫 성분(Y) 샘플링 (4:2:2 면 2x1, 4:2:0 이면 2x2)
+    unsigned char v_samp;
+    unsigned short width;
+    unsigned short height;
+    unsigned short restart_interval;    // DRI (없으면 0)
+    int has_dht;                    // SOS 전에 DHT 가 있음
+    int has_dqt;
+} MJPEG_INFO;
+
+// SOI 부터 SOS 까지 마커를 검사한다. 성공 0, JPEG 가 아니거나 잘린 헤더면 -1
+int MjpegParse(const unsigned char *buf, unsigned int len, MJPEG_INFO *info);
+
+// DHT 가 없으면 [SOFn 앞까지, dht, SOFn 부터] 3 개, 있으면 [프레임 전체] 1 개를 채운다
+// iov 는 buf/dht 를 가리키므로 둘이 살아 있는 동안만 유효. iov 개수 반환, 실패 시 -1
+int MjpegDhtIovec(const unsigned char *buf, unsigned int len,
+                  const unsigned char *dht, unsigned int dht_len,
+                  struct iovec iov[MJPEG_IOV_MAX], MJPEG_INFO *info);
+
+// iovec 를 dst 로 모아 복사 (dst 가 모자라면 0). 복사한 바이트 수 반환
+unsigned int MjpegGather(unsigned char *dst, unsigned int dst_size, const struct iovec *iov, int iovcnt);
+
+// 짧은 쓰기와 EINTR 를 처리하는 writev. 성공 0, 실패 -1
+int MjpegWritev(int fd, const struct iovec *iov, int iovcnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,6 +32,7 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include "v4l2uvc.h"
+#include "mjpeg_dht.h"
 #include "debug.h"
 
 static int debug = 0;
@@ -274,10 +275,9 @@ video_disable (struct vdIn *vd)
 }
 
 int
-uvcGrab (struct vdIn *vd)
+uvcDequeue (struct vdIn *vd, struct iovec *iov)
 {
-#define HEADERFRAME1 0xaf
-  int ret;
+  int ret, cnt = 1;
 
   if (!vd->isstreaming)
     if (video_enable (vd))
@@ -290,39 +290,67 @@ uvcGrab (struct vdIn *vd)
     TestAp_Printf(TESTAP_DBG_ERR, "Unable to dequeue buffer (%d).\n", errno);
     goto err;
   }
+  iov[0].iov_base = vd->mem[vd->buf.index];
+  iov[0].iov_len = vd->buf.bytesused;
   switch (vd->formatIn) {
   case V4L2_PIX_FMT_MJPEG:
-
-    memcpy (vd->tmpbuffer, vd->mem[vd->buf.index], HEADERFRAME1);
-    memcpy (vd->tmpbuffer + HEADERFRAME1, dht_data, DHT_SIZE);
-    memcpy (vd->tmpbuffer + HEADERFRAME1 + DHT_SIZE,
-	    vd->mem[vd->buf.index] + HEADERFRAME1,
-	    (vd->buf.bytesused - HEADERFRAME1));
+    /* header | DHT | payload; frames that already carry a DHT (or don't parse) are passed as-is */
+    cnt = MjpegDhtIovec (vd->mem[vd->buf.index], vd->buf.bytesused, dht_data, DHT_SIZE, iov, NULL);
+    if (cnt < 0) {
+      TestAp_Printf(TESTAP_DBG_FLOW, "Unparsable MJPEG frame (%d bytes)\n", vd->buf.bytesused);
+      iov[0].iov_base = vd->mem[vd->buf.index];
+      iov[0].iov_len = vd->buf.bytesused;
+      cnt = 1;
+    }
     if (debug)
       TestAp_Printf(TESTAP_DBG_FLOW, "bytes in used %d \n", vd->buf.bytesused);
     break;
   case V4L2_PIX_FMT_YUYV:
     if (vd->buf.bytesused > vd->framesizeIn)
-      memcpy (vd->framebuffer, vd->mem[vd->buf.index],
-	      (size_t) vd->framesizeIn);
-    else
-      memcpy (vd->framebuffer, vd->mem[vd->buf.index],
-	      (size_t) vd->buf.bytesused);
+      iov[0].iov_len = vd->framesizeIn;
     break;
   default:
+    uvcRequeue (vd);
     goto err;
     break;
   }
+  return cnt;
+err:
+  vd->signalquit = 0;
+  return -1;
+}
+
+int
+uvcRequeue (struct vdIn *vd)
+{
+  int ret;
+
   ret = ioctl (vd->fd, VIDIOC_QBUF, &vd->buf);
   if (ret < 0) {
     TestAp_Printf(TESTAP_DBG_ERR, "Unable to requeue buffer (%d).\n", errno);
-    goto err;
+    vd->signalquit = 0;
+    return -1;
   }
-
   return 0;
-err:
-  vd->signalquit = 0;
-  return -1;
+}
+
+int
+uvcGrab (struct vdIn *vd)
+{
+  struct iovec iov[MJPEG_IOV_MAX];
+  int cnt;
+
+  cnt = uvcDequeue (vd, iov);
+  if (cnt < 0)
+    return -1;
+  if (vd->formatIn == V4L2_PIX_FMT_MJPEG) {
+    vd->tmpbytes = MjpegGather (vd->tmpbuffer, vd->framesizeIn, iov, cnt);
+    if (vd->tmpbytes == 0)
+      TestAp_Printf(TESTAP_DBG_ERR, "MJPEG frame (%d bytes) larger than tmpbuffer\n", vd->buf.bytesused);
+  } else {
+    memcpy (vd->framebuffer, iov[0].iov_base, iov[0].iov_len);
+  }
+  return uvcRequeue (vd);
 }
 
 int
@@ -22,6 +22,8 @@
 #                                                                              #
 *******************************************************************************/
 
+#include <sys/uio.h>
+
 #define NB_BUFFER 16
 #define DHT_SIZE 420
 
@@ -40,6 +42,7 @@ struct vdIn {
   struct v4l2_requestbuffers rb;
   void *mem[NB_BUFFER];
   unsigned char *tmpbuffer;
+  int tmpbytes;			/* MJPEG frame in tmpbuffer (DHT inserted) */
   unsigned char *framebuffer;
   int isstreaming;
   int grabmethod;
@@ -58,6 +61,11 @@ int
   init_videoIn (struct vdIn *vd, char *device, int width, int height,
 		int format, int grabmethod);
 int uvcGrab (struct vdIn *vd);
+/* Zero-copy grab: fills iov (MJPEG_IOV_MAX entries) with the frame still in
+ * the driver buffer (MJPEG: header, DHT, payload) and returns the count.
+ * The buffer is owned by the caller until uvcRequeue(). */
+int uvcDequeue (struct vdIn *vd, struct iovec *iov);
+int uvcRequeue (struct vdIn *vd);
 int close_v4l2 (struct vdIn *vd);
 
 int v4l2GetControl (int fd, int control);
@@ -14,6 +14,7 @@
 #include <sys/time.h>
 #include "v4l2uvc.h"
 #include "rervision_xu_ctrls.h"
+#include "mjpeg_dht.h"
 
 #define CLEAR(x) memset (&(x), 0, sizeof (x))
 
@@ -315,27 +316,12 @@ static void get_picture_name (char *Picture, int fmt,int flag)
 	  memcpy(Picture, temp, strlen (temp));
 }
 
-static int is_huffman(unsigned char *buf)
-{
-	unsigned char *ptbuf;
-	int i = 0;
-	ptbuf = buf;
-	while (((ptbuf[0] << 8) | ptbuf[1]) != 0xffda){
-		if(i++ > 2048)
-			return 0;
-		if(((ptbuf[0] << 8) | ptbuf[1]) == 0xffc4)
-			return 1;
-		ptbuf++;
-	}
-	return 0;
-}
-
-
+// 마커 세그먼트를 따라가 DHT 가 없을 때만 SOFn 앞에 표준 테이블을 끼워 [헤더, DHT, 페이로드] 로 쓴다
 static int get_picture(unsigned char *buf,int size,int flag)
 {
 	FILE *file;
-	unsigned char *ptdeb,*ptcur = buf;
-	int sizein;
+	struct iovec iov[MJPEG_IOV_MAX];
+	int cnt;
 	char *name = NULL;
 	name = calloc(100,1);
 
@@ -346,21 +332,15 @@ static int get_picture(unsigned char *buf,int size,int flag)
 		printf("--  fopen failed -----!\n");
 	if (file != NULL)
 	{
-		if(!is_huffman(buf))
+		cnt = MjpegDhtIovec(buf, size, dht_data, DHT_SIZE, iov, NULL);
+		if(cnt < 0)
 		{
-			ptdeb = ptcur = buf;
-			while (((ptcur[0] << 8) | ptcur[1]) != 0xffc0)
-					ptcur++;
-			sizein = ptcur-ptdeb;
-
-			fwrite(buf,sizein, 1, file);
-			fwrite(dht_data,DHT_SIZE, 1, file);
-			fwrite(ptcur,size-sizein,1,file);
-
+			printf("--  invalid MJPEG frame (%d bytes), saved as-is -----!\n", size);
+			fwrite(buf,size,1,file);
 		}
-		else
+		else if(MjpegWritev(fileno(file), iov, cnt) < 0)
 		{
-			fwrite(ptcur,size,1,file);
+			printf("--  write failed -----!\n");
 		}
 		fclose(file);
 
@@ -390,8 +370,6 @@ void main()
 	int height = 480;
 	int format  = V4L2_PIX_FMT_MJPEG; 	
 	struct v4l2_buffer buf;
-	int framesizeIn;
-    unsigned char *framebuffer;
 	
 	int md_capture = 0;
 	static int flag_photo = 0;
@@ -414,9 +392,6 @@ void main()
 		printf("---start_previewing------success------- !\n ");
 	}
 	
-	framebuffer = (unsigned char *)calloc(1,(size_t)(width*height<<1));
-	framesizeIn = (width * height << 1);
-    
     /****************  移动 侦测 相关  ********************/	
 	md_mask[0] = strtol(optarg, &endptr, 16);
 	
@@ -450,11 +425,7 @@ void main()
 	    if( (XU_MD_Get_RESULT(vd->fd, md_mask) > 12) && (flag_photo > 10) )
 		{
 			printf(" ----@@@@@@   侦测到有物体移动 开始拍照!\n");
-			if (buf.bytesused > framesizeIn)
-				memcpy(framebuffer, buffers[buf.index].start,(size_t)framesizeIn);
-		    else
-				memcpy(framebuffer, buffers[buf.index].start,(size_t)buf.bytesused);
-			get_picture(framebuffer, buf.bytesused,0);
+			get_picture(buffers[buf.index].start, buf.bytesused,0);
 			usleep(1);
 			md_capture = 1;
 		}
@@ -471,8 +442,6 @@ void main()
 		flag_photo ++;	
 	}
 	
-	free(framebuffer);
-	framebuffer = NULL;
 	close_v4l2(vd);
 	
 }
@@ -0,0 +1,486 @@
+//----------------------------------------------//
+//	글리프 아틀라스 텍스트 오버레이		//
+//----------------------------------------------//
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "text_overlay.h"
+#include "text_overlay_font.h"
+
+#define OVL_MAX_SCALE       4
+#define OVL_SHADOW_ALPHA    192     // 외곽선 세기 (256 = 불투명)
+
+// 타일 픽셀마다 d' = (d * keep + c * fg + k * (256 - keep - fg) + 128) >> 8
+// (c = 글자색, k = 외곽선색 = 검정. keep + fg <= 256, 완전히 덮이면 keep = 0, fg = 256 이라 d' = c)
+typedef struct {
+    uint16_t keep;
+    uint16_t fg;
+} ovl_px_t;
+
+typedef struct {
+    int used;
+    int x, y;
+    int scale;
+    uint32_t rgb;
+    char text[OVL_MAX_TEXT + 1];
+
+    int tw, th;                 // 타일 크기 (외곽선 1픽셀 포함)
+    ovl_px_t *px;               // tw * th
+    int16_t *span;              // 줄마다 [x0, x1) (블렌딩할 것이 없으면 x0 == x1)
+    size_t px_cap;
+    int span_cap;
+
+    // 타일을 만들 때 한 번 변환해 둔 색
+    uint8_t r, g, b;
+    uint8_t cy, cu, cv;
+    uint8_t r5, g6, b5;
+} ovl_item_t;
+
+struct ovl {
+    int max_items;
+    ovl_item_t *items;
+    ovl_stats_t stats;
+    uint8_t *scratch;           // 렌더용 글자 알파 + 가로 최댓값 (가장 큰 타일 크기로 늘어남)
+    size_t scratch_cap;
+    uint8_t glyphs[OVL_FONT_GLYPHS][OVL_FONT_H][OVL_FONT_W];     // 알파 0..255
+};
+
+static void ovl_decode_font(ovl_t *o)
+{
+    int g, r, c;
+
+    for (g = 0; g < OVL_FONT_GLYPHS; g++) {
+        for (r = 0; r < OVL_FONT_H; r++) {
+            const char *row = ovl_font_rows[g * OVL_FONT_H + r];
+            for (c = 0; c < OVL_FONT_W; c++) {
+                char ch = row[c];
+                int v = 0;
+                if (ch >= '0' && ch <= '9')
+                    v = ch - '0';
+                else if (ch >= 'a' && ch <= 'f')
+                    v = ch - 'a' + 10;
+                o->glyphs[g][r][c] = (uint8_t)(v * 17);
+            }
+        }
+    }
+}
+
+ovl_t *ovl_create(int max_items)
+{
+    ovl_t *o;
+
+    if (max_items <= 0)
+        return NULL;
+    o = (ovl_t *)calloc(1, sizeof(*o));
+    if (!o)
+        return NULL;
+    o->items = (ovl_item_t *)calloc(max_items, sizeof(ovl_item_t));
+    if (!o->items) {
+        free(o);
+        return NULL;
+    }
+    o->max_items = max_items;
+    ovl_decode_font(o);
+    return o;
+}
+
+void ovl_destroy(ovl_t *o)
+{
+    int i;
+
+    if (!o)
+        return;
+    for (i = 0; i < o->max_items; i++) {
+        free(o->items[i].px);
+        free(o->items[i].span);
+    }
+    free(o->items);
+    free(o->scratch);
+    free(o);
+}
+
+static uint8_t ovl_clamp8(double v)
+{
+    if (v <= 0.0)
+        return 0;
+    if (v >= 255.0)
+        return 255;
+    return (uint8_t)(v + 0.5);
+}
+
+static void ovl_set_color(ovl_item_t *it, uint32_t rgb)
+{
+    double r = (rgb >> 16) & 0xff, g = (rgb >> 8) & 0xff, b = rgb & 0xff;
+
+    it->rgb = rgb;
+    it->r = (uint8_t)r;
+    it->g = (uint8_t)g;
+    it->b = (uint8_t)b;
+    // BT.601 full range (yuyv_convert 의 역변환)
+    it->cy = ovl_clamp8(0.299 * r + 0.587 * g + 0.114 * b);
+    it->cu = ovl_clamp8(-0.168736 * r - 0.331264 * g + 0.5 * b + 128.0);
+    it->cv = ovl_clamp8(0.5 * r - 0.418688 * g - 0.081312 * b + 128.0);
+    it->r5 = (uint8_t)(it->r >> 3);
+    it->g6 = (uint8_t)(it->g >> 2);
+    it->b5 = (uint8_t)(it->b >> 3);
+}
+
+static int ovl_reserve(ovl_item_t *it, int tw, int th)
+{
+    size_t need = (size_t)tw * th;
+
+    if (need > it->px_cap) {
+        ovl_px_t *p = (ovl_px_t *)realloc(it->px, need * sizeof(ovl_px_t));
+        if (!p)
+            return -1;
+        it->px = p;
+        it->px_cap = need;
+    }
+    if (th > it->span_cap) {
+        int16_t *s = (int16_t *)realloc(it->span, (size_t)th * 2 * sizeof(int16_t));
+        if (!s)
+            return -1;
+        it->span = s;
+        it->span_cap = th;
+    }
+    return 0;
+}
+
+// 글자 알파 → 1픽셀 팽창한 외곽선 알파 → keep / fg 타일과 줄별 범위
+static int ovl_render(ovl_t *o, ovl_item_t *it)
+{
+    int len = (int)strlen(it->text);
+    int s = it->scale;
+    int gw = OVL_FONT_W * s, gh = OVL_FONT_H * s;
+    int tw = len * gw + 2, th = gh + 2;
+    uint8_t *alpha, *hmax;
+    int i, r, c;
+
+    if (ovl_reserve(it, tw, th) < 0)
+        return -1;
+    if ((size_t)tw * th * 2 > o->scratch_cap) {
+        uint8_t *p = (uint8_t *)realloc(o->scratch, (size_t)tw * th * 2);
+        if (!p)
+            return -1;
+        o->scratch = p;
+        o->scratch_cap = (size_t)tw * th * 2;
+    }
+    alpha = o->scratch;
+    hmax = alpha + (size_t)tw * th;
+    memset(alpha, 0, (size_t)tw * th);
+
+    for (i = 0; i < len; i++) {
+        int ch = (unsigned char)it->text[i];
+        if (ch < OVL_FONT_FIRST || ch >= OVL_FONT_FIRST + OVL_FONT_GLYPHS)
+            ch = '?';
+        const uint8_t (*glyph)[OVL_FONT_W] = o->glyphs[ch - OVL_FONT_FIRST];
+        for (r = 0; r < gh; r++) {
+            uint8_t *dst = alpha + (size_t)(r + 1) * tw + 1 + i * gw;
+            const uint8_t *src = glyph[r / s];
+            for (c = 0; c < gw; c++)
+                dst[c] = src[c / s];
+        }
+    }
+
+    // 외곽선 = 3x3 최댓값 (가로 → 세로로 나눠서)
+    for (r = 0; r < th; r++) {
+        const uint8_t *a = alpha + (size_t)r * tw;
+        uint8_t *h = hmax + (size_t)r * tw;
+        for (c = 0; c < tw; c++) {
+            int m = a[c];
+            if (c > 0 && a[c - 1] > m)
+                m = a[c - 1];
+            if (c + 1 < tw && a[c + 1] > m)
+                m = a[c + 1];
+            h[c] = (uint8_t)m;
+        }
+    }
+
+    for (r = 0; r < th; r++) {
+        const uint8_t *a = alpha + (size_t)r * tw;
+        const uint8_t *h0 = hmax + (size_t)(r > 0 ? r - 1 : r) * tw;
+        const uint8_t *h1 = hmax + (size_t)r * tw;
+        const uint8_t *h2 = hmax + (size_t)(r + 1 < th ? r + 1 : r) * tw;
+        ovl_px_t *p = &it->px[(size_t)r * tw];
+        int x0 = tw, x1 = 0;
+        for (c = 0; c < tw; c++) {
+            int m = h0[c] > h1[c] ? h0[c] : h1[c];
+            if (h2[c] > m)
+                m = h2[c];
+            int fa = a[c] + (a[c] >> 7);                    // 0..256
+            int sa = (m + (m >> 7)) * OVL_SHADOW_ALPHA >> 8;
+            p[c].fg = (uint16_t)fa;
+            p[c].keep = (uint16_t)(((256 - sa) * (256 - fa) + 128) >> 8);
+            if (sa || fa) {
+                if (c < x0)
+                    x0 = c;
+                x1 = c + 1;
+            }
+        }
+        if (x0 > x1)
+            x0 = x1 = 0;
+        it->span[r * 2] = (int16_t)x0;
+        it->span[r * 2 + 1] = (int16_t)x1;
+    }
+
+    it->tw = tw;
+    it->th = th;
+    o->stats.renders++;
+    return 0;
+}
+
+int ovl_set_text(ovl_t *o, int item, int x, int y, int scale, uint32_t rgb, const char *text)
+{
+    ovl_item_t *it;
+
+    if (!o || !text || item < 0 || item >= o->max_items || scale < 1 || scale > OVL_MAX_SCALE)
+        return -1;
+    it = &o->items[item];
+    rgb &= 0xffffff;
+    it->x = x;
+    it->y = y;
+
+    if (it->used && it->scale == scale && it->rgb == rgb &&
+        strncmp(it->text, text, OVL_MAX_TEXT) == 0) {
+        o->stats.unchanged++;
+        return 0;
+    }
+
+    strncpy(it->text, text, OVL_MAX_TEXT);
+    it->text[OVL_MAX_TEXT] = '\0';
+    it->scale = scale;
+    ovl_set_color(it, rgb);
+    if (ovl_render(o, it) < 0) {
+        it->used = 0;
+        return -1;
+    }
+    it->used = 1;
+    return 1;
+}
+
+int ovl_printf(ovl_t *o, int item, int x, int y, int scale, uint32_t rgb, const char *fmt, ...)
+{
+    char buf[OVL_MAX_TEXT + 1];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return ovl_set_text(o, item, x, y, scale, rgb, buf);
+}
+
+void ovl_clear(ovl_t *o, int item)
+{
+    if (o && item >= 0 && item < o->max_items)
+        o->items[item].used = 0;
+}
+
+int ovl_item_rect(const ovl_t *o, int item, int *x, int *y, int *w, int *h)
+{
+    const ovl_item_t *it;
+
+    if (!o || item < 0 || item >= o->max_items || !o->items[item].used)
+        return -1;
+    it = &o->items[item];
+    *x = it->x - 1;
+    *y = it->y - 1;
+    *w = it->tw;
+    *h = it->th;
+    return 0;
+}
+
+void ovl_get_stats(const ovl_t *o, ovl_stats_t *stats)
+{
+    if (o && stats)
+        *stats = o->stats;
+}
+
+static inline uint8_t ovl_mix(int d, int c, int keep, int fg)
+{
+    return (uint8_t)((d * keep + c * fg + 128) >> 8);
+}
+
+// 외곽선색이 검정이 아닌 성분 (U / V 의 검정은 128)
+static inline uint8_t ovl_mix_k(int d, int c, int k, int keep, int fg)
+{
+    return (uint8_t)((d * keep + c * fg + k * (256 - keep - fg) + 128) >> 8);
+}
+
+// 프레임과 겹치는 타일 줄 r 의 범위를 프레임 좌표 [*fx0, *fx1) 로. 겹치지 않으면 0
+static int ovl_row_span(const ovl_item_t *it, int r, int width, int *fx0, int *fx1)
+{
+    int ox = it->x - 1;
+    int x0 = ox + it->span[r * 2];
+    int x1 = ox + it->span[r * 2 + 1];
+
+    if (x0 < 0)
+        x0 = 0;
+    if (x1 > width)
+        x1 = width;
+    *fx0 = x0;
+    *fx1 = x1;
+    return x0 < x1;
+}
+
+static const ovl_px_t ovl_clear_px = { 256, 0 };
+
+// 프레임 좌표 (fx, 타일 줄 r) 의 타일 픽셀. 타일 밖이면 투명
+static inline const ovl_px_t *ovl_px_at(const ovl_item_t *it, int r, int fx)
+{
+    int c = fx - (it->x - 1);
+
+    if (r < 0 || r >= it->th || c < it->span[r * 2] || c >= it->span[r * 2 + 1])
+        return &ovl_clear_px;
+    return &it->px[(size_t)r * it->tw + c];
+}
+
+static uint64_t ovl_blit_packed(const ovl_item_t *it, uint8_t *data, int stride,
+                                int width, int height, ovl_format_t fmt)
+{
+    int oy = it->y - 1, r;
+    uint64_t n = 0;
+
+    for (r = 0; r < it->th; r++) {
+        int fy = oy + r, fx0, fx1, fx;
+        if (fy < 0 || fy >= height || !ovl_row_span(it, r, width, &fx0, &fx1))
+            continue;
+        uint8_t *row = data + (size_t)fy * stride;
+        const ovl_px_t *p = &it->px[(size_t)r * it->tw + (fx0 - (it->x - 1))];
+        n += fx1 - fx0;
+
+        switch (fmt) {
+        case OVL_FMT_RGB24:
+        case OVL_FMT_BGR24: {
+            int c0 = fmt == OVL_FMT_RGB24 ? it->r : it->b;
+            int c2 = fmt == OVL_FMT_RGB24 ? it->b : it->r;
+            uint8_t *d = row + fx0 * 3;
+            for (fx = fx0; fx < fx1; fx++, p++, d += 3) {
+                d[0] = ovl_mix(d[0], c0, p->keep, p->fg);
+                d[1] = ovl_mix(d[1], it->g, p->keep, p->fg);
+                d[2] = ovl_mix(d[2], c2, p->keep, p->fg);
+            }
+            break;
+        }
+        case OVL_FMT_BGRX32: {
+            uint8_t *d = row + fx0 * 4;
+            for (fx = fx0; fx < fx1; fx++, p++, d += 4) {
+                d[0] = ovl_mix(d[0], it->b, p->keep, p->fg);
+                d[1] = ovl_mix(d[1], it->g, p->keep, p->fg);
+                d[2] = ovl_mix(d[2], it->r, p->keep, p->fg);
+            }
+            break;
+        }
+        case OVL_FMT_RGB565: {
+            uint8_t *d = row + fx0 * 2;
+            for (fx = fx0; fx < fx1; fx++, p++, d += 2) {
+                int v = d[0] | (d[1] << 8);
+                int r5 = ovl_mix(v >> 11, it->r5, p->keep, p->fg);
+                int g6 = ovl_mix((v >> 5) & 0x3f, it->g6, p->keep, p->fg);
+                int b5 = ovl_mix(v & 0x1f, it->b5, p->keep, p->fg);
+                v = (r5 << 11) | (g6 << 5) | b5;
+                d[0] = (uint8_t)v;
+                d[1] = (uint8_t)(v >> 8);
+            }
+            break;
+        }
+        case OVL_FMT_YUYV: {
+            // Y 는 픽셀마다, U / V 는 짝의 평균 알파로
+            for (fx = fx0 & ~1; fx < fx1; fx += 2) {
+                const ovl_px_t *a = ovl_px_at(it, r, fx);
+                const ovl_px_t *b = fx + 1 < width ? ovl_px_at(it, r, fx + 1) : &ovl_clear_px;
+                uint8_t *d = row + fx * 2;
+                int keep = (a->keep + b->keep) >> 1, fg = (a->fg + b->fg) >> 1;
+                d[0] = ovl_mix(d[0], it->cy, a->keep, a->fg);
+                d[2] = ovl_mix(d[2], it->cy, b->keep, b->fg);
+                d[1] = ovl_mix_k(d[1], it->cu, 128, keep, fg);
+                d[3] = ovl_mix_k(d[3], it->cv, 128, keep, fg);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return n;
+}
+
+int ovl_composite(ovl_t *o, uint8_t *data, int stride, int width, int height, ovl_format_t fmt)
+{
+    int i;
+
+    if (!o || !data || width <= 0 || height <= 0 || (unsigned)fmt >= OVL_FMT_NV12)
+        return -1;
+    if (fmt == OVL_FMT_YUYV && (width & 1))
+        return -1;
+
+    for (i = 0; i < o->max_items; i++) {
+        if (o->items[i].used)
+            o->stats.blended_pixels += ovl_blit_packed(&o->items[i], data, stride, width, height, fmt);
+    }
+    o->stats.composites++;
+    return 0;
+}
+
+int ovl_composite_nv12(ovl_t *o, uint8_t *y, int y_stride, uint8_t *uv, int uv_stride,
+                       int width, int height)
+{
+    int i;
+
+    if (!o || !y || !uv || width <= 0 || height <= 0 || (width & 1) || (height & 1))
+        return -1;
+
+    for (i = 0; i < o->max_items; i++) {
+        const ovl_item_t *it = &o->items[i];
+        int oy = it->y - 1, r, fx, fx0, fx1;
+        if (!it->used)
+            continue;
+
+        // Y 평면
+        for (r = 0; r < it->th; r++) {
+            int fy = oy + r;
+            if (fy < 0 || fy >= height || !ovl_row_span(it, r, width, &fx0, &fx1))
+                continue;
+            uint8_t *d = y + (size_t)fy * y_stride + fx0;
+            const ovl_px_t *p = &it->px[(size_t)r * it->tw + (fx0 - (it->x - 1))];
+            for (fx = fx0; fx < fx1; fx++, p++, d++)
+                *d = ovl_mix(*d, it->cy, p->keep, p->fg);
+            o->stats.blended_pixels += fx1 - fx0;
+        }
+
+        // UV 평면: 2x2 블록의 평균 알파
+        int cy0 = oy < 0 ? 0 : oy >> 1;
+        int cy1 = (oy + it->th + 1) >> 1;
+        if (cy1 > height / 2)
+            cy1 = height / 2;
+        for (int cyr = cy0; cyr < cy1; cyr++) {
+            int r0 = cyr * 2 - oy, r1 = r0 + 1;
+            int a0 = 0, a1 = 0, b0 = 0, b1 = 0;
+            int has0 = r0 >= 0 && r0 < it->th && ovl_row_span(it, r0, width, &a0, &a1);
+            int has1 = r1 >= 0 && r1 < it->th && ovl_row_span(it, r1, width, &b0, &b1);
+            if (!has0 && !has1)
+                continue;
+            if (!has0) {
+                a0 = b0;
+                a1 = b1;
+            } else if (has1) {
+                if (b0 < a0)
+                    a0 = b0;
+                if (b1 > a1)
+                    a1 = b1;
+            }
+            uint8_t *d = uv + (size_t)cyr * uv_stride;
+            for (fx = a0 & ~1; fx < a1; fx += 2) {
+                const ovl_px_t *p00 = ovl_px_at(it, r0, fx), *p01 = ovl_px_at(it, r0, fx + 1);
+                const ovl_px_t *p10 = ovl_px_at(it, r1, fx), *p11 = ovl_px_at(it, r1, fx + 1);
+                int keep = (p00->keep + p01->keep + p10->keep + p11->keep) >> 2;
+                int fg = (p00->fg + p01->fg + p10->fg + p11->fg) >> 2;
+                d[fx] = ovl_mix_k(d[fx], it->cu, 128, keep, fg);
+                d[fx + 1] = ovl_mix_k(d[fx + 1], it->cv, 128, keep, fg);
+            }
+        }
+    }
+    o->stats.composites++;
+    return 0;
+}
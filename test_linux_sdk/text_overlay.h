@@ -0,0 +1,70 @@
+#ifndef TEXT_OVERLAY_H
+#define TEXT_OVERLAY_H
+
+// 프레임 위 텍스트 오버레이 (FPS / 프레임 번호 / 해상도 등)
+// cv::putText 나 XDrawString 처럼 매 프레임 글자 윤곽을 다시 그리지 않는다.
+//
+// - 글꼴: 미리 래스터라이즈한 고정폭 안티앨리어스 글리프 아틀라스 (ASCII 0x20..0x7E, 10x19 셀)
+// - 항목(줄)마다 타일(글자 알파 + 1픽셀 외곽선 알파)을 갖고, 글자가 바뀐 항목만 타일을 다시 만든다
+// - 글자는 호출자 스택 버퍼에 snprintf 로 만들어 넘긴다 (ovl_printf 는 내부 고정 버퍼 사용, 힙 할당 없음)
+// - 합성은 타일의 빈 가장자리를 건너뛰는 알파 블렌딩이며, BGR/BGRX/RGB565 와
+//   YUYV / NV12 에 색변환 없이 바로 쓴다 (색은 타일을 만들 때 한 번 변환)
+// - YUV 색은 뷰어의 yuyv_convert(CC_MATRIX_BT601, CC_RANGE_FULL) 와 같은 기준
+//
+// 한 오버레이는 한 스레드에서만 쓴다.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OVL_MAX_TEXT        128     // 항목 하나의 최대 글자 수
+#define OVL_CELL_W          10      // 글자 셀 (scale 1)
+#define OVL_CELL_H          19
+
+typedef enum {
+    OVL_FMT_RGB24 = 0,      // R, G, B
+    OVL_FMT_BGR24,          // B, G, R (cv::Mat CV_8UC3)
+    OVL_FMT_BGRX32,         // B, G, R, X (XImage 24/32bpp)
+    OVL_FMT_RGB565,         // 리틀엔디안 R5 G6 B5
+    OVL_FMT_YUYV,           // Y0 U Y1 V
+    OVL_FMT_NV12            // Y 평면 + UV 인터리브 평면 (ovl_composite_nv12)
+} ovl_format_t;
+
+typedef struct {
+    uint64_t renders;           // 타일을 다시 만든 횟수
+    uint64_t unchanged;         // 글자가 같아 건너뛴 갱신
+    uint64_t composites;        // ovl_composite 호출
+    uint64_t blended_pixels;    // 알파가 0 이 아니어서 실제로 쓴 픽셀
+} ovl_stats_t;
+
+typedef struct ovl ovl_t;
+
+ovl_t *ovl_create(int max_items);
+void ovl_destroy(ovl_t *o);
+
+// 항목 item 의 글자 / 위치 (왼쪽 위, 픽셀) / 배율 (1..4) / 색 (0xRRGGBB)
+// 글자, 배율, 색이 모두 같으면 타일을 그대로 쓴다 (위치만 바뀌어도 다시 만들지 않음)
+// 다시 만들었으면 1, 그대로면 0, 잘못된 인자 -1
+int ovl_set_text(ovl_t *o, int item, int x, int y, int scale, uint32_t rgb, const char *text);
+int ovl_printf(ovl_t *o, int item, int x, int y, int scale, uint32_t rgb, const char *fmt, ...)
+    __attribute__((format(printf, 7, 8)));
+void ovl_clear(ovl_t *o, int item);
+
+// 보이는 항목을 모두 프레임에 합성한다 (프레임 밖으로 나간 부분은 잘림)
+// stride 는 바이트 단위. NV12 는 ovl_composite_nv12 를 쓴다. 성공 0
+int ovl_composite(ovl_t *o, uint8_t *data, int stride, int width, int height, ovl_format_t fmt);
+int ovl_composite_nv12(ovl_t *o, uint8_t *y, int y_stride, uint8_t *uv, int uv_stride,
+                       int width, int height);
+
+// 항목이 차지하는 영역 (타일 크기, 외곽선 포함). 비어 있으면 -1
+int ovl_item_rect(const ovl_t *o, int item, int *x, int *y, int *w, int *h);
+
+void ovl_get_stats(const ovl_t *o, ovl_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_OVERLAY_H
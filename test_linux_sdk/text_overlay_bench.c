@@ -0,0 +1,362 @@
+//----------------------------------------------//
+//	텍스트 오버레이 벤치마크 / 검증			//
+//----------------------------------------------//
+// 사용법: ./text_overlay_bench [frames]
+// 포맷 간 합성 결과 일치, 불투명 글자 픽셀 = 지정 색, 잘림 / 프레임 밖 쓰기 없음,
+// 같은 글자 재설정 시 타일을 다시 만들지 않는지 확인하고,
+// 1080p 에서 매 프레임 전체 재렌더 vs 바뀐 줄만 재렌더 비용을 잰다.
+// 불일치가 있으면 1 을 반환한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "text_overlay.h"
+
+#define CHECK_W         320
+#define CHECK_H         96
+#define GUARD           64      // 프레임 앞뒤 보호 바이트
+#define GUARD_BYTE      0xA5
+#define BG_GRAY         90
+#define TEXT_RGB        0x00FF00
+#define INFO_RGB        0xFFFF00
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static uint8_t clamp8(double v)
+{
+    return v <= 0.0 ? 0 : (v >= 255.0 ? 255 : (uint8_t)(v + 0.5));
+}
+
+// 보호 바이트로 둘러싼 프레임
+static uint8_t *alloc_frame(size_t size, uint8_t fill)
+{
+    uint8_t *p = (uint8_t *)malloc(size + GUARD * 2);
+    if (!p)
+        return NULL;
+    memset(p, GUARD_BYTE, GUARD);
+    memset(p + GUARD, fill, size);
+    memset(p + GUARD + size, GUARD_BYTE, GUARD);
+    return p + GUARD;
+}
+
+static int guard_ok(const uint8_t *frame, size_t size)
+{
+    int i;
+    for (i = 0; i < GUARD; i++) {
+        if (frame[-1 - i] != GUARD_BYTE || frame[size + i] != GUARD_BYTE)
+            return 0;
+    }
+    return 1;
+}
+
+static void free_frame(uint8_t *frame)
+{
+    if (frame)
+        free(frame - GUARD);
+}
+
+static void set_check_text(ovl_t *o, int x0)
+{
+    ovl_set_text(o, 0, x0, 4, 1, TEXT_RGB, "FPS: 59.9 | Frame: 12345");
+    ovl_set_text(o, 1, 7, 30, 2, INFO_RGB, "1080p@60 YUYV");
+    ovl_set_text(o, 2, CHECK_W - 40, CHECK_H - 12, 1, 0xFF4020, "clip");   // 오른쪽 아래로 잘림
+    ovl_set_text(o, 3, -15, -6, 1, 0xFFFFFF, "edge");                     // 왼쪽 위로 잘림
+}
+
+//------------------------------------------------------------------------------
+// 포맷 간 일치 / 색 / 잘림
+//------------------------------------------------------------------------------
+
+static int verify_formats(void)
+{
+    const size_t n = (size_t)CHECK_W * CHECK_H;
+    uint8_t *rgb = alloc_frame(n * 3, BG_GRAY);
+    uint8_t *bgr = alloc_frame(n * 3, BG_GRAY);
+    uint8_t *bgrx = alloc_frame(n * 4, BG_GRAY);
+    uint8_t *yuyv = alloc_frame(n * 2, 0);
+    uint8_t *nv12 = alloc_frame(n * 3 / 2, 128);
+    ovl_t *o = ovl_create(4);
+    int failures = 0, opaque = 0, outlined = 0, touched = 0;
+    size_t i;
+
+    if (!rgb || !bgr || !bgrx || !yuyv || !nv12 || !o) {
+        printf("메모리 부족\n");
+        return 1;
+    }
+    for (i = 0; i < n; i++) {
+        yuyv[i * 2] = BG_GRAY;
+        yuyv[i * 2 + 1] = 128;
+    }
+    memset(nv12, BG_GRAY, n);
+
+    set_check_text(o, 5);
+    ovl_composite(o, rgb, CHECK_W * 3, CHECK_W, CHECK_H, OVL_FMT_RGB24);
+    ovl_composite(o, bgr, CHECK_W * 3, CHECK_W, CHECK_H, OVL_FMT_BGR24);
+    ovl_composite(o, bgrx, CHECK_W * 4, CHECK_W, CHECK_H, OVL_FMT_BGRX32);
+    ovl_composite(o, yuyv, CHECK_W * 2, CHECK_W, CHECK_H, OVL_FMT_YUYV);
+    ovl_composite_nv12(o, nv12, CHECK_W, nv12 + n, CHECK_W, CHECK_W, CHECK_H);
+
+    for (i = 0; i < n; i++) {
+        const uint8_t *a = rgb + i * 3, *b = bgr + i * 3, *c = bgrx + i * 4;
+        if (a[0] != b[2] || a[1] != b[1] || a[2] != b[0] ||
+            c[0] != b[0] || c[1] != b[1] || c[2] != b[2] || c[3] != BG_GRAY) {
+            if (failures < 5)
+                printf("  픽셀 %zu: RGB24 / BGR24 / BGRX32 결과가 다름\n", i);
+            failures++;
+        }
+        if (yuyv[i * 2] != nv12[i]) {
+            if (failures < 5)
+                printf("  픽셀 %zu: YUYV Y %d != NV12 Y %d\n", i, yuyv[i * 2], nv12[i]);
+            failures++;
+        }
+        if (a[0] != BG_GRAY || a[1] != BG_GRAY || a[2] != BG_GRAY)
+            touched++;
+        if (a[0] == 0x00 && a[1] == 0xFF && a[2] == 0x00)
+            opaque++;
+        if (a[0] < BG_GRAY / 2 && a[1] < BG_GRAY / 2 && a[2] < BG_GRAY / 2)
+            outlined++;
+    }
+    if (!opaque || !outlined) {
+        printf("  불투명 글자 픽셀 %d, 외곽선 픽셀 %d (둘 다 있어야 함)\n", opaque, outlined);
+        failures++;
+    }
+
+    // 같은 밝기의 회색 위에 합성한 Y 는 RGB 결과의 Y 와 거의 같아야 한다 (오차는 반올림)
+    for (i = 0; i < n; i++) {
+        const uint8_t *a = rgb + i * 3;
+        int y = clamp8(0.299 * a[0] + 0.587 * a[1] + 0.114 * a[2]);
+        if (abs(y - nv12[i]) > 2) {
+            if (failures < 5)
+                printf("  픽셀 %zu: RGB 합성의 Y %d, YUV 합성의 Y %d\n", i, y, nv12[i]);
+            failures++;
+        }
+    }
+
+    // 글자가 불투명하게 덮은 YUYV 짝의 U / V 는 글자색 그대로
+    {
+        int cu = clamp8(-0.168736 * 0 - 0.331264 * 255 + 0.5 * 0 + 128.0);
+        int cv = clamp8(0.5 * 0 - 0.418688 * 255 - 0.081312 * 0 + 128.0);
+        int pairs = 0;
+        for (i = 0; i + 1 < n; i += 2) {
+            const uint8_t *a = rgb + i * 3;
+            if (a[0] == 0 && a[1] == 0xFF && a[2] == 0 && a[3] == 0 && a[4] == 0xFF && a[5] == 0) {
+                pairs++;
+                if (yuyv[i * 2 + 1] != cu || yuyv[i * 2 + 3] != cv) {
+                    if (failures < 5)
+                        printf("  짝 %zu: U/V %d/%d != %d/%d\n", i, yuyv[i * 2 + 1], yuyv[i * 2 + 3], cu, cv);
+                    failures++;
+                }
+            }
+        }
+        if (!pairs) {
+            printf("  불투명 YUYV 짝이 없음\n");
+            failures++;
+        }
+    }
+
+    if (!guard_ok(rgb, n * 3) || !guard_ok(bgr, n * 3) || !guard_ok(bgrx, n * 4) ||
+        !guard_ok(yuyv, n * 2) || !guard_ok(nv12, n * 3 / 2)) {
+        printf("  프레임 밖에 씀\n");
+        failures++;
+    }
+
+    printf("포맷 간 일치 / 색 / 잘림: 글자 %d 픽셀 (불투명 %d, 외곽선 %d) %s\n",
+           touched, opaque, outlined, failures ? "FAIL" : "OK");
+
+    ovl_destroy(o);
+    free_frame(rgb);
+    free_frame(bgr);
+    free_frame(bgrx);
+    free_frame(yuyv);
+    free_frame(nv12);
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// 바뀐 줄만 다시 렌더
+//------------------------------------------------------------------------------
+
+static int verify_dirty(void)
+{
+    const size_t size = (size_t)CHECK_W * CHECK_H * 3;
+    uint8_t *first = alloc_frame(size, BG_GRAY);
+    uint8_t *again = alloc_frame(size, BG_GRAY);
+    uint8_t *moved = alloc_frame(size, BG_GRAY);
+    uint8_t *fresh = alloc_frame(size, BG_GRAY);
+    ovl_t *o = ovl_create(4);
+    ovl_t *ref = ovl_create(4);
+    ovl_stats_t st;
+    int failures = 0, i;
+
+    if (!first || !again || !moved || !fresh || !o || !ref) {
+        printf("메모리 부족\n");
+        return 1;
+    }
+
+    set_check_text(o, 5);
+    ovl_composite(o, first, CHECK_W * 3, CHECK_W, CHECK_H, OVL_FMT_BGR24);
+    for (i = 0; i < 1000; i++)
+        set_check_text(o, 5);
+    ovl_get_stats(o, &st);
+    if (st.renders != 4 || st.unchanged != 4000) {
+        printf("  같은 글자 재설정: renders %llu (4 이어야 함), unchanged %llu\n",
+               (unsigned long long)st.renders, (unsigned long long)st.unchanged);
+        failures++;
+    }
+    ovl_composite(o, again, CHECK_W * 3, CHECK_W, CHECK_H, OVL_FMT_BGR24);
+    if (memcmp(first, again, size) != 0) {
+        printf("  재사용한 타일의 합성 결과가 다름\n");
+        failures++;
+    }
+
+    // 위치만 바꾸면 다시 렌더하지 않고, 처음부터 그 위치에 만든 것과 같아야 한다
+    set_check_text(o, 40);
+    ovl_get_stats(o, &st);
+    ovl_composite(o, moved, CHECK_W * 3, CHECK_W, CHECK_H, OVL_FMT_BGR24);
+    set_check_text(ref, 40);
+    ovl_composite(ref, fresh, CHECK_W * 3, CHECK_W, CHECK_H, OVL_FMT_BGR24);
+    if (st.renders != 4 || memcmp(moved, fresh, size) != 0) {
+        printf("  위치 이동: renders %llu, 결과 %s\n", (unsigned long long)st.renders,
+               memcmp(moved, fresh, size) ? "다름" : "같음");
+        failures++;
+    }
+
+    // 한 줄만 바꾸면 그 줄만
+    ovl_set_text(o, 0, 40, 4, 1, TEXT_RGB, "FPS: 60.0 | Frame: 12346");
+    ovl_get_stats(o, &st);
+    if (st.renders != 5) {
+        printf("  한 줄 변경: renders %llu (5 이어야 함)\n", (unsigned long long)st.renders);
+        failures++;
+    }
+
+    printf("바뀐 줄만 재렌더: %s\n", failures ? "FAIL" : "OK");
+
+    ovl_destroy(o);
+    ovl_destroy(ref);
+    free_frame(first);
+    free_frame(again);
+    free_frame(moved);
+    free_frame(fresh);
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// 1080p 비용
+//------------------------------------------------------------------------------
+
+typedef struct {
+    const char *name;
+    ovl_format_t fmt;
+    int bpp_num, bpp_den;       // 바이트 / 픽셀
+} bench_fmt_t;
+
+// 뷰어 오버레이와 같은 구성: 매 프레임 바뀌는 프레임 번호 줄, 가끔 바뀌는 FPS 줄, 고정 정보 줄
+static void update_lines(ovl_t *o, int frame, int full)
+{
+    char buf[OVL_MAX_TEXT];
+    int i;
+
+    if (full) {
+        for (i = 0; i < 3; i++)
+            ovl_clear(o, i);
+    }
+    snprintf(buf, sizeof(buf), "Frame: %d", frame);
+    ovl_set_text(o, 0, 10, 10, 2, TEXT_RGB, buf);
+    snprintf(buf, sizeof(buf), "FPS: %.1f (%.1f ms)", 60.0 - (frame / 60) % 3 * 0.1, 16.7);
+    ovl_set_text(o, 1, 10, 52, 2, TEXT_RGB, buf);
+    snprintf(buf, sizeof(buf), "1920x1080 @ 60fps | MJPEG | ESC: quit, S: save, 1-6: resolution");
+    ovl_set_text(o, 2, 10, 94, 1, INFO_RGB, buf);
+}
+
+static double bench_one(const bench_fmt_t *bf, uint8_t *frame, int frames, int full, ovl_stats_t *st)
+{
+    const int w = 1920, h = 1080;
+    ovl_t *o = ovl_create(3);
+    double t0, t1;
+    int f;
+
+    if (!o)
+        return -1.0;
+    t0 = now_ms();
+    for (f = 0; f < frames; f++) {
+        update_lines(o, f, full);
+        if (bf->fmt == OVL_FMT_NV12)
+            ovl_composite_nv12(o, frame, w, frame + (size_t)w * h, w, w, h);
+        else
+            ovl_composite(o, frame, w * bf->bpp_num / bf->bpp_den, w, h, bf->fmt);
+    }
+    t1 = now_ms();
+    ovl_get_stats(o, st);
+    ovl_destroy(o);
+    return (t1 - t0) * 1000.0 / frames;
+}
+
+static void bench_1080p(int frames)
+{
+    static const bench_fmt_t fmts[] = {
+        { "BGR24",  OVL_FMT_BGR24,  3, 1 },
+        { "BGRX32", OVL_FMT_BGRX32, 4, 1 },
+        { "YUYV",   OVL_FMT_YUYV,   2, 1 },
+        { "NV12",   OVL_FMT_NV12,   3, 2 },
+    };
+    const size_t max_size = (size_t)1920 * 1080 * 4;
+    uint8_t *frame = (uint8_t *)malloc(max_size);
+    uint8_t *copy = (uint8_t *)malloc(max_size);
+    size_t k;
+
+    if (!frame || !copy) {
+        printf("메모리 부족\n");
+        free(frame);
+        free(copy);
+        return;
+    }
+    memset(frame, 100, max_size);
+
+    printf("\n1080p 오버레이 3줄, %d 프레임 (us/frame)\n", frames);
+    printf("  %-7s %12s %12s %8s %14s %12s\n", "format", "full", "dirty", "speedup", "renders/frame", "frame copy");
+    for (k = 0; k < sizeof(fmts) / sizeof(fmts[0]); k++) {
+        const bench_fmt_t *bf = &fmts[k];
+        size_t size = (size_t)1920 * 1080 * bf->bpp_num / bf->bpp_den;
+        ovl_stats_t full_st, dirty_st;
+        double full_us = bench_one(bf, frame, frames, 1, &full_st);
+        double dirty_us = bench_one(bf, frame, frames, 0, &dirty_st);
+        double t0 = now_ms();
+        int f;
+        for (f = 0; f < frames; f++)
+            memcpy(copy, frame, size);
+        double copy_us = (now_ms() - t0) * 1000.0 / frames;
+
+        printf("  %-7s %12.1f %12.1f %7.1fx %6.2f / %-5.2f %12.1f\n", bf->name, full_us, dirty_us,
+               dirty_us > 0 ? full_us / dirty_us : 0.0,
+               (double)full_st.renders / frames, (double)dirty_st.renders / frames, copy_us);
+    }
+    printf("  (frame copy = 같은 크기 프레임 memcpy 한 번, 비교 기준)\n");
+
+    free(frame);
+    free(copy);
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 600;
+    int failures = 0;
+
+    if (frames <= 0)
+        frames = 600;
+
+    failures += verify_formats();
+    failures += verify_dirty();
+    bench_1080p(frames);
+
+    if (failures) {
+        printf("\n불일치 %d 건\n", failures);
+        return 1;
+    }
+    return 0;
+}
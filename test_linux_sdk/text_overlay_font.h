@@ -0,0 +1,1917 @@
+#ifndef TEXT_OVERLAY_FONT_H
+#define TEXT_OVERLAY_FONT_H
+
+// text_overlay.c 전용 글리프 아틀라스
+// DejaVu Sans Mono Bold 16px 를 FreeType 로 안티앨리어스 래스터라이즈한 것 (Bitstream Vera 라이선스)
+// 글리프마다 OVL_FONT_H 줄, 줄마다 OVL_FONT_W 글자. '.' 는 0, '1'..'f' 는 4비트 커버리지 (알파 = v * 17)
+
+#define OVL_FONT_FIRST      0x20
+#define OVL_FONT_GLYPHS     95
+#define OVL_FONT_W          10
+#define OVL_FONT_H          19
+#define OVL_FONT_BASELINE   15
+
+static const char *const ovl_font_rows[OVL_FONT_GLYPHS * OVL_FONT_H] = {
+    // 0x20 ' '
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x21 '!'
+    "..........",
+    "..........",
+    "..........",
+    "...3fd....",
+    "...3fd....",
+    "...3fd....",
+    "...3fd....",
+    "...3fd....",
+    "...3fc....",
+    "...1fb....",
+    "....e9....",
+    "..........",
+    "...133....",
+    "...3fd....",
+    "...3fd....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x22 '"'
+    "..........",
+    "..........",
+    "..........",
+    ".3fc.3fc..",
+    ".3fc.3fc..",
+    ".3fc.3fc..",
+    ".3fc.3fc..",
+    ".154.154..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x23 '#'
+    "..........",
+    "..........",
+    "..........",
+    "...5f61fb.",
+    "...9f24f7.",
+    "...ce.8f3.",
+    "1ffffffff9",
+    "1acfcbfda6",
+    "..8f33f8..",
+    "..ce.7f4..",
+    "aafeadfb7.",
+    "ffffffffb.",
+    ".7f42f8...",
+    ".be.6f5...",
+    ".eb.af1...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x24 '$'
+    "..........",
+    "..........",
+    "..........",
+    "....a6....",
+    "....a6....",
+    "..7dffd8..",
+    ".6feeddc..",
+    ".af7a6.2..",
+    ".9fbb6....",
+    ".2effea2..",
+    "..28effe2.",
+    "....a7cf6.",
+    ".63.a6af7.",
+    ".afdeeff3.",
+    ".4adffc4..",
+    "....a6....",
+    "....a6....",
+    "....64....",
+    "..........",
+    // 0x25 '%'
+    "..........",
+    "..........",
+    "..........",
+    "..1.......",
+    "1bfe6.....",
+    "9e6af2....",
+    "ad37f2....",
+    "3eff9.28c.",
+    ".1424ab5..",
+    "..5ca311..",
+    "2d82.8ff8.",
+    ".1..4f88f5",
+    "....6f..e7",
+    "....3fa9f4",
+    ".....6ee7.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x26 '&'
+    "..........",
+    "..........",
+    "..........",
+    "..3beec2..",
+    ".1efecf3..",
+    ".3ff..11..",
+    ".1ff4.....",
+    "..bfc.....",
+    ".8fff8..11",
+    "4fd5ff34f7",
+    "9f7.9fc6f6",
+    "af8.1dfef2",
+    "8fe3.6ff9.",
+    "1effdfffc.",
+    ".2aefe9ff5",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x27 quote
+    "..........",
+    "..........",
+    "..........",
+    "...3fc....",
+    "...3fc....",
+    "...3fc....",
+    "...3fc....",
+    "...154....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x28 '('
+    "..........",
+    "..........",
+    "..........",
+    ".....de1..",
+    "....7f7...",
+    "....ef1...",
+    "...5fb....",
+    "...af8....",
+    "...df5....",
+    "...ef3....",
+    "...ff3....",
+    "...df4....",
+    "...bf7....",
+    "...7fa....",
+    "...1fe1...",
+    "....9f5...",
+    "....1ec...",
+    ".....341..",
+    "..........",
+    // 0x29 ')'
+    "..........",
+    "..........",
+    "..........",
+    "..5f8.....",
+    "...df2....",
+    "...7f9....",
+    "...2fe1...",
+    "....df4...",
+    "....af7...",
+    "....9f9...",
+    "....9f9...",
+    "....af8...",
+    "....cf5...",
+    "...1ff1...",
+    "...5fb....",
+    "...bf4....",
+    "..3fa.....",
+    "..241.....",
+    "..........",
+    // 0x2A '*'
+    "..........",
+    "..........",
+    "..........",
+    "....d7....",
+    ".63.d7.63.",
+    ".afaebde5.",
+    "..3dff91..",
+    ".3bffee81.",
+    ".ca2d75d6.",
+    ".1..d7....",
+    "....63....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x2B '+'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "...197....",
+    "...2fb....",
+    "...2fb....",
+    "...2fb....",
+    "7ffffffff2",
+    "6dddffddd1",
+    "...2fb....",
+    "...2fb....",
+    "...2fb....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x2C ','
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "...122....",
+    "...6ff1...",
+    "...6ff1...",
+    "...8fc....",
+    "...cf4....",
+    "..1fc.....",
+    "..........",
+    "..........",
+    // 0x2D '-'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..344441..",
+    "..affff4..",
+    "..affff4..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x2E '.'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "...6dd1...",
+    "...7ff2...",
+    "...7ff2...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x2F '/'
+    "..........",
+    "..........",
+    "..........",
+    "......3f8.",
+    "......ae1.",
+    ".....2f9..",
+    ".....9f2..",
+    "....2f9...",
+    "....9f2...",
+    "...1ea....",
+    "...8f3....",
+    "..1eb.....",
+    "..7f4.....",
+    "..ec......",
+    ".6f5......",
+    ".dd.......",
+    "..........",
+    "..........",
+    "..........",
+    // 0x30 '0'
+    "..........",
+    "..........",
+    "..........",
+    "..3bee91..",
+    ".2effffa..",
+    ".8fd25ff2.",
+    ".cf7..df7.",
+    ".ef5..bf9.",
+    ".ff5d9afa.",
+    ".ff5d8afa.",
+    ".ef5..bf9.",
+    ".cf7..df7.",
+    ".8fd15ff2.",
+    ".2effffa..",
+    "..3bfe91..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x31 '1'
+    "..........",
+    "..........",
+    "..........",
+    ".29dff4...",
+    ".5ffff4...",
+    ".484ef4...",
+    "....ef4...",
+    "....ef4...",
+    "....ef4...",
+    "....ef4...",
+    "....ef4...",
+    "....ef4...",
+    "....ef5...",
+    ".8ffffffd.",
+    ".8ffffffd.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x32 '2'
+    "..........",
+    "..........",
+    "..........",
+    ".6beed81..",
+    ".dfedffb..",
+    ".83..6ff3.",
+    ".....1ff4.",
+    ".....5ff1.",
+    "....1df8..",
+    "...1cfb...",
+    "...bfb1...",
+    "..afc1....",
+    ".9fc1.....",
+    "1fffffff5.",
+    "1fffffff5.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x33 '3'
+    "..........",
+    "..........",
+    "..........",
+    ".6befd81..",
+    ".afffffc..",
+    ".641.6ff3.",
+    "......ef4.",
+    "...116fe1.",
+    "...effc3..",
+    "...effe7..",
+    ".....4ef4.",
+    "......af8.",
+    ".731.3ef7.",
+    ".ffffffe2.",
+    ".8cefda2..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x34 '4'
+    "..........",
+    "..........",
+    "..........",
+    "....2efa..",
+    "....bffa..",
+    "...6fefa..",
+    "..2eb9fa..",
+    "..bf29fa..",
+    ".6f7.9fa..",
+    "1ec..9fa..",
+    "3fffffffe.",
+    "3fffffffe.",
+    ".....9fa..",
+    ".....9fa..",
+    ".....9fa..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x35 '5'
+    "..........",
+    "..........",
+    "..........",
+    ".7fffffd..",
+    ".7fffffd..",
+    ".7f6......",
+    ".7f6......",
+    ".7fdec7...",
+    ".7fffffb..",
+    ".44118ff4.",
+    "......cf7.",
+    "......cf8.",
+    ".62.16ff4.",
+    ".dfffffb..",
+    ".8cefd8...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x36 '6'
+    "..........",
+    "..........",
+    "..........",
+    "..18dfea..",
+    "..bffeff1.",
+    ".5fe4..4..",
+    ".af7......",
+    ".df8cfd5..",
+    ".effeeff3.",
+    ".efd11cf9.",
+    ".df8..7fb.",
+    ".bf8..7fa.",
+    ".8fd11cf8.",
+    ".1effefe1.",
+    "..3befb3..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x37 '7'
+    "..........",
+    "..........",
+    "..........",
+    ".effffff7.",
+    ".effffff6.",
+    ".....4ff2.",
+    ".....afb..",
+    "....1ef5..",
+    "....6fe...",
+    "....cf9...",
+    "...2ff3...",
+    "...8fc....",
+    "...ef7....",
+    "..5ff1....",
+    "..afa.....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x38 '8'
+    "..........",
+    "..........",
+    "..........",
+    "..4ced91..",
+    ".4ffeffc..",
+    ".9fa.2ef3.",
+    ".af6..bf5.",
+    ".5fb13ef1.",
+    "..6fffe4..",
+    ".4efeef9..",
+    ".cf7.1cf6.",
+    ".ef2..8f9.",
+    ".cf7.1cf7.",
+    ".6ffeffe2.",
+    "..6ceeb3..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x39 '9'
+    "..........",
+    "..........",
+    "..........",
+    "..7dfd81..",
+    ".6ffcefa..",
+    ".df6.3ff2.",
+    "1ff2..ef6.",
+    "1ff2..ef8.",
+    ".ef916ff9.",
+    ".7ffffff9.",
+    "..7cdabf8.",
+    "......df5.",
+    ".32..8fe1.",
+    ".6fefff6..",
+    ".4ceeb5...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x3A ':'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "...7ff2...",
+    "...7ff2...",
+    "...6dd1...",
+    "..........",
+    "..........",
+    "...6dd1...",
+    "...7ff2...",
+    "...7ff2...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x3B ';'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "...6dd1...",
+    "...7ff2...",
+    "...7ff2...",
+    "..........",
+    "..........",
+    "...122....",
+    "...7ff2...",
+    "...7ff2...",
+    "...9fd....",
+    "...cf5....",
+    "...fc.....",
+    "..........",
+    "..........",
+    // 0x3C '<'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "........1.",
+    "......4ae.",
+    "...17dffd.",
+    ".4affe94..",
+    "5ffa5.....",
+    "4ffb61....",
+    ".39effa5..",
+    "...16cffe.",
+    "......39d.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x3D '='
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "5fffffffe.",
+    "4dddddddc.",
+    "..........",
+    "4dddddddc.",
+    "5fffffffe.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x3E '>'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "1.........",
+    "5d82......",
+    "4fffb5....",
+    ".16bffe82.",
+    "....27cfe.",
+    "....38dfe.",
+    ".27cffd71.",
+    "4fffa4....",
+    "5c61......",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x3F '?'
+    "..........",
+    "..........",
+    "..........",
+    "..6beeb3..",
+    ".3ffeffe1.",
+    ".292.2ff4.",
+    ".....1ff3.",
+    "....1cf9..",
+    "....bfa...",
+    "...5fc....",
+    "...8f8....",
+    "...7d7....",
+    "...232....",
+    "...8f8....",
+    "...8f8....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x40 '@'
+    "..........",
+    "..........",
+    "..........",
+    "...26751..",
+    "..9ffffd2.",
+    ".9f9215fa.",
+    "3f9..1.9e.",
+    "9f11bffcf1",
+    "cc.9f86ef1",
+    "ea.eb..8f1",
+    "e9.ea..7f1",
+    "db.ae42cf1",
+    "ae.2dffdf1",
+    "5f6..3224.",
+    ".ce4....1.",
+    ".2dfb89da.",
+    "..17ceec6.",
+    "..........",
+    "..........",
+    // 0x41 'A'
+    "..........",
+    "..........",
+    "..........",
+    "...bff5...",
+    "...eff9...",
+    "..4fdfd...",
+    "..8f8ef2..",
+    "..cf5af6..",
+    ".1ff17fa..",
+    ".4fd.3fe..",
+    ".8ffeeff3.",
+    ".cffffff7.",
+    "1ff2..8fb.",
+    "5fe...4fe.",
+    "9fa...1ff4",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x42 'B'
+    "..........",
+    "..........",
+    "..........",
+    ".ffffeb4..",
+    ".ffddeff3.",
+    ".ff3.1df8.",
+    ".ff3..af9.",
+    ".ff3.2df5.",
+    ".fffffe8..",
+    ".ffddefc2.",
+    ".ff3..9fc.",
+    ".ff3..5ff.",
+    ".ff3..9ff.",
+    ".ffddeffa.",
+    ".fffffd81.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x43 'C'
+    "..........",
+    "..........",
+    "..........",
+    "...5ceec4.",
+    "..7fffff7.",
+    ".2ffc3276.",
+    ".8ff1.....",
+    ".bfb......",
+    ".cfa......",
+    ".cfa......",
+    ".bfb......",
+    ".8ff1.....",
+    ".2ffc3276.",
+    "..8fffff7.",
+    "...5ceec4.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x44 'D'
+    "..........",
+    "..........",
+    "..........",
+    ".effeb6...",
+    ".efffffa..",
+    ".ef639ff5.",
+    ".ef6..dfa.",
+    ".ef6..9fc.",
+    ".ef6..8fd.",
+    ".ef6..8fd.",
+    ".ef6..9fc.",
+    ".ef6..dfa.",
+    ".ef639ff5.",
+    ".efffffa..",
+    ".effec6...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x45 'E'
+    "..........",
+    "..........",
+    "..........",
+    ".affffff9.",
+    ".affffff9.",
+    ".afa......",
+    ".af9......",
+    ".afa......",
+    ".affffff2.",
+    ".affffff2.",
+    ".af9......",
+    ".af9......",
+    ".afa......",
+    ".affffff9.",
+    ".affffff9.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x46 'F'
+    "..........",
+    "..........",
+    "..........",
+    ".9ffffffa.",
+    ".9ffffffa.",
+    ".9fb......",
+    ".9fb......",
+    ".9fb......",
+    ".9ffffff4.",
+    ".9ffffff4.",
+    ".9fb......",
+    ".9fb......",
+    ".9fb......",
+    ".9fb......",
+    ".9fb......",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x47 'G'
+    "..........",
+    "..........",
+    "..........",
+    "...7dfd92.",
+    "..bfffff6.",
+    ".6ff93276.",
+    ".cfc......",
+    ".ef7......",
+    "1ff5.beec.",
+    "1ff5.cffc.",
+    ".ef7..3fc.",
+    ".bfc..3fc.",
+    ".6ff825fc.",
+    "..bfffffc.",
+    "..18dfea2.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x48 'H'
+    "..........",
+    "..........",
+    "..........",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    ".ef611bf8.",
+    ".effffff8.",
+    ".effffff8.",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    ".ef6..bf8.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x49 'I'
+    "..........",
+    "..........",
+    "..........",
+    ".affffff4.",
+    ".affffff4.",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    ".affffff4.",
+    ".affffff4.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x4A 'J'
+    "..........",
+    "..........",
+    "..........",
+    "..4ffffd..",
+    "..4ffffd..",
+    ".....7fd..",
+    ".....6fd..",
+    ".....6fd..",
+    ".....6fd..",
+    ".....6fd..",
+    ".....6fd..",
+    "11...7fd..",
+    "2d623dfb..",
+    "2ffffff5..",
+    ".6cefc6...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x4B 'K'
+    "..........",
+    "..........",
+    "..........",
+    "1ff3..8fe2",
+    "1ff3.5ff4.",
+    "1ff32ef7..",
+    "1ff4cfb...",
+    "1ffcfe1...",
+    "1fffff3...",
+    "1fffdfa...",
+    "1ff84ff3..",
+    "1ff3.cfb..",
+    "1ff3.4ff4.",
+    "1ff3..bfc.",
+    "1ff3..4ff5",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x4C 'L'
+    "..........",
+    "..........",
+    "..........",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4ff1.....",
+    ".4fffffff.",
+    ".4fffffff.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x4D 'M'
+    "..........",
+    "..........",
+    "..........",
+    "5ff8..eff.",
+    "5ffc.3fff.",
+    "5fef17eff.",
+    "5fbf5bbff.",
+    "5fadae8ff.",
+    "5fa9ff4ff.",
+    "5fa6ff1ff.",
+    "5fa2a8.ff.",
+    "5fa....ff.",
+    "5fa....ff.",
+    "5fa....ff.",
+    "5fa....ff.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x4E 'N'
+    "..........",
+    "..........",
+    "..........",
+    "1ff9..5fa.",
+    "1ffe..5fa.",
+    "1fff5.5fa.",
+    "1ffeb.5fa.",
+    "1ff9f15fa.",
+    "1ff3f75fa.",
+    "1ff.cc5fa.",
+    "1ff.7f8fa.",
+    "1ff.1fefa.",
+    "1ff..bffa.",
+    "1ff..5ffa.",
+    "1ff...efa.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x4F 'O'
+    "..........",
+    "..........",
+    "..........",
+    "..4cee91..",
+    ".3fffffc..",
+    ".bfd36ff5.",
+    "1ff6..bfa.",
+    "3ff3..8fc.",
+    "4ff2..7fd.",
+    "4ff2..8fd.",
+    "3ff3..8fc.",
+    "1ff6..bfa.",
+    ".bfd36ff5.",
+    ".3fffffc..",
+    "..4cfe91..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x50 'P'
+    "..........",
+    "..........",
+    "..........",
+    ".bfffeb5..",
+    ".bffefff5.",
+    ".bf9.2dfc.",
+    ".bf9..7fe.",
+    ".bf9..8fe.",
+    ".bf9.3dfb.",
+    ".bffffff5.",
+    ".bffeda4..",
+    ".bf9......",
+    ".bf9......",
+    ".bf9......",
+    ".bf9......",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x51 'Q'
+    "..........",
+    "..........",
+    "..........",
+    "..4cee91..",
+    ".3fffffc..",
+    ".bfd36ff5.",
+    "1ff6..bfa.",
+    "3ff3..8fc.",
+    "4ff2..7fd.",
+    "4ff2..8fd.",
+    "3ff3..8fc.",
+    "1ff6..bfa.",
+    ".bfd36ff5.",
+    ".3fffffc..",
+    "..4cfff4..",
+    ".....6fe2.",
+    "......88..",
+    "..........",
+    "..........",
+    // 0x52 'R'
+    "..........",
+    "..........",
+    "..........",
+    ".efffeb3..",
+    ".efeeffe2.",
+    ".ef5.3ff7.",
+    ".ef5..df8.",
+    ".ef5.3ff6.",
+    ".efeeffc1.",
+    ".effffc1..",
+    ".ef52ef6..",
+    ".ef5.7fd..",
+    ".ef5.1ef6.",
+    ".ef5..8fd.",
+    ".ef5..2ff6",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x53 'S'
+    "..........",
+    "..........",
+    "..........",
+    "..5ceeb7..",
+    ".7ffffff..",
+    ".df8..3b..",
+    ".ef5......",
+    ".cfe82....",
+    ".3efffa2..",
+    "..17dffe1.",
+    ".....5ff7.",
+    "......bfa.",
+    ".c61.2ef8.",
+    ".effefff3.",
+    ".5bdfeb3..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x54 'T'
+    "..........",
+    "..........",
+    "..........",
+    "4fffffffe.",
+    "4fffffffe.",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x55 'U'
+    "..........",
+    "..........",
+    "..........",
+    "3ff2..8fc.",
+    "3ff2..8fc.",
+    "3ff2..8fc.",
+    "3ff2..8fc.",
+    "3ff2..8fc.",
+    "3ff2..8fc.",
+    "3ff2..8fc.",
+    "2ff2..8fc.",
+    "2ff3..9fb.",
+    ".efb24ef8.",
+    ".7fffffe2.",
+    "..7dfeb3..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x56 'V'
+    "..........",
+    "..........",
+    "..........",
+    "7fd...3ff1",
+    "3ff1..7fd.",
+    ".ef4..af9.",
+    ".bf7..df6.",
+    ".8fb.1ff2.",
+    ".4fe.4fe..",
+    ".1ff27fa..",
+    "..cf5bf7..",
+    "..9f8ef3..",
+    "..5fdff...",
+    "..2fffb...",
+    "...dff8...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x57 'W'
+    "..........",
+    "..........",
+    "..........",
+    "ef1....6f9",
+    "cf2....8f7",
+    "bf4....9f5",
+    "9f53fd.af4",
+    "7f76ff1bf2",
+    "5f89ff4cf.",
+    "3fabaf7de.",
+    "2fbe7caec.",
+    ".fef49efa.",
+    ".dff16ff9.",
+    ".bfd.3ff7.",
+    ".9fa..ef5.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x58 'X'
+    "..........",
+    "..........",
+    "..........",
+    "6fe1..5fe1",
+    ".cf8..df7.",
+    ".4fe27fd1.",
+    "..bfaef5..",
+    "..2fffc...",
+    "...9ff4...",
+    "...aff5...",
+    "..4fffd...",
+    "..cf9df7..",
+    ".6fe15fe1.",
+    "1df6..cf9.",
+    "8fd...4ff2",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x59 'Y'
+    "..........",
+    "..........",
+    "..........",
+    "afc...2ff5",
+    "3ff4..9fc.",
+    ".bfb.2ff5.",
+    ".3ff38fd..",
+    "..bfbef5..",
+    "..3fffd...",
+    "...bff5...",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "...5ff....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x5A 'Z'
+    "..........",
+    "..........",
+    "..........",
+    ".efffffff.",
+    ".efffffff.",
+    ".....3ff9.",
+    ".....cfd1.",
+    "....7ff4..",
+    "...2ff8...",
+    "...bfd1...",
+    "..6ff3....",
+    ".2ef8.....",
+    ".bfd1.....",
+    "1ffffffff1",
+    "1ffffffff1",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x5B '['
+    "..........",
+    "..........",
+    "..........",
+    "...bfff4..",
+    "...bfa82..",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf6....",
+    "...bf721..",
+    "...bfff4..",
+    "...35551..",
+    "..........",
+    // 0x5C backslash
+    "..........",
+    "..........",
+    "..........",
+    ".dd.......",
+    ".6f5......",
+    "..ec......",
+    "..7f4.....",
+    "..1eb.....",
+    "...8f3....",
+    "...1fa....",
+    "....9f2...",
+    "....2f9...",
+    ".....af2..",
+    ".....3f9..",
+    "......ae1.",
+    "......3f8.",
+    "..........",
+    "..........",
+    "..........",
+    // 0x5D ']'
+    "..........",
+    "..........",
+    "..........",
+    "..9fff5...",
+    "..58df5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "....bf5...",
+    "..12cf5...",
+    "..9fff5...",
+    "..35552...",
+    "..........",
+    // 0x5E '^'
+    "..........",
+    "..........",
+    "..........",
+    "...287....",
+    "..1dff8...",
+    "..afdff4..",
+    ".6fc14ee2.",
+    "3fc1..4ec.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x5F '_'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "2222222221",
+    "fffffffffa",
+    "5555555553",
+    // 0x60 '`'
+    "..........",
+    "..........",
+    ".1de3.....",
+    "..2dc1....",
+    "...2e9....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x61 'a'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".3adfec5..",
+    ".6fdbcff3.",
+    ".33...bf8.",
+    "..58aadf9.",
+    ".affffffa.",
+    "2ff91.afa.",
+    "3ff3..dfa.",
+    ".dfb6bffa.",
+    ".3bed9afa.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x62 'b'
+    "..........",
+    "..........",
+    "..........",
+    ".cf7......",
+    ".cf7......",
+    ".cf7......",
+    ".cf79ed6..",
+    ".cfeffff4.",
+    ".cfe21dfa.",
+    ".cf9..7fd.",
+    ".cf7..6fe.",
+    ".cf9..7fc.",
+    ".cfe21dfa.",
+    ".cfeffff4.",
+    ".cf79ed6..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x63 'c'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..18dfd92.",
+    "..bffeff4.",
+    ".5ff6..43.",
+    ".9fc......",
+    ".afa......",
+    ".9fc......",
+    ".5ff6..43.",
+    "..bffeff4.",
+    "..18dfda2.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x64 'd'
+    "..........",
+    "..........",
+    "..........",
+    "......cf7.",
+    "......cf7.",
+    "......cf7.",
+    ".1aed6cf7.",
+    ".affffef7.",
+    "1ff9.6ff7.",
+    "3ff2..ef7.",
+    "4ff...df7.",
+    "3ff1..ef7.",
+    "1ff6.4ff7.",
+    ".9ffbeff7.",
+    ".1aee7cf7.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x65 'e'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..5ceeb4..",
+    ".6ffcdff4.",
+    ".ef6..9fb.",
+    "3ffbbbcfe.",
+    "4ffffffff.",
+    "3ff2......",
+    ".ef9...46.",
+    ".6ffedff9.",
+    "..5befda4.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x66 'f'
+    "..........",
+    "..........",
+    "..........",
+    "....9eff7.",
+    "...5ffcc5.",
+    "...8fc....",
+    ".affffff7.",
+    ".7cdfecc5.",
+    "...8fc....",
+    "...8fc....",
+    "...8fc....",
+    "...8fc....",
+    "...8fc....",
+    "...8fc....",
+    "...8fc....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x67 'g'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..8ee7bf8.",
+    ".7ffefef8.",
+    ".ef9.5ff8.",
+    "2ff3..df8.",
+    "3ff1..bf8.",
+    "2ff3..df8.",
+    ".ef9.4ff8.",
+    ".7ffdfff8.",
+    "..8ee9bf8.",
+    ".12..2ef6.",
+    ".5fedffe1.",
+    ".3befeb3..",
+    "..........",
+    // 0x68 'h'
+    "..........",
+    "..........",
+    "..........",
+    ".af9......",
+    ".af9......",
+    ".af9......",
+    ".afa9ed5..",
+    ".afeeffe1.",
+    ".afe12ff4.",
+    ".afa..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x69 'i'
+    "..........",
+    "..........",
+    "....ff4...",
+    "....ff4...",
+    "....aa3...",
+    "..........",
+    ".4ffff4...",
+    ".3ccff4...",
+    "....ff4...",
+    "....ff4...",
+    "....ff4...",
+    "....ff4...",
+    "....ff4...",
+    ".accffccc1",
+    ".dfffffff2",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x6A 'j'
+    "..........",
+    "....6a6...",
+    "....afa...",
+    "....afa...",
+    "..........",
+    "..........",
+    "..ffffa...",
+    "..bcefa...",
+    "....afa...",
+    "....afa...",
+    "....afa...",
+    "....afa...",
+    "....afa...",
+    "....afa...",
+    "....af9...",
+    "....df8...",
+    ".acdff4...",
+    ".dffd7....",
+    "..........",
+    // 0x6B 'k'
+    "..........",
+    "..........",
+    "..........",
+    ".afa......",
+    ".afa......",
+    ".afa......",
+    ".afa.2efa.",
+    ".afa1dfa..",
+    ".afbcfa...",
+    ".affff1...",
+    ".affff8...",
+    ".afc3ff3..",
+    ".afa.9fc..",
+    ".afa.1ef6.",
+    ".afa..7fe2",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x6C 'l'
+    "..........",
+    "..........",
+    "..........",
+    "4ffff5....",
+    "3ccff5....",
+    "...ff5....",
+    "...ff5....",
+    "...ff5....",
+    "...ff5....",
+    "...ff5....",
+    "...ff5....",
+    "...ef5....",
+    "...df8....",
+    "...9ffcc6.",
+    "...1aeff8.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x6D 'm'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "5f8ed5de5.",
+    "5fedffcfc.",
+    "5f92fd.ef.",
+    "5f81fc.df.",
+    "5f81fc.df.",
+    "5f81fc.df.",
+    "5f81fc.df.",
+    "5f81fc.df.",
+    "5f81fc.df.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x6E 'n'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".afaaed5..",
+    ".affcdfe1.",
+    ".afd.1ff4.",
+    ".afa..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    ".af9..ef6.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x6F 'o'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..5cfea2..",
+    ".5ffeffd1.",
+    ".dfa.2ef8.",
+    "2ff3..8fc.",
+    "3ff1..7fd.",
+    "2ff3..8fc.",
+    ".dfa.2ef8.",
+    ".5ffeffd1.",
+    "..5cfea2..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x70 'p'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".cf8aed6..",
+    ".cffdcff4.",
+    ".cfd..cfa.",
+    ".cf8..7fc.",
+    ".cf7..6fe.",
+    ".cf9..7fc.",
+    ".cfe21dfa.",
+    ".cfeffff4.",
+    ".cf79ed6..",
+    ".cf7......",
+    ".cf7......",
+    ".cf7......",
+    "..........",
+    // 0x71 'q'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".1aed5cf7.",
+    ".9ffefef7.",
+    "1ff8.6ff7.",
+    "3ff2..ef7.",
+    "4ff...df7.",
+    "3ff2..ef7.",
+    "1ff9.6ff7.",
+    ".9ffffef7.",
+    ".1aee5cf7.",
+    "......cf7.",
+    "......cf7.",
+    "......cf7.",
+    "..........",
+    // 0x72 'r'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..bf98efd.",
+    "..bfefccf.",
+    "..bfe4..3.",
+    "..bfa.....",
+    "..bf9.....",
+    "..bf8.....",
+    "..bf8.....",
+    "..bf8.....",
+    "..bf8.....",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x73 's'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..6ceec7..",
+    ".5ffbbeb..",
+    ".9f9...3..",
+    ".7ffb62...",
+    ".19ffff8..",
+    "...159ff3.",
+    ".32...df4.",
+    ".8fcbcfe1.",
+    ".4bdfeb4..",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x74 't'
+    "..........",
+    "..........",
+    "..........",
+    "...783....",
+    "...df6....",
+    "...df6....",
+    "2fffffff6.",
+    "1ccffdcc4.",
+    "...df6....",
+    "...df6....",
+    "...df6....",
+    "...df6....",
+    "...df7....",
+    "...affcc4.",
+    "...2beff6.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x75 'u'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".bf8..ff4.",
+    ".bf8..ff4.",
+    ".bf8..ff4.",
+    ".bf8..ff4.",
+    ".bf8..ff4.",
+    ".bf8..ff4.",
+    ".afa.4ff4.",
+    ".6ffbdff4.",
+    "..9ed5ff4.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x76 'v'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "3ff1..7fd.",
+    ".ef5..bf8.",
+    ".9f9..ef4.",
+    ".4fd.4fe..",
+    "..ef28f9..",
+    "..af6cf5..",
+    "..6fbfe1..",
+    "..1fffa...",
+    "...bff6...",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x77 'w'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "ef.....5f8",
+    "bf2....7f6",
+    "8f42a8.af3",
+    "6f75fe.cf.",
+    "3f98df3ed.",
+    "1fbb8e8fa.",
+    ".dee5adf7.",
+    ".aff17ff5.",
+    ".7fd.4ff2.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x78 'x'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "1df9.1ef9.",
+    ".4ff38fd1.",
+    "..9fcff4..",
+    "..1dff8...",
+    "...8ff3...",
+    "..3fffc...",
+    "..cf8df7..",
+    ".8fe15ff3.",
+    "3ff6..bfc.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x79 'y'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "5ff1..6fe1",
+    ".ef6..bf9.",
+    ".8fb.1ff4.",
+    ".2ff26fd..",
+    "..bf7bf7..",
+    "..6fdff2..",
+    "..1effb...",
+    "...9ff5...",
+    "...4fe1...",
+    "...af9....",
+    ".bdff2....",
+    ".ffd5.....",
+    "..........",
+    // 0x7A 'z'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".8ffffff7.",
+    ".6bbbcff7.",
+    ".....bfc1.",
+    "....9fe2..",
+    "...7ff3...",
+    "..5ff5....",
+    ".3ef7.....",
+    ".bffbbbb5.",
+    ".bffffff7.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    // 0x7B '{'
+    "..........",
+    "..........",
+    "..........",
+    "....6dff4.",
+    "...1ffa82.",
+    "...3fe....",
+    "...3fe....",
+    "...3fe....",
+    "...6fd....",
+    ".59ef7....",
+    ".9ffc2....",
+    "..1bfb....",
+    "...4fd....",
+    "...3fe....",
+    "...3fe....",
+    "...3ff....",
+    "...1ffa82.",
+    "....5dff4.",
+    "..........",
+    // 0x7C '|'
+    "..........",
+    "..........",
+    "..........",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    "...1fb....",
+    // 0x7D '}'
+    "..........",
+    "..........",
+    "..........",
+    ".9feb2....",
+    ".48dfa....",
+    "...5fc....",
+    "...4fc....",
+    "...4fd....",
+    "...3fe1...",
+    "....dfc82.",
+    "....5eff4.",
+    "...1ff61..",
+    "...3fe....",
+    "...4fc....",
+    "...4fc....",
+    "...5fc....",
+    ".48df9....",
+    ".9feb2....",
+    "..........",
+    // 0x7E '~'
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    ".5ab71..6.",
+    "4fffffcee.",
+    "46115bec5.",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+    "..........",
+};
+
+#endif // TEXT_OVERLAY_FONT_H
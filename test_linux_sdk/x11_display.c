@@ -0,0 +1,262 @@
+//----------------------------------------------//
+//	Persistent XImage / MIT-SHM display backend	//
+//----------------------------------------------//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "x11_display.h"
+
+// XShmAttach 실패(원격 디스플레이 등) 감지용
+static volatile int x11_display_error;
+
+static int x11_display_trap(Display *display, XErrorEvent *event)
+{
+    (void)display;
+    (void)event;
+    x11_display_error = 1;
+    return 0;
+}
+
+static void x11_display_free_image(x11_display_t *xd, x11_display_image_t *img)
+{
+    if (!img->ximage)
+        return;
+
+    if (img->shm_attached) {
+        XShmDetach(xd->display, &img->shminfo);
+        XSync(xd->display, False);
+        img->ximage->data = NULL;
+        XDestroyImage(img->ximage);
+        shmdt(img->shminfo.shmaddr);
+    } else {
+        // XDestroyImage 가 malloc 된 data 도 해제
+        XDestroyImage(img->ximage);
+    }
+
+    memset(img, 0, sizeof(*img));
+}
+
+static int x11_display_alloc_shm(x11_display_t *xd, x11_display_image_t *img)
+{
+    XErrorHandler old_handler;
+    size_t size;
+
+    img->ximage = XShmCreateImage(xd->display, xd->visual, xd->depth, ZPixmap,
+                                  NULL, &img->shminfo, xd->width, xd->height);
+    if (!img->ximage)
+        return -1;
+
+    size = (size_t)img->ximage->bytes_per_line * img->ximage->height;
+    img->shminfo.shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (img->shminfo.shmid < 0) {
+        XDestroyImage(img->ximage);
+        img->ximage = NULL;
+        return -1;
+    }
+
+    img->shminfo.shmaddr = (char *)shmat(img->shminfo.shmid, NULL, 0);
+    if (img->shminfo.shmaddr == (char *)-1) {
+        shmctl(img->shminfo.shmid, IPC_RMID, NULL);
+        XDestroyImage(img->ximage);
+        img->ximage = NULL;
+        return -1;
+    }
+    img->ximage->data = img->shminfo.shmaddr;
+    img->shminfo.readOnly = False;
+
+    x11_display_error = 0;
+    old_handler = XSetErrorHandler(x11_display_trap);
+    XShmAttach(xd->display, &img->shminfo);
+    XSync(xd->display, False);
+    XSetErrorHandler(old_handler);
+
+    // 서버가 붙은 뒤에는 세그먼트를 삭제 예약 (비정상 종료 시 누수 방지)
+    shmctl(img->shminfo.shmid, IPC_RMID, NULL);
+
+    if (x11_display_error) {
+        img->ximage->data = NULL;
+        XDestroyImage(img->ximage);
+        shmdt(img->shminfo.shmaddr);
+        memset(img, 0, sizeof(*img));
+        return -1;
+    }
+
+    img->shm_attached = 1;
+    return 0;
+}
+
+static int x11_display_alloc_plain(x11_display_t *xd, x11_display_image_t *img)
+{
+    img->ximage = XCreateImage(xd->display, xd->visual, xd->depth, ZPixmap, 0,
+                               NULL, xd->width, xd->height, 32, 0);
+    if (!img->ximage)
+        return -1;
+
+    img->ximage->data = (char *)malloc((size_t)img->ximage->bytes_per_line * xd->height);
+    if (!img->ximage->data) {
+        XDestroyImage(img->ximage);
+        img->ximage = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int x11_display_init(x11_display_t *xd, Display *display, Window window, GC gc, int use_shm)
+{
+    int major, minor;
+    Bool pixmaps;
+
+    if (!xd || !display)
+        return -1;
+
+    memset(xd, 0, sizeof(*xd));
+    xd->display = display;
+    xd->window = window;
+    xd->gc = gc;
+    xd->visual = DefaultVisual(display, DefaultScreen(display));
+    xd->depth = DefaultDepth(display, DefaultScreen(display));
+    xd->format = CC_FMT_BGRX32;
+
+    if (use_shm && XShmQueryVersion(display, &major, &minor, &pixmaps)) {
+        xd->use_shm = 1;
+        xd->completion_type = XShmGetEventBase(display) + ShmCompletion;
+        printf("MIT-SHM %d.%d 사용\n", major, minor);
+    } else {
+        printf("MIT-SHM 미지원, XPutImage 사용\n");
+    }
+    return 0;
+}
+
+int x11_display_resize(x11_display_t *xd, int width, int height)
+{
+    int i;
+
+    if (!xd || !xd->display || width <= 0 || height <= 0)
+        return -1;
+    if (xd->width == width && xd->height == height && xd->images[0].ximage)
+        return 0;
+
+    for (i = 0; i < X11_DISPLAY_BUFFERS; i++)
+        x11_display_free_image(xd, &xd->images[i]);
+
+    xd->width = width;
+    xd->height = height;
+    xd->back = 0;
+
+    for (i = 0; i < X11_DISPLAY_BUFFERS; i++) {
+        x11_display_image_t *img = &xd->images[i];
+
+        if (xd->use_shm && x11_display_alloc_shm(xd, img) < 0) {
+            // 원격 디스플레이 등에서는 XShmAttach 가 실패할 수 있다
+            printf("XShmAttach 실패, XPutImage 로 폴백\n");
+            xd->use_shm = 0;
+            // 이미 만든 SHM 이미지까지 모두 일반 XImage 로 다시 할당
+            while (i > 0)
+                x11_display_free_image(xd, &xd->images[--i]);
+            img = &xd->images[0];
+        }
+        if (!xd->use_shm && x11_display_alloc_plain(xd, img) < 0) {
+            printf("XImage 생성 실패\n");
+            return -1;
+        }
+    }
+
+    switch (xd->images[0].ximage->bits_per_pixel) {
+    case 32:
+        xd->format = CC_FMT_BGRX32;
+        break;
+    case 16:
+        xd->format = CC_FMT_RGB565;
+        break;
+    default:
+        printf("지원하지 않는 비트 깊이: %d bpp\n", xd->images[0].ximage->bits_per_pixel);
+        return -1;
+    }
+
+    printf("디스플레이 버퍼 할당: %dx%d x %d (%s)\n", width, height,
+           X11_DISPLAY_BUFFERS, xd->use_shm ? "MIT-SHM" : "XPutImage");
+    return 0;
+}
+
+int x11_display_handle_event(x11_display_t *xd, const XEvent *event)
+{
+    int i;
+
+    if (!xd || !xd->use_shm || event->type != xd->completion_type)
+        return 0;
+
+    const XShmCompletionEvent *done = (const XShmCompletionEvent *)event;
+    for (i = 0; i < X11_DISPLAY_BUFFERS; i++) {
+        if (xd->images[i].ximage && xd->images[i].shminfo.shmseg == done->shmseg)
+            xd->images[i].in_flight = 0;
+    }
+    return 1;
+}
+
+uint8_t *x11_display_back_buffer(x11_display_t *xd, int *stride)
+{
+    x11_display_image_t *img;
+    XEvent event;
+
+    if (!xd || !xd->images[xd->back].ximage)
+        return NULL;
+
+    img = &xd->images[xd->back];
+
+    if (img->in_flight) {
+        // 큐에 이미 도착한 완료 이벤트만 꺼낸다 (다른 이벤트는 건드리지 않음)
+        while (XCheckTypedEvent(xd->display, xd->completion_type, &event))
+            x11_display_handle_event(xd, &event);
+
+        if (img->in_flight) {
+            // 왕복 한 번이면 서버가 이 버퍼 읽기를 끝냈음이 보장된다
+            XSync(xd->display, False);
+            while (XCheckTypedEvent(xd->display, xd->completion_type, &event))
+                x11_display_handle_event(xd, &event);
+            img->in_flight = 0;
+        }
+    }
+
+    if (stride)
+        *stride = img->ximage->bytes_per_line;
+    return (uint8_t *)img->ximage->data;
+}
+
+int x11_display_present(x11_display_t *xd, int dst_x, int dst_y)
+{
+    x11_display_image_t *img;
+
+    if (!xd || !xd->images[xd->back].ximage)
+        return -1;
+
+    img = &xd->images[xd->back];
+
+    if (img->shm_attached) {
+        XShmPutImage(xd->display, xd->window, xd->gc, img->ximage,
+                     0, 0, dst_x, dst_y, xd->width, xd->height, True);
+        img->in_flight = 1;
+        xd->frames_shm++;
+    } else {
+        XPutImage(xd->display, xd->window, xd->gc, img->ximage,
+                  0, 0, dst_x, dst_y, xd->width, xd->height);
+        xd->frames_put++;
+    }
+    XFlush(xd->display);
+
+    xd->back = (xd->back + 1) % X11_DISPLAY_BUFFERS;
+    return 0;
+}
+
+void x11_display_destroy(x11_display_t *xd)
+{
+    int i;
+
+    if (!xd || !xd->display)
+        return;
+
+    for (i = 0; i < X11_DISPLAY_BUFFERS; i++)
+        x11_display_free_image(xd, &xd->images[i]);
+
+    xd->display = NULL;
+}
@@ -0,0 +1,74 @@
+#ifndef X11_DISPLAY_H
+#define X11_DISPLAY_H
+
+// 영구 XImage 디스플레이 백엔드
+// - 해상도마다 한 번만 이미지를 할당한다 (프레임마다 XCreateImage/malloc 없음)
+// - 서버가 MIT-SHM 을 지원하면 XShmPutImage, 아니면 XPutImage 로 폴백
+// - 이미지 2장을 번갈아 사용하므로 서버가 현재 프레임을 읽는 동안
+//   다음 프레임을 다른 버퍼에 변환할 수 있다
+
+#include <stdint.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+
+#include "color_convert.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define X11_DISPLAY_BUFFERS 2
+
+typedef struct {
+    XImage *ximage;
+    XShmSegmentInfo shminfo;
+    int shm_attached;
+    int in_flight;          // XShmPutImage 후 ShmCompletion 대기 중
+} x11_display_image_t;
+
+typedef struct {
+    Display *display;
+    Window window;
+    GC gc;
+    Visual *visual;
+    int depth;
+
+    int width;
+    int height;
+    int use_shm;            // MIT-SHM 사용 가능 여부
+    int completion_type;    // ShmCompletion 이벤트 타입
+    cc_format_t format;     // 이미지 픽셀 포맷 (BGRX32 또는 RGB565)
+
+    x11_display_image_t images[X11_DISPLAY_BUFFERS];
+    int back;               // 다음에 쓸 버퍼 인덱스
+
+    unsigned long frames_shm;
+    unsigned long frames_put;
+} x11_display_t;
+
+// 디스플레이/윈도우/GC 를 연결한다 (소유권은 호출 측)
+// use_shm 이 0 이면 MIT-SHM 을 쓰지 않는다
+int x11_display_init(x11_display_t *xd, Display *display, Window window, GC gc, int use_shm);
+
+// 해상도가 바뀌었을 때만 이미지를 다시 할당한다
+int x11_display_resize(x11_display_t *xd, int width, int height);
+
+// 다음 프레임을 쓸 백 버퍼 (서버가 아직 읽는 중이면 완료까지 대기)
+uint8_t *x11_display_back_buffer(x11_display_t *xd, int *stride);
+
+// 백 버퍼를 윈도우에 출력하고 버퍼를 교체한다
+int x11_display_present(x11_display_t *xd, int dst_x, int dst_y);
+
+// 이벤트 루프에서 받은 이벤트 전달 (ShmCompletion 처리). 처리했으면 1
+int x11_display_handle_event(x11_display_t *xd, const XEvent *event);
+
+void x11_display_destroy(x11_display_t *xd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // X11_DISPLAY_H
@@ -1,29 +1,498 @@
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <deque>
+#include <memory>
 #include <thread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 #include <signal.h>
+#include <sys/resource.h>
 #include <opencv2/opencv.hpp>
+#include "text_overlay.h"   // test_linux_sdk/text_overlay.c (글리프 아틀라스 텍스트 오버레이)
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+#include "format_table.h"   // test_linux_sdk/format_table.c (ENUM_FRAMESIZES / ENUM_FRAMEINTERVALS 표)
+#include "device_discovery.h"   // test_linux_sdk/device_discovery.c (sysfs + 동시 QUERYCAP 장치 탐색)
+#define HAVE_V4L2_BACKEND 1
+#endif
 
 static volatile bool keep_running = true;
 static void handle_sigint(int sig) { (void)sig; keep_running = false; }
 
+#ifdef HAVE_V4L2_BACKEND
+// cv::VideoCapture 를 거치지 않는 V4L2 mmap 캡처
+// - 버퍼 수를 직접 정한다 (앱이 1개 보유 + 드라이버 2개 순환 + 여유 1개)
+// - grab() 은 디큐한 버퍼를 복사 없이 cv::Mat 헤더로 감싸며, 다음 grab()/requeue() 까지 유효하다
+// - 협상된 timeperframe 을 그대로 보고한다 (CAP_PROP_FPS 처럼 -1 이 나오지 않음)
+class V4L2Capture {
+private:
+    struct Buffer {
+        void* start;
+        size_t length;
+    };
+
+    int fd;
+    std::vector<Buffer> buffers;
+    int held;                   // 앱이 보유 중인 버퍼 인덱스 (-1: 없음)
+    bool streaming;
+    unsigned int pixfmt;
+    int width;
+    int height;
+    int bytesperline;
+    unsigned int tpf_num;       // timeperframe = tpf_num / tpf_den 초
+    unsigned int tpf_den;
+    ft_table_t formats;         // open() 때 한 번 만드는 지원 포맷 표
+    double last_switch_ms;      // 마지막 configure() 소요 시간
+    std::chrono::steady_clock::time_point switch_start;
+    bool switch_pending;        // configure() 후 첫 프레임 전
+
+    static int xioctl(int fd, unsigned long request, void* arg) {
+        int r;
+        do {
+            r = ioctl(fd, request, arg);
+        } while (r < 0 && errno == EINTR);
+        return r;
+    }
+
+    // pixfmt 이 w x h 에서 fps 이상의 프레임 간격을 지원하는지 (포맷 표)
+    bool supportsRate(unsigned int fmt, int w, int h, int fps) const {
+        const ft_size_t* sz = ft_find(&formats, fmt, w, h);
+        return sz && sz->validated && sz->rate_count > 0 && ft_interval_fps(&sz->rates[0]) + 0.01 >= fps;
+    }
+
+    // 스트리밍을 멈추지 않고 프레임 간격만 바꾼다 (드라이버가 EBUSY 면 false)
+    bool setRateLive(int fps) {
+        struct v4l2_streamparm parm;
+        memset(&parm, 0, sizeof(parm));
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        parm.parm.capture.timeperframe.numerator = 1;
+        parm.parm.capture.timeperframe.denominator = fps;
+        if (xioctl(fd, VIDIOC_S_PARM, &parm) < 0) return false;
+        tpf_num = parm.parm.capture.timeperframe.numerator;
+        tpf_den = parm.parm.capture.timeperframe.denominator;
+        return true;
+    }
+
+    void freeBuffers() {
+        for (size_t i = 0; i < buffers.size(); i++) {
+            munmap(buffers[i].start, buffers[i].length);
+        }
+        buffers.clear();
+        if (fd >= 0) {
+            struct v4l2_requestbuffers req;
+            memset(&req, 0, sizeof(req));
+            req.count = 0;
+            req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            req.memory = V4L2_MEMORY_MMAP;
+            xioctl(fd, VIDIOC_REQBUFS, &req);
+        }
+    }
+
+    bool allocBuffers() {
+        struct v4l2_requestbuffers req;
+        memset(&req, 0, sizeof(req));
+        req.count = kBufferCount;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(fd, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+            std::cout << "V4L2: 버퍼 요청 실패 (" << strerror(errno) << ")" << std::endl;
+            return false;
+        }
+        for (unsigned int i = 0; i < req.count; i++) {
+            struct v4l2_buffer buf;
+            memset(&buf, 0, sizeof(buf));
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = i;
+            if (xioctl(fd, VIDIOC_QUERYBUF, &buf) < 0) return false;
+            void* p = mmap(NULL, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buf.m.offset);
+            if (p == MAP_FAILED) return false;
+            Buffer b = { p, buf.length };
+            buffers.push_back(b);
+        }
+        return true;
+    }
+
+    bool queue(int index) {
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = index;
+        return xioctl(fd, VIDIOC_QBUF, &buf) == 0;
+    }
+
+    // 스트리밍이 멈춘 상태에서 S_FMT/S_PARM → REQBUFS/mmap → STREAMON (실패하면 false, 상태는 호출자가 정리)
+    bool applyFormat(unsigned int fmt_id, int w, int h, unsigned int num, unsigned int den) {
+        struct v4l2_format fmt;
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = w;
+        fmt.fmt.pix.height = h;
+        fmt.fmt.pix.pixelformat = fmt_id;
+        fmt.fmt.pix.field = V4L2_FIELD_ANY;
+        if (xioctl(fd, VIDIOC_S_FMT, &fmt) < 0) {
+            std::cout << "V4L2: 포맷 설정 실패 (" << strerror(errno) << ")" << std::endl;
+            return false;
+        }
+        pixfmt = fmt.fmt.pix.pixelformat;
+        width = fmt.fmt.pix.width;
+        height = fmt.fmt.pix.height;
+        bytesperline = fmt.fmt.pix.bytesperline ? fmt.fmt.pix.bytesperline : width * 2;
+        if (pixfmt != V4L2_PIX_FMT_YUYV && pixfmt != V4L2_PIX_FMT_MJPEG) {
+            std::cout << "V4L2: 지원하지 않는 픽셀 포맷 " << fourcc() << std::endl;
+            return false;
+        }
+
+        struct v4l2_streamparm parm;
+        memset(&parm, 0, sizeof(parm));
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        parm.parm.capture.timeperframe.numerator = num;
+        parm.parm.capture.timeperframe.denominator = den;
+        xioctl(fd, VIDIOC_S_PARM, &parm);
+        // 드라이버가 실제로 고른 값 (가장 가까운 지원 간격)
+        memset(&parm, 0, sizeof(parm));
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(fd, VIDIOC_G_PARM, &parm) == 0) {
+            tpf_num = parm.parm.capture.timeperframe.numerator;
+            tpf_den = parm.parm.capture.timeperframe.denominator;
+        }
+
+        return allocBuffers() && start();
+    }
+
+public:
+    static const int kBufferCount = 4;
+
+    V4L2Capture() : fd(-1), held(-1), streaming(false), pixfmt(0), width(0), height(0), bytesperline(0),
+                    tpf_num(0), tpf_den(0), last_switch_ms(0), switch_pending(false) {
+        memset(&formats, 0, sizeof(formats));
+    }
+    ~V4L2Capture() { close(); }
+
+    // 스트리밍 캡처를 지원하는 장치만 연다
+    bool open(const std::string& path) {
+        close();
+        fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct v4l2_capability cap;
+        memset(&cap, 0, sizeof(cap));
+        unsigned int caps = 0;
+        if (xioctl(fd, VIDIOC_QUERYCAP, &cap) == 0) {
+            caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+        }
+        if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+            close();
+            return false;
+        }
+        ft_probe(fd, &formats);
+
+        // 현재 포맷 / 프레임 간격
+        struct v4l2_format fmt;
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(fd, VIDIOC_G_FMT, &fmt) == 0) {
+            pixfmt = fmt.fmt.pix.pixelformat;
+            width = fmt.fmt.pix.width;
+            height = fmt.fmt.pix.height;
+            bytesperline = fmt.fmt.pix.bytesperline;
+        }
+        struct v4l2_streamparm parm;
+        memset(&parm, 0, sizeof(parm));
+        parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(fd, VIDIOC_G_PARM, &parm) == 0) {
+            tpf_num = parm.parm.capture.timeperframe.numerator;
+            tpf_den = parm.parm.capture.timeperframe.denominator;
+        }
+        return width > 0 && height > 0;
+    }
+
+    void close() {
+        stop();
+        freeBuffers();
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool isOpened() const { return fd >= 0; }
+
+    // 해상도/FPS 전환. 장치는 닫지 않는다.
+    // 요청은 포맷 표의 가장 가까운 항목으로 맞추고, w x h 에서 fps 를 낼 수 있으면 YUYV (디코딩 없음),
+    // 아니면 MJPEG 를 고른다. 크기/포맷이 같으면 S_PARM 만 시도하고 (드라이버가 허용하면 무정지),
+    // 아니면 STREAMOFF → REQBUFS(0)/munmap → S_FMT/S_PARM → REQBUFS/mmap → STREAMON.
+    // 도중에 실패하면 이전 포맷으로 되돌려 스트리밍을 이어가고 false 를 돌려준다
+    bool configure(int w, int h, int fps) {
+        if (fd < 0) return false;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+        unsigned int want = V4L2_PIX_FMT_YUYV;
+        if (!supportsRate(V4L2_PIX_FMT_YUYV, w, h, fps) && supportsRate(V4L2_PIX_FMT_MJPEG, w, h, fps)) {
+            want = V4L2_PIX_FMT_MJPEG;
+        }
+        if (formats.count && !ft_snap(&formats, want, &w, &h, &fps)) {
+            want = want == V4L2_PIX_FMT_YUYV ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
+            ft_snap(&formats, want, &w, &h, &fps);
+        }
+
+        if (streaming && want == pixfmt && w == width && h == height && setRateLive(fps)) {
+            markSwitch(t0);
+            return true;
+        }
+
+        // 실패하면 이전 포맷/간격/버퍼로 되돌려 스트리밍을 재개한다
+        const unsigned int prev_fmt = pixfmt;
+        const int prev_w = width, prev_h = height;
+        const unsigned int prev_num = tpf_num, prev_den = tpf_den;
+
+        stop();
+        freeBuffers();
+        if (applyFormat(want, w, h, 1, fps)) {
+            markSwitch(t0);
+            return true;
+        }
+
+        stop();
+        freeBuffers();
+        if (prev_w > 0 && applyFormat(prev_fmt, prev_w, prev_h, prev_num ? prev_num : 1, prev_den ? prev_den : 30)) {
+            std::cout << "V4L2: 이전 포맷 " << fourcc() << " " << width << "x" << height << " 으로 복구" << std::endl;
+        } else {
+            std::cout << "V4L2: 이전 포맷 복구 실패" << std::endl;
+        }
+        return false;
+    }
+
+    void markSwitch(std::chrono::steady_clock::time_point t0) {
+        switch_start = t0;
+        last_switch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        switch_pending = true;
+    }
+
+    // configure() 이후 첫 프레임이면 전환 시작부터의 시간 (ms), 아니면 음수
+    double takeSwitchLatency() {
+        if (!switch_pending) return -1;
+        switch_pending = false;
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - switch_start).count();
+    }
+
+    double getLastSwitchMs() const { return last_switch_ms; }
+    const ft_table_t& getFormatTable() const { return formats; }
+
+    bool start() {
+        if (streaming) return true;
+        for (size_t i = 0; i < buffers.size(); i++) {
+            if (!queue(i)) return false;
+        }
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(fd, VIDIOC_STREAMON, &type) < 0) {
+            std::cout << "V4L2: 스트림 시작 실패 (" << strerror(errno) << ")" << std::endl;
+            return false;
+        }
+        streaming = true;
+        return true;
+    }
+
+    void stop() {
+        if (!streaming) return;
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd, VIDIOC_STREAMOFF, &type);   // 큐에 있던 버퍼는 모두 드라이버에서 빠진다
+        streaming = false;
+        held = -1;
+    }
+
+    // 보유 중인 버퍼를 드라이버에 돌려준다 (이후 grab() 으로 받은 Mat 헤더는 무효)
+    void requeue() {
+        if (held >= 0) {
+            queue(held);
+            held = -1;
+        }
+    }
+
+    // 다음 프레임을 기다려 mmap 버퍼를 그대로 가리키는 Mat 헤더로 돌려준다.
+    // YUYV: height x width CV_8UC2 (stride = bytesperline), MJPEG: 1 x bytesused CV_8UC1
+    // ts_ms 는 버퍼 timestamp (CAP_PROP_POS_MSEC 와 같은 단위)
+    bool grab(cv::Mat& raw, double& ts_ms, int timeout_ms) {
+        if (!streaming && !start()) return false;
+        requeue();
+        for (;;) {
+            struct v4l2_buffer buf;
+            memset(&buf, 0, sizeof(buf));
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            if (xioctl(fd, VIDIOC_DQBUF, &buf) < 0) {
+                if (errno != EAGAIN) {
+                    std::cout << "V4L2: 디큐 실패 (" << strerror(errno) << ")" << std::endl;
+                    return false;
+                }
+                struct pollfd pfd;
+                pfd.fd = fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                int r = poll(&pfd, 1, timeout_ms);
+                if (r <= 0 || !keep_running) return false;
+                continue;
+            }
+
+            // 잘린 프레임(전송 오류)은 버리고 다음 프레임
+            bool short_frame = pixfmt == V4L2_PIX_FMT_YUYV
+                ? buf.bytesused < (unsigned)(bytesperline * (height - 1) + width * 2)
+                : buf.bytesused < 2;
+            if ((buf.flags & V4L2_BUF_FLAG_ERROR) || short_frame) {
+                queue(buf.index);
+                continue;
+            }
+
+            held = buf.index;
+            unsigned char* data = static_cast<unsigned char*>(buffers[buf.index].start);
+            if (pixfmt == V4L2_PIX_FMT_YUYV) {
+                raw = cv::Mat(height, width, CV_8UC2, data, bytesperline);
+            } else {
+                raw = cv::Mat(1, buf.bytesused, CV_8UC1, data);
+            }
+            ts_ms = buf.timestamp.tv_sec * 1000.0 + buf.timestamp.tv_usec / 1000.0;
+            return true;
+        }
+    }
+
+    // grab() 한 버퍼를 BGR 로 변환한다 (cv::VideoCapture::retrieve 에 해당)
+    bool retrieve(const cv::Mat& raw, cv::Mat& bgr) {
+        if (pixfmt == V4L2_PIX_FMT_YUYV) {
+            cv::cvtColor(raw, bgr, cv::COLOR_YUV2BGR_YUYV);
+        } else {
+            bgr = cv::imdecode(raw, cv::IMREAD_COLOR);
+        }
+        return !bgr.empty();
+    }
+
+    bool getControl(unsigned int id, int& value) {
+        struct v4l2_control ctrl;
+        memset(&ctrl, 0, sizeof(ctrl));
+        ctrl.id = id;
+        if (fd < 0 || xioctl(fd, VIDIOC_G_CTRL, &ctrl) < 0) return false;
+        value = ctrl.value;
+        return true;
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getBufferCount() const { return static_cast<int>(buffers.size()); }
+    unsigned int getTimePerFrameNum() const { return tpf_num; }
+    unsigned int getTimePerFrameDen() const { return tpf_den; }
+    double getFPS() const { return tpf_num ? static_cast<double>(tpf_den) / tpf_num : 0.0; }
+
+    std::string fourcc() const {
+        char s[5] = { (char)(pixfmt & 0xff), (char)((pixfmt >> 8) & 0xff), (char)((pixfmt >> 16) & 0xff),
+                      (char)((pixfmt >> 24) & 0xff), 0 };
+        return s;
+    }
+};
+#endif
+
 // OpenCV SDK 스타일 컨트롤러 클래스
 class OpenCVSDKController {
 private:
     cv::VideoCapture cap;
+#ifdef HAVE_V4L2_BACKEND
+    V4L2Capture v4l2;       // 열려 있으면 cap 대신 사용
+#endif
+    bool prefer_v4l2;
     int current_fps;
     int current_width;
     int current_height;
     int keyframe_rate;
+    double exact_fps;       // 협상된 timeperframe 의 역수 (V4L2 백엔드)
+    double next_slot_ms;    // 다음 출력 슬롯 (장치 timestamp 기준, ms)
+
+    bool usingV4L2() const {
+#ifdef HAVE_V4L2_BACKEND
+        return v4l2.isOpened();
+#else
+        return false;
+#endif
+    }
+
+#ifdef HAVE_V4L2_BACKEND
+    void printV4L2Control(const char* name, unsigned int id) {
+        int value;
+        if (v4l2.getControl(id, value)) {
+            std::cout << name << ": " << value << std::endl;
+        } else {
+            std::cout << name << ": n/a" << std::endl;
+        }
+    }
+
+    // sysfs + 동시 QUERYCAP 으로 찾은 캡처 노드 번호 (RER 칩 / H.264 / MJPEG 순)
+    // 메타데이터 / 코덱 노드는 열어 보지 않는다. 하나도 못 찾으면 devices 를 그대로 둔다
+    void discoverCameras(std::vector<int>& devices) {
+        std::unique_ptr<dd_list_t> list(new dd_list_t);
+        if (dd_discover(list.get(), NULL, NULL, 1) <= 0) return;
+
+        std::vector<int> found;
+        for (int i = 0; i < list->count; i++) {
+            const dd_device_t& d = list->dev[i];
+            if (d.node != DD_NODE_CAPTURE || d.probe_error == EBUSY) continue;
+            found.push_back(d.number);
+        }
+        std::cout << "장치 탐색: 캡처 노드 " << found.size() << " / " << list->count << " 개, "
+                  << list->total_ms << " ms (QUERYCAP 동시 " << list->probe_ms << " ms)" << std::endl;
+        if (!found.empty()) {
+            const dd_device_t& best = list->dev[0];
+            std::cout << "  최선: " << best.path << " " << best.card << " (" << dd_chip_name(best.chip) << ")" << std::endl;
+            devices = found;
+        }
+    }
+#endif
 
 public:
-    OpenCVSDKController() : current_fps(30), current_width(640), current_height(480), keyframe_rate(30) {}
+    OpenCVSDKController() : prefer_v4l2(true), current_fps(30), current_width(640), current_height(480),
+                            keyframe_rate(30), exact_fps(0), next_slot_ms(0) {}
+
+    // openCamera() 전에 호출. false 면 cv::VideoCapture 만 사용
+    void setBackend(bool use_v4l2) {
+        prefer_v4l2 = use_v4l2;
+    }
+
+    std::string getBackendName() const {
+        return usingV4L2() ? "V4L2" : "OpenCV";
+    }
 
     bool openCamera(int device_id = 0) {
         // 라즈베리파이에서 실제 카메라 장치 찾기
-        std::vector<int> camera_devices = {0, 1, 2, 8, 9}; // 실제 카메라 장치들
-        
+        std::vector<int> camera_devices = {0, 1, 2, 8, 9}; // 실제 카메라 장치들 (탐색 실패 시)
+        (void)device_id;
+
+#ifdef HAVE_V4L2_BACKEND
+        discoverCameras(camera_devices);
+
+        if (prefer_v4l2) {
+            for (int dev : camera_devices) {
+                std::string path = "/dev/video" + std::to_string(dev);
+                if (v4l2.open(path)) {
+                    std::cout << "카메라 장치 " << path << " 열림 (V4L2 직접 캡처)" << std::endl;
+                    std::cout << "카메라 정보:" << std::endl;
+                    std::cout << "  Width: " << v4l2.getWidth() << std::endl;
+                    std::cout << "  Height: " << v4l2.getHeight() << std::endl;
+                    std::cout << "  FPS: " << v4l2.getFPS() << std::endl;
+                    std::cout << "  Format: " << v4l2.fourcc() << std::endl;
+                    return true;
+                }
+            }
+            std::cout << "V4L2 직접 캡처 장치를 찾지 못해 OpenCV 백엔드로 대체합니다" << std::endl;
+        }
+#endif
+
         for (int dev : camera_devices) {
             std::cout << "카메라 장치 " << dev << " 열기 시도 중..." << std::endl;
             cap.open(dev);
@@ -55,6 +524,23 @@ public:
     }
 
     bool setFormat(int width, int height, int fps) {
+#ifdef HAVE_V4L2_BACKEND
+        if (v4l2.isOpened()) {
+            std::cout << "카메라 포맷 설정 중..." << std::endl;
+            bool ok = v4l2.configure(width, height, fps);
+            current_width = v4l2.getWidth();
+            current_height = v4l2.getHeight();
+            exact_fps = v4l2.getFPS();
+            current_fps = exact_fps > 0 ? static_cast<int>(std::lround(exact_fps)) : fps;
+            next_slot_ms = 0;
+            if (!ok) return false;
+            std::cout << "Format set to: " << current_width << "x" << current_height << " @ " << exact_fps
+                      << " fps (timeperframe " << v4l2.getTimePerFrameNum() << "/" << v4l2.getTimePerFrameDen()
+                      << ", " << v4l2.fourcc() << ", mmap x" << v4l2.getBufferCount() << ", 전환 "
+                      << v4l2.getLastSwitchMs() << " ms)" << std::endl;
+            return true;
+        }
+#endif
         if (!cap.isOpened()) return false;
 
         // 라즈베리파이에서는 설정을 단계별로 적용
@@ -80,6 +566,8 @@ public:
 
         std::cout << "Format set to: " << current_width << "x" << current_height 
                   << " @ " << current_fps << " fps" << std::endl;
+        exact_fps = 0;
+        next_slot_ms = 0;
         return true;
     }
 
@@ -88,15 +576,53 @@ public:
         
         keyframe_rate = rate;
         // OpenCV에서는 키프레임 레이트를 직접 설정할 수 없지만,
-        // 일부 백엔드에서는 지원할 수 있음
-        cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('H', '2', '6', '4'));
+        // 일부 백엔드에서는 지원할 수 있음 (V4L2 백엔드는 포맷을 직접 고르므로 건드리지 않음)
+        if (!usingV4L2()) {
+            cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('H', '2', '6', '4'));
+        }
         
         std::cout << "Keyframe rate set to: " << rate << std::endl;
         return true;
     }
 
     bool readFrame(cv::Mat& frame) {
-        cap >> frame;
+        // grab() 은 장치가 다음 프레임을 줄 때까지 블록하므로 장치 주기가 곧 프레임 클록이다.
+        // 카메라가 목표 FPS 보다 빠르면 장치 timestamp 기준 슬롯 전에 온 프레임은 디코드 없이 건너뛴다.
+        double interval_ms = 1000.0 / (exact_fps > 0 ? exact_fps : (current_fps > 0 ? current_fps : 30));
+        frame.release();
+#ifdef HAVE_V4L2_BACKEND
+        if (v4l2.isOpened()) {
+            cv::Mat raw;
+            double ts_ms = 0;
+            while (keep_running && v4l2.grab(raw, ts_ms, 1000)) {
+                if (ts_ms > 0 && ts_ms + interval_ms / 4 < next_slot_ms) {
+                    continue;   // 다음 grab() 이 버퍼를 바로 돌려준다
+                }
+                next_slot_ms = ts_ms + interval_ms;
+                v4l2.retrieve(raw, frame);
+                v4l2.requeue();  // frame 은 변환된 사본이므로 버퍼를 바로 돌려준다
+                double switch_ms = v4l2.takeSwitchLatency();
+                if (switch_ms >= 0) {
+                    std::cout << "포맷 전환 → 첫 프레임 " << switch_ms << " ms" << std::endl;
+                }
+                break;
+            }
+            if (frame.empty()) {
+                std::cout << "프레임 읽기 실패 (V4L2 " << current_width << "x" << current_height << " "
+                          << v4l2.fourcc() << ")" << std::endl;
+            }
+            return !frame.empty();
+        }
+#endif
+        while (keep_running && cap.grab()) {
+            double ts_ms = cap.get(cv::CAP_PROP_POS_MSEC);  // V4L2 백엔드: 버퍼 timestamp
+            if (ts_ms > 0 && ts_ms + interval_ms / 4 < next_slot_ms) {
+                continue;
+            }
+            next_slot_ms = ts_ms + interval_ms;
+            cap.retrieve(frame);
+            break;
+        }
         if (frame.empty()) {
             std::cout << "프레임 읽기 실패 - 카메라 상태 확인 중..." << std::endl;
             std::cout << "  카메라 열림 상태: " << (cap.isOpened() ? "열림" : "닫힘") << std::endl;
@@ -113,7 +639,22 @@ public:
         return !frame.empty();
     }
 
+    // 변환 없이 디큐한 버퍼를 가리키는 Mat 헤더 (V4L2 백엔드만, 다음 호출까지 유효)
+    bool readRawFrame(cv::Mat& raw) {
+#ifdef HAVE_V4L2_BACKEND
+        double ts_ms;
+        if (v4l2.isOpened()) {
+            return v4l2.grab(raw, ts_ms, 1000);
+        }
+#endif
+        (void)raw;
+        return false;
+    }
+
     void release() {
+#ifdef HAVE_V4L2_BACKEND
+        v4l2.close();
+#endif
         cap.release();
     }
 
@@ -133,15 +674,50 @@ public:
         return keyframe_rate;
     }
 
+    // V4L2 백엔드: 포맷 표에서 검증된 해상도 (YUYV/MJPEG 합집합, 면적 순)
+    // OpenCV 백엔드 또는 표가 없으면 라즈베리파이에 적합한 기본 목록
     std::vector<std::pair<int, int>> getSupportedResolutions() {
-        // 라즈베리파이에 적합한 해상도 목록
+#ifdef HAVE_V4L2_BACKEND
+        if (v4l2.isOpened() && v4l2.getFormatTable().count) {
+            std::vector<std::pair<int, int>> list;
+            const unsigned int fmts[2] = { V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_MJPEG };
+            for (unsigned int fmt : fmts) {
+                int sizes[FT_MAX_SIZES][2];
+                int n = ft_resolutions(&v4l2.getFormatTable(), fmt, sizes, FT_MAX_SIZES);
+                for (int i = 0; i < n; i++) {
+                    std::pair<int, int> r(sizes[i][0], sizes[i][1]);
+                    if (std::find(list.begin(), list.end(), r) == list.end()) list.push_back(r);
+                }
+            }
+            std::sort(list.begin(), list.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                return a.first * a.second < b.first * b.second;
+            });
+            if (!list.empty()) return list;
+        }
+#endif
         return {
             {320, 240}, {640, 480}, {800, 600}, {1024, 768},
             {1280, 720}, {1920, 1080}
         };
     }
 
+    // 현재 해상도에서 지원하는 FPS (느린 순)
     std::vector<int> getSupportedFPS() {
+#ifdef HAVE_V4L2_BACKEND
+        if (v4l2.isOpened() && v4l2.getFormatTable().count) {
+            std::vector<int> list;
+            const unsigned int fmts[2] = { V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_MJPEG };
+            for (unsigned int fmt : fmts) {
+                int rates[FT_MAX_RATES];
+                int n = ft_frame_rates(&v4l2.getFormatTable(), fmt, current_width, current_height, rates, FT_MAX_RATES);
+                for (int i = 0; i < n; i++) {
+                    if (std::find(list.begin(), list.end(), rates[i]) == list.end()) list.push_back(rates[i]);
+                }
+            }
+            std::sort(list.begin(), list.end());
+            if (!list.empty()) return list;
+        }
+#endif
         // 라즈베리파이에 적합한 FPS 값들
         return {15, 24, 25, 30};
     }
@@ -152,6 +728,25 @@ public:
     }
 
     void printCameraInfo() {
+#ifdef HAVE_V4L2_BACKEND
+        if (v4l2.isOpened()) {
+            std::cout << "=== OpenCV SDK Camera Information ===" << std::endl;
+            std::cout << "Backend: V4L2 (" << v4l2.fourcc() << ", mmap x" << v4l2.getBufferCount() << ")" << std::endl;
+            std::cout << "Resolution: " << current_width << "x" << current_height << std::endl;
+            std::cout << "FPS: " << exact_fps << " (timeperframe " << v4l2.getTimePerFrameNum() << "/"
+                      << v4l2.getTimePerFrameDen() << ")" << std::endl;
+            std::cout << "Keyframe Rate: " << keyframe_rate << std::endl;
+            printV4L2Control("Brightness", V4L2_CID_BRIGHTNESS);
+            printV4L2Control("Contrast", V4L2_CID_CONTRAST);
+            printV4L2Control("Saturation", V4L2_CID_SATURATION);
+            printV4L2Control("Hue", V4L2_CID_HUE);
+            printV4L2Control("Gain", V4L2_CID_GAIN);
+            printV4L2Control("Exposure", V4L2_CID_EXPOSURE_ABSOLUTE);
+            printV4L2Control("Auto Exposure", V4L2_CID_EXPOSURE_AUTO);
+            printV4L2Control("Auto Focus", V4L2_CID_FOCUS_AUTO);
+            return;
+        }
+#endif
         if (!cap.isOpened()) {
             std::cout << "Camera not opened" << std::endl;
             return;
@@ -201,29 +796,47 @@ public:
 };
 
 // FPS 모니터 클래스
+// getFPS(): 최근 1초 슬라이딩 윈도우, getAverageFPS(): 시작(reset) 이후 평균
 class FPSMonitor {
 private:
+    typedef std::chrono::steady_clock Clock;
+
     int frame_count;
-    std::chrono::high_resolution_clock::time_point start_time;
-    double current_fps;
+    Clock::time_point start_time;
+    std::deque<Clock::time_point> window;   // 최근 1초 안의 프레임 시각
+
+    void expire(Clock::time_point now) {
+        while (!window.empty() && now - window.front() > std::chrono::seconds(1)) {
+            window.pop_front();
+        }
+    }
 
 public:
-    FPSMonitor() : frame_count(0), current_fps(0.0) {
-        start_time = std::chrono::high_resolution_clock::now();
+    FPSMonitor() : frame_count(0) {
+        start_time = Clock::now();
     }
 
     void update() {
+        auto now = Clock::now();
         frame_count++;
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time);
-        
-        if (elapsed.count() > 0) {
-            current_fps = frame_count / (elapsed.count() / 1000.0);
+        window.push_back(now);
+        expire(now);
+    }
+
+    double getFPS() {
+        auto now = Clock::now();
+        expire(now);
+        if (window.size() < 2) {
+            return 0.0;
         }
+        // 첫 프레임 이후 경과 시간 동안의 프레임 간격 수
+        double span = std::chrono::duration<double>(now - window.front()).count();
+        return span > 0.0 ? (window.size() - 1) / span : 0.0;
     }
 
-    double getFPS() const {
-        return current_fps;
+    double getAverageFPS() const {
+        double elapsed = std::chrono::duration<double>(Clock::now() - start_time).count();
+        return elapsed > 0.0 ? frame_count / elapsed : 0.0;
     }
 
     int getFrameCount() const {
@@ -232,23 +845,114 @@ public:
 
     void reset() {
         frame_count = 0;
-        start_time = std::chrono::high_resolution_clock::now();
-        current_fps = 0.0;
+        start_time = Clock::now();
+        window.clear();
     }
 };
 
+// 백엔드 A/B 벤치마크: 같은 포맷에서 OpenCV(cv::VideoCapture) 와 V4L2 직접 캡처를 차례로 측정
+// 창 없이 readFrame() (BGR 변환 포함) 과 V4L2 raw 헤더 경로의 FPS / 프레임당 CPU / 읽기 지연을 출력
+static double cpu_seconds() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+static int run_backend_bench(int frames, int width, int height, int fps) {
+    typedef std::chrono::steady_clock Clock;
+    const int warmup = 10;
+    const char* modes[3] = { "opencv", "v4l2", "v4l2-raw" };
+    int failed = 0;
+
+    std::cout << "=== 캡처 백엔드 A/B (" << width << "x" << height << " @ " << fps << ", "
+              << frames << " 프레임) ===" << std::endl;
+    std::cout << "backend     format              fps    cpu ms/frame  read avg ms  read max ms" << std::endl;
+
+    for (int m = 0; m < 3 && keep_running; m++) {
+        bool v4l2 = m > 0;
+        bool raw_mode = m == 2;
+        OpenCVSDKController controller;
+        controller.setBackend(v4l2);
+        if (!controller.openCamera(0) || (v4l2 && controller.getBackendName() != "V4L2") ||
+            !controller.setFormat(width, height, fps)) {
+            std::cout << modes[m] << ": 열기 실패" << std::endl;
+            controller.release();
+            failed++;
+            continue;
+        }
+
+        cv::Mat frame;
+        int got = 0;
+        for (int i = 0; i < warmup; i++) {
+            if (raw_mode ? !controller.readRawFrame(frame) : !controller.readFrame(frame)) break;
+        }
+
+        double max_ms = 0;
+        double cpu0 = cpu_seconds();
+        Clock::time_point start = Clock::now();
+        for (; got < frames && keep_running; got++) {
+            Clock::time_point t0 = Clock::now();
+            bool ok = raw_mode ? controller.readRawFrame(frame) : controller.readFrame(frame);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            if (!ok) break;
+            if (ms > max_ms) max_ms = ms;
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        double cpu = cpu_seconds() - cpu0;
+
+        char line[160];
+        std::string fmt = std::to_string(controller.getCurrentWidth()) + "x" +
+                          std::to_string(controller.getCurrentHeight()) + "@" +
+                          std::to_string(controller.getCurrentFPS());
+        snprintf(line, sizeof(line), "%-11s %-16s %7.2f  %12.3f  %11.2f  %11.2f", modes[m], fmt.c_str(),
+                 elapsed > 0 ? got / elapsed : 0.0, got ? cpu * 1000.0 / got : 0.0,
+                 got ? elapsed * 1000.0 / got : 0.0, max_ms);
+        std::cout << line << std::endl;
+        if (got < frames) failed++;
+
+        // 해상도 전환 지연: setFormat() 부터 새 해상도의 첫 프레임까지 (장치는 열어 둔 채)
+        if (!raw_mode) {
+            auto resolutions = controller.getSupportedResolutions();
+            std::string summary = "  전환 지연 (" + std::string(modes[m]) + "):";
+            for (size_t i = 0; i < resolutions.size() && i < 6 && keep_running; i++) {
+                Clock::time_point t0 = Clock::now();
+                bool ok = controller.setFormat(resolutions[i].first, resolutions[i].second, fps) &&
+                          controller.readFrame(frame);
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+                summary += " " + std::to_string(resolutions[i].first) + "x" + std::to_string(resolutions[i].second) +
+                           "=" + (ok ? std::to_string(static_cast<int>(ms)) + "ms" : std::string("실패"));
+            }
+            std::cout << summary << std::endl;
+        }
+        controller.release();
+    }
+    return failed ? 1 : 0;
+}
+
 int main(int argc, char** argv) {
+    // ./webcam_viewer_sdk --bench [frames] [width] [height] [fps]
+    if (argc >= 2 && std::string(argv[1]) == "--bench") {
+        signal(SIGINT, handle_sigint);
+        int frames = argc >= 3 ? std::stoi(argv[2]) : 300;
+        int w = argc >= 4 ? std::stoi(argv[3]) : 640;
+        int h = argc >= 5 ? std::stoi(argv[4]) : 480;
+        int f = argc >= 6 ? std::stoi(argv[5]) : 30;
+        return run_backend_bench(frames, w, h, f);
+    }
+
     std::string device = "/dev/video0";
     int width = 640;
     int height = 480;
     int fps = 30;
     int keyframe_rate = 30;
+    std::string backend = "v4l2";   // v4l2: 직접 캡처 (실패 시 OpenCV), opencv: cv::VideoCapture
 
     if (argc >= 2) device = argv[1];
     if (argc >= 3) width = std::stoi(argv[2]);
     if (argc >= 4) height = std::stoi(argv[3]);
     if (argc >= 5) fps = std::stoi(argv[4]);
     if (argc >= 6) keyframe_rate = std::stoi(argv[5]);
+    if (argc >= 7) backend = argv[6];
 
     signal(SIGINT, handle_sigint);
 
@@ -267,6 +971,7 @@ int main(int argc, char** argv) {
 
     // OpenCV SDK 컨트롤러 초기화
     OpenCVSDKController controller;
+    controller.setBackend(backend != "opencv");
     
     // 카메라 열기
     if (!controller.openCamera(0)) {
@@ -277,12 +982,15 @@ int main(int argc, char** argv) {
         return -1;
     }
 
-    // 카메라 포맷 설정
-    controller.setFormat(width, height, fps);
+    // 카메라 포맷 설정 (실패하면 장치의 현재 포맷으로 계속)
+    if (!controller.setFormat(width, height, fps)) {
+        std::cout << "Warning: " << width << "x" << height << " @ " << fps << " 설정 실패 - "
+                  << controller.getCurrentWidth() << "x" << controller.getCurrentHeight() << " 사용" << std::endl;
+    }
     controller.setKeyFrameRate(keyframe_rate);
 
     std::cout << "=== OpenCV SDK Style Webcam Viewer (Raspberry Pi) ===" << std::endl;
-    std::cout << "Camera opened successfully!" << std::endl;
+    std::cout << "Camera opened successfully! (backend: " << controller.getBackendName() << ")" << std::endl;
     controller.printCameraInfo();
     controller.printSupportedFormats();
     std::cout << std::endl;
@@ -290,7 +998,7 @@ int main(int argc, char** argv) {
     std::cout << "  'q' - Quit" << std::endl;
     std::cout << "  's' - Save frame" << std::endl;
     std::cout << "  '1-6' - Set resolution (320x240, 640x480, 800x600, 1024x768, 1280x720, 1920x1080)" << std::endl;
-    std::cout << "  'f1-f4' - Set FPS (15, 24, 25, 30)" << std::endl;
+    std::cout << "  'f1-f4' - Set FPS (supported FPS at current resolution, in listed order)" << std::endl;
     std::cout << "  'k1-k5' - Set keyframe rate (1, 5, 10, 15, 30)" << std::endl;
     std::cout << "  'i' - Show camera info" << std::endl;
     std::cout << "  'f' - Show supported formats" << std::endl;
@@ -304,7 +1012,11 @@ int main(int argc, char** argv) {
 
     FPSMonitor monitor;
     bool show_info = true;
-    int frame_interval = 1000 / fps; // ms 단위
+
+    // 정보 텍스트: 스택 버퍼에 포맷하고, 글자가 바뀐 줄만 다시 렌더링해 BGR 프레임에 합성
+    ovl_t *overlay = ovl_create(2);
+    char text[OVL_MAX_TEXT];
+    ovl_set_text(overlay, 1, 10, 42, 1, 0x00FFFF, "Platform: Raspberry Pi");
 
     while (keep_running) {
         // 프레임 읽기 (reference.cpp와 동일한 방식)
@@ -318,25 +1030,24 @@ int main(int argc, char** argv) {
 
         // 정보 표시 (GUI 모드)
         if (show_info) {
-            std::string info_text = "Frame: " + std::to_string(monitor.getFrameCount()) +
-                                   ", FPS: " + std::to_string(static_cast<int>(monitor.getFPS())) +
-                                   ", Target: " + std::to_string(controller.getCurrentFPS()) +
-                                   ", KF: " + std::to_string(controller.getKeyFrameRate()) +
-                                   ", Size: " + std::to_string(frame.cols) + "x" + std::to_string(frame.rows);
+            snprintf(text, sizeof(text), "Frame: %d, FPS: %d, Target: %d, KF: %d, Size: %dx%d",
+                     monitor.getFrameCount(), static_cast<int>(monitor.getFPS()), controller.getCurrentFPS(),
+                     controller.getKeyFrameRate(), frame.cols, frame.rows);
+            ovl_set_text(overlay, 0, 10, 12, 1, 0x00FF00, text);
 
             // 화면에 텍스트 표시
-            cv::putText(frame, info_text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0, 255, 0), 2);
-            
-            // 추가 정보 표시
-            std::string platform_info = "Platform: Raspberry Pi";
-            cv::putText(frame, platform_info, cv::Point(10, 60), cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 255, 0), 2);
+            if (frame.type() == CV_8UC3) {
+                ovl_composite(overlay, frame.data, static_cast<int>(frame.step), frame.cols, frame.rows,
+                              OVL_FMT_BGR24);
+            }
         }
 
         // 화면에 표시 (GUI 모드)
         cv::imshow("OpenCV SDK Style Viewer", frame);
 
         // 키 입력 처리 (GUI 모드)
-        int key = cv::waitKey(frame_interval);
+        // 프레임 간격은 readFrame() 이 장치 주기에 맞추므로 여기서는 이벤트만 처리
+        int key = cv::waitKey(1);
 
         if (key == 'q' || key == 'Q') {
             break;
@@ -345,26 +1056,24 @@ int main(int argc, char** argv) {
             std::string filename = "opencv_sdk_frame_" + std::to_string(monitor.getFrameCount()) + ".jpg";
             cv::imwrite(filename, frame);
             std::cout << "\nSaved: " << filename << std::endl;
-        } else if (key == '1') {
-            controller.setFormat(320, 240, controller.getCurrentFPS());
-        } else if (key == '2') {
-            controller.setFormat(640, 480, controller.getCurrentFPS());
-        } else if (key == '3') {
-            controller.setFormat(800, 600, controller.getCurrentFPS());
-        } else if (key == '4') {
-            controller.setFormat(1024, 768, controller.getCurrentFPS());
-        } else if (key == '5') {
-            controller.setFormat(1280, 720, controller.getCurrentFPS());
-        } else if (key == '6') {
-            controller.setFormat(1920, 1080, controller.getCurrentFPS());
-        } else if (key == 49) { // F1
-            controller.setFormat(controller.getCurrentWidth(), controller.getCurrentHeight(), 15);
-        } else if (key == 50) { // F2
-            controller.setFormat(controller.getCurrentWidth(), controller.getCurrentHeight(), 24);
-        } else if (key == 51) { // F3
-            controller.setFormat(controller.getCurrentWidth(), controller.getCurrentHeight(), 25);
-        } else if (key == 52) { // F4
-            controller.setFormat(controller.getCurrentWidth(), controller.getCurrentHeight(), 30);
+        } else if (key >= '1' && key <= '6') {
+            // 문서화된 고정 해상도 (V4L2 백엔드는 장치 포맷 표의 가장 가까운 크기로 맞춘다)
+            static const int sizes[6][2] = {
+                {320, 240}, {640, 480}, {800, 600}, {1024, 768}, {1280, 720}, {1920, 1080}
+            };
+            int i = key - '1';
+            if (!controller.setFormat(sizes[i][0], sizes[i][1], controller.getCurrentFPS())) {
+                std::cout << "해상도 전환 실패 - " << controller.getCurrentWidth() << "x" << controller.getCurrentHeight()
+                          << " @ " << controller.getCurrentFPS() << " 유지" << std::endl;
+            }
+        } else if (key >= 190 && key <= 193) { // F1-F4 (GTK keysym 하위 8비트): 현재 해상도의 지원 FPS 순서
+            auto fps_values = controller.getSupportedFPS();
+            size_t i = key - 190;
+            if (i < fps_values.size() &&
+                !controller.setFormat(controller.getCurrentWidth(), controller.getCurrentHeight(), fps_values[i])) {
+                std::cout << "FPS 전환 실패 - " << controller.getCurrentWidth() << "x" << controller.getCurrentHeight()
+                          << " @ " << controller.getCurrentFPS() << " 유지" << std::endl;
+            }
         } else if (key == 'k') {
             // 키프레임 레이트 설정 (k1-k5)
             int kf_key = cv::waitKey(0);
@@ -386,12 +1095,13 @@ int main(int argc, char** argv) {
     // 정리 (GUI 모드)
     controller.release();
     cv::destroyAllWindows();
+    ovl_destroy(overlay);
     std::cout << "GUI 윈도우가 종료되었습니다." << std::endl;
 
     std::cout << std::endl;
     std::cout << "=== Session Summary ===" << std::endl;
     std::cout << "Total frames captured: " << monitor.getFrameCount() << std::endl;
-    std::cout << "Average FPS: " << monitor.getFPS() << std::endl;
+    std::cout << "Average FPS: " << monitor.getAverageFPS() << std::endl;
     std::cout << "Final resolution: " << controller.getCurrentWidth() << "x" << controller.getCurrentHeight() << std::endl;
     std::cout << "Final FPS: " << controller.getCurrentFPS() << std::endl;
     std::cout << "Final keyframe rate: " << controller.getKeyFrameRate() << std::endl;